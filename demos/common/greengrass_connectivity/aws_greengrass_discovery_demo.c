@@ -143,6 +143,11 @@ static void prvSendMessageToGGC( GGD_HostAddressData_t * pxHostAddressData )
             configPRINTF( ( "ERROR:  Did not disconnected from the broker.\r\n" ) );
         }
     }
+    else
+    {
+        /* Do not reuse a core that could not be used. */
+        GGD_InvalidateCache();
+    }
 }
 
 /*-----------------------------------------------------------*/
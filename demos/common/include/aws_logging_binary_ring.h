@@ -0,0 +1,73 @@
+/*
+ * Amazon FreeRTOS V1.4.2
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef AWS_LOGGING_BINARY_RING_H
+#define AWS_LOGGING_BINARY_RING_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+/*
+ * Additional interface of the binary ring logging implementation in
+ * aws_logging_task_binary_ring.c.  vLoggingPrintf() in that implementation
+ * copies the format string pointer, a time stamp and the raw arguments into a
+ * ring buffer without allocating or formatting anything, so it can be called
+ * from interrupts.  The text is formatted later by the logging task.
+ *
+ * The format string passed to vLoggingPrintf() must therefore remain valid
+ * after the call returns, which is always the case for string literals.
+ */
+
+/* Counters accumulated over all the rings since xLoggingTaskInitialize(). */
+typedef struct LoggingStats
+{
+    uint32_t ulWritten;   /* Messages written to a ring. */
+    uint32_t ulDropped;   /* Messages dropped because a ring was full. */
+    uint32_t ulTruncated; /* Messages written with a string argument cut short. */
+} LoggingStats_t;
+
+/*
+ * Read the logging counters.  Can be called from any task.
+ */
+void vLoggingGetStats( LoggingStats_t * pxStats );
+
+/*
+ * Wait until the logging task has output every message written so far.
+ * Returns pdFAIL if that did not happen within xTicksToWait.
+ */
+BaseType_t xLoggingFlush( TickType_t xTicksToWait );
+
+/*
+ * Capture a message and format it into pcBuffer the way the logging task
+ * does, without the time and task name prefix and without using a ring.
+ * Returns the length of the text, or 0 if no memory was available.  Used by
+ * the tests to compare the output with snprintf().
+ */
+size_t xLoggingFormat( char * pcBuffer,
+                       size_t xBufferLength,
+                       const char * pcFormat,
+                       va_list xArguments );
+
+#endif /* AWS_LOGGING_BINARY_RING_H */
@@ -0,0 +1,1117 @@
+/*
+ * Amazon FreeRTOS V1.4.2
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * A logging implementation in which vLoggingPrintf() does not format the
+ * message.  Instead it writes the format string pointer, a time stamp and the
+ * raw arguments as a binary record into a ring buffer, one ring per core, and
+ * returns.  No memory is allocated and no lock is taken, so it is cheap enough
+ * to leave enabled on hot paths and can be called from interrupts.  The logging
+ * task formats the records in the background, or passes them unformatted to
+ * configLOGGING_OUTPUT_RECORD() so that a host tool can format them instead.
+ *
+ * Writers reserve space by advancing the ring's head index with a compare and
+ * swap, write their record, then mark it committed.  Where the compiler does
+ * not provide a compare and swap the head index is advanced with interrupts
+ * masked for a few instructions instead.  The logging task consumes committed
+ * records in order, and messages that do not fit in the ring are counted and
+ * dropped rather than waited for.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Logging includes. */
+#include "aws_logging_task.h"
+#include "aws_logging_binary_ring.h"
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Sanity check all the definitions required by this file are set. */
+#ifndef configPRINT_STRING
+    #error configPRINT_STRING( x ) must be defined in FreeRTOSConfig.h to use this logging file.  Set configPRINT_STRING( x ) to a function that outputs a string, where X is the string.  For example, #define configPRINT_STRING( x ) MyUARTWriteString( X )
+#endif
+
+#ifndef configLOGGING_MAX_MESSAGE_LENGTH
+    #error configLOGGING_MAX_MESSAGE_LENGTH must be defined in FreeRTOSConfig.h to use this logging file.  configLOGGING_MAX_MESSAGE_LENGTH sets the size of the buffer into which formatted text is written, so also sets the maximum log message length.
+#endif
+
+#ifndef configLOGGING_INCLUDE_TIME_AND_TASK_NAME
+    #error configLOGGING_INCLUDE_TIME_AND_TASK_NAME must be defined in FreeRTOSConfig.h to use this logging file.  Set configLOGGING_INCLUDE_TIME_AND_TASK_NAME to 1 to prepend a time stamp, message number and the name of the calling task to each logged message.  Otherwise set to 0.
+#endif
+
+/* The number of cores, each of which writes to its own ring, and how to find
+ * the core the caller is running on. */
+#ifndef configLOGGING_CORE_COUNT
+    #define configLOGGING_CORE_COUNT    1
+#endif
+
+#ifndef configLOGGING_GET_CORE_ID
+    #define configLOGGING_GET_CORE_ID()    0
+#endif
+
+/* The time stamp recorded with each message.  The default is safe to call
+ * from both tasks and interrupts. */
+#ifndef configLOGGING_TIMESTAMP
+    #define configLOGGING_TIMESTAMP()    ( ( uint32_t ) xTaskGetTickCountFromISR() )
+#endif
+
+/* How often the logging task looks for new records when the rings are empty.
+ * Writers do not signal the logging task, as they may be interrupts. */
+#ifndef configLOGGING_POLL_PERIOD_MS
+    #define configLOGGING_POLL_PERIOD_MS    10
+#endif
+
+/* The ring of each core is sized to hold the uxQueueLength passed to
+ * xLoggingTaskInitialize() messages of this average size. */
+#define loggingAVERAGE_MESSAGE_BYTES    64
+
+/* A record starts with a header word holding its length in words and these
+ * flags.  The header is written last, so a record is not read until it is
+ * complete. */
+#define loggingRECORD_COMMITTED         0x01UL
+#define loggingRECORD_PADDING           0x02UL /* Fills the end of the ring. */
+#define loggingRECORD_PREFIX            0x04UL /* Starts with the task name. */
+#define loggingRECORD_LENGTH_SHIFT      8
+
+/* The header is followed by the time stamp, then the format string pointer,
+ * then the arguments. */
+#define loggingWORDS( xBytes )          ( ( uint32_t ) ( ( ( xBytes ) + sizeof( uint32_t ) - 1 ) / sizeof( uint32_t ) ) )
+#define loggingFIXED_WORDS              ( 2 + loggingWORDS( sizeof( const char * ) ) )
+
+/* String arguments are copied into the record, up to this length. */
+#define loggingMAX_STRING_BYTES         ( configLOGGING_MAX_MESSAGE_LENGTH )
+
+/* The lengths of this many string arguments are kept between measuring a
+ * record and writing it.  Any further string arguments are captured empty. */
+#define loggingMAX_STRING_ARGUMENTS     8
+
+/* Reserving space in a ring. */
+#if defined( __GNUC__ ) && defined( __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4 )
+    #define loggingHAS_COMPARE_AND_SWAP                              1
+    #define loggingCOMPARE_AND_SWAP( pulTarget, ulExpected, ulNew )    __sync_bool_compare_and_swap( ( pulTarget ), ( ulExpected ), ( ulNew ) )
+    #define loggingATOMIC_INCREMENT( pulTarget )                     ( void ) __sync_fetch_and_add( ( pulTarget ), 1UL )
+    #define loggingMEMORY_BARRIER()                                  __sync_synchronize()
+#else
+    #define loggingHAS_COMPARE_AND_SWAP                              0
+
+/* Records are then reserved with interrupts masked, but the compiler must
+ * still not move the stores that fill a record past the one that publishes
+ * it, or the loads that read a record before the one that finds it. */
+    #if defined( portMEMORY_BARRIER )
+        #define loggingMEMORY_BARRIER()                              portMEMORY_BARRIER()
+    #elif defined( __GNUC__ )
+        #define loggingMEMORY_BARRIER()                              __asm volatile ( "" ::: "memory" )
+    #else
+        /* The ports mask interrupts with intrinsics or volatile assembly,
+         * which the compiler does not move memory accesses across. */
+        #define loggingMEMORY_BARRIER()                              portCLEAR_INTERRUPT_MASK_FROM_ISR( portSET_INTERRUPT_MASK_FROM_ISR() )
+    #endif
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The types in which arguments are captured, derived from the conversion
+ * specifications of the format string. */
+typedef enum LoggingArgument
+{
+    eArgumentNone,     /* %% */
+    eArgumentInt,      /* Also char and short, which are promoted to int. */
+    eArgumentLong,
+    eArgumentLongLong,
+    eArgumentSize,
+    eArgumentIntMax,
+    eArgumentPtrDiff,
+    eArgumentPointer,
+    eArgumentDouble,
+    eArgumentLongDouble,
+    eArgumentString,   /* Copied into the record. */
+    eArgumentCount,    /* %n, which is not supported, so the argument is skipped. */
+    eArgumentUnsupported
+} LoggingArgument_t;
+
+/* One ring.  The head and tail are free running counts of words, so the space
+ * used is always ( ulHead - ulTail ). */
+typedef struct LoggingRing
+{
+    uint32_t * pulBuffer;
+    uint32_t ulSize; /* In words, a power of two. */
+    volatile uint32_t ulHead;
+    volatile uint32_t ulTail;
+    volatile uint32_t ulWritten;
+    volatile uint32_t ulDropped;
+    volatile uint32_t ulTruncated;
+} LoggingRing_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that formats and outputs the records.  Using a separate task
+ * enables the use of slow output, such as as a UART, without the task that is
+ * outputting the log message having to wait for the message to be completely
+ * written.  Using a separate task also serialises access to the output port.
+ */
+static void prvLoggingTask( void * pvParameters );
+
+/*
+ * Write a record to the ring of the calling core.  The task name is prepended
+ * if xPrefix is pdTRUE.
+ */
+static void prvWriteRecord( const char * pcFormat,
+                            va_list xArguments,
+                            BaseType_t xPrefix );
+
+/*
+ * Parse the conversion specification that follows a '%', returning a pointer
+ * to the character after it.
+ */
+static const char * prvParseConversion( const char * pcSpecification,
+                                        LoggingArgument_t * peArgument,
+                                        BaseType_t * pxStars );
+
+/*
+ * Capture the arguments of a format string, returning the number of words they
+ * need.  If pulOut is NULL nothing is written, and the lengths of the strings
+ * are measured into pulLengths.  Otherwise the strings are copied with the
+ * lengths measured before, so they are not scanned twice.
+ */
+static uint32_t prvCaptureString( const char * pcString,
+                                  uint32_t * pulOut,
+                                  uint32_t * pulLength,
+                                  BaseType_t * pxTruncated );
+static uint32_t prvCaptureArguments( const char * pcFormat,
+                                     va_list * pxArguments,
+                                     uint32_t * pulOut,
+                                     uint32_t * pulLengths,
+                                     BaseType_t * pxTruncated );
+
+/*
+ * Output the oldest committed record of a ring, if any.
+ */
+static BaseType_t prvReadRecord( LoggingRing_t * pxRing );
+
+/*
+ * Format a record into pcBuffer, returning the length of the text.  String
+ * arguments are terminated in pcString, which must hold
+ * loggingMAX_STRING_BYTES + 1 characters.
+ */
+static size_t prvFormatRecord( const uint32_t * pulRecord,
+                               char * pcBuffer,
+                               size_t xBufferLength,
+                               char * pcString );
+
+static void prvIncrement( volatile uint32_t * pulCounter );
+
+/*-----------------------------------------------------------*/
+
+/* The rings, one per core. */
+static LoggingRing_t xRings[ configLOGGING_CORE_COUNT ];
+
+/* Set once the rings are allocated. */
+static BaseType_t xRingsCreated = pdFALSE;
+
+/* Format used by vLoggingPrint(). */
+static const char cStringFormat[] = "%s";
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
+                                   UBaseType_t uxPriority,
+                                   UBaseType_t uxQueueLength )
+{
+    BaseType_t xReturn = pdFAIL;
+    BaseType_t xCore;
+    uint32_t ulSize = 64;
+    uint32_t * pulBuffers;
+
+    /* Ensure the logging task has not been created already. */
+    if( xRingsCreated == pdFALSE )
+    {
+        /* Round the ring size up to a power of two, so indexes can be masked
+         * rather than divided.  It must hold at least one message of maximum
+         * length. */
+        while( ( ulSize < loggingWORDS( uxQueueLength * loggingAVERAGE_MESSAGE_BYTES ) ) ||
+               ( ulSize < ( 2 * ( loggingFIXED_WORDS + 2 + loggingWORDS( configLOGGING_MAX_MESSAGE_LENGTH ) ) ) ) )
+        {
+            ulSize <<= 1;
+        }
+
+        /* The only allocation made by this file. */
+        pulBuffers = pvPortMalloc( ulSize * sizeof( uint32_t ) * configLOGGING_CORE_COUNT );
+
+        if( pulBuffers != NULL )
+        {
+            memset( pulBuffers, 0, ulSize * sizeof( uint32_t ) * configLOGGING_CORE_COUNT );
+            memset( xRings, 0, sizeof( xRings ) );
+
+            for( xCore = 0; xCore < configLOGGING_CORE_COUNT; xCore++ )
+            {
+                xRings[ xCore ].pulBuffer = pulBuffers + ( xCore * ulSize );
+                xRings[ xCore ].ulSize = ulSize;
+            }
+
+            xRingsCreated = pdTRUE;
+
+            if( xTaskCreate( prvLoggingTask, "Logging", usStackSize, NULL, uxPriority, NULL ) == pdPASS )
+            {
+                xReturn = pdPASS;
+            }
+            else
+            {
+                /* Could not create the task, so free the rings again. */
+                xRingsCreated = pdFALSE;
+                vPortFree( pulBuffers );
+            }
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoggingTask( void * pvParameters )
+{
+    BaseType_t xCore, xOutput;
+    uint32_t ulDropped, ulReportedDropped = 0;
+    char cMessage[ 48 ];
+
+    ( void ) pvParameters;
+
+    for( ;; )
+    {
+        xOutput = pdFALSE;
+
+        for( xCore = 0; xCore < configLOGGING_CORE_COUNT; xCore++ )
+        {
+            while( prvReadRecord( &xRings[ xCore ] ) == pdTRUE )
+            {
+                xOutput = pdTRUE;
+            }
+        }
+
+        /* Report messages that were lost, so a gap in the output is not
+         * mistaken for a gap in activity. */
+        ulDropped = 0;
+
+        for( xCore = 0; xCore < configLOGGING_CORE_COUNT; xCore++ )
+        {
+            ulDropped += xRings[ xCore ].ulDropped;
+        }
+
+        if( ulDropped != ulReportedDropped )
+        {
+            snprintf( cMessage, sizeof( cMessage ), "Logging: %lu messages dropped\r\n", ( unsigned long ) ( ulDropped - ulReportedDropped ) );
+            configPRINT_STRING( cMessage );
+            ulReportedDropped = ulDropped;
+        }
+
+        if( xOutput == pdFALSE )
+        {
+            vTaskDelay( pdMS_TO_TICKS( configLOGGING_POLL_PERIOD_MS ) );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*!
+ * \brief Records a message to be formatted and printed by
+ * the logging task.
+ *
+ * The message number, time (in ticks), and task that called
+ * vLoggingPrintf are prepended to each print statement when
+ * it is formatted.
+ *
+ */
+void vLoggingPrintf( const char * pcFormat,
+                     ... )
+{
+    va_list args;
+
+    va_start( args, pcFormat );
+
+    #if ( configLOGGING_INCLUDE_TIME_AND_TASK_NAME == 1 )
+        prvWriteRecord( pcFormat, args, ( strcmp( pcFormat, "\n" ) != 0 ) ? pdTRUE : pdFALSE );
+    #else
+        prvWriteRecord( pcFormat, args, pdFALSE );
+    #endif
+
+    va_end( args );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeferredPrint( const char * pcFormat,
+                              ... )
+{
+    va_list args;
+
+    va_start( args, pcFormat );
+    prvWriteRecord( pcFormat, args, pdFALSE );
+    va_end( args );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrint( const char * pcMessage )
+{
+    /* The message is copied into the record as a string argument, as it need
+     * not remain valid after this call. */
+    prvDeferredPrint( cStringFormat, pcMessage );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingGetStats( LoggingStats_t * pxStats )
+{
+    BaseType_t xCore;
+
+    configASSERT( pxStats );
+    memset( pxStats, 0, sizeof( LoggingStats_t ) );
+
+    for( xCore = 0; xCore < configLOGGING_CORE_COUNT; xCore++ )
+    {
+        pxStats->ulWritten += xRings[ xCore ].ulWritten;
+        pxStats->ulDropped += xRings[ xCore ].ulDropped;
+        pxStats->ulTruncated += xRings[ xCore ].ulTruncated;
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xLoggingFormat( char * pcBuffer,
+                       size_t xBufferLength,
+                       const char * pcFormat,
+                       va_list xArguments )
+{
+    uint32_t * pulRecord;
+    uint32_t ulWords, ulStringLengths[ loggingMAX_STRING_ARGUMENTS ];
+    BaseType_t xTruncated = pdFALSE;
+    size_t xLength = 0;
+    va_list xCopy;
+
+    configASSERT( ( pcBuffer != NULL ) && ( xBufferLength > 0 ) );
+    pcBuffer[ 0 ] = '\0';
+
+    va_copy( xCopy, xArguments );
+    ulWords = loggingFIXED_WORDS + prvCaptureArguments( pcFormat, &xCopy, NULL, ulStringLengths, &xTruncated );
+    va_end( xCopy );
+
+    /* The record is followed by the space in which prvFormatRecord()
+     * terminates string arguments. */
+    pulRecord = ( uint32_t * ) pvPortMalloc( ( ulWords * sizeof( uint32_t ) ) + loggingMAX_STRING_BYTES + 1 );
+
+    if( pulRecord != NULL )
+    {
+        pulRecord[ 0 ] = ( ulWords << loggingRECORD_LENGTH_SHIFT ) | loggingRECORD_COMMITTED;
+        pulRecord[ 1 ] = 0;
+        memcpy( &pulRecord[ 2 ], &pcFormat, sizeof( pcFormat ) );
+
+        va_copy( xCopy, xArguments );
+        ( void ) prvCaptureArguments( pcFormat, &xCopy, &pulRecord[ loggingFIXED_WORDS ], ulStringLengths, &xTruncated );
+        va_end( xCopy );
+
+        xLength = prvFormatRecord( pulRecord, pcBuffer, xBufferLength, ( char * ) &pulRecord[ ulWords ] );
+        vPortFree( pulRecord );
+    }
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingFlush( TickType_t xTicksToWait )
+{
+    BaseType_t xCore, xEmpty = pdFALSE;
+    uint32_t ulHeads[ configLOGGING_CORE_COUNT ];
+    TickType_t xStart = xTaskGetTickCount();
+
+    /* Only wait for the messages written before this call. */
+    for( xCore = 0; xCore < configLOGGING_CORE_COUNT; xCore++ )
+    {
+        ulHeads[ xCore ] = xRings[ xCore ].ulHead;
+    }
+
+    for( ; ; )
+    {
+        xEmpty = pdTRUE;
+
+        for( xCore = 0; xCore < configLOGGING_CORE_COUNT; xCore++ )
+        {
+            if( ( int32_t ) ( ulHeads[ xCore ] - xRings[ xCore ].ulTail ) > 0 )
+            {
+                xEmpty = pdFALSE;
+            }
+        }
+
+        if( ( xEmpty == pdTRUE ) || ( ( xTaskGetTickCount() - xStart ) >= xTicksToWait ) )
+        {
+            break;
+        }
+
+        vTaskDelay( 1 );
+    }
+
+    return ( xEmpty == pdTRUE ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvIncrement( volatile uint32_t * pulCounter )
+{
+    #if ( loggingHAS_COMPARE_AND_SWAP == 1 )
+        loggingATOMIC_INCREMENT( pulCounter );
+    #else
+        UBaseType_t uxSavedInterruptStatus;
+
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        ( *pulCounter )++;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteRecord( const char * pcFormat,
+                            va_list xArguments,
+                            BaseType_t xPrefix )
+{
+    LoggingRing_t * pxRing;
+    uint32_t * pulRecord;
+    uint32_t ulWords, ulHead, ulOffset, ulPadding, ulCommit;
+    uint32_t ulPrefixLength, ulStringLengths[ loggingMAX_STRING_ARGUMENTS ];
+    BaseType_t xReserved = pdFALSE, xTruncated = pdFALSE;
+    const char * pcTaskName = "None";
+    va_list xCopy;
+
+    /* The rings are created by xLoggingTaskInitialize().  Check
+     * xLoggingTaskInitialize() has been called. */
+    configASSERT( xRingsCreated );
+
+    pxRing = &xRings[ configLOGGING_GET_CORE_ID() ];
+
+    if( ( xPrefix == pdTRUE ) && ( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED ) )
+    {
+        pcTaskName = pcTaskGetName( NULL );
+    }
+
+    /* Measure the record without writing it. */
+    ulWords = loggingFIXED_WORDS;
+
+    if( xPrefix == pdTRUE )
+    {
+        ulWords += prvCaptureString( pcTaskName, NULL, &ulPrefixLength, &xTruncated );
+    }
+
+    va_copy( xCopy, xArguments );
+    ulWords += prvCaptureArguments( pcFormat, &xCopy, NULL, ulStringLengths, &xTruncated );
+    va_end( xCopy );
+
+    /* Reserve space for the record at the head of the ring.  A record never
+     * wraps, so if it does not fit before the end of the ring the rest of the
+     * ring is filled with padding. */
+    if( ulWords <= ( pxRing->ulSize / 2 ) )
+    {
+        #if ( loggingHAS_COMPARE_AND_SWAP == 1 )
+            do
+            {
+                ulHead = pxRing->ulHead;
+                ulOffset = ulHead & ( pxRing->ulSize - 1 );
+                ulPadding = ( ulWords > ( pxRing->ulSize - ulOffset ) ) ? ( pxRing->ulSize - ulOffset ) : 0;
+
+                if( ( ulHead + ulPadding + ulWords - pxRing->ulTail ) > pxRing->ulSize )
+                {
+                    break;
+                }
+
+                xReserved = loggingCOMPARE_AND_SWAP( &pxRing->ulHead, ulHead, ulHead + ulPadding + ulWords ) ? pdTRUE : pdFALSE;
+            } while( xReserved == pdFALSE );
+        #else
+            {
+                UBaseType_t uxSavedInterruptStatus;
+
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+                {
+                    ulHead = pxRing->ulHead;
+                    ulOffset = ulHead & ( pxRing->ulSize - 1 );
+                    ulPadding = ( ulWords > ( pxRing->ulSize - ulOffset ) ) ? ( pxRing->ulSize - ulOffset ) : 0;
+
+                    if( ( ulHead + ulPadding + ulWords - pxRing->ulTail ) <= pxRing->ulSize )
+                    {
+                        pxRing->ulHead = ulHead + ulPadding + ulWords;
+                        xReserved = pdTRUE;
+                    }
+                }
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+            }
+        #endif /* loggingHAS_COMPARE_AND_SWAP */
+    }
+
+    if( xReserved == pdFALSE )
+    {
+        prvIncrement( &pxRing->ulDropped );
+    }
+    else
+    {
+        if( ulPadding != 0 )
+        {
+            pxRing->pulBuffer[ ulOffset ] = ( ulPadding << loggingRECORD_LENGTH_SHIFT ) | loggingRECORD_PADDING | loggingRECORD_COMMITTED;
+        }
+
+        pulRecord = &pxRing->pulBuffer[ ( ulHead + ulPadding ) & ( pxRing->ulSize - 1 ) ];
+        pulRecord[ 1 ] = configLOGGING_TIMESTAMP();
+        memcpy( &pulRecord[ 2 ], &pcFormat, sizeof( pcFormat ) );
+        ulOffset = loggingFIXED_WORDS;
+        ulCommit = ( ulWords << loggingRECORD_LENGTH_SHIFT ) | loggingRECORD_COMMITTED;
+
+        if( xPrefix == pdTRUE )
+        {
+            ulOffset += prvCaptureString( pcTaskName, &pulRecord[ ulOffset ], &ulPrefixLength, &xTruncated );
+            ulCommit |= loggingRECORD_PREFIX;
+        }
+
+        va_copy( xCopy, xArguments );
+        ( void ) prvCaptureArguments( pcFormat, &xCopy, &pulRecord[ ulOffset ], ulStringLengths, &xTruncated );
+        va_end( xCopy );
+
+        /* Publish the record. */
+        loggingMEMORY_BARRIER();
+        *( ( volatile uint32_t * ) pulRecord ) = ulCommit;
+
+        prvIncrement( &pxRing->ulWritten );
+
+        if( xTruncated == pdTRUE )
+        {
+            prvIncrement( &pxRing->ulTruncated );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static const char * prvParseConversion( const char * pcSpecification,
+                                        LoggingArgument_t * peArgument,
+                                        BaseType_t * pxStars )
+{
+    const char * pc = pcSpecification;
+    char cLength = '\0';
+    BaseType_t xDoubled = pdFALSE;
+
+    *pxStars = 0;
+
+    /* Flags. */
+    while( ( *pc == '-' ) || ( *pc == '+' ) || ( *pc == ' ' ) || ( *pc == '#' ) || ( *pc == '0' ) )
+    {
+        pc++;
+    }
+
+    /* Width. */
+    if( *pc == '*' )
+    {
+        ( *pxStars )++;
+        pc++;
+    }
+
+    while( ( *pc >= '0' ) && ( *pc <= '9' ) )
+    {
+        pc++;
+    }
+
+    /* Precision. */
+    if( *pc == '.' )
+    {
+        pc++;
+
+        if( *pc == '*' )
+        {
+            ( *pxStars )++;
+            pc++;
+        }
+
+        while( ( *pc >= '0' ) && ( *pc <= '9' ) )
+        {
+            pc++;
+        }
+    }
+
+    /* Length modifier. */
+    if( ( *pc == 'h' ) || ( *pc == 'l' ) || ( *pc == 'z' ) || ( *pc == 'j' ) || ( *pc == 't' ) || ( *pc == 'L' ) )
+    {
+        cLength = *pc++;
+
+        if( ( ( cLength == 'h' ) || ( cLength == 'l' ) ) && ( *pc == cLength ) )
+        {
+            xDoubled = pdTRUE;
+            pc++;
+        }
+    }
+
+    switch( *pc )
+    {
+        case '%':
+            *peArgument = eArgumentNone;
+            break;
+
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        case 'c':
+
+            if( cLength == 'l' )
+            {
+                *peArgument = ( xDoubled == pdTRUE ) ? eArgumentLongLong : eArgumentLong;
+            }
+            else if( cLength == 'z' )
+            {
+                *peArgument = eArgumentSize;
+            }
+            else if( cLength == 'j' )
+            {
+                *peArgument = eArgumentIntMax;
+            }
+            else if( cLength == 't' )
+            {
+                *peArgument = eArgumentPtrDiff;
+            }
+            else if( cLength == 'L' )
+            {
+                *peArgument = eArgumentUnsupported;
+            }
+            else
+            {
+                *peArgument = eArgumentInt;
+            }
+
+            /* Wide characters are not supported. */
+            if( ( *pc == 'c' ) && ( cLength == 'l' ) )
+            {
+                *peArgument = eArgumentUnsupported;
+            }
+
+            break;
+
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            *peArgument = ( cLength == 'L' ) ? eArgumentLongDouble : eArgumentDouble;
+            break;
+
+        case 's':
+            *peArgument = ( cLength == '\0' ) ? eArgumentString : eArgumentUnsupported;
+            break;
+
+        case 'p':
+            *peArgument = eArgumentPointer;
+            break;
+
+        case 'n':
+            *peArgument = eArgumentCount;
+            break;
+
+        default:
+            *peArgument = eArgumentUnsupported;
+            break;
+    }
+
+    if( *pc != '\0' )
+    {
+        pc++;
+    }
+
+    return pc;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvCaptureString( const char * pcString,
+                                  uint32_t * pulOut,
+                                  uint32_t * pulLength,
+                                  BaseType_t * pxTruncated )
+{
+    uint32_t ulLength = 0;
+
+    if( pcString == NULL )
+    {
+        pcString = "(null)";
+    }
+
+    if( pulOut == NULL )
+    {
+        while( ( ulLength < loggingMAX_STRING_BYTES ) && ( pcString[ ulLength ] != '\0' ) )
+        {
+            ulLength++;
+        }
+
+        if( pcString[ ulLength ] != '\0' )
+        {
+            *pxTruncated = pdTRUE;
+        }
+
+        *pulLength = ulLength;
+    }
+    else
+    {
+        /* The length, then the characters without a terminator.  Only the
+         * measured length was reserved, even if the string has changed. */
+        ulLength = *pulLength;
+        pulOut[ 0 ] = ulLength;
+        memcpy( &pulOut[ 1 ], pcString, ulLength );
+    }
+
+    return 1 + loggingWORDS( ulLength );
+}
+/*-----------------------------------------------------------*/
+
+/* Capture one argument of type xType. */
+#define loggingCAPTURE( xType )                                      \
+    {                                                                \
+        xType xValue = ( xType ) va_arg( *pxArguments, xType );      \
+                                                                     \
+        if( pulOut != NULL )                                         \
+        {                                                            \
+            memcpy( &pulOut[ ulWords ], &xValue, sizeof( xValue ) ); \
+        }                                                            \
+                                                                     \
+        ulWords += loggingWORDS( sizeof( xValue ) );                 \
+    }
+
+static uint32_t prvCaptureArguments( const char * pcFormat,
+                                     va_list * pxArguments,
+                                     uint32_t * pulOut,
+                                     uint32_t * pulLengths,
+                                     BaseType_t * pxTruncated )
+{
+    const char * pc = pcFormat;
+    const char * pcString;
+    LoggingArgument_t eArgument = eArgumentNone;
+    BaseType_t xStars;
+    uint32_t ulWords = 0, ulStrings = 0, ulEmptyLength = 0;
+
+    while( ( *pc != '\0' ) && ( eArgument != eArgumentUnsupported ) )
+    {
+        if( *pc++ != '%' )
+        {
+            continue;
+        }
+
+        pc = prvParseConversion( pc, &eArgument, &xStars );
+
+        /* Widths and precisions given as arguments precede the value. */
+        for( ; ( xStars > 0 ) && ( eArgument != eArgumentUnsupported ); xStars-- )
+        {
+            loggingCAPTURE( int );
+        }
+
+        switch( eArgument )
+        {
+            case eArgumentInt:
+                loggingCAPTURE( int );
+                break;
+
+            case eArgumentLong:
+                loggingCAPTURE( long );
+                break;
+
+            case eArgumentLongLong:
+                loggingCAPTURE( long long );
+                break;
+
+            case eArgumentSize:
+                loggingCAPTURE( size_t );
+                break;
+
+            case eArgumentIntMax:
+                loggingCAPTURE( intmax_t );
+                break;
+
+            case eArgumentPtrDiff:
+                loggingCAPTURE( ptrdiff_t );
+                break;
+
+            case eArgumentPointer:
+                loggingCAPTURE( void * );
+                break;
+
+            case eArgumentDouble:
+                loggingCAPTURE( double );
+                break;
+
+            case eArgumentLongDouble:
+                loggingCAPTURE( long double );
+                break;
+
+            case eArgumentString:
+                pcString = va_arg( *pxArguments, const char * );
+
+                if( ulStrings < loggingMAX_STRING_ARGUMENTS )
+                {
+                    ulWords += prvCaptureString( pcString,
+                                                 ( pulOut != NULL ) ? &pulOut[ ulWords ] : NULL,
+                                                 &pulLengths[ ulStrings ],
+                                                 pxTruncated );
+                    ulStrings++;
+                }
+                else
+                {
+                    /* No length is kept for this string. */
+                    ulWords += prvCaptureString( "",
+                                                 ( pulOut != NULL ) ? &pulOut[ ulWords ] : NULL,
+                                                 &ulEmptyLength,
+                                                 pxTruncated );
+                    *pxTruncated = pdTRUE;
+                }
+
+                break;
+
+            case eArgumentCount:
+                ( void ) va_arg( *pxArguments, void * );
+                break;
+
+            default:
+
+                /* Nothing to capture for %%.  The arguments after an
+                 * unsupported conversion cannot be located, so capturing
+                 * stops, and the rest of the format is output as it is. */
+                break;
+        }
+    }
+
+    return ulWords;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReadRecord( LoggingRing_t * pxRing )
+{
+    static char cBuffer[ configLOGGING_MAX_MESSAGE_LENGTH ];
+    static char cString[ loggingMAX_STRING_BYTES + 1 ];
+    uint32_t ulTail, ulHeader, ulWords;
+    uint32_t * pulRecord;
+    BaseType_t xReturn = pdFALSE;
+
+    ulTail = pxRing->ulTail;
+
+    if( ulTail != pxRing->ulHead )
+    {
+        pulRecord = &pxRing->pulBuffer[ ulTail & ( pxRing->ulSize - 1 ) ];
+        ulHeader = *( ( volatile uint32_t * ) pulRecord );
+
+        /* The oldest record may still be being written, in which case the
+         * records after it must wait too. */
+        if( ( ulHeader & loggingRECORD_COMMITTED ) != 0 )
+        {
+            loggingMEMORY_BARRIER();
+            ulWords = ulHeader >> loggingRECORD_LENGTH_SHIFT;
+
+            if( ( ulHeader & loggingRECORD_PADDING ) == 0 )
+            {
+                #ifdef configLOGGING_OUTPUT_RECORD
+                    configLOGGING_OUTPUT_RECORD( pulRecord, ulWords );
+                #else
+                    if( prvFormatRecord( pulRecord, cBuffer, sizeof( cBuffer ), cString ) > 0 )
+                    {
+                        configPRINT_STRING( cBuffer );
+                    }
+                #endif
+            }
+
+            /* Records are recognised by their committed flag, so the space
+             * must be cleared before it is reused. */
+            memset( pulRecord, 0, ulWords * sizeof( uint32_t ) );
+            loggingMEMORY_BARRIER();
+            pxRing->ulTail = ulTail + ulWords;
+            xReturn = pdTRUE;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Format one captured argument of type xType with the specification in
+ * cSpecification. */
+#define loggingFORMAT( xType )                                                              \
+    {                                                                                       \
+        xType xValue;                                                                       \
+                                                                                            \
+        memcpy( &xValue, &pulRecord[ ulWord ], sizeof( xValue ) );                          \
+        ulWord += loggingWORDS( sizeof( xValue ) );                                         \
+        lWritten = snprintf( pcBuffer + xLength, xBufferLength - xLength, cSpecification, xValue ); \
+    }
+
+static size_t prvFormatRecord( const uint32_t * pulRecord,
+                               char * pcBuffer,
+                               size_t xBufferLength,
+                               char * pcString )
+{
+    static uint32_t ulMessageNumber = 0;
+    const char * pcFormat;
+    const char * pc;
+    const char * pcConversion;
+    char cSpecification[ 48 ];
+    LoggingArgument_t eArgument;
+    BaseType_t xStars;
+    int32_t lWritten, lStar;
+    uint32_t ulWord = loggingFIXED_WORDS, ulLength;
+    size_t xLength = 0, xSpecification;
+
+    memcpy( &pcFormat, &pulRecord[ 2 ], sizeof( pcFormat ) );
+    pcBuffer[ 0 ] = '\0';
+
+    if( ( pulRecord[ 0 ] & loggingRECORD_PREFIX ) != 0 )
+    {
+        ulLength = pulRecord[ ulWord ];
+        memcpy( pcString, &pulRecord[ ulWord + 1 ], ulLength );
+        pcString[ ulLength ] = '\0';
+        ulWord += 1 + loggingWORDS( ulLength );
+
+        lWritten = snprintf( pcBuffer, xBufferLength, "%lu %lu [%s] ",
+                             ( unsigned long ) ulMessageNumber++,
+                             ( unsigned long ) pulRecord[ 1 ],
+                             pcString );
+        xLength = ( lWritten > 0 ) ? ( size_t ) lWritten : 0;
+    }
+
+    for( pc = pcFormat; ( *pc != '\0' ) && ( xLength < ( xBufferLength - 1 ) ); )
+    {
+        if( *pc != '%' )
+        {
+            pcBuffer[ xLength++ ] = *pc++;
+            continue;
+        }
+
+        pcConversion = pc;
+        pc = prvParseConversion( pc + 1, &eArgument, &xStars );
+
+        if( eArgument == eArgumentUnsupported )
+        {
+            /* No arguments were captured after this one, so output the rest
+             * of the format as it is. */
+            for( pc = pcConversion; ( *pc != '\0' ) && ( xLength < ( xBufferLength - 1 ) ); )
+            {
+                pcBuffer[ xLength++ ] = *pc++;
+            }
+
+            break;
+        }
+
+        /* Copy the specification, replacing each '*' with the captured
+         * value.  A negative precision is treated as if it were omitted. */
+        xSpecification = 0;
+
+        for( ; ( pcConversion < pc ) && ( xSpecification < ( sizeof( cSpecification ) - 12 ) ); pcConversion++ )
+        {
+            if( ( *pcConversion == '.' ) && ( pcConversion[ 1 ] == '*' ) && ( ( int32_t ) pulRecord[ ulWord ] < 0 ) )
+            {
+                ulWord++;
+                pcConversion++;
+            }
+            else if( *pcConversion == '*' )
+            {
+                memcpy( &lStar, &pulRecord[ ulWord++ ], sizeof( lStar ) );
+                xSpecification += ( size_t ) snprintf( &cSpecification[ xSpecification ], 12, "%ld", ( long ) lStar );
+            }
+            else
+            {
+                cSpecification[ xSpecification++ ] = *pcConversion;
+            }
+        }
+
+        cSpecification[ xSpecification ] = '\0';
+        lWritten = 0;
+
+        switch( eArgument )
+        {
+            case eArgumentNone:
+                lWritten = snprintf( pcBuffer + xLength, xBufferLength - xLength, "%%" );
+                break;
+
+            case eArgumentInt:
+                loggingFORMAT( int );
+                break;
+
+            case eArgumentLong:
+                loggingFORMAT( long );
+                break;
+
+            case eArgumentLongLong:
+                loggingFORMAT( long long );
+                break;
+
+            case eArgumentSize:
+                loggingFORMAT( size_t );
+                break;
+
+            case eArgumentIntMax:
+                loggingFORMAT( intmax_t );
+                break;
+
+            case eArgumentPtrDiff:
+                loggingFORMAT( ptrdiff_t );
+                break;
+
+            case eArgumentPointer:
+                loggingFORMAT( void * );
+                break;
+
+            case eArgumentDouble:
+                loggingFORMAT( double );
+                break;
+
+            case eArgumentLongDouble:
+                loggingFORMAT( long double );
+                break;
+
+            case eArgumentString:
+                ulLength = pulRecord[ ulWord ];
+                memcpy( pcString, &pulRecord[ ulWord + 1 ], ulLength );
+                pcString[ ulLength ] = '\0';
+                ulWord += 1 + loggingWORDS( ulLength );
+                lWritten = snprintf( pcBuffer + xLength, xBufferLength - xLength, cSpecification, pcString );
+                break;
+
+            default:
+                break;
+        }
+
+        if( lWritten > 0 )
+        {
+            xLength += ( size_t ) lWritten;
+
+            if( xLength >= xBufferLength )
+            {
+                xLength = xBufferLength - 1;
+            }
+        }
+    }
+
+    pcBuffer[ xLength ] = '\0';
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,553 @@
+/*
+ * Amazon FreeRTOS V1.4.2
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * Throughput and latency benchmark for the POSIX simulator port and the
+ * VirtualSwitch FreeRTOS+TCP network interface.  Nothing leaves the host: the
+ * nodes are separate processes connected by the virtual switch, so the results
+ * depend only on the code under test and the link characteristics given on the
+ * command line.
+ *
+ * Usage:
+ *   aws_benchmark latency
+ *       Measure the time from raising a simulated interrupt in a host thread
+ *       to the task the interrupt handler notifies running.
+ *   aws_benchmark server [ <latency us> <loss per million> <bandwidth bps> ]
+ *       Run node 1, which echoes UDP datagrams and receives one TCP stream.
+ *   aws_benchmark client [ <latency us> <loss per million> <bandwidth bps> ]
+ *       Run node 2, which measures the UDP round trip time to node 1, then
+ *       sends node 1 a TCP stream and measures the throughput.
+ *
+ * Start the server before the client.  Every mode prints one result line per
+ * measurement, and exits with a non-zero status if the measurement failed.
+ */
+
+/* Standard includes. */
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "VirtualSwitch.h"
+
+/* The number of round trips measured by the latency benchmarks. */
+#define mainROUND_TRIPS              ( 2000 )
+
+/* The number of bytes sent by the TCP throughput benchmark. */
+#define mainTCP_STREAM_BYTES         ( 4UL * 1024UL * 1024UL )
+
+/* Size of the datagrams sent by the UDP round trip benchmark. */
+#define mainUDP_DATAGRAM_BYTES       ( 64 )
+
+/* How long the client waits for each UDP echo before counting it as lost. */
+#define mainUDP_TIMEOUT_MS           ( 100 )
+
+#define mainTCP_PORT                 ( 5000 )
+#define mainUDP_PORT                 ( 6000 )
+
+/* The simulated interrupt used by the latency mode.  Interrupts 0 and 1 are
+ * used by the kernel and 2 by the virtual switch. */
+#define mainLATENCY_INTERRUPT        ( 3 )
+
+#define mainSERVER_NODE              ( 1 )
+#define mainCLIENT_NODE              ( 2 )
+
+#define mainBENCHMARK_TASK_PRIORITY  ( tskIDLE_PRIORITY + 2 )
+#define mainBENCHMARK_STACK_SIZE     ( configMINIMAL_STACK_SIZE * 16 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Node 1: echoes every UDP datagram back to its sender.
+ */
+static void prvUDPEchoTask( void * pvParameters );
+
+/*
+ * Node 1: receives one TCP stream and reports the throughput.
+ */
+static void prvTCPSinkTask( void * pvParameters );
+
+/*
+ * Node 2: runs the UDP round trip and TCP throughput benchmarks against node 1.
+ */
+static void prvClientTask( void * pvParameters );
+
+/*
+ * Latency mode: the task woken by the simulated interrupt, the interrupt
+ * handler, and the host thread that raises the interrupt.
+ */
+static void prvInterruptLatencyTask( void * pvParameters );
+static void prvStartInterruptSourceTask( void * pvParameters );
+static uint32_t prvLatencyInterruptHandler( void );
+static void * prvInterruptSourceThread( void * pvParameters );
+
+/*
+ * Print the frame counters of this node's switch port.
+ */
+static void prvPrintSwitchStats( void );
+
+/*
+ * Stop the scheduler so main() returns the given exit status.
+ */
+static void prvFinish( int iStatus );
+
+/*
+ * Time from CLOCK_MONOTONIC, in microseconds.
+ */
+static uint64_t prvMicroseconds( void );
+
+/*-----------------------------------------------------------*/
+
+/* The node number, which is also the last byte of the node's IP and MAC
+ * addresses. */
+static uint8_t ucNode;
+
+/* Set by the network event hook when the IP stack is ready. */
+static volatile BaseType_t xNetworkUp = pdFALSE;
+
+/* Returned by main() once the scheduler has stopped. */
+static volatile int iExitStatus = EXIT_FAILURE;
+
+/* Latency mode state. */
+static TaskHandle_t xLatencyTask = NULL;
+static sem_t xLatencyDone;
+
+/* Buffer used by every socket benchmark.  Each node uses it from one task
+ * only, except the server, whose UDP echo and TCP sink tasks do not run at the
+ * same time. */
+static uint8_t ucBuffer[ 8192 ];
+
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char ** argv )
+{
+    static const uint8_t ucNetMask[ ipIP_ADDRESS_LENGTH_BYTES ] = { 255, 255, 255, 0 };
+    static const uint8_t ucGatewayAddress[ ipIP_ADDRESS_LENGTH_BYTES ] = { 10, 0, 0, 254 };
+    static const uint8_t ucDNSServerAddress[ ipIP_ADDRESS_LENGTH_BYTES ] = { 0, 0, 0, 0 };
+    uint8_t ucIPAddress[ ipIP_ADDRESS_LENGTH_BYTES ] = { 10, 0, 0, 0 };
+    uint8_t ucMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    VirtualSwitchLink_t xLink;
+
+    if( ( argc == 2 ) && ( strcmp( argv[ 1 ], "latency" ) == 0 ) )
+    {
+        sem_init( &xLatencyDone, 0, 0 );
+        vPortSetInterruptHandler( mainLATENCY_INTERRUPT, prvLatencyInterruptHandler );
+
+        /* The woken task has the highest priority so the measurement does not
+         * include waiting for other tasks. */
+        xTaskCreate( prvInterruptLatencyTask, "Latency", mainBENCHMARK_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, &xLatencyTask );
+        xTaskCreate( prvStartInterruptSourceTask, "Source", mainBENCHMARK_STACK_SIZE, NULL, mainBENCHMARK_TASK_PRIORITY, NULL );
+    }
+    else if( ( ( argc == 2 ) || ( argc == 5 ) ) &&
+             ( ( strcmp( argv[ 1 ], "server" ) == 0 ) || ( strcmp( argv[ 1 ], "client" ) == 0 ) ) )
+    {
+        ucNode = ( strcmp( argv[ 1 ], "server" ) == 0 ) ? mainSERVER_NODE : mainCLIENT_NODE;
+        ucIPAddress[ 3 ] = ucNode;
+        ucMACAddress[ 5 ] = ucNode;
+
+        /* Seed from the node number so every run of a node makes the same
+         * choices. */
+        srand( ucNode );
+
+        if( argc == 5 )
+        {
+            xLink.ulLatencyUs = ( uint32_t ) strtoul( argv[ 2 ], NULL, 0 );
+            xLink.ulLossPerMillion = ( uint32_t ) strtoul( argv[ 3 ], NULL, 0 );
+            xLink.ullBandwidthBps = ( uint64_t ) strtoull( argv[ 4 ], NULL, 0 );
+            xVirtualSwitchSetLink( &xLink );
+        }
+
+        FreeRTOS_IPInit( ucIPAddress, ucNetMask, ucGatewayAddress, ucDNSServerAddress, ucMACAddress );
+
+        if( ucNode == mainSERVER_NODE )
+        {
+            xTaskCreate( prvUDPEchoTask, "UDPEcho", mainBENCHMARK_STACK_SIZE, NULL, mainBENCHMARK_TASK_PRIORITY, NULL );
+            xTaskCreate( prvTCPSinkTask, "TCPSink", mainBENCHMARK_STACK_SIZE, NULL, mainBENCHMARK_TASK_PRIORITY, NULL );
+        }
+        else
+        {
+            xTaskCreate( prvClientTask, "Client", mainBENCHMARK_STACK_SIZE, NULL, mainBENCHMARK_TASK_PRIORITY, NULL );
+        }
+    }
+    else
+    {
+        fprintf( stderr, "usage: %s latency | server | client [ <latency us> <loss per million> <bandwidth bps> ]\n", argv[ 0 ] );
+
+        return EXIT_FAILURE;
+    }
+
+    vTaskStartScheduler();
+
+    return iExitStatus;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUDPEchoTask( void * pvParameters )
+{
+    Socket_t xSocket;
+    struct freertos_sockaddr xAddress;
+    uint32_t ulAddressLength = sizeof( xAddress );
+    int32_t lReceived;
+
+    ( void ) pvParameters;
+
+    while( xNetworkUp == pdFALSE )
+    {
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    }
+
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+    configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+
+    xAddress.sin_port = FreeRTOS_htons( mainUDP_PORT );
+    xAddress.sin_addr = 0;
+    FreeRTOS_bind( xSocket, &xAddress, sizeof( xAddress ) );
+
+    for( ; ; )
+    {
+        lReceived = FreeRTOS_recvfrom( xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xAddress, &ulAddressLength );
+
+        if( lReceived > 0 )
+        {
+            FreeRTOS_sendto( xSocket, ucBuffer, ( size_t ) lReceived, 0, &xAddress, sizeof( xAddress ) );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTCPSinkTask( void * pvParameters )
+{
+    Socket_t xListeningSocket, xConnectedSocket;
+    struct freertos_sockaddr xAddress;
+    socklen_t xAddressLength = sizeof( xAddress );
+    uint64_t ullStart, ullEnd, ullReceived = 0;
+    int32_t lReceived;
+
+    ( void ) pvParameters;
+
+    while( xNetworkUp == pdFALSE )
+    {
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    }
+
+    xListeningSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+    configASSERT( xListeningSocket != FREERTOS_INVALID_SOCKET );
+
+    xAddress.sin_port = FreeRTOS_htons( mainTCP_PORT );
+    xAddress.sin_addr = 0;
+    FreeRTOS_bind( xListeningSocket, &xAddress, sizeof( xAddress ) );
+    FreeRTOS_listen( xListeningSocket, 1 );
+
+    printf( "server: ready\n" );
+    fflush( stdout );
+
+    xConnectedSocket = FreeRTOS_accept( xListeningSocket, &xAddress, &xAddressLength );
+    configASSERT( xConnectedSocket != FREERTOS_INVALID_SOCKET );
+
+    /* Time from the first byte, so the measurement does not include waiting
+     * for the client to finish the UDP benchmark. */
+    lReceived = FreeRTOS_recv( xConnectedSocket, ucBuffer, sizeof( ucBuffer ), 0 );
+    ullStart = prvMicroseconds();
+
+    while( lReceived > 0 )
+    {
+        ullReceived += ( uint64_t ) lReceived;
+        lReceived = FreeRTOS_recv( xConnectedSocket, ucBuffer, sizeof( ucBuffer ), 0 );
+    }
+
+    ullEnd = prvMicroseconds();
+    FreeRTOS_closesocket( xConnectedSocket );
+    FreeRTOS_closesocket( xListeningSocket );
+
+    printf( "server: tcp_received_bytes=%llu tcp_throughput_mbps=%.2f\n",
+            ( unsigned long long ) ullReceived,
+            ( ullEnd > ullStart ) ? ( ( double ) ullReceived * 8.0 / ( double ) ( ullEnd - ullStart ) ) : 0.0 );
+    prvPrintSwitchStats();
+
+    prvFinish( ( ullReceived == mainTCP_STREAM_BYTES ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvClientTask( void * pvParameters )
+{
+    Socket_t xSocket;
+    struct freertos_sockaddr xServer, xFrom;
+    uint32_t ulFromLength = sizeof( xFrom );
+    TickType_t xTimeout = pdMS_TO_TICKS( mainUDP_TIMEOUT_MS );
+    uint64_t ullStart, ullEnd, ullSent = 0;
+    uint32_t ulReplies = 0, ulRoundTrip;
+    int32_t lResult;
+    int iStatus = EXIT_SUCCESS;
+
+    ( void ) pvParameters;
+
+    while( xNetworkUp == pdFALSE )
+    {
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    }
+
+    memset( ucBuffer, 0xa5, sizeof( ucBuffer ) );
+    xServer.sin_addr = FreeRTOS_inet_addr_quick( 10, 0, 0, mainSERVER_NODE );
+
+    /* UDP round trip time.  The first datagram also resolves the server's MAC
+     * address, so is sent before the timing starts. */
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+    configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+    FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+    xServer.sin_port = FreeRTOS_htons( mainUDP_PORT );
+
+    do
+    {
+        FreeRTOS_sendto( xSocket, ucBuffer, mainUDP_DATAGRAM_BYTES, 0, &xServer, sizeof( xServer ) );
+    } while( FreeRTOS_recvfrom( xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xFrom, &ulFromLength ) <= 0 );
+
+    ullStart = prvMicroseconds();
+
+    for( ulRoundTrip = 0; ulRoundTrip < mainROUND_TRIPS; ulRoundTrip++ )
+    {
+        FreeRTOS_sendto( xSocket, ucBuffer, mainUDP_DATAGRAM_BYTES, 0, &xServer, sizeof( xServer ) );
+
+        if( FreeRTOS_recvfrom( xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xFrom, &ulFromLength ) > 0 )
+        {
+            ulReplies++;
+        }
+    }
+
+    ullEnd = prvMicroseconds();
+    FreeRTOS_closesocket( xSocket );
+
+    printf( "client: udp_round_trips=%u udp_replies=%u udp_rtt_us=%.1f\n",
+            ( unsigned ) mainROUND_TRIPS,
+            ( unsigned ) ulReplies,
+            ( double ) ( ullEnd - ullStart ) / mainROUND_TRIPS );
+
+    if( ulReplies == 0 )
+    {
+        iStatus = EXIT_FAILURE;
+    }
+
+    /* TCP throughput, timed until the server has acknowledged the whole stream
+     * and closed the connection. */
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+    configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+    xServer.sin_port = FreeRTOS_htons( mainTCP_PORT );
+
+    if( FreeRTOS_connect( xSocket, &xServer, sizeof( xServer ) ) != 0 )
+    {
+        printf( "client: tcp connect failed\n" );
+        FreeRTOS_closesocket( xSocket );
+        prvFinish( EXIT_FAILURE );
+    }
+
+    ullStart = prvMicroseconds();
+
+    while( ullSent < mainTCP_STREAM_BYTES )
+    {
+        lResult = FreeRTOS_send( xSocket, ucBuffer, sizeof( ucBuffer ), 0 );
+
+        if( lResult < 0 )
+        {
+            printf( "client: tcp send failed %d\n", ( int ) lResult );
+            iStatus = EXIT_FAILURE;
+            break;
+        }
+
+        ullSent += ( uint64_t ) lResult;
+    }
+
+    FreeRTOS_shutdown( xSocket, FREERTOS_SHUT_RDWR );
+
+    while( FreeRTOS_recv( xSocket, ucBuffer, sizeof( ucBuffer ), 0 ) >= 0 )
+    {
+    }
+
+    ullEnd = prvMicroseconds();
+    FreeRTOS_closesocket( xSocket );
+
+    printf( "client: tcp_sent_bytes=%llu tcp_throughput_mbps=%.2f\n",
+            ( unsigned long long ) ullSent,
+            ( double ) ullSent * 8.0 / ( double ) ( ullEnd - ullStart ) );
+    prvPrintSwitchStats();
+
+    prvFinish( iStatus );
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptLatencyTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        sem_post( &xLatencyDone );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartInterruptSourceTask( void * pvParameters )
+{
+    pthread_t xThread;
+
+    ( void ) pvParameters;
+
+    /* Host threads must be created with the interrupt signals blocked, which
+     * they inherit from the critical section. */
+    taskENTER_CRITICAL();
+    {
+        pthread_create( &xThread, NULL, prvInterruptSourceThread, NULL );
+        pthread_detach( xThread );
+    }
+    taskEXIT_CRITICAL();
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvLatencyInterruptHandler( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    vTaskNotifyGiveFromISR( xLatencyTask, &xHigherPriorityTaskWoken );
+
+    return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvInterruptSourceThread( void * pvParameters )
+{
+    uint64_t ullStart, ullEnd;
+    uint32_t ulRoundTrip;
+
+    ( void ) pvParameters;
+
+    ullStart = prvMicroseconds();
+
+    for( ulRoundTrip = 0; ulRoundTrip < mainROUND_TRIPS; ulRoundTrip++ )
+    {
+        vPortGenerateSimulatedInterrupt( mainLATENCY_INTERRUPT );
+        sem_wait( &xLatencyDone );
+    }
+
+    ullEnd = prvMicroseconds();
+
+    printf( "latency: interrupts=%u interrupt_to_task_us=%.1f\n",
+            ( unsigned ) mainROUND_TRIPS,
+            ( double ) ( ullEnd - ullStart ) / mainROUND_TRIPS );
+
+    /* Only a task can end the scheduler, so exit the process directly. */
+    fflush( stdout );
+    exit( EXIT_SUCCESS );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintSwitchStats( void )
+{
+    VirtualSwitchStats_t xStats;
+
+    if( xVirtualSwitchGetStats( &xStats ) == pdPASS )
+    {
+        printf( "%s: frames_sent=%u frames_received=%u frames_lost=%u frames_dropped=%u\n",
+                ( ucNode == mainSERVER_NODE ) ? "server" : "client",
+                ( unsigned ) xStats.ulFramesSent,
+                ( unsigned ) xStats.ulFramesReceived,
+                ( unsigned ) xStats.ulFramesLost,
+                ( unsigned ) xStats.ulFramesDropped );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFinish( int iStatus )
+{
+    fflush( stdout );
+    iExitStatus = iStatus;
+    vTaskEndScheduler();
+
+    /* Not reached. */
+    for( ; ; )
+    {
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvMicroseconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000ULL ) + ( ( uint64_t ) xNow.tv_nsec / 1000ULL );
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationIPNetworkEventHook( eIPCallbackEvent_t eNetworkEvent )
+{
+    if( eNetworkEvent == eNetworkUp )
+    {
+        xNetworkUp = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulRand( void )
+{
+    return ( uint32_t ) rand();
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
+                                             uint16_t usSourcePort,
+                                             uint32_t ulDestinationAddress,
+                                             uint16_t usDestinationPort )
+{
+    ( void ) ulSourceAddress;
+    ( void ) usSourcePort;
+    ( void ) ulDestinationAddress;
+    ( void ) usDestinationPort;
+
+    return ulRand();
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char * pcFile,
+                    uint32_t ulLine )
+{
+    printf( "ASSERT: %s:%u\n", pcFile, ( unsigned ) ulLine );
+    fflush( stdout );
+    exit( EXIT_FAILURE );
+}
@@ -0,0 +1,95 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*****************************************************************************
+*
+* See the following URL for configuration information.
+* http://www.freertos.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_IP_Configuration.html
+*
+*****************************************************************************/
+
+#ifndef FREERTOS_IP_CONFIG_H
+#define FREERTOS_IP_CONFIG_H
+
+#include <stdio.h>
+
+/* Print FreeRTOS+TCP diagnostics straight to the console. */
+#define ipconfigHAS_DEBUG_PRINTF                   0
+#define ipconfigHAS_PRINTF                         1
+#define FreeRTOS_printf( X )    printf X
+
+/* The POSIX simulator only runs on little endian x86 and ARM hosts. */
+#define ipconfigBYTE_ORDER                         pdFREERTOS_LITTLE_ENDIAN
+
+/* The virtual switch does not calculate checksums. */
+#define ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM     0
+#define ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM     0
+
+/* The priority and stack of the IP task. */
+#define ipconfigIP_TASK_PRIORITY                   ( configMAX_PRIORITIES - 2 )
+#define ipconfigIP_TASK_STACK_SIZE_WORDS           ( configMINIMAL_STACK_SIZE * 10 )
+
+/* The benchmark seeds the C library generator, so the initial sequence
+ * numbers, and with them the whole run, are repeatable. */
+extern uint32_t ulRand( void );
+#define ipconfigRAND32()    ulRand()
+
+/* The benchmark waits for eNetworkUp before it opens sockets. */
+#define ipconfigUSE_NETWORK_EVENT_HOOK             1
+
+/* Nodes use fixed addresses, and no name resolution is needed. */
+#define ipconfigUSE_DHCP                           0
+#define ipconfigUSE_DNS                            0
+#define ipconfigUSE_LLMNR                          0
+#define ipconfigUSE_NBNS                           0
+
+#define ipconfigUSE_TCP                            1
+#define ipconfigUSE_TCP_WIN                        1
+#define ipconfigNETWORK_MTU                        1500
+#define ipconfigTCP_WIN_SEG_COUNT                  240
+#define ipconfigTCP_RX_BUFFER_LENGTH               ( 64 * 1024 )
+#define ipconfigTCP_TX_BUFFER_LENGTH               ( 64 * 1024 )
+
+#define ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS     60
+#define ipconfigEVENT_QUEUE_LENGTH                 ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS + 5 )
+#define ipconfigALLOW_SOCKET_SEND_WITHOUT_BIND     1
+#define ipconfigFILTER_OUT_NON_ETHERNET_II_FRAMES  1
+#define ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES    1
+#define ipconfigPACKET_FILLER_SIZE                 2
+#define ipconfigREPLY_TO_INCOMING_PINGS            1
+
+/* The virtual switch passes the frames that are due together to the IP task
+ * as one chain, which the IP task handles as one batch.  To measure the stack
+ * without batching, build with this in the environment:
+ * CFLAGS="-O2 -g -DipconfigRX_BATCH_SIZE=1 -DipconfigUSE_LINKED_RX_MESSAGES=0" */
+#ifndef ipconfigRX_BATCH_SIZE
+    #define ipconfigRX_BATCH_SIZE                  16
+#endif
+#ifndef ipconfigUSE_LINKED_RX_MESSAGES
+    #define ipconfigUSE_LINKED_RX_MESSAGES         1
+#endif
+
+#endif /* FREERTOS_IP_CONFIG_H */
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+#ifndef _AWS_MBEDTLS_CONFIG_H_
+#define _AWS_MBEDTLS_CONFIG_H_
+
+/**
+ * @file aws_mbedtls_config.h
+ * @brief Port-specific changes to the mbedTLS configuration.
+ *
+ * The project defines MBEDTLS_USER_CONFIG_FILE as this file, which
+ * mbedtls/config.h includes after its own settings. Options changed here
+ * apply to every file that includes an mbedTLS header, so the library and the
+ * code that uses it agree on the layout of the mbedTLS structures.
+ */
+
+/**
+ * @brief Accept session tickets from servers, so that the TLS session cache
+ * can also resume sessions with servers that keep no session state.
+ */
+#define MBEDTLS_SSL_SESSION_TICKETS
+
+#endif /* _AWS_MBEDTLS_CONFIG_H_ */
@@ -67,29 +67,158 @@ typedef struct pthread_mutex_internal
          )                               \
     )
 
+/**
+ * @brief Event group bits that threads waiting on a condition variable can
+ * block on.
+ *
+ * The top 8 bits of an event group are reserved by the kernel.
+ */
+#if ( configUSE_16_BIT_TICKS == 1 )
+    #define FREERTOS_POSIX_COND_WAITER_BITS    ( ( EventBits_t ) 0xFF )
+#else
+    #define FREERTOS_POSIX_COND_WAITER_BITS    ( ( EventBits_t ) 0xFFFFFF )
+#endif
+
 /**
  * @brief Condition variable.
+ *
+ * Each waiting thread blocks on its own bit of xCondWaitEventGroup, so that
+ * pthread_cond_broadcast wakes all of them with a single call. When all the
+ * bits are in use, further threads block on xCondWaitSemaphore instead.
  */
 typedef struct pthread_cond_internal
 {
-    BaseType_t xIsInitialized;            /**< Set to pdTRUE if this condition variable is initialized, pdFALSE otherwise. */
-    StaticSemaphore_t xCondMutex;         /**< Prevents concurrent accesses to iWaitingThreads. */
-    StaticSemaphore_t xCondWaitSemaphore; /**< Threads block on this semaphore in pthread_cond_wait. */
-    int iWaitingThreads;                  /**< The number of threads currently waiting on this condition variable. */
+    BaseType_t xIsInitialized;              /**< Set to pdTRUE if this condition variable is initialized, pdFALSE otherwise. */
+    StaticSemaphore_t xCondMutex;           /**< Prevents concurrent accesses to the waiter bookkeeping below. */
+    StaticSemaphore_t xCondWaitSemaphore;   /**< Threads block on this semaphore in pthread_cond_wait when no event group bit is free. */
+    StaticEventGroup_t xCondWaitEventGroup; /**< Threads block on a bit of this event group in pthread_cond_wait. */
+    EventBits_t uxWaiterBits;               /**< Bits of xCondWaitEventGroup that threads currently wait on. */
+    EventBits_t uxLastAllocatedBit;         /**< Bit most recently given to a waiting thread. */
+    EventBits_t uxLastSignaledBit;          /**< Bit most recently set by pthread_cond_signal. */
+    int iWaitingThreads;                    /**< The number of threads currently waiting on xCondWaitSemaphore. */
 } pthread_cond_internal_t;
 
 /**
  * @brief Compile-time initializer of pthread_cond_internal_t.
  */
-#define FREERTOS_POSIX_COND_INITIALIZER \
-    ( &( ( pthread_cond_internal_t )    \
-    {                                   \
-        .xIsInitialized = pdFALSE,      \
-        .xCondMutex = { { 0 } },        \
-        .xCondWaitSemaphore = { { 0 } },\
-        .iWaitingThreads = 0            \
-    }                                   \
-         )                              \
+#define FREERTOS_POSIX_COND_INITIALIZER  \
+    ( &( ( pthread_cond_internal_t )     \
+    {                                    \
+        .xIsInitialized = pdFALSE,       \
+        .xCondMutex = { { 0 } },         \
+        .xCondWaitSemaphore = { { 0 } }, \
+        .xCondWaitEventGroup = { 0 },    \
+        .uxWaiterBits = 0,               \
+        .uxLastAllocatedBit = 0,         \
+        .uxLastSignaledBit = 0,          \
+        .iWaitingThreads = 0             \
+    }                                    \
+         )                               \
+    )
+
+/**
+ * @brief Read-write lock.
+ *
+ * Writers are preferred: once a writer waits for the lock, new readers block
+ * until it has taken and released the lock.
+ */
+typedef struct pthread_rwlock_internal
+{
+    pthread_mutex_internal_t xMutex;      /**< Protects the members below. */
+    pthread_cond_internal_t xReadersCond; /**< Readers wait on this condition variable. */
+    pthread_cond_internal_t xWritersCond; /**< Writers wait on this condition variable. */
+    unsigned uReaders;                    /**< Number of threads holding a read lock. */
+    unsigned uWaitingReaders;             /**< Number of threads waiting for a read lock. */
+    unsigned uWaitingWriters;             /**< Number of threads waiting for the write lock. */
+    TaskHandle_t xWriter;                 /**< Thread holding the write lock, or NULL. */
+} pthread_rwlock_internal_t;
+
+/**
+ * @brief Compile-time initializer of pthread_rwlock_internal_t.
+ */
+#define FREERTOS_POSIX_RWLOCK_INITIALIZER              \
+    ( &( ( pthread_rwlock_internal_t )                 \
+    {                                                  \
+        .xMutex = { .xIsInitialized = pdFALSE },       \
+        .xReadersCond = { .xIsInitialized = pdFALSE }, \
+        .xWritersCond = { .xIsInitialized = pdFALSE }, \
+        .uReaders = 0,                                 \
+        .uWaitingReaders = 0,                          \
+        .uWaitingWriters = 0,                          \
+        .xWriter = NULL                                \
+    }                                                  \
+         )                                             \
     )
 
+/**
+ * @brief A thread in poll(), as registered with a message queue or semaphore
+ * it waits on.
+ */
+typedef struct poll_waiter_internal
+{
+    Link_t xLink;                   /**< Links the waiter into the list of waiters of the object. */
+    EventGroupHandle_t xEventGroup; /**< Event group on which the thread in poll() blocks. */
+    short sEvents;                  /**< Events the thread waits for, POLLIN and/or POLLOUT. */
+    BaseType_t xObjectDeleted;      /**< Set when the object is deleted while the thread is in poll(). */
+} poll_waiter_internal_t;
+
+/**
+ * @brief Event group bit set to wake a thread in poll() when a message queue
+ * or semaphore becomes ready.
+ *
+ * It is above the bits used by FreeRTOS+TCP socket sets, and fits in an event
+ * group when configUSE_16_BIT_TICKS is 1.
+ */
+#define FREERTOS_POSIX_POLL_WAKE_BIT    ( ( EventBits_t ) 0x80 )
+
+/**
+ * @brief Wake the threads in poll() that wait for any of sEvents on an object.
+ *
+ * @param[in] pxWaiterList List of poll_waiter_internal_t of the object.
+ * @param[in] sEvents Events that the object is now ready for.
+ *
+ * @return nothing
+ */
+void poll_wake_internal( Link_t * pxWaiterList,
+                         short sEvents );
+
+/**
+ * @brief Remove all threads in poll() from an object that is being deleted,
+ * and wake them.
+ *
+ * This must be called before the memory of the object is freed. The
+ * woken threads report POLLNVAL for the object and no longer access it.
+ *
+ * @param[in] pxWaiterList List of poll_waiter_internal_t of the object.
+ *
+ * @return nothing
+ */
+void poll_object_deleted_internal( Link_t * pxWaiterList );
+
+/**
+ * @brief Get the events a message queue is ready for, and optionally register
+ * a thread in poll() with it.
+ *
+ * @param[in] mqdes Message queue descriptor.
+ * @param[in] pxWaiter Waiter to add to the queue. If NULL, mqdes is not
+ * checked and must have been checked by an earlier call, and the caller must
+ * prevent the queue from being deleted during the call.
+ *
+ * @return POLLIN and/or POLLOUT, or POLLNVAL if mqdes is not an open queue.
+ */
+short mq_poll_internal( void * mqdes,
+                        poll_waiter_internal_t * pxWaiter );
+
+/**
+ * @brief Get the events a semaphore is ready for, and optionally register a
+ * thread in poll() with it.
+ *
+ * @param[in] sem Semaphore, as initialized by sem_init.
+ * @param[in] pxWaiter Waiter to add to the semaphore, or NULL.
+ *
+ * @return POLLIN if the semaphore can be taken without blocking, 0 otherwise.
+ */
+short sem_poll_internal( void * sem,
+                         poll_waiter_internal_t * pxWaiter );
+
 #endif /* _FREERTOS_POSIX_INTERNAL_H_ */
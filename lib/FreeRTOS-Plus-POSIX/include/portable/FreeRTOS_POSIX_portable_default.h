@@ -38,6 +38,18 @@
     #define posixconfigPTHREAD_TASK_NAME    "pthread"
 #endif
 
+/**
+ * @brief Number of times pthread_mutex_lock checks a locked mutex before
+ * blocking on it.
+ *
+ * Spinning only helps when the owner of the mutex can run at the same time as
+ * the caller, i.e. on SMP ports. On single-core ports, leave it at 0 so that
+ * the caller blocks at once.
+ */
+#ifndef posixconfigPTHREAD_MUTEX_SPIN_COUNT
+    #define posixconfigPTHREAD_MUTEX_SPIN_COUNT    0
+#endif
+
 /**
  * @brief the FreeRTOS timer name given to POSIX timers.
  */
@@ -56,8 +68,25 @@
 #ifndef posixconfigMQ_MAX_SIZE
     #define posixconfigMQ_MAX_SIZE    128 /**< Maximum size (in bytes) of each message. */
 #endif
+
+#ifndef posixconfigMQ_HASH_TABLE_SIZE
+    #define posixconfigMQ_HASH_TABLE_SIZE    8 /**< Number of buckets in the tables used to look up mqs by name and by descriptor. */
+#endif
+
+#ifndef posixconfigMQ_BUFFER_POOL_SIZE
+    #define posixconfigMQ_BUFFER_POOL_SIZE    2 /**< Maximum number of free message buffers each mq keeps for reuse. */
+#endif
 /**@} */
 
+/**
+ * @brief Set to 1 to allow poll() to wait on FreeRTOS+TCP sockets.
+ *
+ * This requires ipconfigSUPPORT_SELECT_FUNCTION to be 1 in FreeRTOSIPConfig.h.
+ */
+#ifndef posixconfigPOLL_FREERTOS_TCP_SOCKETS
+    #define posixconfigPOLL_FREERTOS_TCP_SOCKETS    0
+#endif
+
 /**
  * @defgroup POSIX implementation-dependent constants usually defined in limits.h.
  *
@@ -109,6 +138,12 @@
 #ifndef posixconfigENABLE_PTHREAD_MUTEXATTR_T
     #define posixconfigENABLE_PTHREAD_MUTEXATTR_T    1 /**< pthread_mutexattr_t in sys/types.h */
 #endif
+#ifndef posixconfigENABLE_PTHREAD_RWLOCK_T
+    #define posixconfigENABLE_PTHREAD_RWLOCK_T       1 /**< pthread_rwlock_t in sys/types.h */
+#endif
+#ifndef posixconfigENABLE_PTHREAD_RWLOCKATTR_T
+    #define posixconfigENABLE_PTHREAD_RWLOCKATTR_T   1 /**< pthread_rwlockattr_t in sys/types.h */
+#endif
 #ifndef posixconfigENABLE_PTHREAD_T
     #define posixconfigENABLE_PTHREAD_T              1 /**< pthread_t in sys/types.h */
 #endif
@@ -31,7 +31,9 @@
 #ifndef _FREERTOS_POSIX_PORTABLE_H_
 #define _FREERTOS_POSIX_PORTABLE_H_
 
-/* This port uses the defaults in FreeRTOS_POSIX_portable_default.h, so this
- * file is empty. */
+/* The simulator runs one task at a time, so spinning cannot see the mutex
+ * being released. It is enabled here only so that the test project builds
+ * the spin in pthread_mutex_lock and runs it in the pthread tests. */
+#define posixconfigPTHREAD_MUTEX_SPIN_COUNT    100
 
 #endif /* _FREERTOS_POSIX_PORTABLE_H_ */
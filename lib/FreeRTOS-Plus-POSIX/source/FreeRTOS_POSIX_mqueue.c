@@ -36,6 +36,7 @@
 #include "FreeRTOS_POSIX/errno.h"
 #include "FreeRTOS_POSIX/fcntl.h"
 #include "FreeRTOS_POSIX/mqueue.h"
+#include "FreeRTOS_POSIX/poll.h"
 #include "FreeRTOS_POSIX/utils.h"
 
 /**
@@ -47,24 +48,62 @@ typedef struct QueueElement
     size_t xDataSize; /**< Size of data pointed by pcData. */
 } QueueElement_t;
 
+/**
+ * @brief Header in front of every message buffer.
+ *
+ * Records the size the buffer was allocated with and the queue it was
+ * allocated for, so that a buffer is only kept for reuse or sent by the queue
+ * it belongs to.
+ */
+typedef union MessageBufferHeader
+{
+    struct
+    {
+        size_t xBufferSize;               /**< Bytes available after the header. */
+        const void * pvQueue;             /**< Queue whose pool the buffer belongs to. */
+    } xFields;                            /**< Header fields. */
+    char cAlignment[ portBYTE_ALIGNMENT ]; /**< Keeps the message aligned like pvPortMalloc memory. */
+} MessageBufferHeader_t;
+
+/**
+ * @brief Get the header of a message buffer.
+ */
+#define mqBUFFER_HEADER( pcBuffer )    ( ( ( MessageBufferHeader_t * ) ( pcBuffer ) ) - 1 )
+
 /**
  * @brief Data structure of an mq.
  *
  * FreeRTOS isn't guaranteed to have a file-like abstraction, so message
- * queues in this implementation are stored as a linked list (in RAM).
+ * queues in this implementation are stored in RAM, in two hash tables of
+ * linked lists: one indexed by name and one indexed by descriptor.
  */
 typedef struct QueueListElement
 {
-    Link_t xLink;              /**< Pointer to the next element in the list. */
+    Link_t xLink;              /**< Pointer to the next element in the name table bucket. */
+    Link_t xDescriptorLink;    /**< Pointer to the next element in the descriptor table bucket. */
     QueueHandle_t xQueue;      /**< FreeRTOS queue handle. */
     size_t xOpenDescriptors;   /**< Number of threads that have opened this queue. */
     char * pcName;             /**< Null-terminated queue name. */
     struct mq_attr xAttr;      /**< Queue attibutes. */
     BaseType_t xPendingUnlink; /**< If pdTRUE, this queue will be unlinked once all descriptors close. */
+    Link_t xPollWaiters;       /**< Threads in poll() on this queue. */
+    char * pcFreeBuffers;      /**< Message buffers kept for reuse, linked through their first bytes. */
+    size_t xFreeBufferCount;   /**< Number of buffers in pcFreeBuffers. */
 } QueueListElement_t;
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Allocate a new message buffer.
+ *
+ * @param[in] pxMessageQueue Queue whose pool the buffer belongs to.
+ * @param[in] xMessageSize Bytes the buffer must hold.
+ *
+ * @return The buffer; NULL if memory allocation failed.
+ */
+static char * prvAllocateBuffer( const QueueListElement_t * const pxMessageQueue,
+                                 size_t xMessageSize );
+
 /**
  * @brief Convert an absolute timespec into a tick timeout, taking into account
  * queue flags.
@@ -102,12 +141,27 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
  *
  * @return nothing
  */
-static void prvDeleteMessageQueue( const QueueListElement_t * const pxMessageQueue );
+static void prvDeleteMessageQueue( QueueListElement_t * const pxMessageQueue );
+
+/**
+ * @brief Free a message buffer.
+ *
+ * @param[in] pcBuffer The buffer to free.
+ *
+ * @return nothing
+ */
+static void prvFreeBuffer( char * pcBuffer );
 
 /**
  * @brief Attempt to find the queue identified by pcName or xMqId in the queue list.
  *
- * Matches queues by pcName first; if pcName is NULL, matches by xMqId.
+ * Matches queues by pcName if provided; if pcName is NULL, matches by xMqId.
+ * Only the hash table bucket of pcName or xMqId is searched, and xMqId is
+ * never dereferenced, so any value may be passed for it.
+ *
+ * Must be called with xQueueListMutex held. Matching by xMqId may also be done
+ * in a critical section instead, as the descriptor table is only modified in
+ * critical sections.
  * @param[out] ppxQueueListElement Output parameter set when queue is found.
  * @param[in] pcName A queue name to match.
  * @param[in] xMessageQueueDescriptor A queue descriptor to match.
@@ -118,15 +172,114 @@ static BaseType_t prvFindQueueInList( QueueListElement_t ** const ppxQueueListEl
                                       const char * const pcName,
                                       mqd_t xMessageQueueDescriptor );
 
+/**
+ * @brief Compute the bucket of a queue descriptor in the descriptor table.
+ *
+ * @param[in] xMessageQueueDescriptor The queue descriptor.
+ *
+ * @return Index of the bucket in xQueueDescriptorTable.
+ */
+static size_t prvHashDescriptor( mqd_t xMessageQueueDescriptor );
+
+/**
+ * @brief Compute the bucket of a queue name in the name table.
+ *
+ * @param[in] pcName The queue name.
+ *
+ * @return Index of the bucket in xQueueNameTable.
+ */
+static size_t prvHashName( const char * pcName );
+
 /**
  * @brief Initialize the queue list.
  *
- * Performs initialization of the queue list mutex and queue list head.
+ * Performs initialization of the queue list mutex and hash table buckets.
  *
  * @return nothing
  */
 static void prvInitializeQueueList( void );
 
+/**
+ * @brief Keep a message buffer for reuse by a queue.
+ *
+ * The buffer is kept only if it was allocated for the message size of the
+ * queue, and the queue keeps fewer than posixconfigMQ_BUFFER_POOL_SIZE buffers.
+ * Must be called in a critical section.
+ *
+ * @param[in] pxMessageQueue The queue to keep the buffer.
+ * @param[in] pcBuffer The buffer to keep.
+ *
+ * @return pdTRUE if the buffer was kept; pdFALSE if the caller must free it.
+ */
+static BaseType_t prvKeepBuffer( QueueListElement_t * const pxMessageQueue,
+                                 char * pcBuffer );
+
+/**
+ * @brief Receive a message from the FreeRTOS queue of an mq.
+ *
+ * Wakes the threads in poll() on the queue if a message was received.
+ * @param[in] pxMessageQueue The queue to receive from.
+ * @param[out] pxReceiveData The received message.
+ * @param[in] xTimeoutTicks How long to wait for a message.
+ *
+ * @return 0 if successful; EAGAIN or ETIMEDOUT otherwise.
+ */
+static int prvReceiveElement( QueueListElement_t * const pxMessageQueue,
+                              QueueElement_t * const pxReceiveData,
+                              TickType_t xTimeoutTicks );
+
+/**
+ * @brief Give a message buffer back to a queue, which keeps it for reuse if
+ * it can and frees it otherwise.
+ *
+ * @param[in] pxMessageQueue The queue to give the buffer to.
+ * @param[in] pcBuffer The buffer to give back.
+ *
+ * @return nothing
+ */
+static void prvReleaseBuffer( QueueListElement_t * const pxMessageQueue,
+                              char * pcBuffer );
+
+/**
+ * @brief Send a message to the FreeRTOS queue of an mq.
+ *
+ * Wakes the threads in poll() on the queue if the message was sent.
+ * @param[in] pxMessageQueue The queue to send to.
+ * @param[in] pxSendData The message to send.
+ * @param[in] xTimeoutTicks How long to wait for space in the queue.
+ *
+ * @return 0 if successful; EAGAIN or ETIMEDOUT otherwise.
+ */
+static int prvSendElement( QueueListElement_t * const pxMessageQueue,
+                           const QueueElement_t * const pxSendData,
+                           TickType_t xTimeoutTicks );
+
+/**
+ * @brief Take a message buffer kept for reuse by a queue.
+ *
+ * Must be called in a critical section.
+ *
+ * @param[in] pxMessageQueue The queue to take the buffer from.
+ *
+ * @return The buffer; NULL if the queue keeps none.
+ */
+static char * prvTakeBuffer( QueueListElement_t * const pxMessageQueue );
+
+/**
+ * @brief Check that a descriptor refers to an open queue, and convert a
+ * send or receive timeout for it.
+ *
+ * @param[in] xMessageQueueDescriptor The descriptor to check.
+ * @param[in] pxAbsoluteTimeout The absolute timeout to convert.
+ * @param[out] pxTimeoutTicks Output parameter of the timeout in ticks.
+ *
+ * @return 0 if successful; EBADF if the descriptor is invalid; otherwise,
+ * the error returned by prvCalculateTickTimeout.
+ */
+static int prvValidateDescriptor( mqd_t xMessageQueueDescriptor,
+                                  const struct timespec * const pxAbsoluteTimeout,
+                                  TickType_t * pxTimeoutTicks );
+
 /**
  * @brief Checks that pcName is a valid name for a message queue.
  *
@@ -145,9 +298,41 @@ static BaseType_t prvValidateQueueName( const char * const pcName,
 static StaticSemaphore_t xQueueListMutex = { { 0 } };
 
 /**
- * @brief Head of the linked list of queues.
+ * @brief Queues, hashed by name.
+ */
+static Link_t xQueueNameTable[ posixconfigMQ_HASH_TABLE_SIZE ] = { { 0 } };
+
+/**
+ * @brief Queues, hashed by descriptor.
  */
-static Link_t xQueueListHead = { 0 };
+static Link_t xQueueDescriptorTable[ posixconfigMQ_HASH_TABLE_SIZE ] = { { 0 } };
+
+/*-----------------------------------------------------------*/
+
+static char * prvAllocateBuffer( const QueueListElement_t * const pxMessageQueue,
+                                 size_t xMessageSize )
+{
+    MessageBufferHeader_t * pxHeader = NULL;
+    char * pcBuffer = NULL;
+
+    /* Free buffers are linked through their first bytes, so every buffer
+     * must be large enough to hold a pointer. */
+    if( xMessageSize < sizeof( char * ) )
+    {
+        xMessageSize = sizeof( char * );
+    }
+
+    pxHeader = pvPortMalloc( sizeof( MessageBufferHeader_t ) + xMessageSize );
+
+    if( pxHeader != NULL )
+    {
+        pxHeader->xFields.xBufferSize = xMessageSize;
+        pxHeader->xFields.pvQueue = pxMessageQueue;
+        pcBuffer = ( char * ) ( pxHeader + 1 );
+    }
+
+    return pcBuffer;
+}
 
 /*-----------------------------------------------------------*/
 
@@ -253,8 +438,19 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
         /* A newly-created queue will not be pending unlink. */
         ( *ppxMessageQueue )->xPendingUnlink = pdFALSE;
 
-        /* Add the new queue to the list. */
-        listADD( &xQueueListHead, &( *ppxMessageQueue )->xLink );
+        /* No thread is in poll() on a newly-created queue. */
+        listINIT_HEAD( &( *ppxMessageQueue )->xPollWaiters );
+
+        /* A newly-created queue has no buffers to reuse. */
+        ( *ppxMessageQueue )->pcFreeBuffers = NULL;
+        ( *ppxMessageQueue )->xFreeBufferCount = 0;
+
+        /* Add the new queue to the name and descriptor tables. */
+        listADD( &xQueueNameTable[ prvHashName( pcName ) ], &( *ppxMessageQueue )->xLink );
+        taskENTER_CRITICAL();
+        listADD( &xQueueDescriptorTable[ prvHashDescriptor( ( mqd_t ) *ppxMessageQueue ) ],
+                 &( *ppxMessageQueue )->xDescriptorLink );
+        taskEXIT_CRITICAL();
     }
 
     return xStatus;
@@ -262,9 +458,15 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
 
 /*-----------------------------------------------------------*/
 
-static void prvDeleteMessageQueue( const QueueListElement_t * const pxMessageQueue )
+static void prvDeleteMessageQueue( QueueListElement_t * const pxMessageQueue )
 {
     QueueElement_t xQueueElement = { 0 };
+    char * pcBuffer = pxMessageQueue->pcFreeBuffers;
+    char * pcNextBuffer = NULL;
+
+    /* Wake the threads in poll() on this queue, so that they no longer
+     * access it. */
+    poll_object_deleted_internal( &pxMessageQueue->xPollWaiters );
 
     /* Free all data in the queue. It's assumed that no more data will be added
      * to the queue, so xQueueReceive does not block. */
@@ -272,7 +474,15 @@ static void prvDeleteMessageQueue( const QueueListElement_t * const pxMessageQue
                           ( void * ) &xQueueElement,
                           0 ) == pdTRUE )
     {
-        vPortFree( xQueueElement.pcData );
+        prvFreeBuffer( xQueueElement.pcData );
+    }
+
+    /* Free the buffers kept for reuse. */
+    while( pcBuffer != NULL )
+    {
+        pcNextBuffer = *( ( char ** ) pcBuffer );
+        prvFreeBuffer( pcBuffer );
+        pcBuffer = pcNextBuffer;
     }
 
     /* Free memory used by this message queue. */
@@ -288,23 +498,37 @@ static BaseType_t prvFindQueueInList( QueueListElement_t ** const ppxQueueListEl
                                       mqd_t xMessageQueueDescriptor )
 {
     Link_t * pxQueueListLink = NULL;
+    Link_t * pxBucket = NULL;
     QueueListElement_t * pxMessageQueue = NULL;
     BaseType_t xQueueFound = pdFALSE;
 
-    /* Iterate through the list of queues. */
-    listFOR_EACH( pxQueueListLink, &xQueueListHead )
+    /* Match by name if provided. */
+    if( pcName != NULL )
     {
-        pxMessageQueue = listCONTAINER( pxQueueListLink, QueueListElement_t, xLink );
+        pxBucket = &xQueueNameTable[ prvHashName( pcName ) ];
 
-        /* Match by name first if provided. */
-        if( ( pcName != NULL ) && ( strcmp( pxMessageQueue->pcName, pcName ) == 0 ) )
+        /* Iterate through the queues whose name hashes to the same bucket. */
+        listFOR_EACH( pxQueueListLink, pxBucket )
         {
-            xQueueFound = pdTRUE;
-            break;
+            pxMessageQueue = listCONTAINER( pxQueueListLink, QueueListElement_t, xLink );
+
+            if( strcmp( pxMessageQueue->pcName, pcName ) == 0 )
+            {
+                xQueueFound = pdTRUE;
+                break;
+            }
         }
-        /* If name doesn't match, match by descriptor. */
-        else
+    }
+    /* Otherwise, match by descriptor. */
+    else
+    {
+        pxBucket = &xQueueDescriptorTable[ prvHashDescriptor( xMessageQueueDescriptor ) ];
+
+        /* Iterate through the queues whose descriptor hashes to the same bucket. */
+        listFOR_EACH( pxQueueListLink, pxBucket )
         {
+            pxMessageQueue = listCONTAINER( pxQueueListLink, QueueListElement_t, xDescriptorLink );
+
             if( ( mqd_t ) pxMessageQueue == xMessageQueueDescriptor )
             {
                 xQueueFound = pdTRUE;
@@ -324,10 +548,43 @@ static BaseType_t prvFindQueueInList( QueueListElement_t ** const ppxQueueListEl
 
 /*-----------------------------------------------------------*/
 
+static void prvFreeBuffer( char * pcBuffer )
+{
+    vPortFree( mqBUFFER_HEADER( pcBuffer ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t prvHashDescriptor( mqd_t xMessageQueueDescriptor )
+{
+    /* Descriptors point to allocated memory, so their lowest bits are
+     * always clear. Drop them so that all buckets are used. */
+    return ( size_t ) ( ( ( uintptr_t ) xMessageQueueDescriptor >> 3 ) % posixconfigMQ_HASH_TABLE_SIZE );
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t prvHashName( const char * pcName )
+{
+    uint32_t ulHash = 5381;
+
+    /* djb2 string hash. */
+    while( *pcName != '\0' )
+    {
+        ulHash = ( ( ulHash << 5 ) + ulHash ) + ( uint8_t ) *pcName;
+        pcName++;
+    }
+
+    return ( size_t ) ( ulHash % posixconfigMQ_HASH_TABLE_SIZE );
+}
+
+/*-----------------------------------------------------------*/
+
 static void prvInitializeQueueList( void )
 {
     /* Keep track of whether the queue list has been initialized. */
     static BaseType_t xQueueListInitialized = pdFALSE;
+    size_t xBucket = 0;
 
     /* Check if queue list needs to be initialized. */
     if( xQueueListInitialized == pdFALSE )
@@ -341,9 +598,15 @@ static void prvInitializeQueueList( void )
          * section. */
         if( xQueueListInitialized == pdFALSE )
         {
-            /* Initialize the queue list mutex and list head. */
+            /* Initialize the queue list mutex and hash table buckets. */
             ( void ) xSemaphoreCreateMutexStatic( &xQueueListMutex );
-            listINIT_HEAD( &xQueueListHead );
+
+            for( xBucket = 0; xBucket < posixconfigMQ_HASH_TABLE_SIZE; xBucket++ )
+            {
+                listINIT_HEAD( &xQueueNameTable[ xBucket ] );
+                listINIT_HEAD( &xQueueDescriptorTable[ xBucket ] );
+            }
+
             xQueueListInitialized = pdTRUE;
         }
 
@@ -354,6 +617,176 @@ static void prvInitializeQueueList( void )
 
 /*-----------------------------------------------------------*/
 
+static BaseType_t prvKeepBuffer( QueueListElement_t * const pxMessageQueue,
+                                 char * pcBuffer )
+{
+    BaseType_t xKept = pdFALSE;
+    size_t xMessageSize = ( size_t ) pxMessageQueue->xAttr.mq_msgsize;
+
+    /* prvAllocateBuffer rounds small sizes up to hold a pointer. */
+    if( xMessageSize < sizeof( char * ) )
+    {
+        xMessageSize = sizeof( char * );
+    }
+
+    /* Only keep buffers this queue allocated, so that a buffer from another
+     * queue is never handed out by this one. A queue allocated where a
+     * deleted one was is told apart by the size of its buffers. */
+    if( ( mqBUFFER_HEADER( pcBuffer )->xFields.pvQueue == pxMessageQueue ) &&
+        ( mqBUFFER_HEADER( pcBuffer )->xFields.xBufferSize == xMessageSize ) &&
+        ( pxMessageQueue->xFreeBufferCount < ( size_t ) posixconfigMQ_BUFFER_POOL_SIZE ) )
+    {
+        *( ( char ** ) pcBuffer ) = pxMessageQueue->pcFreeBuffers;
+        pxMessageQueue->pcFreeBuffers = pcBuffer;
+        pxMessageQueue->xFreeBufferCount++;
+        xKept = pdTRUE;
+    }
+
+    return xKept;
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvReceiveElement( QueueListElement_t * const pxMessageQueue,
+                              QueueElement_t * const pxReceiveData,
+                              TickType_t xTimeoutTicks )
+{
+    int iStatus = 0;
+
+    /* Receive data from the FreeRTOS queue. */
+    if( xQueueReceive( pxMessageQueue->xQueue,
+                       pxReceiveData,
+                       xTimeoutTicks ) == pdFALSE )
+    {
+        /* If queue receive fails, return the appropriate errno. */
+        if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
+        {
+            /* Return EAGAIN for nonblocking mq. */
+            iStatus = EAGAIN;
+        }
+        else
+        {
+            /* Otherwise, return ETIMEDOUT. */
+            iStatus = ETIMEDOUT;
+        }
+    }
+    else
+    {
+        /* There is now space in the queue; wake the threads in poll() on it. */
+        poll_wake_internal( &pxMessageQueue->xPollWaiters, POLLOUT );
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvReleaseBuffer( QueueListElement_t * const pxMessageQueue,
+                              char * pcBuffer )
+{
+    BaseType_t xKept = pdFALSE;
+
+    /* Keep the buffer for reuse if the queue can. */
+    taskENTER_CRITICAL();
+    xKept = prvKeepBuffer( pxMessageQueue, pcBuffer );
+    taskEXIT_CRITICAL();
+
+    /* Otherwise, free it. */
+    if( xKept == pdFALSE )
+    {
+        prvFreeBuffer( pcBuffer );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvSendElement( QueueListElement_t * const pxMessageQueue,
+                           const QueueElement_t * const pxSendData,
+                           TickType_t xTimeoutTicks )
+{
+    int iStatus = 0;
+
+    /* Send data to the FreeRTOS queue. */
+    if( xQueueSend( pxMessageQueue->xQueue,
+                    pxSendData,
+                    xTimeoutTicks ) == pdFALSE )
+    {
+        /* If queue send fails, return the appropriate errno. */
+        if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
+        {
+            /* Return EAGAIN for nonblocking mq. */
+            iStatus = EAGAIN;
+        }
+        else
+        {
+            /* Otherwise, return ETIMEDOUT. */
+            iStatus = ETIMEDOUT;
+        }
+    }
+    else
+    {
+        /* Wake the threads in poll() on this queue. */
+        poll_wake_internal( &pxMessageQueue->xPollWaiters, POLLIN );
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static char * prvTakeBuffer( QueueListElement_t * const pxMessageQueue )
+{
+    char * pcBuffer = pxMessageQueue->pcFreeBuffers;
+
+    if( pcBuffer != NULL )
+    {
+        pxMessageQueue->pcFreeBuffers = *( ( char ** ) pcBuffer );
+        pxMessageQueue->xFreeBufferCount--;
+    }
+
+    return pcBuffer;
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvValidateDescriptor( mqd_t xMessageQueueDescriptor,
+                                  const struct timespec * const pxAbsoluteTimeout,
+                                  TickType_t * pxTimeoutTicks )
+{
+    int iStatus = 0;
+    long lMessageQueueFlags = 0;
+    QueueListElement_t * pxMessageQueue = NULL;
+
+    /* Every send and receive comes through here, so the descriptor is looked
+     * up in a short critical section rather than with xQueueListMutex. */
+    taskENTER_CRITICAL();
+
+    /* Find the mq referenced by the descriptor. */
+    if( prvFindQueueInList( &pxMessageQueue, NULL, xMessageQueueDescriptor ) == pdTRUE )
+    {
+        lMessageQueueFlags = pxMessageQueue->xAttr.mq_flags;
+    }
+    else
+    {
+        /* Queue not found; bad descriptor. */
+        iStatus = EBADF;
+    }
+
+    taskEXIT_CRITICAL();
+
+    if( iStatus == 0 )
+    {
+        /* Convert the absolute timeout to a tick timeout. */
+        iStatus = prvCalculateTickTimeout( lMessageQueueFlags,
+                                           pxAbsoluteTimeout,
+                                           pxTimeoutTicks );
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvValidateQueueName( const char * const pcName,
                                         size_t * pxNameLength )
 {
@@ -417,6 +850,9 @@ int mq_close( mqd_t mqdes )
             if( pxMessageQueue->xPendingUnlink == pdTRUE )
             {
                 listREMOVE( &pxMessageQueue->xLink );
+                taskENTER_CRITICAL();
+                listREMOVE( &pxMessageQueue->xDescriptorLink );
+                taskEXIT_CRITICAL();
 
                 /* Set the flag to delete the queue. Deleting the queue is deferred
                  * until xQueueListMutex is released. */
@@ -627,7 +1063,7 @@ ssize_t mq_timedreceive( mqd_t mqdes,
                          const struct timespec * abstime )
 {
     ssize_t xStatus = 0;
-    int iCalculateTimeoutReturn = 0;
+    int iError = 0;
     TickType_t xTimeoutTicks = 0;
     QueueListElement_t * pxMessageQueue = ( QueueListElement_t * ) mqdes;
     QueueElement_t xReceiveData = { 0 };
@@ -635,15 +1071,12 @@ ssize_t mq_timedreceive( mqd_t mqdes,
     /* Silence warnings about unused parameters. */
     ( void ) msg_prio;
 
-    /* Lock the mutex that guards access to the queue list. This call will
-     * never fail because it blocks forever. */
-    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &xQueueListMutex, portMAX_DELAY );
+    /* Check the descriptor and convert abstime to a tick timeout. */
+    iError = prvValidateDescriptor( mqdes, abstime, &xTimeoutTicks );
 
-    /* Find the mq referenced by mqdes. */
-    if( prvFindQueueInList( NULL, NULL, mqdes ) == pdFALSE )
+    if( iError != 0 )
     {
-        /* Queue not found; bad descriptor. */
-        errno = EBADF;
+        errno = iError;
         xStatus = -1;
     }
 
@@ -658,42 +1091,14 @@ ssize_t mq_timedreceive( mqd_t mqdes,
         }
     }
 
-    if( xStatus == 0 )
-    {
-        /* Convert abstime to a tick timeout. */
-        iCalculateTimeoutReturn = prvCalculateTickTimeout( pxMessageQueue->xAttr.mq_flags,
-                                                           abstime,
-                                                           &xTimeoutTicks );
-
-        if( iCalculateTimeoutReturn != 0 )
-        {
-            errno = iCalculateTimeoutReturn;
-            xStatus = -1;
-        }
-    }
-
-    /* Release the mutex protecting the queue list. */
-    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &xQueueListMutex );
-
     if( xStatus == 0 )
     {
         /* Receive data from the FreeRTOS queue. */
-        if( xQueueReceive( pxMessageQueue->xQueue,
-                           &xReceiveData,
-                           xTimeoutTicks ) == pdFALSE )
-        {
-            /* If queue receive fails, set the appropriate errno. */
-            if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
-            {
-                /* Set errno to EAGAIN for nonblocking mq. */
-                errno = EAGAIN;
-            }
-            else
-            {
-                /* Otherwise, set errno to ETIMEDOUT. */
-                errno = ETIMEDOUT;
-            }
+        iError = prvReceiveElement( pxMessageQueue, &xReceiveData, xTimeoutTicks );
 
+        if( iError != 0 )
+        {
+            errno = iError;
             xStatus = -1;
         }
     }
@@ -703,9 +1108,10 @@ ssize_t mq_timedreceive( mqd_t mqdes,
         /* Get the length of data for return value. */
         xStatus = ( ssize_t ) xReceiveData.xDataSize;
 
-        /* Copy received data into given buffer, then free it. */
+        /* Copy received data into given buffer, then give the buffer back to
+         * the queue. */
         ( void ) memcpy( msg_ptr, xReceiveData.pcData, xReceiveData.xDataSize );
-        vPortFree( xReceiveData.pcData );
+        prvReleaseBuffer( pxMessageQueue, xReceiveData.pcData );
     }
 
     return xStatus;
@@ -719,7 +1125,7 @@ int mq_timedsend( mqd_t mqdes,
                   unsigned int msg_prio,
                   const struct timespec * abstime )
 {
-    int iStatus = 0, iCalculateTimeoutReturn = 0;
+    int iStatus = 0, iError = 0;
     TickType_t xTimeoutTicks = 0;
     QueueListElement_t * pxMessageQueue = ( QueueListElement_t * ) mqdes;
     QueueElement_t xSendData = { 0 };
@@ -727,15 +1133,12 @@ int mq_timedsend( mqd_t mqdes,
     /* Silence warnings about unused parameters. */
     ( void ) msg_prio;
 
-    /* Lock the mutex that guards access to the queue list. This call will
-     * never fail because it blocks forever. */
-    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &xQueueListMutex, portMAX_DELAY );
+    /* Check the descriptor and convert abstime to a tick timeout. */
+    iError = prvValidateDescriptor( mqdes, abstime, &xTimeoutTicks );
 
-    /* Find the mq referenced by mqdes. */
-    if( prvFindQueueInList( NULL, NULL, mqdes ) == pdFALSE )
+    if( iError != 0 )
     {
-        /* Queue not found; bad descriptor. */
-        errno = EBADF;
+        errno = iError;
         iStatus = -1;
     }
 
@@ -750,28 +1153,21 @@ int mq_timedsend( mqd_t mqdes,
         }
     }
 
+    /* Get a buffer for the message. */
     if( iStatus == 0 )
     {
-        /* Convert abstime to a tick timeout. */
-        iCalculateTimeoutReturn = prvCalculateTickTimeout( pxMessageQueue->xAttr.mq_flags,
-                                                           abstime,
-                                                           &xTimeoutTicks );
+        xSendData.xDataSize = msg_len;
+
+        /* Take a buffer kept for reuse, if there is one. Otherwise, allocate
+         * a new one. */
+        taskENTER_CRITICAL();
+        xSendData.pcData = prvTakeBuffer( pxMessageQueue );
+        taskEXIT_CRITICAL();
 
-        if( iCalculateTimeoutReturn != 0 )
+        if( xSendData.pcData == NULL )
         {
-            errno = iCalculateTimeoutReturn;
-            iStatus = -1;
+            xSendData.pcData = prvAllocateBuffer( pxMessageQueue, ( size_t ) pxMessageQueue->xAttr.mq_msgsize );
         }
-    }
-
-    /* Release the mutex protecting the queue list. */
-    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &xQueueListMutex );
-
-    /* Allocate memory for the message. */
-    if( iStatus == 0 )
-    {
-        xSendData.xDataSize = msg_len;
-        xSendData.pcData = pvPortMalloc( msg_len );
 
         /* Check that memory allocation succeeded. */
         if( xSendData.pcData == NULL )
@@ -790,24 +1186,14 @@ int mq_timedsend( mqd_t mqdes,
     if( iStatus == 0 )
     {
         /* Send data to the FreeRTOS queue. */
-        if( xQueueSend( pxMessageQueue->xQueue,
-                        &xSendData,
-                        xTimeoutTicks ) == pdFALSE )
+        iError = prvSendElement( pxMessageQueue, &xSendData, xTimeoutTicks );
+
+        if( iError != 0 )
         {
-            /* If queue send fails, set the appropriate errno. */
-            if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
-            {
-                /* Set errno to EAGAIN for nonblocking mq. */
-                errno = EAGAIN;
-            }
-            else
-            {
-                /* Otherwise, set errno to ETIMEDOUT. */
-                errno = ETIMEDOUT;
-            }
+            errno = iError;
 
-            /* Free the allocated queue data. */
-            vPortFree( xSendData.pcData );
+            /* Give the unsent buffer back to the queue. */
+            prvReleaseBuffer( pxMessageQueue, xSendData.pcData );
 
             iStatus = -1;
         }
@@ -850,6 +1236,9 @@ int mq_unlink( const char * name )
             if( pxMessageQueue->xOpenDescriptors == 0 )
             {
                 listREMOVE( &pxMessageQueue->xLink );
+                taskENTER_CRITICAL();
+                listREMOVE( &pxMessageQueue->xDescriptorLink );
+                taskEXIT_CRITICAL();
 
                 /* Set the flag to delete the queue. Deleting the queue is deferred
                  * until xQueueListMutex is released. */
@@ -883,3 +1272,259 @@ int mq_unlink( const char * name )
 }
 
 /*-----------------------------------------------------------*/
+
+char * mq_zc_alloc( mqd_t mqdes )
+{
+    char * pcBuffer = NULL;
+    size_t xMessageSize = 0;
+    BaseType_t xQueueFound = pdFALSE;
+    QueueListElement_t * pxMessageQueue = NULL;
+
+    /* Find the mq referenced by mqdes, and take a buffer it keeps for reuse.
+     * Both are done in one critical section, so the queue cannot be deleted
+     * in between. */
+    taskENTER_CRITICAL();
+    xQueueFound = prvFindQueueInList( &pxMessageQueue, NULL, mqdes );
+
+    if( xQueueFound == pdTRUE )
+    {
+        pcBuffer = prvTakeBuffer( pxMessageQueue );
+        xMessageSize = ( size_t ) pxMessageQueue->xAttr.mq_msgsize;
+    }
+
+    taskEXIT_CRITICAL();
+
+    if( xQueueFound == pdTRUE )
+    {
+        /* Otherwise, allocate a new one. */
+        if( pcBuffer == NULL )
+        {
+            pcBuffer = prvAllocateBuffer( pxMessageQueue, xMessageSize );
+        }
+
+        if( pcBuffer == NULL )
+        {
+            errno = ENOMEM;
+        }
+    }
+    else
+    {
+        /* Queue not found; bad descriptor. */
+        errno = EBADF;
+    }
+
+    return pcBuffer;
+}
+
+/*-----------------------------------------------------------*/
+
+void mq_zc_free( mqd_t mqdes,
+                 char * msg_ptr )
+{
+    BaseType_t xKept = pdFALSE;
+    QueueListElement_t * pxMessageQueue = NULL;
+
+    if( msg_ptr != NULL )
+    {
+        /* Find the mq referenced by mqdes and give the buffer back to it in
+         * one critical section, so the queue cannot be deleted in between. */
+        taskENTER_CRITICAL();
+
+        if( prvFindQueueInList( &pxMessageQueue, NULL, mqdes ) == pdTRUE )
+        {
+            xKept = prvKeepBuffer( pxMessageQueue, msg_ptr );
+        }
+
+        taskEXIT_CRITICAL();
+
+        /* Free the buffer if the queue has been removed or cannot keep it. */
+        if( xKept == pdFALSE )
+        {
+            prvFreeBuffer( msg_ptr );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+ssize_t mq_zc_timedreceive( mqd_t mqdes,
+                            char ** msg_ptr,
+                            unsigned * msg_prio,
+                            const struct timespec * abstime )
+{
+    ssize_t xStatus = 0;
+    int iError = 0;
+    TickType_t xTimeoutTicks = 0;
+    QueueElement_t xReceiveData = { 0 };
+
+    /* Silence warnings about unused parameters. */
+    ( void ) msg_prio;
+
+    if( msg_ptr == NULL )
+    {
+        errno = EINVAL;
+        xStatus = -1;
+    }
+
+    /* Check the descriptor and convert abstime to a tick timeout. */
+    if( xStatus == 0 )
+    {
+        iError = prvValidateDescriptor( mqdes, abstime, &xTimeoutTicks );
+    }
+
+    /* Receive the message, and pass its buffer to the caller. */
+    if( ( xStatus == 0 ) && ( iError == 0 ) )
+    {
+        iError = prvReceiveElement( ( QueueListElement_t * ) mqdes,
+                                    &xReceiveData,
+                                    xTimeoutTicks );
+    }
+
+    if( ( xStatus == 0 ) && ( iError != 0 ) )
+    {
+        errno = iError;
+        xStatus = -1;
+    }
+
+    if( xStatus == 0 )
+    {
+        *msg_ptr = xReceiveData.pcData;
+        xStatus = ( ssize_t ) xReceiveData.xDataSize;
+    }
+
+    return xStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int mq_zc_timedsend( mqd_t mqdes,
+                     char * msg_ptr,
+                     size_t msg_len,
+                     unsigned msg_prio,
+                     const struct timespec * abstime )
+{
+    int iStatus = 0, iError = 0;
+    TickType_t xTimeoutTicks = 0;
+    QueueListElement_t * pxMessageQueue = ( QueueListElement_t * ) mqdes;
+    QueueElement_t xSendData = { 0 };
+
+    /* Silence warnings about unused parameters. */
+    ( void ) msg_prio;
+
+    if( msg_ptr == NULL )
+    {
+        errno = EINVAL;
+        iStatus = -1;
+    }
+
+    /* Check the descriptor and convert abstime to a tick timeout. */
+    if( iStatus == 0 )
+    {
+        iError = prvValidateDescriptor( mqdes, abstime, &xTimeoutTicks );
+
+        if( iError != 0 )
+        {
+            errno = iError;
+            iStatus = -1;
+        }
+    }
+
+    /* Only send buffers from the pool of this queue. Any other pointer has no
+     * valid header. */
+    if( iStatus == 0 )
+    {
+        if( mqBUFFER_HEADER( msg_ptr )->xFields.pvQueue != pxMessageQueue )
+        {
+            errno = EINVAL;
+            iStatus = -1;
+        }
+    }
+
+    /* Verify that mq_msgsize and the buffer are large enough. */
+    if( iStatus == 0 )
+    {
+        if( ( msg_len > ( size_t ) pxMessageQueue->xAttr.mq_msgsize ) ||
+            ( msg_len > mqBUFFER_HEADER( msg_ptr )->xFields.xBufferSize ) )
+        {
+            /* msg_len too large. */
+            errno = EMSGSIZE;
+            iStatus = -1;
+        }
+    }
+
+    /* Send the buffer itself. It belongs to the queue once it is sent, and
+     * stays with the caller otherwise. */
+    if( iStatus == 0 )
+    {
+        xSendData.pcData = msg_ptr;
+        xSendData.xDataSize = msg_len;
+
+        iError = prvSendElement( pxMessageQueue, &xSendData, xTimeoutTicks );
+
+        if( iError != 0 )
+        {
+            errno = iError;
+            iStatus = -1;
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+short mq_poll_internal( void * mqdes,
+                        poll_waiter_internal_t * pxWaiter )
+{
+    short sReadyEvents = 0;
+    QueueListElement_t * pxMessageQueue = ( QueueListElement_t * ) mqdes;
+
+    if( pxWaiter != NULL )
+    {
+        /* Initialize the queue list, if needed. */
+        prvInitializeQueueList();
+
+        /* Lock the mutex that guards access to the queue list. This call will
+         * never fail because it blocks forever. */
+        ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &xQueueListMutex, portMAX_DELAY );
+
+        /* Find the mq referenced by mqdes. */
+        if( prvFindQueueInList( NULL, NULL, ( mqd_t ) mqdes ) == pdTRUE )
+        {
+            /* Register the waiter before checking the queue, so that a send
+             * or receive between the two is not missed. */
+            vTaskSuspendAll();
+            listADD( &pxMessageQueue->xPollWaiters, &pxWaiter->xLink );
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            /* Queue not found; bad descriptor. */
+            sReadyEvents = POLLNVAL;
+        }
+    }
+
+    if( sReadyEvents == 0 )
+    {
+        if( uxQueueMessagesWaiting( pxMessageQueue->xQueue ) > 0 )
+        {
+            sReadyEvents |= POLLIN;
+        }
+
+        if( uxQueueSpacesAvailable( pxMessageQueue->xQueue ) > 0 )
+        {
+            sReadyEvents |= POLLOUT;
+        }
+    }
+
+    if( pxWaiter != NULL )
+    {
+        /* Release the mutex protecting the queue list. This is done after the
+         * queue is read, as the queue may be deleted once it is released. */
+        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &xQueueListMutex );
+    }
+
+    return sReadyEvents;
+}
+
+/*-----------------------------------------------------------*/
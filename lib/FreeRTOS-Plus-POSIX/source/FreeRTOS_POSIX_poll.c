@@ -0,0 +1,518 @@
+/*
+ * Amazon FreeRTOS+POSIX V1.0.0
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_POSIX_poll.c
+ * @brief Implementation of functions in poll.h
+ *
+ * A thread in poll() blocks on a single event group. Message queues and
+ * semaphores keep a list of the threads in poll() on them, and set
+ * FREERTOS_POSIX_POLL_WAKE_BIT in their event groups when they become ready.
+ * Sockets are added to a FreeRTOS+TCP socket set, whose event group is the
+ * one the thread blocks on, so the IP-task wakes the thread directly.
+ */
+
+/* C standard library includes. */
+#include <stddef.h>
+
+/* FreeRTOS+POSIX includes. */
+#include "FreeRTOS_POSIX.h"
+#include "FreeRTOS_POSIX/errno.h"
+#include "FreeRTOS_POSIX/poll.h"
+#include "FreeRTOS_POSIX/utils.h"
+
+#if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+    /* FreeRTOS+TCP includes. */
+    #include "FreeRTOS_IP.h"
+    #include "FreeRTOS_Sockets.h"
+
+    #if ( ipconfigSUPPORT_SELECT_FUNCTION != 1 )
+        #error "posixconfigPOLL_FREERTOS_TCP_SOCKETS requires ipconfigSUPPORT_SELECT_FUNCTION to be 1."
+    #endif
+#else
+    typedef void * SocketSet_t; /**< Placeholder, sockets are not supported. */
+#endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check the events of all entries of a poll() call.
+ *
+ * @param[in,out] fds Entries of the poll() call. revents is updated.
+ * @param[in] nfds Number of entries in fds.
+ * @param[in] pxWaiters Waiters of the message queues and semaphores in fds,
+ * one per such entry, in order.
+ * @param[in] xRegister pdTRUE to register the waiters with their objects.
+ * @param[in] xSocketSet Socket set holding the sockets in fds, or NULL.
+ *
+ * @return The number of entries with a non-zero revents.
+ */
+static int prvCheckEvents( struct pollfd fds[],
+                           nfds_t nfds,
+                           poll_waiter_internal_t * pxWaiters,
+                           BaseType_t xRegister,
+                           SocketSet_t xSocketSet );
+
+/**
+ * @brief Get the events a message queue or semaphore is ready for.
+ *
+ * @param[in] pxFd Entry of the poll() call for the object.
+ * @param[in] pxWaiter Waiter of the object.
+ * @param[in] xRegister pdTRUE to register the waiter with the object.
+ *
+ * @return The events of the object, or POLLNVAL if it was deleted.
+ */
+static short prvCheckObject( const struct pollfd * pxFd,
+                             poll_waiter_internal_t * pxWaiter,
+                             BaseType_t xRegister );
+
+/**
+ * @brief Remove the waiters of a poll() call from their objects and the
+ * sockets from the socket set.
+ *
+ * @param[in] fds Entries of the poll() call.
+ * @param[in] nfds Number of entries in fds.
+ * @param[in] pxWaiters Waiters registered by prvCheckEvents, or NULL.
+ * @param[in] xObjectCount Number of waiters in pxWaiters.
+ * @param[in] xSocketSet Socket set holding the sockets in fds, or NULL.
+ *
+ * @return nothing
+ */
+static void prvUnregister( struct pollfd fds[],
+                           nfds_t nfds,
+                           poll_waiter_internal_t * pxWaiters,
+                           nfds_t xObjectCount,
+                           SocketSet_t xSocketSet );
+
+/*-----------------------------------------------------------*/
+
+static short prvCheckObject( const struct pollfd * pxFd,
+                             poll_waiter_internal_t * pxWaiter,
+                             BaseType_t xRegister )
+{
+    short sReadyEvents = 0;
+
+    if( xRegister == pdTRUE )
+    {
+        /* The objects make sure they are not deleted while the waiter is
+         * registered. */
+        if( pxFd->fdtype == POLLFD_MQ )
+        {
+            sReadyEvents = mq_poll_internal( pxFd->fd, pxWaiter );
+        }
+        else
+        {
+            sReadyEvents = sem_poll_internal( pxFd->fd, pxWaiter );
+        }
+    }
+    else
+    {
+        /* Objects are deleted with the scheduler suspended, so the object
+         * cannot be freed between the check of the flag and the read. */
+        vTaskSuspendAll();
+
+        if( pxWaiter->xObjectDeleted == pdTRUE )
+        {
+            sReadyEvents = POLLNVAL;
+        }
+        else if( pxFd->fdtype == POLLFD_MQ )
+        {
+            sReadyEvents = mq_poll_internal( pxFd->fd, NULL );
+        }
+        else
+        {
+            sReadyEvents = sem_poll_internal( pxFd->fd, NULL );
+        }
+
+        ( void ) xTaskResumeAll();
+    }
+
+    return sReadyEvents;
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvCheckEvents( struct pollfd fds[],
+                           nfds_t nfds,
+                           poll_waiter_internal_t * pxWaiters,
+                           BaseType_t xRegister,
+                           SocketSet_t xSocketSet )
+{
+    int iReadyCount = 0;
+    nfds_t xIndex = 0;
+    poll_waiter_internal_t * pxWaiter = pxWaiters;
+
+    #if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+        EventBits_t xSocketBits = 0;
+
+        if( xSocketSet != NULL )
+        {
+            /* Have the IP-task update the events of all sockets in the set. A
+             * block time of 0 makes this return as soon as that is done. */
+            ( void ) FreeRTOS_select( xSocketSet, 0 );
+        }
+    #else
+        ( void ) xSocketSet;
+    #endif
+
+    for( xIndex = 0; xIndex < nfds; xIndex++ )
+    {
+        fds[ xIndex ].revents = 0;
+
+        if( fds[ xIndex ].fd == NULL )
+        {
+            continue;
+        }
+
+        switch( fds[ xIndex ].fdtype )
+        {
+            #if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+                case POLLFD_SOCKET:
+                    xSocketBits = FreeRTOS_FD_ISSET( ( Socket_t ) fds[ xIndex ].fd, xSocketSet );
+
+                    if( ( xSocketBits & eSELECT_READ ) != 0 )
+                    {
+                        fds[ xIndex ].revents |= POLLIN;
+                    }
+
+                    if( ( xSocketBits & eSELECT_WRITE ) != 0 )
+                    {
+                        fds[ xIndex ].revents |= POLLOUT;
+                    }
+
+                    /* Only TCP sockets report exceptions, when the connection
+                     * is closed. */
+                    if( ( xSocketBits & eSELECT_EXCEPT ) != 0 )
+                    {
+                        fds[ xIndex ].revents |= POLLHUP;
+                    }
+
+                    break;
+            #endif /* if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 ) */
+
+            case POLLFD_MQ:
+            case POLLFD_SEM:
+                fds[ xIndex ].revents = prvCheckObject( &fds[ xIndex ], pxWaiter, xRegister );
+                pxWaiter++;
+                break;
+
+            default:
+                fds[ xIndex ].revents = POLLNVAL;
+                break;
+        }
+
+        /* Only report the requested events, and the ones that are always
+         * reported. */
+        fds[ xIndex ].revents &= ( short ) ( fds[ xIndex ].events | POLLERR | POLLHUP | POLLNVAL );
+
+        if( fds[ xIndex ].revents != 0 )
+        {
+            iReadyCount++;
+        }
+    }
+
+    return iReadyCount;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvUnregister( struct pollfd fds[],
+                           nfds_t nfds,
+                           poll_waiter_internal_t * pxWaiters,
+                           nfds_t xObjectCount,
+                           SocketSet_t xSocketSet )
+{
+    nfds_t xIndex = 0;
+
+    if( pxWaiters != NULL )
+    {
+        /* Waiters are removed with the scheduler suspended, as the objects
+         * walk their lists of waiters with the scheduler suspended. Waiters
+         * that were never added have NULL links and are skipped. */
+        vTaskSuspendAll();
+
+        for( xIndex = 0; xIndex < xObjectCount; xIndex++ )
+        {
+            listREMOVE( &pxWaiters[ xIndex ].xLink );
+        }
+
+        ( void ) xTaskResumeAll();
+    }
+
+    #if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+        if( xSocketSet != NULL )
+        {
+            for( xIndex = 0; xIndex < nfds; xIndex++ )
+            {
+                if( ( fds[ xIndex ].fd != NULL ) && ( fds[ xIndex ].fdtype == POLLFD_SOCKET ) )
+                {
+                    FreeRTOS_FD_CLR( ( Socket_t ) fds[ xIndex ].fd, xSocketSet, eSELECT_ALL );
+                }
+            }
+        }
+    #else
+        ( void ) fds;
+        ( void ) nfds;
+        ( void ) xSocketSet;
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+void poll_wake_internal( Link_t * pxWaiterList,
+                         short sEvents )
+{
+    Link_t * pxLink = NULL;
+    poll_waiter_internal_t * pxWaiter = NULL;
+
+    /* Most of the time, no thread is in poll() on the object. */
+    if( listIS_EMPTY( pxWaiterList ) == 0 )
+    {
+        /* Suspend the scheduler so that poll() cannot remove a waiter while
+         * the list is walked. Setting event group bits does not block. */
+        vTaskSuspendAll();
+
+        listFOR_EACH( pxLink, pxWaiterList )
+        {
+            pxWaiter = listCONTAINER( pxLink, poll_waiter_internal_t, xLink );
+
+            if( ( pxWaiter->sEvents & sEvents ) != 0 )
+            {
+                ( void ) xEventGroupSetBits( pxWaiter->xEventGroup, FREERTOS_POSIX_POLL_WAKE_BIT );
+            }
+        }
+
+        ( void ) xTaskResumeAll();
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void poll_object_deleted_internal( Link_t * pxWaiterList )
+{
+    poll_waiter_internal_t * pxWaiter = NULL;
+
+    if( listIS_EMPTY( pxWaiterList ) == 0 )
+    {
+        /* Removing the waiters sets their links to NULL, so that poll() does
+         * not remove them from the freed list again. */
+        vTaskSuspendAll();
+
+        while( listIS_EMPTY( pxWaiterList ) == 0 )
+        {
+            pxWaiter = listCONTAINER( pxWaiterList->pxNext, poll_waiter_internal_t, xLink );
+            listREMOVE( &pxWaiter->xLink );
+            pxWaiter->xObjectDeleted = pdTRUE;
+            ( void ) xEventGroupSetBits( pxWaiter->xEventGroup, FREERTOS_POSIX_POLL_WAKE_BIT );
+        }
+
+        ( void ) xTaskResumeAll();
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+int poll( struct pollfd fds[],
+          nfds_t nfds,
+          int timeout )
+{
+    int iStatus = 0;
+    nfds_t xIndex = 0, xObjectCount = 0, xSocketCount = 0;
+    TickType_t xRemainingTicks = portMAX_DELAY;
+    TimeOut_t xTimeOut;
+    struct timespec xTimeout = { 0 };
+    StaticEventGroup_t xEventGroupBuffer;
+    EventGroupHandle_t xEventGroup = NULL;
+    EventBits_t xWaitBits = FREERTOS_POSIX_POLL_WAKE_BIT, xSetBits = 0;
+    poll_waiter_internal_t * pxWaiters = NULL;
+    SocketSet_t xSocketSet = NULL;
+
+    if( ( fds == NULL ) && ( nfds > 0 ) )
+    {
+        errno = EINVAL;
+        iStatus = -1;
+    }
+
+    /* Count the objects that need a waiter, and the sockets. */
+    for( xIndex = 0; ( iStatus == 0 ) && ( xIndex < nfds ); xIndex++ )
+    {
+        if( fds[ xIndex ].fd != NULL )
+        {
+            if( ( fds[ xIndex ].fdtype == POLLFD_MQ ) || ( fds[ xIndex ].fdtype == POLLFD_SEM ) )
+            {
+                xObjectCount++;
+            }
+            else if( fds[ xIndex ].fdtype == POLLFD_SOCKET )
+            {
+                xSocketCount++;
+            }
+        }
+    }
+
+    /* Convert the timeout in milliseconds to ticks. A negative timeout blocks
+     * forever. */
+    if( ( iStatus == 0 ) && ( timeout >= 0 ) )
+    {
+        xTimeout.tv_sec = timeout / 1000;
+        xTimeout.tv_nsec = ( long ) ( timeout % 1000 ) * 1000000L;
+        ( void ) UTILS_TimespecToTicks( &xTimeout, &xRemainingTicks );
+    }
+
+    /* Create the event group the calling thread blocks on. With sockets, it
+     * is the one of the socket set. */
+    if( iStatus == 0 )
+    {
+        #if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+            if( xSocketCount > 0 )
+            {
+                xSocketSet = FreeRTOS_CreateSocketSet();
+
+                if( xSocketSet == NULL )
+                {
+                    errno = ENOMEM;
+                    iStatus = -1;
+                }
+                else
+                {
+                    xEventGroup = FreeRTOS_GetSocketSetEventGroup( xSocketSet );
+                    xWaitBits |= eSELECT_ALL;
+
+                    for( xIndex = 0; xIndex < nfds; xIndex++ )
+                    {
+                        if( ( fds[ xIndex ].fd != NULL ) && ( fds[ xIndex ].fdtype == POLLFD_SOCKET ) )
+                        {
+                            /* Exceptions are always reported. The IP-task is
+                             * asked to check all sockets at once afterwards. */
+                            FreeRTOS_FD_SET_NoCheck( ( Socket_t ) fds[ xIndex ].fd,
+                                                     xSocketSet,
+                                                     ( ( ( fds[ xIndex ].events & POLLIN ) != 0 ) ? eSELECT_READ : 0 ) |
+                                                     ( ( ( fds[ xIndex ].events & POLLOUT ) != 0 ) ? eSELECT_WRITE : 0 ) |
+                                                     eSELECT_EXCEPT );
+                        }
+                    }
+                }
+            }
+            else
+        #endif /* if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 ) */
+        {
+            /* This call will not fail because the memory for the event group
+             * is provided. */
+            xEventGroup = xEventGroupCreateStatic( &xEventGroupBuffer );
+        }
+    }
+
+    /* Allocate the waiters registered with the message queues and semaphores. */
+    if( ( iStatus == 0 ) && ( xObjectCount > 0 ) )
+    {
+        pxWaiters = pvPortMalloc( xObjectCount * sizeof( poll_waiter_internal_t ) );
+
+        if( pxWaiters == NULL )
+        {
+            errno = ENOMEM;
+            iStatus = -1;
+        }
+        else
+        {
+            /* Waiters are in the same order as their objects in fds. */
+            xObjectCount = 0;
+
+            for( xIndex = 0; xIndex < nfds; xIndex++ )
+            {
+                if( ( fds[ xIndex ].fd != NULL ) &&
+                    ( ( fds[ xIndex ].fdtype == POLLFD_MQ ) || ( fds[ xIndex ].fdtype == POLLFD_SEM ) ) )
+                {
+                    pxWaiters[ xObjectCount ].xLink.pxPrev = NULL;
+                    pxWaiters[ xObjectCount ].xLink.pxNext = NULL;
+                    pxWaiters[ xObjectCount ].xEventGroup = xEventGroup;
+                    pxWaiters[ xObjectCount ].sEvents = fds[ xIndex ].events;
+                    pxWaiters[ xObjectCount ].xObjectDeleted = pdFALSE;
+                    xObjectCount++;
+                }
+            }
+        }
+    }
+
+    if( iStatus == 0 )
+    {
+        vTaskSetTimeOutState( &xTimeOut );
+
+        /* The first check registers the waiters, later checks only read the
+         * state of the objects. */
+        iStatus = prvCheckEvents( fds, nfds, pxWaiters, pdTRUE, xSocketSet );
+
+        while( iStatus == 0 )
+        {
+            if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTicks ) != pdFALSE )
+            {
+                break;
+            }
+
+            xSetBits = xEventGroupWaitBits( xEventGroup, xWaitBits, pdFALSE, pdFALSE, xRemainingTicks );
+
+            #if ( ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 ) && ( ipconfigSUPPORT_SIGNALS != 0 ) )
+                /* A socket in the set was signalled. */
+                if( ( xSetBits & eSELECT_INTR ) != 0 )
+                {
+                    ( void ) xEventGroupClearBits( xEventGroup, eSELECT_INTR );
+                    errno = EINTR;
+                    iStatus = -1;
+                    break;
+                }
+            #endif
+
+            /* Clear the wake bit before the objects are checked, so that an
+             * object that becomes ready during the check wakes this thread
+             * again. */
+            if( ( xSetBits & FREERTOS_POSIX_POLL_WAKE_BIT ) != 0 )
+            {
+                ( void ) xEventGroupClearBits( xEventGroup, FREERTOS_POSIX_POLL_WAKE_BIT );
+            }
+
+            iStatus = prvCheckEvents( fds, nfds, pxWaiters, pdFALSE, xSocketSet );
+        }
+    }
+
+    /* Clean up. */
+    prvUnregister( fds, nfds, pxWaiters, xObjectCount, xSocketSet );
+    vPortFree( pxWaiters );
+
+    #if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+        if( xSocketSet != NULL )
+        {
+            FreeRTOS_DeleteSocketSet( xSocketSet );
+        }
+        else
+    #endif
+    {
+        if( xEventGroup != NULL )
+        {
+            vEventGroupDelete( xEventGroup );
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
@@ -48,6 +48,27 @@
  */
 static void prvInitializeStaticCond( pthread_cond_internal_t * pxCond );
 
+/**
+ * @brief Set the members of a cond.
+ *
+ * @param[in] pxCond The cond to initialize.
+ *
+ * @return nothing
+ */
+static void prvInitializeCond( pthread_cond_internal_t * pxCond );
+
+/**
+ * @brief Pick one of a set of event group bits, in rotating order.
+ *
+ * @param[in] uxBits The bits to pick from. Must not be 0.
+ * @param[in] uxAfter The bit picked last time, or 0.
+ *
+ * @return The lowest bit of uxBits above uxAfter, or the lowest bit of uxBits
+ * if there is none.
+ */
+static EventBits_t prvNextBit( EventBits_t uxBits,
+                               EventBits_t uxAfter );
+
 /*-----------------------------------------------------------*/
 
 static void prvInitializeStaticCond( pthread_cond_internal_t * pxCond )
@@ -64,12 +85,7 @@ static void prvInitializeStaticCond( pthread_cond_internal_t * pxCond )
          * section. */
         if( pxCond->xIsInitialized == pdFALSE )
         {
-            /* Set the members of the cond. The semaphore create calls will never fail
-             * when their arguments aren't NULL. */
-            pxCond->xIsInitialized = pdTRUE;
-            ( void ) xSemaphoreCreateMutexStatic( &pxCond->xCondMutex );
-            ( void ) xSemaphoreCreateCountingStatic( INT_MAX, 0U, &pxCond->xCondWaitSemaphore );
-            pxCond->iWaitingThreads = 0;
+            prvInitializeCond( pxCond );
         }
 
         /* Exit the critical section. */
@@ -79,6 +95,39 @@ static void prvInitializeStaticCond( pthread_cond_internal_t * pxCond )
 
 /*-----------------------------------------------------------*/
 
+static void prvInitializeCond( pthread_cond_internal_t * pxCond )
+{
+    /* Set the members of the cond. The create calls will never fail when
+     * their arguments aren't NULL. */
+    pxCond->xIsInitialized = pdTRUE;
+    ( void ) xSemaphoreCreateMutexStatic( &pxCond->xCondMutex );
+    ( void ) xSemaphoreCreateCountingStatic( INT_MAX, 0U, &pxCond->xCondWaitSemaphore );
+    ( void ) xEventGroupCreateStatic( &pxCond->xCondWaitEventGroup );
+    pxCond->uxWaiterBits = 0;
+    pxCond->uxLastAllocatedBit = 0;
+    pxCond->uxLastSignaledBit = 0;
+    pxCond->iWaitingThreads = 0;
+}
+
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvNextBit( EventBits_t uxBits,
+                               EventBits_t uxAfter )
+{
+    /* Bits of uxBits above uxAfter. uxAfter is 0 or a single bit. */
+    EventBits_t uxHigherBits = uxBits & ~( ( uxAfter << 1 ) - 1U );
+
+    if( uxHigherBits == 0 )
+    {
+        uxHigherBits = uxBits;
+    }
+
+    /* Isolate the lowest set bit. */
+    return uxHigherBits & ( ~uxHigherBits + 1U );
+}
+
+/*-----------------------------------------------------------*/
+
 int pthread_cond_broadcast( pthread_cond_t * cond )
 {
     int i = 0;
@@ -87,11 +136,19 @@ int pthread_cond_broadcast( pthread_cond_t * cond )
     /* If the cond is uninitialized, perform initialization. */
     prvInitializeStaticCond( pxCond );
 
-    /* Lock xCondMutex to protect access to iWaitingThreads.
+    /* Lock xCondMutex to protect access to the waiters.
      * This call will never fail because it blocks forever. */
     ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondMutex, portMAX_DELAY );
 
-    /* Unblock all threads waiting on this condition variable. */
+    /* Unblock all threads waiting on an event group bit at once. */
+    if( pxCond->uxWaiterBits != 0 )
+    {
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &pxCond->xCondWaitEventGroup,
+                                     pxCond->uxWaiterBits );
+        pxCond->uxWaiterBits = 0;
+    }
+
+    /* Unblock all threads waiting on the semaphore. */
     for( i = 0; i < pxCond->iWaitingThreads; i++ )
     {
         ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore );
@@ -115,6 +172,7 @@ int pthread_cond_destroy( pthread_cond_t * cond )
     /* Free all resources in use by the cond. */
     vSemaphoreDelete( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
     vSemaphoreDelete( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore );
+    vEventGroupDelete( ( EventGroupHandle_t ) &pxCond->xCondWaitEventGroup );
     vPortFree( pxCond );
 
     return 0;
@@ -140,12 +198,8 @@ int pthread_cond_init( pthread_cond_t * cond,
 
     if( iStatus == 0 )
     {
-        /* Set the members of the cond. The semaphore create calls will never fail
-         * when their arguments aren't NULL. */
-        pxCond->xIsInitialized = pdTRUE;
-        ( void ) xSemaphoreCreateMutexStatic( &pxCond->xCondMutex );
-        ( void ) xSemaphoreCreateCountingStatic( INT_MAX, 0U, &pxCond->xCondWaitSemaphore );
-        pxCond->iWaitingThreads = 0;
+        /* Set the members of the cond. */
+        prvInitializeCond( pxCond );
 
         /* Set the output. */
         *cond = pxCond;
@@ -158,21 +212,31 @@ int pthread_cond_init( pthread_cond_t * cond,
 
 int pthread_cond_signal( pthread_cond_t * cond )
 {
+    EventBits_t uxBit = 0;
     pthread_cond_internal_t * pxCond = ( pthread_cond_internal_t * ) ( *cond );
 
     /* If the cond is uninitialized, perform initialization. */
     prvInitializeStaticCond( pxCond );
 
     /* Check that at least one thread is waiting for a signal. */
-    if( pxCond->iWaitingThreads > 0 )
+    if( ( pxCond->uxWaiterBits != 0 ) || ( pxCond->iWaitingThreads > 0 ) )
     {
-        /* Lock xCondMutex to protect access to iWaitingThreads.
+        /* Lock xCondMutex to protect access to the waiters.
          * This call will never fail because it blocks forever. */
         ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondMutex, portMAX_DELAY );
 
         /* Check again that at least one thread is waiting for a signal after
-         * taking xCondMutex. If so, unblock it. */
-        if( pxCond->iWaitingThreads > 0 )
+         * taking xCondMutex. If so, unblock it. Threads waiting on an event
+         * group bit are picked in turn so that none of them starves. */
+        if( pxCond->uxWaiterBits != 0 )
+        {
+            uxBit = prvNextBit( pxCond->uxWaiterBits, pxCond->uxLastSignaledBit );
+            pxCond->uxLastSignaledBit = uxBit;
+            pxCond->uxWaiterBits &= ~uxBit;
+
+            ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &pxCond->xCondWaitEventGroup, uxBit );
+        }
+        else if( pxCond->iWaitingThreads > 0 )
         {
             ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore );
 
@@ -196,6 +260,7 @@ int pthread_cond_timedwait( pthread_cond_t * cond,
     int iStatus = 0;
     pthread_cond_internal_t * pxCond = ( pthread_cond_internal_t * ) ( *cond );
     TickType_t xDelay = portMAX_DELAY;
+    EventBits_t uxFreeBits = 0, uxBit = 0;
 
     /* If the cond is uninitialized, perform initialization. */
     prvInitializeStaticCond( pxCond );
@@ -206,19 +271,70 @@ int pthread_cond_timedwait( pthread_cond_t * cond,
         iStatus = UTILS_AbsoluteTimespecToTicks( abstime, &xDelay );
     }
 
-    /* Increase the counter of threads blocking on condition variable, then
-     * unlock mutex. */
+    /* Register this thread as a waiter, then unlock mutex. A bit that is set
+     * in the event group but no longer in uxWaiterBits belongs to a thread
+     * that was signaled but has not woken up yet, so it isn't free. */
     if( iStatus == 0 )
     {
         ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondMutex, portMAX_DELAY );
-        pxCond->iWaitingThreads++;
+
+        uxFreeBits = ~( pxCond->uxWaiterBits |
+                        xEventGroupGetBits( ( EventGroupHandle_t ) &pxCond->xCondWaitEventGroup ) ) &
+                     FREERTOS_POSIX_COND_WAITER_BITS;
+
+        if( uxFreeBits != 0 )
+        {
+            uxBit = prvNextBit( uxFreeBits, pxCond->uxLastAllocatedBit );
+            pxCond->uxLastAllocatedBit = uxBit;
+            pxCond->uxWaiterBits |= uxBit;
+        }
+        else
+        {
+            pxCond->iWaitingThreads++;
+        }
+
         ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
 
         iStatus = pthread_mutex_unlock( mutex );
     }
 
     /* Wait on the condition variable. */
-    if( iStatus == 0 )
+    if( ( iStatus == 0 ) && ( uxBit != 0 ) )
+    {
+        if( ( xEventGroupWaitBits( ( EventGroupHandle_t ) &pxCond->xCondWaitEventGroup,
+                                   uxBit,
+                                   pdTRUE,
+                                   pdFALSE,
+                                   xDelay ) & uxBit ) == 0 )
+        {
+            /* Timeout. Unregister this thread, unless it was signaled in the
+             * meantime, in which case the signal is consumed. */
+            ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondMutex, portMAX_DELAY );
+
+            if( ( pxCond->uxWaiterBits & uxBit ) != 0 )
+            {
+                pxCond->uxWaiterBits &= ~uxBit;
+                iStatus = ETIMEDOUT;
+            }
+            else
+            {
+                ( void ) xEventGroupClearBits( ( EventGroupHandle_t ) &pxCond->xCondWaitEventGroup, uxBit );
+            }
+
+            ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
+        }
+
+        /* Relock mutex. */
+        if( iStatus == 0 )
+        {
+            iStatus = pthread_mutex_lock( mutex );
+        }
+        else
+        {
+            ( void ) pthread_mutex_lock( mutex );
+        }
+    }
+    else if( iStatus == 0 )
     {
         if( xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore,
                             xDelay ) == pdPASS )
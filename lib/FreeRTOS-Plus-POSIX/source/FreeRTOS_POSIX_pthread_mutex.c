@@ -49,6 +49,17 @@
  */
 static void prvInitializeStaticMutex( pthread_mutex_internal_t * pxMutex );
 
+/**
+ * @brief Take the FreeRTOS mutex of a mutex.
+ *
+ * @param[in] pxMutex The mutex to take.
+ * @param[in] xDelay Time to wait for the mutex, in ticks.
+ *
+ * @return pdPASS if the mutex was taken, pdFALSE otherwise.
+ */
+static BaseType_t prvTakeMutex( pthread_mutex_internal_t * pxMutex,
+                                TickType_t xDelay );
+
 /**
  * @brief Default pthread_mutexattr_t.
  */
@@ -94,6 +105,26 @@ static void prvInitializeStaticMutex( pthread_mutex_internal_t * pxMutex )
 
 /*-----------------------------------------------------------*/
 
+static BaseType_t prvTakeMutex( pthread_mutex_internal_t * pxMutex,
+                                TickType_t xDelay )
+{
+    BaseType_t xFreeRTOSMutexTakeStatus = pdFALSE;
+
+    /* Call the correct FreeRTOS mutex take function based on mutex type. */
+    if( pxMutex->xAttr.iType == PTHREAD_MUTEX_RECURSIVE )
+    {
+        xFreeRTOSMutexTakeStatus = xSemaphoreTakeRecursive( ( SemaphoreHandle_t ) &pxMutex->xMutex, xDelay );
+    }
+    else
+    {
+        xFreeRTOSMutexTakeStatus = xSemaphoreTake( ( SemaphoreHandle_t ) &pxMutex->xMutex, xDelay );
+    }
+
+    return xFreeRTOSMutexTakeStatus;
+}
+
+/*-----------------------------------------------------------*/
+
 int pthread_mutex_destroy( pthread_mutex_t * mutex )
 {
     pthread_mutex_internal_t * pxMutex = ( pthread_mutex_internal_t * ) ( *mutex );
@@ -188,6 +219,10 @@ int pthread_mutex_timedlock( pthread_mutex_t * mutex,
     TickType_t xDelay = portMAX_DELAY;
     BaseType_t xFreeRTOSMutexTakeStatus = pdFALSE;
 
+    #if ( posixconfigPTHREAD_MUTEX_SPIN_COUNT > 0 )
+        int i = 0;
+    #endif
+
     /* If mutex in uninitialized, perform initialization. */
     prvInitializeStaticMutex( pxMutex );
 
@@ -216,18 +251,31 @@ int pthread_mutex_timedlock( pthread_mutex_t * mutex,
         iStatus = EDEADLK;
     }
 
-    if( iStatus == 0 )
-    {
-        /* Call the correct FreeRTOS mutex take function based on mutex type. */
-        if( pxMutex->xAttr.iType == PTHREAD_MUTEX_RECURSIVE )
-        {
-            xFreeRTOSMutexTakeStatus = xSemaphoreTakeRecursive( ( SemaphoreHandle_t ) &pxMutex->xMutex, xDelay );
-        }
-        else
+    #if ( posixconfigPTHREAD_MUTEX_SPIN_COUNT > 0 )
+        /* The owner of the mutex may be about to release it, so check for a
+         * while before blocking. The owner is read through a volatile pointer
+         * as it is updated by other threads. */
+        if( ( iStatus == 0 ) &&
+            ( xDelay != 0 ) &&
+            ( pxMutex->xTaskOwner != xTaskGetCurrentTaskHandle() ) )
         {
-            xFreeRTOSMutexTakeStatus = xSemaphoreTake( ( SemaphoreHandle_t ) &pxMutex->xMutex, xDelay );
+            for( i = 0; ( i < posixconfigPTHREAD_MUTEX_SPIN_COUNT ) && ( xFreeRTOSMutexTakeStatus == pdFALSE ); i++ )
+            {
+                if( *( ( volatile TaskHandle_t * ) &pxMutex->xTaskOwner ) == NULL )
+                {
+                    xFreeRTOSMutexTakeStatus = prvTakeMutex( pxMutex, 0 );
+                }
+            }
         }
+    #endif /* if ( posixconfigPTHREAD_MUTEX_SPIN_COUNT > 0 ) */
 
+    if( ( iStatus == 0 ) && ( xFreeRTOSMutexTakeStatus == pdFALSE ) )
+    {
+        xFreeRTOSMutexTakeStatus = prvTakeMutex( pxMutex, xDelay );
+    }
+
+    if( iStatus == 0 )
+    {
         /* If the mutex was successfully taken, set its owner. */
         if( xFreeRTOSMutexTakeStatus == pdPASS )
         {
@@ -0,0 +1,351 @@
+/*
+ * Amazon FreeRTOS+POSIX V1.0.0
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_POSIX_pthread_rwlock.c
+ * @brief Implementation of read-write lock functions in pthread.h
+ */
+
+/* C standard library includes. */
+#include <stddef.h>
+
+/* FreeRTOS+POSIX includes. */
+#include "FreeRTOS_POSIX.h"
+#include "FreeRTOS_POSIX/errno.h"
+#include "FreeRTOS_POSIX/pthread.h"
+
+/**
+ * @brief Delete the FreeRTOS objects of a condition variable embedded in a
+ * read-write lock.
+ *
+ * pthread_cond_destroy can't be used, as it frees the condition variable.
+ *
+ * @param[in] pxCond The condition variable.
+ *
+ * @return nothing
+ */
+static void prvDeleteCond( pthread_cond_internal_t * pxCond );
+
+/**
+ * @brief Lock a read-write lock for reading.
+ *
+ * @param[in] pxRwlock The lock.
+ * @param[in] abstime Time at which to stop waiting, or NULL to wait forever.
+ * @param[in] xTry If pdTRUE, fail with EBUSY instead of waiting.
+ *
+ * @return 0 on success, an errno value otherwise.
+ */
+static int prvReadLock( pthread_rwlock_internal_t * pxRwlock,
+                        const struct timespec * abstime,
+                        BaseType_t xTry );
+
+/**
+ * @brief Lock a read-write lock for writing.
+ *
+ * @param[in] pxRwlock The lock.
+ * @param[in] abstime Time at which to stop waiting, or NULL to wait forever.
+ * @param[in] xTry If pdTRUE, fail with EBUSY instead of waiting.
+ *
+ * @return 0 on success, an errno value otherwise.
+ */
+static int prvWriteLock( pthread_rwlock_internal_t * pxRwlock,
+                         const struct timespec * abstime,
+                         BaseType_t xTry );
+
+/*-----------------------------------------------------------*/
+
+static void prvDeleteCond( pthread_cond_internal_t * pxCond )
+{
+    if( pxCond->xIsInitialized == pdTRUE )
+    {
+        vSemaphoreDelete( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
+        vSemaphoreDelete( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore );
+        vEventGroupDelete( ( EventGroupHandle_t ) &pxCond->xCondWaitEventGroup );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvReadLock( pthread_rwlock_internal_t * pxRwlock,
+                        const struct timespec * abstime,
+                        BaseType_t xTry )
+{
+    int iStatus = 0;
+    pthread_mutex_t xMutex = ( pthread_mutex_t ) &pxRwlock->xMutex;
+    pthread_cond_t xReadersCond = ( pthread_cond_t ) &pxRwlock->xReadersCond;
+
+    /* This call will never fail because it blocks forever. */
+    ( void ) pthread_mutex_lock( &xMutex );
+
+    /* Check if the calling thread would wait for itself to release the
+     * write lock. */
+    if( ( xTry == pdFALSE ) && ( pxRwlock->xWriter == xTaskGetCurrentTaskHandle() ) )
+    {
+        iStatus = EDEADLK;
+    }
+
+    /* Wait for the writer to release the lock, and for the writers waiting
+     * for it to take and release it. */
+    while( ( iStatus == 0 ) &&
+           ( ( pxRwlock->xWriter != NULL ) || ( pxRwlock->uWaitingWriters > 0 ) ) )
+    {
+        if( xTry == pdTRUE )
+        {
+            iStatus = EBUSY;
+        }
+        else
+        {
+            pxRwlock->uWaitingReaders++;
+            iStatus = pthread_cond_timedwait( &xReadersCond, &xMutex, abstime );
+            pxRwlock->uWaitingReaders--;
+        }
+    }
+
+    if( iStatus == 0 )
+    {
+        pxRwlock->uReaders++;
+    }
+
+    ( void ) pthread_mutex_unlock( &xMutex );
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvWriteLock( pthread_rwlock_internal_t * pxRwlock,
+                         const struct timespec * abstime,
+                         BaseType_t xTry )
+{
+    int iStatus = 0;
+    pthread_mutex_t xMutex = ( pthread_mutex_t ) &pxRwlock->xMutex;
+    pthread_cond_t xReadersCond = ( pthread_cond_t ) &pxRwlock->xReadersCond;
+    pthread_cond_t xWritersCond = ( pthread_cond_t ) &pxRwlock->xWritersCond;
+
+    /* This call will never fail because it blocks forever. */
+    ( void ) pthread_mutex_lock( &xMutex );
+
+    /* Check if the calling thread would wait for itself to release the
+     * write lock. */
+    if( ( xTry == pdFALSE ) && ( pxRwlock->xWriter == xTaskGetCurrentTaskHandle() ) )
+    {
+        iStatus = EDEADLK;
+    }
+    else
+    {
+        /* Count this thread as a waiting writer. This stops new readers from
+         * taking the lock. */
+        pxRwlock->uWaitingWriters++;
+
+        while( ( iStatus == 0 ) &&
+               ( ( pxRwlock->xWriter != NULL ) || ( pxRwlock->uReaders > 0 ) ) )
+        {
+            if( xTry == pdTRUE )
+            {
+                iStatus = EBUSY;
+            }
+            else
+            {
+                iStatus = pthread_cond_timedwait( &xWritersCond, &xMutex, abstime );
+            }
+        }
+
+        pxRwlock->uWaitingWriters--;
+
+        if( iStatus == 0 )
+        {
+            pxRwlock->xWriter = xTaskGetCurrentTaskHandle();
+        }
+        else if( ( pxRwlock->xWriter == NULL ) && ( pxRwlock->uReaders == 0 ) &&
+                 ( pxRwlock->uWaitingWriters > 0 ) )
+        {
+            /* The lock is free, and this thread may have consumed the wakeup
+             * meant for another writer. Pass it on. */
+            ( void ) pthread_cond_signal( &xWritersCond );
+        }
+        else if( ( pxRwlock->xWriter == NULL ) && ( pxRwlock->uWaitingWriters == 0 ) &&
+                 ( pxRwlock->uWaitingReaders > 0 ) )
+        {
+            /* This thread was the last writer holding back the readers. */
+            ( void ) pthread_cond_broadcast( &xReadersCond );
+        }
+    }
+
+    ( void ) pthread_mutex_unlock( &xMutex );
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_destroy( pthread_rwlock_t * rwlock )
+{
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( *rwlock );
+
+    /* Free all resources in use by the lock. The mutex and condition
+     * variables are embedded in it, so only their FreeRTOS objects are
+     * deleted. */
+    if( pxRwlock->xMutex.xIsInitialized == pdTRUE )
+    {
+        vSemaphoreDelete( ( SemaphoreHandle_t ) &pxRwlock->xMutex.xMutex );
+    }
+
+    prvDeleteCond( &pxRwlock->xReadersCond );
+    prvDeleteCond( &pxRwlock->xWritersCond );
+    vPortFree( pxRwlock );
+
+    return 0;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_init( pthread_rwlock_t * rwlock,
+                         const pthread_rwlockattr_t * attr )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = NULL;
+
+    /* Silence warnings about unused parameters. */
+    ( void ) attr;
+
+    pxRwlock = pvPortMalloc( sizeof( pthread_rwlock_internal_t ) );
+
+    if( pxRwlock == NULL )
+    {
+        iStatus = ENOMEM;
+    }
+
+    if( iStatus == 0 )
+    {
+        /* Set the members of the lock. The mutex and condition variables are
+         * initialized on first use. */
+        pxRwlock->xMutex.xIsInitialized = pdFALSE;
+        pxRwlock->xMutex.xTaskOwner = NULL;
+        pxRwlock->xReadersCond.xIsInitialized = pdFALSE;
+        pxRwlock->xWritersCond.xIsInitialized = pdFALSE;
+        pxRwlock->uReaders = 0;
+        pxRwlock->uWaitingReaders = 0;
+        pxRwlock->uWaitingWriters = 0;
+        pxRwlock->xWriter = NULL;
+
+        /* Set the output. */
+        *rwlock = pxRwlock;
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_rdlock( pthread_rwlock_t * rwlock )
+{
+    return prvReadLock( ( pthread_rwlock_internal_t * ) ( *rwlock ), NULL, pdFALSE );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_timedrdlock( pthread_rwlock_t * rwlock,
+                                const struct timespec * abstime )
+{
+    return prvReadLock( ( pthread_rwlock_internal_t * ) ( *rwlock ), abstime, pdFALSE );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_timedwrlock( pthread_rwlock_t * rwlock,
+                                const struct timespec * abstime )
+{
+    return prvWriteLock( ( pthread_rwlock_internal_t * ) ( *rwlock ), abstime, pdFALSE );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_tryrdlock( pthread_rwlock_t * rwlock )
+{
+    return prvReadLock( ( pthread_rwlock_internal_t * ) ( *rwlock ), NULL, pdTRUE );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_trywrlock( pthread_rwlock_t * rwlock )
+{
+    return prvWriteLock( ( pthread_rwlock_internal_t * ) ( *rwlock ), NULL, pdTRUE );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_unlock( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( *rwlock );
+    pthread_mutex_t xMutex = ( pthread_mutex_t ) &pxRwlock->xMutex;
+    pthread_cond_t xReadersCond = ( pthread_cond_t ) &pxRwlock->xReadersCond;
+    pthread_cond_t xWritersCond = ( pthread_cond_t ) &pxRwlock->xWritersCond;
+
+    /* This call will never fail because it blocks forever. */
+    ( void ) pthread_mutex_lock( &xMutex );
+
+    /* Release the write lock if the calling thread holds it, otherwise a read
+     * lock. Readers are not tracked individually, so a thread that doesn't
+     * hold a read lock is only detected when no thread does. */
+    if( pxRwlock->xWriter == xTaskGetCurrentTaskHandle() )
+    {
+        pxRwlock->xWriter = NULL;
+    }
+    else if( ( pxRwlock->xWriter == NULL ) && ( pxRwlock->uReaders > 0 ) )
+    {
+        pxRwlock->uReaders--;
+    }
+    else
+    {
+        iStatus = EPERM;
+    }
+
+    if( iStatus == 0 )
+    {
+        /* Hand the lock to a waiting writer first. Waiting readers are only
+         * woken once no writer waits. */
+        if( ( pxRwlock->uReaders == 0 ) && ( pxRwlock->uWaitingWriters > 0 ) )
+        {
+            ( void ) pthread_cond_signal( &xWritersCond );
+        }
+        else if( ( pxRwlock->xWriter == NULL ) && ( pxRwlock->uWaitingWriters == 0 ) &&
+                 ( pxRwlock->uWaitingReaders > 0 ) )
+        {
+            ( void ) pthread_cond_broadcast( &xReadersCond );
+        }
+    }
+
+    ( void ) pthread_mutex_unlock( &xMutex );
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_wrlock( pthread_rwlock_t * rwlock )
+{
+    return prvWriteLock( ( pthread_rwlock_internal_t * ) ( *rwlock ), NULL, pdFALSE );
+}
@@ -34,6 +34,7 @@
 /* FreeRTOS+POSIX includes. */
 #include "FreeRTOS_POSIX.h"
 #include "FreeRTOS_POSIX/errno.h"
+#include "FreeRTOS_POSIX/poll.h"
 #include "FreeRTOS_POSIX/semaphore.h"
 #include "FreeRTOS_POSIX/utils.h"
 
@@ -43,6 +44,7 @@
 typedef struct
 {
     StaticSemaphore_t xSemaphore; /**< FreeRTOS semaphore. */
+    Link_t xPollWaiters;          /**< Threads in poll() on this semaphore. */
 } sem_internal_t;
 
 
@@ -52,6 +54,10 @@ int sem_destroy( sem_t * sem )
 {
     sem_internal_t * pxSem = ( sem_internal_t * ) ( *sem );
 
+    /* Wake the threads in poll() on this semaphore, so that they no longer
+     * access it. */
+    poll_object_deleted_internal( &pxSem->xPollWaiters );
+
     /* Free the resources in use by the semaphore. */
     vSemaphoreDelete( ( SemaphoreHandle_t ) &pxSem->xSemaphore );
     vPortFree( pxSem );
@@ -108,6 +114,7 @@ int sem_init( sem_t * sem,
     if( iStatus == 0 )
     {
         ( void ) xSemaphoreCreateCountingStatic( SEM_VALUE_MAX, value, &pxSem->xSemaphore );
+        listINIT_HEAD( &pxSem->xPollWaiters );
         *sem = pxSem;
     }
 
@@ -123,6 +130,9 @@ int sem_post( sem_t * sem )
     /* Give the semaphore using the FreeRTOS API. */
     ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxSem->xSemaphore );
 
+    /* Wake the threads in poll() on this semaphore. */
+    poll_wake_internal( &pxSem->xPollWaiters, POLLIN );
+
     return 0;
 }
 
@@ -202,3 +212,28 @@ int sem_wait( sem_t * sem )
 }
 
 /*-----------------------------------------------------------*/
+
+short sem_poll_internal( void * sem,
+                         poll_waiter_internal_t * pxWaiter )
+{
+    short sReadyEvents = 0;
+    sem_internal_t * pxSem = ( sem_internal_t * ) sem;
+
+    /* Register the waiter before checking the count, so that a sem_post
+     * between the two is not missed. */
+    if( pxWaiter != NULL )
+    {
+        vTaskSuspendAll();
+        listADD( &pxSem->xPollWaiters, &pxWaiter->xLink );
+        ( void ) xTaskResumeAll();
+    }
+
+    if( uxSemaphoreGetCount( ( SemaphoreHandle_t ) &pxSem->xSemaphore ) > 0 )
+    {
+        sReadyEvents = POLLIN;
+    }
+
+    return sReadyEvents;
+}
+
+/*-----------------------------------------------------------*/
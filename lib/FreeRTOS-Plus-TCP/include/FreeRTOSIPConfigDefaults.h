@@ -451,6 +451,15 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigWATCHDOG_TIMER()
 #endif
 
+#ifndef ipconfigRX_BATCH_SIZE
+	/* The maximum number of received frames that the IP-task processes in one
+	go.  While a batch lasts, the IP-task takes further events from its queue
+	without checking its timers, and the owner of a UDP socket is woken up once
+	for a run of frames to that socket rather than once per frame.  A value of
+	1 handles every frame on its own. */
+	#define ipconfigRX_BATCH_SIZE	1
+#endif
+
 #ifndef ipconfigUSE_CALLBACKS
 	#define ipconfigUSE_CALLBACKS			( 0 )
 #endif
@@ -523,6 +532,13 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigSUPPORT_SIGNALS				0
 #endif
 
+/* Set to 1 to include FreeRTOS_sendmmsg() and FreeRTOS_recvmmsg(), which pass
+several UDP messages in one call.  Every network buffer descriptor then has a
+'pxNextBuffer' field. */
+#ifndef ipconfigSUPPORT_MMSG_FUNCTIONS
+	#define ipconfigSUPPORT_MMSG_FUNCTIONS		0
+#endif
+
 #ifndef ipconfigUSE_NBNS
 	#define ipconfigUSE_NBNS 0
 #endif
@@ -254,6 +254,7 @@ typedef enum
 	eSocketCloseEvent,		/* 9: Send a message to the IP-task to close a socket. */
 	eSocketSelectEvent,		/*10: Send a message to the IP-task for select(). */
 	eSocketSignalEvent,		/*11: A socket must be signalled. */
+	eStackTxChainEvent,		/*12: The software stack has queued a chain of packets to transmit. */
 } eIPEvent_t;
 
 typedef struct IP_TASK_COMMANDS
@@ -674,6 +675,14 @@ FreeRTOS_Socket_t *pxUDPSocketLookup( UBaseType_t uxLocalPort );
  */
 void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer );
 
+#if( ipconfigRX_BATCH_SIZE > 1 )
+	/*
+	 * Wake up the owner of the UDP socket that received the last frames of a
+	 * batch, if it hasn't been woken up yet.  Only called by the IP-task.
+	 */
+	void vUDPWakeUpDeferredSocket( void );
+#endif
+
 /*
  * Calculate the upper-layer checksum
  * Works both for UDP, ICMP and TCP packages
@@ -173,6 +173,32 @@ struct freertos_sockaddr
 	uint32_t sin_addr;
 };
 
+/* One buffer of a call to FreeRTOS_sendv(). */
+struct freertos_iovec
+{
+	void *pvBase;
+	size_t xLength;
+};
+
+#if( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 )
+	/* One message of a call to FreeRTOS_sendmmsg() or FreeRTOS_recvmmsg(). */
+	struct freertos_mmsghdr
+	{
+		/* The payload.  With FREERTOS_ZERO_COPY, a buffer obtained from
+		FreeRTOS_GetUDPPayloadBuffer() when sending, or set to the received
+		buffer, which must be returned with FreeRTOS_ReleaseUDPPayloadBuffer(). */
+		void *pvBuffer;
+		/* FreeRTOS_recvmmsg() only: the size of pvBuffer.  Not used with
+		FREERTOS_ZERO_COPY. */
+		size_t xBufferLength;
+		/* The number of bytes to send, or set to the number of bytes
+		received. */
+		size_t xDataLength;
+		/* The destination, or set to the source of the received message. */
+		struct freertos_sockaddr xAddress;
+	};
+#endif /* ipconfigSUPPORT_MMSG_FUNCTIONS */
+
 #if ipconfigBYTE_ORDER == pdFREERTOS_LITTLE_ENDIAN
 
 	#define FreeRTOS_inet_addr_quick( ucOctet0, ucOctet1, ucOctet2, ucOctet3 )				\
@@ -222,6 +248,25 @@ int32_t FreeRTOS_recvfrom( Socket_t xSocket, void *pvBuffer, size_t xBufferLengt
 int32_t FreeRTOS_sendto( Socket_t xSocket, const void *pvBuffer, size_t xTotalDataLength, BaseType_t xFlags, const struct freertos_sockaddr *pxDestinationAddress, socklen_t xDestinationAddressLength );
 BaseType_t FreeRTOS_bind( Socket_t xSocket, struct freertos_sockaddr *pxAddress, socklen_t xAddressLength );
 
+#if( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 )
+	/*
+	 * Receive up to uxMessageCount messages from a UDP socket.  The call blocks
+	 * like FreeRTOS_recvfrom() until the first message arrives, then also takes
+	 * the messages that are already waiting.  Returns the number of messages
+	 * received, or a negative error code when none was received.
+	 */
+	int32_t FreeRTOS_recvmmsg( Socket_t xSocket, struct freertos_mmsghdr *pxMessages, size_t uxMessageCount, BaseType_t xFlags );
+
+	/*
+	 * Send up to uxMessageCount messages from a UDP socket, with a single
+	 * message to the IP-task.  Sending stops at the first message that is too
+	 * long or for which no network buffer is available in time.  Returns the
+	 * number of messages sent; with FREERTOS_ZERO_COPY, the buffers of the
+	 * messages that were not sent still belong to the caller.
+	 */
+	int32_t FreeRTOS_sendmmsg( Socket_t xSocket, const struct freertos_mmsghdr *pxMessages, size_t uxMessageCount, BaseType_t xFlags );
+#endif /* ipconfigSUPPORT_MMSG_FUNCTIONS */
+
 /* function to get the local address and IP port */
 size_t FreeRTOS_GetLocalAddress( Socket_t xSocket, struct freertos_sockaddr *pxAddress );
 
@@ -234,6 +279,12 @@ BaseType_t FreeRTOS_connect( Socket_t xClientSocket, struct freertos_sockaddr *p
 BaseType_t FreeRTOS_listen( Socket_t xSocket, BaseType_t xBacklog );
 BaseType_t FreeRTOS_recv( Socket_t xSocket, void *pvBuffer, size_t xBufferLength, BaseType_t xFlags );
 BaseType_t FreeRTOS_send( Socket_t xSocket, const void *pvBuffer, size_t uxDataLength, BaseType_t xFlags );
+
+/* Send the data of uxVectorCount buffers as if they were one buffer, for
+instance a protocol header and its payload.  Returns the same values as
+FreeRTOS_send(). */
+BaseType_t FreeRTOS_sendv( Socket_t xSocket, const struct freertos_iovec *pxVectors, size_t uxVectorCount, BaseType_t xFlags );
+
 Socket_t FreeRTOS_accept( Socket_t xServerSocket, struct freertos_sockaddr *pxAddress, socklen_t *pxAddressLength );
 BaseType_t FreeRTOS_shutdown (Socket_t xSocket, BaseType_t xHow);
 
@@ -367,9 +418,11 @@ void FreeRTOS_netstat( void );
 	SocketSet_t FreeRTOS_CreateSocketSet( void );
 	void FreeRTOS_DeleteSocketSet( SocketSet_t xSocketSet );
 	void FreeRTOS_FD_SET( Socket_t xSocket, SocketSet_t xSocketSet, EventBits_t xBitsToSet );
+	void FreeRTOS_FD_SET_NoCheck( Socket_t xSocket, SocketSet_t xSocketSet, EventBits_t xBitsToSet );
 	void FreeRTOS_FD_CLR( Socket_t xSocket, SocketSet_t xSocketSet, EventBits_t xBitsToClear );
 	EventBits_t FreeRTOS_FD_ISSET( Socket_t xSocket, SocketSet_t xSocketSet );
 	BaseType_t FreeRTOS_select( SocketSet_t xSocketSet, TickType_t xBlockTimeTicks );
+	EventGroupHandle_t FreeRTOS_GetSocketSetEventGroup( SocketSet_t xSocketSet );
 
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 
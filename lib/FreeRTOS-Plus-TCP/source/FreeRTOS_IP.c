@@ -230,7 +230,7 @@ static TickType_t prvCalculateSleepTime( void );
  * The network card driver has received a packet.  In the case that it is part
  * of a linked packet chain, walk through it to handle every message.
  */
-static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer );
+static UBaseType_t prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer );
 
 /*
  * Utility functions for the light weight IP timers.
@@ -317,6 +317,9 @@ IPStackEvent_t xReceivedEvent;
 TickType_t xNextIPSleep;
 FreeRTOS_Socket_t *pxSocket;
 struct freertos_sockaddr xAddress;
+#if( ipconfigRX_BATCH_SIZE > 1 )
+	UBaseType_t uxRxBatchCount = 0u;
+#endif
 
 	/* Just to prevent compiler warnings about unused parameters. */
 	( void ) pvParameters;
@@ -347,12 +350,24 @@ struct freertos_sockaddr xAddress;
 	{
 		ipconfigWATCHDOG_TIMER();
 
-		/* Check the ARP, DHCP and TCP timers to see if there is any periodic
-		or timeout processing to perform. */
-		prvCheckNetworkTimers();
+		#if( ipconfigRX_BATCH_SIZE > 1 )
+			if( uxRxBatchCount != 0u )
+			{
+				/* A batch of received frames is being processed.  Take the
+				next event without blocking, and leave the timers until the
+				batch ends. */
+				xNextIPSleep = ( TickType_t ) 0;
+			}
+			else
+		#endif /* ipconfigRX_BATCH_SIZE */
+		{
+			/* Check the ARP, DHCP and TCP timers to see if there is any periodic
+			or timeout processing to perform. */
+			prvCheckNetworkTimers();
 
-		/* Calculate the acceptable maximum sleep time. */
-		xNextIPSleep = prvCalculateSleepTime();
+			/* Calculate the acceptable maximum sleep time. */
+			xNextIPSleep = prvCalculateSleepTime();
+		}
 
 		/* Wait until there is something to do. If the following call exits
 		 * due to a time out rather than a message being received, set a
@@ -379,6 +394,19 @@ struct freertos_sockaddr xAddress;
 
 		iptraceNETWORK_EVENT_RECEIVED( xReceivedEvent.eEventType );
 
+		#if( ipconfigRX_BATCH_SIZE > 1 )
+		{
+			if( xReceivedEvent.eEventType != eNetworkRxEvent )
+			{
+				/* The batch ends.  Wake up the owner of the socket that received
+				the last frames before handling any other event, as that event
+				might close the socket. */
+				vUDPWakeUpDeferredSocket();
+				uxRxBatchCount = 0u;
+			}
+		}
+		#endif /* ipconfigRX_BATCH_SIZE */
+
 		switch( xReceivedEvent.eEventType )
 		{
 			case eNetworkDownEvent :
@@ -391,7 +419,21 @@ struct freertos_sockaddr xAddress;
 				/* The network hardware driver has received a new packet.  A
 				pointer to the received buffer is located in the pvData member
 				of the received event structure. */
-				prvHandleEthernetPacket( ( NetworkBufferDescriptor_t * ) ( xReceivedEvent.pvData ) );
+				#if( ipconfigRX_BATCH_SIZE > 1 )
+				{
+					uxRxBatchCount += prvHandleEthernetPacket( ( NetworkBufferDescriptor_t * ) ( xReceivedEvent.pvData ) );
+
+					if( uxRxBatchCount >= ( UBaseType_t ) ipconfigRX_BATCH_SIZE )
+					{
+						vUDPWakeUpDeferredSocket();
+						uxRxBatchCount = 0u;
+					}
+				}
+				#else
+				{
+					( void ) prvHandleEthernetPacket( ( NetworkBufferDescriptor_t * ) ( xReceivedEvent.pvData ) );
+				}
+				#endif /* ipconfigRX_BATCH_SIZE */
 				break;
 
 			case eARPTimerEvent :
@@ -433,6 +475,27 @@ struct freertos_sockaddr xAddress;
 				vProcessGeneratedUDPPacket( ( NetworkBufferDescriptor_t * ) ( xReceivedEvent.pvData ) );
 				break;
 
+			case eStackTxChainEvent :
+				/* FreeRTOS_sendmmsg() has generated a chain of packets to
+				send. */
+				#if( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 )
+				{
+				NetworkBufferDescriptor_t *pxBuffer = ( NetworkBufferDescriptor_t * ) ( xReceivedEvent.pvData );
+				NetworkBufferDescriptor_t *pxNextBuffer;
+
+					while( pxBuffer != NULL )
+					{
+						/* The buffer may be released once it has been
+						handled, so fetch the next one first. */
+						pxNextBuffer = pxBuffer->pxNextBuffer;
+						pxBuffer->pxNextBuffer = NULL;
+						vProcessGeneratedUDPPacket( pxBuffer );
+						pxBuffer = pxNextBuffer;
+					}
+				}
+				#endif /* ipconfigSUPPORT_MMSG_FUNCTIONS */
+				break;
+
 			case eDHCPEvent:
 				/* The DHCP state machine needs processing. */
 				#if( ipconfigUSE_DHCP == 1 )
@@ -532,14 +595,17 @@ BaseType_t xReturn;
 }
 /*-----------------------------------------------------------*/
 
-static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer )
+static UBaseType_t prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer )
 {
+UBaseType_t uxCount = 0u;
+
 	#if( ipconfigUSE_LINKED_RX_MESSAGES == 0 )
 	{
 		/* When ipconfigUSE_LINKED_RX_MESSAGES is not set to 0 then only one
 		buffer will be sent at a time.  This is the default way for +TCP to pass
 		messages from the MAC to the TCP/IP stack. */
 		prvProcessEthernetPacket( pxBuffer );
+		uxCount++;
 	}
 	#else /* ipconfigUSE_LINKED_RX_MESSAGES */
 	{
@@ -561,11 +627,15 @@ static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer )
 
 			prvProcessEthernetPacket( pxBuffer );
 			pxBuffer = pxNextBuffer;
+			uxCount++;
 
 		/* While there is another packet in the chain. */
 		} while( pxBuffer != NULL );
 	}
 	#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+
+	/* Return the number of frames that were processed. */
+	return uxCount;
 }
 /*-----------------------------------------------------------*/
 
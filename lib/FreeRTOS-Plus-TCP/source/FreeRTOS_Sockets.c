@@ -117,6 +117,26 @@ static BaseType_t prvValidSocket( FreeRTOS_Socket_t *pxSocket, BaseType_t xProto
  */
 static BaseType_t prvDetermineSocketSize( BaseType_t xDomain, BaseType_t xType, BaseType_t xProtocol, size_t *pxSocketSize );
 
+/*
+ * Called from FreeRTOS_recvfrom() and FreeRTOS_recvmmsg(): pass a received UDP
+ * payload to the caller, either as a copy or, when FREERTOS_ZERO_COPY is set,
+ * as a pointer to the network buffer.
+ */
+static int32_t prvUDPReceiveBuffer( NetworkBufferDescriptor_t *pxNetworkBuffer, void *pvBuffer, size_t xBufferLength, BaseType_t xFlags, struct freertos_sockaddr *pxSourceAddress );
+
+/*
+ * Return the time for which a UDP send call may block.
+ */
+static TickType_t prvUDPSendBlockTime( FreeRTOS_Socket_t *pxSocket, BaseType_t xFlags );
+
+/*
+ * Called from FreeRTOS_sendto() and FreeRTOS_sendmmsg(): obtain the network
+ * buffer that holds a UDP payload and fill in its destination.  Returns NULL
+ * if no buffer could be obtained within the remaining block time.
+ */
+static NetworkBufferDescriptor_t *prvUDPPrepareBuffer( FreeRTOS_Socket_t *pxSocket, const void *pvBuffer, size_t xTotalDataLength, BaseType_t xFlags,
+	const struct freertos_sockaddr *pxDestinationAddress, TimeOut_t *pxTimeOut, TickType_t *pxTicksToWait );
+
 #if( ipconfigUSE_TCP == 1 )
 	/*
 	 * Create a txStream or a rxStream, depending on the parameter 'xIsInputStream'
@@ -132,6 +152,24 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain, BaseType_t xType,
 	static int32_t prvTCPSendCheck( FreeRTOS_Socket_t *pxSocket, size_t xDataLength );
 #endif /* ipconfigUSE_TCP */
 
+#if( ipconfigUSE_TCP == 1 )
+	/*
+	 * Called when the txStream of a TCP socket lacks space: wait until the
+	 * IP-task makes more space.  Returns pdFALSE, without waiting, when the
+	 * socket may not block or when the send timeout has been reached.
+	 */
+	static BaseType_t prvTCPWaitTxSpace( FreeRTOS_Socket_t *pxSocket, BaseType_t xFlags, BaseType_t *pxTimed, TimeOut_t *pxTimeOut, TickType_t *pxRemainingTime );
+#endif /* ipconfigUSE_TCP */
+
+#if( ipconfigUSE_TCP == 1 )
+	/*
+	 * Called from FreeRTOS_send() and FreeRTOS_sendv(): add the data of
+	 * uxVectorCount buffers to the txStream.  A buffer with a NULL pvBase has
+	 * already been written to the txStream by the caller.
+	 */
+	static BaseType_t prvTCPSendVectors( FreeRTOS_Socket_t *pxSocket, const struct freertos_iovec *pxVectors, size_t uxVectorCount, size_t uxDataLength, BaseType_t xFlags );
+#endif /* ipconfigUSE_TCP */
+
 #if( ipconfigUSE_TCP == 1 )
 	/*
 	 * When a child socket gets closed, make sure to update the child-count of the parent
@@ -431,6 +469,30 @@ Socket_t xReturn;
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+	/* Add a socket to a set, without having the IP-task check the set.  When
+	many sockets are added at once, this saves a message to the IP-task for
+	each socket.  The caller must call FreeRTOS_select() with a block time of
+	zero afterwards, to find the sockets that were already 'ready'. */
+	void FreeRTOS_FD_SET_NoCheck( Socket_t xSocket, SocketSet_t xSocketSet, EventBits_t xSelectBits )
+	{
+	FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+
+		configASSERT( pxSocket != NULL );
+		configASSERT( xSocketSet != NULL );
+
+		pxSocket->xSelectBits |= ( xSelectBits & eSELECT_ALL );
+
+		if( ( pxSocket->xSelectBits & eSELECT_ALL ) != 0 )
+		{
+			pxSocket->pxSocketSet = ( SocketSelect_t * ) xSocketSet;
+		}
+	}
+
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
 	/* Clear select bits for a socket
 	If the mask becomes 0, remove the socket from the set */
@@ -545,6 +607,23 @@ Socket_t xReturn;
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+	/* Return the event group on which FreeRTOS_select() blocks.  Other sources
+	of events may set bits above 'eSELECT_CALL_IP' in this group, to wake up a
+	task that waits for sockets and for those sources at the same time. */
+	EventGroupHandle_t FreeRTOS_GetSocketSetEventGroup( SocketSet_t xSocketSet )
+	{
+	SocketSelect_t *pxSocketSet = ( SocketSelect_t * ) xSocketSet;
+
+		configASSERT( xSocketSet != NULL );
+
+		return pxSocketSet->xSelectGroup;
+	}
+
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
 
 	/* Send a message to the IP-task to have it check all sockets belonging to
@@ -584,6 +663,52 @@ Socket_t xReturn;
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
 /*-----------------------------------------------------------*/
 
+static int32_t prvUDPReceiveBuffer( NetworkBufferDescriptor_t *pxNetworkBuffer, void *pvBuffer, size_t xBufferLength, BaseType_t xFlags, struct freertos_sockaddr *pxSourceAddress )
+{
+int32_t lReturn;
+
+	/* The returned value is the data length, which may have been capped to
+	the receive buffer size. */
+	lReturn = ( int32_t ) pxNetworkBuffer->xDataLength;
+
+	if( pxSourceAddress != NULL )
+	{
+		pxSourceAddress->sin_port = pxNetworkBuffer->usPort;
+		pxSourceAddress->sin_addr = pxNetworkBuffer->ulIPAddress;
+	}
+
+	if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
+	{
+		/* The zero copy flag is not set.  Truncate the length if it won't
+		fit in the provided buffer. */
+		if( lReturn > ( int32_t ) xBufferLength )
+		{
+			iptraceRECVFROM_DISCARDING_BYTES( ( xBufferLength - lReturn ) );
+			lReturn = ( int32_t )xBufferLength;
+		}
+
+		/* Copy the received data into the provided buffer, then release the
+		network buffer. */
+		memcpy( pvBuffer, ( void * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ), ( size_t )lReturn );
+
+		if( ( xFlags & FREERTOS_MSG_PEEK ) == 0 )
+		{
+			vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+		}
+	}
+	else
+	{
+		/* The zero copy flag was set.  pvBuffer is not a buffer into which
+		the received data can be copied, but a pointer that must be set to
+		point to the buffer in which the received data has already been
+		placed. */
+		*( ( void** ) pvBuffer ) = ( void * ) ( &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ) );
+	}
+
+	return lReturn;
+}
+/*-----------------------------------------------------------*/
+
 /*
  * FreeRTOS_recvfrom: receive data from a bound socket
  * In this library, the function can only be used with connectionsless sockets
@@ -697,44 +822,7 @@ EventBits_t xEventBits = ( EventBits_t ) 0;
 		}
 		taskEXIT_CRITICAL();
 
-		/* The returned value is the data length, which may have been capped to
-		the receive buffer size. */
-		lReturn = ( int32_t ) pxNetworkBuffer->xDataLength;
-
-		if( pxSourceAddress != NULL )
-		{
-			pxSourceAddress->sin_port = pxNetworkBuffer->usPort;
-			pxSourceAddress->sin_addr = pxNetworkBuffer->ulIPAddress;
-		}
-
-		if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
-		{
-			/* The zero copy flag is not set.  Truncate the length if it won't
-			fit in the provided buffer. */
-			if( lReturn > ( int32_t ) xBufferLength )
-			{
-				iptraceRECVFROM_DISCARDING_BYTES( ( xBufferLength - lReturn ) );
-				lReturn = ( int32_t )xBufferLength;
-			}
-
-			/* Copy the received data into the provided buffer, then release the
-			network buffer. */
-			memcpy( pvBuffer, ( void * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ), ( size_t )lReturn );
-
-			if( ( xFlags & FREERTOS_MSG_PEEK ) == 0 )
-			{
-				vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
-			}
-		}
-		else
-		{
-			/* The zero copy flag was set.  pvBuffer is not a buffer into which
-			the received data can be copied, but a pointer that must be set to
-			point to the buffer in which the received data has already been
-			placed. */
-			*( ( void** ) pvBuffer ) = ( void * ) ( &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ) );
-		}
-
+		lReturn = prvUDPReceiveBuffer( pxNetworkBuffer, pvBuffer, xBufferLength, xFlags, pxSourceAddress );
 	}
 #if( ipconfigSUPPORT_SIGNALS != 0 )
 	else if( ( xEventBits & eSOCKET_INTR ) != 0 )
@@ -753,6 +841,78 @@ EventBits_t xEventBits = ( EventBits_t ) 0;
 }
 /*-----------------------------------------------------------*/
 
+static TickType_t prvUDPSendBlockTime( FreeRTOS_Socket_t *pxSocket, BaseType_t xFlags )
+{
+TickType_t xTicksToWait = pxSocket->xSendBlockTime;
+
+	#if( ipconfigUSE_CALLBACKS != 0 )
+	{
+		if( xIsCallingFromIPTask() != pdFALSE )
+		{
+			/* If this send function is called from within a call-back
+			handler it may not block, otherwise chances would be big to
+			get a deadlock: the IP-task waiting for itself. */
+			xTicksToWait = ( TickType_t )0;
+		}
+	}
+	#endif /* ipconfigUSE_CALLBACKS */
+
+	if( ( xFlags & FREERTOS_MSG_DONTWAIT ) != 0 )
+	{
+		xTicksToWait = ( TickType_t ) 0;
+	}
+
+	return xTicksToWait;
+}
+/*-----------------------------------------------------------*/
+
+static NetworkBufferDescriptor_t *prvUDPPrepareBuffer( FreeRTOS_Socket_t *pxSocket, const void *pvBuffer, size_t xTotalDataLength, BaseType_t xFlags,
+	const struct freertos_sockaddr *pxDestinationAddress, TimeOut_t *pxTimeOut, TickType_t *pxTicksToWait )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+
+	if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
+	{
+		/* Zero copy is not set, so obtain a network buffer into
+		which the payload will be copied.  Block until a buffer becomes
+		available, or until a timeout has been reached */
+		pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xTotalDataLength + sizeof( UDPPacket_t ), *pxTicksToWait );
+
+		if( pxNetworkBuffer != NULL )
+		{
+			memcpy( ( void * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ), ( void * ) pvBuffer, xTotalDataLength );
+
+			if( xTaskCheckForTimeOut( pxTimeOut, pxTicksToWait ) == pdTRUE )
+			{
+				/* The entire block time has been used up. */
+				*pxTicksToWait = ( TickType_t ) 0;
+			}
+		}
+	}
+	else
+	{
+		/* When zero copy is used, pvBuffer is a pointer to the
+		payload of a buffer that has already been obtained from the
+		stack.  Obtain the network buffer pointer from the buffer. */
+		pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( (void*)pvBuffer );
+	}
+
+	if( pxNetworkBuffer != NULL )
+	{
+		pxNetworkBuffer->xDataLength = xTotalDataLength;
+		pxNetworkBuffer->usPort = pxDestinationAddress->sin_port;
+		pxNetworkBuffer->usBoundPort = ( uint16_t ) socketGET_SOCKET_PORT( pxSocket );
+		pxNetworkBuffer->ulIPAddress = pxDestinationAddress->sin_addr;
+
+		/* The socket options are passed to the IP layer in the
+		space that will eventually get used by the Ethernet header. */
+		pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = pxSocket->ucSocketOptions;
+	}
+
+	return pxNetworkBuffer;
+}
+/*-----------------------------------------------------------*/
+
 int32_t FreeRTOS_sendto( Socket_t xSocket, const void *pvBuffer, size_t xTotalDataLength, BaseType_t xFlags, const struct freertos_sockaddr *pxDestinationAddress, socklen_t xDestinationAddressLength )
 {
 NetworkBufferDescriptor_t *pxNetworkBuffer;
@@ -778,65 +938,13 @@ FreeRTOS_Socket_t *pxSocket;
 		if( ( socketSOCKET_IS_BOUND( pxSocket ) != pdFALSE ) ||
 			( FreeRTOS_bind( xSocket, NULL, 0u ) == 0 ) )
 		{
-			xTicksToWait = pxSocket->xSendBlockTime;
-
-			#if( ipconfigUSE_CALLBACKS != 0 )
-			{
-				if( xIsCallingFromIPTask() != pdFALSE )
-				{
-					/* If this send function is called from within a call-back
-					handler it may not block, otherwise chances would be big to
-					get a deadlock: the IP-task waiting for itself. */
-					xTicksToWait = ( TickType_t )0;
-				}
-			}
-			#endif /* ipconfigUSE_CALLBACKS */
-
-			if( ( xFlags & FREERTOS_MSG_DONTWAIT ) != 0 )
-			{
-				xTicksToWait = ( TickType_t ) 0;
-			}
-
-			if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
-			{
-				/* Zero copy is not set, so obtain a network buffer into
-				which the payload will be copied. */
-				vTaskSetTimeOutState( &xTimeOut );
-
-				/* Block until a buffer becomes available, or until a
-				timeout has been reached */
-				pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xTotalDataLength + sizeof( UDPPacket_t ), xTicksToWait );
-
-				if( pxNetworkBuffer != NULL )
-				{
-					memcpy( ( void * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ), ( void * ) pvBuffer, xTotalDataLength );
+			xTicksToWait = prvUDPSendBlockTime( pxSocket, xFlags );
+			vTaskSetTimeOutState( &xTimeOut );
 
-					if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE )
-					{
-						/* The entire block time has been used up. */
-						xTicksToWait = ( TickType_t ) 0;
-					}
-				}
-			}
-			else
-			{
-				/* When zero copy is used, pvBuffer is a pointer to the
-				payload of a buffer that has already been obtained from the
-				stack.  Obtain the network buffer pointer from the buffer. */
-				pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( (void*)pvBuffer );
-			}
+			pxNetworkBuffer = prvUDPPrepareBuffer( pxSocket, pvBuffer, xTotalDataLength, xFlags, pxDestinationAddress, &xTimeOut, &xTicksToWait );
 
 			if( pxNetworkBuffer != NULL )
 			{
-				pxNetworkBuffer->xDataLength = xTotalDataLength;
-				pxNetworkBuffer->usPort = pxDestinationAddress->sin_port;
-				pxNetworkBuffer->usBoundPort = ( uint16_t ) socketGET_SOCKET_PORT( pxSocket );
-				pxNetworkBuffer->ulIPAddress = pxDestinationAddress->sin_addr;
-
-				/* The socket options are passed to the IP layer in the
-				space that will eventually get used by the Ethernet header. */
-				pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = pxSocket->ucSocketOptions;
-
 				/* Tell the networking task that the packet needs sending. */
 				xStackTxEvent.pvData = pxNetworkBuffer;
 
@@ -889,6 +997,182 @@ FreeRTOS_Socket_t *pxSocket;
 } /* Tested */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 )
+
+	int32_t FreeRTOS_recvmmsg( Socket_t xSocket, struct freertos_mmsghdr *pxMessages, size_t uxMessageCount, BaseType_t xFlags )
+	{
+	FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+	NetworkBufferDescriptor_t *pxNetworkBuffer;
+	struct freertos_mmsghdr *pxMessage;
+	void *pvBuffer;
+	int32_t lLength;
+	int32_t lReturn;
+
+		if( uxMessageCount == 0u )
+		{
+			return -pdFREERTOS_ERRNO_EINVAL;
+		}
+
+		/* Wait for the first message in the same way as FreeRTOS_recvfrom().
+		With zero copy, the pointer to the payload is stored in pvBuffer. */
+		pxMessage = &( pxMessages[ 0 ] );
+		pvBuffer = ( ( xFlags & FREERTOS_ZERO_COPY ) != 0 ) ? ( void * ) &( pxMessage->pvBuffer ) : pxMessage->pvBuffer;
+		lLength = FreeRTOS_recvfrom( xSocket, pvBuffer, pxMessage->xBufferLength, xFlags, &( pxMessage->xAddress ), NULL );
+
+		if( lLength < 0 )
+		{
+			/* Nothing was received, return the error code. */
+			lReturn = lLength;
+		}
+		else
+		{
+			pxMessage->xDataLength = ( size_t ) lLength;
+			lReturn = 1;
+
+			/* Take the messages that are already waiting without blocking.  A
+			peek only looks at the first message. */
+			while( ( ( size_t ) lReturn < uxMessageCount ) && ( ( xFlags & FREERTOS_MSG_PEEK ) == 0 ) )
+			{
+				pxNetworkBuffer = NULL;
+
+				taskENTER_CRITICAL();
+				{
+					if( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) != 0u )
+					{
+						pxNetworkBuffer = ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xUDP.xWaitingPacketsList ) );
+						uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+					}
+				}
+				taskEXIT_CRITICAL();
+
+				if( pxNetworkBuffer == NULL )
+				{
+					break;
+				}
+
+				pxMessage = &( pxMessages[ lReturn ] );
+				pvBuffer = ( ( xFlags & FREERTOS_ZERO_COPY ) != 0 ) ? ( void * ) &( pxMessage->pvBuffer ) : pxMessage->pvBuffer;
+				pxMessage->xDataLength = ( size_t ) prvUDPReceiveBuffer( pxNetworkBuffer, pvBuffer, pxMessage->xBufferLength, xFlags, &( pxMessage->xAddress ) );
+				lReturn++;
+			}
+		}
+
+		return lReturn;
+	}
+
+#endif /* ipconfigSUPPORT_MMSG_FUNCTIONS */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 )
+
+	int32_t FreeRTOS_sendmmsg( Socket_t xSocket, const struct freertos_mmsghdr *pxMessages, size_t uxMessageCount, BaseType_t xFlags )
+	{
+	FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+	NetworkBufferDescriptor_t *pxNetworkBuffer;
+	NetworkBufferDescriptor_t *pxFirstBuffer = NULL;
+	NetworkBufferDescriptor_t *pxLastBuffer = NULL;
+	IPStackEvent_t xStackTxEvent = { eStackTxChainEvent, NULL };
+	TimeOut_t xTimeOut;
+	TickType_t xTicksToWait;
+	size_t uxIndex;
+	int32_t lReturn = 0;
+
+		if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdFALSE ) == pdFALSE )
+		{
+			return -pdFREERTOS_ERRNO_EINVAL;
+		}
+
+		/* If the socket is not already bound to an address, bind it now. */
+		if( ( socketSOCKET_IS_BOUND( pxSocket ) == pdFALSE ) &&
+			( FreeRTOS_bind( xSocket, NULL, 0u ) != 0 ) )
+		{
+			iptraceSENDTO_SOCKET_NOT_BOUND();
+			return 0;
+		}
+
+		xTicksToWait = prvUDPSendBlockTime( pxSocket, xFlags );
+		vTaskSetTimeOutState( &xTimeOut );
+
+		/* Chain the buffers of all messages, so that they are passed to the
+		IP-task in a single event.  Stop at the first message that can not
+		be sent. */
+		for( uxIndex = 0u; uxIndex < uxMessageCount; uxIndex++ )
+		{
+			configASSERT( pxMessages[ uxIndex ].pvBuffer );
+
+			if( pxMessages[ uxIndex ].xDataLength > ( size_t ) ipMAX_UDP_PAYLOAD_LENGTH )
+			{
+				iptraceSENDTO_DATA_TOO_LONG();
+				break;
+			}
+
+			pxNetworkBuffer = prvUDPPrepareBuffer( pxSocket, pxMessages[ uxIndex ].pvBuffer, pxMessages[ uxIndex ].xDataLength, xFlags,
+				&( pxMessages[ uxIndex ].xAddress ), &xTimeOut, &xTicksToWait );
+
+			if( pxNetworkBuffer == NULL )
+			{
+				iptraceNO_BUFFER_FOR_SENDTO();
+				break;
+			}
+
+			pxNetworkBuffer->pxNextBuffer = NULL;
+
+			if( pxFirstBuffer == NULL )
+			{
+				pxFirstBuffer = pxNetworkBuffer;
+			}
+			else
+			{
+				pxLastBuffer->pxNextBuffer = pxNetworkBuffer;
+			}
+
+			pxLastBuffer = pxNetworkBuffer;
+		}
+
+		if( pxFirstBuffer != NULL )
+		{
+			xStackTxEvent.pvData = pxFirstBuffer;
+
+			if( xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait ) == pdPASS )
+			{
+				/* All chained messages were passed to the IP-task. */
+				lReturn = ( int32_t ) uxIndex;
+
+				#if( ipconfigUSE_CALLBACKS == 1 )
+				{
+					if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
+					{
+						for( uxIndex = 0u; uxIndex < ( size_t ) lReturn; uxIndex++ )
+						{
+							pxSocket->u.xUDP.pxHandleSent( (Socket_t *)pxSocket, pxMessages[ uxIndex ].xDataLength );
+						}
+					}
+				}
+				#endif /* ipconfigUSE_CALLBACKS */
+			}
+			else
+			{
+				/* Release the buffers that were allocated in this function.
+				With zero copy, the buffers still belong to the caller. */
+				if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
+				{
+					while( pxFirstBuffer != NULL )
+					{
+						pxNetworkBuffer = pxFirstBuffer;
+						pxFirstBuffer = pxFirstBuffer->pxNextBuffer;
+						vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+					}
+				}
+				iptraceSTACK_TX_EVENT_LOST( ipSTACK_TX_EVENT );
+			}
+		}
+
+		return lReturn;
+	}
+
+#endif /* ipconfigSUPPORT_MMSG_FUNCTIONS */
+/*-----------------------------------------------------------*/
+
 /*
  * FreeRTOS_bind() : binds a sockt to a local port number.  If port 0 is
  * provided, a system provided port number will be assigned.  This function can
@@ -2436,24 +2720,79 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 /*-----------------------------------------------------------*/
 
 #if( ipconfigUSE_TCP == 1 )
-	/*
-	 * Send data using a TCP socket.  It is not necessary to have the socket
-	 * connected already.  Outgoing data will be stored and delivered as soon as
-	 * the socket gets connected.
-	 */
-	BaseType_t FreeRTOS_send( Socket_t xSocket, const void *pvBuffer, size_t uxDataLength, BaseType_t xFlags )
+
+	static BaseType_t prvTCPWaitTxSpace( FreeRTOS_Socket_t *pxSocket, BaseType_t xFlags, BaseType_t *pxTimed, TimeOut_t *pxTimeOut, TickType_t *pxRemainingTime )
+	{
+	BaseType_t xReturn = pdTRUE;
+
+		if( *pxTimed == pdFALSE )
+		{
+			/* Only in the first round, check for non-blocking. */
+			*pxRemainingTime = pxSocket->xSendBlockTime;
+
+			#if( ipconfigUSE_CALLBACKS != 0 )
+			{
+				if( xIsCallingFromIPTask() != pdFALSE )
+				{
+					/* If this send function is called from within a
+					call-back handler it may not block, otherwise
+					chances would be big to get a deadlock: the IP-task
+					waiting for	itself. */
+					*pxRemainingTime = ( TickType_t ) 0;
+				}
+			}
+			#endif /* ipconfigUSE_CALLBACKS */
+
+			if( ( *pxRemainingTime == ( TickType_t ) 0 ) || ( ( xFlags & FREERTOS_MSG_DONTWAIT ) != 0 ) )
+			{
+				xReturn = pdFALSE;
+			}
+			else
+			{
+				/* Don't get here a second time. */
+				*pxTimed = pdTRUE;
+
+				/* Fetch the current time. */
+				vTaskSetTimeOutState( pxTimeOut );
+			}
+		}
+		else
+		{
+			/* Has the timeout been reached? */
+			if( xTaskCheckForTimeOut( pxTimeOut, pxRemainingTime ) != pdFALSE )
+			{
+				xReturn = pdFALSE;
+			}
+		}
+
+		if( xReturn != pdFALSE )
+		{
+			/* Go sleeping until down-stream events are received. */
+			xEventGroupWaitBits( pxSocket->xEventGroup, eSOCKET_SEND | eSOCKET_CLOSED,
+				pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, *pxRemainingTime );
+		}
+
+		return xReturn;
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	static BaseType_t prvTCPSendVectors( FreeRTOS_Socket_t *pxSocket, const struct freertos_iovec *pxVectors, size_t uxVectorCount, size_t uxDataLength, BaseType_t xFlags )
 	{
 	BaseType_t xByteCount;
 	BaseType_t xBytesLeft;
-	FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+	BaseType_t xBytesAdded;
 	TickType_t xRemainingTime;
 	BaseType_t xTimed = pdFALSE;
 	TimeOut_t xTimeOut;
 	BaseType_t xCloseAfterSend;
-
-		/* Prevent compiler warnings about unused parameters.  The parameter
-		may be used in future versions. */
-		( void ) xFlags;
+	size_t uxVector = 0u;
+	size_t uxOffset = 0u;
+	size_t uxCount;
+	const uint8_t *pucData;
 
 		xByteCount = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxDataLength );
 
@@ -2504,7 +2843,37 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 						pxSocket->u.xTCP.bits.bCloseRequested = pdTRUE_UNSIGNED;
 					}
 
-					xByteCount = ( BaseType_t ) uxStreamBufferAdd( pxSocket->u.xTCP.txStream, 0ul, ( const uint8_t * ) pvBuffer, ( size_t ) xByteCount );
+					/* Copy xByteCount bytes, taking them from as many buffers
+					as necessary. */
+					xBytesAdded = 0;
+
+					while( ( xBytesAdded < xByteCount ) && ( uxVector < uxVectorCount ) )
+					{
+						uxCount = FreeRTOS_min_uint32( pxVectors[ uxVector ].xLength - uxOffset, ( size_t ) ( xByteCount - xBytesAdded ) );
+
+						if( pxVectors[ uxVector ].pvBase != NULL )
+						{
+							pucData = ( ( const uint8_t * ) pxVectors[ uxVector ].pvBase ) + uxOffset;
+						}
+						else
+						{
+							/* FreeRTOS_send() was called with a NULL buffer
+							after the data was written at the head returned by
+							FreeRTOS_get_tx_head(), only advance the head. */
+							pucData = NULL;
+						}
+
+						xBytesAdded += ( BaseType_t ) uxStreamBufferAdd( pxSocket->u.xTCP.txStream, 0ul, pucData, uxCount );
+						uxOffset += uxCount;
+
+						if( uxOffset >= pxVectors[ uxVector ].xLength )
+						{
+							uxVector++;
+							uxOffset = 0u;
+						}
+					}
+
+					xByteCount = xBytesAdded;
 
 					if( xCloseAfterSend != pdFALSE )
 					{
@@ -2531,61 +2900,15 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 					{
 						break;
 					}
-
-					/* As there are still bytes left to be sent, increase the
-					data pointer. */
-					pvBuffer = ( void * ) ( ( ( const uint8_t * ) pvBuffer) + xByteCount );
 				}
 
 				/* Not all bytes have been sent. In case the socket is marked as
 				blocking sleep for a while. */
-				if( xTimed == pdFALSE )
-				{
-					/* Only in the first round, check for non-blocking. */
-					xRemainingTime = pxSocket->xSendBlockTime;
-
-					#if( ipconfigUSE_CALLBACKS != 0 )
-					{
-						if( xIsCallingFromIPTask() != pdFALSE )
-						{
-							/* If this send function is called from within a
-							call-back handler it may not block, otherwise
-							chances would be big to get a deadlock: the IP-task
-							waiting for	itself. */
-							xRemainingTime = ( TickType_t ) 0;
-						}
-					}
-					#endif /* ipconfigUSE_CALLBACKS */
-
-					if( xRemainingTime == ( TickType_t ) 0 )
-					{
-						break;
-					}
-
-					if( ( xFlags & FREERTOS_MSG_DONTWAIT ) != 0 )
-					{
-						break;
-					}
-
-					/* Don't get here a second time. */
-					xTimed = pdTRUE;
-
-					/* Fetch the current time. */
-					vTaskSetTimeOutState( &xTimeOut );
-				}
-				else
+				if( prvTCPWaitTxSpace( pxSocket, xFlags, &xTimed, &xTimeOut, &xRemainingTime ) == pdFALSE )
 				{
-					/* Has the timeout been reached? */
-					if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
-					{
-						break;
-					}
+					break;
 				}
 
-				/* Go sleeping until down-stream events are received. */
-				xEventGroupWaitBits( pxSocket->xEventGroup, eSOCKET_SEND | eSOCKET_CLOSED,
-					pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
-
 				xByteCount = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
 			}
 
@@ -2619,6 +2942,60 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_TCP == 1 )
+	/*
+	 * Send data using a TCP socket.  It is not necessary to have the socket
+	 * connected already.  Outgoing data will be stored and delivered as soon as
+	 * the socket gets connected.
+	 */
+	BaseType_t FreeRTOS_send( Socket_t xSocket, const void *pvBuffer, size_t uxDataLength, BaseType_t xFlags )
+	{
+	struct freertos_iovec xVector;
+
+		xVector.pvBase = ( void * ) pvBuffer;
+		xVector.xLength = uxDataLength;
+
+		return prvTCPSendVectors( ( FreeRTOS_Socket_t * ) xSocket, &xVector, 1u, uxDataLength, xFlags );
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+	/*
+	 * Send the data of several buffers using a TCP socket, as if they were
+	 * one buffer.  Each byte is copied once, directly into the txStream.
+	 */
+	BaseType_t FreeRTOS_sendv( Socket_t xSocket, const struct freertos_iovec *pxVectors, size_t uxVectorCount, BaseType_t xFlags )
+	{
+	size_t uxDataLength = 0u;
+	size_t uxVector;
+	BaseType_t xReturn = 0;
+
+		for( uxVector = 0u; uxVector < uxVectorCount; uxVector++ )
+		{
+			if( pxVectors[ uxVector ].pvBase == NULL )
+			{
+				/* A NULL pointer has a special meaning for
+				prvTCPSendVectors(). */
+				xReturn = -pdFREERTOS_ERRNO_EINVAL;
+				break;
+			}
+
+			uxDataLength += pxVectors[ uxVector ].xLength;
+		}
+
+		if( xReturn == 0 )
+		{
+			xReturn = prvTCPSendVectors( ( FreeRTOS_Socket_t * ) xSocket, pxVectors, uxVectorCount, uxDataLength, xFlags );
+		}
+
+		return xReturn;
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigUSE_TCP == 1 )
 
 	/*
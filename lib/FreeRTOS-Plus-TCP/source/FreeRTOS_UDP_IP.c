@@ -70,6 +70,12 @@ UDPPacketHeader_t xDefaultPartUDPPacketHeader =
 		0x00, 0x00, 0x00, 0x00 					/* Source IP address. */
 	}
 };
+
+#if( ipconfigRX_BATCH_SIZE > 1 )
+	/* The socket that received the last frames of the current batch, and whose
+	owner has not been woken up yet. */
+	static FreeRTOS_Socket_t *pxDeferredWakeUpSocket = NULL;
+#endif
 /*-----------------------------------------------------------*/
 
 void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer )
@@ -308,29 +314,55 @@ UDPPacket_t *pxUDPPacket = (UDPPacket_t *) pxNetworkBuffer->pucEthernetBuffer;
 			}
 			xTaskResumeAll();
 
-			/* Set the socket's receive event */
-			if( pxSocket->xEventGroup != NULL )
+			#if( ipconfigRX_BATCH_SIZE > 1 )
 			{
-				xEventGroupSetBits( pxSocket->xEventGroup, eSOCKET_RECEIVE );
-			}
+				/* Frames for the same socket tend to arrive back to back.  Only
+				record the events here; the owner is woken up once when a frame
+				for another socket arrives, or when the IP-task ends the batch. */
+				if( pxSocket != pxDeferredWakeUpSocket )
+				{
+					vUDPWakeUpDeferredSocket();
+					pxDeferredWakeUpSocket = pxSocket;
+				}
 
-			#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
-			{
-				if( ( pxSocket->pxSocketSet != NULL ) && ( ( pxSocket->xSelectBits & eSELECT_READ ) != 0 ) )
+				pxSocket->xEventBits |= eSOCKET_RECEIVE;
+
+				#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
 				{
-					xEventGroupSetBits( pxSocket->pxSocketSet->xSelectGroup, eSELECT_READ );
+					if( ( pxSocket->pxSocketSet != NULL ) && ( ( pxSocket->xSelectBits & eSELECT_READ ) != 0 ) )
+					{
+						pxSocket->xEventBits |= ( eSELECT_READ << SOCKET_EVENT_BIT_COUNT );
+					}
 				}
+				#endif
 			}
-			#endif
-
-			#if( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
+			#else
 			{
-				if( pxSocket->pxUserSemaphore != NULL )
+				/* Set the socket's receive event */
+				if( pxSocket->xEventGroup != NULL )
+				{
+					xEventGroupSetBits( pxSocket->xEventGroup, eSOCKET_RECEIVE );
+				}
+
+				#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+				{
+					if( ( pxSocket->pxSocketSet != NULL ) && ( ( pxSocket->xSelectBits & eSELECT_READ ) != 0 ) )
+					{
+						xEventGroupSetBits( pxSocket->pxSocketSet->xSelectGroup, eSELECT_READ );
+					}
+				}
+				#endif
+
+				#if( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
 				{
-					xSemaphoreGive( pxSocket->pxUserSemaphore );
+					if( pxSocket->pxUserSemaphore != NULL )
+					{
+						xSemaphoreGive( pxSocket->pxUserSemaphore );
+					}
 				}
+				#endif
 			}
-			#endif
+			#endif /* ipconfigRX_BATCH_SIZE */
 
 			#if( ipconfigUSE_DHCP == 1 )
 			{
@@ -376,3 +408,17 @@ UDPPacket_t *pxUDPPacket = (UDPPacket_t *) pxNetworkBuffer->pucEthernetBuffer;
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
+
+#if( ipconfigRX_BATCH_SIZE > 1 )
+
+	void vUDPWakeUpDeferredSocket( void )
+	{
+		if( pxDeferredWakeUpSocket != NULL )
+		{
+			vSocketWakeUpUser( pxDeferredWakeUpSocket );
+			pxDeferredWakeUpSocket = NULL;
+		}
+	}
+
+#endif /* ipconfigRX_BATCH_SIZE */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,802 @@
+/*
+FreeRTOS+TCP V2.0.7
+Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ http://aws.amazon.com/freertos
+ http://www.FreeRTOS.org
+*/
+
+/*
+ * A network driver for the POSIX simulator port that connects FreeRTOS+TCP
+ * nodes through a virtual Ethernet switch rather than a real network, so the
+ * throughput and latency of the whole stack can be measured deterministically
+ * on a host.
+ *
+ * FreeRTOS+TCP supports one instance per program, so each node is a separate
+ * host process.  The switch is held in POSIX shared memory that every node
+ * using the same configVSWITCH_NAME maps.  Each node owns one port on the
+ * switch, consisting of its MAC address and a queue of frames waiting to be
+ * received.  Sending a frame copies it into the receive queue of the port with
+ * the destination MAC address, or of every other port for broadcast and
+ * multicast frames, stamped with the time at which the frame would arrive
+ * given the latency and bandwidth of the sender's link.  The sender's link may
+ * also lose the frame, using a pseudo random sequence seeded from
+ * configVSWITCH_SEED so runs are repeatable.
+ *
+ * A host thread in each node waits until the frame at the front of the node's
+ * receive queue is due, then raises a simulated interrupt, which wakes a task
+ * that passes the due frames to the IP task.
+ */
+
+/* Standard includes. */
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkInterface.h"
+#include "NetworkBufferManagement.h"
+
+#include "VirtualSwitch.h"
+
+/* If ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES is set to 1, then the Ethernet
+driver will filter incoming packets and only pass the stack those packets it
+considers need processing. */
+#if( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES == 0 )
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) eProcessBuffer
+#else
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) eConsiderFrameForProcessing( ( pucEthernetBuffer ) )
+#endif
+
+/* The name of the shared memory object that holds the switch.  Nodes that use
+the same name are connected to each other. */
+#ifndef configVSWITCH_NAME
+	#define configVSWITCH_NAME				"/freertos_vswitch"
+#endif
+
+/* Default characteristics of this node's link, which can be changed at run
+time with xVirtualSwitchSetLink(). */
+#ifndef configVSWITCH_LATENCY_US
+	#define configVSWITCH_LATENCY_US		0
+#endif
+
+#ifndef configVSWITCH_LOSS_PER_MILLION
+	#define configVSWITCH_LOSS_PER_MILLION	0
+#endif
+
+#ifndef configVSWITCH_BANDWIDTH_BPS
+	#define configVSWITCH_BANDWIDTH_BPS		0
+#endif
+
+/* Seed of the pseudo random sequence that decides which frames are lost. */
+#ifndef configVSWITCH_SEED
+	#define configVSWITCH_SEED				1
+#endif
+
+/* The simulated interrupt raised when received frames are due.  Interrupts 0
+and 1 are used by the kernel. */
+#ifndef configVSWITCH_INTERRUPT
+	#define configVSWITCH_INTERRUPT			2
+#endif
+
+/* Priority of the task that passes received frames to the IP task. */
+#ifndef configMAC_ISR_SIMULATOR_PRIORITY
+	#define configMAC_ISR_SIMULATOR_PRIORITY	( configMAX_PRIORITIES - 1 )
+#endif
+
+/* Dimensions of the switch.  They are fixed, rather than derived from the
+FreeRTOS+TCP configuration, so that nodes built with different configurations
+can share a switch. */
+#define vswitchMAX_PORTS					8
+#define vswitchQUEUE_LENGTH					64
+#define vswitchMAX_FRAME_SIZE				1536
+#define vswitchMAGIC						0x56535731UL
+
+#define vswitchNS_PER_SECOND				1000000000ULL
+
+/*-----------------------------------------------------------*/
+
+/* A frame waiting in a port's receive queue. */
+typedef struct xSWITCH_FRAME
+{
+	uint64_t ullDeliverAt;		/* CLOCK_MONOTONIC time at which the frame is due, in ns. */
+	uint32_t ulLength;
+	uint8_t ucFrame[ vswitchMAX_FRAME_SIZE ];
+} SwitchFrame_t;
+
+typedef struct xSWITCH_PORT
+{
+	BaseType_t xInUse;
+	pid_t xOwner;
+	uint8_t ucMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ];
+
+	/* Link from the node to the switch.  ullLinkFreeAt is the time at which the
+	previous frame sent by the node has been fully serialised onto the link. */
+	VirtualSwitchLink_t xLink;
+	uint64_t ullLinkFreeAt;
+	uint32_t ulRandom;
+
+	VirtualSwitchStats_t xStats;
+
+	/* Frames waiting to be received by the node, and the condition its
+	receive thread waits on for new frames. */
+	uint32_t ulHead;
+	uint32_t ulTail;
+	pthread_cond_t xFrameAvailable;
+	SwitchFrame_t xFrames[ vswitchQUEUE_LENGTH ];
+} SwitchPort_t;
+
+/* The layout of the shared memory. */
+typedef struct xSWITCH
+{
+	volatile uint32_t ulMagic;
+	pthread_mutex_t xMutex;
+	SwitchPort_t xPorts[ vswitchMAX_PORTS ];
+} Switch_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Map the switch, creating it if this is the first node, and claim a port.
+ */
+static Switch_t *prvOpenSwitch( void );
+static BaseType_t prvAttachPort( Switch_t *pxSwitch );
+
+/*
+ * Lock the switch.  The lock is shared with other processes, so it is only
+ * taken by FreeRTOS tasks inside a critical section, otherwise another task in
+ * this node could block on it while the holder is not running.
+ */
+static void prvLockSwitch( void );
+static void prvUnlockSwitch( void );
+
+/*
+ * Copy a frame into the receive queue of a port.
+ */
+static void prvQueueFrame( SwitchPort_t *pxPort, const uint8_t *pucFrame, size_t xLength, uint64_t ullDeliverAt );
+
+/*
+ * The host thread that raises the receive interrupt, the interrupt handler, and
+ * the task it wakes.
+ */
+static void *prvReceiveThread( void *pvParameters );
+static uint32_t prvReceiveInterruptHandler( void );
+static void prvReceiveTask( void *pvParameters );
+
+/*
+ * Returns pdFALSE if the port is free.  Ports left behind by nodes that exited
+ * without detaching are freed, as their receive threads may have died while
+ * waiting on the port's condition, and signalling it again would block.
+ */
+static BaseType_t prvPortInUse( SwitchPort_t *pxCandidate );
+
+static uint64_t prvNow( void );
+static void prvDetachPort( void );
+
+/*-----------------------------------------------------------*/
+
+static Switch_t *pxSwitch = NULL;
+static SwitchPort_t *pxPort = NULL;
+
+/* Link characteristics, which are copied to the port when it is attached. */
+static VirtualSwitchLink_t xLink =
+{
+	configVSWITCH_LATENCY_US,
+	configVSWITCH_LOSS_PER_MILLION,
+	configVSWITCH_BANDWIDTH_BPS
+};
+
+/* Set when the receive interrupt has been raised, and cleared when the task it
+wakes finds no more due frames.  Protected by the switch lock. */
+static BaseType_t xInterruptRaised = pdFALSE;
+
+static TaskHandle_t xReceiveTaskHandle = NULL;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkInterfaceInitialise( void )
+{
+BaseType_t xReturn = pdPASS;
+pthread_t xThread;
+int iResult;
+
+	/* The network may be restarted, in which case the node is still connected
+	to the switch. */
+	if( pxPort == NULL )
+	{
+		pxSwitch = prvOpenSwitch();
+
+		if( ( pxSwitch == NULL ) || ( prvAttachPort( pxSwitch ) != pdPASS ) )
+		{
+			FreeRTOS_printf( ( "xNetworkInterfaceInitialise: could not connect to %s\n", configVSWITCH_NAME ) );
+			xReturn = pdFAIL;
+		}
+		else
+		{
+			vPortSetInterruptHandler( configVSWITCH_INTERRUPT, prvReceiveInterruptHandler );
+			xTaskCreate( prvReceiveTask, "VSwitchRx", configMINIMAL_STACK_SIZE, NULL, configMAC_ISR_SIMULATOR_PRIORITY, &xReceiveTaskHandle );
+			configASSERT( xReceiveTaskHandle != NULL );
+
+			/* The host thread must be created in a critical section so it does
+			not take the signals used to simulate interrupts. */
+			taskENTER_CRITICAL();
+			{
+				iResult = pthread_create( &xThread, NULL, prvReceiveThread, NULL );
+			}
+			taskEXIT_CRITICAL();
+
+			configASSERT( iResult == 0 );
+			( void ) iResult;
+			pthread_detach( xThread );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkInterfaceOutput( NetworkBufferDescriptor_t * const pxNetworkBuffer, BaseType_t bReleaseAfterSend )
+{
+const uint8_t *pucFrame = pxNetworkBuffer->pucEthernetBuffer;
+size_t xLength = pxNetworkBuffer->xDataLength;
+SwitchPort_t *pxDestination;
+uint64_t ullNow, ullDeliverAt;
+BaseType_t xPortNumber, xLost;
+
+	iptraceNETWORK_INTERFACE_TRANSMIT();
+
+	if( ( pxPort != NULL ) && ( xLength >= ipSIZE_OF_ETH_HEADER ) && ( xLength <= vswitchMAX_FRAME_SIZE ) )
+	{
+		taskENTER_CRITICAL();
+		prvLockSwitch();
+		{
+			pxPort->xStats.ulFramesSent++;
+
+			/* Work out when the frame arrives.  It cannot start to be sent
+			until the link has finished sending the previous frame. */
+			ullNow = prvNow();
+			ullDeliverAt = ( pxPort->ullLinkFreeAt > ullNow ) ? pxPort->ullLinkFreeAt : ullNow;
+
+			if( pxPort->xLink.ullBandwidthBps != 0ULL )
+			{
+				ullDeliverAt += ( ( uint64_t ) xLength * 8ULL * vswitchNS_PER_SECOND ) / pxPort->xLink.ullBandwidthBps;
+			}
+
+			pxPort->ullLinkFreeAt = ullDeliverAt;
+			ullDeliverAt += ( uint64_t ) pxPort->xLink.ulLatencyUs * 1000ULL;
+
+			/* xorshift32, which is repeatable for a given seed. */
+			pxPort->ulRandom ^= pxPort->ulRandom << 13;
+			pxPort->ulRandom ^= pxPort->ulRandom >> 17;
+			pxPort->ulRandom ^= pxPort->ulRandom << 5;
+			xLost = ( ( pxPort->ulRandom % 1000000UL ) < pxPort->xLink.ulLossPerMillion ) ? pdTRUE : pdFALSE;
+
+			if( xLost != pdFALSE )
+			{
+				pxPort->xStats.ulFramesLost++;
+			}
+			else
+			{
+				for( xPortNumber = 0; xPortNumber < vswitchMAX_PORTS; xPortNumber++ )
+				{
+					pxDestination = &( pxSwitch->xPorts[ xPortNumber ] );
+
+					if( ( pxDestination == pxPort ) || ( prvPortInUse( pxDestination ) == pdFALSE ) )
+					{
+						continue;
+					}
+
+					/* The group bit of the destination address is set for
+					broadcast and multicast frames, which go to every port.
+					Frames to unknown unicast addresses are not delivered. */
+					if( ( ( pucFrame[ 0 ] & 0x01U ) != 0U ) ||
+						( memcmp( pucFrame, pxDestination->ucMACAddress, ipMAC_ADDRESS_LENGTH_BYTES ) == 0 ) )
+					{
+						prvQueueFrame( pxDestination, pucFrame, xLength, ullDeliverAt );
+					}
+				}
+			}
+		}
+		prvUnlockSwitch();
+		taskEXIT_CRITICAL();
+	}
+
+	/* The frame has been copied so the buffer can be released. */
+	if( bReleaseAfterSend != pdFALSE )
+	{
+		vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetPhyLinkStatus( void )
+{
+	return ( pxPort != NULL ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xVirtualSwitchSetLink( const VirtualSwitchLink_t *pxNewLink )
+{
+	configASSERT( pxNewLink != NULL );
+
+	taskENTER_CRITICAL();
+	{
+		xLink = *pxNewLink;
+
+		if( pxPort != NULL )
+		{
+			prvLockSwitch();
+			pxPort->xLink = xLink;
+			prvUnlockSwitch();
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xVirtualSwitchGetStats( VirtualSwitchStats_t *pxStats )
+{
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( pxStats != NULL );
+
+	taskENTER_CRITICAL();
+	{
+		if( pxPort != NULL )
+		{
+			prvLockSwitch();
+			*pxStats = pxPort->xStats;
+			prvUnlockSwitch();
+			xReturn = pdPASS;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static Switch_t *prvOpenSwitch( void )
+{
+Switch_t *pxMapped = NULL;
+pthread_mutexattr_t xMutexAttributes;
+BaseType_t xCreated = pdTRUE, xAttempts;
+struct stat xStat;
+int iHandle;
+
+	iHandle = shm_open( configVSWITCH_NAME, O_RDWR | O_CREAT | O_EXCL, 0600 );
+
+	if( ( iHandle < 0 ) && ( errno == EEXIST ) )
+	{
+		xCreated = pdFALSE;
+		iHandle = shm_open( configVSWITCH_NAME, O_RDWR, 0600 );
+	}
+
+	if( iHandle >= 0 )
+	{
+		if( xCreated != pdFALSE )
+		{
+			if( ftruncate( iHandle, ( off_t ) sizeof( Switch_t ) ) != 0 )
+			{
+				close( iHandle );
+				shm_unlink( configVSWITCH_NAME );
+				return NULL;
+			}
+		}
+		else
+		{
+			/* Wait for the node that created the switch to size it. */
+			for( xAttempts = 0; xAttempts < 1000; xAttempts++ )
+			{
+				if( ( fstat( iHandle, &xStat ) == 0 ) && ( xStat.st_size >= ( off_t ) sizeof( Switch_t ) ) )
+				{
+					break;
+				}
+
+				usleep( 1000 );
+			}
+		}
+
+		pxMapped = ( Switch_t * ) mmap( NULL, sizeof( Switch_t ), PROT_READ | PROT_WRITE, MAP_SHARED, iHandle, 0 );
+		close( iHandle );
+
+		if( pxMapped == ( Switch_t * ) MAP_FAILED )
+		{
+			pxMapped = NULL;
+		}
+	}
+
+	if( ( pxMapped != NULL ) && ( xCreated != pdFALSE ) )
+	{
+		/* The lock is robust so that a node that exits while holding it does
+		not stop the others. */
+		pthread_mutexattr_init( &xMutexAttributes );
+		pthread_mutexattr_setpshared( &xMutexAttributes, PTHREAD_PROCESS_SHARED );
+		pthread_mutexattr_setrobust( &xMutexAttributes, PTHREAD_MUTEX_ROBUST );
+		pthread_mutex_init( &( pxMapped->xMutex ), &xMutexAttributes );
+		pthread_mutexattr_destroy( &xMutexAttributes );
+
+		__atomic_store_n( &( pxMapped->ulMagic ), vswitchMAGIC, __ATOMIC_RELEASE );
+	}
+	else if( pxMapped != NULL )
+	{
+		/* Wait for the node that created the switch to initialise it. */
+		for( xAttempts = 0; xAttempts < 1000; xAttempts++ )
+		{
+			if( __atomic_load_n( &( pxMapped->ulMagic ), __ATOMIC_ACQUIRE ) == vswitchMAGIC )
+			{
+				break;
+			}
+
+			usleep( 1000 );
+		}
+
+		if( pxMapped->ulMagic != vswitchMAGIC )
+		{
+			munmap( pxMapped, sizeof( Switch_t ) );
+			pxMapped = NULL;
+		}
+	}
+
+	return pxMapped;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAttachPort( Switch_t *pxOpenedSwitch )
+{
+BaseType_t xPortNumber;
+SwitchPort_t *pxCandidate;
+pthread_condattr_t xCondAttributes;
+
+	taskENTER_CRITICAL();
+	prvLockSwitch();
+	{
+		for( xPortNumber = 0; xPortNumber < vswitchMAX_PORTS; xPortNumber++ )
+		{
+			pxCandidate = &( pxOpenedSwitch->xPorts[ xPortNumber ] );
+
+			if( prvPortInUse( pxCandidate ) == pdFALSE )
+			{
+				pxCandidate->xInUse = pdTRUE;
+				pxCandidate->xOwner = getpid();
+				memcpy( pxCandidate->ucMACAddress, FreeRTOS_GetMACAddress(), ipMAC_ADDRESS_LENGTH_BYTES );
+				pxCandidate->xLink = xLink;
+				pxCandidate->ullLinkFreeAt = 0ULL;
+				memset( &( pxCandidate->xStats ), 0, sizeof( pxCandidate->xStats ) );
+				pxCandidate->ulHead = 0UL;
+				pxCandidate->ulTail = 0UL;
+
+				/* Only the owner of a port waits on its condition, so it can
+				be initialised again here, which discards any waiter left
+				behind by a node that exited while it was waiting. */
+				pthread_condattr_init( &xCondAttributes );
+				pthread_condattr_setpshared( &xCondAttributes, PTHREAD_PROCESS_SHARED );
+				pthread_condattr_setclock( &xCondAttributes, CLOCK_MONOTONIC );
+				pthread_cond_init( &( pxCandidate->xFrameAvailable ), &xCondAttributes );
+				pthread_condattr_destroy( &xCondAttributes );
+
+				/* Each port has its own loss sequence, so the frames a node
+				loses do not depend on the traffic of the other nodes.  The
+				xorshift state must not be zero. */
+				pxCandidate->ulRandom = ( ( uint32_t ) configVSWITCH_SEED * 2654435761UL ) ^ ( uint32_t ) ( xPortNumber + 1 );
+
+				if( pxCandidate->ulRandom == 0UL )
+				{
+					pxCandidate->ulRandom = 1UL;
+				}
+
+				pxPort = pxCandidate;
+				break;
+			}
+		}
+	}
+	prvUnlockSwitch();
+	taskEXIT_CRITICAL();
+
+	if( pxPort != NULL )
+	{
+		atexit( prvDetachPort );
+	}
+
+	return ( pxPort != NULL ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDetachPort( void )
+{
+	if( pxPort != NULL )
+	{
+		prvLockSwitch();
+		pxPort->xInUse = pdFALSE;
+		prvUnlockSwitch();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvPortInUse( SwitchPort_t *pxCandidate )
+{
+	if( ( pxCandidate->xInUse != pdFALSE ) && ( kill( pxCandidate->xOwner, 0 ) != 0 ) && ( errno == ESRCH ) )
+	{
+		pxCandidate->xInUse = pdFALSE;
+	}
+
+	return pxCandidate->xInUse;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLockSwitch( void )
+{
+	if( pthread_mutex_lock( &( pxSwitch->xMutex ) ) == EOWNERDEAD )
+	{
+		/* The previous holder exited.  The switch state is only changed in
+		ways that leave it consistent, so it can be used as it is. */
+		pthread_mutex_consistent( &( pxSwitch->xMutex ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlockSwitch( void )
+{
+	pthread_mutex_unlock( &( pxSwitch->xMutex ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueFrame( SwitchPort_t *pxDestination, const uint8_t *pucFrame, size_t xLength, uint64_t ullDeliverAt )
+{
+SwitchFrame_t *pxFrame;
+
+	if( ( pxDestination->ulTail - pxDestination->ulHead ) >= vswitchQUEUE_LENGTH )
+	{
+		pxDestination->xStats.ulFramesDropped++;
+	}
+	else
+	{
+		pxFrame = &( pxDestination->xFrames[ pxDestination->ulTail % vswitchQUEUE_LENGTH ] );
+		pxFrame->ullDeliverAt = ullDeliverAt;
+		pxFrame->ulLength = ( uint32_t ) xLength;
+		memcpy( pxFrame->ucFrame, pucFrame, xLength );
+		pxDestination->ulTail++;
+
+		pthread_cond_signal( &( pxDestination->xFrameAvailable ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvReceiveThread( void *pvParameters )
+{
+SwitchFrame_t *pxFrame;
+struct timespec xDeliverAt;
+BaseType_t xRaise;
+
+	/* THIS IS A HOST THREAD - DO NOT ATTEMPT ANY FREERTOS CALLS OTHER THAN
+	vPortGenerateSimulatedInterrupt(). */
+
+	( void ) pvParameters;
+
+	prvLockSwitch();
+
+	for( ;; )
+	{
+		xRaise = pdFALSE;
+
+		if( ( xInterruptRaised != pdFALSE ) || ( pxPort->ulHead == pxPort->ulTail ) )
+		{
+			/* Wait for a new frame, or for the receive task to finish. */
+			if( pthread_cond_wait( &( pxPort->xFrameAvailable ), &( pxSwitch->xMutex ) ) == EOWNERDEAD )
+			{
+				pthread_mutex_consistent( &( pxSwitch->xMutex ) );
+			}
+		}
+		else
+		{
+			pxFrame = &( pxPort->xFrames[ pxPort->ulHead % vswitchQUEUE_LENGTH ] );
+
+			if( pxFrame->ullDeliverAt > prvNow() )
+			{
+				/* Wait until the frame arrives. */
+				xDeliverAt.tv_sec = ( time_t ) ( pxFrame->ullDeliverAt / vswitchNS_PER_SECOND );
+				xDeliverAt.tv_nsec = ( long ) ( pxFrame->ullDeliverAt % vswitchNS_PER_SECOND );
+
+				if( pthread_cond_timedwait( &( pxPort->xFrameAvailable ), &( pxSwitch->xMutex ), &xDeliverAt ) == EOWNERDEAD )
+				{
+					pthread_mutex_consistent( &( pxSwitch->xMutex ) );
+				}
+			}
+			else
+			{
+				xInterruptRaised = pdTRUE;
+				xRaise = pdTRUE;
+			}
+		}
+
+		if( xRaise != pdFALSE )
+		{
+			prvUnlockSwitch();
+			vPortGenerateSimulatedInterrupt( configVSWITCH_INTERRUPT );
+			prvLockSwitch();
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvReceiveInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	vTaskNotifyGiveFromISR( xReceiveTaskHandle, &xHigherPriorityTaskWoken );
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReceiveTask( void *pvParameters )
+{
+static uint8_t ucFrame[ vswitchMAX_FRAME_SIZE ];
+SwitchFrame_t *pxFrame;
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
+size_t xLength;
+#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	NetworkBufferDescriptor_t *pxFirstBuffer = NULL, *pxLastBuffer = NULL;
+	UBaseType_t uxChainLength = 0u;
+#endif
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		do
+		{
+			xLength = 0;
+
+			/* Take the next due frame, or tell the receive thread to wait for
+			the next one if there are none. */
+			taskENTER_CRITICAL();
+			prvLockSwitch();
+			{
+				pxFrame = &( pxPort->xFrames[ pxPort->ulHead % vswitchQUEUE_LENGTH ] );
+
+				if( ( pxPort->ulHead != pxPort->ulTail ) && ( pxFrame->ullDeliverAt <= prvNow() ) )
+				{
+					xLength = ( size_t ) pxFrame->ulLength;
+					memcpy( ucFrame, pxFrame->ucFrame, xLength );
+					pxPort->ulHead++;
+					pxPort->xStats.ulFramesReceived++;
+				}
+				else
+				{
+					xInterruptRaised = pdFALSE;
+					pthread_cond_signal( &( pxPort->xFrameAvailable ) );
+				}
+			}
+			prvUnlockSwitch();
+			taskEXIT_CRITICAL();
+
+			iptraceNETWORK_INTERFACE_RECEIVE();
+
+			if( ( xLength >= sizeof( EthernetHeader_t ) ) && ( ipCONSIDER_FRAME_FOR_PROCESSING( ucFrame ) == eProcessBuffer ) )
+			{
+				pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xLength, 0 );
+
+				if( pxNetworkBuffer != NULL )
+				{
+					memcpy( pxNetworkBuffer->pucEthernetBuffer, ucFrame, xLength );
+					pxNetworkBuffer->xDataLength = xLength;
+
+					#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+					{
+						/* Add the buffer to the chain of received frames,
+						which is passed to the IP task in one message. */
+						pxNetworkBuffer->pxNextBuffer = NULL;
+
+						if( pxFirstBuffer == NULL )
+						{
+							pxFirstBuffer = pxNetworkBuffer;
+						}
+						else
+						{
+							pxLastBuffer->pxNextBuffer = pxNetworkBuffer;
+						}
+
+						pxLastBuffer = pxNetworkBuffer;
+						uxChainLength++;
+					}
+					#else
+					{
+						xRxEvent.pvData = ( void * ) pxNetworkBuffer;
+
+						if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+						{
+							vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+							iptraceETHERNET_RX_EVENT_LOST();
+						}
+					}
+					#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+				}
+				else
+				{
+					iptraceETHERNET_RX_EVENT_LOST();
+				}
+			}
+
+			#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+			{
+				/* Pass the chain to the IP task once no more frames are due,
+				or once it holds as many frames as the IP task processes in
+				one batch. */
+				if( ( pxFirstBuffer != NULL ) &&
+					( ( xLength == 0 ) || ( uxChainLength >= ( UBaseType_t ) ipconfigRX_BATCH_SIZE ) ) )
+				{
+					xRxEvent.pvData = ( void * ) pxFirstBuffer;
+
+					if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+					{
+						/* The chain could not be sent to the stack so all its
+						buffers must be released again. */
+						while( pxFirstBuffer != NULL )
+						{
+							pxNetworkBuffer = pxFirstBuffer;
+							pxFirstBuffer = pxFirstBuffer->pxNextBuffer;
+							vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+							iptraceETHERNET_RX_EVENT_LOST();
+						}
+					}
+
+					pxFirstBuffer = NULL;
+					pxLastBuffer = NULL;
+					uxChainLength = 0u;
+				}
+			}
+			#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+		} while( xLength != 0 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNow( void )
+{
+struct timespec xTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &xTime );
+
+	return ( ( uint64_t ) xTime.tv_sec * vswitchNS_PER_SECOND ) + ( uint64_t ) xTime.tv_nsec;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,74 @@
+/*
+FreeRTOS+TCP V2.0.7
+Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ http://aws.amazon.com/freertos
+ http://www.FreeRTOS.org
+*/
+
+#ifndef VIRTUAL_SWITCH_H
+#define VIRTUAL_SWITCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Control interface of the virtual switch network driver, which connects
+ * FreeRTOS+TCP nodes running under the POSIX simulator port.  Each node is a
+ * separate host process, and all the processes that use the same
+ * configVSWITCH_NAME are connected to the same switch.
+ */
+
+/* The characteristics of the link from this node to the switch.  They are
+applied to every frame this node sends. */
+typedef struct xVIRTUAL_SWITCH_LINK
+{
+	uint32_t ulLatencyUs;		/* Added to the delivery time of every frame. */
+	uint32_t ulLossPerMillion;	/* Frames lost for every million sent. */
+	uint64_t ullBandwidthBps;	/* Link speed in bits per second, or 0 for unlimited. */
+} VirtualSwitchLink_t;
+
+/* Frame counters for this node's port on the switch. */
+typedef struct xVIRTUAL_SWITCH_STATS
+{
+	uint32_t ulFramesSent;		/* Frames sent by this node. */
+	uint32_t ulFramesReceived;	/* Frames that arrived at this node. */
+	uint32_t ulFramesLost;		/* Frames sent by this node that the link lost. */
+	uint32_t ulFramesDropped;	/* Frames for this node dropped because its receive queue was full. */
+} VirtualSwitchStats_t;
+
+/*
+ * Change the link characteristics of this node.  Can be called before or after
+ * the network is started.  Frames already in flight are not affected.
+ */
+BaseType_t xVirtualSwitchSetLink( const VirtualSwitchLink_t *pxLink );
+
+/*
+ * Read the frame counters of this node.  Returns pdFAIL if the node is not yet
+ * connected to the switch.
+ */
+BaseType_t xVirtualSwitchGetStats( VirtualSwitchStats_t *pxStats );
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* VIRTUAL_SWITCH_H */
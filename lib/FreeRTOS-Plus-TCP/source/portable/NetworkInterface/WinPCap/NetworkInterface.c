@@ -506,6 +506,10 @@ uint8_t ucRecvBuffer[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
 NetworkBufferDescriptor_t *pxNetworkBuffer;
 IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
 eFrameProcessingResult_t eResult;
+#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	NetworkBufferDescriptor_t *pxFirstBuffer = NULL, *pxLastBuffer = NULL;
+	UBaseType_t uxChainLength = 0u;
+#endif
 
 	/* Remove compiler warnings about unused parameters. */
 	( void ) pvParameters;
@@ -559,6 +563,23 @@ eFrameProcessingResult_t eResult;
 
 						if( pxNetworkBuffer != NULL )
 						{
+						#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+							/* Add the buffer to the chain of received frames,
+							which is passed to the IP task in one message. */
+							pxNetworkBuffer->pxNextBuffer = NULL;
+
+							if( pxFirstBuffer == NULL )
+							{
+								pxFirstBuffer = pxNetworkBuffer;
+							}
+							else
+							{
+								pxLastBuffer->pxNextBuffer = pxNetworkBuffer;
+							}
+
+							pxLastBuffer = pxNetworkBuffer;
+							uxChainLength++;
+						#else
 							xRxEvent.pvData = ( void * ) pxNetworkBuffer;
 
 							/* Data was received and stored.  Send a message to
@@ -575,6 +596,7 @@ eFrameProcessingResult_t eResult;
 								vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
 								iptraceETHERNET_RX_EVENT_LOST();
 							}
+						#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
 						}
 						else
 						{
@@ -594,6 +616,37 @@ eFrameProcessingResult_t eResult;
 					process. */
 				}
 			}
+
+			#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+			{
+				/* Pass the chain to the IP task once no more frames are
+				waiting, or once it holds as many frames as the IP task
+				processes in one batch. */
+				if( ( pxFirstBuffer != NULL ) &&
+					( ( uxStreamBufferGetSize( xRecvBuffer ) <= sizeof( xHeader ) ) ||
+					  ( uxChainLength >= ( UBaseType_t ) ipconfigRX_BATCH_SIZE ) ) )
+				{
+					xRxEvent.pvData = ( void * ) pxFirstBuffer;
+
+					if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+					{
+						/* The chain could not be sent to the stack so all its
+						buffers must be released again. */
+						while( pxFirstBuffer != NULL )
+						{
+							pxNetworkBuffer = pxFirstBuffer;
+							pxFirstBuffer = pxFirstBuffer->pxNextBuffer;
+							vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+							iptraceETHERNET_RX_EVENT_LOST();
+						}
+					}
+
+					pxFirstBuffer = NULL;
+					pxLastBuffer = NULL;
+					uxChainLength = 0u;
+				}
+			}
+			#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
 		}
 		else
 		{
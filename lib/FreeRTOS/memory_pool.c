@@ -0,0 +1,510 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "memory_pool.h"
+
+#if( configUSE_COUNTING_SEMAPHORES != 1 )
+	#error configUSE_COUNTING_SEMAPHORES must be set to 1 to build memory_pool.c
+#endif
+
+/* Lint e961 and e750 are suppressed as a MISRA exception justified because the
+MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined for the
+header files above, but not in this file, in order to generate the correct
+privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750. */
+
+/* Bits that can be set in ucFlags. */
+#define mpFLAGS_IS_STATICALLY_ALLOCATED		( ( uint8_t ) 1 ) /* Set if the pool structure was allocated statically. */
+
+/* Structure that holds state information on the memory pool. */
+typedef struct xMEMORY_POOL /*lint --e{9058} Structure is used in the static structure definition. */
+{
+	void * volatile pvFreeList;						/* The first free block.  Each free block holds a pointer to the next. */
+	uint8_t *pucStorage;							/* The storage the blocks are allocated from. */
+	size_t xBlockSize;								/* The size of each block, rounded up by poolBLOCK_SIZE(). */
+	UBaseType_t uxBlockCount;						/* The number of blocks in the pool. */
+	volatile UBaseType_t uxFreeBlocks;				/* The number of blocks on the free list. */
+	volatile UBaseType_t uxMinimumEverFreeBlocks;	/* The smallest value uxFreeBlocks has had. */
+	volatile UBaseType_t uxWaitingTasks;			/* The number of tasks blocked waiting for a block. */
+	SemaphoreHandle_t xWaitSemaphore;				/* Given when a block is freed while tasks are waiting. */
+	uint8_t ucFlags;
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		StaticSemaphore_t xWaitSemaphoreBuffer;		/* Holds xWaitSemaphore, so creating a pool only needs one allocation. */
+	#endif
+} MemoryPool_t;
+
+/*
+ * Initialises the pool structure and threads all the blocks onto the free
+ * list.  Returns pdFAIL if the semaphore used to block waiting tasks could not
+ * be created.
+ */
+static BaseType_t prvInitialiseNewMemoryPool( MemoryPool_t * const pxMemoryPool,
+											  uint8_t * const pucStorage,
+											  size_t xBlockSize,
+											  UBaseType_t uxBlockCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a block from the free list, returning NULL if the list is empty.
+ * Must be called from a critical section.
+ */
+static void *prvPopBlock( MemoryPool_t * const pxMemoryPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns a block to the free list.  Must be called from a critical section.
+ * Returns pdTRUE if a task is waiting for the block.
+ */
+static BaseType_t prvPushBlock( MemoryPool_t * const pxMemoryPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	MemoryPoolHandle_t xMemoryPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount )
+	{
+	MemoryPool_t *pxMemoryPool;
+	size_t xHeaderSize, xStorageSize;
+
+		configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+
+		/* The blocks follow the pool structure in the same allocation, so the
+		structure is padded to keep the first block aligned. */
+		xHeaderSize = ( sizeof( MemoryPool_t ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xStorageSize = poolSTORAGE_SIZE( xBlockSize, uxBlockCount );
+
+		pxMemoryPool = ( MemoryPool_t * ) pvPortMalloc( xHeaderSize + xStorageSize ); /*lint !e9079 malloc() only returns void*. */
+
+		if( pxMemoryPool != NULL )
+		{
+			if( prvInitialiseNewMemoryPool( pxMemoryPool,
+											( ( uint8_t * ) pxMemoryPool ) + xHeaderSize, /*lint !e9016 Indexing past structure valid for uint8_t pointer into the same allocation. */
+											xBlockSize,
+											uxBlockCount ) != pdFAIL )
+			{
+				traceMEMORY_POOL_CREATE( pxMemoryPool );
+			}
+			else
+			{
+				vPortFree( ( void * ) pxMemoryPool );
+				pxMemoryPool = NULL;
+				traceMEMORY_POOL_CREATE_FAILED();
+			}
+		}
+		else
+		{
+			traceMEMORY_POOL_CREATE_FAILED();
+		}
+
+		return ( MemoryPoolHandle_t ) pxMemoryPool;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	MemoryPoolHandle_t xMemoryPoolCreateStatic( size_t xBlockSize,
+												UBaseType_t uxBlockCount,
+												uint8_t * const pucPoolStorage,
+												StaticMemoryPool_t * const pxStaticMemoryPool )
+	{
+	MemoryPool_t * const pxMemoryPool = ( MemoryPool_t * ) pxStaticMemoryPool;
+	MemoryPoolHandle_t xReturn;
+
+		configASSERT( pucPoolStorage );
+		configASSERT( pxStaticMemoryPool );
+		configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+
+		/* Blocks are returned to the application, so must be aligned in case
+		they hold types that require it. */
+		configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucPoolStorage ) & ( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) == 0UL );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticMemoryPool_t equals the size of the real
+			memory pool structure. */
+			volatile size_t xSize = sizeof( StaticMemoryPool_t );
+			configASSERT( xSize == sizeof( MemoryPool_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucPoolStorage != NULL ) && ( pxStaticMemoryPool != NULL ) )
+		{
+			/* Creating the semaphore cannot fail when its buffer is provided. */
+			( void ) prvInitialiseNewMemoryPool( pxMemoryPool, pucPoolStorage, xBlockSize, uxBlockCount );
+
+			/* Remember this was statically allocated in case it is ever
+			deleted. */
+			pxMemoryPool->ucFlags |= mpFLAGS_IS_STATICALLY_ALLOCATED;
+
+			traceMEMORY_POOL_CREATE( pxMemoryPool );
+
+			xReturn = ( MemoryPoolHandle_t ) pxStaticMemoryPool;
+		}
+		else
+		{
+			xReturn = NULL;
+			traceMEMORY_POOL_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+void vMemoryPoolDelete( MemoryPoolHandle_t xMemoryPool )
+{
+MemoryPool_t * pxMemoryPool = ( MemoryPool_t * ) xMemoryPool;
+
+	configASSERT( pxMemoryPool );
+	configASSERT( pxMemoryPool->uxWaitingTasks == ( UBaseType_t ) 0 );
+
+	traceMEMORY_POOL_DELETE( xMemoryPool );
+
+	/* Only frees the semaphore if it was not created inside the structure. */
+	vSemaphoreDelete( pxMemoryPool->xWaitSemaphore );
+
+	if( ( pxMemoryPool->ucFlags & mpFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			/* Both the structure and the blocks were allocated in a single
+			call to pvPortMalloc(), hence only one call to vPortFree() is
+			required. */
+			vPortFree( ( void * ) pxMemoryPool ); /*lint !e9087 Standard free() semantics require void *, plus pxMemoryPool was allocated by pvPortMalloc(). */
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xMemoryPool == ( MemoryPoolHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure and blocks were not allocated dynamically and cannot
+		be freed - just scrub the structure so future use will assert. */
+		memset( pxMemoryPool, 0x00, sizeof( MemoryPool_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void *pvMemoryPoolAlloc( MemoryPoolHandle_t xMemoryPool, TickType_t xTicksToWait )
+{
+MemoryPool_t * const pxMemoryPool = ( MemoryPool_t * ) xMemoryPool;
+void *pvReturn;
+BaseType_t xWaiting = pdFALSE, xEntryTimeSet = pdFALSE;
+TimeOut_t xTimeOut;
+
+	configASSERT( pxMemoryPool );
+
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	/* The free list is only held in a critical section for the few
+	instructions needed to pop a block.  The semaphore is only used to block
+	while the pool is empty, so it does not add to the cost of an allocation
+	that succeeds straight away. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			if( xWaiting != pdFALSE )
+			{
+				( pxMemoryPool->uxWaitingTasks )--;
+				xWaiting = pdFALSE;
+			}
+
+			pvReturn = prvPopBlock( pxMemoryPool );
+
+			if( pvReturn != NULL )
+			{
+				traceMEMORY_POOL_ALLOC( xMemoryPool, pvReturn, pxMemoryPool->uxFreeBlocks );
+			}
+			else if( xTicksToWait == ( TickType_t ) 0 )
+			{
+				traceMEMORY_POOL_ALLOC_FAILED( xMemoryPool );
+			}
+			else
+			{
+				/* Registering as a waiter in the same critical section as
+				finding the pool empty means a block freed before this task
+				blocks still gives the semaphore, so cannot be missed. */
+				( pxMemoryPool->uxWaitingTasks )++;
+				xWaiting = pdTRUE;
+				traceBLOCKING_ON_MEMORY_POOL_ALLOC( xMemoryPool );
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xWaiting == pdFALSE )
+		{
+			break;
+		}
+
+		if( xEntryTimeSet == pdFALSE )
+		{
+			vTaskSetTimeOutState( &xTimeOut );
+			xEntryTimeSet = pdTRUE;
+		}
+
+		/* Another task may take the freed block before this task runs, and the
+		semaphore may have been given for a block that has already gone, so
+		the free list is always checked again rather than assuming a block is
+		available. */
+		( void ) xSemaphoreTake( pxMemoryPool->xWaitSemaphore, xTicksToWait );
+
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+		{
+			/* Timed out.  Make one last attempt without blocking. */
+			xTicksToWait = ( TickType_t ) 0;
+		}
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void *pvMemoryPoolAllocFromISR( MemoryPoolHandle_t xMemoryPool )
+{
+MemoryPool_t * const pxMemoryPool = ( MemoryPool_t * ) xMemoryPool;
+void *pvReturn;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxMemoryPool );
+
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		pvReturn = prvPopBlock( pxMemoryPool );
+
+		if( pvReturn != NULL )
+		{
+			traceMEMORY_POOL_ALLOC_FROM_ISR( xMemoryPool, pvReturn, pxMemoryPool->uxFreeBlocks );
+		}
+		else
+		{
+			traceMEMORY_POOL_ALLOC_FROM_ISR_FAILED( xMemoryPool );
+		}
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vMemoryPoolFree( MemoryPoolHandle_t xMemoryPool, void *pvBlock )
+{
+MemoryPool_t * const pxMemoryPool = ( MemoryPool_t * ) xMemoryPool;
+BaseType_t xTaskWaiting;
+
+	configASSERT( pxMemoryPool );
+
+	taskENTER_CRITICAL();
+	{
+		xTaskWaiting = prvPushBlock( pxMemoryPool, pvBlock );
+		traceMEMORY_POOL_FREE( xMemoryPool, pvBlock, pxMemoryPool->uxFreeBlocks );
+	}
+	taskEXIT_CRITICAL();
+
+	if( xTaskWaiting != pdFALSE )
+	{
+		/* The counting semaphore can hold gives left over from blocks that a
+		waiting task found on the free list without taking the semaphore, for
+		example after its take timed out.  The give only fails once those have
+		raised the count to uxBlockCount, in which case the next take returns
+		at once and the waiting task finds this block on the free list. */
+		( void ) xSemaphoreGive( pxMemoryPool->xWaitSemaphore );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vMemoryPoolFreeFromISR( MemoryPoolHandle_t xMemoryPool,
+							 void *pvBlock,
+							 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+MemoryPool_t * const pxMemoryPool = ( MemoryPool_t * ) xMemoryPool;
+BaseType_t xTaskWaiting;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxMemoryPool );
+
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		xTaskWaiting = prvPushBlock( pxMemoryPool, pvBlock );
+		traceMEMORY_POOL_FREE_FROM_ISR( xMemoryPool, pvBlock, pxMemoryPool->uxFreeBlocks );
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	if( xTaskWaiting != pdFALSE )
+	{
+		( void ) xSemaphoreGiveFromISR( pxMemoryPool->xWaitSemaphore, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMemoryPoolGetFreeBlocks( MemoryPoolHandle_t xMemoryPool )
+{
+MemoryPool_t * const pxMemoryPool = ( MemoryPool_t * ) xMemoryPool;
+
+	configASSERT( pxMemoryPool );
+
+	return pxMemoryPool->uxFreeBlocks;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMemoryPoolGetMinimumEverFreeBlocks( MemoryPoolHandle_t xMemoryPool )
+{
+MemoryPool_t * const pxMemoryPool = ( MemoryPool_t * ) xMemoryPool;
+
+	configASSERT( pxMemoryPool );
+
+	return pxMemoryPool->uxMinimumEverFreeBlocks;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvPopBlock( MemoryPool_t * const pxMemoryPool )
+{
+void *pvBlock = pxMemoryPool->pvFreeList;
+
+	if( pvBlock != NULL )
+	{
+		pxMemoryPool->pvFreeList = *( ( void ** ) pvBlock );
+		( pxMemoryPool->uxFreeBlocks )--;
+
+		if( pxMemoryPool->uxFreeBlocks < pxMemoryPool->uxMinimumEverFreeBlocks )
+		{
+			pxMemoryPool->uxMinimumEverFreeBlocks = pxMemoryPool->uxFreeBlocks;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvPushBlock( MemoryPool_t * const pxMemoryPool, void *pvBlock )
+{
+	/* The block must be one that was allocated from this pool. */
+	configASSERT( ( ( uint8_t * ) pvBlock >= pxMemoryPool->pucStorage ) &&
+				  ( ( uint8_t * ) pvBlock < ( pxMemoryPool->pucStorage + ( pxMemoryPool->xBlockSize * ( size_t ) pxMemoryPool->uxBlockCount ) ) ) );
+	configASSERT( ( ( size_t ) ( ( uint8_t * ) pvBlock - pxMemoryPool->pucStorage ) % pxMemoryPool->xBlockSize ) == ( size_t ) 0 );
+	configASSERT( pxMemoryPool->uxFreeBlocks < pxMemoryPool->uxBlockCount );
+
+	*( ( void ** ) pvBlock ) = pxMemoryPool->pvFreeList;
+	pxMemoryPool->pvFreeList = pvBlock;
+	( pxMemoryPool->uxFreeBlocks )++;
+
+	return ( pxMemoryPool->uxWaitingTasks > ( UBaseType_t ) 0 ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInitialiseNewMemoryPool( MemoryPool_t * const pxMemoryPool,
+											  uint8_t * const pucStorage,
+											  size_t xBlockSize,
+											  UBaseType_t uxBlockCount )
+{
+UBaseType_t uxBlock;
+uint8_t *pucBlock;
+BaseType_t xReturn;
+
+	memset( ( void * ) pxMemoryPool, 0x00, sizeof( MemoryPool_t ) ); /*lint !e9087 memset() requires void *. */
+	pxMemoryPool->pucStorage = pucStorage;
+	pxMemoryPool->xBlockSize = poolBLOCK_SIZE( xBlockSize );
+	pxMemoryPool->uxBlockCount = uxBlockCount;
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	{
+		pxMemoryPool->xWaitSemaphore = xSemaphoreCreateCountingStatic( uxBlockCount, ( UBaseType_t ) 0, &( pxMemoryPool->xWaitSemaphoreBuffer ) );
+	}
+	#else
+	{
+		pxMemoryPool->xWaitSemaphore = xSemaphoreCreateCounting( uxBlockCount, ( UBaseType_t ) 0 );
+	}
+	#endif
+
+	if( pxMemoryPool->xWaitSemaphore != NULL )
+	{
+		/* Thread the blocks onto the free list in address order, so the first
+		block allocated is the first block of the storage. */
+		pucBlock = pucStorage + ( pxMemoryPool->xBlockSize * ( size_t ) uxBlockCount );
+
+		for( uxBlock = 0; uxBlock < uxBlockCount; uxBlock++ )
+		{
+			pucBlock -= pxMemoryPool->xBlockSize;
+			*( ( void ** ) pucBlock ) = pxMemoryPool->pvFreeList; /*lint !e9087 !e826 The block is aligned for a pointer. */
+			pxMemoryPool->pvFreeList = ( void * ) pucBlock;
+		}
+
+		pxMemoryPool->uxFreeBlocks = uxBlockCount;
+		pxMemoryPool->uxMinimumEverFreeBlocks = uxBlockCount;
+		xReturn = pdPASS;
+	}
+	else
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,939 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A port that runs FreeRTOS as a Linux (or other POSIX) process, so that the
+ * kernel, the TCP/IP stack and the libraries above them can be run and
+ * benchmarked on a host.
+ *
+ * Each task runs in its own pthread, but only one of those threads is allowed
+ * to run at a time: the others wait on a per-thread event until the scheduler
+ * selects them.  The tick is generated by an interval timer (SIGALRM) and
+ * other simulated interrupts by SIGUSR1.  Only the running thread has those
+ * signals unblocked, so the signal handlers always execute in the context of
+ * the running task, as an interrupt would on real hardware, and can switch
+ * context by resuming another thread and then waiting for their own turn.
+ *
+ * A task can be switched out while it holds a host library lock, for example
+ * inside printf() or malloc(), so tasks that call such functions must not be
+ * allowed to block each other on them from inside a critical section.
+ *
+ * When configNUM_CORES is greater than 1 one thread runs per simulated core,
+ * and the tick and other simulated interrupts are taken by whichever of those
+ * threads has the signals unblocked.  A core is made to reschedule by sending
+ * SIGUSR2 to the thread it is running.
+ */
+
+/* Standard includes. */
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define portMAX_INTERRUPTS				( ( uint32_t ) sizeof( uint32_t ) * 8UL ) /* The number of bits in an uint32_t. */
+#define portNO_CRITICAL_NESTING 		( ( uint32_t ) 0 )
+
+/* The signals used to deliver the tick and the other simulated interrupts. */
+#define portTICK_SIGNAL					SIGALRM
+#define portINTERRUPT_SIGNAL			SIGUSR1
+#define portYIELD_CORE_SIGNAL			SIGUSR2
+
+/* The owner of a kernel lock that is not held. */
+#define portLOCK_FREE					( ( BaseType_t ) -1 )
+
+/*-----------------------------------------------------------*/
+
+/* The task stack is only used to hold a Thread_t structure, which maps the task
+to the thread that runs it.  The thread has its own stack. */
+typedef struct THREAD
+{
+	pthread_t xThread;
+
+	/* Event on which the thread waits while it is not the running thread. */
+	pthread_mutex_t xEventMutex;
+	pthread_cond_t xEventCond;
+	BaseType_t xEventSet;
+
+	/* Set when the task has been deleted, so the thread must exit rather than
+	run again. */
+	volatile BaseType_t xDying;
+
+	/* Set when the task deleted itself, in which case nothing waits for the
+	thread to exit. */
+	BaseType_t xDetached;
+
+	TaskFunction_t pxCode;
+	void *pvParameters;
+
+	#if( configNUM_CORES > 1 )
+		/* The core the thread runs on, set by the core that resumes it. */
+		volatile BaseType_t xCoreID;
+	#endif
+} Thread_t;
+
+#if( configNUM_CORES > 1 )
+
+	/* A recursive spinlock, held by one core at a time. */
+	typedef struct LOCK
+	{
+		volatile BaseType_t xOwner;
+		UBaseType_t uxCount;
+	} Lock_t;
+
+#endif
+
+/*
+ * Wait for the scheduler to select the calling thread, then run its task.
+ */
+static void *prvThreadEntry( void *pvParameters );
+
+#if( configNUM_CORES == 1 )
+
+	/*
+	 * Let another thread run, then wait until the calling thread is selected
+	 * again.
+	 */
+	static void prvSwitchThread( Thread_t *pxThreadToResume, Thread_t *pxThreadToSuspend );
+
+#endif
+static void prvResumeThread( Thread_t *pxThread );
+static void prvSuspendSelf( Thread_t *pxThread );
+
+/*
+ * Select the next task to run, and switch to its thread if it is not the
+ * running one.
+ */
+static void prvSwitchContext( void );
+
+/*
+ * Signal handlers for the tick and the other simulated interrupts.
+ */
+static void prvTickSignalHandler( int iSignal );
+static void prvInterruptSignalHandler( int iSignal );
+
+#if( configNUM_CORES > 1 )
+
+	/*
+	 * Signal handler for a request from another core to reschedule.
+	 */
+	static void prvYieldCoreSignalHandler( int iSignal );
+
+	/*
+	 * Take and give the kernel locks.
+	 */
+	static void prvGetLock( Lock_t *pxLock );
+	static void prvReleaseLock( Lock_t *pxLock );
+
+#endif
+
+/*
+ * Interrupt handlers used by the kernel itself.
+ */
+static uint32_t prvProcessYieldInterrupt( void );
+static uint32_t prvProcessTickInterrupt( void );
+
+/*-----------------------------------------------------------*/
+
+/* Maps a TCB to the thread state held in its stack.  The first member of the
+TCB is the top of stack pointer, which pxPortInitialiseStack() pointed at the
+thread state. */
+#define portTHREAD_FROM_TCB( pvTCB ) ( ( Thread_t * ) *( ( StackType_t ** ) ( pvTCB ) ) )
+
+/* The signals that represent interrupts. */
+static sigset_t xInterruptSignals;
+
+/* Simulated interrupts waiting to be processed.  This is a bit mask where each
+bit represents one interrupt, so a maximum of 32 interrupts can be simulated. */
+static volatile uint32_t ulPendingInterrupts = 0UL;
+
+/* Handlers for all the simulated interrupts.  The first two positions are used
+for the Yield and Tick interrupts, all the other interrupts can be user
+defined. */
+static uint32_t (*ulIsrHandler[ portMAX_INTERRUPTS ])( void ) = { 0 };
+
+#if( configNUM_CORES > 1 )
+
+	/* The thread state of the calling thread, which is NULL for threads that
+	do not run a task. */
+	static __thread Thread_t *pxThisThread = NULL;
+
+	/* Whether the calling thread has the interrupt signals blocked, so they
+	are only blocked and unblocked when that changes. */
+	static __thread BaseType_t xInterruptsMasked = pdFALSE;
+
+	/* The cores that have been asked to reschedule by another core. */
+	static volatile BaseType_t xYieldRequests[ configNUM_CORES ] = { 0 };
+
+	/* The kernel locks. */
+	static Lock_t xTaskLock = { portLOCK_FREE, 0 };
+	static Lock_t xISRLock = { portLOCK_FREE, 0 };
+
+	/* Pointers to the TCBs of the tasks running on each core. */
+	extern void * volatile pxCurrentTCBs[];
+
+#else
+
+	/* The critical nesting count for the running task.  Each thread saves and
+	restores it across a context switch.  It is initialised to a non-zero value
+	so interrupts are not enabled before the scheduler starts. */
+	static volatile uint32_t ulCriticalNesting = 9999UL;
+
+	/* Pointer to the TCB of the currently executing task. */
+	extern void *pxCurrentTCB;
+
+#endif
+
+/* Used to ensure nothing is processed during the startup sequence. */
+static volatile BaseType_t xPortRunning = pdFALSE;
+
+/* Used by vPortEndScheduler() to release the thread that started the
+scheduler. */
+static pthread_mutex_t xSchedulerEndMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xSchedulerEndCond = PTHREAD_COND_INITIALIZER;
+static BaseType_t xSchedulerEnded = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+Thread_t *pxThread;
+sigset_t xSavedSignals;
+pthread_attr_t xAttributes;
+int iResult;
+
+	/* In this simulated case a stack is not initialised, but instead a thread
+	is created that will execute the task being created.  The Thread_t object
+	is placed onto the stack that was created for the task - so the stack
+	buffer is still used, just not in the conventional way.  It will not be
+	used for anything other than holding this structure. */
+	pxThread = ( Thread_t * ) ( ( ( uintptr_t ) pxTopOfStack - sizeof( Thread_t ) ) & ~( ( uintptr_t ) portBYTE_ALIGNMENT - 1 ) );
+	memset( pxThread, 0, sizeof( Thread_t ) );
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+	pthread_mutex_init( &pxThread->xEventMutex, NULL );
+	pthread_cond_init( &pxThread->xEventCond, NULL );
+
+	/* The new thread inherits the signal mask of this one, and must not take
+	interrupts until it is selected to run. */
+	pthread_sigmask( SIG_BLOCK, &xInterruptSignals, &xSavedSignals );
+
+	pthread_attr_init( &xAttributes );
+	iResult = pthread_create( &pxThread->xThread, &xAttributes, prvThreadEntry, pxThread );
+	pthread_attr_destroy( &xAttributes );
+	configASSERT( iResult == 0 );
+	( void ) iResult;
+
+	pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+
+	return ( StackType_t * ) pxThread;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvThreadEntry( void *pvParameters )
+{
+Thread_t *pxThread = ( Thread_t * ) pvParameters;
+
+	#if( configNUM_CORES > 1 )
+	{
+		pxThisThread = pxThread;
+		xInterruptsMasked = pdTRUE;
+	}
+	#endif
+
+	prvSuspendSelf( pxThread );
+
+	/* The task starts with interrupts enabled. */
+	#if( configNUM_CORES == 1 )
+	{
+		ulCriticalNesting = portNO_CRITICAL_NESTING;
+	}
+	#endif
+	vPortEnableInterrupts();
+
+	pxThread->pxCode( pxThread->pvParameters );
+
+	/* Tasks must not return from their implementing function. */
+	configASSERT( pdFALSE );
+	vTaskDelete( NULL );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumeThread( Thread_t *pxThread )
+{
+	pthread_mutex_lock( &pxThread->xEventMutex );
+	pxThread->xEventSet = pdTRUE;
+	pthread_cond_signal( &pxThread->xEventCond );
+	pthread_mutex_unlock( &pxThread->xEventMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendSelf( Thread_t *pxThread )
+{
+	pthread_mutex_lock( &pxThread->xEventMutex );
+
+	while( pxThread->xEventSet == pdFALSE )
+	{
+		pthread_cond_wait( &pxThread->xEventCond, &pxThread->xEventMutex );
+	}
+
+	pxThread->xEventSet = pdFALSE;
+	pthread_mutex_unlock( &pxThread->xEventMutex );
+
+	/* A task deleted by another task is woken only to exit. */
+	if( pxThread->xDying != pdFALSE )
+	{
+		pthread_exit( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configNUM_CORES == 1 )
+
+static void prvSwitchThread( Thread_t *pxThreadToResume, Thread_t *pxThreadToSuspend )
+{
+uint32_t ulSavedCriticalNesting;
+BaseType_t xDying;
+
+	if( pxThreadToResume != pxThreadToSuspend )
+	{
+		/* Read everything needed from the suspending thread's state before the
+		resumed thread runs, as it may free that state if the task was
+		deleted. */
+		ulSavedCriticalNesting = ulCriticalNesting;
+		xDying = pxThreadToSuspend->xDying;
+
+		prvResumeThread( pxThreadToResume );
+
+		if( xDying != pdFALSE )
+		{
+			pthread_exit( NULL );
+		}
+
+		prvSuspendSelf( pxThreadToSuspend );
+		ulCriticalNesting = ulSavedCriticalNesting;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchContext( void )
+{
+void *pvOldCurrentTCB = pxCurrentTCB;
+
+	/* Select the next task to run. */
+	vTaskSwitchContext();
+
+	if( pvOldCurrentTCB != pxCurrentTCB )
+	{
+		prvSwitchThread( portTHREAD_FROM_TCB( pxCurrentTCB ), portTHREAD_FROM_TCB( pvOldCurrentTCB ) );
+	}
+}
+
+#else /* configNUM_CORES */
+
+static void prvSwitchContext( void )
+{
+BaseType_t xCoreID = pxThisThread->xCoreID;
+Thread_t *pxOldThread = pxThisThread;
+Thread_t *pxNewThread;
+BaseType_t xDying = pxOldThread->xDying;
+
+	/* Any request to reschedule made before this point is served by this
+	switch. */
+	__atomic_store_n( &xYieldRequests[ xCoreID ], pdFALSE, __ATOMIC_SEQ_CST );
+
+	/* Select the next task to run on this core.  Once this returns the old
+	task can be selected by another core, or freed if it was deleted, so its
+	state is not accessed again. */
+	vTaskSwitchContext( xCoreID );
+	pxNewThread = portTHREAD_FROM_TCB( pxCurrentTCBs[ xCoreID ] );
+
+	if( pxNewThread != pxOldThread )
+	{
+		/* The new thread may not have reached its own suspend point yet if it
+		was switched out by another core, in which case the event is latched
+		and it continues straight away. */
+		pxNewThread->xCoreID = xCoreID;
+		prvResumeThread( pxNewThread );
+
+		if( xDying != pdFALSE )
+		{
+			pthread_exit( NULL );
+		}
+
+		prvSuspendSelf( pxOldThread );
+	}
+}
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+struct sigaction xAction;
+struct itimerval xTimer;
+#if( configNUM_CORES > 1 )
+	BaseType_t xCoreID;
+	Thread_t *pxThread;
+#endif
+
+	/* The thread that starts the scheduler does not run a task, so it never
+	takes interrupts. */
+	pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+
+	/* Install the interrupt handlers used by the scheduler itself. */
+	vPortSetInterruptHandler( portINTERRUPT_YIELD, prvProcessYieldInterrupt );
+	vPortSetInterruptHandler( portINTERRUPT_TICK, prvProcessTickInterrupt );
+
+	/* The handlers run with all the interrupt signals blocked, just as an
+	interrupt runs with interrupts disabled. */
+	memset( &xAction, 0, sizeof( xAction ) );
+	xAction.sa_mask = xInterruptSignals;
+	xAction.sa_flags = SA_RESTART;
+	xAction.sa_handler = prvTickSignalHandler;
+	sigaction( portTICK_SIGNAL, &xAction, NULL );
+	xAction.sa_handler = prvInterruptSignalHandler;
+	sigaction( portINTERRUPT_SIGNAL, &xAction, NULL );
+	#if( configNUM_CORES > 1 )
+	{
+		xAction.sa_handler = prvYieldCoreSignalHandler;
+		sigaction( portYIELD_CORE_SIGNAL, &xAction, NULL );
+	}
+	#endif
+
+	xPortRunning = pdTRUE;
+
+	/* Start the timer that generates the tick. */
+	memset( &xTimer, 0, sizeof( xTimer ) );
+	xTimer.it_interval.tv_usec = ( suseconds_t ) ( 1000000UL / configTICK_RATE_HZ );
+	xTimer.it_value = xTimer.it_interval;
+	setitimer( ITIMER_REAL, &xTimer, NULL );
+
+	/* Start the highest priority task, or one task on each core. */
+	#if( configNUM_CORES > 1 )
+	{
+		for( xCoreID = 0; xCoreID < configNUM_CORES; xCoreID++ )
+		{
+			pxThread = portTHREAD_FROM_TCB( pxCurrentTCBs[ xCoreID ] );
+			pxThread->xCoreID = xCoreID;
+			prvResumeThread( pxThread );
+		}
+	}
+	#else
+	{
+		prvResumeThread( portTHREAD_FROM_TCB( pxCurrentTCB ) );
+	}
+	#endif
+
+	/* Wait until the scheduler is ended. */
+	pthread_mutex_lock( &xSchedulerEndMutex );
+
+	while( xSchedulerEnded == pdFALSE )
+	{
+		pthread_cond_wait( &xSchedulerEndCond, &xSchedulerEndMutex );
+	}
+
+	pthread_mutex_unlock( &xSchedulerEndMutex );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+struct itimerval xTimer;
+#if( configNUM_CORES > 1 )
+	Thread_t *pxThread = pxThisThread;
+	BaseType_t xCoreID;
+#else
+	Thread_t *pxThread = portTHREAD_FROM_TCB( pxCurrentTCB );
+#endif
+
+	/* Stop the tick. */
+	memset( &xTimer, 0, sizeof( xTimer ) );
+	setitimer( ITIMER_REAL, &xTimer, NULL );
+	xPortRunning = pdFALSE;
+
+	/* Let the thread that started the scheduler return from
+	vTaskStartScheduler(). */
+	pthread_mutex_lock( &xSchedulerEndMutex );
+	xSchedulerEnded = pdTRUE;
+	pthread_cond_signal( &xSchedulerEndCond );
+	pthread_mutex_unlock( &xSchedulerEndMutex );
+
+	/* Stop the tasks running on the other cores as soon as they take
+	interrupts. */
+	#if( configNUM_CORES > 1 )
+	{
+		for( xCoreID = 0; xCoreID < configNUM_CORES; xCoreID++ )
+		{
+			if( xCoreID != pxThread->xCoreID )
+			{
+				pthread_kill( portTHREAD_FROM_TCB( pxCurrentTCBs[ xCoreID ] )->xThread, portYIELD_CORE_SIGNAL );
+			}
+		}
+	}
+	#endif
+
+	/* No task runs again. */
+	vPortDisableInterrupts();
+
+	for( ;; )
+	{
+		prvSuspendSelf( pxThread );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+	#if( configNUM_CORES > 1 )
+	{
+		if( xInterruptsMasked == pdFALSE )
+		{
+			pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+			xInterruptsMasked = pdTRUE;
+		}
+	}
+	#else
+	{
+		pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+	#if( configNUM_CORES > 1 )
+	{
+		xInterruptsMasked = pdFALSE;
+	}
+	#endif
+
+	pthread_sigmask( SIG_UNBLOCK, &xInterruptSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+#if( configNUM_CORES > 1 )
+
+	UBaseType_t uxPortSetInterruptMask( void )
+	{
+	UBaseType_t uxWasMasked = ( UBaseType_t ) xInterruptsMasked;
+
+		vPortDisableInterrupts();
+
+		return uxWasMasked;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortClearInterruptMask( UBaseType_t uxSavedInterruptStatus )
+	{
+		if( uxSavedInterruptStatus == ( UBaseType_t ) pdFALSE )
+		{
+			vPortEnableInterrupts();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xPortGetCoreID( void )
+	{
+	BaseType_t xCoreID = 0;
+
+		/* Threads that do not run a task, such as the one that starts the
+		scheduler, report core 0. */
+		if( pxThisThread != NULL )
+		{
+			xCoreID = pxThisThread->xCoreID;
+		}
+
+		return xCoreID;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvGetLock( Lock_t *pxLock )
+	{
+	BaseType_t xCoreID = xPortGetCoreID();
+	BaseType_t xExpected = portLOCK_FREE;
+
+		/* The caller has interrupts masked, so the owner cannot change to or
+		from this core while it is read. */
+		if( pxLock->xOwner != xCoreID )
+		{
+			while( __atomic_compare_exchange_n( &pxLock->xOwner, &xExpected, xCoreID, pdFALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) == pdFALSE )
+			{
+				/* The host may have fewer CPUs than there are cores, so give
+				the owner a chance to run. */
+				xExpected = portLOCK_FREE;
+				sched_yield();
+			}
+		}
+
+		pxLock->uxCount++;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvReleaseLock( Lock_t *pxLock )
+	{
+		configASSERT( pxLock->xOwner == xPortGetCoreID() );
+		configASSERT( pxLock->uxCount > 0 );
+
+		pxLock->uxCount--;
+
+		if( pxLock->uxCount == 0 )
+		{
+			__atomic_store_n( &pxLock->xOwner, portLOCK_FREE, __ATOMIC_RELEASE );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortGetTaskLock( void )
+	{
+		prvGetLock( &xTaskLock );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortReleaseTaskLock( void )
+	{
+		prvReleaseLock( &xTaskLock );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortGetISRLock( void )
+	{
+		prvGetLock( &xISRLock );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortReleaseISRLock( void )
+	{
+		prvReleaseLock( &xISRLock );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortYieldCore( BaseType_t xCoreID )
+	{
+		/* The kernel yields the calling core itself. */
+		configASSERT( xCoreID != xPortGetCoreID() );
+
+		/* The caller holds a kernel lock, so the core cannot switch tasks
+		until the request is made.  If the thread is switched out before it
+		takes the signal, that switch has served the request. */
+		__atomic_store_n( &xYieldRequests[ xCoreID ], pdTRUE, __ATOMIC_SEQ_CST );
+		pthread_kill( portTHREAD_FROM_TCB( pxCurrentTCBs[ xCoreID ] )->xThread, portYIELD_CORE_SIGNAL );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortYield( void )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = uxPortSetInterruptMask();
+		prvSwitchContext();
+		vPortClearInterruptMask( uxSavedInterruptStatus );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvYieldCoreSignalHandler( int iSignal )
+	{
+	BaseType_t xCoreID;
+
+		( void ) iSignal;
+
+		xInterruptsMasked = pdTRUE;
+
+		if( xPortRunning != pdFALSE )
+		{
+			/* A thread holds the signal pending while it is switched out, and
+			may take it after moving to another core, so the request is checked
+			for the core the thread runs on now. */
+			xCoreID = pxThisThread->xCoreID;
+
+			if( __atomic_exchange_n( &xYieldRequests[ xCoreID ], pdFALSE, __ATOMIC_SEQ_CST ) != pdFALSE )
+			{
+				prvSwitchContext();
+			}
+		}
+		else if( xSchedulerEnded != pdFALSE )
+		{
+			/* The scheduler was ended from another core. */
+			for( ;; )
+			{
+				prvSuspendSelf( pxThisThread );
+			}
+		}
+
+		xInterruptsMasked = pdFALSE;
+	}
+	/*-----------------------------------------------------------*/
+
+#else /* configNUM_CORES */
+
+void vPortEnterCritical( void )
+{
+	if( ulCriticalNesting == portNO_CRITICAL_NESTING )
+	{
+		vPortDisableInterrupts();
+	}
+
+	ulCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	if( ulCriticalNesting > portNO_CRITICAL_NESTING )
+	{
+		ulCriticalNesting--;
+
+		/* Any interrupt raised in the critical section is taken as soon as the
+		signals are unblocked. */
+		if( ulCriticalNesting == portNO_CRITICAL_NESTING )
+		{
+			vPortEnableInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+	vPortEnterCritical();
+	prvSwitchContext();
+	vPortExitCritical();
+}
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
+
+static void prvTickSignalHandler( int iSignal )
+{
+	( void ) iSignal;
+
+	if( xPortRunning != pdFALSE )
+	{
+		/* Signals are blocked in the handler, which is therefore a critical
+		section. */
+		#if( configNUM_CORES > 1 )
+		{
+			xInterruptsMasked = pdTRUE;
+		}
+		#else
+		{
+			ulCriticalNesting++;
+		}
+		#endif
+
+		if( prvProcessTickInterrupt() != pdFALSE )
+		{
+			prvSwitchContext();
+		}
+
+		#if( configNUM_CORES > 1 )
+		{
+			xInterruptsMasked = pdFALSE;
+		}
+		#else
+		{
+			ulCriticalNesting--;
+		}
+		#endif
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSignalHandler( int iSignal )
+{
+uint32_t ulPending, ulSwitchRequired = pdFALSE, i;
+
+	( void ) iSignal;
+
+	if( xPortRunning != pdFALSE )
+	{
+		#if( configNUM_CORES > 1 )
+		{
+			xInterruptsMasked = pdTRUE;
+		}
+		#else
+		{
+			ulCriticalNesting++;
+		}
+		#endif
+
+		/* Several interrupts raised together may be delivered as one signal,
+		so handle everything that is pending. */
+		ulPending = __atomic_exchange_n( &ulPendingInterrupts, 0UL, __ATOMIC_SEQ_CST );
+
+		for( i = 0; i < portMAX_INTERRUPTS; i++ )
+		{
+			if( ( ( ulPending & ( 1UL << i ) ) != 0UL ) && ( ulIsrHandler[ i ] != NULL ) )
+			{
+				if( ulIsrHandler[ i ]() != pdFALSE )
+				{
+					ulSwitchRequired = pdTRUE;
+				}
+			}
+		}
+
+		if( ulSwitchRequired != pdFALSE )
+		{
+			prvSwitchContext();
+		}
+
+		#if( configNUM_CORES > 1 )
+		{
+			xInterruptsMasked = pdFALSE;
+		}
+		#else
+		{
+			ulCriticalNesting--;
+		}
+		#endif
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvProcessYieldInterrupt( void )
+{
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvProcessTickInterrupt( void )
+{
+	/* Process the tick itself. */
+	return ( uint32_t ) xTaskIncrementTick();
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+	sigset_t xWaitSignals;
+
+		( void ) xExpectedIdleTime;
+
+		/* The scheduler is suspended, so the interrupts taken while waiting are
+		processed, and any context switch they request is performed, when the idle
+		task resumes it. */
+		vPortDisableInterrupts();
+
+		if( eTaskConfirmSleepModeStatus() != eAbortSleep )
+		{
+			pthread_sigmask( SIG_BLOCK, NULL, &xWaitSignals );
+			sigdelset( &xWaitSignals, portTICK_SIGNAL );
+			sigdelset( &xWaitSignals, portINTERRUPT_SIGNAL );
+			sigsuspend( &xWaitSignals );
+		}
+
+		vPortEnableInterrupts();
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+void vPortThreadDying( void *pvTaskToDelete, volatile BaseType_t *pxPendYield )
+{
+Thread_t *pxThread = portTHREAD_FROM_TCB( pvTaskToDelete );
+
+	/* The task is deleting itself.  Its thread exits when it next switches
+	away, which the yield that follows this hook does. */
+	pxThread->xDying = pdTRUE;
+	pxThread->xDetached = pdTRUE;
+	pthread_detach( pxThread->xThread );
+
+	( void ) pxPendYield;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCancelThread( void *pvTaskToDelete )
+{
+Thread_t *pxThread = portTHREAD_FROM_TCB( pvTaskToDelete );
+
+	/* A task that deleted itself has already gone.  Otherwise wake the thread
+	so that it exits, and wait for it before the TCB and stack that hold its
+	state are freed. */
+	if( pxThread->xDetached == pdFALSE )
+	{
+		pxThread->xDying = pdTRUE;
+		prvResumeThread( pxThread );
+		pthread_join( pxThread->xThread, NULL );
+	}
+
+	pthread_mutex_destroy( &pxThread->xEventMutex );
+	pthread_cond_destroy( &pxThread->xEventCond );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+	if( ( ulInterruptNumber < portMAX_INTERRUPTS ) && ( xPortRunning != pdFALSE ) )
+	{
+		__atomic_fetch_or( &ulPendingInterrupts, 1UL << ulInterruptNumber, __ATOMIC_SEQ_CST );
+
+		/* The signal is taken by the running task's thread, unless it is in a
+		critical section, in which case it is held pending until the critical
+		section is exited. */
+		kill( getpid(), portINTERRUPT_SIGNAL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) )
+{
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* Set up the interrupt signal set before main() runs, so that tasks created
+before the scheduler starts are created with the signals blocked. */
+static void prvInitialiseSignals( void ) __attribute__( ( constructor ) );
+static void prvInitialiseSignals( void )
+{
+	sigemptyset( &xInterruptSignals );
+	sigaddset( &xInterruptSignals, portTICK_SIGNAL );
+	sigaddset( &xInterruptSignals, portINTERRUPT_SIGNAL );
+	#if( configNUM_CORES > 1 )
+	{
+		sigaddset( &xInterruptSignals, portYIELD_CORE_SIGNAL );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,213 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/******************************************************************************
+	Defines
+******************************************************************************/
+/* Type definitions. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	uintptr_t
+#define portBASE_TYPE	long
+#define portPOINTER_SIZE_TYPE uintptr_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+
+	/* 32-bit tick type on a 32/64-bit architecture, so reads of the tick count
+	do not need to be guarded with a critical section. */
+	#define portTICK_TYPE_IS_ATOMIC 1
+#endif
+
+/* Hardware specifics. */
+#define portSTACK_GROWTH			( -1 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portINLINE					__inline
+#define portBYTE_ALIGNMENT			8
+#define portNOP()					__asm volatile( "" )
+#define portMEMORY_BARRIER()		__sync_synchronize()
+
+/* Each task runs in its own pthread, and the running thread is the only one
+that has the interrupt signals (the tick and the simulated interrupts)
+unblocked.  Disabling interrupts blocks those signals. */
+void vPortDisableInterrupts( void );
+void vPortEnableInterrupts( void );
+#define portDISABLE_INTERRUPTS()	vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()		vPortEnableInterrupts()
+
+#if( configNUM_CORES > 1 )
+
+	/* Each core is a host thread that runs one task at a time.  The core a
+	thread runs on is held in its thread state, and changes when the thread is
+	resumed by another core. */
+	BaseType_t xPortGetCoreID( void );
+	#define portGET_CORE_ID()			xPortGetCoreID()
+
+	/* A core is made to yield by sending a signal to the thread it runs. */
+	void vPortYieldCore( BaseType_t xCoreID );
+	#define portYIELD_CORE( xCoreID )	vPortYieldCore( ( xCoreID ) )
+
+	/* The kernel locks are recursive spinlocks, owned by a core. */
+	void vPortGetTaskLock( void );
+	void vPortReleaseTaskLock( void );
+	void vPortGetISRLock( void );
+	void vPortReleaseISRLock( void );
+	#define portGET_TASK_LOCK()			vPortGetTaskLock()
+	#define portRELEASE_TASK_LOCK()		vPortReleaseTaskLock()
+	#define portGET_ISR_LOCK()			vPortGetISRLock()
+	#define portRELEASE_ISR_LOCK()		vPortReleaseISRLock()
+
+	/* Masking returns whether the interrupt signals were already blocked, so
+	nested masking, and masking from a handler, does not block them again. */
+	UBaseType_t uxPortSetInterruptMask( void );
+	void vPortClearInterruptMask( UBaseType_t uxSavedInterruptStatus );
+	#define portSET_INTERRUPT_MASK()				uxPortSetInterruptMask()
+	#define portCLEAR_INTERRUPT_MASK( x )			vPortClearInterruptMask( ( x ) )
+	#define portSET_INTERRUPT_MASK_FROM_ISR()		uxPortSetInterruptMask()
+	#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )	vPortClearInterruptMask( ( x ) )
+
+	/* The critical nesting count is kept per core by the kernel, which also
+	takes the kernel locks. */
+	extern void vTaskEnterCritical( void );
+	extern void vTaskExitCritical( void );
+	#define portENTER_CRITICAL()		vTaskEnterCritical()
+	#define portEXIT_CRITICAL()			vTaskExitCritical()
+
+#else
+
+	/* Simulated interrupt handlers run with the interrupt signals blocked, so
+	there is nothing further to mask. */
+	#define portSET_INTERRUPT_MASK_FROM_ISR()		( ( UBaseType_t ) 0 )
+	#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )	( void ) ( x )
+
+	/* Critical section handling. */
+	void vPortEnterCritical( void );
+	void vPortExitCritical( void );
+	#define portENTER_CRITICAL()		vPortEnterCritical()
+	#define portEXIT_CRITICAL()			vPortExitCritical()
+
+#endif /* configNUM_CORES */
+
+/* Scheduler utilities. */
+void vPortYield( void );
+#define portYIELD()					vPortYield()
+
+/* Simulated interrupts return pdFALSE if no context switch should be performed,
+or a non-zero number if a context switch should be performed. */
+#define portYIELD_FROM_ISR( x )		( void ) ( x )
+#define portEND_SWITCHING_ISR( x )	portYIELD_FROM_ISR( ( x ) )
+
+/* Threads of deleted tasks are stopped by the port. */
+void vPortThreadDying( void *pvTaskToDelete, volatile BaseType_t *pxPendYield );
+void vPortCancelThread( void *pvTaskToDelete );
+#define portPRE_TASK_DELETE_HOOK( pvTaskToDelete, pxPendYield ) vPortThreadDying( ( pvTaskToDelete ), ( pxPendYield ) )
+#define portCLEAN_UP_TCB( pxTCB )	vPortCancelThread( pxTCB )
+
+/* Used when configUSE_TICKLESS_IDLE is 1.  The tick is not suppressed, but the
+idle task waits for the next interrupt rather than spinning, so several
+simulator processes can share a host CPU without delaying each other. */
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( ( xExpectedIdleTime ) )
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+	/* Check the configuration. */
+	#if( configMAX_PRIORITIES > 32 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
+	#endif
+
+	/* Store/clear the ready priorities in a bit map. */
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+	/*-----------------------------------------------------------*/
+
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31UL - ( UBaseType_t ) __builtin_clz( ( uint32_t ) ( uxReadyPriorities ) ) )
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void * pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void * pvParameters )
+
+#define portINTERRUPT_YIELD				( 0UL )
+#define portINTERRUPT_TICK				( 1UL )
+
+/*
+ * Raise a simulated interrupt.  The first two interrupt numbers are used by the
+ * kernel for the Yield and Tick interrupts.  Unlike any other FreeRTOS API
+ * function, this may be called from host threads that are not FreeRTOS tasks,
+ * which is how simulated peripherals signal the application.
+ *
+ * Host threads must not have the interrupt signals unblocked, or the kernel
+ * would run in them.  Create host threads from inside a critical section, so
+ * that they inherit the blocked signal mask.
+ */
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
+
+/*
+ * Install an interrupt handler to be called when the simulated interrupt is
+ * raised.  The interrupt number must be above any used by the kernel itself
+ * and lower than 32.  The handler runs in the context of the running task with
+ * interrupts disabled, much like a real interrupt.
+ *
+ * Interrupt handler functions must return a non-zero value if executing the
+ * handler resulted in a task switch being required.
+ */
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
@@ -951,7 +951,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 	read, instead return a flag to say whether a context switch is required or
 	not (i.e. has a task with a higher priority than us been woken by this
 	post). */
-	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 	{
 		if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
 		{
@@ -1065,7 +1065,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			xReturn = errQUEUE_FULL;
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 	return xReturn;
 }
@@ -1110,7 +1110,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 	link: http://www.freertos.org/RTOS-Cortex-M3-M4.html */
 	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 	{
 		const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
@@ -1230,7 +1230,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			xReturn = errQUEUE_FULL;
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 	return xReturn;
 }
@@ -1772,7 +1772,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 	link: http://www.freertos.org/RTOS-Cortex-M3-M4.html */
 	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 	{
 		const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
@@ -1832,7 +1832,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 	return xReturn;
 }
@@ -1865,7 +1865,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 	link: http://www.freertos.org/RTOS-Cortex-M3-M4.html */
 	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 	{
 		/* Cannot block in an ISR, so check there is data available. */
 		if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
@@ -1886,7 +1886,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue );
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 	return xReturn;
 }
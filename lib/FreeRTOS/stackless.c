@@ -0,0 +1,949 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "stackless.h"
+
+#if( configUSE_TASK_NOTIFICATIONS != 1 )
+	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to build stackless.c
+#endif
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to build stackless.c
+#endif
+
+/* Lint e961 and e750 are suppressed as a MISRA exception justified because the
+MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined for the
+header files above, but not in this file, in order to generate the correct
+privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750. */
+
+/* Bits that can be set in a stackless task's ucWaitFlags. */
+#define stacklessWAIT_STARTED			( ( uint8_t ) 0x01 )	/* The timeout of the current wait has been set. */
+#define stacklessWAIT_TIMED_OUT			( ( uint8_t ) 0x02 )	/* The executor resumed the stackless task because its wait timed out. */
+
+/*-----------------------------------------------------------*/
+
+/* The definition of the executor structure.  All the lists are only accessed
+by the executor task, so only the list of signalled stackless tasks, which is
+written by other tasks and interrupts, needs a critical section. */
+typedef struct xEXECUTOR
+{
+	List_t xReadyList;								/*< Stackless tasks that will be run the next time the executor checks. */
+	List_t xDelayedList1;							/*< Stackless tasks waiting with a timeout, ordered by the time the wait times out. */
+	List_t xDelayedList2;							/*< As xDelayedList1, used for timeouts that fall after the tick count overflows. */
+	List_t *pxDelayedList;							/*< Points to whichever of xDelayedList1 and xDelayedList2 holds the timeouts before the tick count overflows. */
+	List_t *pxOverflowDelayedList;					/*< Points to the other delayed list. */
+	List_t xObjectWaitList;							/*< Stackless tasks waiting for a queue or semaphore, in the order they started waiting. */
+	TickType_t xLastTime;							/*< The tick count when the delayed lists were last checked, used to detect the tick count overflowing. */
+	StacklessTask_t * volatile pxSignalledHead;		/*< The first stackless task notified or started since the executor last checked. */
+	StacklessTask_t * volatile pxSignalledTail;		/*< The last stackless task notified or started, to which the next is linked. */
+	TaskHandle_t xExecutorTask;						/*< The task that runs the stackless tasks. */
+	volatile BaseType_t xDeleted;					/*< Set by vExecutorDelete(), after which the executor task frees the executor. */
+	#if( configUSE_QUEUE_SETS == 1 )
+		QueueSetHandle_t xQueueSet;					/*< The set the executor task blocks on, or NULL if no queues will be added. */
+		SemaphoreHandle_t xWakeSemaphore;			/*< Member of xQueueSet given to wake the executor task, as it cannot also wait for a notification. */
+		UBaseType_t uxQueueSetLength;				/*< The uxQueueSetLength the executor was created with. */
+		UBaseType_t uxQueueLengthAdded;				/*< The sum of the lengths of the queues and semaphores in xQueueSet, other than xWakeSemaphore. */
+	#endif
+} Executor_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task created for each executor to run its stackless tasks.
+ */
+static void prvExecutorTask( void *pvParameters ) PRIVILEGED_FUNCTION;
+
+/*
+ * Links a stackless task onto the end of the list of signalled stackless tasks,
+ * if it is not already on it.  Must be called from a critical section.  Returns
+ * pdTRUE if the executor task must be woken because the list was empty.
+ */
+static BaseType_t prvSignalStackless( Executor_t * const pxExecutor, StacklessTask_t * const pxStacklessTask ) PRIVILEGED_FUNCTION;
+
+/*
+ * Wakes the executor task from a task or from an interrupt.
+ */
+static void prvWakeExecutor( Executor_t * const pxExecutor ) PRIVILEGED_FUNCTION;
+static void prvWakeExecutorFromISR( Executor_t * const pxExecutor, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Moves the stackless tasks that were started, or that were notified while
+ * waiting for a notification, to the ready list.
+ */
+static void prvProcessSignalledStacklessTasks( Executor_t * const pxExecutor ) PRIVILEGED_FUNCTION;
+
+/*
+ * Moves the stackless tasks whose waits have timed out to the ready list.
+ */
+static void prvProcessTimeouts( Executor_t * const pxExecutor ) PRIVILEGED_FUNCTION;
+
+/*
+ * If the tick count has overflowed since the delayed lists were last checked
+ * then all the stackless tasks on the current delayed list have timed out, and
+ * the overflow delayed list becomes the current delayed list.
+ */
+static void prvCheckForTickOverflow( Executor_t * const pxExecutor, TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a stackless task from any lists it is waiting on and adds it to the
+ * end of the ready list.
+ */
+static void prvMakeStacklessReady( Executor_t * const pxExecutor, StacklessTask_t * const pxStacklessTask, BaseType_t xTimedOut ) PRIVILEGED_FUNCTION;
+
+/*
+ * Runs a stackless task until it next waits, yields or finishes.
+ */
+static void prvRunStackless( Executor_t * const pxExecutor, StacklessTask_t * const pxStacklessTask ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the number of ticks the executor task can block for before a wait
+ * times out.
+ */
+static TickType_t prvGetBlockTime( Executor_t * const pxExecutor ) PRIVILEGED_FUNCTION;
+
+/*
+ * Blocks the executor task until it is woken, a queue or semaphore in its set
+ * becomes available, or xTicksToWait ticks pass.
+ */
+static void prvWaitForEvent( Executor_t * const pxExecutor, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+ExecutorHandle_t xExecutorCreate( const char * const pcName,
+								  configSTACK_DEPTH_TYPE usStackDepth,
+								  UBaseType_t uxPriority,
+								  UBaseType_t uxQueueSetLength )
+{
+Executor_t *pxExecutor;
+BaseType_t xResult = pdPASS;
+
+	pxExecutor = ( Executor_t * ) pvPortMalloc( sizeof( Executor_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of Executor_t is a list. */
+
+	if( pxExecutor != NULL )
+	{
+		memset( ( void * ) pxExecutor, 0x00, sizeof( Executor_t ) );
+		vListInitialise( &( pxExecutor->xReadyList ) );
+		vListInitialise( &( pxExecutor->xDelayedList1 ) );
+		vListInitialise( &( pxExecutor->xDelayedList2 ) );
+		vListInitialise( &( pxExecutor->xObjectWaitList ) );
+		pxExecutor->pxDelayedList = &( pxExecutor->xDelayedList1 );
+		pxExecutor->pxOverflowDelayedList = &( pxExecutor->xDelayedList2 );
+		pxExecutor->xLastTime = xTaskGetTickCount();
+
+		#if( configUSE_QUEUE_SETS == 1 )
+		{
+			if( uxQueueSetLength > ( UBaseType_t ) 0 )
+			{
+				/* One more space is needed for the semaphore used to wake the
+				executor task. */
+				pxExecutor->xQueueSet = xQueueCreateSet( uxQueueSetLength + ( UBaseType_t ) 1 );
+				pxExecutor->xWakeSemaphore = xSemaphoreCreateBinary();
+				pxExecutor->uxQueueSetLength = uxQueueSetLength;
+
+				if( ( pxExecutor->xQueueSet == NULL ) ||
+					( pxExecutor->xWakeSemaphore == NULL ) ||
+					( xQueueAddToSet( pxExecutor->xWakeSemaphore, pxExecutor->xQueueSet ) != pdPASS ) )
+				{
+					xResult = pdFAIL;
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			configASSERT( uxQueueSetLength == ( UBaseType_t ) 0 );
+			( void ) uxQueueSetLength;
+		}
+		#endif /* configUSE_QUEUE_SETS */
+
+		if( xResult == pdPASS )
+		{
+			xResult = xTaskCreate( prvExecutorTask, pcName, usStackDepth, ( void * ) pxExecutor, uxPriority, &( pxExecutor->xExecutorTask ) );
+		}
+
+		if( xResult != pdPASS )
+		{
+			#if( configUSE_QUEUE_SETS == 1 )
+			{
+				if( pxExecutor->xWakeSemaphore != NULL )
+				{
+					if( pxExecutor->xQueueSet != NULL )
+					{
+						( void ) xQueueRemoveFromSet( pxExecutor->xWakeSemaphore, pxExecutor->xQueueSet );
+					}
+
+					vSemaphoreDelete( pxExecutor->xWakeSemaphore );
+				}
+
+				if( pxExecutor->xQueueSet != NULL )
+				{
+					vQueueDelete( pxExecutor->xQueueSet );
+				}
+			}
+			#endif /* configUSE_QUEUE_SETS */
+
+			vPortFree( ( void * ) pxExecutor );
+			pxExecutor = NULL;
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return ( ExecutorHandle_t ) pxExecutor;
+}
+/*-----------------------------------------------------------*/
+
+void vExecutorDelete( ExecutorHandle_t xExecutor )
+{
+Executor_t * const pxExecutor = ( Executor_t * ) xExecutor;
+
+	configASSERT( pxExecutor );
+	configASSERT( pxExecutor->xDeleted == pdFALSE );
+
+	pxExecutor->xDeleted = pdTRUE;
+
+	/* The executor task frees the executor and deletes itself when it next
+	checks for work, which may be once the stackless task it is running
+	returns. */
+	if( xTaskGetCurrentTaskHandle() != pxExecutor->xExecutorTask )
+	{
+		prvWakeExecutor( pxExecutor );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vExecutorStartStacklessTask( ExecutorHandle_t xExecutor,
+								  StacklessTask_t *pxStacklessTask,
+								  StacklessTaskFunction_t pxFunction,
+								  void *pvParameter )
+{
+Executor_t * const pxExecutor = ( Executor_t * ) xExecutor;
+BaseType_t xWake;
+
+	configASSERT( pxExecutor );
+	configASSERT( pxStacklessTask );
+	configASSERT( pxFunction );
+
+	/* Restarting a stackless task that has not finished would corrupt the
+	executor's lists. */
+	configASSERT( ( pxStacklessTask->ucState == stacklessSTATE_NOT_STARTED ) || ( pxStacklessTask->ucState == stacklessSTATE_FINISHED ) );
+
+	vListInitialiseItem( &( pxStacklessTask->xStateListItem ) );
+	vListInitialiseItem( &( pxStacklessTask->xEventListItem ) );
+	listSET_LIST_ITEM_OWNER( &( pxStacklessTask->xStateListItem ), pxStacklessTask );
+	listSET_LIST_ITEM_OWNER( &( pxStacklessTask->xEventListItem ), pxStacklessTask );
+	pxStacklessTask->pxNextSignalled = NULL;
+	pxStacklessTask->pxFunction = pxFunction;
+	pxStacklessTask->pvParameter = pvParameter;
+	pxStacklessTask->pvExecutor = ( void * ) pxExecutor;
+	pxStacklessTask->pvWaitObject = NULL;
+	pxStacklessTask->xTicksToWait = ( TickType_t ) 0;
+	pxStacklessTask->ulNotifiedValue = 0UL;
+	pxStacklessTask->uxResumePoint = stacklessRESUME_POINT_START;
+	pxStacklessTask->ucSignalled = pdFALSE;
+	pxStacklessTask->ucWaitFlags = 0;
+
+	/* The executor task moves the stackless task to its ready list, as no other
+	task can access the executor's lists. */
+	taskENTER_CRITICAL();
+	{
+		pxStacklessTask->ucState = stacklessSTATE_STARTING;
+		xWake = prvSignalStackless( pxExecutor, pxStacklessTask );
+	}
+	taskEXIT_CRITICAL();
+
+	if( ( xWake != pdFALSE ) && ( xTaskGetCurrentTaskHandle() != pxExecutor->xExecutorTask ) )
+	{
+		prvWakeExecutor( pxExecutor );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_SETS == 1 )
+
+	BaseType_t xExecutorAddQueue( ExecutorHandle_t xExecutor, QueueSetMemberHandle_t xQueueOrSemaphore )
+	{
+	Executor_t * const pxExecutor = ( Executor_t * ) xExecutor;
+	UBaseType_t uxLength;
+	BaseType_t xReturn;
+
+		configASSERT( pxExecutor );
+
+		/* The executor must have been created with a queue set length. */
+		configASSERT( pxExecutor->xQueueSet );
+
+		taskENTER_CRITICAL();
+		{
+			/* Only an empty queue or semaphore can be added to a set, so the
+			spaces available are its length. */
+			uxLength = uxQueueSpacesAvailable( ( QueueHandle_t ) xQueueOrSemaphore );
+
+			/* The set would overflow, and the events of a full set lost, if the
+			lengths added came to more than the executor was created with. */
+			if( uxLength > ( pxExecutor->uxQueueSetLength - pxExecutor->uxQueueLengthAdded ) )
+			{
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				xReturn = xQueueAddToSet( xQueueOrSemaphore, pxExecutor->xQueueSet );
+
+				if( xReturn == pdPASS )
+				{
+					pxExecutor->uxQueueLengthAdded += uxLength;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_SETS == 1 )
+
+	BaseType_t xExecutorRemoveQueue( ExecutorHandle_t xExecutor, QueueSetMemberHandle_t xQueueOrSemaphore )
+	{
+	Executor_t * const pxExecutor = ( Executor_t * ) xExecutor;
+	UBaseType_t uxLength;
+	BaseType_t xReturn;
+
+		configASSERT( pxExecutor );
+		configASSERT( pxExecutor->xQueueSet );
+
+		taskENTER_CRITICAL();
+		{
+			/* As when adding, only an empty queue or semaphore can be removed
+			from a set. */
+			uxLength = uxQueueSpacesAvailable( ( QueueHandle_t ) xQueueOrSemaphore );
+			xReturn = xQueueRemoveFromSet( xQueueOrSemaphore, pxExecutor->xQueueSet );
+
+			if( xReturn == pdPASS )
+			{
+				configASSERT( pxExecutor->uxQueueLengthAdded >= uxLength );
+				pxExecutor->uxQueueLengthAdded -= uxLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+BaseType_t xStacklessNotify( StacklessTask_t *pxStacklessTask, uint32_t ulBitsToSet )
+{
+Executor_t *pxExecutor;
+BaseType_t xWake;
+
+	configASSERT( pxStacklessTask );
+	configASSERT( ulBitsToSet != 0UL );
+
+	pxExecutor = ( Executor_t * ) pxStacklessTask->pvExecutor;
+	configASSERT( pxExecutor );
+
+	taskENTER_CRITICAL();
+	{
+		pxStacklessTask->ulNotifiedValue |= ulBitsToSet;
+		xWake = prvSignalStackless( pxExecutor, pxStacklessTask );
+	}
+	taskEXIT_CRITICAL();
+
+	/* The executor task checks for signalled stackless tasks before it blocks,
+	so does not need to be woken when a stackless task notifies another. */
+	if( ( xWake != pdFALSE ) && ( xTaskGetCurrentTaskHandle() != pxExecutor->xExecutorTask ) )
+	{
+		prvWakeExecutor( pxExecutor );
+	}
+	else
+	{
+		xWake = pdFALSE;
+	}
+
+	return xWake;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStacklessNotifyFromISR( StacklessTask_t *pxStacklessTask,
+									uint32_t ulBitsToSet,
+									BaseType_t * const pxHigherPriorityTaskWoken )
+{
+Executor_t *pxExecutor;
+BaseType_t xWake;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxStacklessTask );
+	configASSERT( ulBitsToSet != 0UL );
+
+	pxExecutor = ( Executor_t * ) pxStacklessTask->pvExecutor;
+	configASSERT( pxExecutor );
+
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		pxStacklessTask->ulNotifiedValue |= ulBitsToSet;
+		xWake = prvSignalStackless( pxExecutor, pxStacklessTask );
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	if( xWake != pdFALSE )
+	{
+		prvWakeExecutorFromISR( pxExecutor, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xWake;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulStacklessNotifyTake( StacklessTask_t *pxStacklessTask )
+{
+uint32_t ulReturn;
+
+	configASSERT( pxStacklessTask );
+
+	taskENTER_CRITICAL();
+	{
+		ulReturn = pxStacklessTask->ulNotifiedValue;
+		pxStacklessTask->ulNotifiedValue = 0UL;
+	}
+	taskEXIT_CRITICAL();
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStacklessWait( StacklessTask_t *pxStacklessTask, BaseType_t xReady, void *pvObject, TickType_t xTicksToWait )
+{
+Executor_t * const pxExecutor = ( Executor_t * ) pxStacklessTask->pvExecutor;
+TickType_t xTimeNow, xTimeToWake;
+BaseType_t xReturn, xWaitForever;
+
+	/* Only the executor task runs stackless tasks. */
+	configASSERT( xTaskGetCurrentTaskHandle() == pxExecutor->xExecutorTask );
+
+	if( xReady != pdFALSE )
+	{
+		pxStacklessTask->ucWaitFlags = 0;
+		xReturn = pdFALSE;
+	}
+	else
+	{
+		if( ( pxStacklessTask->ucWaitFlags & stacklessWAIT_STARTED ) == 0 )
+		{
+			/* This is the first time the condition has been tested, so the
+			timeout starts now.  If the stackless task waits more than once for
+			the same condition, because it was woken before the condition became
+			true, the timeout still runs from the first time. */
+			vTaskSetTimeOutState( &( pxStacklessTask->xTimeOut ) );
+			pxStacklessTask->xTicksToWait = xTicksToWait;
+			pxStacklessTask->ucWaitFlags = stacklessWAIT_STARTED;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ( ( pxStacklessTask->ucWaitFlags & stacklessWAIT_TIMED_OUT ) != 0 ) ||
+			( xTaskCheckForTimeOut( &( pxStacklessTask->xTimeOut ), &( pxStacklessTask->xTicksToWait ) ) != pdFALSE ) )
+		{
+			pxStacklessTask->ucWaitFlags = 0;
+			xReturn = pdFALSE;
+		}
+		else
+		{
+			pxStacklessTask->ucState = stacklessSTATE_WAITING;
+			pxStacklessTask->pvWaitObject = pvObject;
+
+			#if( INCLUDE_vTaskSuspend == 1 )
+			{
+				xWaitForever = ( pxStacklessTask->xTicksToWait == portMAX_DELAY ) ? pdTRUE : pdFALSE;
+			}
+			#else
+			{
+				xWaitForever = pdFALSE;
+			}
+			#endif
+
+			if( xWaitForever == pdFALSE )
+			{
+				xTimeNow = xTaskGetTickCount();
+				prvCheckForTickOverflow( pxExecutor, xTimeNow );
+
+				/* As in the kernel's own delayed lists, the list item value is
+				the time at which the wait times out, and a time that is less
+				than the current time is after the tick count overflows. */
+				xTimeToWake = xTimeNow + pxStacklessTask->xTicksToWait;
+				listSET_LIST_ITEM_VALUE( &( pxStacklessTask->xStateListItem ), xTimeToWake );
+
+				if( xTimeToWake < xTimeNow )
+				{
+					vListInsert( pxExecutor->pxOverflowDelayedList, &( pxStacklessTask->xStateListItem ) );
+				}
+				else
+				{
+					vListInsert( pxExecutor->pxDelayedList, &( pxStacklessTask->xStateListItem ) );
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* A stackless task waiting for a notification is found through the
+			list of signalled stackless tasks, so is not added to the object
+			list. */
+			if( ( pvObject != NULL ) && ( pvObject != ( void * ) pxStacklessTask ) )
+			{
+				vListInsertEnd( &( pxExecutor->xObjectWaitList ), &( pxStacklessTask->xEventListItem ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdTRUE;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSignalStackless( Executor_t * const pxExecutor, StacklessTask_t * const pxStacklessTask )
+{
+BaseType_t xReturn = pdFALSE;
+
+	if( pxStacklessTask->ucSignalled == pdFALSE )
+	{
+		pxStacklessTask->ucSignalled = pdTRUE;
+		pxStacklessTask->pxNextSignalled = NULL;
+
+		if( pxExecutor->pxSignalledTail == NULL )
+		{
+			pxExecutor->pxSignalledHead = pxStacklessTask;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			pxExecutor->pxSignalledTail->pxNextSignalled = pxStacklessTask;
+		}
+
+		pxExecutor->pxSignalledTail = pxStacklessTask;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWakeExecutor( Executor_t * const pxExecutor )
+{
+	#if( configUSE_QUEUE_SETS == 1 )
+	{
+		if( pxExecutor->xWakeSemaphore != NULL )
+		{
+			/* Fails if the semaphore was already given, which is fine. */
+			( void ) xSemaphoreGive( pxExecutor->xWakeSemaphore );
+		}
+		else
+		{
+			( void ) xTaskNotifyGive( pxExecutor->xExecutorTask );
+		}
+	}
+	#else
+	{
+		( void ) xTaskNotifyGive( pxExecutor->xExecutorTask );
+	}
+	#endif /* configUSE_QUEUE_SETS */
+}
+/*-----------------------------------------------------------*/
+
+static void prvWakeExecutorFromISR( Executor_t * const pxExecutor, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+	#if( configUSE_QUEUE_SETS == 1 )
+	{
+		if( pxExecutor->xWakeSemaphore != NULL )
+		{
+			( void ) xSemaphoreGiveFromISR( pxExecutor->xWakeSemaphore, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			vTaskNotifyGiveFromISR( pxExecutor->xExecutorTask, pxHigherPriorityTaskWoken );
+		}
+	}
+	#else
+	{
+		vTaskNotifyGiveFromISR( pxExecutor->xExecutorTask, pxHigherPriorityTaskWoken );
+	}
+	#endif /* configUSE_QUEUE_SETS */
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessSignalledStacklessTasks( Executor_t * const pxExecutor )
+{
+StacklessTask_t *pxStacklessTask, *pxNext;
+
+	taskENTER_CRITICAL();
+	{
+		pxStacklessTask = pxExecutor->pxSignalledHead;
+		pxExecutor->pxSignalledHead = NULL;
+		pxExecutor->pxSignalledTail = NULL;
+	}
+	taskEXIT_CRITICAL();
+
+	while( pxStacklessTask != NULL )
+	{
+		/* Once ucSignalled is clear the stackless task can be signalled again,
+		which overwrites pxNextSignalled, so both are accessed together. */
+		taskENTER_CRITICAL();
+		{
+			pxNext = pxStacklessTask->pxNextSignalled;
+			pxStacklessTask->pxNextSignalled = NULL;
+			pxStacklessTask->ucSignalled = pdFALSE;
+		}
+		taskEXIT_CRITICAL();
+
+		if( pxStacklessTask->ucState == stacklessSTATE_STARTING )
+		{
+			prvMakeStacklessReady( pxExecutor, pxStacklessTask, pdFALSE );
+		}
+		else if( ( pxStacklessTask->ucState == stacklessSTATE_WAITING ) && ( pxStacklessTask->pvWaitObject == ( void * ) pxStacklessTask ) )
+		{
+			prvMakeStacklessReady( pxExecutor, pxStacklessTask, pdFALSE );
+		}
+		else
+		{
+			/* The stackless task is not waiting for a notification, so will
+			find the notification value the next time it tests it. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStacklessTask = pxNext;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckForTickOverflow( Executor_t * const pxExecutor, TickType_t xTimeNow )
+{
+List_t *pxTemp;
+
+	if( xTimeNow < pxExecutor->xLastTime )
+	{
+		while( listLIST_IS_EMPTY( pxExecutor->pxDelayedList ) == pdFALSE )
+		{
+			prvMakeStacklessReady( pxExecutor, ( StacklessTask_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxExecutor->pxDelayedList ), pdTRUE ); /*lint !e9087 The list item owner is the stackless task. */
+		}
+
+		pxTemp = pxExecutor->pxDelayedList;
+		pxExecutor->pxDelayedList = pxExecutor->pxOverflowDelayedList;
+		pxExecutor->pxOverflowDelayedList = pxTemp;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxExecutor->xLastTime = xTimeNow;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessTimeouts( Executor_t * const pxExecutor )
+{
+TickType_t xTimeNow = xTaskGetTickCount();
+StacklessTask_t *pxStacklessTask;
+
+	prvCheckForTickOverflow( pxExecutor, xTimeNow );
+
+	while( listLIST_IS_EMPTY( pxExecutor->pxDelayedList ) == pdFALSE )
+	{
+		pxStacklessTask = ( StacklessTask_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxExecutor->pxDelayedList ); /*lint !e9087 The list item owner is the stackless task. */
+
+		if( listGET_LIST_ITEM_VALUE( &( pxStacklessTask->xStateListItem ) ) > xTimeNow )
+		{
+			/* The list is ordered by timeout, so none of the other waits has
+			timed out either. */
+			break;
+		}
+
+		prvMakeStacklessReady( pxExecutor, pxStacklessTask, pdTRUE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMakeStacklessReady( Executor_t * const pxExecutor, StacklessTask_t * const pxStacklessTask, BaseType_t xTimedOut )
+{
+	if( listLIST_ITEM_CONTAINER( &( pxStacklessTask->xStateListItem ) ) != NULL )
+	{
+		( void ) uxListRemove( &( pxStacklessTask->xStateListItem ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( listLIST_ITEM_CONTAINER( &( pxStacklessTask->xEventListItem ) ) != NULL )
+	{
+		( void ) uxListRemove( &( pxStacklessTask->xEventListItem ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xTimedOut != pdFALSE )
+	{
+		pxStacklessTask->ucWaitFlags |= stacklessWAIT_TIMED_OUT;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxStacklessTask->ucState = stacklessSTATE_READY;
+	pxStacklessTask->pvWaitObject = NULL;
+	vListInsertEnd( &( pxExecutor->xReadyList ), &( pxStacklessTask->xStateListItem ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunStackless( Executor_t * const pxExecutor, StacklessTask_t * const pxStacklessTask )
+{
+	( void ) uxListRemove( &( pxStacklessTask->xStateListItem ) );
+
+	pxStacklessTask->pxFunction( pxStacklessTask, pxStacklessTask->pvParameter );
+
+	if( pxStacklessTask->ucState == stacklessSTATE_WAITING )
+	{
+		/* xStacklessWait() has already added the stackless task to the lists it
+		waits on. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+	else if( pxStacklessTask->uxResumePoint == stacklessRESUME_POINT_END )
+	{
+		pxStacklessTask->ucState = stacklessSTATE_FINISHED;
+	}
+	else
+	{
+		/* The stackless task yielded, so runs again after the other stackless
+		tasks that are ready. */
+		vListInsertEnd( &( pxExecutor->xReadyList ), &( pxStacklessTask->xStateListItem ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvGetBlockTime( Executor_t * const pxExecutor )
+{
+TickType_t xReturn, xTimeNow, xTimeToWake;
+
+	if( listLIST_IS_EMPTY( &( pxExecutor->xReadyList ) ) == pdFALSE )
+	{
+		xReturn = ( TickType_t ) 0;
+	}
+	else if( listLIST_IS_EMPTY( pxExecutor->pxDelayedList ) == pdFALSE )
+	{
+		xTimeNow = xTaskGetTickCount();
+		xTimeToWake = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxExecutor->pxDelayedList );
+
+		if( ( xTimeNow >= pxExecutor->xLastTime ) && ( xTimeToWake > xTimeNow ) )
+		{
+			xReturn = xTimeToWake - xTimeNow;
+		}
+		else
+		{
+			xReturn = ( TickType_t ) 0;
+		}
+	}
+	else if( listLIST_IS_EMPTY( pxExecutor->pxOverflowDelayedList ) == pdFALSE )
+	{
+		/* Wake when the tick count overflows to switch the delayed lists. */
+		xTimeNow = xTaskGetTickCount();
+
+		if( xTimeNow >= pxExecutor->xLastTime )
+		{
+			xReturn = ( TickType_t ) ( ( portMAX_DELAY - xTimeNow ) + ( TickType_t ) 1 );
+		}
+		else
+		{
+			xReturn = ( TickType_t ) 0;
+		}
+	}
+	else
+	{
+		xReturn = portMAX_DELAY;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitForEvent( Executor_t * const pxExecutor, TickType_t xTicksToWait )
+{
+	#if( configUSE_QUEUE_SETS == 1 )
+	{
+	QueueSetMemberHandle_t xActivated;
+	ListItem_t const *pxEndMarker;
+	ListItem_t *pxIterator;
+	StacklessTask_t *pxStacklessTask;
+
+		if( pxExecutor->xQueueSet != NULL )
+		{
+			while( ( xActivated = xQueueSelectFromSet( pxExecutor->xQueueSet, xTicksToWait ) ) != NULL )
+			{
+				if( xActivated == ( QueueSetMemberHandle_t ) pxExecutor->xWakeSemaphore )
+				{
+					( void ) xSemaphoreTake( pxExecutor->xWakeSemaphore, 0 );
+				}
+				else
+				{
+					/* Each time a queue or semaphore appears in the set one
+					item or count has become available, so one stackless task
+					waiting for it is resumed.  The others remain waiting.  If
+					none is waiting then the next stackless task to test its
+					condition will find the item. */
+					pxEndMarker = listGET_END_MARKER( &( pxExecutor->xObjectWaitList ) );
+
+					for( pxIterator = listGET_HEAD_ENTRY( &( pxExecutor->xObjectWaitList ) ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+					{
+						pxStacklessTask = ( StacklessTask_t * ) listGET_LIST_ITEM_OWNER( pxIterator ); /*lint !e9087 The list item owner is the stackless task. */
+
+						if( pxStacklessTask->pvWaitObject == ( void * ) xActivated )
+						{
+							prvMakeStacklessReady( pxExecutor, pxStacklessTask, pdFALSE );
+							break;
+						}
+					}
+				}
+
+				/* Collect everything else that is already available without
+				blocking again. */
+				xTicksToWait = ( TickType_t ) 0;
+			}
+		}
+		else
+		{
+			( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+		}
+	}
+	#else
+	{
+		( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+	}
+	#endif /* configUSE_QUEUE_SETS */
+}
+/*-----------------------------------------------------------*/
+
+static void prvExecutorTask( void *pvParameters )
+{
+Executor_t * const pxExecutor = ( Executor_t * ) pvParameters;
+UBaseType_t uxToRun;
+
+	for( ;; )
+	{
+		prvProcessSignalledStacklessTasks( pxExecutor );
+		prvProcessTimeouts( pxExecutor );
+
+		/* Only the stackless tasks that are ready now are run, so stackless
+		tasks that yield, or that become ready while the others run, cannot stop
+		the executor checking for new events. */
+		uxToRun = listCURRENT_LIST_LENGTH( &( pxExecutor->xReadyList ) );
+
+		while( ( uxToRun > ( UBaseType_t ) 0 ) && ( pxExecutor->xDeleted == pdFALSE ) )
+		{
+			prvRunStackless( pxExecutor, ( StacklessTask_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxExecutor->xReadyList ) ) ); /*lint !e9087 The list item owner is the stackless task. */
+			uxToRun--;
+		}
+
+		if( pxExecutor->xDeleted != pdFALSE )
+		{
+			break;
+		}
+
+		prvWaitForEvent( pxExecutor, prvGetBlockTime( pxExecutor ) );
+	}
+
+	#if( configUSE_QUEUE_SETS == 1 )
+	{
+		if( pxExecutor->xQueueSet != NULL )
+		{
+			/* The semaphore must be empty to be removed from the set. */
+			( void ) xSemaphoreTake( pxExecutor->xWakeSemaphore, 0 );
+			( void ) xQueueRemoveFromSet( pxExecutor->xWakeSemaphore, pxExecutor->xQueueSet );
+			vSemaphoreDelete( pxExecutor->xWakeSemaphore );
+			vQueueDelete( pxExecutor->xQueueSet );
+		}
+	}
+	#endif /* configUSE_QUEUE_SETS */
+
+	vPortFree( ( void * ) pxExecutor );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
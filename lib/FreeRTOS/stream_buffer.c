@@ -74,7 +74,7 @@ that uses task notifications. */
 	{																					\
 	UBaseType_t uxSavedInterruptStatus;													\
 																						\
-		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();		\
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();							\
 		{																				\
 			if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )						\
 			{																			\
@@ -85,7 +85,7 @@ that uses task notifications. */
 				( pxStreamBuffer )->xTaskWaitingToSend = NULL;							\
 			}																			\
 		}																				\
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );							\
 	}
 #endif /* sbRECEIVE_COMPLETED_FROM_ISR */
 
@@ -112,7 +112,7 @@ that uses task notifications. */
 	{																					\
 	UBaseType_t uxSavedInterruptStatus;													\
 																						\
-		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();		\
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();							\
 		{																				\
 			if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )						\
 			{																			\
@@ -123,7 +123,7 @@ that uses task notifications. */
 				( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
 			}																			\
 		}																				\
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );							\
 	}
 #endif /* sbSEND_COMPLETE_FROM_ISR */
 /*lint -restore (9026) */
@@ -965,7 +965,7 @@ UBaseType_t uxSavedInterruptStatus;
 
 	configASSERT( pxStreamBuffer );
 
-	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 	{
 		if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )
 		{
@@ -981,7 +981,7 @@ UBaseType_t uxSavedInterruptStatus;
 			xReturn = pdFALSE;
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 	return xReturn;
 }
@@ -995,7 +995,7 @@ UBaseType_t uxSavedInterruptStatus;
 
 	configASSERT( pxStreamBuffer );
 
-	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 	{
 		if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )
 		{
@@ -1011,7 +1011,7 @@ UBaseType_t uxSavedInterruptStatus;
 			xReturn = pdFALSE;
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 	return xReturn;
 }
@@ -64,6 +64,25 @@ functions but without including stdio.h here. */
 	#define taskYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
 #endif
 
+/* Value held in the xTaskRunState member of the TCB of a task that is not
+running on any core.  Otherwise xTaskRunState holds the ID of the core the task
+is running on. */
+#define taskTASK_NOT_RUNNING	( ( BaseType_t ) -1 )
+
+#if( configNUM_CORES > 1 )
+	#define taskTASK_IS_RUNNING( pxTCB )	( ( pxTCB )->xTaskRunState != taskTASK_NOT_RUNNING )
+
+	/* Requests a context switch on the core identified by xCoreID, which may be
+	the calling core. */
+	#if( configUSE_PREEMPTION == 0 )
+		#define taskYIELD_CORE_IF_USING_PREEMPTION( xCoreID )
+	#else
+		#define taskYIELD_CORE_IF_USING_PREEMPTION( xCoreID ) prvYieldCore( xCoreID )
+	#endif
+#else
+	#define taskTASK_IS_RUNNING( pxTCB )	( ( pxTCB ) == pxCurrentTCB )
+#endif
+
 /* Values that can be assigned to the ucNotifyState member of the TCB. */
 #define taskNOT_WAITING_NOTIFICATION	( ( uint8_t ) 0 )
 #define taskWAITING_NOTIFICATION		( ( uint8_t ) 1 )
@@ -210,21 +229,63 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 
 /*-----------------------------------------------------------*/
 
-/* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
-count overflows. */
-#define taskSWITCH_DELAYED_LISTS()																	\
-{																									\
-	List_t *pxTemp;																					\
+#if( configUSE_TIMING_WHEEL == 0 )
+
+	/* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the
+	tick count overflows. */
+	#define taskSWITCH_DELAYED_LISTS()																\
+	{																								\
+		List_t *pxTemp;																				\
 																									\
-	/* The delayed tasks list should be empty when the lists are switched. */						\
-	configASSERT( ( listLIST_IS_EMPTY( pxDelayedTaskList ) ) );										\
+		/* The delayed tasks list should be empty when the lists are switched. */					\
+		configASSERT( ( listLIST_IS_EMPTY( pxDelayedTaskList ) ) );									\
 																									\
-	pxTemp = pxDelayedTaskList;																		\
-	pxDelayedTaskList = pxOverflowDelayedTaskList;													\
-	pxOverflowDelayedTaskList = pxTemp;																\
-	xNumOfOverflows++;																				\
-	prvResetNextTaskUnblockTime();																	\
-}
+		pxTemp = pxDelayedTaskList;																	\
+		pxDelayedTaskList = pxOverflowDelayedTaskList;												\
+		pxOverflowDelayedTaskList = pxTemp;															\
+		xNumOfOverflows++;																			\
+		prvResetNextTaskUnblockTime();																\
+	}
+
+	/* Wake times are absolute tick counts, and tasks that wake after the tick
+	count overflows are held in their own list. */
+	#define taskTICK_IS_BEFORE_OR_AT( xTick, xReference ) ( ( xTick ) <= ( xReference ) )
+
+	#define taskLIST_IS_DELAYED_LIST( pxList ) ( ( ( pxList ) == pxDelayedTaskList ) || ( ( pxList ) == pxOverflowDelayedTaskList ) )
+
+#else
+
+	/* Tasks are placed in the timing wheel relative to the current tick count,
+	so only the overflow count has to be maintained when the tick count
+	overflows. */
+	#define taskSWITCH_DELAYED_LISTS()																\
+	{																								\
+		xNumOfOverflows++;																			\
+	}
+
+	/* Tick counts are compared by their distance from the last tick processed
+	by the timing wheel, which keeps the comparison valid across an overflow of
+	the tick count. */
+	#define taskTICK_IS_BEFORE_OR_AT( xTick, xReference ) ( ( TickType_t ) ( ( xTick ) - xTimingWheelTick ) <= ( TickType_t ) ( ( xReference ) - xTimingWheelTick ) )
+
+	#define taskLIST_IS_DELAYED_LIST( pxList ) ( ( ( ( pxList ) >= &( xTimingWheel[ 0 ][ 0 ] ) ) && ( ( pxList ) <= &( xTimingWheel[ 1 ][ configTIMING_WHEEL_SLOTS - 1 ] ) ) ) || ( ( pxList ) == &xTimingWheelFarList ) )
+
+	/* Each level of the timing wheel has configTIMING_WHEEL_SLOTS slots.  A
+	task due to wake within configTIMING_WHEEL_SLOTS ticks is held in the first
+	level, in the slot of its wake time.  A task due to wake within
+	taskWHEEL_SPAN ticks is held in the second level, in the slot of its wake
+	time divided by configTIMING_WHEEL_SLOTS, and is moved to the first level
+	when the tick count reaches the start of that slot.  Other tasks are held in
+	xTimingWheelFarList, which is sorted back into the wheel each time the tick
+	count reaches a multiple of taskWHEEL_SPAN. */
+	#define taskWHEEL_SLOT_MASK		( ( TickType_t ) configTIMING_WHEEL_SLOTS - ( TickType_t ) 1 )
+	#define taskWHEEL_SPAN			( ( uint32_t ) configTIMING_WHEEL_SLOTS * ( uint32_t ) configTIMING_WHEEL_SLOTS )
+	#define taskWHEEL_MAP_WORDS		( configTIMING_WHEEL_SLOTS / 32 )
+
+	#define taskWHEEL_SET_SLOT_BIT( uxLevel, uxSlot ) ( ulTimingWheelMap[ ( uxLevel ) ][ ( uxSlot ) >> 5 ] |= ( ( uint32_t ) 1 ) << ( ( uxSlot ) & 31 ) )
+	#define taskWHEEL_CLEAR_SLOT_BIT( uxLevel, uxSlot ) ( ulTimingWheelMap[ ( uxLevel ) ][ ( uxSlot ) >> 5 ] &= ~( ( ( uint32_t ) 1 ) << ( ( uxSlot ) & 31 ) ) )
+
+#endif /* configUSE_TIMING_WHEEL */
 
 /*-----------------------------------------------------------*/
 
@@ -322,8 +383,8 @@ typedef struct tskTaskControlBlock
 	#endif
 
 	#if( configUSE_TASK_NOTIFICATIONS == 1 )
-		volatile uint32_t ulNotifiedValue;
-		volatile uint8_t ucNotifyState;
+		volatile uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		volatile uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 
 	/* See the comments above the definition of
@@ -340,6 +401,11 @@ typedef struct tskTaskControlBlock
 		int iTaskErrno;
 	#endif
 
+	#if( configNUM_CORES > 1 )
+		volatile BaseType_t xTaskRunState;	/*< The ID of the core the task is running on, or taskTASK_NOT_RUNNING. */
+		UBaseType_t		uxCoreAffinityMask;	/*< Bit n is set if the task is allowed to run on core n. */
+	#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -349,14 +415,37 @@ typedef tskTCB TCB_t;
 /*lint -save -e956 A manual analysis and inspection has been used to determine
 which static variables must be declared volatile. */
 
-PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+#if( configNUM_CORES > 1 )
+
+	/* One running task per core.  The task running on the calling core is
+	obtained through xTaskGetCurrentTaskHandle(), as the calling task could be
+	moved to another core between reading the core ID and indexing the array. */
+	PRIVILEGED_DATA TCB_t * volatile pxCurrentTCBs[ configNUM_CORES ] = { NULL };
+	#define pxCurrentTCB	( ( TCB_t * ) xTaskGetCurrentTaskHandle() )
+
+#else
+
+	PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+
+#endif
 
 /* Lists for ready and blocked tasks. --------------------*/
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ];/*< Prioritised ready tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList1;						/*< Delayed tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList2;						/*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the delayed task list currently being used. */
-PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+#if( configUSE_TIMING_WHEEL == 0 )
+
+	PRIVILEGED_DATA static List_t xDelayedTaskList1;						/*< Delayed tasks. */
+	PRIVILEGED_DATA static List_t xDelayedTaskList2;						/*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
+	PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the delayed task list currently being used. */
+	PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+
+#else
+
+	PRIVILEGED_DATA static List_t xTimingWheel[ 2 ][ configTIMING_WHEEL_SLOTS ];			/*< Delayed tasks, in unsorted slots by wake time. */
+	PRIVILEGED_DATA static List_t xTimingWheelFarList;									/*< Delayed tasks that wake too far in the future to be held in the wheel. */
+	PRIVILEGED_DATA static uint32_t ulTimingWheelMap[ 2 ][ taskWHEEL_MAP_WORDS ];		/*< One bit per slot, set when a task is placed in the slot.  Bits are only cleared when the slot is found to be empty. */
+	PRIVILEGED_DATA static TickType_t xTimingWheelTick = ( TickType_t ) 0U;				/*< The tick count up to which the wheel has been processed. */
+
+#endif /* configUSE_TIMING_WHEEL */
 PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if( INCLUDE_vTaskDelete == 1 )
@@ -385,11 +474,19 @@ PRIVILEGED_DATA static volatile TickType_t xIdleTickCount 			= ( TickType_t ) co
 PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority 		= tskIDLE_PRIORITY;
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning 		= pdFALSE;
 PRIVILEGED_DATA static volatile UBaseType_t uxPendedTicks 			= ( UBaseType_t ) 0U;
-PRIVILEGED_DATA static volatile BaseType_t xYieldPending 			= pdFALSE;
+#if( configNUM_CORES > 1 )
+	PRIVILEGED_DATA static volatile BaseType_t xYieldPendings[ configNUM_CORES ] = { pdFALSE };
+#else
+	PRIVILEGED_DATA static volatile BaseType_t xYieldPending 		= pdFALSE;
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xNumOfOverflows 			= ( BaseType_t ) 0;
 PRIVILEGED_DATA static UBaseType_t uxTaskNumber 					= ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime		= ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
-PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle					= NULL;			/*< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
+#if( configNUM_CORES > 1 )
+	PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandles[ configNUM_CORES ] = { NULL };	/*< Holds the handles of the idle tasks, one per core.  The idle tasks are created automatically when the scheduler is started. */
+#else
+	PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle				= NULL;			/*< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
+#endif
 
 /* Context switches are held pending while the scheduler is suspended.  Also,
 interrupts must not manipulate the xStateListItem of a TCB, or any of the
@@ -401,9 +498,29 @@ when the scheduler is unsuspended.  The pending ready list itself can only be
 accessed from a critical section. */
 PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended	= ( UBaseType_t ) pdFALSE;
 
+#if( configNUM_CORES > 1 )
+
+	/* The critical section nesting depth of each core.  While the scheduler is
+	running a core that is in a critical section holds both the task lock and
+	the ISR lock, and uxSchedulerSuspended can only be non-zero while the core
+	that suspended the scheduler holds the task lock. */
+	PRIVILEGED_DATA static volatile UBaseType_t uxCriticalNestings[ configNUM_CORES ] = { 0U };
+
+	/* A task that is running on a core cannot move to another core while it
+	is in a critical section or has suspended the scheduler, so xYieldPending
+	and xIdleTaskHandle are only used from such places. */
+	#define xYieldPending		xYieldPendings[ portGET_CORE_ID() ]
+	#define xIdleTaskHandle		xIdleTaskHandles[ 0 ]
+
+#endif
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
-	PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
+	#if( configNUM_CORES > 1 )
+		PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime[ configNUM_CORES ] = { 0UL };	/*< Holds the value of a timer/counter the last time a task was switched in on each core. */
+	#else
+		PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
+	#endif
 	PRIVILEGED_DATA static uint32_t ulTotalRunTime = 0UL;		/*< Holds the total amount of execution time as defined by the run time counter clock. */
 
 #endif
@@ -545,6 +662,54 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  */
 static void prvResetNextTaskUnblockTime( void );
 
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	/*
+	 * Place the list item of a Blocked state task into the timing wheel slot
+	 * for its wake time, measured relative to xTimeNow.  Returns the tick
+	 * count at which the wheel must next be processed for the task.
+	 */
+	static TickType_t prvTimingWheelInsert( ListItem_t * const pxListItem, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move the task at the head of the timing wheel slot that is being
+	 * processed into the appropriate ready list.
+	 */
+	static BaseType_t prvTimingWheelUnblockTask( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Process the timing wheel for the tick count xTick, unblocking the tasks
+	 * that are due to wake.  Returns pdTRUE if a context switch is required.
+	 */
+	static BaseType_t prvTimingWheelProcessTick( const TickType_t xTick ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the offset, from uxStart and modulo configTIMING_WHEEL_SLOTS, of
+	 * the first slot of the level that holds a task.  Returns
+	 * configTIMING_WHEEL_SLOTS or more if all the slots are empty.
+	 */
+	static UBaseType_t prvTimingWheelFirstSlot( const UBaseType_t uxLevel, const UBaseType_t uxStart ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the first tick count after xTimingWheelTick at which the timing
+	 * wheel has to be processed.
+	 */
+	static TickType_t prvTimingWheelNextWake( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Place the calling task, whose state list item holds its wake time, into
+	 * the timing wheel.
+	 */
+	static void prvTimingWheelAddCurrentTask( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Advance xTimingWheelTick as far towards the current tick count as
+	 * possible without skipping a tick that still has to be processed.
+	 */
+	static void prvTimingWheelSync( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMING_WHEEL */
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	/*
@@ -574,6 +739,33 @@ static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 
+#if( configNUM_CORES > 1 )
+
+	/*
+	 * Select the highest priority ready task that is allowed to run on the
+	 * core xCoreID and is not already running on another core, and make it
+	 * the running task of xCoreID.  Must be called with the task and ISR locks
+	 * held.
+	 */
+	static void prvSelectHighestPriorityTask( const BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Request a context switch on the core xCoreID.  The switch is held
+	 * pending by the calling core until it leaves its critical section.
+	 */
+	static void prvYieldCore( const BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called when the task pxTCB becomes ready to run.  If pxTCB has a higher
+	 * priority than a task running on one of the cores it is allowed to run on
+	 * then the core running the lowest priority such task is requested to
+	 * yield.  Must be called from a critical section, or with the scheduler
+	 * suspended by the calling task, so no core can switch tasks meanwhile.
+	 */
+	static void prvYieldForTask( const TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif /* configNUM_CORES */
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -990,8 +1182,8 @@ UBaseType_t x;
 
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
 	{
-		pxNewTCB->ulNotifiedValue = 0;
-		pxNewTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+		memset( ( void * ) &( pxNewTCB->ulNotifiedValue[ 0 ] ), 0x00, sizeof( pxNewTCB->ulNotifiedValue ) );
+		memset( ( void * ) &( pxNewTCB->ucNotifyState[ 0 ] ), taskNOT_WAITING_NOTIFICATION, sizeof( pxNewTCB->ucNotifyState ) );
 	}
 	#endif
 
@@ -1008,6 +1200,13 @@ UBaseType_t x;
 	}
 	#endif
 
+	#if( configNUM_CORES > 1 )
+	{
+		pxNewTCB->xTaskRunState = taskTASK_NOT_RUNNING;
+		pxNewTCB->uxCoreAffinityMask = tskNO_AFFINITY;
+	}
+	#endif
+
 	/* Initialize the TCB stack to look as if the task was already running,
 	but had been interrupted by the scheduler.  The return address is set
 	to the start of the task function. Once the stack has been initialised
@@ -1042,6 +1241,21 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 	taskENTER_CRITICAL();
 	{
 		uxCurrentNumberOfTasks++;
+
+		#if( configNUM_CORES > 1 )
+		{
+			/* The running task of each core is selected when the scheduler
+			starts, so there is no current task to update here. */
+			if( uxCurrentNumberOfTasks == ( UBaseType_t ) 1 )
+			{
+				prvInitialiseTaskLists();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
 		if( pxCurrentTCB == NULL )
 		{
 			/* There are no other tasks, or all the other tasks are in
@@ -1081,6 +1295,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
+		#endif /* configNUM_CORES */
 
 		uxTaskNumber++;
 
@@ -1095,26 +1310,46 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		prvAddTaskToReadyList( pxNewTCB );
 
 		portSETUP_TCB( pxNewTCB );
+
+		#if( configNUM_CORES > 1 )
+		{
+			/* The new task may preempt a lower priority task on any of the
+			cores it is allowed to run on.  The yield is performed when the
+			critical section is exited. */
+			if( xSchedulerRunning != pdFALSE )
+			{
+				prvYieldForTask( pxNewTCB );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
 	}
 	taskEXIT_CRITICAL();
 
-	if( xSchedulerRunning != pdFALSE )
+	#if( configNUM_CORES == 1 )
 	{
-		/* If the created task is of a higher priority than the current task
-		then it should run now. */
-		if( pxCurrentTCB->uxPriority < pxNewTCB->uxPriority )
+		if( xSchedulerRunning != pdFALSE )
 		{
-			taskYIELD_IF_USING_PREEMPTION();
+			/* If the created task is of a higher priority than the current task
+			then it should run now. */
+			if( pxCurrentTCB->uxPriority < pxNewTCB->uxPriority )
+			{
+				taskYIELD_IF_USING_PREEMPTION();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
 	}
-	else
-	{
-		mtCOVERAGE_TEST_MARKER();
-	}
+	#endif /* configNUM_CORES */
 }
 /*-----------------------------------------------------------*/
 
@@ -1156,6 +1391,31 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			not return. */
 			uxTaskNumber++;
 
+			#if( configNUM_CORES > 1 )
+			if( taskTASK_IS_RUNNING( pxTCB ) )
+			{
+				/* The task is running on this or another core, so its memory
+				cannot be freed until the core has switched to another task.
+				The idle task only frees a task from the termination list once
+				it is no longer running. */
+				vListInsertEnd( &xTasksWaitingTermination, &( pxTCB->xStateListItem ) );
+				++uxDeletedTasksWaitingCleanUp;
+
+				if( pxTCB->xTaskRunState == portGET_CORE_ID() )
+				{
+					configASSERT( uxSchedulerSuspended == 0 );
+					portPRE_TASK_DELETE_HOOK( pxTCB, &xYieldPending );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* The yield happens when the critical section is exited if the
+				task is running on this core. */
+				prvYieldCore( pxTCB->xTaskRunState );
+			}
+			#else
 			if( pxTCB == pxCurrentTCB )
 			{
 				/* A task is deleting itself.  This cannot complete within the
@@ -1177,6 +1437,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				required. */
 				portPRE_TASK_DELETE_HOOK( pxTCB, &xYieldPending );
 			}
+			#endif /* configNUM_CORES */
 			else
 			{
 				--uxCurrentNumberOfTasks;
@@ -1192,19 +1453,24 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		taskEXIT_CRITICAL();
 
 		/* Force a reschedule if it is the currently running task that has just
-		been deleted. */
-		if( xSchedulerRunning != pdFALSE )
+		been deleted.  When there is more than one core the yield has already
+		been requested from within the critical section. */
+		#if( configNUM_CORES == 1 )
 		{
-			if( pxTCB == pxCurrentTCB )
-			{
-				configASSERT( uxSchedulerSuspended == 0 );
-				portYIELD_WITHIN_API();
-			}
-			else
+			if( xSchedulerRunning != pdFALSE )
 			{
-				mtCOVERAGE_TEST_MARKER();
+				if( pxTCB == pxCurrentTCB )
+				{
+					configASSERT( uxSchedulerSuspended == 0 );
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
 		}
+		#endif /* configNUM_CORES */
 	}
 
 #endif /* INCLUDE_vTaskDelete */
@@ -1219,10 +1485,14 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 		configASSERT( pxPreviousWakeTime );
 		configASSERT( ( xTimeIncrement > 0U ) );
-		configASSERT( uxSchedulerSuspended == 0 );
 
 		vTaskSuspendAll();
 		{
+			/* The scheduler must not already have been suspended by the
+			calling task.  uxSchedulerSuspended is only checked once this core
+			holds it, as another core may suspend the scheduler too. */
+			configASSERT( uxSchedulerSuspended == 1 );
+
 			/* Minor optimisation.  The tick count cannot change in this
 			block. */
 			const TickType_t xConstTickCount = xTickCount;
@@ -1303,9 +1573,9 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		/* A delay time of zero just forces a reschedule. */
 		if( xTicksToDelay > ( TickType_t ) 0U )
 		{
-			configASSERT( uxSchedulerSuspended == 0 );
 			vTaskSuspendAll();
 			{
+				configASSERT( uxSchedulerSuspended == 1 );
 				traceTASK_DELAY();
 
 				/* A task that is removed from the event list while the
@@ -1349,9 +1619,10 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 		configASSERT( pxTCB );
 
-		if( pxTCB == pxCurrentTCB )
+		if( taskTASK_IS_RUNNING( pxTCB ) )
 		{
-			/* The task calling this function is querying its own state. */
+			/* The task calling this function is querying its own state, or
+			the task is running on another core. */
 			eReturn = eRunning;
 		}
 		else
@@ -1362,7 +1633,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			}
 			taskEXIT_CRITICAL();
 
-			if( ( pxStateList == pxDelayedTaskList ) || ( pxStateList == pxOverflowDelayedTaskList ) )
+			if( taskLIST_IS_DELAYED_LIST( pxStateList ) )
 			{
 				/* The task being queried is referenced from one of the Blocked
 				lists. */
@@ -1457,14 +1728,14 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		http://www.freertos.org/RTOS-Cortex-M3-M4.html */
 		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-		uxSavedInterruptState = portSET_INTERRUPT_MASK_FROM_ISR();
+		uxSavedInterruptState = taskENTER_CRITICAL_FROM_ISR();
 		{
 			/* If null is passed in here then it is the priority of the calling
 			task that is being queried. */
 			pxTCB = prvGetTCBFromHandle( xTask );
 			uxReturn = pxTCB->uxPriority;
 		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptState );
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptState );
 
 		return uxReturn;
 	}
@@ -1616,14 +1887,46 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					mtCOVERAGE_TEST_MARKER();
 				}
 
-				if( xYieldRequired != pdFALSE )
+				#if( configNUM_CORES > 1 )
 				{
-					taskYIELD_IF_USING_PREEMPTION();
+					/* xYieldRequired only compares against the task running on
+					this core.  Instead a ready task that has been raised may
+					preempt any core, and a running task that has been lowered
+					may have to give up its own core. */
+					if( taskTASK_IS_RUNNING( pxTCB ) )
+					{
+						if( uxNewPriority < uxCurrentBasePriority )
+						{
+							taskYIELD_CORE_IF_USING_PREEMPTION( pxTCB->xTaskRunState );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else if( ( uxNewPriority > uxCurrentBasePriority ) && ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE ) )
+					{
+						prvYieldForTask( pxTCB );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					( void ) xYieldRequired;
 				}
-				else
+				#else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					if( xYieldRequired != pdFALSE )
+					{
+						taskYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
+				#endif /* configNUM_CORES */
 
 				/* Remove compiler warning about unused variables when the port
 				optimised task selection is not being used. */
@@ -1636,6 +1939,79 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 #endif /* INCLUDE_vTaskPrioritySet */
 /*-----------------------------------------------------------*/
 
+#if( configNUM_CORES > 1 )
+
+	void vTaskCoreAffinitySet( TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask )
+	{
+	TCB_t *pxTCB;
+
+		/* The task must be allowed to run on at least one core. */
+		configASSERT( ( uxCoreAffinityMask & ( ( ( UBaseType_t ) 1U << ( UBaseType_t ) configNUM_CORES ) - ( UBaseType_t ) 1U ) ) != 0U );
+
+		taskENTER_CRITICAL();
+		{
+			/* If null is passed in here then it is the affinity of the calling
+			task that is being changed. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+			pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+
+			if( xSchedulerRunning != pdFALSE )
+			{
+				if( taskTASK_IS_RUNNING( pxTCB ) )
+				{
+					/* The core the task is running on has to select another
+					task if it is no longer in the task's affinity.  The task
+					is then selected by one of the cores it can run on when
+					that core next yields. */
+					if( ( uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) pxTCB->xTaskRunState ) ) == 0U )
+					{
+						prvYieldCore( pxTCB->xTaskRunState );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+				{
+					/* A ready task may now be able to preempt a core it could
+					not run on before. */
+					prvYieldForTask( pxTCB );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxTaskCoreAffinityGet( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB;
+	UBaseType_t uxReturn;
+
+		taskENTER_CRITICAL();
+		{
+			/* If null is passed in here then it is the affinity of the calling
+			task that is being queried. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+			uxReturn = pxTCB->uxCoreAffinityMask;
+		}
+		taskEXIT_CRITICAL();
+
+		return uxReturn;
+	}
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskSuspend == 1 )
 
 	void vTaskSuspend( TaskHandle_t xTaskToSuspend )
@@ -1675,32 +2051,77 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 			#if( configUSE_TASK_NOTIFICATIONS == 1 )
 			{
-				if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
+			UBaseType_t uxIndex;
+
+				for( uxIndex = 0; uxIndex < ( UBaseType_t ) configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
 				{
-					/* The task was blocked to wait for a notification, but is
-					now suspended, so no notification was received. */
-					pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+					if( pxTCB->ucNotifyState[ uxIndex ] == taskWAITING_NOTIFICATION )
+					{
+						/* The task was blocked to wait for a notification, but is
+						now suspended, so no notification was received. */
+						pxTCB->ucNotifyState[ uxIndex ] = taskNOT_WAITING_NOTIFICATION;
+					}
 				}
 			}
 			#endif
+
+			#if( configNUM_CORES > 1 )
+			{
+				/* The task may be running on another core, so the checks that
+				follow the critical section for a single core are made before
+				the lists can change again. */
+				if( xSchedulerRunning != pdFALSE )
+				{
+					prvResetNextTaskUnblockTime();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( taskTASK_IS_RUNNING( pxTCB ) )
+				{
+					if( pxTCB->xTaskRunState == portGET_CORE_ID() )
+					{
+						/* The calling task has just been suspended. */
+						configASSERT( uxSchedulerSuspended == 0 );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					prvYieldCore( pxTCB->xTaskRunState );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configNUM_CORES */
 		}
 		taskEXIT_CRITICAL();
 
-		if( xSchedulerRunning != pdFALSE )
+		#if( configNUM_CORES == 1 )
 		{
-			/* Reset the next expected unblock time in case it referred to the
-			task that is now in the Suspended state. */
-			taskENTER_CRITICAL();
+			if( xSchedulerRunning != pdFALSE )
 			{
-				prvResetNextTaskUnblockTime();
+				/* Reset the next expected unblock time in case it referred to the
+				task that is now in the Suspended state. */
+				taskENTER_CRITICAL();
+				{
+					prvResetNextTaskUnblockTime();
+				}
+				taskEXIT_CRITICAL();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
 			}
-			taskEXIT_CRITICAL();
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
 		}
+		#endif /* configNUM_CORES */
 
+		#if( configNUM_CORES == 1 )
 		if( pxTCB == pxCurrentTCB )
 		{
 			if( xSchedulerRunning != pdFALSE )
@@ -1732,6 +2153,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
+		#endif /* configNUM_CORES */
 	}
 
 #endif /* INCLUDE_vTaskSuspend */
@@ -1808,17 +2230,25 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					prvAddTaskToReadyList( pxTCB );
 
 					/* A higher priority task may have just been resumed. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+					#if( configNUM_CORES > 1 )
 					{
-						/* This yield may not cause the task just resumed to run,
-						but will leave the lists in the correct state for the
-						next yield. */
-						taskYIELD_IF_USING_PREEMPTION();
+						prvYieldForTask( pxTCB );
 					}
-					else
+					#else
 					{
-						mtCOVERAGE_TEST_MARKER();
+						if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+						{
+							/* This yield may not cause the task just resumed to run,
+							but will leave the lists in the correct state for the
+							next yield. */
+							taskYIELD_IF_USING_PREEMPTION();
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 					}
+					#endif /* configNUM_CORES */
 				}
 				else
 				{
@@ -1865,7 +2295,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		http://www.freertos.org/RTOS-Cortex-M3-M4.html */
 		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 		{
 			if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
 			{
@@ -1876,17 +2306,30 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				{
 					/* Ready lists can be accessed so move the task from the
 					suspended list to the ready list directly. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
-					{
-						xYieldRequired = pdTRUE;
-					}
-					else
+					#if( configNUM_CORES == 1 )
 					{
-						mtCOVERAGE_TEST_MARKER();
+						if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+						{
+							xYieldRequired = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 					}
+					#endif
 
 					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
 					prvAddTaskToReadyList( pxTCB );
+
+					#if( configNUM_CORES > 1 )
+					{
+						/* Only a yield of the interrupted core is left to the
+						caller. */
+						prvYieldForTask( pxTCB );
+						xYieldRequired = xYieldPending;
+					}
+					#endif
 				}
 				else
 				{
@@ -1901,7 +2344,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 		return xYieldRequired;
 	}
@@ -1952,6 +2395,68 @@ BaseType_t xReturn;
 	}
 	#endif /* configSUPPORT_STATIC_ALLOCATION */
 
+	#if( configNUM_CORES > 1 )
+	{
+	BaseType_t xCoreID;
+	char cIdleName[ configMAX_TASK_NAME_LEN ];
+	UBaseType_t x;
+
+		/* Each core has its own idle task, which is only allowed to run on
+		that core, so every core always has a task to run.  The idle task of
+		core 0 is the one created above, and is the only one that can be
+		created using application provided RAM.  The parameter of each idle
+		task is the ID of its core. */
+		if( xReturn == pdPASS )
+		{
+			vTaskCoreAffinitySet( xIdleTaskHandles[ 0 ], ( UBaseType_t ) 1U );
+		}
+
+		for( xCoreID = 1; ( xCoreID < ( BaseType_t ) configNUM_CORES ) && ( xReturn == pdPASS ); xCoreID++ )
+		{
+			/* The idle task names are the configured name followed by the
+			core ID, truncated to fit. */
+			for( x = ( UBaseType_t ) 0; x < ( UBaseType_t ) configMAX_TASK_NAME_LEN; x++ )
+			{
+				cIdleName[ x ] = configIDLE_TASK_NAME[ x ];
+
+				if( cIdleName[ x ] == 0x00 )
+				{
+					break;
+				}
+			}
+
+			if( x > ( UBaseType_t ) ( configMAX_TASK_NAME_LEN - 3 ) )
+			{
+				x = ( UBaseType_t ) ( configMAX_TASK_NAME_LEN - 3 );
+			}
+
+			if( xCoreID >= 10 )
+			{
+				cIdleName[ x++ ] = ( char ) ( '0' + ( xCoreID / 10 ) );
+			}
+
+			cIdleName[ x++ ] = ( char ) ( '0' + ( xCoreID % 10 ) );
+			cIdleName[ x ] = 0x00;
+
+			xReturn = xTaskCreate(	prvIdleTask,
+									cIdleName,
+									configMINIMAL_STACK_SIZE,
+									( void * ) ( portPOINTER_SIZE_TYPE ) xCoreID,
+									( tskIDLE_PRIORITY | portPRIVILEGE_BIT ),
+									&( xIdleTaskHandles[ xCoreID ] ) ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
+
+			if( xReturn == pdPASS )
+			{
+				vTaskCoreAffinitySet( xIdleTaskHandles[ xCoreID ], ( UBaseType_t ) 1U << xCoreID );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	#endif /* configNUM_CORES */
+
 	#if ( configUSE_TIMERS == 1 )
 	{
 		if( xReturn == pdPASS )
@@ -1995,6 +2500,28 @@ BaseType_t xReturn;
 		xSchedulerRunning = pdTRUE;
 		xTickCount = ( TickType_t ) 0U;
 
+		#if ( configUSE_TIMING_WHEEL == 1 )
+		{
+			/* portMAX_DELAY ticks after xTimingWheelTick is the value used for
+			xNextTaskUnblockTime when no tasks are blocked. */
+			xTimingWheelTick = ( TickType_t ) 0U;
+		}
+		#endif /* configUSE_TIMING_WHEEL */
+
+		#if( configNUM_CORES > 1 )
+		{
+		BaseType_t xCoreID;
+
+			/* Select the task each core runs first.  The other cores are not
+			started until xPortStartScheduler() is called, so the locks are
+			not needed yet. */
+			for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUM_CORES; xCoreID++ )
+			{
+				prvSelectHighestPriorityTask( xCoreID );
+			}
+		}
+		#endif /* configNUM_CORES */
+
 		/* If configGENERATE_RUN_TIME_STATS is defined then the following
 		macro must be defined to configure the timer/counter used to generate
 		the run time counter time base.   NOTE:  If configGENERATE_RUN_TIME_STATS
@@ -2042,11 +2569,42 @@ void vTaskEndScheduler( void )
 
 void vTaskSuspendAll( void )
 {
-	/* A critical section is not required as the variable is of type
-	BaseType_t.  Please read Richard Barry's reply in the following link to a
-	post in the FreeRTOS support forum before reporting this as a bug! -
-	http://goo.gl/wu4acr */
-	++uxSchedulerSuspended;
+	#if( configNUM_CORES > 1 )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		if( xSchedulerRunning != pdFALSE )
+		{
+			/* The task lock is held until the scheduler is resumed, so only
+			one core at a time can have the scheduler suspended, and no other
+			core can enter a critical section meanwhile.  The ISR lock keeps
+			interrupts on the other cores from reading uxSchedulerSuspended
+			while it is being changed.  Interrupts are masked so this task is
+			not moved to another core between taking the task lock and
+			incrementing uxSchedulerSuspended. */
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+			portGET_TASK_LOCK();
+			portGET_ISR_LOCK();
+			{
+				++uxSchedulerSuspended;
+			}
+			portRELEASE_ISR_LOCK();
+			portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+		}
+		else
+		{
+			++uxSchedulerSuspended;
+		}
+	}
+	#else
+	{
+		/* A critical section is not required as the variable is of type
+		BaseType_t.  Please read Richard Barry's reply in the following link to a
+		post in the FreeRTOS support forum before reporting this as a bug! -
+		http://goo.gl/wu4acr */
+		++uxSchedulerSuspended;
+	}
+	#endif /* configNUM_CORES */
 }
 /*----------------------------------------------------------*/
 
@@ -2131,6 +2689,21 @@ BaseType_t xAlreadyYielded = pdFALSE;
 	{
 		--uxSchedulerSuspended;
 
+		#if( configNUM_CORES > 1 )
+		{
+			/* Release the task lock taken by vTaskSuspendAll().  The lock is
+			still held by the critical section. */
+			if( xSchedulerRunning != pdFALSE )
+			{
+				portRELEASE_TASK_LOCK();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
+
 		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 		{
 			if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
@@ -2146,14 +2719,22 @@ BaseType_t xAlreadyYielded = pdFALSE;
 
 					/* If the moved task has a priority higher than the current
 					task then a yield must be performed. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+					#if( configNUM_CORES > 1 )
 					{
-						xYieldPending = pdTRUE;
+						prvYieldForTask( pxTCB );
 					}
-					else
+					#else
 					{
-						mtCOVERAGE_TEST_MARKER();
+						if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+						{
+							xYieldPending = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 					}
+					#endif /* configNUM_CORES */
 				}
 
 				if( pxTCB != NULL )
@@ -2423,15 +3004,31 @@ TCB_t *pxTCB;
 			} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
 			/* Search the delayed lists. */
-			if( pxTCB == NULL )
+			#if ( configUSE_TIMING_WHEEL == 0 )
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
-			}
+				if( pxTCB == NULL )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+				}
 
-			if( pxTCB == NULL )
+				if( pxTCB == NULL )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+				}
+			}
+			#else
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+				for( uxQueue = ( UBaseType_t ) 0U; ( uxQueue < ( UBaseType_t ) ( 2 * configTIMING_WHEEL_SLOTS ) ) && ( pxTCB == NULL ); uxQueue++ )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( &( xTimingWheel[ uxQueue / configTIMING_WHEEL_SLOTS ][ uxQueue % configTIMING_WHEEL_SLOTS ] ), pcNameToQuery );
+				}
+
+				if( pxTCB == NULL )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( &xTimingWheelFarList, pcNameToQuery );
+				}
 			}
+			#endif /* configUSE_TIMING_WHEEL */
 
 			#if ( INCLUDE_vTaskSuspend == 1 )
 			{
@@ -2483,8 +3080,21 @@ TCB_t *pxTCB;
 
 				/* Fill in an TaskStatus_t structure with information on each
 				task in the Blocked state. */
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+				#if ( configUSE_TIMING_WHEEL == 0 )
+				{
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+				}
+				#else
+				{
+					for( uxQueue = ( UBaseType_t ) 0U; uxQueue < ( UBaseType_t ) ( 2 * configTIMING_WHEEL_SLOTS ); uxQueue++ )
+					{
+						uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xTimingWheel[ uxQueue / configTIMING_WHEEL_SLOTS ][ uxQueue % configTIMING_WHEEL_SLOTS ] ), eBlocked );
+					}
+
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xTimingWheelFarList, eBlocked );
+				}
+				#endif /* configUSE_TIMING_WHEEL */
 
 				#if( INCLUDE_vTaskDelete == 1 )
 				{
@@ -2559,7 +3169,7 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 		/* Correct the tick count value after a period during which the tick
 		was suppressed.  Note this does *not* call the tick hook function for
 		each stepped tick. */
-		configASSERT( ( xTickCount + xTicksToJump ) <= xNextTaskUnblockTime );
+		configASSERT( taskTICK_IS_BEFORE_OR_AT( xTickCount + xTicksToJump, xNextTaskUnblockTime ) );
 		xTickCount += xTicksToJump;
 		traceINCREASE_TICK_COUNT( xTicksToJump );
 	}
@@ -2612,7 +3222,13 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 
 				/* A task being unblocked cannot cause an immediate context
 				switch if preemption is turned off. */
-				#if (  configUSE_PREEMPTION == 1 )
+				#if( configNUM_CORES > 1 )
+				{
+					/* A yield of this core is held pending until the scheduler
+					is unsuspended. */
+					prvYieldForTask( pxTCB );
+				}
+				#elif (  configUSE_PREEMPTION == 1 )
 				{
 					/* Preemption is on, but a context switch should only be
 					performed if the unblocked task has a priority that is
@@ -2645,9 +3261,18 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 
 BaseType_t xTaskIncrementTick( void )
 {
+#if ( configUSE_TIMING_WHEEL == 0 )
 TCB_t * pxTCB;
 TickType_t xItemValue;
+#endif
 BaseType_t xSwitchRequired = pdFALSE;
+#if( configNUM_CORES > 1 )
+UBaseType_t uxSavedInterruptStatus;
+
+	/* Interrupts on the other cores may access the lists, and a task on
+	another core may be in a critical section. */
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+#endif
 
 	/* Called by the portable layer each time a tick interrupt occurs.
 	Increments the tick then checks to see if the new tick value will cause any
@@ -2672,92 +3297,169 @@ BaseType_t xSwitchRequired = pdFALSE;
 			mtCOVERAGE_TEST_MARKER();
 		}
 
-		/* See if this tick has made a timeout expire.  Tasks are stored in
-		the	queue in the order of their wake time - meaning once one task
-		has been found whose block time has not expired there is no need to
-		look any further down the list. */
-		if( xConstTickCount >= xNextTaskUnblockTime )
+		#if ( configUSE_TIMING_WHEEL == 0 )
 		{
-			for( ;; )
+			/* See if this tick has made a timeout expire.  Tasks are stored in
+			the	queue in the order of their wake time - meaning once one task
+			has been found whose block time has not expired there is no need to
+			look any further down the list. */
+			if( xConstTickCount >= xNextTaskUnblockTime )
 			{
-				if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
-				{
-					/* The delayed list is empty.  Set xNextTaskUnblockTime
-					to the maximum possible value so it is extremely
-					unlikely that the
-					if( xTickCount >= xNextTaskUnblockTime ) test will pass
-					next time through. */
-					xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-					break;
-				}
-				else
+				for( ;; )
 				{
-					/* The delayed list is not empty, get the value of the
-					item at the head of the delayed list.  This is the time
-					at which the task at the head of the delayed list must
-					be removed from the Blocked state. */
-					pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
-					xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
-
-					if( xConstTickCount < xItemValue )
+					if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
 					{
-						/* It is not time to unblock this item yet, but the
-						item value is the time at which the task at the head
-						of the blocked list must be removed from the Blocked
-						state -	so record the item value in
-						xNextTaskUnblockTime. */
-						xNextTaskUnblockTime = xItemValue;
+						/* The delayed list is empty.  Set xNextTaskUnblockTime
+						to the maximum possible value so it is extremely
+						unlikely that the
+						if( xTickCount >= xNextTaskUnblockTime ) test will pass
+						next time through. */
+						xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 						break;
 					}
 					else
 					{
-						mtCOVERAGE_TEST_MARKER();
-					}
-
-					/* It is time to remove the item from the Blocked state. */
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-
-					/* Is the task waiting on an event also?  If so remove
-					it from the event list. */
-					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
-					{
-						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
+						/* The delayed list is not empty, get the value of the
+						item at the head of the delayed list.  This is the time
+						at which the task at the head of the delayed list must
+						be removed from the Blocked state. */
+						pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
+						xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+						if( xConstTickCount < xItemValue )
+						{
+							/* It is not time to unblock this item yet, but the
+							item value is the time at which the task at the head
+							of the blocked list must be removed from the Blocked
+							state -	so record the item value in
+							xNextTaskUnblockTime. */
+							xNextTaskUnblockTime = xItemValue;
+							break;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 
-					/* Place the unblocked task into the appropriate ready
-					list. */
-					prvAddTaskToReadyList( pxTCB );
+						/* It is time to remove the item from the Blocked state. */
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
 
-					/* A task being unblocked cannot cause an immediate
-					context switch if preemption is turned off. */
-					#if (  configUSE_PREEMPTION == 1 )
-					{
-						/* Preemption is on, but a context switch should
-						only be performed if the unblocked task has a
-						priority that is equal to or higher than the
-						currently executing task. */
-						if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+						/* Is the task waiting on an event also?  If so remove
+						it from the event list. */
+						if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
 						{
-							xSwitchRequired = pdTRUE;
+							( void ) uxListRemove( &( pxTCB->xEventListItem ) );
 						}
 						else
 						{
 							mtCOVERAGE_TEST_MARKER();
 						}
+
+						/* Place the unblocked task into the appropriate ready
+						list. */
+						prvAddTaskToReadyList( pxTCB );
+
+						/* A task being unblocked cannot cause an immediate
+						context switch if preemption is turned off. */
+						#if( configNUM_CORES > 1 )
+						{
+							/* A yield of this core is picked up from
+							xYieldPending below. */
+							prvYieldForTask( pxTCB );
+						}
+						#elif (  configUSE_PREEMPTION == 1 )
+						{
+							/* Preemption is on, but a context switch should
+							only be performed if the unblocked task has a
+							priority that is equal to or higher than the
+							currently executing task. */
+							if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+							{
+								xSwitchRequired = pdTRUE;
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						#endif /* configUSE_PREEMPTION */
+					}
+				}
+			}
+		}
+		#else
+		{
+			/* See if this tick has made a timeout expire.  The ticks between
+			the last tick the wheel processed and xNextTaskUnblockTime have
+			nothing to process, so are skipped. */
+			if( taskTICK_IS_BEFORE_OR_AT( xNextTaskUnblockTime, xConstTickCount ) )
+			{
+				xTimingWheelTick = xNextTaskUnblockTime - ( TickType_t ) 1;
+
+				while( xTimingWheelTick != xConstTickCount )
+				{
+					xTimingWheelTick++;
+
+					if( prvTimingWheelProcessTick( xTimingWheelTick ) != pdFALSE )
+					{
+						xSwitchRequired = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
 					}
-					#endif /* configUSE_PREEMPTION */
 				}
+
+				xNextTaskUnblockTime = prvTimingWheelNextWake();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
 			}
 		}
+		#endif /* configUSE_TIMING_WHEEL */
 
 		/* Tasks of equal priority to the currently running task will share
 		processing time (time slice) if preemption is on, and the application
 		writer has not explicitly turned time slicing off. */
-		#if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+		#if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) && ( configNUM_CORES > 1 ) )
+		{
+		BaseType_t xCoreID, xOtherCoreID;
+		UBaseType_t uxPriority, uxRunning;
+
+			/* A core only has to yield if a task of the priority it is running
+			is ready but not running on any core. */
+			for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUM_CORES; xCoreID++ )
+			{
+				uxPriority = pxCurrentTCBs[ xCoreID ]->uxPriority;
+				uxRunning = 0;
+
+				for( xOtherCoreID = 0; xOtherCoreID < ( BaseType_t ) configNUM_CORES; xOtherCoreID++ )
+				{
+					if( pxCurrentTCBs[ xOtherCoreID ]->uxPriority == uxPriority )
+					{
+						uxRunning++;
+					}
+				}
+
+				if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxPriority ] ) ) > uxRunning )
+				{
+					if( xCoreID == portGET_CORE_ID() )
+					{
+						xSwitchRequired = pdTRUE;
+					}
+					else
+					{
+						prvYieldCore( xCoreID );
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		#elif ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
 		{
 			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
 			{
@@ -2811,6 +3513,12 @@ BaseType_t xSwitchRequired = pdFALSE;
 	}
 	#endif /* configUSE_PREEMPTION */
 
+	#if( configNUM_CORES > 1 )
+	{
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+	}
+	#endif
+
 	return xSwitchRequired;
 }
 /*-----------------------------------------------------------*/
@@ -2905,27 +3613,90 @@ BaseType_t xSwitchRequired = pdFALSE;
 #endif /* configUSE_APPLICATION_TASK_TAG */
 /*-----------------------------------------------------------*/
 
-void vTaskSwitchContext( void )
+#if( configNUM_CORES > 1 )
+
+void vTaskSwitchContext( BaseType_t xCoreID )
 {
-	if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
+	/* The task lock prevents the lists changing under a task on another core
+	that has suspended the scheduler, and the ISR lock prevents them changing
+	under a critical section or an interrupt on another core.  The locks are
+	recursive, so a core that suspended the scheduler itself does not wait on
+	them here. */
+	portGET_TASK_LOCK();
+	portGET_ISR_LOCK();
 	{
-		/* The scheduler is currently suspended - do not allow a context
-		switch. */
-		xYieldPending = pdTRUE;
-	}
-	else
-	{
-		xYieldPending = pdFALSE;
-		traceTASK_SWITCHED_OUT();
+		/* A context switch must not be performed from within a critical
+		section. */
+		configASSERT( uxCriticalNestings[ xCoreID ] == 0U );
 
-		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
 		{
-				#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
-					portALT_GET_RUN_TIME_COUNTER_VALUE( ulTotalRunTime );
-				#else
-					ulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
-				#endif
-
+			/* The scheduler is currently suspended by the task running on
+			this core - do not allow a context switch. */
+			xYieldPendings[ xCoreID ] = pdTRUE;
+		}
+		else
+		{
+			xYieldPendings[ xCoreID ] = pdFALSE;
+			traceTASK_SWITCHED_OUT();
+
+			#if ( configGENERATE_RUN_TIME_STATS == 1 )
+			{
+					#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+						portALT_GET_RUN_TIME_COUNTER_VALUE( ulTotalRunTime );
+					#else
+						ulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+					#endif
+
+					/* Each core keeps the time its own running task was
+					switched in. */
+					if( ulTotalRunTime > ulTaskSwitchedInTime[ xCoreID ] )
+					{
+						pxCurrentTCBs[ xCoreID ]->ulRunTimeCounter += ( ulTotalRunTime - ulTaskSwitchedInTime[ xCoreID ] );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+					ulTaskSwitchedInTime[ xCoreID ] = ulTotalRunTime;
+			}
+			#endif /* configGENERATE_RUN_TIME_STATS */
+
+			/* Check for stack overflow, if configured. */
+			taskCHECK_FOR_STACK_OVERFLOW();
+
+			/* Select a new task to run on this core. */
+			prvSelectHighestPriorityTask( xCoreID );
+			traceTASK_SWITCHED_IN();
+		}
+	}
+	portRELEASE_ISR_LOCK();
+	portRELEASE_TASK_LOCK();
+}
+
+#else /* configNUM_CORES */
+
+void vTaskSwitchContext( void )
+{
+	if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
+	{
+		/* The scheduler is currently suspended - do not allow a context
+		switch. */
+		xYieldPending = pdTRUE;
+	}
+	else
+	{
+		xYieldPending = pdFALSE;
+		traceTASK_SWITCHED_OUT();
+
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+				#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+					portALT_GET_RUN_TIME_COUNTER_VALUE( ulTotalRunTime );
+				#else
+					ulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+				#endif
+
 				/* Add the amount of time the task has been running to the
 				accumulated time so far.  The time the task started running was
 				stored in ulTaskSwitchedInTime.  Note that there is no overflow
@@ -2976,6 +3747,185 @@ void vTaskSwitchContext( void )
 		#endif /* configUSE_NEWLIB_REENTRANT */
 	}
 }
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
+
+#if( configNUM_CORES > 1 )
+
+	static void prvSelectHighestPriorityTask( const BaseType_t xCoreID )
+	{
+	UBaseType_t uxTopPriority, x;
+	List_t *pxList;
+	ListItem_t *pxIterator;
+	TCB_t *pxTCB, *pxSelectedTCB = NULL;
+
+		/* The task that was running on this core can be selected again. */
+		if( pxCurrentTCBs[ xCoreID ] != NULL )
+		{
+			if( pxCurrentTCBs[ xCoreID ]->xTaskRunState == xCoreID )
+			{
+				pxCurrentTCBs[ xCoreID ]->xTaskRunState = taskTASK_NOT_RUNNING;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Find the highest priority list that contains ready tasks. */
+		#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+		{
+			while( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxTopReadyPriority ] ) ) )
+			{
+				configASSERT( uxTopReadyPriority );
+				--uxTopReadyPriority;
+			}
+
+			uxTopPriority = uxTopReadyPriority;
+		}
+		#else
+		{
+			portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );
+		}
+		#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+		/* The highest priority ready task may already be running on another
+		core, or may not be allowed to run on this one, in which case the
+		next task in the list, and then the next lower priority, is tried.
+		The search starts after the list's index so tasks of equal priority
+		get an equal share of the cores.  The idle task of this core always
+		qualifies, so the search ends at the idle priority at the latest. */
+		for( ;; )
+		{
+			pxList = &( pxReadyTasksLists[ uxTopPriority ] );
+			pxIterator = pxList->pxIndex;
+
+			for( x = ( UBaseType_t ) 0; x <= listCURRENT_LIST_LENGTH( pxList ); x++ )
+			{
+				pxIterator = pxIterator->pxNext;
+
+				if( pxIterator != ( ListItem_t * ) listGET_END_MARKER( pxList ) )
+				{
+					pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+					if( ( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING ) &&
+						( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U ) )
+					{
+						pxList->pxIndex = pxIterator;
+						pxSelectedTCB = pxTCB;
+						break;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			if( pxSelectedTCB != NULL )
+			{
+				break;
+			}
+
+			configASSERT( uxTopPriority > ( UBaseType_t ) tskIDLE_PRIORITY );
+			--uxTopPriority;
+		}
+
+		pxSelectedTCB->xTaskRunState = xCoreID;
+		pxCurrentTCBs[ xCoreID ] = pxSelectedTCB;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvYieldCore( const BaseType_t xCoreID )
+	{
+		/* The flag is cleared by vTaskSwitchContext() on the core.  A core
+		yielding itself does so when it leaves its critical section. */
+		xYieldPendings[ xCoreID ] = pdTRUE;
+
+		if( xCoreID != portGET_CORE_ID() )
+		{
+			portYIELD_CORE( xCoreID );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvYieldForTask( const TCB_t * const pxTCB )
+	{
+	#if( configUSE_PREEMPTION == 1 )
+	BaseType_t xCoreID, xLowestCoreID = -1;
+	BaseType_t xLowestPriority, xCorePriority;
+
+		if( taskTASK_IS_RUNNING( pxTCB ) == pdFALSE )
+		{
+			/* Only a core running a task of strictly lower priority is
+			preempted.  A core running its own idle task is preferred over one
+			running another idle priority task.  Cores that are already due to
+			yield will select the highest priority ready task anyway. */
+			xLowestPriority = ( BaseType_t ) pxTCB->uxPriority;
+
+			for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUM_CORES; xCoreID++ )
+			{
+				if( ( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U ) &&
+					( xYieldPendings[ xCoreID ] == pdFALSE ) )
+				{
+					if( pxCurrentTCBs[ xCoreID ] == ( TCB_t * ) xIdleTaskHandles[ xCoreID ] )
+					{
+						xCorePriority = -1;
+					}
+					else
+					{
+						xCorePriority = ( BaseType_t ) pxCurrentTCBs[ xCoreID ]->uxPriority;
+					}
+
+					if( xCorePriority < xLowestPriority )
+					{
+						xLowestPriority = xCorePriority;
+						xLowestCoreID = xCoreID;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			if( xLowestCoreID >= 0 )
+			{
+				prvYieldCore( xLowestCoreID );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	#else
+		/* A task that becomes ready only runs when a core next yields. */
+		( void ) pxTCB;
+	#endif /* configUSE_PREEMPTION */
+	}
+
+#endif /* configNUM_CORES */
 /*-----------------------------------------------------------*/
 
 void vTaskPlaceOnEventList( List_t * const pxEventList, const TickType_t xTicksToWait )
@@ -3086,21 +4036,51 @@ BaseType_t xReturn;
 		vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
 	}
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	#if( configNUM_CORES > 1 )
 	{
-		/* Return true if the task removed from the event list has a higher
-		priority than the calling task.  This allows the calling task to know if
-		it should force a context switch now. */
-		xReturn = pdTRUE;
+		/* The core that suspended the scheduler yields for the pending ready
+		task, if needed, when it resumes the scheduler.  Otherwise return true
+		only if it is this core that has to yield, which prvYieldCore() has
+		also marked as pending. */
+		xReturn = pdFALSE;
 
-		/* Mark that a yield is pending in case the user is not using the
-		"xHigherPriorityTaskWoken" parameter to an ISR safe FreeRTOS function. */
-		xYieldPending = pdTRUE;
+		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+		{
+			prvYieldForTask( pxUnblockedTCB );
+
+			if( xYieldPending != pdFALSE )
+			{
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 	}
-	else
+	#else
 	{
-		xReturn = pdFALSE;
+		if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+		{
+			/* Return true if the task removed from the event list has a higher
+			priority than the calling task.  This allows the calling task to know if
+			it should force a context switch now. */
+			xReturn = pdTRUE;
+
+			/* Mark that a yield is pending in case the user is not using the
+			"xHigherPriorityTaskWoken" parameter to an ISR safe FreeRTOS function. */
+			xYieldPending = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
 	}
+	#endif /* configNUM_CORES */
 
 	#if( configUSE_TICKLESS_IDLE != 0 )
 	{
@@ -3143,14 +4123,23 @@ TCB_t *pxUnblockedTCB;
 	( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
 	prvAddTaskToReadyList( pxUnblockedTCB );
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	#if( configNUM_CORES > 1 )
 	{
-		/* The unblocked task has a priority above that of the calling task, so
-		a context switch is required.  This function is called with the
-		scheduler suspended so xYieldPending is set so the context switch
-		occurs immediately that the scheduler is resumed (unsuspended). */
-		xYieldPending = pdTRUE;
+		/* A yield of this core occurs when the scheduler is resumed. */
+		prvYieldForTask( pxUnblockedTCB );
 	}
+	#else
+	{
+		if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+		{
+			/* The unblocked task has a priority above that of the calling task, so
+			a context switch is required.  This function is called with the
+			scheduler suspended so xYieldPending is set so the context switch
+			occurs immediately that the scheduler is resumed (unsuspended). */
+			xYieldPending = pdTRUE;
+		}
+	}
+	#endif /* configNUM_CORES */
 }
 /*-----------------------------------------------------------*/
 
@@ -3294,7 +4283,8 @@ void vTaskMissedYield( void )
  */
 static portTASK_FUNCTION( prvIdleTask, pvParameters )
 {
-	/* Stop warnings. */
+	/* Stop warnings.  When there is more than one core pvParameters holds the
+	ID of the core the idle task runs on. */
 	( void ) pvParameters;
 
 	/** THIS IS THE RTOS IDLE TASK - WHICH IS CREATED AUTOMATICALLY WHEN THE
@@ -3308,8 +4298,20 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 	for( ;; )
 	{
 		/* See if any tasks have deleted themselves - if so then the idle task
-		is responsible for freeing the deleted task's TCB and stack. */
-		prvCheckTasksWaitingTermination();
+		is responsible for freeing the deleted task's TCB and stack.  Only the
+		idle task of core 0 does so when there is more than one core. */
+		#if( configNUM_CORES > 1 )
+		{
+			if( pvParameters == NULL )
+			{
+				prvCheckTasksWaitingTermination();
+			}
+		}
+		#else
+		{
+			prvCheckTasksWaitingTermination();
+		}
+		#endif /* configNUM_CORES */
 
 		#if ( configUSE_PREEMPTION == 0 )
 		{
@@ -3330,9 +4332,10 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 
 			A critical region is not required here as we are just reading from
 			the list, and an occasional incorrect value will not matter.  If
-			the ready list at the idle priority contains more than one task
-			then a task other than the idle task is ready to execute. */
-			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) 1 )
+			the ready list at the idle priority contains more tasks than there
+			are idle tasks then a task other than an idle task is ready to
+			execute. */
+			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUM_CORES )
 			{
 				taskYIELD();
 			}
@@ -3378,7 +4381,7 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 					/* Now the scheduler is suspended, the expected idle
 					time can be sampled again, and this time its value can
 					be used. */
-					configASSERT( xNextTaskUnblockTime >= xTickCount );
+					configASSERT( taskTICK_IS_BEFORE_OR_AT( xTickCount, xNextTaskUnblockTime ) );
 					xExpectedIdleTime = prvGetExpectedIdleTime();
 
 					/* Define the following macro to set xExpectedIdleTime to 0
@@ -3513,8 +4516,24 @@ UBaseType_t uxPriority;
 		vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
 	}
 
-	vListInitialise( &xDelayedTaskList1 );
-	vListInitialise( &xDelayedTaskList2 );
+	#if ( configUSE_TIMING_WHEEL == 0 )
+	{
+		vListInitialise( &xDelayedTaskList1 );
+		vListInitialise( &xDelayedTaskList2 );
+	}
+	#else
+	{
+		for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configTIMING_WHEEL_SLOTS; uxPriority++ )
+		{
+			vListInitialise( &( xTimingWheel[ 0 ][ uxPriority ] ) );
+			vListInitialise( &( xTimingWheel[ 1 ][ uxPriority ] ) );
+		}
+
+		vListInitialise( &xTimingWheelFarList );
+		memset( ( void * ) ulTimingWheelMap, 0x00, sizeof( ulTimingWheelMap ) );
+	}
+	#endif /* configUSE_TIMING_WHEEL */
+
 	vListInitialise( &xPendingReadyList );
 
 	#if ( INCLUDE_vTaskDelete == 1 )
@@ -3529,10 +4548,14 @@ UBaseType_t uxPriority;
 	}
 	#endif /* INCLUDE_vTaskSuspend */
 
-	/* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
-	using list2. */
-	pxDelayedTaskList = &xDelayedTaskList1;
-	pxOverflowDelayedTaskList = &xDelayedTaskList2;
+	#if ( configUSE_TIMING_WHEEL == 0 )
+	{
+		/* Start with pxDelayedTaskList using list1 and the
+		pxOverflowDelayedTaskList using list2. */
+		pxDelayedTaskList = &xDelayedTaskList1;
+		pxOverflowDelayedTaskList = &xDelayedTaskList2;
+	}
+	#endif /* configUSE_TIMING_WHEEL */
 }
 /*-----------------------------------------------------------*/
 
@@ -3549,16 +4572,59 @@ static void prvCheckTasksWaitingTermination( void )
 		being called too often in the idle task. */
 		while( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U )
 		{
-			taskENTER_CRITICAL();
+			#if( configNUM_CORES > 1 )
 			{
-				pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) );
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-				--uxCurrentNumberOfTasks;
-				--uxDeletedTasksWaitingCleanUp;
+				/* A task deleted while running on another core stays in the
+				list until that core has switched away from it. */
+				pxTCB = NULL;
+
+				taskENTER_CRITICAL();
+				{
+					if( listLIST_IS_EMPTY( &xTasksWaitingTermination ) == pdFALSE )
+					{
+						pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) );
+
+						if( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING )
+						{
+							( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+							--uxCurrentNumberOfTasks;
+							--uxDeletedTasksWaitingCleanUp;
+						}
+						else
+						{
+							pxTCB = NULL;
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				taskEXIT_CRITICAL();
+
+				if( pxTCB != NULL )
+				{
+					prvDeleteTCB( pxTCB );
+				}
+				else
+				{
+					break;
+				}
 			}
-			taskEXIT_CRITICAL();
+			#else
+			{
+				taskENTER_CRITICAL();
+				{
+					pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) );
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					--uxCurrentNumberOfTasks;
+					--uxDeletedTasksWaitingCleanUp;
+				}
+				taskEXIT_CRITICAL();
 
-			prvDeleteTCB( pxTCB );
+				prvDeleteTCB( pxTCB );
+			}
+			#endif /* configNUM_CORES */
 		}
 	}
 	#endif /* INCLUDE_vTaskDelete */
@@ -3605,7 +4671,7 @@ static void prvCheckTasksWaitingTermination( void )
 		state is just set to whatever is passed in. */
 		if( eState != eInvalid )
 		{
-			if( pxTCB == pxCurrentTCB )
+			if( taskTASK_IS_RUNNING( pxTCB ) )
 			{
 				pxTaskStatus->eCurrentState = eRunning;
 			}
@@ -3798,45 +4864,408 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
-static void prvResetNextTaskUnblockTime( void )
-{
-TCB_t *pxTCB;
+#if ( configUSE_TIMING_WHEEL == 0 )
 
-	if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+	static void prvResetNextTaskUnblockTime( void )
 	{
-		/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-		the maximum possible value so it is	extremely unlikely that the
-		if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-		there is an item in the delayed list. */
-		xNextTaskUnblockTime = portMAX_DELAY;
+	TCB_t *pxTCB;
+
+		if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+		{
+			/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+			the maximum possible value so it is	extremely unlikely that the
+			if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+			there is an item in the delayed list. */
+			xNextTaskUnblockTime = portMAX_DELAY;
+		}
+		else
+		{
+			/* The new current delayed list is not empty, get the value of
+			the item at the head of the delayed list.  This is the time at
+			which the task at the head of the delayed list should be removed
+			from the Blocked state. */
+			( pxTCB ) = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
+			xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
+		}
 	}
-	else
+
+#else /* configUSE_TIMING_WHEEL */
+
+	static void prvResetNextTaskUnblockTime( void )
 	{
-		/* The new current delayed list is not empty, get the value of
-		the item at the head of the delayed list.  This is the time at
-		which the task at the head of the delayed list should be removed
-		from the Blocked state. */
-		( pxTCB ) = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
-		xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
+		prvTimingWheelSync();
+		xNextTaskUnblockTime = prvTimingWheelNextWake();
 	}
-}
+	/*-----------------------------------------------------------*/
+
+	static TickType_t prvTimingWheelNextWake( void )
+	{
+	TickType_t xNextWake = xTimingWheelTick - ( TickType_t ) 1;
+	TickType_t xBoundary;
+	UBaseType_t uxOffset;
+
+		/* The first level holds the tasks that wake in the
+		configTIMING_WHEEL_SLOTS ticks that follow xTimingWheelTick. */
+		uxOffset = prvTimingWheelFirstSlot( 0, ( UBaseType_t ) ( ( xTimingWheelTick + ( TickType_t ) 1 ) & taskWHEEL_SLOT_MASK ) );
+
+		if( uxOffset < ( UBaseType_t ) configTIMING_WHEEL_SLOTS )
+		{
+			xNextWake = xTimingWheelTick + ( TickType_t ) 1 + ( TickType_t ) uxOffset;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* A slot of the second level must be processed when the tick count
+		reaches the start of the slot, so its tasks are moved to the first
+		level. */
+		xBoundary = ( xTimingWheelTick & ~taskWHEEL_SLOT_MASK ) + ( TickType_t ) configTIMING_WHEEL_SLOTS;
+		uxOffset = prvTimingWheelFirstSlot( 1, ( UBaseType_t ) ( ( xBoundary / ( TickType_t ) configTIMING_WHEEL_SLOTS ) & taskWHEEL_SLOT_MASK ) );
+
+		if( uxOffset < ( UBaseType_t ) configTIMING_WHEEL_SLOTS )
+		{
+			xBoundary += ( TickType_t ) uxOffset * ( TickType_t ) configTIMING_WHEEL_SLOTS;
+
+			if( taskTICK_IS_BEFORE_OR_AT( xBoundary, xNextWake ) )
+			{
+				xNextWake = xBoundary;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( listLIST_IS_EMPTY( &xTimingWheelFarList ) == pdFALSE )
+		{
+			xBoundary = ( xTimingWheelTick | ( TickType_t ) ( taskWHEEL_SPAN - 1UL ) ) + ( TickType_t ) 1;
+
+			if( taskTICK_IS_BEFORE_OR_AT( xBoundary, xNextWake ) )
+			{
+				xNextWake = xBoundary;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* If no tasks are blocked xNextWake is left portMAX_DELAY ticks after
+		xTimingWheelTick. */
+		return xNextWake;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTimingWheelSync( void )
+	{
+		if( taskTICK_IS_BEFORE_OR_AT( xNextTaskUnblockTime, xTickCount ) == pdFALSE )
+		{
+			/* No tick up to and including the current tick count has
+			anything to process. */
+			xTimingWheelTick = xTickCount;
+		}
+		else
+		{
+			/* The tick count was stepped to xNextTaskUnblockTime while the
+			tick was suppressed, and that tick is yet to be processed. */
+			xTimingWheelTick = xNextTaskUnblockTime - ( TickType_t ) 1;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static UBaseType_t prvTimingWheelFirstSlot( const UBaseType_t uxLevel, const UBaseType_t uxStart )
+	{
+	/* Used to find the index of the lowest set bit in a word without relying
+	on a compiler intrinsic. */
+	static const uint8_t ucDeBruijnBitPosition[ 32 ] =
+	{
+		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+		31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+	};
+	UBaseType_t uxOffset = ( UBaseType_t ) 0U, uxSlot;
+	uint32_t ulBits;
+
+		while( uxOffset < ( UBaseType_t ) configTIMING_WHEEL_SLOTS )
+		{
+			uxSlot = ( uxStart + uxOffset ) & ( UBaseType_t ) taskWHEEL_SLOT_MASK;
+			ulBits = ulTimingWheelMap[ uxLevel ][ uxSlot >> 5 ] >> ( uxSlot & ( UBaseType_t ) 31 );
+
+			if( ulBits == 0UL )
+			{
+				/* No slot is set in the rest of this word. */
+				uxOffset += ( UBaseType_t ) 32 - ( uxSlot & ( UBaseType_t ) 31 );
+			}
+			else
+			{
+				/* Isolate the lowest set bit, then look up its position. */
+				ulBits = ( uint32_t ) ( ulBits & ( ( uint32_t ) 0U - ulBits ) );
+				ulBits = ( uint32_t ) ( ulBits * ( uint32_t ) 0x077CB531U );
+				uxOffset += ( UBaseType_t ) ucDeBruijnBitPosition[ ulBits >> 27 ];
+
+				if( uxOffset < ( UBaseType_t ) configTIMING_WHEEL_SLOTS )
+				{
+					uxSlot = ( uxStart + uxOffset ) & ( UBaseType_t ) taskWHEEL_SLOT_MASK;
+
+					if( listLIST_IS_EMPTY( &( xTimingWheel[ uxLevel ][ uxSlot ] ) ) == pdFALSE )
+					{
+						break;
+					}
+					else
+					{
+						/* The tasks in the slot were removed from the Blocked
+						state other than by the wheel. */
+						taskWHEEL_CLEAR_SLOT_BIT( uxLevel, uxSlot );
+						uxOffset++;
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+
+		return uxOffset;
+	}
+	/*-----------------------------------------------------------*/
+
+	static TickType_t prvTimingWheelInsert( ListItem_t * const pxListItem, const TickType_t xTimeNow )
+	{
+	const TickType_t xTimeToWake = listGET_LIST_ITEM_VALUE( pxListItem );
+	const TickType_t xTicksToWake = xTimeToWake - xTimeNow;
+	UBaseType_t uxSlot;
+	TickType_t xProcessTime;
+
+		if( xTicksToWake < ( TickType_t ) configTIMING_WHEEL_SLOTS )
+		{
+			uxSlot = ( UBaseType_t ) ( xTimeToWake & taskWHEEL_SLOT_MASK );
+			vListInsertEnd( &( xTimingWheel[ 0 ][ uxSlot ] ), pxListItem );
+			taskWHEEL_SET_SLOT_BIT( 0, uxSlot );
+			xProcessTime = xTimeToWake;
+		}
+		else if( ( uint32_t ) xTicksToWake < taskWHEEL_SPAN )
+		{
+			uxSlot = ( UBaseType_t ) ( ( xTimeToWake / ( TickType_t ) configTIMING_WHEEL_SLOTS ) & taskWHEEL_SLOT_MASK );
+			vListInsertEnd( &( xTimingWheel[ 1 ][ uxSlot ] ), pxListItem );
+			taskWHEEL_SET_SLOT_BIT( 1, uxSlot );
+			xProcessTime = xTimeToWake & ~taskWHEEL_SLOT_MASK;
+		}
+		else
+		{
+			vListInsertEnd( &xTimingWheelFarList, pxListItem );
+			xProcessTime = ( xTimeNow | ( TickType_t ) ( taskWHEEL_SPAN - 1UL ) ) + ( TickType_t ) 1;
+		}
+
+		return xProcessTime;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvTimingWheelUnblockTask( TCB_t * const pxTCB )
+	{
+	BaseType_t xSwitchRequired = pdFALSE;
+
+		( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+
+		/* Is the task waiting on an event also?  If so remove it from the
+		event list. */
+		if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+		{
+			( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Place the unblocked task into the appropriate ready list. */
+		prvAddTaskToReadyList( pxTCB );
+
+		/* A task being unblocked cannot cause an immediate context switch if
+		preemption is turned off. */
+		#if( configNUM_CORES > 1 )
+		{
+			/* xTaskIncrementTick() picks up a yield of this core from
+			xYieldPending. */
+			prvYieldForTask( pxTCB );
+		}
+		#elif (  configUSE_PREEMPTION == 1 )
+		{
+			/* Preemption is on, but a context switch should only be performed
+			if the unblocked task has a priority that is equal to or higher
+			than the currently executing task. */
+			if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+			{
+				xSwitchRequired = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_PREEMPTION */
+
+		return xSwitchRequired;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvTimingWheelProcessTick( const TickType_t xTick )
+	{
+	BaseType_t xSwitchRequired = pdFALSE;
+	UBaseType_t uxSlot;
+	List_t *pxSlot;
+	ListItem_t *pxListItem, *pxNextListItem;
+
+		if( ( xTick & taskWHEEL_SLOT_MASK ) == ( TickType_t ) 0 )
+		{
+			if( ( xTick & ( TickType_t ) ( taskWHEEL_SPAN - 1UL ) ) == ( TickType_t ) 0 )
+			{
+				/* Move the tasks that now wake within taskWHEEL_SPAN ticks into
+				the wheel.  Tasks that still wake later are left where they
+				are. */
+				pxListItem = listGET_HEAD_ENTRY( &xTimingWheelFarList );
+
+				while( pxListItem != listGET_END_MARKER( &xTimingWheelFarList ) )
+				{
+					pxNextListItem = listGET_NEXT( pxListItem );
+
+					if( ( uint32_t ) ( ( TickType_t ) ( listGET_LIST_ITEM_VALUE( pxListItem ) - xTick ) ) < taskWHEEL_SPAN )
+					{
+						( void ) uxListRemove( pxListItem );
+						( void ) prvTimingWheelInsert( pxListItem, xTick );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					pxListItem = pxNextListItem;
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* The tasks in the second level slot that starts at this tick
+			all wake within the next configTIMING_WHEEL_SLOTS ticks, so move
+			them to the first level. */
+			uxSlot = ( UBaseType_t ) ( ( xTick / ( TickType_t ) configTIMING_WHEEL_SLOTS ) & taskWHEEL_SLOT_MASK );
+			pxSlot = &( xTimingWheel[ 1 ][ uxSlot ] );
+
+			while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+			{
+				pxListItem = listGET_HEAD_ENTRY( pxSlot );
+				( void ) uxListRemove( pxListItem );
+				( void ) prvTimingWheelInsert( pxListItem, xTick );
+			}
+
+			taskWHEEL_CLEAR_SLOT_BIT( 1, uxSlot );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Every task in the first level slot for this tick is due to wake. */
+		uxSlot = ( UBaseType_t ) ( xTick & taskWHEEL_SLOT_MASK );
+		pxSlot = &( xTimingWheel[ 0 ][ uxSlot ] );
+
+		while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+		{
+			if( prvTimingWheelUnblockTask( ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ) ) != pdFALSE )
+			{
+				xSwitchRequired = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		taskWHEEL_CLEAR_SLOT_BIT( 0, uxSlot );
+
+		return xSwitchRequired;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTimingWheelAddCurrentTask( void )
+	{
+	TickType_t xProcessTime;
+
+		/* The wheel is placed at the current tick count before the task is
+		inserted relative to it. */
+		prvTimingWheelSync();
+
+		if( listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ) ) == xTickCount )
+		{
+			/* The slot for the current tick has already been processed, so
+			unblock the task on the next tick, as the sorted delayed list
+			would. */
+			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTickCount + ( TickType_t ) 1 );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xProcessTime = prvTimingWheelInsert( &( pxCurrentTCB->xStateListItem ), xTickCount );
+
+		/* Only one slot is updated, so xNextTaskUnblockTime can be updated
+		without searching the wheel. */
+		if( taskTICK_IS_BEFORE_OR_AT( xProcessTime, xNextTaskUnblockTime ) )
+		{
+			xNextTaskUnblockTime = xProcessTime;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_TIMING_WHEEL */
 /*-----------------------------------------------------------*/
 
-#if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
+#if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) || ( configNUM_CORES > 1 ) )
 
 	TaskHandle_t xTaskGetCurrentTaskHandle( void )
 	{
 	TaskHandle_t xReturn;
 
-		/* A critical section is not required as this is not called from
-		an interrupt and the current TCB will always be the same for any
-		individual execution thread. */
-		xReturn = pxCurrentTCB;
+		#if( configNUM_CORES > 1 )
+		{
+		UBaseType_t uxSavedInterruptStatus;
+
+			/* Interrupts are masked so the calling task is not moved to
+			another core between reading the core ID and indexing the array
+			of running tasks. */
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+			{
+				xReturn = pxCurrentTCBs[ portGET_CORE_ID() ];
+			}
+			portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+		}
+		#else
+		{
+			/* A critical section is not required as this is not called from
+			an interrupt and the current TCB will always be the same for any
+			individual execution thread. */
+			xReturn = pxCurrentTCB;
+		}
+		#endif /* configNUM_CORES */
 
 		return xReturn;
 	}
 
-#endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) */
+#endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) || ( configNUM_CORES > 1 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
@@ -3851,14 +5280,35 @@ TCB_t *pxTCB;
 		}
 		else
 		{
-			if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+			#if( configNUM_CORES > 1 )
 			{
-				xReturn = taskSCHEDULER_RUNNING;
+				/* Only the calling task can have the scheduler suspended while
+				the calling core holds the task lock. */
+				taskENTER_CRITICAL();
+				{
+					if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+					{
+						xReturn = taskSCHEDULER_RUNNING;
+					}
+					else
+					{
+						xReturn = taskSCHEDULER_SUSPENDED;
+					}
+				}
+				taskEXIT_CRITICAL();
 			}
-			else
+			#else
 			{
-				xReturn = taskSCHEDULER_SUSPENDED;
+				if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+				{
+					xReturn = taskSCHEDULER_RUNNING;
+				}
+				else
+				{
+					xReturn = taskSCHEDULER_SUSPENDED;
+				}
 			}
+			#endif /* configNUM_CORES */
 		}
 
 		return xReturn;
@@ -3912,6 +5362,14 @@ TCB_t *pxTCB;
 					/* Inherit the priority before being moved into the new list. */
 					pxMutexHolderTCB->uxPriority = pxCurrentTCB->uxPriority;
 					prvAddTaskToReadyList( pxMutexHolderTCB );
+
+					#if( configNUM_CORES > 1 )
+					{
+						/* The mutex holder may now preempt a task on another
+						core, so it can release the mutex sooner. */
+						prvYieldForTask( pxMutexHolderTCB );
+					}
+					#endif
 				}
 				else
 				{
@@ -4109,8 +5567,24 @@ TCB_t *pxTCB;
 						{
 							mtCOVERAGE_TEST_MARKER();
 						}
-
-						prvAddTaskToReadyList( pxTCB );
+
+						prvAddTaskToReadyList( pxTCB );
+
+						#if( configNUM_CORES > 1 )
+						{
+							/* The mutex holder may be running on another core,
+							in which case that core may now have to run a
+							higher priority task instead. */
+							if( ( taskTASK_IS_RUNNING( pxTCB ) ) && ( uxPriorityToUse < uxPriorityUsedOnEntry ) )
+							{
+								taskYIELD_CORE_IF_USING_PREEMPTION( pxTCB->xTaskRunState );
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						#endif
 					}
 					else
 					{
@@ -4199,6 +5673,201 @@ TCB_t *pxTCB;
 #endif /* portCRITICAL_NESTING_IN_TCB */
 /*-----------------------------------------------------------*/
 
+#if( configNUM_CORES > 1 )
+
+	void vTaskEnterCritical( void )
+	{
+	BaseType_t xCoreID;
+
+		portDISABLE_INTERRUPTS();
+
+		if( xSchedulerRunning != pdFALSE )
+		{
+			/* With interrupts disabled the calling task cannot be moved to
+			another core, so the core ID remains valid. */
+			xCoreID = portGET_CORE_ID();
+
+			if( uxCriticalNestings[ xCoreID ] == 0U )
+			{
+				/* The locks are always taken in this order. */
+				portGET_TASK_LOCK();
+				portGET_ISR_LOCK();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			( uxCriticalNestings[ xCoreID ] )++;
+
+			/* This is not the interrupt safe version of the enter critical
+			function so	assert() if it is being called from an interrupt
+			context.  Only API functions that end in "FromISR" can be used in an
+			interrupt.  Only assert if the critical nesting count is 1 to
+			protect against recursive calls if the assert function also uses a
+			critical section. */
+			if( uxCriticalNestings[ xCoreID ] == 1U )
+			{
+				portASSERT_IF_IN_ISR();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskExitCritical( void )
+	{
+	BaseType_t xCoreID, xYieldCurrentTask;
+
+		if( xSchedulerRunning != pdFALSE )
+		{
+			xCoreID = portGET_CORE_ID();
+
+			if( uxCriticalNestings[ xCoreID ] > 0U )
+			{
+				( uxCriticalNestings[ xCoreID ] )--;
+
+				if( uxCriticalNestings[ xCoreID ] == 0U )
+				{
+					/* Perform any yield that was requested from within the
+					critical section, unless this core has the scheduler
+					suspended, in which case the yield stays pending until the
+					scheduler is resumed. */
+					xYieldCurrentTask = ( ( xYieldPendings[ xCoreID ] != pdFALSE ) && ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) ) ? pdTRUE : pdFALSE;
+
+					portRELEASE_ISR_LOCK();
+					portRELEASE_TASK_LOCK();
+					portENABLE_INTERRUPTS();
+
+					if( xYieldCurrentTask != pdFALSE )
+					{
+						portYIELD();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxTaskEnterCriticalFromISR( void )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xCoreID;
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+
+		if( xSchedulerRunning != pdFALSE )
+		{
+			xCoreID = portGET_CORE_ID();
+
+			/* Only the ISR lock is taken, so interrupts on this core are
+			serialised with critical sections and interrupts on the other
+			cores, but not with a task that has suspended the scheduler. */
+			if( uxCriticalNestings[ xCoreID ] == 0U )
+			{
+				portGET_ISR_LOCK();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			( uxCriticalNestings[ xCoreID ] )++;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return uxSavedInterruptStatus;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskExitCriticalFromISR( UBaseType_t uxSavedInterruptStatus )
+	{
+	BaseType_t xCoreID;
+
+		if( xSchedulerRunning != pdFALSE )
+		{
+			xCoreID = portGET_CORE_ID();
+
+			if( uxCriticalNestings[ xCoreID ] > 0U )
+			{
+				( uxCriticalNestings[ xCoreID ] )--;
+
+				if( uxCriticalNestings[ xCoreID ] == 0U )
+				{
+					portRELEASE_ISR_LOCK();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskYieldWithinAPI( void )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xCoreID;
+
+		/* Interrupts are masked so the calling task is not moved to another
+		core while the core's critical nesting is read. */
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+		xCoreID = portGET_CORE_ID();
+
+		if( uxCriticalNestings[ xCoreID ] == 0U )
+		{
+			portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+			portYIELD();
+		}
+		else
+		{
+			/* A context switch cannot be performed from within a critical
+			section, so it is performed by vTaskExitCritical(). */
+			xYieldPendings[ xCoreID ] = pdTRUE;
+			portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+		}
+	}
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	static char *prvWriteNameToBuffer( char *pcBuffer, const char *pcTaskName )
@@ -4483,17 +6152,19 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+	uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
 	{
 	uint32_t ulReturn;
 
+		configASSERT( uxIndexToWaitOn < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if the notification count is not already non-zero. */
-			if( pxCurrentTCB->ulNotifiedValue == 0UL )
+			if( pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ] == 0UL )
 			{
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4521,17 +6192,17 @@ TickType_t uxReturn;
 		taskENTER_CRITICAL();
 		{
 			traceTASK_NOTIFY_TAKE();
-			ulReturn = pxCurrentTCB->ulNotifiedValue;
+			ulReturn = pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ];
 
 			if( ulReturn != 0UL )
 			{
 				if( xClearCountOnExit != pdFALSE )
 				{
-					pxCurrentTCB->ulNotifiedValue = 0UL;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ] = 0UL;
 				}
 				else
 				{
-					pxCurrentTCB->ulNotifiedValue = ulReturn - ( uint32_t ) 1;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ] = ulReturn - ( uint32_t ) 1;
 				}
 			}
 			else
@@ -4539,7 +6210,7 @@ TickType_t uxReturn;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4551,22 +6222,24 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+	BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWaitOn, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
 	{
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToWaitOn < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if a notification is not already pending. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* Clear bits in the task's notification value as bits may get
 				set	by the notifying task or interrupt.  This can be used to
 				clear the value to zero. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnEntry;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ] &= ~ulBitsToClearOnEntry;
 
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4599,14 +6272,14 @@ TickType_t uxReturn;
 			{
 				/* Output the current notification value, which may or may not
 				have changed. */
-				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue;
+				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ];
 			}
 
 			/* If ucNotifyValue is set then either the task never entered the
 			blocked state (because a notification was already pending) or the
 			task unblocked because of a notification.  Otherwise the task
 			unblocked because of a timeout. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* A notification was not received. */
 				xReturn = pdFALSE;
@@ -4615,11 +6288,11 @@ TickType_t uxReturn;
 			{
 				/* A notification was already pending or a notification was
 				received while the task was waiting. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnExit;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ] &= ~ulBitsToClearOnExit;
 				xReturn = pdTRUE;
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4631,44 +6304,46 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
+	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
 	{
 	TCB_t * pxTCB;
 	BaseType_t xReturn = pdPASS;
 	uint8_t ucOriginalNotifyState;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		pxTCB = ( TCB_t * ) xTaskToNotify;
 
 		taskENTER_CRITICAL();
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
 
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4711,16 +6386,25 @@ TickType_t uxReturn;
 				}
 				#endif
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				#if( configNUM_CORES > 1 )
 				{
-					/* The notified task has a priority above the currently
-					executing task so a yield is required. */
-					taskYIELD_IF_USING_PREEMPTION();
+					/* The notified task may preempt a task on any core. */
+					prvYieldForTask( pxTCB );
 				}
-				else
+				#else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+					{
+						/* The notified task has a priority above the currently
+						executing task so a yield is required. */
+						taskYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
+				#endif /* configNUM_CORES */
 			}
 			else
 			{
@@ -4737,7 +6421,7 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
+	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
@@ -4745,6 +6429,7 @@ TickType_t uxReturn;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -4766,34 +6451,34 @@ TickType_t uxReturn;
 
 		pxTCB = ( TCB_t * ) xTaskToNotify;
 
-		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4829,29 +6514,57 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				#if( configNUM_CORES > 1 )
 				{
-					/* The notified task has a priority above the currently
-					executing task so a yield is required. */
-					if( pxHigherPriorityTaskWoken != NULL )
+					/* The notified task may preempt a task on any core.  Only
+					a yield of the interrupted core is reported to the caller.
+					A task held in the pending ready list is yielded for when
+					the scheduler is resumed. */
+					if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 					{
-						*pxHigherPriorityTaskWoken = pdTRUE;
+						prvYieldForTask( pxTCB );
+
+						if( ( xYieldPending != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+						{
+							*pxHigherPriorityTaskWoken = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 					}
 					else
 					{
-						/* Mark that a yield is pending in case the user is not
-						using the "xHigherPriorityTaskWoken" parameter to an ISR
-						safe FreeRTOS function. */
-						xYieldPending = pdTRUE;
+						mtCOVERAGE_TEST_MARKER();
 					}
 				}
-				else
+				#else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+					{
+						/* The notified task has a priority above the currently
+						executing task so a yield is required. */
+						if( pxHigherPriorityTaskWoken != NULL )
+						{
+							*pxHigherPriorityTaskWoken = pdTRUE;
+						}
+						else
+						{
+							/* Mark that a yield is pending in case the user is not
+							using the "xHigherPriorityTaskWoken" parameter to an ISR
+							safe FreeRTOS function. */
+							xYieldPending = pdTRUE;
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
+				#endif /* configNUM_CORES */
 			}
 		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 		return xReturn;
 	}
@@ -4861,13 +6574,14 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+	void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -4889,14 +6603,14 @@ TickType_t uxReturn;
 
 		pxTCB = ( TCB_t * ) xTaskToNotify;
 
-		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 		{
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			/* 'Giving' is equivalent to incrementing a count in a counting
 			semaphore. */
-			( pxTCB->ulNotifiedValue )++;
+			( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 
 			traceTASK_NOTIFY_GIVE_FROM_ISR();
 
@@ -4919,29 +6633,57 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				#if( configNUM_CORES > 1 )
 				{
-					/* The notified task has a priority above the currently
-					executing task so a yield is required. */
-					if( pxHigherPriorityTaskWoken != NULL )
+					/* The notified task may preempt a task on any core.  Only
+					a yield of the interrupted core is reported to the caller.
+					A task held in the pending ready list is yielded for when
+					the scheduler is resumed. */
+					if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 					{
-						*pxHigherPriorityTaskWoken = pdTRUE;
+						prvYieldForTask( pxTCB );
+
+						if( ( xYieldPending != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+						{
+							*pxHigherPriorityTaskWoken = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 					}
 					else
 					{
-						/* Mark that a yield is pending in case the user is not
-						using the "xHigherPriorityTaskWoken" parameter in an ISR
-						safe FreeRTOS function. */
-						xYieldPending = pdTRUE;
+						mtCOVERAGE_TEST_MARKER();
 					}
 				}
-				else
+				#else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+					{
+						/* The notified task has a priority above the currently
+						executing task so a yield is required. */
+						if( pxHigherPriorityTaskWoken != NULL )
+						{
+							*pxHigherPriorityTaskWoken = pdTRUE;
+						}
+						else
+						{
+							/* Mark that a yield is pending in case the user is not
+							using the "xHigherPriorityTaskWoken" parameter in an ISR
+							safe FreeRTOS function. */
+							xYieldPending = pdTRUE;
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
+				#endif /* configNUM_CORES */
 			}
 		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 	}
 
 #endif /* configUSE_TASK_NOTIFICATIONS */
@@ -4950,20 +6692,22 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask )
+	BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear )
 	{
 	TCB_t *pxTCB;
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		/* If null is passed in here then it is the calling task that is having
 		its notification state cleared. */
 		pxTCB = prvGetTCBFromHandle( xTask );
 
 		taskENTER_CRITICAL();
 		{
-			if( pxTCB->ucNotifyState == taskNOTIFICATION_RECEIVED )
+			if( pxTCB->ucNotifyState[ uxIndexToClear ] == taskNOTIFICATION_RECEIVED )
 			{
-				pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+				pxTCB->ucNotifyState[ uxIndexToClear ] = taskNOT_WAITING_NOTIFICATION;
 				xReturn = pdPASS;
 			}
 			else
@@ -5026,30 +6770,38 @@ const TickType_t xConstTickCount = xTickCount;
 			/* The list item will be inserted in wake time order. */
 			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-			if( xTimeToWake < xConstTickCount )
+			#if ( configUSE_TIMING_WHEEL == 0 )
 			{
-				/* Wake time has overflowed.  Place this item in the overflow
-				list. */
-				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
-			}
-			else
-			{
-				/* The wake time has not overflowed, so the current block list
-				is used. */
-				vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
-
-				/* If the task entering the blocked state was placed at the
-				head of the list of blocked tasks then xNextTaskUnblockTime
-				needs to be updated too. */
-				if( xTimeToWake < xNextTaskUnblockTime )
+				if( xTimeToWake < xConstTickCount )
 				{
-					xNextTaskUnblockTime = xTimeToWake;
+					/* Wake time has overflowed.  Place this item in the overflow
+					list. */
+					vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
 				}
 				else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					/* The wake time has not overflowed, so the current block list
+					is used. */
+					vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+
+					/* If the task entering the blocked state was placed at the
+					head of the list of blocked tasks then xNextTaskUnblockTime
+					needs to be updated too. */
+					if( xTimeToWake < xNextTaskUnblockTime )
+					{
+						xNextTaskUnblockTime = xTimeToWake;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
 			}
+			#else
+			{
+				prvTimingWheelAddCurrentTask();
+			}
+			#endif /* configUSE_TIMING_WHEEL */
 		}
 	}
 	#else /* INCLUDE_vTaskSuspend */
@@ -5062,28 +6814,36 @@ const TickType_t xConstTickCount = xTickCount;
 		/* The list item will be inserted in wake time order. */
 		listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-		if( xTimeToWake < xConstTickCount )
+		#if ( configUSE_TIMING_WHEEL == 0 )
 		{
-			/* Wake time has overflowed.  Place this item in the overflow list. */
-			vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
-		}
-		else
-		{
-			/* The wake time has not overflowed, so the current block list is used. */
-			vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
-
-			/* If the task entering the blocked state was placed at the head of the
-			list of blocked tasks then xNextTaskUnblockTime needs to be updated
-			too. */
-			if( xTimeToWake < xNextTaskUnblockTime )
+			if( xTimeToWake < xConstTickCount )
 			{
-				xNextTaskUnblockTime = xTimeToWake;
+				/* Wake time has overflowed.  Place this item in the overflow list. */
+				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
 			}
 			else
 			{
-				mtCOVERAGE_TEST_MARKER();
+				/* The wake time has not overflowed, so the current block list is used. */
+				vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+
+				/* If the task entering the blocked state was placed at the head of the
+				list of blocked tasks then xNextTaskUnblockTime needs to be updated
+				too. */
+				if( xTimeToWake < xNextTaskUnblockTime )
+				{
+					xNextTaskUnblockTime = xTimeToWake;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
 		}
+		#else
+		{
+			prvTimingWheelAddCurrentTask();
+		}
+		#endif /* configUSE_TIMING_WHEEL */
 
 		/* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
 		( void ) xCanBlockIndefinitely;
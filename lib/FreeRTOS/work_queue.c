@@ -0,0 +1,441 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "work_queue.h"
+
+#if( configUSE_TASK_NOTIFICATIONS != 1 )
+	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to build work_queue.c
+#endif
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to build work_queue.c
+#endif
+
+/* Lint e961 and e750 are suppressed as a MISRA exception justified because the
+MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined for the
+header files above, but not in this file, in order to generate the correct
+privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750. */
+
+/*-----------------------------------------------------------*/
+
+/* The definition of the work queue structure. */
+typedef struct xWORK_QUEUE
+{
+	WorkItem_t * volatile pxHead;		/*< The next item to run. */
+	WorkItem_t * volatile pxTail;		/*< The last item submitted, to which the next item submitted is linked. */
+	volatile UBaseType_t uxPending;		/*< The number of items in the queue. */
+	TaskHandle_t xWorkerTask;			/*< The task that runs the items. */
+	UBaseType_t uxMaxBatch;				/*< The number of items run before the worker task yields, or 0 to not yield. */
+	volatile BaseType_t xDeleted;		/*< Set by vWorkQueueDelete(), after which the worker task frees the queue. */
+	WorkQueueStats_t xStats;			/*< Statistics, only updated from within critical sections. */
+} WorkQueue_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task created for each work queue to run the items submitted to it.
+ */
+static void prvWorkerTask( void *pvParameters ) PRIVILEGED_FUNCTION;
+
+/*
+ * Links an item onto the end of the queue.  Must be called from a critical
+ * section.  Returns pdTRUE if the worker task must be notified because the
+ * queue was empty, otherwise pdFALSE.  *pxAdded is set to pdFALSE if the item
+ * was already pending, so was not added.
+ */
+static BaseType_t prvSubmitItem( WorkQueue_t * const pxWorkQueue, WorkItem_t * const pxWorkItem, TickType_t xNow, BaseType_t *pxAdded ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes the item at the head of the queue, and returns pdTRUE with the
+ * item's function and parameter in *ppxFunction and *ppvParameter, or returns
+ * pdFALSE if the queue is empty.  The function and parameter are read while the
+ * item is still owned by the queue, as it may be submitted again by another
+ * task or interrupt as soon as it has been removed.
+ */
+static BaseType_t prvTakeItem( WorkQueue_t * const pxWorkQueue, WorkFunction_t *ppxFunction, void **ppvParameter ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+WorkQueueHandle_t xWorkQueueCreate( const char * const pcName,
+									configSTACK_DEPTH_TYPE usStackDepth,
+									UBaseType_t uxPriority,
+									UBaseType_t uxMaxBatch )
+{
+WorkQueue_t *pxWorkQueue;
+
+	pxWorkQueue = ( WorkQueue_t * ) pvPortMalloc( sizeof( WorkQueue_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of WorkQueue_t is a pointer. */
+
+	if( pxWorkQueue != NULL )
+	{
+		memset( ( void * ) pxWorkQueue, 0x00, sizeof( WorkQueue_t ) );
+		pxWorkQueue->uxMaxBatch = uxMaxBatch;
+
+		if( xTaskCreate( prvWorkerTask, pcName, usStackDepth, ( void * ) pxWorkQueue, uxPriority, &( pxWorkQueue->xWorkerTask ) ) != pdPASS )
+		{
+			vPortFree( ( void * ) pxWorkQueue );
+			pxWorkQueue = NULL;
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return ( WorkQueueHandle_t ) pxWorkQueue;
+}
+/*-----------------------------------------------------------*/
+
+void vWorkQueueDelete( WorkQueueHandle_t xWorkQueue )
+{
+WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) xWorkQueue;
+WorkItem_t *pxWorkItem;
+
+	configASSERT( pxWorkQueue );
+
+	taskENTER_CRITICAL();
+	{
+		configASSERT( pxWorkQueue->xDeleted == pdFALSE );
+		pxWorkQueue->xDeleted = pdTRUE;
+
+		/* The items are no longer pending, so can be submitted to another
+		work queue. */
+		for( pxWorkItem = pxWorkQueue->pxHead; pxWorkItem != NULL; pxWorkItem = pxWorkItem->pxNext )
+		{
+			pxWorkItem->pvOwner = NULL;
+		}
+
+		pxWorkQueue->pxHead = NULL;
+		pxWorkQueue->pxTail = NULL;
+		pxWorkQueue->uxPending = 0;
+	}
+	taskEXIT_CRITICAL();
+
+	/* The worker task frees the queue and deletes itself when it next checks
+	for items, which may be once the function it is running returns. */
+	( void ) xTaskNotifyGive( pxWorkQueue->xWorkerTask );
+}
+/*-----------------------------------------------------------*/
+
+void vWorkQueueInitialiseItem( WorkItem_t *pxWorkItem, WorkFunction_t pxFunction, void *pvParameter )
+{
+	configASSERT( pxWorkItem );
+	configASSERT( pxFunction );
+
+	pxWorkItem->pxNext = NULL;
+	pxWorkItem->pvOwner = NULL;
+	pxWorkItem->pxFunction = pxFunction;
+	pxWorkItem->pvParameter = pvParameter;
+	pxWorkItem->xSubmitTime = ( TickType_t ) 0;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSubmitItem( WorkQueue_t * const pxWorkQueue, WorkItem_t * const pxWorkItem, TickType_t xNow, BaseType_t *pxAdded )
+{
+BaseType_t xNotifyWorker = pdFALSE;
+
+	configASSERT( pxWorkQueue->xDeleted == pdFALSE );
+
+	if( pxWorkItem->pvOwner == NULL )
+	{
+		pxWorkItem->pvOwner = ( void * ) pxWorkQueue;
+		pxWorkItem->pxNext = NULL;
+		pxWorkItem->xSubmitTime = xNow;
+
+		if( pxWorkQueue->pxTail == NULL )
+		{
+			/* The worker task is only notified when the queue becomes non
+			empty, as it does not block again until the queue is empty. */
+			pxWorkQueue->pxHead = pxWorkItem;
+			xNotifyWorker = pdTRUE;
+		}
+		else
+		{
+			pxWorkQueue->pxTail->pxNext = pxWorkItem;
+		}
+
+		pxWorkQueue->pxTail = pxWorkItem;
+		( pxWorkQueue->uxPending )++;
+
+		if( pxWorkQueue->uxPending > pxWorkQueue->xStats.uxMaxPending )
+		{
+			pxWorkQueue->xStats.uxMaxPending = pxWorkQueue->uxPending;
+		}
+
+		( pxWorkQueue->xStats.ulSubmitted )++;
+		*pxAdded = pdTRUE;
+	}
+	else
+	{
+		/* The item has not started to run yet, so running it once serves both
+		submissions. */
+		configASSERT( pxWorkItem->pvOwner == ( void * ) pxWorkQueue );
+		( pxWorkQueue->xStats.ulCoalesced )++;
+		*pxAdded = pdFALSE;
+	}
+
+	return xNotifyWorker;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem )
+{
+WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) xWorkQueue;
+BaseType_t xNotifyWorker, xReturn;
+
+	configASSERT( pxWorkQueue );
+	configASSERT( pxWorkItem );
+
+	taskENTER_CRITICAL();
+	{
+		xNotifyWorker = prvSubmitItem( pxWorkQueue, pxWorkItem, xTaskGetTickCount(), &xReturn );
+	}
+	taskEXIT_CRITICAL();
+
+	if( xNotifyWorker != pdFALSE )
+	{
+		( void ) xTaskNotifyGive( pxWorkQueue->xWorkerTask );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem, BaseType_t *pxHigherPriorityTaskWoken )
+{
+WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) xWorkQueue;
+BaseType_t xNotifyWorker, xReturn;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxWorkQueue );
+	configASSERT( pxWorkItem );
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		xNotifyWorker = prvSubmitItem( pxWorkQueue, pxWorkItem, xTaskGetTickCountFromISR(), &xReturn );
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	if( xNotifyWorker != pdFALSE )
+	{
+		vTaskNotifyGiveFromISR( pxWorkQueue->xWorkerTask, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueCancel( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem )
+{
+WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) xWorkQueue;
+WorkItem_t *pxPrevious = NULL, *pxItem;
+BaseType_t xReturn = pdFALSE;
+
+	configASSERT( pxWorkQueue );
+	configASSERT( pxWorkItem );
+
+	taskENTER_CRITICAL();
+	{
+		if( pxWorkItem->pvOwner == ( void * ) pxWorkQueue )
+		{
+			/* The queue is singly linked, so the item before the one being
+			removed has to be found. */
+			for( pxItem = pxWorkQueue->pxHead; pxItem != pxWorkItem; pxItem = pxItem->pxNext )
+			{
+				configASSERT( pxItem );
+				pxPrevious = pxItem;
+			}
+
+			if( pxPrevious == NULL )
+			{
+				pxWorkQueue->pxHead = pxWorkItem->pxNext;
+			}
+			else
+			{
+				pxPrevious->pxNext = pxWorkItem->pxNext;
+			}
+
+			if( pxWorkQueue->pxTail == pxWorkItem )
+			{
+				pxWorkQueue->pxTail = pxPrevious;
+			}
+
+			( pxWorkQueue->uxPending )--;
+			pxWorkItem->pvOwner = NULL;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vWorkQueueGetStats( WorkQueueHandle_t xWorkQueue, WorkQueueStats_t *pxStats )
+{
+WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) xWorkQueue;
+
+	configASSERT( pxWorkQueue );
+	configASSERT( pxStats );
+
+	taskENTER_CRITICAL();
+	{
+		*pxStats = pxWorkQueue->xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vWorkQueueResetStats( WorkQueueHandle_t xWorkQueue )
+{
+WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) xWorkQueue;
+
+	configASSERT( pxWorkQueue );
+
+	taskENTER_CRITICAL();
+	{
+		memset( ( void * ) &( pxWorkQueue->xStats ), 0x00, sizeof( WorkQueueStats_t ) );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTakeItem( WorkQueue_t * const pxWorkQueue, WorkFunction_t *ppxFunction, void **ppvParameter )
+{
+WorkItem_t *pxWorkItem;
+TickType_t xLatency;
+BaseType_t xReturn = pdFALSE;
+
+	taskENTER_CRITICAL();
+	{
+		pxWorkItem = pxWorkQueue->pxHead;
+
+		if( pxWorkItem != NULL )
+		{
+			pxWorkQueue->pxHead = pxWorkItem->pxNext;
+
+			if( pxWorkQueue->pxHead == NULL )
+			{
+				pxWorkQueue->pxTail = NULL;
+			}
+
+			( pxWorkQueue->uxPending )--;
+
+			*ppxFunction = pxWorkItem->pxFunction;
+			*ppvParameter = pxWorkItem->pvParameter;
+
+			xLatency = xTaskGetTickCount() - pxWorkItem->xSubmitTime;
+			pxWorkQueue->xStats.ulTotalLatency += ( uint32_t ) xLatency;
+
+			if( xLatency > pxWorkQueue->xStats.xMaxLatency )
+			{
+				pxWorkQueue->xStats.xMaxLatency = xLatency;
+			}
+
+			( pxWorkQueue->xStats.ulExecuted )++;
+
+			/* From here the item can be submitted again, in which case it runs
+			again after this run. */
+			pxWorkItem->pvOwner = NULL;
+			xReturn = pdTRUE;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void *pvParameters )
+{
+WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) pvParameters;
+WorkFunction_t pxFunction = NULL;
+void *pvParameter = NULL;
+UBaseType_t uxRun;
+
+	for( ;; )
+	{
+		/* Wait until the queue becomes non empty. */
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		if( pxWorkQueue->xDeleted != pdFALSE )
+		{
+			break;
+		}
+
+		taskENTER_CRITICAL();
+		{
+			( pxWorkQueue->xStats.ulWakeups )++;
+		}
+		taskEXIT_CRITICAL();
+
+		/* Run everything that is pending, including items submitted while
+		the others run, before blocking again. */
+		uxRun = 0;
+
+		while( prvTakeItem( pxWorkQueue, &pxFunction, &pvParameter ) != pdFALSE )
+		{
+			pxFunction( pvParameter );
+
+			uxRun++;
+
+			if( uxRun == pxWorkQueue->uxMaxBatch )
+			{
+				/* Let other tasks of the same priority run between batches. */
+				uxRun = 0;
+				taskYIELD();
+			}
+		}
+	}
+
+	vPortFree( ( void * ) pxWorkQueue );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
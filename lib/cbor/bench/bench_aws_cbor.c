@@ -0,0 +1,159 @@
+/*
+ * Amazon FreeRTOS CBOR Library V1.0.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file
+ * @brief Encode and query benchmarks for documents of 10 to 500 keys
+ *
+ * Compares building a document with AssignKey (walks the map for every key),
+ * AssignKey with the key offset index, and AppendKey into a reserved buffer.
+ * Then compares reading every key back with and without the index.
+ */
+
+#include "aws_cbor.h"
+#include <stdio.h>
+#include <time.h>
+
+/** Approximate encoded size of one "kNNN": int pair, used to reserve space */
+#define BENCH_BYTES_PER_KEY    ( 12 )
+
+/** Total keys written or read per measurement, split across documents */
+#define BENCH_KEY_BUDGET       ( 500000 )
+
+typedef enum
+{
+    eBenchAssign,
+    eBenchAssignIndexed,
+    eBenchAppendReserved,
+} BenchEncode_t;
+
+static const int plKeyCounts[] = { 10, 50, 100, 250, 500 };
+
+static char pcKeys[ 500 ][ 8 ];
+
+static double prvSeconds( clock_t xStart )
+{
+    return ( double ) ( clock() - xStart ) / CLOCKS_PER_SEC;
+}
+
+static CBORHandle_t prvEncode( BenchEncode_t xMode,
+                               int lKeyCount )
+{
+    CBORHandle_t xDoc = CBOR_New( 0 );
+
+    if( eBenchAssignIndexed == xMode )
+    {
+        CBOR_EnableKeyIndex( xDoc );
+    }
+    else if( eBenchAppendReserved == xMode )
+    {
+        CBOR_Reserve( xDoc, 2 + lKeyCount * BENCH_BYTES_PER_KEY );
+    }
+
+    for( int i = 0; i < lKeyCount; i++ )
+    {
+        if( eBenchAppendReserved == xMode )
+        {
+            CBOR_AppendKeyWithInt( xDoc, pcKeys[ i ], i );
+        }
+        else
+        {
+            CBOR_AssignKeyWithInt( xDoc, pcKeys[ i ], i );
+        }
+    }
+
+    return xDoc;
+}
+
+/** @return microseconds per document */
+static double prvBenchEncode( BenchEncode_t xMode,
+                              int lKeyCount )
+{
+    int lDocs = BENCH_KEY_BUDGET / lKeyCount;
+    clock_t xStart = clock();
+
+    for( int d = 0; d < lDocs; d++ )
+    {
+        CBORHandle_t xDoc = prvEncode( xMode, lKeyCount );
+        CBOR_Delete( &xDoc );
+    }
+
+    return prvSeconds( xStart ) * 1e6 / lDocs;
+}
+
+/** @return microseconds to read every key of the document once */
+static double prvBenchQuery( bool xIndexed,
+                             int lKeyCount )
+{
+    int lPasses = BENCH_KEY_BUDGET / lKeyCount;
+    CBORHandle_t xDoc = prvEncode( eBenchAppendReserved, lKeyCount );
+    volatile cbor_int_t xSum = 0;
+
+    if( xIndexed )
+    {
+        CBOR_EnableKeyIndex( xDoc );
+    }
+
+    clock_t xStart = clock();
+
+    for( int p = 0; p < lPasses; p++ )
+    {
+        for( int i = 0; i < lKeyCount; i++ )
+        {
+            xSum += CBOR_FromKeyReadInt( xDoc, pcKeys[ i ] );
+        }
+    }
+
+    double xElapsed = prvSeconds( xStart );
+    CBOR_Delete( &xDoc );
+
+    return xElapsed * 1e6 / lPasses;
+}
+
+int main( void )
+{
+    for( int i = 0; i < 500; i++ )
+    {
+        snprintf( pcKeys[ i ], sizeof( pcKeys[ i ] ), "k%d", i );
+    }
+
+    printf( "%6s | %12s %12s %12s | %12s %12s\n", "keys",
+            "assign us", "indexed us", "reserved us",
+            "query us", "indexed us" );
+
+    for( size_t i = 0; i < sizeof( plKeyCounts ) / sizeof( plKeyCounts[ 0 ] ); i++ )
+    {
+        int lKeyCount = plKeyCounts[ i ];
+
+        printf( "%6d | %12.2f %12.2f %12.2f | %12.2f %12.2f\n", lKeyCount,
+                prvBenchEncode( eBenchAssign, lKeyCount ),
+                prvBenchEncode( eBenchAssignIndexed, lKeyCount ),
+                prvBenchEncode( eBenchAppendReserved, lKeyCount ),
+                prvBenchQuery( false, lKeyCount ),
+                prvBenchQuery( true, lKeyCount ) );
+    }
+
+    return 0;
+}
@@ -57,6 +57,8 @@ CBORHandle_t CBOR_New( cbor_ssize_t xSize )
     xNewCborData->pxCursor = pxNew_buffer;
     xNewCborData->pxBufferEnd = &pxNew_buffer[ xSize - 1 ];
     xNewCborData->pxMapEnd = &pxNew_buffer[ 1 ];
+    xNewCborData->pxKeyIndex = NULL;
+    xNewCborData->xError = eCborErrNoError;
 
     return xNewCborData;
 }
@@ -73,11 +75,65 @@ void CBOR_Delete( CBORHandle_t * ppxHandle )
         return;
     }
 
+    CBOR_KeyIndexFree( *ppxHandle );
     pxCBOR_free( ( *ppxHandle )->pxBufferStart );
     pxCBOR_free( *ppxHandle );
     *ppxHandle = NULL;
 }
 
+void CBOR_Reserve( CBORHandle_t xCborData,
+                   cbor_ssize_t xSize )
+{
+    if( NULL == xCborData )
+    {
+        return;
+    }
+
+    CBOR_ReserveBuffer( xCborData, xSize );
+}
+
+bool CBOR_EnableKeyIndex( CBORHandle_t xCborData )
+{
+    if( NULL == xCborData )
+    {
+        return false;
+    }
+
+    if( NULL != xCborData->pxKeyIndex )
+    {
+        return true;
+    }
+
+    struct CborKeyIndex_s * pxIndex =
+        pxCBOR_malloc( sizeof( struct CborKeyIndex_s ) );
+
+    if( NULL == pxIndex )
+    {
+        xCborData->xError = eCborErrInsufficentSpace;
+
+        return false;
+    }
+
+    /* Built lazily, on the first lookup */
+    pxIndex->pxSlots = NULL;
+    pxIndex->xSlotCount = 0;
+    pxIndex->xKeyCount = 0;
+    pxIndex->xIsValid = false;
+    xCborData->pxKeyIndex = pxIndex;
+
+    return true;
+}
+
+void CBOR_DisableKeyIndex( CBORHandle_t xCborData )
+{
+    if( NULL == xCborData )
+    {
+        return;
+    }
+
+    CBOR_KeyIndexFree( xCborData );
+}
+
 cbor_byte_t const * const CBOR_GetRawBuffer( CBORHandle_t pxHandle )
 {
     return pxHandle->pxBufferStart;
@@ -325,11 +381,13 @@ CBORHandle_t CBOR_FromKeyReadMap( CBORHandle_t xCborData,
 void CBOR_AppendMap( CBORHandle_t xDest,
                      CBORHandle_t xSrc )
 {
+    /* Copy the key value pairs and the break, but not the unused space */
     xSrc->pxCursor = xSrc->pxBufferStart + 1;
-    cbor_ssize_t xLength = xSrc->pxBufferEnd - xSrc->pxCursor;
+    cbor_ssize_t xLength = xSrc->pxMapEnd - xSrc->pxCursor + 1;
     xDest->pxCursor = xDest->pxMapEnd;
     CBOR_MemCopy( xDest, xSrc->pxCursor, xLength );
     xDest->pxMapEnd = xDest->pxCursor - 1;
+    CBOR_KeyIndexInvalidate( xDest );
 }
 
 cborError_t CBOR_CheckError( CBORHandle_t xCborData )
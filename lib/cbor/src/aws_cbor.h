@@ -131,6 +131,51 @@ CBORHandle_t CBOR_New( cbor_ssize_t /*size*/ );
  */
 void CBOR_Delete( CBORHandle_t * /*handle*/ );
 
+/**
+ * @brief Reserves space in the CBOR buffer
+ *
+ * Grows the buffer to at least the given size with a single allocation.  A
+ * document whose size is known up front can then be built with the
+ * AppendKey... functions without any reallocation.  Appending only writes at
+ * the end of the map and never moves existing data.
+ *
+ * @code
+ * CBORHandle_t xReport = CBOR_New( 0 );
+ * CBOR_Reserve( xReport, xExpectedReportSize );
+ * CBOR_AppendKeyWithInt( xReport, "t", xTimestamp );
+ * @endcode
+ *
+ * @param CBORHandle_t   Handle for the CBOR data struct.
+ * @param cbor_ssize_t   Minimum size (in bytes) of the buffer
+ * @see CBOR_New
+ */
+void CBOR_Reserve( CBORHandle_t /*xCborData*/, cbor_ssize_t /*size*/ );
+
+/**
+ * @brief Enables the key offset index
+ *
+ * Without the index, every lookup walks the map key by key, so reading or
+ * assigning K keys costs O(K^2).  With the index, CBOR_FindKey, the
+ * FromKeyRead... and the AssignKey... functions find top level keys through a
+ * hash table of key offsets.  The table is built on the first lookup after it
+ * is enabled and kept up to date as keys are appended or assigned.  It costs
+ * one allocation of about 16 bytes per key.
+ *
+ * If the index cannot be allocated, lookups fall back to walking the map.
+ *
+ * @param CBORHandle_t   Handle for the CBOR data struct.
+ * @return true if the index is enabled, false if out of memory
+ * @see CBOR_DisableKeyIndex
+ */
+bool CBOR_EnableKeyIndex( CBORHandle_t /*xCborData*/ );
+
+/**
+ * @brief Disables the key offset index and frees its memory
+ * @param CBORHandle_t   Handle for the CBOR data struct.
+ * @see CBOR_EnableKeyIndex
+ */
+void CBOR_DisableKeyIndex( CBORHandle_t /*xCborData*/ );
+
 /**
  * @brief Returns a pointer to the raw buffer
  *
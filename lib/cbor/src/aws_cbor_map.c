@@ -24,6 +24,169 @@
  */
 #include "aws_cbor_internals.h"
 #include <assert.h>
+#include <string.h>
+
+/** Smallest slot table allocated for the key offset index */
+#define CBOR_KEY_INDEX_MIN_SLOTS    ( 16 )
+
+/** FNV-1a parameters used to hash keys for the key offset index */
+#define CBOR_FNV_OFFSET_BASIS       ( 2166136261UL )
+#define CBOR_FNV_PRIME              ( 16777619UL )
+
+/**
+ * @brief Gets the characters and length of the string data item at the pointer
+ */
+static const cbor_byte_t * CBOR_KeyPayload( const cbor_byte_t * pxKey,
+                                            cbor_ssize_t * pxLength )
+{
+    assert( NULL != pxKey );
+    assert( NULL != pxLength );
+
+    cbor_byte_t xAdditional_detail = *pxKey & CBOR_ADDITIONAL_DATA_MASK;
+    cbor_ssize_t xHeaderSize = 1;
+
+    if( CBOR_INT8_FOLLOWS == xAdditional_detail )
+    {
+        xHeaderSize = 2;
+    }
+    else if( CBOR_INT16_FOLLOWS == xAdditional_detail )
+    {
+        xHeaderSize = 3;
+    }
+
+    *pxLength = CBOR_StringSize( pxKey ) - xHeaderSize;
+
+    return pxKey + xHeaderSize;
+}
+
+static uint32_t CBOR_KeyHash( const cbor_byte_t * pxBytes,
+                              cbor_ssize_t xLength )
+{
+    uint32_t ulHash = CBOR_FNV_OFFSET_BASIS;
+
+    for( cbor_ssize_t xI = 0; xI < xLength; xI++ )
+    {
+        ulHash ^= pxBytes[ xI ];
+        ulHash *= CBOR_FNV_PRIME;
+    }
+
+    return ulHash;
+}
+
+/**
+ * @brief Finds the slot holding the key, or the empty slot where it belongs
+ *
+ * The index is kept at most half full, so the probe always terminates.
+ */
+static CborKeySlot_t * CBOR_KeyIndexProbe( CBORHandle_t xCborData,
+                                           uint32_t ulHash,
+                                           const cbor_byte_t * pxKey,
+                                           cbor_ssize_t xLength )
+{
+    struct CborKeyIndex_s * pxIndex = xCborData->pxKeyIndex;
+    cbor_ssize_t xMask = pxIndex->xSlotCount - 1;
+    cbor_ssize_t xI = ( cbor_ssize_t ) ( ulHash & ( uint32_t ) xMask );
+
+    for( ; ; )
+    {
+        CborKeySlot_t * pxSlot = &( pxIndex->pxSlots[ xI ] );
+
+        if( 0 == pxSlot->xOffset )
+        {
+            return pxSlot;
+        }
+
+        if( ulHash == pxSlot->ulHash )
+        {
+            cbor_ssize_t xSlotLength = 0;
+            const cbor_byte_t * pxSlotKey = CBOR_KeyPayload(
+                xCborData->pxBufferStart + pxSlot->xOffset, &xSlotLength );
+
+            if( ( xSlotLength == xLength ) &&
+                ( 0 == memcmp( pxSlotKey, pxKey, xLength ) ) )
+            {
+                return pxSlot;
+            }
+        }
+
+        xI = ( xI + 1 ) & xMask;
+    }
+}
+
+/**
+ * @brief Reallocates the slot table and rehashes the keys into it
+ */
+static bool CBOR_KeyIndexGrow( CBORHandle_t xCborData,
+                               cbor_ssize_t xSlotCount )
+{
+    struct CborKeyIndex_s * pxIndex = xCborData->pxKeyIndex;
+    CborKeySlot_t * pxNewSlots =
+        pxCBOR_malloc( xSlotCount * sizeof( CborKeySlot_t ) );
+
+    if( NULL == pxNewSlots )
+    {
+        return false;
+    }
+
+    memset( pxNewSlots, 0, xSlotCount * sizeof( CborKeySlot_t ) );
+    cbor_ssize_t xMask = xSlotCount - 1;
+
+    for( cbor_ssize_t xI = 0; xI < pxIndex->xSlotCount; xI++ )
+    {
+        CborKeySlot_t * pxSlot = &( pxIndex->pxSlots[ xI ] );
+
+        if( 0 != pxSlot->xOffset )
+        {
+            cbor_ssize_t xJ = ( cbor_ssize_t ) ( pxSlot->ulHash & ( uint32_t ) xMask );
+
+            while( 0 != pxNewSlots[ xJ ].xOffset )
+            {
+                xJ = ( xJ + 1 ) & xMask;
+            }
+
+            pxNewSlots[ xJ ] = *pxSlot;
+        }
+    }
+
+    pxCBOR_free( pxIndex->pxSlots );
+    pxIndex->pxSlots = pxNewSlots;
+    pxIndex->xSlotCount = xSlotCount;
+
+    return true;
+}
+
+/**
+ * @brief Indexes every key of the top level map
+ */
+static bool CBOR_KeyIndexBuild( CBORHandle_t xCborData )
+{
+    struct CborKeyIndex_s * pxIndex = xCborData->pxKeyIndex;
+
+    if( NULL != pxIndex->pxSlots )
+    {
+        memset( pxIndex->pxSlots, 0,
+                pxIndex->xSlotCount * sizeof( CborKeySlot_t ) );
+    }
+
+    pxIndex->xKeyCount = 0;
+    pxIndex->xIsValid = true;
+
+    const cbor_byte_t * pxPtr = xCborData->pxBufferStart + 1;
+
+    while( CBOR_BREAK != *pxPtr )
+    {
+        CBOR_KeyIndexInsert( xCborData, pxPtr - xCborData->pxBufferStart );
+
+        if( !pxIndex->xIsValid )
+        {
+            return false;
+        }
+
+        pxPtr = CBOR_NextKeyPtr( pxPtr );
+    }
+
+    return true;
+}
 
 void CBOR_OpenMap( CBORHandle_t xCborData )
 {
@@ -63,6 +226,15 @@ void CBOR_SearchForKey( CBORHandle_t xCborData,
     assert( *( xCborData->pxCursor ) != 0 );
     assert( *( xCborData->pxCursor ) != CBOR_MAP_OPEN );
 
+    /* The index only covers the top level map, so it can only stand in for a
+     * search that starts at the first key. */
+    if( ( NULL != xCborData->pxKeyIndex ) &&
+        ( ( xCborData->pxBufferStart + 1 ) == xCborData->pxCursor ) &&
+        CBOR_KeyIndexSearch( xCborData, pcKey ) )
+    {
+        return;
+    }
+
     while( !( ( CBOR_BREAK == *( xCborData->pxCursor ) ) ||
               true == CBOR_KeyIsMatch( xCborData, pcKey ) ) )
     {
@@ -79,6 +251,8 @@ void CBOR_AppendKey( CBORHandle_t xCborData,
     assert( NULL != xWriteFunction );
     assert( NULL != pvValue );
 
+    cbor_ssize_t xKeyOffset = xCborData->pxMapEnd - xCborData->pxBufferStart;
+
     xCborData->pxCursor = xCborData->pxMapEnd;
     /* Key not found, at end of map */
     assert( CBOR_BREAK == *( xCborData->pxCursor ) );
@@ -91,6 +265,15 @@ void CBOR_AppendKey( CBORHandle_t xCborData,
 
     /* ...So need to reclose it here. */
     CBOR_CloseMap( xCborData );
+
+    if( eCborErrNoError == xCborData->xError )
+    {
+        CBOR_KeyIndexInsert( xCborData, xKeyOffset );
+    }
+    else
+    {
+        CBOR_KeyIndexInvalidate( xCborData );
+    }
 }
 
 void CBOR_AssignKey( CBORHandle_t xCborData,
@@ -114,8 +297,18 @@ void CBOR_AssignKey( CBORHandle_t xCborData,
         if( CBOR_KeyIsMatch( xCborData, pcKey ) )
         {
             /* Key was found */
+            cbor_ssize_t xKeyOffset =
+                xCborData->pxCursor - xCborData->pxBufferStart;
+            cbor_ssize_t xOldMapLength =
+                xCborData->pxMapEnd - xCborData->pxBufferStart;
+
             CBOR_Next( xCborData );
             xWriteFunction( xCborData, pvValue );
+
+            /* Keys after a resized value have moved */
+            CBOR_KeyIndexShift( xCborData, xKeyOffset,
+                                xCborData->pxMapEnd - xCborData->pxBufferStart -
+                                xOldMapLength );
         }
         else
         {
@@ -189,3 +382,136 @@ CBORHandle_t CBOR_ReadMap( CBORHandle_t xCborData )
 
     return xMap;
 }
+
+bool CBOR_KeyIndexSearch( CBORHandle_t xCborData,
+                          const char * pcKey )
+{
+    assert( NULL != xCborData );
+    assert( NULL != pcKey );
+
+    struct CborKeyIndex_s * pxIndex = xCborData->pxKeyIndex;
+
+    if( NULL == pxIndex )
+    {
+        return false;
+    }
+
+    if( !pxIndex->xIsValid && !CBOR_KeyIndexBuild( xCborData ) )
+    {
+        return false;
+    }
+
+    xCborData->pxCursor = xCborData->pxMapEnd;
+
+    if( 0 == pxIndex->xKeyCount )
+    {
+        return true;
+    }
+
+    cbor_ssize_t xLength = strlen( pcKey );
+    const cbor_byte_t * pxKey = ( const cbor_byte_t * ) pcKey;
+    CborKeySlot_t * pxSlot = CBOR_KeyIndexProbe(
+        xCborData, CBOR_KeyHash( pxKey, xLength ), pxKey, xLength );
+
+    if( 0 != pxSlot->xOffset )
+    {
+        xCborData->pxCursor = xCborData->pxBufferStart + pxSlot->xOffset;
+    }
+
+    return true;
+}
+
+void CBOR_KeyIndexInsert( CBORHandle_t xCborData,
+                          cbor_ssize_t xOffset )
+{
+    assert( NULL != xCborData );
+    assert( 0 < xOffset );
+
+    struct CborKeyIndex_s * pxIndex = xCborData->pxKeyIndex;
+
+    /* An invalid index is rebuilt from scratch before the next lookup */
+    if( ( NULL == pxIndex ) || !pxIndex->xIsValid )
+    {
+        return;
+    }
+
+    const cbor_byte_t * pxKey = xCborData->pxBufferStart + xOffset;
+
+    /* Only string keys can be looked up */
+    if( CBOR_STRING != ( *pxKey & CBOR_MAJOR_TYPE_MASK ) )
+    {
+        return;
+    }
+
+    if( ( pxIndex->xKeyCount + 1 ) * 2 > pxIndex->xSlotCount )
+    {
+        cbor_ssize_t xSlotCount = pxIndex->xSlotCount * 2;
+        xSlotCount = xSlotCount < CBOR_KEY_INDEX_MIN_SLOTS ?
+                     CBOR_KEY_INDEX_MIN_SLOTS : xSlotCount;
+
+        if( !CBOR_KeyIndexGrow( xCborData, xSlotCount ) )
+        {
+            CBOR_KeyIndexInvalidate( xCborData );
+
+            return;
+        }
+    }
+
+    cbor_ssize_t xLength = 0;
+    const cbor_byte_t * pxPayload = CBOR_KeyPayload( pxKey, &xLength );
+    uint32_t ulHash = CBOR_KeyHash( pxPayload, xLength );
+    CborKeySlot_t * pxSlot =
+        CBOR_KeyIndexProbe( xCborData, ulHash, pxPayload, xLength );
+
+    /* Keep the first occurrence of a duplicate key */
+    if( 0 == pxSlot->xOffset )
+    {
+        pxSlot->ulHash = ulHash;
+        pxSlot->xOffset = xOffset;
+        pxIndex->xKeyCount++;
+    }
+}
+
+void CBOR_KeyIndexShift( CBORHandle_t xCborData,
+                         cbor_ssize_t xOffset,
+                         cbor_ssize_t xDelta )
+{
+    assert( NULL != xCborData );
+
+    struct CborKeyIndex_s * pxIndex = xCborData->pxKeyIndex;
+
+    if( ( NULL == pxIndex ) || !pxIndex->xIsValid || ( 0 == xDelta ) )
+    {
+        return;
+    }
+
+    for( cbor_ssize_t xI = 0; xI < pxIndex->xSlotCount; xI++ )
+    {
+        if( pxIndex->pxSlots[ xI ].xOffset > xOffset )
+        {
+            pxIndex->pxSlots[ xI ].xOffset += xDelta;
+        }
+    }
+}
+
+void CBOR_KeyIndexInvalidate( CBORHandle_t xCborData )
+{
+    assert( NULL != xCborData );
+
+    if( NULL != xCborData->pxKeyIndex )
+    {
+        xCborData->pxKeyIndex->xIsValid = false;
+    }
+}
+
+void CBOR_KeyIndexFree( CBORHandle_t xCborData )
+{
+    assert( NULL != xCborData );
+
+    if( NULL != xCborData->pxKeyIndex )
+    {
+        pxCBOR_free( xCborData->pxKeyIndex->pxSlots );
+        pxCBOR_free( xCborData->pxKeyIndex );
+        xCborData->pxKeyIndex = NULL;
+    }
+}
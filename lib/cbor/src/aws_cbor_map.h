@@ -99,4 +99,50 @@ void CBOR_WriteMap( CBORHandle_t /*xCborData*/, const void * /*input*/ );
  */
 CBORHandle_t CBOR_ReadMap( CBORHandle_t /*xCborData*/ );
 
+/**
+ * @brief Looks up a key in the top level map through the key offset index
+ *
+ * Rebuilds the index first if it was invalidated.  On success the cursor
+ * points at the key, or at the end of the map if the key is not present, just
+ * as it would after CBOR_SearchForKey.
+ *
+ * @param CBORHandle_t Handle for the CBOR data struct, with an index enabled
+ * @param "const char *" String to look for
+ * @return true if the index was used, false if the caller must walk the map
+ */
+bool CBOR_KeyIndexSearch( CBORHandle_t /*xCborData*/, const char * /*key*/ );
+
+/**
+ * @brief Adds the key at the given offset to the key offset index
+ *
+ * Duplicate keys are not added, so lookups find the first occurrence like
+ * CBOR_SearchForKey does.  Invalidates the index if it cannot grow.
+ *
+ * @param CBORHandle_t Handle for the CBOR data struct.
+ * @param cbor_ssize_t Offset of the key from the start of the buffer
+ */
+void CBOR_KeyIndexInsert( CBORHandle_t /*xCborData*/, cbor_ssize_t /*offset*/ );
+
+/**
+ * @brief Moves indexed keys that follow a resized value
+ *
+ * @param CBORHandle_t Handle for the CBOR data struct.
+ * @param cbor_ssize_t Offset of the key whose value was resized
+ * @param cbor_ssize_t Change in size of the value, in bytes
+ */
+void CBOR_KeyIndexShift( CBORHandle_t /*xCborData*/, cbor_ssize_t /*offset*/,
+                         cbor_ssize_t /*delta*/ );
+
+/**
+ * @brief Marks the key offset index for rebuilding on the next lookup
+ * @param CBORHandle_t Handle for the CBOR data struct.
+ */
+void CBOR_KeyIndexInvalidate( CBORHandle_t /*xCborData*/ );
+
+/**
+ * @brief Frees the key offset index
+ * @param CBORHandle_t Handle for the CBOR data struct.
+ */
+void CBOR_KeyIndexFree( CBORHandle_t /*xCborData*/ );
+
 #endif /* end of include guard: AWS_CBOR_MAP_H */
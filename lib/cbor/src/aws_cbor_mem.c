@@ -29,6 +29,7 @@
 
 #include "aws_cbor_internals.h"
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -76,63 +77,47 @@ static void CBOR_Reallocate( CBORHandle_t xCborData )
 
     /* Adjust pointers to new location */
     cbor_ssize_t xCursor_index = xCborData->pxCursor - xCborData->pxBufferStart;
+    cbor_ssize_t xMap_end_index = xCborData->pxMapEnd - xCborData->pxBufferStart;
     xCborData->pxBufferStart = pxNew_start;
     xCborData->pxBufferEnd = xCborData->pxBufferStart + xNewSize - 1;
     xCborData->pxCursor = xCborData->pxBufferStart + xCursor_index;
+    xCborData->pxMapEnd = xCborData->pxBufferStart + xMap_end_index;
 }
 
 /**
- * @brief Copies memory into the CBOR buffer "front to back."
+ * @brief Resizes the CBOR buffer to exactly the requested size
  *
- * Copies memory starting from the lowest address and ending with the highest
- * address.
+ * Goes through malloc and free rather than realloc, as CBOR_ReallocImpl only
+ * supports growing by the 1.5 multiplier used in CBOR_Reallocate.  Sets err if
+ * unable to allocate the space.
  */
-static void CBOR_MemCopyLowToHigh( CBORHandle_t xCborData,
-                                   const cbor_byte_t * pxSource,
-                                   cbor_ssize_t xLength )
+static void CBOR_ResizeBuffer( CBORHandle_t xCborData,
+                               cbor_ssize_t xNewSize )
 {
     assert( NULL != xCborData );
-    assert( NULL != pxSource );
-    assert( 0 <= xLength );
-    assert( xCborData->pxCursor < pxSource );
+    assert( 0 < xNewSize );
+
+    cbor_byte_t * pxNew_start = pxCBOR_malloc( xNewSize );
 
-    for( cbor_int_t xI = 0; xI < xLength; xI++ )
+    if( NULL == pxNew_start )
     {
-        CBOR_AssignAndIncrementCursor( xCborData, *pxSource++ );
+        xCborData->xError = eCborErrInsufficentSpace;
 
-        if( xCborData->xError )
-        {
-            return;
-        }
+        return;
     }
-}
-
-/**
- * @brief Copies memory into the CBOR buffer "back to front."
- *
- * Copies memory starting from the highest address and ending with the lowest
- * address.
- */
-static void CBOR_MemCopyHighToLow( CBORHandle_t xCborData,
-                                   const cbor_byte_t * pxSource,
-                                   cbor_ssize_t xLength )
-{
-    assert( NULL != xCborData );
-    assert( NULL != pxSource );
-    assert( 0 <= xLength );
-    assert( xCborData->pxCursor > pxSource );
 
-    pxSource += ( xLength - 1 );
-    xCborData->pxCursor += ( xLength - 1 );
+    cbor_ssize_t xOld_size = BufferSize( xCborData );
+    memcpy( pxNew_start, xCborData->pxBufferStart,
+            xOld_size < xNewSize ? xOld_size : xNewSize );
+    pxCBOR_free( xCborData->pxBufferStart );
 
-    for( cbor_int_t xI = 0; xI < xLength; xI++ )
-    {
-        CBOR_AssignAndDecrementCursor( xCborData, *pxSource-- );
-        /* assert, because else case is unreachable, unlike in 'LowToHigh' */
-        assert( eCborErrNoError == xCborData->xError );
-    }
-
-    xCborData->pxCursor += xLength + 1;
+    /* Adjust pointers to new location */
+    cbor_ssize_t xCursor_index = xCborData->pxCursor - xCborData->pxBufferStart;
+    cbor_ssize_t xMap_end_index = xCborData->pxMapEnd - xCborData->pxBufferStart;
+    xCborData->pxBufferStart = pxNew_start;
+    xCborData->pxBufferEnd = xCborData->pxBufferStart + xNewSize - 1;
+    xCborData->pxCursor = xCborData->pxBufferStart + xCursor_index;
+    xCborData->pxMapEnd = xCborData->pxBufferStart + xMap_end_index;
 }
 
 void CBOR_AssignAndIncrementCursor( CBORHandle_t xCborData,
@@ -184,20 +169,79 @@ void CBOR_MemCopy( CBORHandle_t xCborData,
     assert( 0 <= xLength );
 
     const cbor_byte_t * pxSource = pvInput;
+    cbor_ssize_t xCursor_index = xCborData->pxCursor - xCborData->pxBufferStart;
 
-    if( xCborData->pxCursor < pxSource )
+    /* Check the lengths before moving any pointer by them, so that a bad length
+     * can neither overflow the size below nor push the cursor off the buffer. */
+    if( ( 0 > xCursor_index ) || ( xLength > INT_MAX - xCursor_index ) )
     {
-        CBOR_MemCopyLowToHigh( xCborData, pxSource, xLength );
+        xCborData->xError = eCborErrInsufficentSpace;
+
+        return;
     }
-    else if( xCborData->pxCursor > pxSource )
+
+    cbor_ssize_t xRequired_size = xCursor_index + xLength;
+
+    /* The source may be inside the CBOR buffer (e.g. when resizing a value),
+     * so remember where it is in case the buffer moves while growing. */
+    bool xSource_in_buffer = ( xCborData->pxBufferStart <= pxSource ) &&
+                             ( xCborData->pxBufferEnd >= pxSource );
+    cbor_ssize_t xSource_index = 0;
+
+    if( xSource_in_buffer )
     {
-        CBOR_MemCopyHighToLow( xCborData, pxSource, xLength );
+        xSource_index = pxSource - xCborData->pxBufferStart;
+
+        if( xLength > BufferSize( xCborData ) - xSource_index )
+        {
+            xCborData->xError = eCborErrInsufficentSpace;
+
+            return;
+        }
     }
-    else
+
+    if( xCborData->pxCursor == pxSource )
     {
         /* Copying from a location into itself, so we can skip the copy part and
          * just move the cursor.  Maybe a user error, but not necessarily*/
         xCborData->pxCursor += xLength;
+
+        return;
+    }
+
+    /* Grow once for the whole copy, instead of once per byte */
+    if( BufferSize( xCborData ) < xRequired_size )
+    {
+        cbor_ssize_t xNewSize = BufferSize( xCborData );
+        xNewSize = ( xNewSize / 2 > INT_MAX - xNewSize ) ?
+                   xRequired_size : xNewSize + xNewSize / 2;
+        xNewSize = xNewSize < xRequired_size ? xRequired_size : xNewSize;
+        CBOR_ResizeBuffer( xCborData, xNewSize );
+
+        /* A failed resize leaves the buffer as it was. */
+        if( BufferSize( xCborData ) < xRequired_size )
+        {
+            return;
+        }
+
+        if( xSource_in_buffer )
+        {
+            pxSource = xCborData->pxBufferStart + xSource_index;
+        }
+    }
+
+    memmove( xCborData->pxCursor, pxSource, xLength );
+    xCborData->pxCursor += xLength;
+}
+
+void CBOR_ReserveBuffer( CBORHandle_t xCborData,
+                         cbor_ssize_t xSize )
+{
+    assert( NULL != xCborData );
+
+    if( BufferSize( xCborData ) < xSize )
+    {
+        CBOR_ResizeBuffer( xCborData, xSize );
     }
 }
 
@@ -253,8 +297,16 @@ void CBOR_ValueResize( CBORHandle_t xCborData,
     cbor_byte_t * pxKey_position = pxCurrent_place + xNewSize;
     cbor_ssize_t xRemaining_length = xCborData->pxMapEnd - pxNext_key + 1;
     assert( 0 <= xRemaining_length );
+    cbor_ssize_t xCurrent_index = pxCurrent_place - xCborData->pxBufferStart;
     xCborData->pxCursor = pxKey_position;
     CBOR_MemCopy( xCborData, pxNext_key, xRemaining_length );
-    assert( eCborErrNoError == xCborData->xError );
-    xCborData->pxCursor = pxCurrent_place;
+
+    if( eCborErrNoError != xCborData->xError )
+    {
+        return;
+    }
+
+    /* The tail of the map, including the break, moved with the value */
+    xCborData->pxMapEnd = xCborData->pxCursor - 1;
+    xCborData->pxCursor = xCborData->pxBufferStart + xCurrent_index;
 }
@@ -65,6 +65,18 @@ void CBOR_AssignAndDecrementCursor(
 void CBOR_MemCopy( CBORHandle_t /*xCborData*/, const void * /*input*/,
                    cbor_ssize_t /*length*/ );
 
+/**
+ * @brief Grows the CBOR buffer to at least the given size.
+ *
+ * Grows the buffer with a single allocation, so a document of known size can
+ * be built without reallocating.  Does nothing if the buffer is already large
+ * enough.  Sets eCborErrInsufficentSpace if the allocation fails.
+ *
+ * @param CBORHandle_t Handle for the CBOR data struct.
+ * @param cbor_ssize_t Minimum size (in bytes) of the buffer.
+ */
+void CBOR_ReserveBuffer( CBORHandle_t /*xCborData*/, cbor_ssize_t /*size*/ );
+
 /**
  * @brief Gets size of the CBOR data item that the cursor points to.
  *
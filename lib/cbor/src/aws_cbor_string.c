@@ -47,7 +47,15 @@ void CBOR_WriteString( CBORHandle_t xCborData,
 
     const char * pcStr = pvInput;
     cbor_int_t xStringLength = strlen( pcStr );
-    CBOR_ValueResize( xCborData, xStringLength + 1 );
+    cbor_ssize_t xHeaderSize = CBOR_SMALL_INT_SIZE;
+
+    if( !CBOR_IsSmallInt( xStringLength ) )
+    {
+        xHeaderSize = CBOR_Is8BitInt( xStringLength ) ?
+                      CBOR_INT8_SIZE : CBOR_INT16_SIZE;
+    }
+
+    CBOR_ValueResize( xCborData, xStringLength + xHeaderSize );
 
     if( CBOR_IsSmallInt( xStringLength ) )
     {
@@ -33,6 +33,33 @@
 #include "aws_cbor.h"
 #include <stdint.h>
 
+/**
+ * @brief One slot of the key offset index
+ */
+typedef struct CborKeySlot_s
+{
+    /** Hash of the key string */
+    uint32_t ulHash;
+    /** Offset of the key from pxBufferStart, 0 marks an empty slot */
+    cbor_ssize_t xOffset;
+} CborKeySlot_t;
+
+/**
+ * @brief Open addressed hash table of the keys in the top level map
+ * @see CBOR_EnableKeyIndex
+ */
+struct CborKeyIndex_s
+{
+    /** Slot table, NULL until the index is first built */
+    CborKeySlot_t * pxSlots;
+    /** Number of slots, zero or a power of two */
+    cbor_ssize_t xSlotCount;
+    /** Number of keys stored in the slots */
+    cbor_ssize_t xKeyCount;
+    /** False when the index must be rebuilt before the next lookup */
+    bool xIsValid;
+};
+
 /**
  * @brief Pointer to a CBOR Data Struct
  */
@@ -52,6 +79,8 @@ struct CborData_s
     cbor_byte_t * pxCursor;
     /** Current error code status */
     cborError_t xError;
+    /** Key offset index, NULL unless enabled with CBOR_EnableKeyIndex */
+    struct CborKeyIndex_s * pxKeyIndex;
 };
 
 #endif /* ifndef AWS_CBOR_TYPES_H */
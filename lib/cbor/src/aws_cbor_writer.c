@@ -0,0 +1,221 @@
+/*
+ * Amazon FreeRTOS CBOR Library V1.0.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+#include "aws_cbor_internals.h"
+#include "aws_cbor_writer.h"
+#include <assert.h>
+#include <string.h>
+
+/**
+ * @brief Copies bytes to the output, or only counts them when measuring
+ */
+static void CBOR_WriterPut( CborWriter_t * pxWriter,
+                            const void * pvData,
+                            cbor_ssize_t xLength )
+{
+    assert( NULL != pxWriter );
+
+    if( eCborErrNoError != pxWriter->xError )
+    {
+        return;
+    }
+
+    if( NULL != pxWriter->pxBufferStart )
+    {
+        cbor_byte_t * pxCursor = pxWriter->pxBufferStart + pxWriter->xLength;
+
+        if( ( pxWriter->pxBufferEnd - pxCursor ) < xLength )
+        {
+            pxWriter->xError = eCborErrInsufficentSpace;
+
+            return;
+        }
+
+        memcpy( pxCursor, pvData, xLength );
+    }
+
+    pxWriter->xLength += xLength;
+}
+
+/**
+ * @brief Writes the head of a data item in its shortest form
+ */
+static void CBOR_WriterHead( CborWriter_t * pxWriter,
+                             cbor_byte_t xMajorType,
+                             uint32_t ulValue )
+{
+    cbor_byte_t xHead[ CBOR_INT32_SIZE ];
+    cbor_ssize_t xSize;
+
+    if( CBOR_IsSmallInt( ulValue ) )
+    {
+        xHead[ 0 ] = xMajorType | ( cbor_byte_t ) ulValue;
+        xSize = CBOR_SMALL_INT_SIZE;
+    }
+    else if( CBOR_Is8BitInt( ulValue ) )
+    {
+        xHead[ 0 ] = xMajorType | CBOR_INT8_FOLLOWS;
+        xHead[ 1 ] = ( cbor_byte_t ) ulValue;
+        xSize = CBOR_INT8_SIZE;
+    }
+    else if( CBOR_Is16BitInt( ulValue ) )
+    {
+        xHead[ 0 ] = xMajorType | CBOR_INT16_FOLLOWS;
+        xHead[ 1 ] = ( cbor_byte_t ) ( ulValue >> CBOR_BYTE_WIDTH );
+        xHead[ 2 ] = ( cbor_byte_t ) ulValue;
+        xSize = CBOR_INT16_SIZE;
+    }
+    else
+    {
+        xHead[ 0 ] = xMajorType | CBOR_INT32_FOLLOWS;
+        xHead[ 1 ] = ( cbor_byte_t ) ( ulValue >> ( 3 * CBOR_BYTE_WIDTH ) );
+        xHead[ 2 ] = ( cbor_byte_t ) ( ulValue >> ( 2 * CBOR_BYTE_WIDTH ) );
+        xHead[ 3 ] = ( cbor_byte_t ) ( ulValue >> CBOR_BYTE_WIDTH );
+        xHead[ 4 ] = ( cbor_byte_t ) ulValue;
+        xSize = CBOR_INT32_SIZE;
+    }
+
+    CBOR_WriterPut( pxWriter, xHead, xSize );
+}
+
+void CBOR_WriterInit( CborWriter_t * pxWriter,
+                      cbor_byte_t * pxBuffer,
+                      cbor_ssize_t xSize )
+{
+    assert( NULL != pxWriter );
+    assert( 0 <= xSize );
+
+    pxWriter->pxBufferStart = pxBuffer;
+    pxWriter->pxBufferEnd = ( NULL == pxBuffer ) ? NULL : pxBuffer + xSize;
+    pxWriter->xLength = 0;
+    pxWriter->xDepth = 0;
+    pxWriter->xError = eCborErrNoError;
+}
+
+void CBOR_WriterOpenMap( CborWriter_t * pxWriter )
+{
+    assert( NULL != pxWriter );
+
+    cbor_byte_t xOpen = CBOR_MAP_OPEN;
+
+    CBOR_WriterPut( pxWriter, &xOpen, 1 );
+    pxWriter->xDepth++;
+}
+
+void CBOR_WriterCloseMap( CborWriter_t * pxWriter )
+{
+    assert( NULL != pxWriter );
+
+    if( 0 == pxWriter->xDepth )
+    {
+        pxWriter->xError = eCborErrUnsupportedWriteOperation;
+
+        return;
+    }
+
+    cbor_byte_t xBreak = CBOR_BREAK;
+
+    CBOR_WriterPut( pxWriter, &xBreak, 1 );
+    pxWriter->xDepth--;
+}
+
+void CBOR_WriterString( CborWriter_t * pxWriter,
+                        cbor_const_string_t pcValue )
+{
+    assert( NULL != pxWriter );
+    assert( NULL != pcValue );
+
+    size_t xStringLength = strlen( pcValue );
+
+    if( !CBOR_Is16BitInt( xStringLength ) )
+    {
+        pxWriter->xError = eCborErrUnsupportedWriteOperation;
+
+        return;
+    }
+
+    CBOR_WriterHead( pxWriter, CBOR_STRING, ( uint32_t ) xStringLength );
+    CBOR_WriterPut( pxWriter, pcValue, ( cbor_ssize_t ) xStringLength );
+}
+
+void CBOR_WriterInt( CborWriter_t * pxWriter,
+                     cbor_int_t xValue )
+{
+    assert( NULL != pxWriter );
+
+    if( 0 <= xValue )
+    {
+        CBOR_WriterHead( pxWriter, CBOR_POS_INT, ( uint32_t ) xValue );
+    }
+    else
+    {
+        /* Negative integers are encoded as -1 - n */
+        CBOR_WriterHead( pxWriter, CBOR_NEG_INT, ( uint32_t ) ( -1 - xValue ) );
+    }
+}
+
+void CBOR_WriterKeyWithString( CborWriter_t * pxWriter,
+                               cbor_const_key_t pcKey,
+                               cbor_const_string_t pcValue )
+{
+    CBOR_WriterString( pxWriter, pcKey );
+    CBOR_WriterString( pxWriter, pcValue );
+}
+
+void CBOR_WriterKeyWithInt( CborWriter_t * pxWriter,
+                            cbor_const_key_t pcKey,
+                            cbor_int_t xValue )
+{
+    CBOR_WriterString( pxWriter, pcKey );
+    CBOR_WriterInt( pxWriter, xValue );
+}
+
+void CBOR_WriterKeyOpenMap( CborWriter_t * pxWriter,
+                            cbor_const_key_t pcKey )
+{
+    CBOR_WriterString( pxWriter, pcKey );
+    CBOR_WriterOpenMap( pxWriter );
+}
+
+cbor_ssize_t CBOR_WriterLength( CborWriter_t const * pxWriter )
+{
+    assert( NULL != pxWriter );
+
+    return pxWriter->xLength;
+}
+
+cborError_t CBOR_WriterCheckError( CborWriter_t const * pxWriter )
+{
+    if( NULL == pxWriter )
+    {
+        return eCborErrNullHandle;
+    }
+
+    if( ( eCborErrNoError == pxWriter->xError ) && ( 0 != pxWriter->xDepth ) )
+    {
+        return eCborErrDefaultError;
+    }
+
+    return pxWriter->xError;
+}
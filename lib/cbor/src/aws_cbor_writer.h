@@ -0,0 +1,163 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+#ifndef AWS_CBOR_WRITER_H
+#define AWS_CBOR_WRITER_H
+
+/**
+ * @file
+ * @brief Streaming CBOR encoder that writes into a caller supplied buffer
+ *
+ * Unlike the CBORHandle_t functions, the writer never allocates memory and
+ * never copies a data item once it is written.  Maps are written in order, so
+ * nested maps are opened and closed in place instead of being built as
+ * separate documents and appended.  The output uses the same encoding as the
+ * CBORHandle_t functions (indefinite length maps, shortest form integers and
+ * string lengths), so it can be read back with them.
+ *
+ * @code
+ * cbor_byte_t ucBuffer[ 64 ];
+ * CborWriter_t xWriter;
+ *
+ * CBOR_WriterInit( &xWriter, ucBuffer, sizeof( ucBuffer ) );
+ * CBOR_WriterOpenMap( &xWriter );
+ * CBOR_WriterKeyWithInt( &xWriter, "answer", 42 );
+ * CBOR_WriterKeyOpenMap( &xWriter, "nested" );
+ * CBOR_WriterKeyWithString( &xWriter, "question", "unknown" );
+ * CBOR_WriterCloseMap( &xWriter );
+ * CBOR_WriterCloseMap( &xWriter );
+ *
+ * if( eCborErrNoError == CBOR_WriterCheckError( &xWriter ) )
+ * {
+ *     send( ucBuffer, CBOR_WriterLength( &xWriter ) );
+ * }
+ * @endcode
+ */
+
+#include "aws_cbor.h"
+
+/**
+ * @brief State of a streaming CBOR encoder
+ * @note Treat as opaque, use the CBOR_Writer... functions.
+ */
+typedef struct CborWriter_s
+{
+    /** Start of the output buffer, NULL when only measuring */
+    cbor_byte_t * pxBufferStart;
+    /** One past the last usable byte of the output buffer */
+    cbor_byte_t * pxBufferEnd;
+    /** Number of bytes written so far */
+    cbor_ssize_t xLength;
+    /** Number of maps opened but not yet closed */
+    cbor_ssize_t xDepth;
+    /** First error that occurred, writes are ignored after an error */
+    cborError_t xError;
+} CborWriter_t;
+
+/**
+ * @brief Initializes a writer over the given buffer
+ *
+ * If the buffer is NULL, nothing is written but CBOR_WriterLength still
+ * counts the bytes, so a document can be measured before its buffer is
+ * allocated.
+ *
+ * @param CborWriter_t *  Writer to initialize
+ * @param cbor_byte_t *   Output buffer, or NULL to only measure
+ * @param cbor_ssize_t    Size of the output buffer in bytes
+ */
+void CBOR_WriterInit( CborWriter_t * /*pxWriter*/, cbor_byte_t * /*buffer*/,
+                      cbor_ssize_t /*size*/ );
+
+/**
+ * @brief Opens a map.  Subsequent data items are its keys and values.
+ * @param CborWriter_t * Writer
+ */
+void CBOR_WriterOpenMap( CborWriter_t * /*pxWriter*/ );
+
+/**
+ * @brief Closes the innermost open map
+ * @note Sets eCborErrUnsupportedWriteOperation if no map is open
+ * @param CborWriter_t * Writer
+ */
+void CBOR_WriterCloseMap( CborWriter_t * /*pxWriter*/ );
+
+/**
+ * @brief Writes a string data item (a key or a value)
+ * @note Sets eCborErrUnsupportedWriteOperation for strings of 64KiB or more
+ * @param CborWriter_t *        Writer
+ * @param cbor_const_string_t   zero terminated string
+ */
+void CBOR_WriterString( CborWriter_t * /*pxWriter*/,
+                        cbor_const_string_t /*value*/ );
+
+/**
+ * @brief Writes an integer data item
+ * @param CborWriter_t * Writer
+ * @param cbor_int_t     Value, negative values are supported
+ */
+void CBOR_WriterInt( CborWriter_t * /*pxWriter*/, cbor_int_t /*value*/ );
+
+/**
+ * @brief Writes a @glos{key} with a string @glos{value}
+ * @warning The writer does not check for duplicate keys.
+ */
+void CBOR_WriterKeyWithString( CborWriter_t * /*pxWriter*/,
+                               cbor_const_key_t /*key*/,
+                               cbor_const_string_t /*value*/ );
+
+/**
+ * @brief Writes a @glos{key} with an integer @glos{value}
+ * @warning The writer does not check for duplicate keys.
+ */
+void CBOR_WriterKeyWithInt( CborWriter_t * /*pxWriter*/,
+                            cbor_const_key_t /*key*/, cbor_int_t /*value*/ );
+
+/**
+ * @brief Writes a @glos{key} and opens a map as its @glos{value}
+ *
+ * The map's contents follow, and it is closed with CBOR_WriterCloseMap.
+ * @warning The writer does not check for duplicate keys.
+ */
+void CBOR_WriterKeyOpenMap( CborWriter_t * /*pxWriter*/,
+                            cbor_const_key_t /*key*/ );
+
+/**
+ * @brief Returns the number of bytes written
+ * @param CborWriter_t * Writer
+ * @return Bytes written, or that would have been written when measuring
+ */
+cbor_ssize_t CBOR_WriterLength( CborWriter_t const * /*pxWriter*/ );
+
+/**
+ * @brief Checks the error state of the writer
+ *
+ * Also reports eCborErrDefaultError while a map is still open, as the output
+ * is not yet a complete data item.
+ *
+ * @param CborWriter_t * Writer
+ * @return cborError_t   The first error that occurred
+ */
+cborError_t CBOR_WriterCheckError( CborWriter_t const * /*pxWriter*/ );
+
+#endif /* end of include guard: AWS_CBOR_WRITER_H */
@@ -25,6 +25,7 @@
 #include "aws_cbor_internals.h"
 #include "unity_fixture.h"
 #include <assert.h>
+#include <stdio.h>
 #include <string.h>
 
 CBORHandle_t xCborData;
@@ -54,6 +55,16 @@ TEST_GROUP_RUNNER( aws_cbor )
     RUN_TEST_CASE( aws_cbor, GetBuffer_returns_size_of_map_in_bytes );
     RUN_TEST_CASE( aws_cbor, ClearError_sets_err_to_CBOR_ERR_NO_ERROR );
     RUN_TEST_CASE( aws_cbor, AppendMap );
+    RUN_TEST_CASE( aws_cbor, AppendMap_copies_only_the_source_map );
+    RUN_TEST_CASE( aws_cbor, Reserve_grows_buffer_and_keeps_contents );
+    RUN_TEST_CASE( aws_cbor, Reserve_does_not_shrink_buffer );
+    RUN_TEST_CASE( aws_cbor, Reserve_sets_err_when_out_of_memory );
+    RUN_TEST_CASE( aws_cbor, KeyIndex_finds_every_key );
+    RUN_TEST_CASE( aws_cbor, KeyIndex_returns_false_when_key_not_found );
+    RUN_TEST_CASE( aws_cbor, KeyIndex_tracks_keys_moved_by_assign );
+    RUN_TEST_CASE( aws_cbor, KeyIndex_finds_first_of_duplicate_keys );
+    RUN_TEST_CASE( aws_cbor, KeyIndex_is_rebuilt_after_AppendMap );
+    RUN_TEST_CASE( aws_cbor, KeyIndex_falls_back_to_search_when_out_of_memory );
 }
 
 TEST( aws_cbor, New_returns_not_null )
@@ -164,3 +175,141 @@ TEST( aws_cbor, AppendMap )
     TEST_ASSERT_TRUE( xAnswerFound );
     TEST_ASSERT_TRUE( xQuestionFound );
 }
+
+TEST( aws_cbor, AppendMap_copies_only_the_source_map )
+{
+    CBORHandle_t xSrcData = CBOR_New( 128 );
+
+    CBOR_AppendKeyWithInt( xSrcData, "question", 6 );
+    CBOR_AppendMap( xCborData, xSrcData );
+
+    TEST_ASSERT_EQUAL( CBOR_GetBufferSize( xSrcData ),
+                       CBOR_GetBufferSize( xCborData ) );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( xSrcData->pxBufferStart,
+                                  xCborData->pxBufferStart,
+                                  CBOR_GetBufferSize( xSrcData ) );
+    CBOR_Delete( &xSrcData );
+}
+
+TEST( aws_cbor, Reserve_grows_buffer_and_keeps_contents )
+{
+    CBOR_AppendKeyWithInt( xCborData, "answer", 42 );
+    CBOR_Reserve( xCborData, 1000 );
+
+    cbor_ssize_t xSize = xCborData->pxBufferEnd - xCborData->pxBufferStart + 1;
+    TEST_ASSERT_EQUAL( 1000, xSize );
+    TEST_ASSERT_EQUAL( 11, CBOR_GetBufferSize( xCborData ) );
+    TEST_ASSERT_EQUAL( 42, CBOR_FromKeyReadInt( xCborData, "answer" ) );
+}
+
+TEST( aws_cbor, Reserve_does_not_shrink_buffer )
+{
+    CBOR_Reserve( xCborData, 1 );
+
+    cbor_ssize_t xSize = xCborData->pxBufferEnd - xCborData->pxBufferStart + 1;
+    TEST_ASSERT_GREATER_THAN( 1, xSize );
+}
+
+TEST( aws_cbor, Reserve_sets_err_when_out_of_memory )
+{
+    UnityMalloc_MakeMallocFailAfterCount( 0 );
+    CBOR_Reserve( xCborData, 1000 );
+
+    TEST_ASSERT_EQUAL( eCborErrInsufficentSpace, xCborData->xError );
+    TEST_ASSERT_EQUAL( 2, CBOR_GetBufferSize( xCborData ) );
+}
+
+TEST( aws_cbor, KeyIndex_finds_every_key )
+{
+    char cKey[ 8 ];
+
+    TEST_ASSERT_TRUE( CBOR_EnableKeyIndex( xCborData ) );
+
+    for( int i = 0; i < 100; i++ )
+    {
+        snprintf( cKey, sizeof( cKey ), "k%d", i );
+        CBOR_AppendKeyWithInt( xCborData, cKey, i );
+    }
+
+    for( int i = 0; i < 100; i++ )
+    {
+        snprintf( cKey, sizeof( cKey ), "k%d", i );
+        TEST_ASSERT_EQUAL( i, CBOR_FromKeyReadInt( xCborData, cKey ) );
+    }
+
+    TEST_ASSERT_EQUAL( 100, xCborData->pxKeyIndex->xKeyCount );
+}
+
+TEST( aws_cbor, KeyIndex_returns_false_when_key_not_found )
+{
+    CBOR_EnableKeyIndex( xCborData );
+    TEST_ASSERT_FALSE( CBOR_FindKey( xCborData, "answer" ) );
+
+    CBOR_AppendKeyWithInt( xCborData, "answer", 42 );
+    TEST_ASSERT_FALSE( CBOR_FindKey( xCborData, "question" ) );
+    TEST_ASSERT_EQUAL_PTR( xCborData->pxMapEnd, xCborData->pxCursor );
+}
+
+TEST( aws_cbor, KeyIndex_tracks_keys_moved_by_assign )
+{
+    CBOR_EnableKeyIndex( xCborData );
+    CBOR_AssignKeyWithInt( xCborData, "1", 1 );
+    CBOR_AssignKeyWithString( xCborData, "2", "two" );
+    CBOR_AssignKeyWithInt( xCborData, "3", 3 );
+
+    /* Grow, then shrink, the first value */
+    CBOR_AssignKeyWithInt( xCborData, "1", 0x10000 );
+    TEST_ASSERT_EQUAL( 3, CBOR_FromKeyReadInt( xCborData, "3" ) );
+    CBOR_AssignKeyWithInt( xCborData, "1", 1 );
+    TEST_ASSERT_EQUAL( 3, CBOR_FromKeyReadInt( xCborData, "3" ) );
+
+    CBOR_AssignKeyWithString( xCborData, "2",
+                              "a string long enough for an 8-bit length" );
+    CBOR_AssignKeyWithInt( xCborData, "3", 33 );
+
+    char * pcStr = CBOR_FromKeyReadString( xCborData, "2" );
+    TEST_ASSERT_EQUAL_STRING( "a string long enough for an 8-bit length", pcStr );
+    pxCBOR_free( pcStr );
+    TEST_ASSERT_EQUAL( 33, CBOR_FromKeyReadInt( xCborData, "3" ) );
+    TEST_ASSERT_EQUAL( 1, CBOR_FromKeyReadInt( xCborData, "1" ) );
+    TEST_ASSERT_EQUAL( eCborErrNoError, xCborData->xError );
+}
+
+TEST( aws_cbor, KeyIndex_finds_first_of_duplicate_keys )
+{
+    CBOR_AppendKeyWithInt( xCborData, "answer", 42 );
+    CBOR_AppendKeyWithInt( xCborData, "answer", 43 );
+    CBOR_EnableKeyIndex( xCborData );
+    CBOR_AppendKeyWithInt( xCborData, "answer", 44 );
+
+    TEST_ASSERT_EQUAL( 42, CBOR_FromKeyReadInt( xCborData, "answer" ) );
+    CBOR_AppendKeyWithInt( xCborData, "answer", 45 );
+    TEST_ASSERT_EQUAL( 42, CBOR_FromKeyReadInt( xCborData, "answer" ) );
+}
+
+TEST( aws_cbor, KeyIndex_is_rebuilt_after_AppendMap )
+{
+    CBORHandle_t xSrcData = CBOR_New( 0 );
+
+    CBOR_AppendKeyWithString( xSrcData, "question", "unknown" );
+    CBOR_EnableKeyIndex( xCborData );
+    CBOR_AppendKeyWithInt( xCborData, "answer", 42 );
+    TEST_ASSERT_TRUE( CBOR_FindKey( xCborData, "answer" ) );
+
+    CBOR_AppendMap( xCborData, xSrcData );
+    CBOR_Delete( &xSrcData );
+
+    TEST_ASSERT_TRUE( CBOR_FindKey( xCborData, "answer" ) );
+    TEST_ASSERT_TRUE( CBOR_FindKey( xCborData, "question" ) );
+}
+
+TEST( aws_cbor, KeyIndex_falls_back_to_search_when_out_of_memory )
+{
+    CBOR_AppendKeyWithInt( xCborData, "answer", 42 );
+    CBOR_EnableKeyIndex( xCborData );
+
+    /* Building the slot table on the first lookup fails */
+    UnityMalloc_MakeMallocFailAfterCount( 0 );
+    TEST_ASSERT_EQUAL( 42, CBOR_FromKeyReadInt( xCborData, "answer" ) );
+    TEST_ASSERT_FALSE( xCborData->pxKeyIndex->xIsValid );
+}
@@ -71,6 +71,8 @@ TEST_GROUP_RUNNER( aws_cbor_mem )
     RUN_TEST_CASE( aws_cbor_mem, MemCopy_will_reverse_copy_overlapping_strings );
     RUN_TEST_CASE( aws_cbor_mem, MemCopy_will_do_nothing_if_src_matches_dest );
     RUN_TEST_CASE( aws_cbor_mem, MemCopy_returns_err_when_out_of_memory );
+    RUN_TEST_CASE( aws_cbor_mem, MemCopy_keeps_existing_err );
+    RUN_TEST_CASE( aws_cbor_mem, MemCopy_returns_err_when_src_past_end_of_buffer );
 
     RUN_TEST_CASE( aws_cbor_mem, GetValueSize );
 
@@ -257,6 +259,37 @@ TEST( aws_cbor_mem, MemCopy_returns_err_when_out_of_memory )
     xCborData->xError = eCborErrNoError;
 }
 
+TEST( aws_cbor_mem, MemCopy_keeps_existing_err )
+{
+    char cInit[] = "Hello, World!";
+
+    xCborData->xError = eCborErrKeyNotFound;
+    CBOR_MemCopy( xCborData, cInit, sizeof( cInit ) );
+
+    TEST_ASSERT_EQUAL_STRING( cInit, ( xCborData->pxBufferStart ) );
+    TEST_ASSERT_EQUAL( eCborErrKeyNotFound, xCborData->xError );
+    xCborData->xError = eCborErrNoError;
+}
+
+TEST( aws_cbor_mem, MemCopy_returns_err_when_src_past_end_of_buffer )
+{
+    cbor_ssize_t xBufferSize =
+        xCborData->pxBufferEnd - xCborData->pxBufferStart + 1;
+
+    /* Copying the last byte of the buffer and one byte past it must not read
+     * past the end, nor move the cursor. */
+    CBOR_MemCopy( xCborData, xCborData->pxBufferEnd, 2 );
+    TEST_ASSERT_EQUAL( eCborErrInsufficentSpace, xCborData->xError );
+    TEST_ASSERT_EQUAL_PTR( xCborData->pxBufferStart, xCborData->pxCursor );
+
+    /* The same holds when copying onto itself. */
+    xCborData->xError = eCborErrNoError;
+    CBOR_MemCopy( xCborData, xCborData->pxBufferStart, xBufferSize + 1 );
+    TEST_ASSERT_EQUAL( eCborErrInsufficentSpace, xCborData->xError );
+    TEST_ASSERT_EQUAL_PTR( xCborData->pxBufferStart, xCborData->pxCursor );
+    xCborData->xError = eCborErrNoError;
+}
+
 const test_size_t * pxTestCase;
 const test_size_t xSizeTestCases[] =
 {
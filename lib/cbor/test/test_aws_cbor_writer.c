@@ -0,0 +1,219 @@
+/*
+ * Amazon FreeRTOS CBOR Library V1.0.0
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+#include "assert_override.h"
+#include "aws_cbor_internals.h"
+#include "aws_cbor_writer.h"
+#include "unity_fixture.h"
+#include <assert.h>
+#include <string.h>
+
+static cbor_byte_t ucBuffer[ 64 ];
+static CborWriter_t xWriter;
+
+TEST_GROUP( aws_cbor_writer );
+
+TEST_SETUP( aws_cbor_writer )
+{
+    memset( ucBuffer, 0, sizeof( ucBuffer ) );
+    CBOR_WriterInit( &xWriter, ucBuffer, sizeof( ucBuffer ) );
+}
+
+TEST_TEAR_DOWN( aws_cbor_writer )
+{
+}
+
+TEST_GROUP_RUNNER( aws_cbor_writer )
+{
+    RUN_TEST_CASE( aws_cbor_writer, writes_empty_map );
+    RUN_TEST_CASE( aws_cbor_writer, writes_int_in_shortest_form );
+    RUN_TEST_CASE( aws_cbor_writer, writes_negative_int );
+    RUN_TEST_CASE( aws_cbor_writer, writes_int8_sized_string );
+    RUN_TEST_CASE( aws_cbor_writer, matches_output_of_cbor_handle );
+    RUN_TEST_CASE( aws_cbor_writer, output_can_be_read_by_cbor_handle );
+    RUN_TEST_CASE( aws_cbor_writer, measures_without_buffer );
+    RUN_TEST_CASE( aws_cbor_writer, sets_err_when_buffer_is_full );
+    RUN_TEST_CASE( aws_cbor_writer, sets_err_when_closing_unopened_map );
+    RUN_TEST_CASE( aws_cbor_writer, CheckError_reports_open_map );
+    RUN_TEST_CASE( aws_cbor_writer, null_checks );
+}
+
+TEST( aws_cbor_writer, writes_empty_map )
+{
+    cbor_byte_t ucExpected[] = { CBOR_MAP_OPEN, CBOR_BREAK };
+
+    CBOR_WriterOpenMap( &xWriter );
+    CBOR_WriterCloseMap( &xWriter );
+
+    TEST_ASSERT_EQUAL( eCborErrNoError, CBOR_WriterCheckError( &xWriter ) );
+    TEST_ASSERT_EQUAL( sizeof( ucExpected ), CBOR_WriterLength( &xWriter ) );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( ucExpected, ucBuffer, sizeof( ucExpected ) );
+}
+
+TEST( aws_cbor_writer, writes_int_in_shortest_form )
+{
+    cbor_byte_t ucExpected[] =
+    {
+        0x17,                         /* 23         */
+        0x18, 0x18,                   /* 24         */
+        0x19, 0x01, 0x00,             /* 256        */
+        0x1A, 0x00, 0x01, 0x00, 0x00, /* 65536      */
+    };
+
+    CBOR_WriterInt( &xWriter, 23 );
+    CBOR_WriterInt( &xWriter, 24 );
+    CBOR_WriterInt( &xWriter, 256 );
+    CBOR_WriterInt( &xWriter, 65536 );
+
+    TEST_ASSERT_EQUAL( sizeof( ucExpected ), CBOR_WriterLength( &xWriter ) );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( ucExpected, ucBuffer, sizeof( ucExpected ) );
+}
+
+TEST( aws_cbor_writer, writes_negative_int )
+{
+    cbor_byte_t ucExpected[] =
+    {
+        0x20,       /* -1   */
+        0x38, 0x63, /* -100 */
+    };
+
+    CBOR_WriterInt( &xWriter, -1 );
+    CBOR_WriterInt( &xWriter, -100 );
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( ucExpected, ucBuffer, sizeof( ucExpected ) );
+}
+
+TEST( aws_cbor_writer, writes_int8_sized_string )
+{
+    char const * pcStr = "a string long enough for an 8-bit length";
+
+    CBOR_WriterString( &xWriter, pcStr );
+
+    TEST_ASSERT_EQUAL_HEX8( CBOR_STRING | CBOR_INT8_FOLLOWS, ucBuffer[ 0 ] );
+    TEST_ASSERT_EQUAL( strlen( pcStr ), ucBuffer[ 1 ] );
+    TEST_ASSERT_EQUAL_MEMORY( pcStr, &ucBuffer[ 2 ], strlen( pcStr ) );
+}
+
+static void prvWriteExample( void )
+{
+    CBOR_WriterOpenMap( &xWriter );
+    CBOR_WriterKeyOpenMap( &xWriter, "header" );
+    CBOR_WriterKeyWithInt( &xWriter, "report_id", 1234567 );
+    CBOR_WriterKeyWithString( &xWriter, "version", "1.0" );
+    CBOR_WriterCloseMap( &xWriter );
+    CBOR_WriterKeyWithInt( &xWriter, "total", 2 );
+    CBOR_WriterCloseMap( &xWriter );
+}
+
+TEST( aws_cbor_writer, matches_output_of_cbor_handle )
+{
+    CBORHandle_t xReport = CBOR_New( 0 );
+    CBORHandle_t xHeader = CBOR_New( 0 );
+
+    CBOR_AppendKeyWithInt( xHeader, "report_id", 1234567 );
+    CBOR_AppendKeyWithString( xHeader, "version", "1.0" );
+    CBOR_AppendKeyWithMap( xReport, "header", xHeader );
+    CBOR_AppendKeyWithInt( xReport, "total", 2 );
+
+    prvWriteExample();
+
+    TEST_ASSERT_EQUAL( eCborErrNoError, CBOR_WriterCheckError( &xWriter ) );
+    TEST_ASSERT_EQUAL( CBOR_GetBufferSize( xReport ),
+                       CBOR_WriterLength( &xWriter ) );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( CBOR_GetRawBuffer( xReport ), ucBuffer,
+                                  CBOR_GetBufferSize( xReport ) );
+
+    CBOR_Delete( &xHeader );
+    CBOR_Delete( &xReport );
+}
+
+TEST( aws_cbor_writer, output_can_be_read_by_cbor_handle )
+{
+    prvWriteExample();
+
+    CBORHandle_t xReport = CBOR_New( CBOR_WriterLength( &xWriter ) );
+    memcpy( xReport->pxBufferStart, ucBuffer, CBOR_WriterLength( &xWriter ) );
+    xReport->pxMapEnd = xReport->pxBufferStart + CBOR_WriterLength( &xWriter ) - 1;
+
+    TEST_ASSERT_EQUAL( 2, CBOR_FromKeyReadInt( xReport, "total" ) );
+
+    CBORHandle_t xHeader = CBOR_FromKeyReadMap( xReport, "header" );
+    TEST_ASSERT_EQUAL( 1234567, CBOR_FromKeyReadInt( xHeader, "report_id" ) );
+
+    CBOR_Delete( &xHeader );
+    CBOR_Delete( &xReport );
+}
+
+TEST( aws_cbor_writer, measures_without_buffer )
+{
+    prvWriteExample();
+    cbor_ssize_t xWritten = CBOR_WriterLength( &xWriter );
+
+    CBOR_WriterInit( &xWriter, NULL, 0 );
+    prvWriteExample();
+
+    TEST_ASSERT_EQUAL( eCborErrNoError, CBOR_WriterCheckError( &xWriter ) );
+    TEST_ASSERT_EQUAL( xWritten, CBOR_WriterLength( &xWriter ) );
+}
+
+TEST( aws_cbor_writer, sets_err_when_buffer_is_full )
+{
+    CBOR_WriterInit( &xWriter, ucBuffer, 8 );
+    CBOR_WriterOpenMap( &xWriter );
+    CBOR_WriterKeyWithString( &xWriter, "question", "unknown" );
+    CBOR_WriterKeyWithInt( &xWriter, "answer", 42 );
+    CBOR_WriterCloseMap( &xWriter );
+
+    TEST_ASSERT_EQUAL( eCborErrInsufficentSpace,
+                       CBOR_WriterCheckError( &xWriter ) );
+    TEST_ASSERT_EQUAL( 2, CBOR_WriterLength( &xWriter ) );
+    TEST_ASSERT_EQUAL_HEX8( 0, ucBuffer[ 2 ] );
+}
+
+TEST( aws_cbor_writer, sets_err_when_closing_unopened_map )
+{
+    CBOR_WriterCloseMap( &xWriter );
+
+    TEST_ASSERT_EQUAL( eCborErrUnsupportedWriteOperation,
+                       CBOR_WriterCheckError( &xWriter ) );
+}
+
+TEST( aws_cbor_writer, CheckError_reports_open_map )
+{
+    CBOR_WriterOpenMap( &xWriter );
+
+    TEST_ASSERT_EQUAL( eCborErrDefaultError, CBOR_WriterCheckError( &xWriter ) );
+    TEST_ASSERT_EQUAL( eCborErrNullHandle, CBOR_WriterCheckError( NULL ) );
+}
+
+TEST( aws_cbor_writer, null_checks )
+{
+    xTEST_expect_assert( CBOR_WriterInit( NULL, ucBuffer, 0 ) );
+    xTEST_expect_assert( CBOR_WriterOpenMap( NULL ) );
+    xTEST_expect_assert( CBOR_WriterCloseMap( NULL ) );
+    xTEST_expect_assert( CBOR_WriterString( NULL, "" ) );
+    xTEST_expect_assert( CBOR_WriterString( &xWriter, NULL ) );
+    xTEST_expect_assert( CBOR_WriterInt( NULL, 0 ) );
+    xTEST_expect_assert( CBOR_WriterLength( NULL ) );
+}
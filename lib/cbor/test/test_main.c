@@ -35,6 +35,7 @@ static void runAllTests()
     RUN_TEST_GROUP(aws_cbor_mem);
     RUN_TEST_GROUP(aws_cbor_print);
     RUN_TEST_GROUP(aws_cbor_string);
+    RUN_TEST_GROUP(aws_cbor_writer);
 }
 
 int main(int argc, const char *argv[])
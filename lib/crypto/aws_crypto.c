@@ -40,6 +40,42 @@
 /* C runtime includes. */
 #include <string.h>
 
+/**
+ * @brief Build the x86 SHA extensions backend when the compiler can emit the
+ * instructions. Whether the CPU has them is checked at runtime.
+ */
+#ifndef cryptoconfigHASH_ENABLE_SHA_NI
+    #if ( defined( __clang__ ) || ( defined( __GNUC__ ) && ( __GNUC__ >= 5 ) ) ) && \
+    ( defined( __x86_64__ ) || defined( __i386__ ) )
+        #define cryptoconfigHASH_ENABLE_SHA_NI    1
+    #elif defined( _MSC_VER ) && ( _MSC_VER >= 1900 ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+        #define cryptoconfigHASH_ENABLE_SHA_NI    1
+    #else
+        #define cryptoconfigHASH_ENABLE_SHA_NI    0
+    #endif
+#endif
+
+#if ( cryptoconfigHASH_ENABLE_SHA_NI == 1 )
+    #include <immintrin.h>
+    #if defined( _MSC_VER )
+        #include <intrin.h>
+        #define cryptoSHA_NI_TARGET
+    #else
+        #include <cpuid.h>
+        #define cryptoSHA_NI_TARGET    __attribute__( ( target( "sha,sse4.1,ssse3" ) ) )
+    #endif
+#endif
+
+/**
+ * @brief Most streams CRYPTO_HashUpdateMulti hands to a backend at once.
+ */
+#define cryptoHASH_MULTI_MAX_STREAMS    8
+
+/**
+ * @brief SHA-256 block size in bytes.
+ */
+#define cryptoSHA256_BLOCK_BYTES        64
+
 /**
  * @brief Internal signature verification context structure
  */
@@ -48,9 +84,36 @@ typedef struct SignatureVerificationState
     BaseType_t xAsymmetricAlgorithm;
     BaseType_t xHashAlgorithm;
     mbedtls_sha1_context xSHA1Context;
-    mbedtls_sha256_context xSHA256Context;
+    void * pvSHA256Context;
 } SignatureVerificationState_t, * SignatureVerificationStatePtr_t;
 
+/**
+ * @brief Internal hash context structure. The backend state follows it.
+ */
+typedef struct HashState
+{
+    const CRYPTO_HashBackend_t * pxBackend;
+    uint64_t ullState[ 1 ];
+} HashState_t, * HashStatePtr_t;
+
+/**
+ * @brief SHA-256 state for backends that only provide the block function.
+ */
+typedef struct SHA256BlockState
+{
+    uint32_t ulState[ 8 ];
+    uint64_t ullLength;
+    uint8_t ucBlock[ cryptoSHA256_BLOCK_BYTES ];
+    size_t xBlockLength;
+} SHA256BlockState_t;
+
+/**
+ * @brief SHA-256 block function; consumes xBlockCount whole blocks.
+ */
+typedef void ( * SHA256Compress_t )( uint32_t * pulState,
+                                     const uint8_t * pucBlocks,
+                                     size_t xBlockCount );
+
 /*
  * Helper routines
  */
@@ -134,6 +197,464 @@ static BaseType_t prvVerifySignature( char * pcSignerCertificate,
     return xResult;
 }
 
+/*
+ * Hash backends
+ */
+
+/**
+ * @brief Starts an mbedTLS SHA-256 stream. This uses whatever mbedTLS is
+ * built with, including MBEDTLS_SHA256_ALT hardware engines.
+ */
+static void prvSHA256StartMbedTls( void * pvState )
+{
+    mbedtls_sha256_init( ( mbedtls_sha256_context * ) pvState );
+    ( void ) mbedtls_sha256_starts_ret( ( mbedtls_sha256_context * ) pvState, 0 );
+}
+
+static void prvSHA256UpdateMbedTls( void * pvState,
+                                    const uint8_t * pucData,
+                                    size_t xDataLength )
+{
+    ( void ) mbedtls_sha256_update_ret( ( mbedtls_sha256_context * ) pvState, pucData, xDataLength );
+}
+
+static void prvSHA256FinishMbedTls( void * pvState,
+                                    uint8_t * pucDigest )
+{
+    if( NULL != pucDigest )
+    {
+        ( void ) mbedtls_sha256_finish_ret( ( mbedtls_sha256_context * ) pvState, pucDigest );
+    }
+
+    mbedtls_sha256_free( ( mbedtls_sha256_context * ) pvState );
+}
+
+static const CRYPTO_HashBackend_t xHashBackendMbedTls =
+{
+    "mbedtls",
+    NULL,
+    sizeof( mbedtls_sha256_context ),
+    prvSHA256StartMbedTls,
+    prvSHA256UpdateMbedTls,
+    prvSHA256FinishMbedTls,
+    NULL
+};
+
+/*-----------------------------------------------------------*/
+
+#if ( cryptoconfigHASH_ENABLE_SHA_NI == 1 )
+
+/**
+ * @brief Starts a SHA-256 stream for a block function backend.
+ */
+    static void prvBlockStart( SHA256BlockState_t * pxState )
+    {
+        static const uint32_t ulInitialState[ 8 ] =
+        {
+            0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+            0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+        };
+
+        memset( pxState, 0, sizeof( *pxState ) );
+        memcpy( pxState->ulState, ulInitialState, sizeof( ulInitialState ) );
+    }
+
+/**
+ * @brief Completes a partly filled block.
+ *
+ * @return Number of bytes of pucData consumed. Unless the stream is now on a
+ * block boundary, this is all of them.
+ */
+    static size_t prvBlockUpdateHead( SHA256BlockState_t * pxState,
+                                      const uint8_t * pucData,
+                                      size_t xDataLength,
+                                      SHA256Compress_t xCompress )
+    {
+        size_t xUsed = 0;
+
+        if( 0 != pxState->xBlockLength )
+        {
+            xUsed = cryptoSHA256_BLOCK_BYTES - pxState->xBlockLength;
+
+            if( xUsed > xDataLength )
+            {
+                xUsed = xDataLength;
+            }
+
+            memcpy( &pxState->ucBlock[ pxState->xBlockLength ], pucData, xUsed );
+            pxState->xBlockLength += xUsed;
+            pxState->ullLength += xUsed;
+
+            if( cryptoSHA256_BLOCK_BYTES == pxState->xBlockLength )
+            {
+                xCompress( pxState->ulState, pxState->ucBlock, 1 );
+                pxState->xBlockLength = 0;
+            }
+        }
+
+        return xUsed;
+    }
+
+/**
+ * @brief Adds bytes to a SHA-256 stream for a block function backend.
+ */
+    static void prvBlockUpdate( SHA256BlockState_t * pxState,
+                                const uint8_t * pucData,
+                                size_t xDataLength,
+                                SHA256Compress_t xCompress )
+    {
+        size_t xUsed = prvBlockUpdateHead( pxState, pucData, xDataLength, xCompress );
+        size_t xBlocks;
+
+        pucData += xUsed;
+        xDataLength -= xUsed;
+        xBlocks = xDataLength / cryptoSHA256_BLOCK_BYTES;
+
+        if( 0 != xBlocks )
+        {
+            xCompress( pxState->ulState, pucData, xBlocks );
+            xUsed = xBlocks * cryptoSHA256_BLOCK_BYTES;
+            pucData += xUsed;
+            xDataLength -= xUsed;
+            pxState->ullLength += xUsed;
+        }
+
+        /* Keep the tail for the next call. */
+        memcpy( pxState->ucBlock, pucData, xDataLength );
+        pxState->xBlockLength += xDataLength;
+        pxState->ullLength += xDataLength;
+    }
+
+/**
+ * @brief Pads and completes a SHA-256 stream for a block function backend.
+ */
+    static void prvBlockFinish( SHA256BlockState_t * pxState,
+                                uint8_t * pucDigest,
+                                SHA256Compress_t xCompress )
+    {
+        uint64_t ullBits = pxState->ullLength * 8u;
+        BaseType_t x;
+
+        if( NULL != pucDigest )
+        {
+            pxState->ucBlock[ pxState->xBlockLength++ ] = 0x80;
+
+            if( pxState->xBlockLength > ( cryptoSHA256_BLOCK_BYTES - 8 ) )
+            {
+                memset( &pxState->ucBlock[ pxState->xBlockLength ], 0, cryptoSHA256_BLOCK_BYTES - pxState->xBlockLength );
+                xCompress( pxState->ulState, pxState->ucBlock, 1 );
+                pxState->xBlockLength = 0;
+            }
+
+            memset( &pxState->ucBlock[ pxState->xBlockLength ], 0, cryptoSHA256_BLOCK_BYTES - 8 - pxState->xBlockLength );
+
+            for( x = 0; x < 8; x++ )
+            {
+                pxState->ucBlock[ cryptoSHA256_BLOCK_BYTES - 1 - x ] = ( uint8_t ) ( ullBits >> ( 8 * x ) );
+            }
+
+            xCompress( pxState->ulState, pxState->ucBlock, 1 );
+
+            for( x = 0; x < 8; x++ )
+            {
+                pucDigest[ 4 * x ] = ( uint8_t ) ( pxState->ulState[ x ] >> 24 );
+                pucDigest[ 4 * x + 1 ] = ( uint8_t ) ( pxState->ulState[ x ] >> 16 );
+                pucDigest[ 4 * x + 2 ] = ( uint8_t ) ( pxState->ulState[ x ] >> 8 );
+                pucDigest[ 4 * x + 3 ] = ( uint8_t ) ( pxState->ulState[ x ] );
+            }
+        }
+
+        memset( pxState, 0, sizeof( *pxState ) );
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief SHA-256 round constants.
+ */
+    static const uint32_t ulSHA256RoundConstants[ 64 ] =
+    {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+    };
+
+/**
+ * @brief Reports whether the CPU has the SHA extensions and the SSSE3 and
+ * SSE4.1 instructions used alongside them.
+ */
+    static BaseType_t prvShaNiIsSupported( void )
+    {
+        uint32_t ulLeaf7Ebx = 0;
+        uint32_t ulLeaf1Ecx = 0;
+
+        #if defined( _MSC_VER )
+            int lRegisters[ 4 ];
+
+            __cpuid( lRegisters, 0 );
+
+            if( lRegisters[ 0 ] >= 7 )
+            {
+                __cpuidex( lRegisters, 7, 0 );
+                ulLeaf7Ebx = ( uint32_t ) lRegisters[ 1 ];
+            }
+
+            __cpuid( lRegisters, 1 );
+            ulLeaf1Ecx = ( uint32_t ) lRegisters[ 2 ];
+        #else
+            unsigned int ulEax, ulEbx, ulEcx, ulEdx;
+
+            if( __get_cpuid_max( 0, NULL ) >= 7 )
+            {
+                __cpuid_count( 7, 0, ulEax, ulEbx, ulEcx, ulEdx );
+                ulLeaf7Ebx = ulEbx;
+            }
+
+            if( 0 != __get_cpuid( 1, &ulEax, &ulEbx, &ulEcx, &ulEdx ) )
+            {
+                ulLeaf1Ecx = ulEcx;
+            }
+        #endif
+
+        return ( ( 0 != ( ulLeaf7Ebx & ( 1UL << 29 ) ) ) && /* SHA */
+                 ( 0 != ( ulLeaf1Ecx & ( 1UL << 19 ) ) ) && /* SSE4.1 */
+                 ( 0 != ( ulLeaf1Ecx & ( 1UL << 9 ) ) ) ) ? pdTRUE : pdFALSE; /* SSSE3 */
+    }
+
+/**
+ * @brief Hashes xBlockCount blocks on each of xLanes independent streams
+ * (one or two) with the SHA extensions. The lanes are interleaved so that one
+ * stream's rounds fill the latency of the other's.
+ */
+    cryptoSHA_NI_TARGET static void prvSHA256CompressShaNiLanes( uint32_t * const * ppulStates,
+                                                                 const uint8_t * const * ppucBlocks,
+                                                                 size_t xLanes,
+                                                                 size_t xBlockCount )
+    {
+        const __m128i xByteSwap = _mm_set_epi64x( 0x0C0D0E0F08090A0BLL, 0x0405060700010203LL );
+        __m128i xABEF[ 2 ], xCDGH[ 2 ], xSavedABEF[ 2 ], xSavedCDGH[ 2 ];
+        __m128i xW[ 2 ][ 4 ];
+        __m128i xMessage, xTemp;
+        const uint8_t * pucBlock[ 2 ];
+        size_t xLane, xGroup, xOffset;
+
+        /* Load the state, rearranged into the ABEF and CDGH order the
+         * instructions use. */
+        for( xLane = 0; xLane < xLanes; xLane++ )
+        {
+            xTemp = _mm_shuffle_epi32( _mm_loadu_si128( ( const __m128i * ) &ppulStates[ xLane ][ 0 ] ), 0xB1 );
+            xCDGH[ xLane ] = _mm_shuffle_epi32( _mm_loadu_si128( ( const __m128i * ) &ppulStates[ xLane ][ 4 ] ), 0x1B );
+            xABEF[ xLane ] = _mm_alignr_epi8( xTemp, xCDGH[ xLane ], 8 );
+            xCDGH[ xLane ] = _mm_blend_epi16( xCDGH[ xLane ], xTemp, 0xF0 );
+            pucBlock[ xLane ] = ppucBlocks[ xLane ];
+        }
+
+        for( xOffset = 0; xOffset < xBlockCount * cryptoSHA256_BLOCK_BYTES; xOffset += cryptoSHA256_BLOCK_BYTES )
+        {
+            for( xLane = 0; xLane < xLanes; xLane++ )
+            {
+                xSavedABEF[ xLane ] = xABEF[ xLane ];
+                xSavedCDGH[ xLane ] = xCDGH[ xLane ];
+            }
+
+            /* Each group is four rounds; the message schedule is computed
+             * four words at a time in a ring of four vectors. */
+            for( xGroup = 0; xGroup < 16; xGroup++ )
+            {
+                for( xLane = 0; xLane < xLanes; xLane++ )
+                {
+                    if( xGroup < 4 )
+                    {
+                        xW[ xLane ][ xGroup ] = _mm_shuffle_epi8(
+                            _mm_loadu_si128( ( const __m128i * ) &pucBlock[ xLane ][ xOffset + 16 * xGroup ] ),
+                            xByteSwap );
+                    }
+                    else
+                    {
+                        xTemp = _mm_sha256msg1_epu32( xW[ xLane ][ xGroup & 3 ], xW[ xLane ][ ( xGroup + 1 ) & 3 ] );
+                        xTemp = _mm_add_epi32( xTemp, _mm_alignr_epi8( xW[ xLane ][ ( xGroup + 3 ) & 3 ], xW[ xLane ][ ( xGroup + 2 ) & 3 ], 4 ) );
+                        xW[ xLane ][ xGroup & 3 ] = _mm_sha256msg2_epu32( xTemp, xW[ xLane ][ ( xGroup + 3 ) & 3 ] );
+                    }
+
+                    xMessage = _mm_add_epi32( xW[ xLane ][ xGroup & 3 ],
+                                              _mm_loadu_si128( ( const __m128i * ) &ulSHA256RoundConstants[ 4 * xGroup ] ) );
+                    xCDGH[ xLane ] = _mm_sha256rnds2_epu32( xCDGH[ xLane ], xABEF[ xLane ], xMessage );
+                    xMessage = _mm_shuffle_epi32( xMessage, 0x0E );
+                    xABEF[ xLane ] = _mm_sha256rnds2_epu32( xABEF[ xLane ], xCDGH[ xLane ], xMessage );
+                }
+            }
+
+            for( xLane = 0; xLane < xLanes; xLane++ )
+            {
+                xABEF[ xLane ] = _mm_add_epi32( xABEF[ xLane ], xSavedABEF[ xLane ] );
+                xCDGH[ xLane ] = _mm_add_epi32( xCDGH[ xLane ], xSavedCDGH[ xLane ] );
+            }
+        }
+
+        /* Store the state back in ABCDEFGH order. */
+        for( xLane = 0; xLane < xLanes; xLane++ )
+        {
+            xTemp = _mm_shuffle_epi32( xABEF[ xLane ], 0x1B );
+            xCDGH[ xLane ] = _mm_shuffle_epi32( xCDGH[ xLane ], 0xB1 );
+            _mm_storeu_si128( ( __m128i * ) &ppulStates[ xLane ][ 0 ], _mm_blend_epi16( xTemp, xCDGH[ xLane ], 0xF0 ) );
+            _mm_storeu_si128( ( __m128i * ) &ppulStates[ xLane ][ 4 ], _mm_alignr_epi8( xCDGH[ xLane ], xTemp, 8 ) );
+        }
+    }
+
+    static void prvSHA256CompressShaNi( uint32_t * pulState,
+                                        const uint8_t * pucBlocks,
+                                        size_t xBlockCount )
+    {
+        prvSHA256CompressShaNiLanes( &pulState, &pucBlocks, 1, xBlockCount );
+    }
+
+    static void prvSHA256StartShaNi( void * pvState )
+    {
+        prvBlockStart( ( SHA256BlockState_t * ) pvState );
+    }
+
+    static void prvSHA256UpdateShaNi( void * pvState,
+                                      const uint8_t * pucData,
+                                      size_t xDataLength )
+    {
+        prvBlockUpdate( ( SHA256BlockState_t * ) pvState, pucData, xDataLength, prvSHA256CompressShaNi );
+    }
+
+    static void prvSHA256FinishShaNi( void * pvState,
+                                      uint8_t * pucDigest )
+    {
+        prvBlockFinish( ( SHA256BlockState_t * ) pvState, pucDigest, prvSHA256CompressShaNi );
+    }
+
+/**
+ * @brief Hashes streams two at a time. The whole blocks the two streams have
+ * in common are hashed together; the rest of each stream on its own.
+ */
+    static void prvSHA256UpdateMultiShaNi( void * const * ppvStates,
+                                           const uint8_t * const * ppucData,
+                                           const size_t * pxDataLength,
+                                           size_t xCount )
+    {
+        SHA256BlockState_t * pxState[ 2 ];
+        uint32_t * pulState[ 2 ];
+        const uint8_t * pucData[ 2 ];
+        size_t xLength[ 2 ];
+        size_t xStream, xLane, xUsed, xBlocks;
+
+        for( xStream = 0; xStream < xCount; xStream += 2 )
+        {
+            if( xStream + 1 == xCount )
+            {
+                prvSHA256UpdateShaNi( ppvStates[ xStream ], ppucData[ xStream ], pxDataLength[ xStream ] );
+                break;
+            }
+
+            for( xLane = 0; xLane < 2; xLane++ )
+            {
+                pxState[ xLane ] = ( SHA256BlockState_t * ) ppvStates[ xStream + xLane ];
+                pulState[ xLane ] = pxState[ xLane ]->ulState;
+                xUsed = prvBlockUpdateHead( pxState[ xLane ],
+                                            ppucData[ xStream + xLane ],
+                                            pxDataLength[ xStream + xLane ],
+                                            prvSHA256CompressShaNi );
+                pucData[ xLane ] = ppucData[ xStream + xLane ] + xUsed;
+                xLength[ xLane ] = pxDataLength[ xStream + xLane ] - xUsed;
+            }
+
+            xBlocks = xLength[ 0 ] / cryptoSHA256_BLOCK_BYTES;
+
+            if( ( xLength[ 1 ] / cryptoSHA256_BLOCK_BYTES ) < xBlocks )
+            {
+                xBlocks = xLength[ 1 ] / cryptoSHA256_BLOCK_BYTES;
+            }
+
+            if( 0 != xBlocks )
+            {
+                prvSHA256CompressShaNiLanes( pulState, pucData, 2, xBlocks );
+            }
+
+            for( xLane = 0; xLane < 2; xLane++ )
+            {
+                xUsed = xBlocks * cryptoSHA256_BLOCK_BYTES;
+                pxState[ xLane ]->ullLength += xUsed;
+                prvBlockUpdate( pxState[ xLane ],
+                                pucData[ xLane ] + xUsed,
+                                xLength[ xLane ] - xUsed,
+                                prvSHA256CompressShaNi );
+            }
+        }
+    }
+
+    static const CRYPTO_HashBackend_t xHashBackendShaNi =
+    {
+        "sha-ni",
+        prvShaNiIsSupported,
+        sizeof( SHA256BlockState_t ),
+        prvSHA256StartShaNi,
+        prvSHA256UpdateShaNi,
+        prvSHA256FinishShaNi,
+        prvSHA256UpdateMultiShaNi
+    };
+
+#endif /* if ( cryptoconfigHASH_ENABLE_SHA_NI == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+#ifdef cryptoconfigHASH_BACKEND_PORT
+    extern const CRYPTO_HashBackend_t cryptoconfigHASH_BACKEND_PORT;
+#endif
+
+/**
+ * @brief Hash backends, in order of preference.
+ */
+static const CRYPTO_HashBackend_t * const pxHashBackends[] =
+{
+#ifdef cryptoconfigHASH_BACKEND_PORT
+    &cryptoconfigHASH_BACKEND_PORT,
+#endif
+#if ( cryptoconfigHASH_ENABLE_SHA_NI == 1 )
+    &xHashBackendShaNi,
+#endif
+    &xHashBackendMbedTls
+};
+
+/**
+ * @brief Backend used by new hash contexts, chosen on first use.
+ */
+static const CRYPTO_HashBackend_t * pxSelectedHashBackend = NULL;
+
+/**
+ * @brief Reports whether a hash backend can run on this CPU.
+ */
+static BaseType_t prvHashBackendUsable( const CRYPTO_HashBackend_t * pxBackend )
+{
+    return ( ( NULL == pxBackend->pxIsSupported ) ||
+             ( pdTRUE == pxBackend->pxIsSupported() ) ) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief Returns the backend for new hash contexts.
+ */
+static const CRYPTO_HashBackend_t * prvHashBackend( void )
+{
+    const CRYPTO_HashBackend_t * pxBackend = pxSelectedHashBackend;
+
+    if( NULL == pxBackend )
+    {
+        /* Selection always gives the same answer, so racing tasks at worst
+         * repeat it. */
+        pxBackend = CRYPTO_HashGetBackend( 0 );
+        pxSelectedHashBackend = pxBackend;
+    }
+
+    return pxBackend;
+}
+
 /*
  * Interface routines
  */
@@ -188,8 +709,13 @@ BaseType_t CRYPTO_SignatureVerificationStart( void ** ppvContext,
         }
         else
         {
-            mbedtls_sha256_init( &pxCtx->xSHA256Context );
-            ( void )mbedtls_sha256_starts_ret( &pxCtx->xSHA256Context, 0 );
+            xResult = CRYPTO_HashStart( &pxCtx->pvSHA256Context, cryptoHASH_ALGORITHM_SHA256 );
+
+            if( pdFALSE == xResult )
+            {
+                vPortFree( pxCtx );
+                *ppvContext = NULL;
+            }
         }
     }
 
@@ -215,7 +741,7 @@ void CRYPTO_SignatureVerificationUpdate( void * pvContext,
     }
     else
     {
-        ( void )mbedtls_sha256_update_ret( &pxCtx->xSHA256Context, pucData, xDataLength );
+        CRYPTO_HashUpdate( pxCtx->pvSHA256Context, pucData, xDataLength );
     }
 }
 
@@ -253,7 +779,8 @@ BaseType_t CRYPTO_SignatureVerificationFinal( void * pvContext,
 			}
 			else
 			{
-				(void)mbedtls_sha256_finish_ret (&pxCtx->xSHA256Context, ucSHA1or256);
+				CRYPTO_HashFinish (pxCtx->pvSHA256Context, ucSHA1or256);
+				pxCtx->pvSHA256Context = NULL;
 				pucHash = ucSHA1or256;
 				xHashLength = cryptoSHA256_DIGEST_BYTES;
 			}
@@ -272,6 +799,10 @@ BaseType_t CRYPTO_SignatureVerificationFinal( void * pvContext,
 		else
 		{
 			/* Allow function to be called with only the context pointer for cleanup after a failure. */
+			if (cryptoHASH_ALGORITHM_SHA256 == pxCtx->xHashAlgorithm)
+			{
+				CRYPTO_HashFinish (pxCtx->pvSHA256Context, NULL);
+			}
 		}
 		/*
 		 * Clean-up
@@ -280,3 +811,159 @@ BaseType_t CRYPTO_SignatureVerificationFinal( void * pvContext,
 	}
     return xResult;
 }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Enumerates the hash backends usable on this CPU.
+ */
+const CRYPTO_HashBackend_t * CRYPTO_HashGetBackend( UBaseType_t uxIndex )
+{
+    const CRYPTO_HashBackend_t * pxBackend = NULL;
+    size_t x;
+
+    for( x = 0; ( x < sizeof( pxHashBackends ) / sizeof( pxHashBackends[ 0 ] ) ) && ( NULL == pxBackend ); x++ )
+    {
+        if( pdTRUE == prvHashBackendUsable( pxHashBackends[ x ] ) )
+        {
+            if( 0 == uxIndex )
+            {
+                pxBackend = pxHashBackends[ x ];
+            }
+            else
+            {
+                uxIndex--;
+            }
+        }
+    }
+
+    return pxBackend;
+}
+
+/**
+ * @brief Selects the backend used by hash contexts started from now on.
+ */
+BaseType_t CRYPTO_HashSetBackend( const CRYPTO_HashBackend_t * pxBackend )
+{
+    BaseType_t xResult = pdTRUE;
+
+    if( NULL == pxBackend )
+    {
+        pxSelectedHashBackend = CRYPTO_HashGetBackend( 0 );
+    }
+    else if( pdTRUE == prvHashBackendUsable( pxBackend ) )
+    {
+        pxSelectedHashBackend = pxBackend;
+    }
+    else
+    {
+        xResult = pdFALSE;
+    }
+
+    return xResult;
+}
+
+/**
+ * @brief Starts a hash computation on the selected backend.
+ */
+BaseType_t CRYPTO_HashStart( void ** ppvContext,
+                             BaseType_t xHashAlgorithm )
+{
+    BaseType_t xResult = pdFALSE;
+    const CRYPTO_HashBackend_t * pxBackend = prvHashBackend();
+    HashStatePtr_t pxCtx = NULL;
+
+    if( cryptoHASH_ALGORITHM_SHA256 == xHashAlgorithm )
+    {
+        pxCtx = ( HashStatePtr_t ) pvPortMalloc( sizeof( HashState_t ) + pxBackend->xStateSize ); /*lint !e9087 Allow casting void* to other types. */
+    }
+
+    if( NULL != pxCtx )
+    {
+        pxCtx->pxBackend = pxBackend;
+        pxBackend->pxStart( pxCtx->ullState );
+        *ppvContext = pxCtx;
+        xResult = pdTRUE;
+    }
+
+    return xResult;
+}
+
+/**
+ * @brief Adds bytes to an in-progress hash.
+ */
+void CRYPTO_HashUpdate( void * pvContext,
+                        const uint8_t * pucData,
+                        size_t xDataLength )
+{
+    HashStatePtr_t pxCtx = ( HashStatePtr_t ) pvContext; /*lint !e9087 Allow casting void* to other types. */
+
+    pxCtx->pxBackend->pxUpdate( pxCtx->ullState, pucData, xDataLength );
+}
+
+/**
+ * @brief Adds bytes to several independent in-progress hashes at once.
+ */
+void CRYPTO_HashUpdateMulti( void * const * ppvContexts,
+                             const uint8_t * const * ppucData,
+                             const size_t * pxDataLength,
+                             size_t xCount )
+{
+    void * pvStates[ cryptoHASH_MULTI_MAX_STREAMS ];
+    const CRYPTO_HashBackend_t * pxBackend;
+    HashStatePtr_t pxCtx;
+    size_t xFirst = 0;
+    size_t xBatch = 0;
+    size_t xStream;
+
+    /* Hand the backend runs of streams that it hashes, in batches. */
+    while( xFirst < xCount )
+    {
+        pxBackend = ( ( HashStatePtr_t ) ppvContexts[ xFirst ] )->pxBackend;
+
+        for( xBatch = 0;
+             ( xBatch < cryptoHASH_MULTI_MAX_STREAMS ) && ( xFirst + xBatch < xCount );
+             xBatch++ )
+        {
+            pxCtx = ( HashStatePtr_t ) ppvContexts[ xFirst + xBatch ];
+
+            if( pxCtx->pxBackend != pxBackend )
+            {
+                break;
+            }
+
+            pvStates[ xBatch ] = pxCtx->ullState;
+        }
+
+        if( ( NULL != pxBackend->pxUpdateMulti ) && ( xBatch > 1u ) )
+        {
+            pxBackend->pxUpdateMulti( pvStates, &ppucData[ xFirst ], &pxDataLength[ xFirst ], xBatch );
+        }
+        else
+        {
+            for( xStream = 0; xStream < xBatch; xStream++ )
+            {
+                pxBackend->pxUpdate( pvStates[ xStream ],
+                                     ppucData[ xFirst + xStream ],
+                                     pxDataLength[ xFirst + xStream ] );
+            }
+        }
+
+        xFirst += xBatch;
+    }
+}
+
+/**
+ * @brief Completes a hash and frees its context.
+ */
+void CRYPTO_HashFinish( void * pvContext,
+                        uint8_t * pucDigest )
+{
+    HashStatePtr_t pxCtx = ( HashStatePtr_t ) pvContext; /*lint !e9087 Allow casting void* to other types. */
+
+    if( NULL != pxCtx )
+    {
+        pxCtx->pxBackend->pxFinish( pxCtx->ullState, pucDigest );
+        vPortFree( pxCtx );
+    }
+}
@@ -58,15 +58,35 @@ static MQTTAgentHandle_t xDefenderMQTTAgent;
 static TaskHandle_t xDefenderTaskHandle = NULL;
 /* Timeout period for MQTT connections */
 static TickType_t xMQTTTimeoutPeriodTicks = pdMS_TO_TICKS( 10U * 1000U );
+/* The MQTT agent is owned by the application and must not be torn down */
+static DEFENDERBool_t xDefenderSharedAgent;
+/* Keep the agent's own connection open between reports */
+static DEFENDERBool_t xDefenderKeepConnection;
+/* Buffer the agent task encodes each report into */
+static uint8_t ucDefenderReportBuffer[ DEFENDER_REPORT_BUFFER_SIZE ];
+/* The agent's own MQTT agent has been created and not yet deleted */
+static DEFENDERBool_t xDefenderAgentCreated;
+/* The MQTT agent is connected to the endpoint */
+static DEFENDERBool_t xDefenderConnected;
+/* The accept and reject topics are subscribed on the current connection */
+static DEFENDERBool_t xDefenderSubscribed;
+
+/* Topics used to exchange reports with the DD service */
+#define defenderREPORT_TOPIC \
+    "$aws/things/" clientcredentialIOT_THING_NAME "/defender/metrics/cbor"
+#define defenderACCEPT_TOPIC    defenderREPORT_TOPIC "/accepted"
+#define defenderREJECT_TOPIC    defenderREPORT_TOPIC "/rejected"
 
 /**
  * @brief      Publishes metrics report to service
  *
- * @param[in]  xReport  The metrics report
+ * @param[in]  pucReport     The encoded metrics report
+ * @param[in]  lReportLength Length of the encoded report
  *
  * @return     Returns true if error occurred, false (0) on success
  */
-static DEFENDERBool_t prvPublishCborToDevDef( CBORHandle_t xReport );
+static DEFENDERBool_t prvPublishCborToDevDef( uint8_t const * pucReport,
+                                              int32_t lReportLength );
 
 /**
  * @brief      Subscribes to the report accept topic
@@ -88,6 +108,23 @@ static DEFENDERBool_t prvSubscribeToAcceptCbor( void );
  */
 static DEFENDERBool_t prvSubscribeToRejectCbor( void );
 
+/**
+ * @brief      Unsubscribes from a report topic
+ *
+ * @param[in]  pcTopic  The topic to unsubscribe from
+ *
+ * @return     Returns true if error occurred, false (0) on success
+ */
+static DEFENDERBool_t prvUnsubscribe( char const * pcTopic );
+
+/**
+ * @brief      Releases the connection resources held by the agent
+ *
+ * The agent's own connection is disconnected and deleted.  On a shared
+ * connection only the agent's subscriptions are removed.
+ */
+static void prvAgentCleanup( void );
+
 /**
  * @brief      Device Defender Agent Task
  *
@@ -119,11 +156,14 @@ static MQTTBool_t prvRejectCallback( void * pxPvPublishCallbackContext,
                                      MQTTPublishData_t const * pxPublishData );
 
 static DefenderState_t prvStateInit( void );
+static DefenderState_t prvStateStart( void );
 static DefenderState_t prvStateNewMQTT( void );
 static DefenderState_t prvStateConnectMqtt( void );
 static DefenderState_t prvStateDisconnectMqtt( void );
 static DefenderState_t prvStateSubscribe( void );
 static DefenderState_t prvStateCreateReport( void );
+static DefenderState_t prvStateReportSent( void );
+static DefenderState_t prvStateConnectionFailed( void );
 static DefenderState_t prvStateDeleteMqtt( void );
 static DefenderState_t prvStateSleep( void );
 
@@ -190,15 +230,15 @@ static void DEFENDER_StateFunctionSet( void )
     /* clang-format off */
     DEFENDER_States[ eDefenderStateInit ] = prvStateInit;
 
-    DEFENDER_States[ eDefenderStateStarted ] = prvStateNewMQTT;
+    DEFENDER_States[ eDefenderStateStarted ] = prvStateStart;
     DEFENDER_States[ eDefenderStateNewMqttFailed ] = prvStateSleep;
     DEFENDER_States[ eDefenderStateNewMqttSuccess ] = prvStateConnectMqtt;
     DEFENDER_States[ eDefenderStateConnectMqttFailed ] = prvStateDeleteMqtt;
     DEFENDER_States[ eDefenderStateConnectMqttSuccess ] = prvStateSubscribe;
-    DEFENDER_States[ eDefenderStateSubscribeMqttFailed ] = prvStateDisconnectMqtt;
+    DEFENDER_States[ eDefenderStateSubscribeMqttFailed ] = prvStateConnectionFailed;
     DEFENDER_States[ eDefenderStateSubscribeMqttSuccess ] = prvStateCreateReport;
-    DEFENDER_States[ eDefenderStateSubmitReportFailed ] = prvStateDisconnectMqtt;
-    DEFENDER_States[ eDefenderStateSubmitReportSuccess ] = prvStateDisconnectMqtt;
+    DEFENDER_States[ eDefenderStateSubmitReportFailed ] = prvStateConnectionFailed;
+    DEFENDER_States[ eDefenderStateSubmitReportSuccess ] = prvStateReportSent;
     DEFENDER_States[ eDefenderStateDisconnectFailed ] = prvStateDisconnectMqtt;
     DEFENDER_States[ eDefenderStateDisconnected ] = prvStateDeleteMqtt;
     DEFENDER_States[ eDefenderStateDeleteFailed ] = prvStateDeleteMqtt;
@@ -211,6 +251,23 @@ static DefenderState_t prvStateInit( void )
     return eDefenderStateStarted;
 }
 
+static DefenderState_t prvStateStart( void )
+{
+    /* Reuse the connection and subscriptions of the previous report */
+    if( xDefenderSubscribed )
+    {
+        return eDefenderStateSubscribeMqttSuccess;
+    }
+
+    /* A shared connection is up already, only the subscriptions are needed */
+    if( xDefenderConnected )
+    {
+        return eDefenderStateConnectMqttSuccess;
+    }
+
+    return prvStateNewMQTT();
+}
+
 static DefenderState_t prvStateNewMQTT( void )
 {
     MQTTAgentReturnCode_t xCreateResult =
@@ -221,6 +278,8 @@ static DefenderState_t prvStateNewMQTT( void )
         return eDefenderStateNewMqttFailed;
     }
 
+    xDefenderAgentCreated = eDefenderTrue;
+
     return eDefenderStateNewMqttSuccess;
 }
 
@@ -251,6 +310,8 @@ static DefenderState_t prvStateConnectMqtt( void )
         return eDefenderStateConnectMqttFailed;
     }
 
+    xDefenderConnected = eDefenderTrue;
+
     return eDefenderStateConnectMqttSuccess;
 }
 
@@ -266,14 +327,14 @@ static DefenderState_t prvStateSubscribe( void )
         return eDefenderStateSubscribeMqttFailed;
     }
 
+    xDefenderSubscribed = eDefenderTrue;
+
     return eDefenderStateSubscribeMqttSuccess;
 }
 
 static DEFENDERBool_t prvSubscribeToAcceptCbor( void )
 {
-    uint8_t * pucTopic = ( uint8_t * ) "$aws/things/"
-                         clientcredentialIOT_THING_NAME
-                         "/defender/metrics/cbor/accepted";
+    uint8_t * pucTopic = ( uint8_t * ) defenderACCEPT_TOPIC;
     MQTTAgentSubscribeParams_t xSubParams =
     {
         .pucTopic                 = pucTopic,
@@ -300,9 +361,7 @@ static MQTTBool_t xAcceptCallback( void * pxPvPublishCallbackContext,
 
 static DEFENDERBool_t prvSubscribeToRejectCbor( void )
 {
-    uint8_t * pucTopic = ( uint8_t * ) "$aws/things/"
-                         clientcredentialIOT_THING_NAME
-                         "/defender/metrics/cbor/rejected";
+    uint8_t * pucTopic = ( uint8_t * ) defenderREJECT_TOPIC;
     MQTTAgentSubscribeParams_t xSubParams =
     {
         .pucTopic                 = pucTopic,
@@ -327,20 +386,37 @@ static MQTTBool_t prvRejectCallback( void * pxPvPublishCallbackContext,
     return eMQTTFalse;
 }
 
+static DEFENDERBool_t prvUnsubscribe( char const * pcTopic )
+{
+    MQTTAgentUnsubscribeParams_t xUnsubParams =
+    {
+        .pucTopic      = ( uint8_t const * ) pcTopic,
+        .usTopicLength = ( uint16_t ) strlen( pcTopic ),
+    };
+    MQTTAgentReturnCode_t xUnsubResult = MQTT_AGENT_Unsubscribe(
+        xDefenderMQTTAgent, &xUnsubParams, xMQTTTimeoutPeriodTicks );
+
+    DEFENDERBool_t xError = eMQTTAgentSuccess != xUnsubResult;
+
+    return xError;
+}
+
 
 static DefenderState_t prvStateCreateReport( void )
 {
-    CBORHandle_t xReport;
+    uint8_t const * pucReport;
+    int32_t lReportLength = 0;
 
-    xReport = CreateReport();
+    pucReport = CreateReport( ucDefenderReportBuffer,
+                              sizeof( ucDefenderReportBuffer ),
+                              &lReportLength );
 
-    if( NULL == xReport )
+    if( NULL == pucReport )
     {
         return eDefenderStateSubmitReportFailed;
     }
 
-    DEFENDERBool_t xError = prvPublishCborToDevDef( xReport );
-    CBOR_Delete( &xReport );
+    DEFENDERBool_t xError = prvPublishCborToDevDef( pucReport, lReportLength );
 
     /* Wait for ack from service */
     vTaskDelay( pdMS_TO_TICKS( 10000 ) );
@@ -353,22 +429,18 @@ static DefenderState_t prvStateCreateReport( void )
     return eDefenderStateSubmitReportSuccess;
 }
 
-static DEFENDERBool_t prvPublishCborToDevDef( CBORHandle_t xReport )
+static DEFENDERBool_t prvPublishCborToDevDef( uint8_t const * pucReport,
+                                              int32_t lReportLength )
 {
-    uint8_t * pucTopic = ( uint8_t * )
-                         "$aws/things/"
-                         clientcredentialIOT_THING_NAME
-                         "/defender/metrics/cbor";
-    uint8_t const * pucBuffer = CBOR_GetRawBuffer( xReport );
-    int32_t lBufLen = CBOR_GetBufferSize( xReport );
+    uint8_t * pucTopic = ( uint8_t * ) defenderREPORT_TOPIC;
 
     MQTTAgentPublishParams_t xPubRecParams =
     {
         .pucTopic      = pucTopic,
         .usTopicLength = ( uint16_t ) strlen( ( char * ) pucTopic ),
         .xQoS          = eMQTTQoS0,
-        .pvData        = pucBuffer,
-        .ulDataLength  = lBufLen,
+        .pvData        = pucReport,
+        .ulDataLength  = ( uint32_t ) lReportLength,
     };
     MQTTAgentReturnCode_t xPublishResult = MQTT_AGENT_Publish(
         xDefenderMQTTAgent, &xPubRecParams, xMQTTTimeoutPeriodTicks );
@@ -385,8 +457,36 @@ static DEFENDERBool_t prvPublishCborToDevDef( CBORHandle_t xReport )
     return eDefenderFalse;
 }
 
+static DefenderState_t prvStateReportSent( void )
+{
+    /* Hold on to the connection and subscriptions for the next report */
+    if( xDefenderSharedAgent || xDefenderKeepConnection )
+    {
+        return eDefenderStateSleep;
+    }
+
+    return prvStateDisconnectMqtt();
+}
+
+static DefenderState_t prvStateConnectionFailed( void )
+{
+    /* The connection is suspect, so subscribe again before the next report */
+    xDefenderSubscribed = eDefenderFalse;
+
+    /* The application owns a shared connection and is the one to reconnect it */
+    if( xDefenderSharedAgent )
+    {
+        return eDefenderStateSleep;
+    }
+
+    return prvStateDisconnectMqtt();
+}
+
 static DefenderState_t prvStateDisconnectMqtt( void )
 {
+    /* Subscriptions do not outlive the connection */
+    xDefenderSubscribed = eDefenderFalse;
+
     if( eMQTTAgentSuccess
         != MQTT_AGENT_Disconnect(
             xDefenderMQTTAgent, xMQTTTimeoutPeriodTicks ) )
@@ -394,6 +494,8 @@ static DefenderState_t prvStateDisconnectMqtt( void )
         return eDefenderStateDisconnectFailed;
     }
 
+    xDefenderConnected = eDefenderFalse;
+
     return eDefenderStateDisconnected;
 }
 
@@ -404,6 +506,9 @@ static DefenderState_t prvStateDeleteMqtt( void )
         return eDefenderStateDeleteFailed;
     }
 
+    xDefenderAgentCreated = eDefenderFalse;
+    xDefenderConnected = eDefenderFalse;
+
     return eDefenderStateSleep;
 }
 
@@ -451,6 +556,33 @@ DefenderErr_t DEFENDER_ConnectionTimeoutSet( uint32_t ulTimeoutMs )
     return eDefenderErrSuccess;
 }
 
+DefenderErr_t DEFENDER_ConnectionSet( MQTTAgentHandle_t xMQTTAgent )
+{
+    if( NULL != xDefenderTaskHandle )
+    {
+        return eDefenderErrAlreadyStarted;
+    }
+
+    xDefenderSharedAgent = NULL != xMQTTAgent;
+    xDefenderConnected = xDefenderSharedAgent;
+    xDefenderSubscribed = eDefenderFalse;
+    xDefenderMQTTAgent = xMQTTAgent;
+
+    return eDefenderErrSuccess;
+}
+
+DefenderErr_t DEFENDER_KeepConnectionSet( bool xKeepConnection )
+{
+    if( NULL != xDefenderTaskHandle )
+    {
+        return eDefenderErrAlreadyStarted;
+    }
+
+    xDefenderKeepConnection = xKeepConnection;
+
+    return eDefenderErrSuccess;
+}
+
 DefenderReportStatus_t DEFENDER_ReportStatusGet( void )
 {
     DefenderReportStatus_t xReportStatus;
@@ -509,7 +641,6 @@ static void prvAgentLoop( void * params )
         if( xDefenderKill )
         {
             break;
-            /* TODO: Appropriately clean up resources on kill request */
         }
 
         eDefenderState = DEFENDER_StateFunction( eDefenderState );
@@ -518,11 +649,44 @@ static void prvAgentLoop( void * params )
         vTaskDelay( pdMS_TO_TICKS( lStatePeriodMS ) );
     }
 
+    prvAgentCleanup();
+
+    /* The next start begins with a fresh state machine */
+    eDefenderState = eDefenderStateInit;
+
     TaskHandle_t xTaskHandle = xDefenderTaskHandle;
     xDefenderTaskHandle = NULL;
     vTaskDelete( xTaskHandle );
 }
 
+static void prvAgentCleanup( void )
+{
+    if( xDefenderSharedAgent )
+    {
+        if( xDefenderSubscribed )
+        {
+            ( void ) prvUnsubscribe( defenderACCEPT_TOPIC );
+            ( void ) prvUnsubscribe( defenderREJECT_TOPIC );
+        }
+
+        xDefenderSubscribed = eDefenderFalse;
+
+        return;
+    }
+
+    if( xDefenderConnected )
+    {
+        ( void ) prvStateDisconnectMqtt();
+        xDefenderConnected = eDefenderFalse;
+    }
+
+    if( xDefenderAgentCreated )
+    {
+        ( void ) prvStateDeleteMqtt();
+        xDefenderAgentCreated = eDefenderFalse;
+    }
+}
+
 char const * DEFENDER_ErrAsString( DefenderErr_t eErrNum )
 {
     /* *INDENT-OFF* */
@@ -52,45 +52,41 @@ DefenderErr_t DEFENDER_MetricsInitFunc( DefenderMetric_t * xMetrics,
     return eDefenderErrSuccess;
 }
 
-CBORHandle_t CreateReport( void )
+uint8_t const * CreateReport( uint8_t * pucBuffer,
+                              size_t xBufferSize,
+                              int32_t * plReportLength )
 {
-    /*Create new empty report*/
-    CBORHandle_t xReport = CBOR_New( 0 );
-    /*Create new report header*/
-    CBORHandle_t xHeader = GetHeader();
+    CborWriter_t xWriter;
 
-    /*Copy header to the report*/
-    CBOR_AppendKeyWithMap( xReport, DEFENDER_HEADER_TAG, xHeader );
-    /*Delete the header*/
-    CBOR_Delete( &xHeader );
-    /*Create new empty metrics document*/
-    CBORHandle_t xMetrics = CBOR_New( 0 );
+    CBOR_WriterInit( &xWriter, pucBuffer, xBufferSize );
 
-    /*For each metric, append it to the metrics document*/
+    /*Open the report and write the header into it*/
+    CBOR_WriterOpenMap( &xWriter );
+    WriteHeader( &xWriter );
+
+    /*Open the metrics map*/
+    CBOR_WriterKeyOpenMap( &xWriter, DEFENDER_METRICS_TAG );
+
+    /*For each metric, write it into the metrics map*/
     for( int32_t lI = 0; lI < lMetricsCount; ++lI )
     {
         /*Update the date for the metric*/
         xMetricsList[ lI ]->UpdateMetric();
-        /*Get report from the metric*/
-        CBORHandle_t xMetric = xMetricsList[ lI ]->ReportMetric();
-        /*Copy the metric to the metrics document*/
-        CBOR_AppendMap( xMetrics, xMetric );
-        /*Delete the metric document*/
-        CBOR_Delete( &xMetric );
+        /*Write the metric to the report*/
+        xMetricsList[ lI ]->ReportMetric( &xWriter );
     }
 
-    /*Copy the metrics document to the report*/
-    CBOR_AppendKeyWithMap( xReport, DEFENDER_METRICS_TAG, xMetrics );
-    /*Delete the metrics document*/
-    CBOR_Delete( &xMetrics );
+    /*Close the metrics map and the report*/
+    CBOR_WriterCloseMap( &xWriter );
+    CBOR_WriterCloseMap( &xWriter );
 
-    /*If an error occurred */
-    if( eCborErrNoError != CBOR_CheckError( xReport ) )
+    /*If an error occurred, there is no report to send*/
+    if( eCborErrNoError != CBOR_WriterCheckError( &xWriter ) )
     {
-        /*Delete the report*/
-        CBOR_Delete( &xReport );
+        return NULL;
     }
 
-    /*Return the report*/
-    return xReport;
+    *plReportLength = CBOR_WriterLength( &xWriter );
+
+    return pucBuffer;
 }
@@ -32,11 +32,7 @@ struct DefenderMetric_s xDefenderMetricCpu_s =
 
 DefenderMetric_t xDEFENDER_metric_cpu = &xDefenderMetricCpu_s;
 
-CBORHandle_t CpuReportGet( void )
+void CpuReportGet( CborWriter_t * pxWriter )
 {
-    CBORHandle_t xCpuMetrics = CBOR_New( 0 );
-
-    CBOR_AssignKeyWithInt( xCpuMetrics, "cpu", CpuLoadGet() );
-
-    return xCpuMetrics;
+    CBOR_WriterKeyWithInt( pxWriter, "cpu", CpuLoadGet() );
 }
@@ -40,17 +40,15 @@ static uint32_t prvDEFENDER_ReportIdInit( void )
     return ulId;
 }
 
-CBORHandle_t GetHeader( void )
+void WriteHeader( CborWriter_t * pxWriter )
 {
     lReportId = lReportId == 0 ? prvDEFENDER_ReportIdInit() : lReportId;
 
-    CBORHandle_t xHeader = CBOR_New( 0 );
-
-    CBOR_AssignKeyWithInt( xHeader, DEFENDER_REPORT_ID_TAG, ++lReportId );
-    CBOR_AssignKeyWithString(
-        xHeader, DEFENDER_VERSION_TAG, pcDEFENDER_METRICS_VERSION );
-
-    return xHeader;
+    CBOR_WriterKeyOpenMap( pxWriter, DEFENDER_HEADER_TAG );
+    CBOR_WriterKeyWithInt( pxWriter, DEFENDER_REPORT_ID_TAG, ++lReportId );
+    CBOR_WriterKeyWithString(
+        pxWriter, DEFENDER_VERSION_TAG, pcDEFENDER_METRICS_VERSION );
+    CBOR_WriterCloseMap( pxWriter );
 }
 
 int32_t GetLastReportId( void )
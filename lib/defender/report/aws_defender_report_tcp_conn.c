@@ -32,20 +32,11 @@ static struct DefenderMetric_s xDefenderTCPConnectionsS =
 
 DefenderMetric_t xDefenderTCPConnections = &xDefenderTCPConnectionsS;
 
-CBORHandle_t TcpConnReportGet( void )
+void TcpConnReportGet( CborWriter_t * pxWriter )
 {
-    CBORHandle_t xEstConn = CBOR_New( 0 );
-
-    CBOR_AssignKeyWithInt( xEstConn, DEFENDER_TOTAL_TAG, TcpConnGet() );
-
-    CBORHandle_t xTcpConnMetrics = CBOR_New( 0 );
-    CBOR_AssignKeyWithMap( xTcpConnMetrics, DEFENDER_EST_CONN_TAG, xEstConn );
-    CBOR_Delete( &xEstConn );
-
-    CBORHandle_t xTcpConnReport = CBOR_New( 0 );
-    CBOR_AssignKeyWithMap(
-        xTcpConnReport, DEFENDER_TCP_CONN_TAG, xTcpConnMetrics );
-    CBOR_Delete( &xTcpConnMetrics );
-
-    return xTcpConnReport;
+    CBOR_WriterKeyOpenMap( pxWriter, DEFENDER_TCP_CONN_TAG );
+    CBOR_WriterKeyOpenMap( pxWriter, DEFENDER_EST_CONN_TAG );
+    CBOR_WriterKeyWithInt( pxWriter, DEFENDER_TOTAL_TAG, TcpConnGet() );
+    CBOR_WriterCloseMap( pxWriter );
+    CBOR_WriterCloseMap( pxWriter );
 }
@@ -32,11 +32,7 @@ static struct DefenderMetric_s xDefenderMetricUptimeS =
 
 DefenderMetric_t xDefenderMetricUptime = &xDefenderMetricUptimeS;
 
-CBORHandle_t UptimeReportGet( void )
+void UptimeReportGet( CborWriter_t * pxWriter )
 {
-    CBORHandle_t xUptimeMetrics = CBOR_New( 0 );
-
-    CBOR_AppendKeyWithInt( xUptimeMetrics, "ut", UptimeSecondsGet() );
-
-    return xUptimeMetrics;
+    CBOR_WriterKeyWithInt( pxWriter, "ut", UptimeSecondsGet() );
 }
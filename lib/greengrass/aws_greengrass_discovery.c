@@ -48,6 +48,7 @@
 #include "jsmn.h"
 
 /* Standard includes. */
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -58,8 +59,11 @@
  * the certificate and IP address.
  */
 /** @{ */
+#define ggdJSON_FILE_GROUPS          "GGGroups"
 #define ggdJSON_FILE_GROUPID         "GGGroupId"
+#define ggdJSON_FILE_CORES           "Cores"
 #define ggdJSON_FILE_THING_ARN       "thingArn"
+#define ggdJSON_FILE_CONNECTIVITY    "Connectivity"
 #define ggdJSON_FILE_HOST_ADDRESS    "HostAddress"
 #define ggdJSON_FILE_CERTIFICATE     "CAs"
 #define ggdJSON_FILE_PORT_NUMBER     "PortNumber"
@@ -76,20 +80,202 @@
 #define ggJSON_CONVERTION_RADIX    10
 
 /**
- * @brief HTTP field to get the length of the JSON file.
+ * @brief HTTP response parsing.
  *
- * The server respond with the JSON file encapsulated in
- * a HTTP header. The header is parsed bytes per bytes until
- * "content-length:" is found. then the length string is stored
- * into a temporary buffer of the ggJSON_PARSING_TMP_BUFFER_SIZE
- * size. Then a string to int conversion is performed to get the size
- * of the JSON file.
+ * The response is read through a buffer of ggdconfigHTTP_READ_BUFFER_SIZE
+ * bytes rather than one byte per call to GGD_SecureConnect_Read(). Header
+ * lines longer than ggdHTTP_LINE_SIZE are truncated, which is harmless as
+ * only the status line and the length headers are used.
  */
 /** @{ */
-#define ggdHTTP_CONTENT_LENGTH_STRING     "content-length:"
-#define ggJSON_PARSING_TMP_BUFFER_SIZE    10
+#define ggdHTTP_STATUS_OK                   200
+#define ggdHTTP_LINE_SIZE                   64
+#define ggdHTTP_CONTENT_LENGTH_HEADER       "content-length"
+#define ggdHTTP_TRANSFER_ENCODING_HEADER    "transfer-encoding"
+#define ggdHTTP_CHUNKED_ENCODING            "chunked"
+#define ggdHTTP_CHUNK_SIZE_RADIX            16
 /** @} */
 
+/**
+ * @brief State of the discovery HTTP response being read.
+ */
+typedef struct
+{
+    Socket_t xSocket;         /**< Socket the response is read from. */
+    uint32_t ulStart;         /**< Index of the first unread byte in cBuffer. */
+    uint32_t ulEnd;           /**< Index of the end of the data in cBuffer. */
+    uint32_t ulContentLength; /**< Body length, when the body is not chunked. */
+    uint32_t ulRemaining;     /**< Bytes left to read in the body or the current chunk. */
+    BaseType_t xHeadersRead;  /**< pdTRUE once the headers have been read. */
+    BaseType_t xChunked;      /**< pdTRUE if the body uses chunked transfer encoding. */
+    BaseType_t xChunkRead;    /**< pdTRUE once a chunk has been read, so a CRLF precedes the next chunk size. */
+    BaseType_t xBodyRead;     /**< pdTRUE once the whole body has been read. */
+    char cBuffer[ ggdconfigHTTP_READ_BUFFER_SIZE ];
+} GGD_HTTPReader_t;
+
+/**
+ * @brief Streaming JSON parser limits.
+ *
+ * The discovery document is parsed as it is received, so it never has to be
+ * held in memory. Only the keys listed in pcJSONKeys are recognised, so keys
+ * are stored in a small buffer and longer keys are ignored.
+ */
+/** @{ */
+#define ggdJSON_MAX_DEPTH                   16
+#define ggdJSON_MAX_KEY_SIZE                16
+#define ggdJSON_ARRAY                       0x80U
+#define ggdJSON_UNICODE_ESCAPE_DIGITS       4
+#define ggdJSON_NO_CERTIFICATE              0xFFFFFFFFUL
+/** @} */
+
+/**
+ * @brief Keys of the discovery document used by the streaming parser.
+ *
+ * The order must match pcJSONKeys.
+ */
+typedef enum
+{
+    eJSONKeyOther = 0,
+    eJSONKeyGroups,
+    eJSONKeyGroupId,
+    eJSONKeyCores,
+    eJSONKeyThingArn,
+    eJSONKeyConnectivity,
+    eJSONKeyHostAddress,
+    eJSONKeyPortNumber,
+    eJSONKeyCertificates,
+    eJSONKeyCount
+} GGD_JSONKey_t;
+
+static const char * const pcJSONKeys[ eJSONKeyCount ] = /*lint !e971 can use char without signed/unsigned. */
+{
+    "",
+    ggdJSON_FILE_GROUPS,
+    ggdJSON_FILE_GROUPID,
+    ggdJSON_FILE_CORES,
+    ggdJSON_FILE_THING_ARN,
+    ggdJSON_FILE_CONNECTIVITY,
+    ggdJSON_FILE_HOST_ADDRESS,
+    ggdJSON_FILE_PORT_NUMBER,
+    ggdJSON_FILE_CERTIFICATE
+};
+
+/**
+ * @brief What the streaming parser expects next.
+ */
+typedef enum
+{
+    eJSONStateValue,
+    eJSONStateKey,
+    eJSONStateColon,
+    eJSONStateNext,
+    eJSONStateString,
+    eJSONStateNumber,
+    eJSONStateLiteral,
+    eJSONStateDone
+} GGD_JSONState_t;
+
+/**
+ * @brief Where the characters of the string being parsed go.
+ */
+typedef enum
+{
+    eJSONSinkNone,
+    eJSONSinkKey,
+    eJSONSinkMatch,
+    eJSONSinkStore
+} GGD_JSONSink_t;
+
+/**
+ * @brief State of the streaming discovery document parser.
+ *
+ * The certificate and the connectivity of the selected core are written to
+ * the caller's buffer as they are parsed. Data written for a group or core
+ * that turns out not to be the selected one is discarded when the group or
+ * core ends, so the buffer only needs to hold the selected core's data.
+ */
+typedef struct
+{
+    const HostParameters_t * pxHostParameters;
+    BaseType_t xAutoSelectFlag;
+
+    char * pcBuffer; /*lint !e971 can use char without signed/unsigned. */
+    uint32_t ulBufferSize;
+    uint32_t ulBufferUsed;
+    BaseType_t xBufferFull;
+
+    GGD_HostAddressData_t * pxHostAddressData;
+    uint32_t ulMaxHostAddresses;
+    uint32_t ulHostAddresses;
+
+    GGD_JSONState_t eState;
+    uint8_t ucDepth;
+    uint8_t ucContainers[ ggdJSON_MAX_DEPTH ]; /**< Key of each open container, or'ed with ggdJSON_ARRAY for arrays. */
+    uint8_t ucKey;                             /**< Key of the value being parsed. */
+    char cKey[ ggdJSON_MAX_KEY_SIZE ];         /*lint !e971 can use char without signed/unsigned. */
+    uint8_t ucKeyLength;
+
+    GGD_JSONSink_t eSink;
+    uint8_t ucEscape; /**< 1 after a backslash, then counts the digits of a \\u escape. */
+    uint16_t usUnicode;
+    const char * pcMatch; /*lint !e971 can use char without signed/unsigned. */
+    uint32_t ulMatchIndex;
+    BaseType_t xMatch;
+    BaseType_t * pxMatchResult;
+    uint32_t ulNumber;
+    BaseType_t xPortNumber;
+
+    uint8_t ucGroupDepth; /**< Depth of the group object being parsed, or 0. */
+    uint8_t ucCoreDepth;
+    uint8_t ucHostDepth;
+    uint8_t ucCertificatesDepth;
+    BaseType_t xGroupMatch;
+    BaseType_t xGroupSelected;
+    BaseType_t xCoreMatch;
+    BaseType_t xCoreSelected;
+    uint32_t ulGroupMark;
+    uint32_t ulGroupHostMark;
+    uint32_t ulCoreMark;
+    uint32_t ulCoreHostMark;
+    uint32_t ulHostMark;
+    const char * pcHostAddress; /*lint !e971 can use char without signed/unsigned. */
+    uint16_t usPort;
+    BaseType_t xPortFound;
+    uint32_t ulCertificateStart;
+    uint32_t ulCertificateSize;
+    BaseType_t xError;
+} GGD_JSONStream_t;
+
+/**
+ * @brief The discovery response being read.
+ *
+ * Only one discovery request can be in progress at a time.
+ */
+static GGD_HTTPReader_t xHTTPReader;
+
+/**
+ * @brief Result of the last successful discovery.
+ *
+ * The addresses and certificate stay in the caller's buffer, so the cache
+ * records a checksum of the part of the buffer they use, to detect that it
+ * was reused for something else.
+ */
+typedef struct
+{
+    const char * pcBuffer;      /**< Buffer holding the certificate and addresses. */ /*lint !e971 can use char without signed/unsigned. */
+    uint32_t ulBufferSize;      /**< Size of the buffer. */
+    uint32_t ulUsedSize;        /**< Number of bytes of the buffer covered by the checksum. */
+    uint32_t ulChecksum;        /**< Checksum of the used part of the buffer. */
+    TickType_t xTimeStamp;      /**< Time the discovery was made. */
+    uint32_t ulHostAddressCount; /**< Number of addresses, the one that answered last first. */
+    GGD_HostAddressData_t xHostAddressData[ ggdconfigMAX_CORE_ENDPOINTS ]; /**< Addresses of the core. */
+} GGD_DiscoveryCache_t;
+
+/**
+ * @brief The cached discovery result, valid if ulHostAddressCount is not 0.
+ */
+static GGD_DiscoveryCache_t xDiscoveryCache;
+
 /**
  * @brief Size of the IP address character string
  *
@@ -146,13 +332,89 @@ static BaseType_t prvIsIPvalid( const char * pcIP,
 /** @} */
 
 /**
- * @brief Search for length field in server HTTP response
+ * @brief Buffered HTTP response reader.
+ *
+ * prvHTTPReadHeaders() reads the status line and headers of the response.
+ * prvHTTPReadBody() then returns the body, with any chunked transfer
+ * encoding removed, as pointers into the read buffer. If pcDestination is
+ * not NULL and nothing is buffered, the body is instead read straight into
+ * pcDestination, so large reads are not split into buffer sized pieces.
+ */
+/** @{ */
+static void prvHTTPReaderInit( GGD_HTTPReader_t * pxReader,
+                               Socket_t xSocket );
+static BaseType_t prvHTTPFill( GGD_HTTPReader_t * pxReader );
+static BaseType_t prvHTTPReadLine( GGD_HTTPReader_t * pxReader,
+                                   char * pcLine, /*lint !e971 can use char without signed/unsigned. */
+                                   uint32_t ulLineSize );
+static const char * prvHTTPHeaderValue( const char * pcLine, /*lint !e971 can use char without signed/unsigned. */
+                                        const char * pcName ); /*lint !e971 can use char without signed/unsigned. */
+static BaseType_t prvHTTPReadHeaders( GGD_HTTPReader_t * pxReader );
+static BaseType_t prvHTTPReadBody( GGD_HTTPReader_t * pxReader,
+                                   char * pcDestination,  /*lint !e971 can use char without signed/unsigned. */
+                                   const char ** ppcData, /*lint !e971 can use char without signed/unsigned. */
+                                   uint32_t ulMaxLength,
+                                   uint32_t * pulLength );
+/** @} */
+
+/**
+ * @brief Streaming discovery document parser.
  *
- * Small helper function that return true when the
- * length field is found in the html header.
+ * The parser is fed the document in pieces of any size, and keeps the
+ * certificate and connectivity of the selected core.
+ */
+/** @{ */
+static void prvJSONStreamInit( GGD_JSONStream_t * pxStream,
+                               char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                               uint32_t ulBufferSize,
+                               const HostParameters_t * pxHostParameters,
+                               BaseType_t xAutoSelectFlag,
+                               GGD_HostAddressData_t * pxHostAddressData,
+                               uint32_t ulMaxHostAddresses );
+static BaseType_t prvJSONStreamFeed( GGD_JSONStream_t * pxStream,
+                                     const char * pcData, /*lint !e971 can use char without signed/unsigned. */
+                                     uint32_t ulLength );
+static BaseType_t prvJSONStreamResult( GGD_JSONStream_t * pxStream,
+                                       uint32_t * pulHostAddressCount );
+static void prvJSONStreamPut( GGD_JSONStream_t * pxStream,
+                              char cChar );     /*lint !e971 can use char without signed/unsigned. */
+static void prvJSONStreamToken( GGD_JSONStream_t * pxStream,
+                                char cChar );   /*lint !e971 can use char without signed/unsigned. */
+static void prvJSONStreamStringChar( GGD_JSONStream_t * pxStream,
+                                     char cChar ); /*lint !e971 can use char without signed/unsigned. */
+static void prvJSONStreamOutput( GGD_JSONStream_t * pxStream,
+                                 char cChar );  /*lint !e971 can use char without signed/unsigned. */
+static void prvJSONStreamStartString( GGD_JSONStream_t * pxStream );
+static void prvJSONStreamEndString( GGD_JSONStream_t * pxStream );
+static void prvJSONStreamEndNumber( GGD_JSONStream_t * pxStream );
+static void prvJSONStreamPush( GGD_JSONStream_t * pxStream,
+                               BaseType_t xArray );
+static void prvJSONStreamPop( GGD_JSONStream_t * pxStream,
+                              BaseType_t xArray );
+/** @} */
+
+/**
+ * @brief Discovery cache helpers.
  */
-static BaseType_t prvCheckForContentLengthString( uint8_t * pucIndex,
-                                                  const char cNewChar ); /*lint !e971 can use char without signed/unsigned. */
+/** @{ */
+static uint32_t prvDiscoveryCacheUsedSize( const char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                           const GGD_HostAddressData_t * pxHostAddressData,
+                                           uint32_t ulHostAddressCount );
+static uint32_t prvDiscoveryCacheChecksum( const char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                           uint32_t ulSize );
+static BaseType_t prvDiscoveryCacheGet( const char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                        uint32_t ulBufferSize,
+                                        GGD_HostAddressData_t * pxHostAddressData,
+                                        uint32_t * pulHostAddressCount );
+static void prvDiscoveryCacheSet( const char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                  uint32_t ulBufferSize,
+                                  const GGD_HostAddressData_t * pxHostAddressData,
+                                  uint32_t ulHostAddressCount,
+                                  uint32_t ulConnectedIndex );
+static BaseType_t prvConnectToCore( const GGD_HostAddressData_t * pxHostAddressData,
+                                    uint32_t ulHostAddressCount,
+                                    uint32_t * pulConnectedIndex );
+/** @} */
 
 /*-----------------------------------------------------------*/
 
@@ -161,69 +423,90 @@ BaseType_t GGD_GetGGCIPandCertificate( char * pcBuffer, /*lint !e971 can use cha
                                        GGD_HostAddressData_t * pxHostAddressData )
 {
     Socket_t xSocket;
-    uint32_t ulJSONFileSize = 0;
-    BaseType_t xJSONFileRetrieveCompleted = pdFALSE;
-    uint32_t ulByteRead = 0;
-    BaseType_t xStatus;
+    GGD_HostAddressData_t xHostAddressData[ ggdconfigMAX_CORE_ENDPOINTS ];
+    uint32_t ulHostAddressCount = 0;
+    uint32_t ulValidCount = 0;
+    uint32_t ulConnectedIndex = 0;
+    uint32_t ulIndex;
+    BaseType_t xStatus = pdFAIL;
 
     configASSERT( pxHostAddressData != NULL );
     configASSERT( pcBuffer != NULL );
 
-    xStatus = GGD_JSONRequestStart( &xSocket );
-
-    if( xStatus == pdPASS )
+    if( prvDiscoveryCacheGet( pcBuffer,
+                              ulBufferSize,
+                              xHostAddressData,
+                              &ulHostAddressCount ) == pdPASS )
     {
-        xStatus = GGD_JSONRequestGetSize( &xSocket, &ulJSONFileSize );
+        xStatus = prvConnectToCore( xHostAddressData,
+                                    ulHostAddressCount,
+                                    &ulConnectedIndex );
+
+        if( xStatus == pdFAIL )
+        {
+            ggdconfigPRINT( "GGD - Cached core not reachable, discovering again\r\n" );
+            GGD_InvalidateCache();
+        }
     }
 
-    if( xStatus == pdPASS )
+    if( xStatus == pdFAIL )
     {
-        /* Loop until the full JSON is retrieved. */
-        do {
-            xStatus = GGD_JSONRequestGetFile( &xSocket,
-                                              &pcBuffer[ulByteRead],
-                                              ulBufferSize - ulByteRead,
-                                              &ulByteRead,
-                                              &xJSONFileRetrieveCompleted,
-                                              ulJSONFileSize ); /*lint !e644 ulJSONFileSize has been initialized if code reaches here. */
-        } while ( ( xStatus == pdPASS ) && ( xJSONFileRetrieveCompleted != pdTRUE ) && ( ulBufferSize - ulByteRead ) > 0 );
+        ulHostAddressCount = ( uint32_t ) ggdconfigMAX_CORE_ENDPOINTS;
+        xStatus = GGD_JSONRequestStart( &xSocket );
 
-        /* If the JSON file was not completely received and there
-         * is no space left in the buffer, it means that the buffer
-         * is not large enough to hold the complete GreenGrass
-         * Discovery document. The user should increase the size of
-         * the buffer. */
-        if( ( xJSONFileRetrieveCompleted == pdFALSE ) && ( ( ulBufferSize - ulByteRead ) ==  0 ) )
+        if( xStatus == pdPASS )
         {
-            ggdconfigPRINT( "[ERROR] The supplied buffer is not large enough to hold the GreenGrass discovery document. \r\n" );
-            ggdconfigPRINT( "[ERROR] Consider increasing the size of the supplied buffer. \r\n" );
+            /* Only the certificate and the connectivity of the selected core are
+             * kept, so the buffer does not need to hold the whole document. */
+            xStatus = GGD_JSONRequestParse( &xSocket,
+                                            pcBuffer,
+                                            ulBufferSize,
+                                            NULL,
+                                            pdTRUE,
+                                            xHostAddressData,
+                                            &ulHostAddressCount );
         }
 
-        if( xSocket != SOCKETS_INVALID_SOCKET )             /* Check connection is closed. */
+        if( xStatus == pdPASS )
         {
-            GGD_JSONRequestAbort( &xSocket );
-            xStatus = pdFAIL;
-        }
+            /* Only keep the addresses that can be connected to. */
+            for( ulIndex = 0; ulIndex < ulHostAddressCount; ulIndex++ )
+            {
+                if( prvIsIPvalid( xHostAddressData[ ulIndex ].pcHostAddress,
+                                  ( uint32_t ) strlen( xHostAddressData[ ulIndex ].pcHostAddress ) ) == pdTRUE )
+                {
+                    xHostAddressData[ ulValidCount ] = xHostAddressData[ ulIndex ];
+                    ulValidCount++;
+                }
+            }
 
-        if( xJSONFileRetrieveCompleted != pdTRUE )
-        {
-            xStatus = pdFAIL;
+            ulHostAddressCount = ulValidCount;
+            xStatus = prvConnectToCore( xHostAddressData,
+                                        ulHostAddressCount,
+                                        &ulConnectedIndex );
         }
     }
 
     if( xStatus == pdPASS )
     {
-        xStatus = GGD_GetIPandCertificateFromJSON( pcBuffer,
-                                                   ulJSONFileSize,
-                                                   NULL,
-                                                   pxHostAddressData,
-                                                   pdTRUE );
+        *pxHostAddressData = xHostAddressData[ ulConnectedIndex ];
+        prvDiscoveryCacheSet( pcBuffer,
+                              ulBufferSize,
+                              xHostAddressData,
+                              ulHostAddressCount,
+                              ulConnectedIndex );
     }
 
     return xStatus;
 }
 /*-----------------------------------------------------------*/
 
+void GGD_InvalidateCache( void )
+{
+    xDiscoveryCache.ulHostAddressCount = 0;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t GGD_JSONRequestStart( Socket_t * pxSocket )
 {
     GGD_HostAddressData_t xHostAddressData;
@@ -244,6 +527,9 @@ BaseType_t GGD_JSONRequestStart( Socket_t * pxSocket )
 
     if( xStatus == pdPASS )
     {
+        /* Start reading a new response. */
+        prvHTTPReaderInit( &xHTTPReader, *pxSocket );
+
         /* Send HTTP request over secure connection (HTTPS) to get the GGC JSON file. */
         xStatus = GGD_SecureConnect_Send( ggdCLOUD_DISCOVERY_ADDRESS,
                                           ( uint32_t ) sizeof( ggdCLOUD_DISCOVERY_ADDRESS ) - 1,
@@ -268,90 +554,32 @@ BaseType_t GGD_JSONRequestStart( Socket_t * pxSocket )
 BaseType_t GGD_JSONRequestGetSize( Socket_t * pxSocket,
                                    uint32_t * pulJSONFileSize )
 {
-    BaseType_t xStatus = pdFAIL;
-    BaseType_t xReadStatus = pdFAIL;
-    char cBuffer[ ggJSON_PARSING_TMP_BUFFER_SIZE ]; /*lint !e971 can use char without signed/unsigned. */
-    char cReadChar;                                 /*lint !e971 can use char without signed/unsigned. */
-    uint32_t ulReadSize;
-    uint8_t ucContentLengthIndex = 0;
-    uint8_t ucLengthStrIndex;
-
+    BaseType_t xStatus;
 
-    /****** Parse the header until the begining of the content length string is found. *****/
     configASSERT( pxSocket != NULL );
     configASSERT( pulJSONFileSize != NULL );
-    memset( cBuffer, 0, sizeof( cBuffer ) );
 
-    do
+    if( xHTTPReader.xSocket != *pxSocket )
     {
-        xReadStatus = GGD_SecureConnect_Read( &cReadChar,
-                                              ( uint32_t ) 1,
-                                              *pxSocket,
-                                              &ulReadSize );
+        prvHTTPReaderInit( &xHTTPReader, *pxSocket );
+    }
 
-        /** Check if we have found the end of header. */
-        if( prvCheckForContentLengthString( &ucContentLengthIndex, cReadChar ) == pdTRUE )
-        {
-            xStatus = pdPASS;
-            break;
-        }
-    } while( ( xReadStatus == pdPASS ) && ( ulReadSize == ( uint32_t ) 1 ) );
+    xStatus = prvHTTPReadHeaders( &xHTTPReader );
 
-    if( xStatus == pdPASS )
+    if( ( xStatus == pdPASS ) && ( xHTTPReader.xChunked == pdTRUE ) )
     {
-        /****** Get JSON file Size. *****/
-        for( ucLengthStrIndex = ( uint8_t ) 0;
-             ucLengthStrIndex < ( uint8_t ) ggJSON_PARSING_TMP_BUFFER_SIZE;
-             ucLengthStrIndex++ )
-        {
-            xReadStatus = GGD_SecureConnect_Read( &cBuffer[ ucLengthStrIndex ],
-                                                  ( uint32_t ) 1,
-                                                  *pxSocket,
-                                                  &ulReadSize );
-
-            if( ( xReadStatus == pdFAIL ) || ( ulReadSize != ( uint32_t ) 1 ) )
-            {
-                ggdconfigPRINT( "JSON parsing could not get JSON file Size.\r\n" );
-                xStatus = pdFAIL;
-                break;
-            }
-        }
+        /* The size of a chunked response is not known until it has all been
+         * received. */
+        ggdconfigPRINT( "JSON parsing - Chunked response, use GGD_JSONRequestParse\r\n" );
+        xStatus = pdFAIL;
     }
 
     if( xStatus == pdPASS )
     {
         /* Add 1 because at the end of the JSON file the escape character '\0' will be added. */
-        *pulJSONFileSize =
-            ( uint32_t ) strtoul( cBuffer, NULL, ggJSON_CONVERTION_RADIX )
-            + ( uint32_t ) 1; /*lint !e645 if code reaches here, cBuffer has been inialized. */
-
-        /****** Go to the end of the header *****/
-        xStatus = pdFAIL;
-
-        do
-        {
-            xReadStatus = GGD_SecureConnect_Read( &cBuffer[ 3 ],
-                                                  ( uint32_t ) 1,
-                                                  *pxSocket,
-                                                  &ulReadSize );
-
-            /* Check if we have found the end of header. */
-            if( ( cBuffer[ 0 ] == '\r' ) &&
-                ( cBuffer[ 1 ] == '\n' ) &&
-                ( cBuffer[ 2 ] == '\r' ) &&
-                ( cBuffer[ 3 ] == '\n' ) )
-            {
-                xStatus = pdPASS;
-                break;
-            }
-
-            cBuffer[ 0 ] = cBuffer[ 1 ];
-            cBuffer[ 1 ] = cBuffer[ 2 ];
-            cBuffer[ 2 ] = cBuffer[ 3 ];
-        } while( ( xReadStatus == pdPASS ) && ( ulReadSize == ( uint32_t ) 1 ) );
+        *pulJSONFileSize = xHTTPReader.ulContentLength + ( uint32_t ) 1;
     }
-
-    if( xStatus == pdFAIL )
+    else
     {
         /* Don't forget to close the connection. */
         GGD_SecureConnect_Disconnect( pxSocket );
@@ -369,7 +597,9 @@ BaseType_t GGD_JSONRequestGetFile( Socket_t * pxSocket,
                                    const uint32_t pulJSONFileSize )
 {
     BaseType_t xStatus;
-    uint32_t ulDataSizeRead;
+    uint32_t ulDataSizeRead = 0;
+    uint32_t ulLength;
+    const char * pcData; /*lint !e971 can use char without signed/unsigned. */
 
     configASSERT( pxSocket != NULL );
     configASSERT( pulByteRead != NULL );
@@ -378,10 +608,34 @@ BaseType_t GGD_JSONRequestGetFile( Socket_t * pxSocket,
 
     *pxJSONFileRetrieveCompleted = pdFALSE;
 
-    xStatus = GGD_SecureConnect_Read( pcBuffer,
-                                      ulBufferSize,
-                                      *pxSocket,
-                                      &ulDataSizeRead );
+    if( xHTTPReader.xSocket != *pxSocket )
+    {
+        prvHTTPReaderInit( &xHTTPReader, *pxSocket );
+    }
+
+    xStatus = prvHTTPReadHeaders( &xHTTPReader );
+
+    /* Fill as much of the buffer as the body allows. */
+    while( ( xStatus == pdPASS ) &&
+           ( ulDataSizeRead < ulBufferSize ) &&
+           ( xHTTPReader.xBodyRead == pdFALSE ) )
+    {
+        xStatus = prvHTTPReadBody( &xHTTPReader,
+                                   &pcBuffer[ ulDataSizeRead ],
+                                   &pcData,
+                                   ulBufferSize - ulDataSizeRead,
+                                   &ulLength );
+
+        if( xStatus == pdPASS )
+        {
+            if( pcData != &pcBuffer[ ulDataSizeRead ] )
+            {
+                memcpy( &pcBuffer[ ulDataSizeRead ], pcData, ulLength );
+            }
+
+            ulDataSizeRead += ulLength;
+        }
+    }
 
     if( xStatus == pdPASS )
     {
@@ -406,8 +660,13 @@ BaseType_t GGD_JSONRequestGetFile( Socket_t * pxSocket,
         }
         else
         {
-            /* Add the escape character. */
-            pcBuffer[ pulJSONFileSize - ( uint32_t ) 1 ] = '\0';
+            /* Add the escape character after the last byte read, if this
+             * part of the buffer has room for it. */
+            if( ulDataSizeRead < ulBufferSize )
+            {
+                pcBuffer[ ulDataSizeRead ] = '\0';
+            }
+
             *pxJSONFileRetrieveCompleted = pdTRUE;
         }
     }
@@ -430,6 +689,75 @@ BaseType_t GGD_JSONRequestGetFile( Socket_t * pxSocket,
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t GGD_JSONRequestParse( Socket_t * pxSocket,
+                                 char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                 const uint32_t ulBufferSize,
+                                 const HostParameters_t * pxHostParameters,
+                                 const BaseType_t xAutoSelectFlag,
+                                 GGD_HostAddressData_t * pxHostAddressData,
+                                 uint32_t * pulHostAddressCount )
+{
+    GGD_JSONStream_t xStream;
+    BaseType_t xStatus;
+    uint32_t ulLength;
+    const char * pcData; /*lint !e971 can use char without signed/unsigned. */
+
+    configASSERT( pxSocket != NULL );
+    configASSERT( pcBuffer != NULL );
+    configASSERT( pxHostAddressData != NULL );
+    configASSERT( pulHostAddressCount != NULL );
+
+    if( xAutoSelectFlag == pdFALSE )
+    {
+        configASSERT( pxHostParameters != NULL );
+    }
+
+    if( xHTTPReader.xSocket != *pxSocket )
+    {
+        prvHTTPReaderInit( &xHTTPReader, *pxSocket );
+    }
+
+    prvJSONStreamInit( &xStream,
+                       pcBuffer,
+                       ulBufferSize,
+                       pxHostParameters,
+                       xAutoSelectFlag,
+                       pxHostAddressData,
+                       *pulHostAddressCount );
+
+    xStatus = prvHTTPReadHeaders( &xHTTPReader );
+
+    /* Parse the body straight out of the read buffer as it arrives. Parsing
+     * errors are reported by prvJSONStreamResult(). */
+    while( ( xStatus == pdPASS ) && ( xHTTPReader.xBodyRead == pdFALSE ) )
+    {
+        xStatus = prvHTTPReadBody( &xHTTPReader,
+                                   NULL,
+                                   &pcData,
+                                   ( uint32_t ) ggdconfigHTTP_READ_BUFFER_SIZE,
+                                   &ulLength );
+
+        if( ( xStatus == pdPASS ) && ( prvJSONStreamFeed( &xStream, pcData, ulLength ) == pdFAIL ) )
+        {
+            break;
+        }
+    }
+
+    GGD_SecureConnect_Disconnect( pxSocket );
+
+    if( xStatus == pdPASS )
+    {
+        xStatus = prvJSONStreamResult( &xStream, pulHostAddressCount );
+    }
+    else
+    {
+        ggdconfigPRINT( "JSON parsing - JSON file retrieval failed\r\n" );
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
 void GGD_JSONRequestAbort( Socket_t * pxSocket )
 {
     configASSERT( pxSocket != NULL );
@@ -859,27 +1187,1173 @@ static BaseType_t prvGGDGetIPOnInterface( char * pcJSONFile, /*lint !e971 can us
     return xStatus;
 }
 /*-----------------------------------------------------------*/
+static void prvHTTPReaderInit( GGD_HTTPReader_t * pxReader,
+                               Socket_t xSocket )
+{
+    pxReader->xSocket = xSocket;
+    pxReader->ulStart = 0;
+    pxReader->ulEnd = 0;
+    pxReader->ulContentLength = 0;
+    pxReader->ulRemaining = 0;
+    pxReader->xHeadersRead = pdFALSE;
+    pxReader->xChunked = pdFALSE;
+    pxReader->xChunkRead = pdFALSE;
+    pxReader->xBodyRead = pdFALSE;
+}
+/*-----------------------------------------------------------*/
 
-static BaseType_t prvCheckForContentLengthString( uint8_t * pucIndex,
-                                                  const char cNewChar ) /*lint !e971 can use char without signed/unsigned. */
+static BaseType_t prvHTTPFill( GGD_HTTPReader_t * pxReader )
 {
-    BaseType_t xMatch = pdFALSE;
+    BaseType_t xStatus = pdPASS;
+    uint32_t ulReadSize = 0;
 
-    if( cNewChar == ggdHTTP_CONTENT_LENGTH_STRING[ *pucIndex ] )
+    /* Only read when everything buffered has been consumed. */
+    if( pxReader->ulStart == pxReader->ulEnd )
     {
-        ( *pucIndex )++;
+        pxReader->ulStart = 0;
+        pxReader->ulEnd = 0;
+
+        xStatus = GGD_SecureConnect_Read( pxReader->cBuffer,
+                                          ( uint32_t ) sizeof( pxReader->cBuffer ),
+                                          pxReader->xSocket,
+                                          &ulReadSize );
 
-        if( *pucIndex == ( uint8_t ) ( sizeof( ggdHTTP_CONTENT_LENGTH_STRING ) - ( uint8_t ) 1 ) ) /*lint !e734 string length is not going to increase and is lower than 255 characters. */
+        if( ( xStatus == pdPASS ) && ( ulReadSize > ( uint32_t ) 0 ) )
         {
-            xMatch = pdTRUE;
+            pxReader->ulEnd = ulReadSize;
+        }
+        else
+        {
+            xStatus = pdFAIL;
         }
     }
-    else
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvHTTPReadLine( GGD_HTTPReader_t * pxReader,
+                                   char * pcLine, /*lint !e971 can use char without signed/unsigned. */
+                                   uint32_t ulLineSize )
+{
+    BaseType_t xStatus;
+    uint32_t ulLength = 0;
+    char cChar; /*lint !e971 can use char without signed/unsigned. */
+
+    for( ; ; )
+    {
+        xStatus = prvHTTPFill( pxReader );
+
+        if( xStatus == pdFAIL )
+        {
+            break;
+        }
+
+        cChar = pxReader->cBuffer[ pxReader->ulStart ];
+        pxReader->ulStart++;
+
+        if( cChar == '\n' )
+        {
+            break;
+        }
+
+        /* Drop the carriage return, and truncate long lines. */
+        if( ( cChar != '\r' ) && ( ulLength < ( ulLineSize - ( uint32_t ) 1 ) ) )
+        {
+            pcLine[ ulLength ] = cChar;
+            ulLength++;
+        }
+    }
+
+    pcLine[ ulLength ] = '\0';
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static const char * prvHTTPHeaderValue( const char * pcLine, /*lint !e971 can use char without signed/unsigned. */
+                                        const char * pcName ) /*lint !e971 can use char without signed/unsigned. */
+{
+    const char * pcValue = NULL; /*lint !e971 can use char without signed/unsigned. */
+    uint32_t ulIndex = 0;
+
+    /* Header names are not case sensitive. pcName is in lower case. */
+    while( ( pcName[ ulIndex ] != '\0' ) &&
+           ( ( char ) tolower( ( int ) pcLine[ ulIndex ] ) == pcName[ ulIndex ] ) )
     {
-        *pucIndex = 0;
+        ulIndex++;
     }
 
-    return xMatch;
+    if( ( pcName[ ulIndex ] == '\0' ) && ( pcLine[ ulIndex ] == ':' ) )
+    {
+        pcValue = &pcLine[ ulIndex + ( uint32_t ) 1 ];
+
+        while( ( *pcValue == ' ' ) || ( *pcValue == '\t' ) )
+        {
+            pcValue++;
+        }
+    }
+
+    return pcValue;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvHTTPReadHeaders( GGD_HTTPReader_t * pxReader )
+{
+    BaseType_t xStatus = pdPASS;
+    BaseType_t xLengthFound = pdFALSE;
+    char cLine[ ggdHTTP_LINE_SIZE ]; /*lint !e971 can use char without signed/unsigned. */
+    const char * pcValue;            /*lint !e971 can use char without signed/unsigned. */
+    uint32_t ulIndex;
+    uint32_t ulLength;
+
+    if( pxReader->xHeadersRead == pdFALSE )
+    {
+        /* Status line, for example "HTTP/1.1 200 OK". */
+        xStatus = prvHTTPReadLine( pxReader, cLine, ( uint32_t ) sizeof( cLine ) );
+
+        if( xStatus == pdPASS )
+        {
+            pcValue = strchr( cLine, ' ' );
+
+            if( ( strncmp( cLine, "HTTP/", 5 ) != 0 ) ||
+                ( pcValue == NULL ) ||
+                ( strtoul( pcValue, NULL, ggJSON_CONVERTION_RADIX ) != ( unsigned long ) ggdHTTP_STATUS_OK ) )
+            {
+                ggdconfigPRINT( "JSON request - Unexpected response: %s\r\n", cLine );
+                xStatus = pdFAIL;
+            }
+        }
+
+        /* Header lines, up to the empty line that ends them. */
+        while( xStatus == pdPASS )
+        {
+            xStatus = prvHTTPReadLine( pxReader, cLine, ( uint32_t ) sizeof( cLine ) );
+
+            if( ( xStatus == pdFAIL ) || ( cLine[ 0 ] == '\0' ) )
+            {
+                break;
+            }
+
+            pcValue = prvHTTPHeaderValue( cLine, ggdHTTP_CONTENT_LENGTH_HEADER );
+
+            if( pcValue != NULL )
+            {
+                pxReader->ulContentLength = ( uint32_t ) strtoul( pcValue, NULL, ggJSON_CONVERTION_RADIX );
+                xLengthFound = pdTRUE;
+            }
+
+            pcValue = prvHTTPHeaderValue( cLine, ggdHTTP_TRANSFER_ENCODING_HEADER );
+
+            if( pcValue != NULL )
+            {
+                /* Chunked is always the last encoding applied. */
+                ulLength = ( uint32_t ) strlen( pcValue );
+
+                while( ( ulLength > ( uint32_t ) 0 ) && ( pcValue[ ulLength - ( uint32_t ) 1 ] == ' ' ) )
+                {
+                    ulLength--;
+                }
+
+                if( ulLength >= ( uint32_t ) ( sizeof( ggdHTTP_CHUNKED_ENCODING ) - 1 ) )
+                {
+                    pcValue = &pcValue[ ulLength - ( uint32_t ) ( sizeof( ggdHTTP_CHUNKED_ENCODING ) - 1 ) ];
+
+                    for( ulIndex = 0; ulIndex < ( uint32_t ) ( sizeof( ggdHTTP_CHUNKED_ENCODING ) - 1 ); ulIndex++ )
+                    {
+                        if( ( char ) tolower( ( int ) pcValue[ ulIndex ] ) != ggdHTTP_CHUNKED_ENCODING[ ulIndex ] )
+                        {
+                            break;
+                        }
+                    }
+
+                    if( ulIndex == ( uint32_t ) ( sizeof( ggdHTTP_CHUNKED_ENCODING ) - 1 ) )
+                    {
+                        pxReader->xChunked = pdTRUE;
+                    }
+                }
+            }
+        }
+
+        if( xStatus == pdPASS )
+        {
+            if( pxReader->xChunked == pdTRUE )
+            {
+                /* The length of the first chunk is read with the body. */
+                pxReader->ulRemaining = 0;
+            }
+            else if( xLengthFound == pdTRUE )
+            {
+                pxReader->ulRemaining = pxReader->ulContentLength;
+                pxReader->xBodyRead = ( pxReader->ulContentLength == ( uint32_t ) 0 ) ? pdTRUE : pdFALSE;
+            }
+            else
+            {
+                ggdconfigPRINT( "JSON request - Response length unknown\r\n" );
+                xStatus = pdFAIL;
+            }
+        }
+
+        pxReader->xHeadersRead = xStatus;
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvHTTPReadBody( GGD_HTTPReader_t * pxReader,
+                                   char * pcDestination,  /*lint !e971 can use char without signed/unsigned. */
+                                   const char ** ppcData, /*lint !e971 can use char without signed/unsigned. */
+                                   uint32_t ulMaxLength,
+                                   uint32_t * pulLength )
+{
+    BaseType_t xStatus = pdPASS;
+    char cLine[ ggdHTTP_LINE_SIZE ]; /*lint !e971 can use char without signed/unsigned. */
+    char * pcEnd;                    /*lint !e971 can use char without signed/unsigned. */
+    uint32_t ulLength;
+
+    *ppcData = NULL;
+    *pulLength = 0;
+
+    /* Start the next chunk, if the current one has been read. */
+    if( ( pxReader->xChunked == pdTRUE ) &&
+        ( pxReader->ulRemaining == ( uint32_t ) 0 ) &&
+        ( pxReader->xBodyRead == pdFALSE ) )
+    {
+        if( pxReader->xChunkRead == pdTRUE )
+        {
+            /* The CRLF that ends the previous chunk. */
+            xStatus = prvHTTPReadLine( pxReader, cLine, ( uint32_t ) sizeof( cLine ) );
+        }
+
+        if( xStatus == pdPASS )
+        {
+            /* The chunk size, in hex, optionally followed by extensions. */
+            xStatus = prvHTTPReadLine( pxReader, cLine, ( uint32_t ) sizeof( cLine ) );
+        }
+
+        if( xStatus == pdPASS )
+        {
+            pxReader->ulRemaining = ( uint32_t ) strtoul( cLine, &pcEnd, ggdHTTP_CHUNK_SIZE_RADIX );
+            pxReader->xChunkRead = pdTRUE;
+
+            if( pcEnd == cLine )
+            {
+                ggdconfigPRINT( "JSON request - Bad chunk size\r\n" );
+                xStatus = pdFAIL;
+            }
+        }
+
+        if( ( xStatus == pdPASS ) && ( pxReader->ulRemaining == ( uint32_t ) 0 ) )
+        {
+            /* The last chunk, followed by optional trailers and an empty line. */
+            do
+            {
+                xStatus = prvHTTPReadLine( pxReader, cLine, ( uint32_t ) sizeof( cLine ) );
+            } while( ( xStatus == pdPASS ) && ( cLine[ 0 ] != '\0' ) );
+
+            pxReader->xBodyRead = pdTRUE;
+        }
+    }
+
+    if( ( xStatus == pdPASS ) &&
+        ( pxReader->xBodyRead == pdFALSE ) &&
+        ( pcDestination != NULL ) &&
+        ( pxReader->ulStart == pxReader->ulEnd ) )
+    {
+        ulLength = ( ulMaxLength < pxReader->ulRemaining ) ? ulMaxLength : pxReader->ulRemaining;
+
+        xStatus = GGD_SecureConnect_Read( pcDestination,
+                                          ulLength,
+                                          pxReader->xSocket,
+                                          &ulLength );
+
+        if( ( xStatus == pdPASS ) && ( ulLength > ( uint32_t ) 0 ) )
+        {
+            *ppcData = pcDestination;
+            *pulLength = ulLength;
+            pxReader->ulRemaining -= ulLength;
+
+            if( ( pxReader->xChunked == pdFALSE ) && ( pxReader->ulRemaining == ( uint32_t ) 0 ) )
+            {
+                pxReader->xBodyRead = pdTRUE;
+            }
+        }
+        else
+        {
+            xStatus = pdFAIL;
+        }
+    }
+    else if( ( xStatus == pdPASS ) && ( pxReader->xBodyRead == pdFALSE ) )
+    {
+        xStatus = prvHTTPFill( pxReader );
+
+        if( xStatus == pdPASS )
+        {
+            ulLength = pxReader->ulEnd - pxReader->ulStart;
+
+            if( ulLength > pxReader->ulRemaining )
+            {
+                ulLength = pxReader->ulRemaining;
+            }
+
+            if( ulLength > ulMaxLength )
+            {
+                ulLength = ulMaxLength;
+            }
+
+            *ppcData = &pxReader->cBuffer[ pxReader->ulStart ];
+            *pulLength = ulLength;
+            pxReader->ulStart += ulLength;
+            pxReader->ulRemaining -= ulLength;
+
+            if( ( pxReader->xChunked == pdFALSE ) && ( pxReader->ulRemaining == ( uint32_t ) 0 ) )
+            {
+                pxReader->xBodyRead = pdTRUE;
+            }
+        }
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamInit( GGD_JSONStream_t * pxStream,
+                               char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                               uint32_t ulBufferSize,
+                               const HostParameters_t * pxHostParameters,
+                               BaseType_t xAutoSelectFlag,
+                               GGD_HostAddressData_t * pxHostAddressData,
+                               uint32_t ulMaxHostAddresses )
+{
+    memset( pxStream, 0, sizeof( GGD_JSONStream_t ) );
+
+    pxStream->pxHostParameters = pxHostParameters;
+    pxStream->xAutoSelectFlag = xAutoSelectFlag;
+    pxStream->pcBuffer = pcBuffer;
+    pxStream->ulBufferSize = ulBufferSize;
+    pxStream->pxHostAddressData = pxHostAddressData;
+    pxStream->ulMaxHostAddresses = ulMaxHostAddresses;
+    pxStream->eState = eJSONStateValue;
+    pxStream->ulCertificateStart = ggdJSON_NO_CERTIFICATE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvJSONStreamFeed( GGD_JSONStream_t * pxStream,
+                                     const char * pcData, /*lint !e971 can use char without signed/unsigned. */
+                                     uint32_t ulLength )
+{
+    uint32_t ulIndex = 0;
+    char cChar; /*lint !e971 can use char without signed/unsigned. */
+
+    while( ( ulIndex < ulLength ) && ( pxStream->xError == pdFALSE ) )
+    {
+        cChar = pcData[ ulIndex ];
+
+        if( pxStream->eState == eJSONStateString )
+        {
+            /* Most of the document is strings that are not needed, so skip
+             * them quickly. */
+            if( ( pxStream->eSink == eJSONSinkNone ) && ( pxStream->ucEscape == ( uint8_t ) 0 ) )
+            {
+                while( ( cChar != '"' ) && ( cChar != '\\' ) && ( ulIndex < ( ulLength - ( uint32_t ) 1 ) ) )
+                {
+                    ulIndex++;
+                    cChar = pcData[ ulIndex ];
+                }
+            }
+            else if( ( pxStream->eSink == eJSONSinkKey ) && ( pxStream->ucEscape == ( uint8_t ) 0 ) )
+            {
+                while( ( cChar != '"' ) && ( cChar != '\\' ) && ( ulIndex < ( ulLength - ( uint32_t ) 1 ) ) )
+                {
+                    if( pxStream->ucKeyLength < ( uint8_t ) ggdJSON_MAX_KEY_SIZE )
+                    {
+                        pxStream->cKey[ pxStream->ucKeyLength ] = cChar;
+                        pxStream->ucKeyLength++;
+                    }
+
+                    ulIndex++;
+                    cChar = pcData[ ulIndex ];
+                }
+            }
+            else
+            {
+                /* Escapes and needed strings are handled a character at a
+                 * time. */
+            }
+
+            prvJSONStreamStringChar( pxStream, cChar );
+            ulIndex++;
+        }
+        else if( pxStream->eState == eJSONStateNumber )
+        {
+            if( ( cChar >= '0' ) && ( cChar <= '9' ) )
+            {
+                pxStream->ulNumber = ( pxStream->ulNumber * ( uint32_t ) ggJSON_CONVERTION_RADIX ) + ( uint32_t ) ( cChar - '0' );
+                ulIndex++;
+            }
+            else if( ( cChar == '-' ) || ( cChar == '+' ) || ( cChar == '.' ) || ( cChar == 'e' ) || ( cChar == 'E' ) )
+            {
+                ulIndex++;
+            }
+            else
+            {
+                /* The character after the number is parsed again. */
+                prvJSONStreamEndNumber( pxStream );
+            }
+        }
+        else if( pxStream->eState == eJSONStateLiteral )
+        {
+            if( ( cChar >= 'a' ) && ( cChar <= 'z' ) )
+            {
+                ulIndex++;
+            }
+            else
+            {
+                pxStream->eState = eJSONStateNext;
+            }
+        }
+        else
+        {
+            if( ( cChar != ' ' ) && ( cChar != '\t' ) && ( cChar != '\r' ) && ( cChar != '\n' ) )
+            {
+                prvJSONStreamToken( pxStream, cChar );
+            }
+
+            ulIndex++;
+        }
+    }
+
+    return ( pxStream->xError == pdFALSE ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvJSONStreamResult( GGD_JSONStream_t * pxStream,
+                                       uint32_t * pulHostAddressCount )
+{
+    BaseType_t xStatus = pdFAIL;
+    uint32_t ulIndex;
+
+    if( pxStream->xBufferFull == pdTRUE )
+    {
+        ggdconfigPRINT( "[ERROR] The supplied buffer is not large enough to hold the GreenGrass core certificate and addresses. \r\n" );
+    }
+    else if( ( pxStream->xError == pdTRUE ) || ( pxStream->eState != eJSONStateDone ) )
+    {
+        ggdconfigPRINT( "JSON parsing: Failed to parse JSON\r\n" );
+    }
+    else if( pxStream->xGroupSelected == pdFALSE )
+    {
+        ggdconfigPRINT( "JSON parsing: Couldn't find Green Grass Core\r\n" );
+    }
+    else
+    {
+        /* All the addresses of the core share the group certificate. */
+        for( ulIndex = 0; ulIndex < pxStream->ulHostAddresses; ulIndex++ )
+        {
+            pxStream->pxHostAddressData[ ulIndex ].pcCertificate = &pxStream->pcBuffer[ pxStream->ulCertificateStart ];
+            pxStream->pxHostAddressData[ ulIndex ].ulCertificateSize = pxStream->ulCertificateSize;
+        }
+
+        *pulHostAddressCount = pxStream->ulHostAddresses;
+        xStatus = pdPASS;
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamPut( GGD_JSONStream_t * pxStream,
+                              char cChar ) /*lint !e971 can use char without signed/unsigned. */
+{
+    if( pxStream->ulBufferUsed < pxStream->ulBufferSize )
+    {
+        pxStream->pcBuffer[ pxStream->ulBufferUsed ] = cChar;
+        pxStream->ulBufferUsed++;
+    }
+    else
+    {
+        pxStream->xBufferFull = pdTRUE;
+        pxStream->xError = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamToken( GGD_JSONStream_t * pxStream,
+                                char cChar ) /*lint !e971 can use char without signed/unsigned. */
+{
+    BaseType_t xInArray = pdFALSE;
+
+    if( pxStream->ucDepth > ( uint8_t ) 0 )
+    {
+        xInArray = ( ( pxStream->ucContainers[ pxStream->ucDepth - 1U ] & ggdJSON_ARRAY ) != 0U ) ? pdTRUE : pdFALSE;
+    }
+
+    switch( pxStream->eState )
+    {
+        case eJSONStateValue:
+
+            if( ( cChar == '{' ) || ( cChar == '[' ) )
+            {
+                prvJSONStreamPush( pxStream, ( cChar == '[' ) ? pdTRUE : pdFALSE );
+            }
+            else if( cChar == '"' )
+            {
+                prvJSONStreamStartString( pxStream );
+            }
+            else if( ( cChar == '-' ) || ( ( cChar >= '0' ) && ( cChar <= '9' ) ) )
+            {
+                pxStream->ulNumber = ( cChar == '-' ) ? 0U : ( uint32_t ) ( cChar - '0' );
+                pxStream->eState = eJSONStateNumber;
+            }
+            else if( ( cChar == 't' ) || ( cChar == 'f' ) || ( cChar == 'n' ) )
+            {
+                pxStream->eState = eJSONStateLiteral;
+            }
+            else if( ( cChar == ']' ) && ( xInArray == pdTRUE ) )
+            {
+                /* Empty array. */
+                prvJSONStreamPop( pxStream, pdTRUE );
+            }
+            else
+            {
+                pxStream->xError = pdTRUE;
+            }
+
+            break;
+
+        case eJSONStateKey:
+
+            if( cChar == '"' )
+            {
+                pxStream->eSink = eJSONSinkKey;
+                pxStream->ucKeyLength = 0;
+                pxStream->ucEscape = 0;
+                pxStream->eState = eJSONStateString;
+            }
+            else if( cChar == '}' )
+            {
+                /* Empty object. */
+                prvJSONStreamPop( pxStream, pdFALSE );
+            }
+            else
+            {
+                pxStream->xError = pdTRUE;
+            }
+
+            break;
+
+        case eJSONStateColon:
+
+            if( cChar == ':' )
+            {
+                pxStream->eState = eJSONStateValue;
+            }
+            else
+            {
+                pxStream->xError = pdTRUE;
+            }
+
+            break;
+
+        case eJSONStateNext:
+
+            if( cChar == ',' )
+            {
+                /* The elements of an array all take the key of the array. */
+                pxStream->eState = ( xInArray == pdTRUE ) ? eJSONStateValue : eJSONStateKey;
+            }
+            else if( ( cChar == '}' ) && ( xInArray == pdFALSE ) )
+            {
+                prvJSONStreamPop( pxStream, pdFALSE );
+            }
+            else if( ( cChar == ']' ) && ( xInArray == pdTRUE ) )
+            {
+                prvJSONStreamPop( pxStream, pdTRUE );
+            }
+            else
+            {
+                pxStream->xError = pdTRUE;
+            }
+
+            break;
+
+        default:
+            /* Nothing may follow the document. */
+            pxStream->xError = pdTRUE;
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamStringChar( GGD_JSONStream_t * pxStream,
+                                     char cChar ) /*lint !e971 can use char without signed/unsigned. */
+{
+    if( pxStream->ucEscape == ( uint8_t ) 0 )
+    {
+        if( cChar == '"' )
+        {
+            prvJSONStreamEndString( pxStream );
+        }
+        else if( cChar == '\\' )
+        {
+            pxStream->ucEscape = 1;
+        }
+        else
+        {
+            prvJSONStreamOutput( pxStream, cChar );
+        }
+    }
+    else if( pxStream->ucEscape == ( uint8_t ) 1 )
+    {
+        pxStream->ucEscape = 0;
+
+        switch( cChar )
+        {
+            case 'n':
+                prvJSONStreamOutput( pxStream, '\n' );
+                break;
+
+            case 'r':
+                prvJSONStreamOutput( pxStream, '\r' );
+                break;
+
+            case 't':
+                prvJSONStreamOutput( pxStream, '\t' );
+                break;
+
+            case 'b':
+                prvJSONStreamOutput( pxStream, '\b' );
+                break;
+
+            case 'f':
+                prvJSONStreamOutput( pxStream, '\f' );
+                break;
+
+            case 'u':
+                pxStream->usUnicode = 0;
+                pxStream->ucEscape = 2;
+                break;
+
+            default:
+                /* '"', '\\' and '/' stand for themselves. */
+                prvJSONStreamOutput( pxStream, cChar );
+                break;
+        }
+    }
+    else
+    {
+        pxStream->usUnicode = ( uint16_t ) ( pxStream->usUnicode << 4 );
+
+        if( ( cChar >= '0' ) && ( cChar <= '9' ) )
+        {
+            pxStream->usUnicode |= ( uint16_t ) ( cChar - '0' );
+        }
+        else if( ( cChar >= 'a' ) && ( cChar <= 'f' ) )
+        {
+            pxStream->usUnicode |= ( uint16_t ) ( cChar - 'a' + 10 );
+        }
+        else if( ( cChar >= 'A' ) && ( cChar <= 'F' ) )
+        {
+            pxStream->usUnicode |= ( uint16_t ) ( cChar - 'A' + 10 );
+        }
+        else
+        {
+            pxStream->xError = pdTRUE;
+        }
+
+        pxStream->ucEscape++;
+
+        if( pxStream->ucEscape == ( uint8_t ) ( ggdJSON_UNICODE_ESCAPE_DIGITS + 2 ) )
+        {
+            /* Addresses and certificates are ASCII. */
+            pxStream->ucEscape = 0;
+            prvJSONStreamOutput( pxStream, ( pxStream->usUnicode < 0x80U ) ? ( char ) pxStream->usUnicode : '?' );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamOutput( GGD_JSONStream_t * pxStream,
+                                 char cChar ) /*lint !e971 can use char without signed/unsigned. */
+{
+    switch( pxStream->eSink )
+    {
+        case eJSONSinkKey:
+
+            /* Longer keys cannot match, so are left truncated. */
+            if( pxStream->ucKeyLength < ( uint8_t ) ggdJSON_MAX_KEY_SIZE )
+            {
+                pxStream->cKey[ pxStream->ucKeyLength ] = cChar;
+                pxStream->ucKeyLength++;
+            }
+
+            break;
+
+        case eJSONSinkMatch:
+
+            if( ( pxStream->xMatch == pdTRUE ) && ( pxStream->pcMatch[ pxStream->ulMatchIndex ] == cChar ) )
+            {
+                pxStream->ulMatchIndex++;
+            }
+            else
+            {
+                pxStream->xMatch = pdFALSE;
+            }
+
+            break;
+
+        case eJSONSinkStore:
+            prvJSONStreamPut( pxStream, cChar );
+            break;
+
+        default:
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamStartString( GGD_JSONStream_t * pxStream )
+{
+    BaseType_t xGroupActive, xCoreActive;
+
+    /* Only the first matching group and core are kept. */
+    xGroupActive = ( ( pxStream->ucGroupDepth != ( uint8_t ) 0 ) && ( pxStream->xGroupSelected == pdFALSE ) ) ? pdTRUE : pdFALSE;
+    xCoreActive = ( ( xGroupActive == pdTRUE ) && ( pxStream->ucCoreDepth != ( uint8_t ) 0 ) && ( pxStream->xCoreSelected == pdFALSE ) ) ? pdTRUE : pdFALSE;
+
+    pxStream->eSink = eJSONSinkNone;
+    pxStream->ucEscape = 0;
+    pxStream->eState = eJSONStateString;
+
+    if( ( pxStream->ucKey == ( uint8_t ) eJSONKeyGroupId ) &&
+        ( pxStream->ucDepth == pxStream->ucGroupDepth ) &&
+        ( xGroupActive == pdTRUE ) &&
+        ( pxStream->xAutoSelectFlag == pdFALSE ) )
+    {
+        pxStream->eSink = eJSONSinkMatch;
+        pxStream->pcMatch = pxStream->pxHostParameters->pcGroupName;
+        pxStream->pxMatchResult = &pxStream->xGroupMatch;
+    }
+    else if( ( pxStream->ucKey == ( uint8_t ) eJSONKeyThingArn ) &&
+             ( pxStream->ucDepth == pxStream->ucCoreDepth ) &&
+             ( xCoreActive == pdTRUE ) &&
+             ( pxStream->xAutoSelectFlag == pdFALSE ) )
+    {
+        pxStream->eSink = eJSONSinkMatch;
+        pxStream->pcMatch = pxStream->pxHostParameters->pcCoreAddress;
+        pxStream->pxMatchResult = &pxStream->xCoreMatch;
+    }
+    else if( ( pxStream->ucKey == ( uint8_t ) eJSONKeyHostAddress ) &&
+             ( pxStream->ucDepth == pxStream->ucHostDepth ) &&
+             ( xCoreActive == pdTRUE ) &&
+             ( pxStream->pcHostAddress == NULL ) &&
+             ( pxStream->ulHostAddresses < pxStream->ulMaxHostAddresses ) )
+    {
+        pxStream->eSink = eJSONSinkStore;
+        pxStream->pcHostAddress = &pxStream->pcBuffer[ pxStream->ulBufferUsed ];
+    }
+    else if( ( pxStream->ucKey == ( uint8_t ) eJSONKeyCertificates ) &&
+             ( pxStream->ucDepth == pxStream->ucCertificatesDepth ) &&
+             ( xGroupActive == pdTRUE ) )
+    {
+        /* All the certificates of the group are kept, one after the other. */
+        pxStream->eSink = eJSONSinkStore;
+
+        if( pxStream->ulCertificateStart == ggdJSON_NO_CERTIFICATE )
+        {
+            pxStream->ulCertificateStart = pxStream->ulBufferUsed;
+        }
+    }
+    else
+    {
+        /* Not needed. */
+    }
+
+    if( pxStream->eSink == eJSONSinkMatch )
+    {
+        pxStream->ulMatchIndex = 0;
+        pxStream->xMatch = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamEndString( GGD_JSONStream_t * pxStream )
+{
+    uint8_t ucKey;
+
+    pxStream->eState = eJSONStateNext;
+
+    switch( pxStream->eSink )
+    {
+        case eJSONSinkKey:
+            pxStream->ucKey = ( uint8_t ) eJSONKeyOther;
+
+            for( ucKey = ( uint8_t ) eJSONKeyGroups; ucKey < ( uint8_t ) eJSONKeyCount; ucKey++ )
+            {
+                if( ( pxStream->ucKeyLength != ( uint8_t ) 0 ) &&
+                    ( pcJSONKeys[ ucKey ][ 0 ] == pxStream->cKey[ 0 ] ) &&
+                    ( strlen( pcJSONKeys[ ucKey ] ) == ( size_t ) pxStream->ucKeyLength ) &&
+                    ( strncmp( pcJSONKeys[ ucKey ], pxStream->cKey, pxStream->ucKeyLength ) == 0 ) )
+                {
+                    pxStream->ucKey = ucKey;
+                    break;
+                }
+            }
+
+            pxStream->eState = eJSONStateColon;
+            break;
+
+        case eJSONSinkMatch:
+            *pxStream->pxMatchResult = ( ( pxStream->xMatch == pdTRUE ) &&
+                                         ( pxStream->pcMatch[ pxStream->ulMatchIndex ] == '\0' ) ) ? pdTRUE : pdFALSE;
+            break;
+
+        case eJSONSinkStore:
+
+            if( pxStream->ucKey == ( uint8_t ) eJSONKeyHostAddress )
+            {
+                prvJSONStreamPut( pxStream, '\0' );
+            }
+
+            break;
+
+        default:
+            break;
+    }
+
+    pxStream->eSink = eJSONSinkNone;
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamEndNumber( GGD_JSONStream_t * pxStream )
+{
+    if( ( pxStream->ucKey == ( uint8_t ) eJSONKeyPortNumber ) &&
+        ( pxStream->ucDepth == pxStream->ucHostDepth ) )
+    {
+        pxStream->usPort = ( uint16_t ) pxStream->ulNumber;
+        pxStream->xPortFound = pdTRUE;
+    }
+
+    pxStream->eState = eJSONStateNext;
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamPush( GGD_JSONStream_t * pxStream,
+                               BaseType_t xArray )
+{
+    uint8_t ucKey = pxStream->ucKey;
+
+    if( pxStream->ucDepth == ( uint8_t ) ggdJSON_MAX_DEPTH )
+    {
+        pxStream->xError = pdTRUE;
+    }
+    else
+    {
+        pxStream->ucContainers[ pxStream->ucDepth ] = ( xArray == pdTRUE ) ? ( uint8_t ) ( ucKey | ggdJSON_ARRAY ) : ucKey;
+        pxStream->ucDepth++;
+        pxStream->eState = ( xArray == pdTRUE ) ? eJSONStateValue : eJSONStateKey;
+
+        if( xArray == pdTRUE )
+        {
+            if( ( ucKey == ( uint8_t ) eJSONKeyCertificates ) &&
+                ( pxStream->ucGroupDepth == ( uint8_t ) ( pxStream->ucDepth - 1U ) ) )
+            {
+                pxStream->ucCertificatesDepth = pxStream->ucDepth;
+            }
+        }
+        else if( ( ucKey == ( uint8_t ) eJSONKeyGroups ) &&
+                 ( pxStream->ucGroupDepth == ( uint8_t ) 0 ) &&
+                 ( pxStream->xGroupSelected == pdFALSE ) )
+        {
+            /* A group. Its data is discarded if it is not selected. */
+            pxStream->ucGroupDepth = pxStream->ucDepth;
+            pxStream->xGroupMatch = pxStream->xAutoSelectFlag;
+            pxStream->xCoreSelected = pdFALSE;
+            pxStream->ulGroupMark = pxStream->ulBufferUsed;
+            pxStream->ulGroupHostMark = pxStream->ulHostAddresses;
+            pxStream->ulCertificateStart = ggdJSON_NO_CERTIFICATE;
+            pxStream->ulCertificateSize = 0;
+        }
+        else if( ( ucKey == ( uint8_t ) eJSONKeyCores ) &&
+                 ( pxStream->ucGroupDepth != ( uint8_t ) 0 ) &&
+                 ( pxStream->ucCoreDepth == ( uint8_t ) 0 ) )
+        {
+            /* A core of the group. */
+            pxStream->ucCoreDepth = pxStream->ucDepth;
+            pxStream->xCoreMatch = pxStream->xAutoSelectFlag;
+            pxStream->ulCoreMark = pxStream->ulBufferUsed;
+            pxStream->ulCoreHostMark = pxStream->ulHostAddresses;
+        }
+        else if( ( ucKey == ( uint8_t ) eJSONKeyConnectivity ) &&
+                 ( pxStream->ucCoreDepth != ( uint8_t ) 0 ) &&
+                 ( pxStream->ucHostDepth == ( uint8_t ) 0 ) )
+        {
+            /* A connectivity entry of the core. */
+            pxStream->ucHostDepth = pxStream->ucDepth;
+            pxStream->ulHostMark = pxStream->ulBufferUsed;
+            pxStream->pcHostAddress = NULL;
+            pxStream->xPortFound = pdFALSE;
+        }
+        else
+        {
+            /* Not needed. */
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvJSONStreamPop( GGD_JSONStream_t * pxStream,
+                              BaseType_t xArray )
+{
+    GGD_HostAddressData_t * pxHostAddressData;
+
+    ( void ) xArray;
+
+    if( pxStream->ucDepth == pxStream->ucCertificatesDepth )
+    {
+        /* End of the certificates of the group. */
+        if( pxStream->ulCertificateStart != ggdJSON_NO_CERTIFICATE )
+        {
+            prvJSONStreamPut( pxStream, '\0' );
+            pxStream->ulCertificateSize = pxStream->ulBufferUsed - pxStream->ulCertificateStart;
+        }
+
+        pxStream->ucCertificatesDepth = 0;
+    }
+    else if( pxStream->ucDepth == pxStream->ucHostDepth )
+    {
+        /* End of a connectivity entry. Keep it if it is complete. */
+        if( ( pxStream->pcHostAddress != NULL ) && ( pxStream->xPortFound == pdTRUE ) )
+        {
+            pxHostAddressData = &pxStream->pxHostAddressData[ pxStream->ulHostAddresses ];
+            pxHostAddressData->pcHostAddress = pxStream->pcHostAddress;
+            pxHostAddressData->usPort = pxStream->usPort;
+            pxHostAddressData->pcCertificate = NULL;
+            pxHostAddressData->ulCertificateSize = 0;
+            pxStream->ulHostAddresses++;
+        }
+        else
+        {
+            pxStream->ulBufferUsed = pxStream->ulHostMark;
+        }
+
+        pxStream->pcHostAddress = NULL;
+        pxStream->ucHostDepth = 0;
+    }
+    else if( pxStream->ucDepth == pxStream->ucCoreDepth )
+    {
+        /* End of a core. Keep the first one that matches and has addresses. */
+        if( ( pxStream->xGroupSelected == pdFALSE ) && ( pxStream->xCoreSelected == pdFALSE ) )
+        {
+            if( ( pxStream->xCoreMatch == pdTRUE ) && ( pxStream->ulHostAddresses > pxStream->ulCoreHostMark ) )
+            {
+                pxStream->xCoreSelected = pdTRUE;
+            }
+            else
+            {
+                pxStream->ulBufferUsed = pxStream->ulCoreMark;
+                pxStream->ulHostAddresses = pxStream->ulCoreHostMark;
+            }
+        }
+
+        pxStream->ucCoreDepth = 0;
+    }
+    else if( pxStream->ucDepth == pxStream->ucGroupDepth )
+    {
+        /* End of a group. Keep the first one that matches, has a selected
+         * core and has a certificate. */
+        if( pxStream->xGroupSelected == pdFALSE )
+        {
+            if( ( pxStream->xGroupMatch == pdTRUE ) &&
+                ( pxStream->xCoreSelected == pdTRUE ) &&
+                ( pxStream->ulCertificateSize != ( uint32_t ) 0 ) )
+            {
+                pxStream->xGroupSelected = pdTRUE;
+            }
+            else
+            {
+                pxStream->ulBufferUsed = pxStream->ulGroupMark;
+                pxStream->ulHostAddresses = pxStream->ulGroupHostMark;
+                pxStream->ulCertificateStart = ggdJSON_NO_CERTIFICATE;
+                pxStream->ulCertificateSize = 0;
+                pxStream->xCoreSelected = pdFALSE;
+            }
+        }
+
+        pxStream->ucGroupDepth = 0;
+    }
+    else
+    {
+        /* Not needed. */
+    }
+
+    pxStream->ucDepth--;
+
+    if( pxStream->ucDepth == ( uint8_t ) 0 )
+    {
+        pxStream->eState = eJSONStateDone;
+    }
+    else
+    {
+        /* Restore the key of the enclosing array, for its next element. */
+        pxStream->ucKey = ( uint8_t ) ( pxStream->ucContainers[ pxStream->ucDepth - 1U ] & ( uint8_t ) ~ggdJSON_ARRAY );
+        pxStream->eState = eJSONStateNext;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvConnectToCore( const GGD_HostAddressData_t * pxHostAddressData,
+                                    uint32_t ulHostAddressCount,
+                                    uint32_t * pulConnectedIndex )
+{
+    Socket_t xSocket;
+    BaseType_t xStatus;
+
+    xStatus = GGD_SecureConnect_ConnectFirst( pxHostAddressData,
+                                              ulHostAddressCount,
+                                              &xSocket,
+                                              pulConnectedIndex,
+                                              ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                              ggdconfigTCP_SEND_TIMEOUT_MS );
+
+    if( xStatus == pdPASS )
+    {
+        /* Interface found, disconnect. */
+        GGD_SecureConnect_Disconnect( &xSocket );
+    }
+    else
+    {
+        ggdconfigPRINT( "GGD - Can't connect to greengrass Core\r\n" );
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvDiscoveryCacheUsedSize( const char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                           const GGD_HostAddressData_t * pxHostAddressData,
+                                           uint32_t ulHostAddressCount )
+{
+    uint32_t ulUsedSize = 0;
+    uint32_t ulEnd;
+    uint32_t ulIndex;
+
+    /* The certificate and the addresses are written one after the other at
+     * the start of the buffer. */
+    for( ulIndex = 0; ulIndex < ulHostAddressCount; ulIndex++ )
+    {
+        ulEnd = ( uint32_t ) ( pxHostAddressData[ ulIndex ].pcCertificate - pcBuffer ) +
+                pxHostAddressData[ ulIndex ].ulCertificateSize;
+
+        if( ulEnd > ulUsedSize )
+        {
+            ulUsedSize = ulEnd;
+        }
+
+        ulEnd = ( uint32_t ) ( pxHostAddressData[ ulIndex ].pcHostAddress - pcBuffer ) +
+                ( uint32_t ) strlen( pxHostAddressData[ ulIndex ].pcHostAddress ) + ( uint32_t ) 1;
+
+        if( ulEnd > ulUsedSize )
+        {
+            ulUsedSize = ulEnd;
+        }
+    }
+
+    return ulUsedSize;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvDiscoveryCacheChecksum( const char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                           uint32_t ulSize )
+{
+    uint32_t ulChecksum = 2166136261UL;
+    uint32_t ulIndex;
+
+    /* FNV-1a. */
+    for( ulIndex = 0; ulIndex < ulSize; ulIndex++ )
+    {
+        ulChecksum ^= ( uint32_t ) ( uint8_t ) pcBuffer[ ulIndex ];
+        ulChecksum *= 16777619UL;
+    }
+
+    return ulChecksum;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvDiscoveryCacheGet( const char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                        uint32_t ulBufferSize,
+                                        GGD_HostAddressData_t * pxHostAddressData,
+                                        uint32_t * pulHostAddressCount )
+{
+    const TickType_t xValidity = ( TickType_t ) ggdconfigCACHE_VALIDITY_S * ( TickType_t ) configTICK_RATE_HZ;
+    BaseType_t xStatus = pdFAIL;
+
+    if( ( xDiscoveryCache.ulHostAddressCount != ( uint32_t ) 0 ) &&
+        ( xDiscoveryCache.pcBuffer == pcBuffer ) &&
+        ( xDiscoveryCache.ulBufferSize == ulBufferSize ) )
+    {
+        if( ( xTaskGetTickCount() - xDiscoveryCache.xTimeStamp ) >= xValidity )
+        {
+            ggdconfigPRINT( "GGD - Cached discovery expired\r\n" );
+        }
+        else if( prvDiscoveryCacheChecksum( pcBuffer, xDiscoveryCache.ulUsedSize ) != xDiscoveryCache.ulChecksum )
+        {
+            ggdconfigPRINT( "GGD - Discovery buffer modified, cache discarded\r\n" );
+        }
+        else
+        {
+            memcpy( pxHostAddressData,
+                    xDiscoveryCache.xHostAddressData,
+                    xDiscoveryCache.ulHostAddressCount * sizeof( GGD_HostAddressData_t ) );
+            *pulHostAddressCount = xDiscoveryCache.ulHostAddressCount;
+            xStatus = pdPASS;
+        }
+
+        if( xStatus == pdFAIL )
+        {
+            GGD_InvalidateCache();
+        }
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDiscoveryCacheSet( const char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                  uint32_t ulBufferSize,
+                                  const GGD_HostAddressData_t * pxHostAddressData,
+                                  uint32_t ulHostAddressCount,
+                                  uint32_t ulConnectedIndex )
+{
+    uint32_t ulIndex;
+    uint32_t ulCount = 1;
+
+    if( ggdconfigCACHE_VALIDITY_S > 0 )
+    {
+        xDiscoveryCache.pcBuffer = pcBuffer;
+        xDiscoveryCache.ulBufferSize = ulBufferSize;
+        xDiscoveryCache.xTimeStamp = xTaskGetTickCount();
+
+        /* Keep the address that answered first, so it is tried first next
+         * time. */
+        xDiscoveryCache.xHostAddressData[ 0 ] = pxHostAddressData[ ulConnectedIndex ];
+
+        for( ulIndex = 0; ulIndex < ulHostAddressCount; ulIndex++ )
+        {
+            if( ulIndex != ulConnectedIndex )
+            {
+                xDiscoveryCache.xHostAddressData[ ulCount ] = pxHostAddressData[ ulIndex ];
+                ulCount++;
+            }
+        }
+
+        xDiscoveryCache.ulUsedSize = prvDiscoveryCacheUsedSize( pcBuffer,
+                                                                pxHostAddressData,
+                                                                ulHostAddressCount );
+        xDiscoveryCache.ulChecksum = prvDiscoveryCacheChecksum( pcBuffer,
+                                                                xDiscoveryCache.ulUsedSize );
+        xDiscoveryCache.ulHostAddressCount = ulHostAddressCount;
+    }
 }
 /*-----------------------------------------------------------*/
 /* Provide access to private members for testing. */
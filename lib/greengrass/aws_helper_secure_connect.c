@@ -37,6 +37,7 @@
 #include "task.h"
 #include "queue.h"
 #include "semphr.h"
+#include "event_groups.h"
 
 /* Helper interface includes. */
 #include "aws_helper_secure_connect.h"
@@ -48,11 +49,97 @@
 
 #define helperMAX_IP_ADDRESS_OCTETS    4u
 
+#define helperPROBE_WON_BIT            ( ( EventBits_t ) 0x01 ) /**< A connection attempt succeeded. */
+#define helperPROBE_FAILED_BIT         ( ( EventBits_t ) 0x02 ) /**< All the connection attempts failed. */
+#define helperPROBE_SHUTDOWN_RETRY_MS  ( 10 )                   /**< Delay before shutting down a losing attempt that is not connected yet. */
+
+/**
+ * @brief State shared by the tasks racing to connect to one of several hosts.
+ *
+ * The hosts, and the strings they point to, are copied after the structure so
+ * that the tasks still connecting when the caller returns do not depend on
+ * the caller's memory. The structure is freed by whichever of the caller and
+ * the tasks releases it last.
+ */
+typedef struct
+{
+    EventGroupHandle_t xEvents;                 /**< Signals the caller that a task won or that all failed. */
+    GGD_HostAddressData_t * pxHostAddressData;  /**< Copy of the hosts to try. */
+    uint32_t ulHostAddressCount;                /**< Number of hosts to try. */
+    uint32_t ulNextHost;                        /**< Index of the next host to try. */
+    uint32_t ulRunning;                         /**< Number of tasks still trying hosts. */
+    uint32_t ulReferences;                      /**< Number of tasks plus the caller, if still waiting. */
+    BaseType_t xDone;                           /**< Set once a connection succeeded. */
+    uint32_t ulWinner;                          /**< Index of the host connected to. */
+    Socket_t xWinnerSocket;                     /**< Socket connected to the winning host. */
+    uint32_t ulReceiveTimeOut;                  /**< Receive timeout of the connections. */
+    uint32_t ulSendTimeOut;                     /**< Send timeout of the connections. */
+    SemaphoreHandle_t xSocketsMutex;            /**< Guards xSockets and xShutDown, as shutting down a socket cannot be done in a critical section. */
+    Socket_t xSockets[ ggdconfigPROBE_MAX_PARALLEL ];    /**< Sockets of the attempts in progress, or SOCKETS_INVALID_SOCKET. */
+    BaseType_t xShutDown[ ggdconfigPROBE_MAX_PARALLEL ]; /**< Set once the socket in the same slot was shut down. */
+} GGD_ProbeContext_t;
+
 /**
  * @brief This function return non 0 if it is an IP and 0 if it isn't
  */
 static uint32_t prvIsIPaddress( const char * pcIPAddress );
 
+/**
+ * @brief Create and configure a socket for a secure connection to a host, and
+ * resolve the address of the host.
+ *
+ * @return pdPASS if the socket is ready to connect. Otherwise pdFAIL, and a
+ * socket that was created is left in *pxSocket.
+ */
+static BaseType_t prvSecureConnectPrepare( const GGD_HostAddressData_t * pxHostAddressData,
+                                           Socket_t * pxSocket,
+                                           SocketsSockaddr_t * pxServerAddress,
+                                           uint32_t ulReceiveTimeOut,
+                                           uint32_t ulSendTimeOut );
+
+/**
+ * @brief Copy the hosts to try into a new probe context.
+ */
+static GGD_ProbeContext_t * prvProbeContextCreate( const GGD_HostAddressData_t * pxHostAddressData,
+                                                   const uint32_t ulHostAddressCount );
+
+/**
+ * @brief Drop one reference to a probe context, and free it if it was the
+ * last one.
+ */
+static void prvProbeContextRelease( GGD_ProbeContext_t * pxContext );
+
+/**
+ * @brief Record the socket of an attempt in progress, unless an attempt
+ * already won.
+ *
+ * @return pdPASS if the socket was recorded in slot *pulSlot.
+ */
+static BaseType_t prvProbeSocketAdd( GGD_ProbeContext_t * pxContext,
+                                     Socket_t xSocket,
+                                     uint32_t * pulSlot );
+
+/**
+ * @brief Forget the socket of an attempt that completed.
+ */
+static void prvProbeSocketRemove( GGD_ProbeContext_t * pxContext,
+                                  uint32_t ulSlot );
+
+/**
+ * @brief Shut down the sockets of all attempts in progress, so that they fail
+ * and release their socket and TLS context without waiting for a timeout.
+ *
+ * A socket that is still waiting for its TCP connection cannot be shut down
+ * yet, and is retried every helperPROBE_SHUTDOWN_RETRY_MS.
+ */
+static void prvProbeCancelOthers( GGD_ProbeContext_t * pxContext );
+
+/**
+ * @brief Task that tries hosts from a probe context until one connects or
+ * there are none left.
+ */
+static void prvProbeTask( void * pvParameters );
+
 /*-----------------------------------------------------------*/
 
 BaseType_t GGD_SecureConnect_Connect( const GGD_HostAddressData_t * pxHostAddressData,
@@ -60,121 +147,159 @@ BaseType_t GGD_SecureConnect_Connect( const GGD_HostAddressData_t * pxHostAddres
                                       uint32_t ulReceiveTimeOut,
                                       uint32_t ulSendTimeOut )
 {
-    const TickType_t xReceiveTimeOut = pdMS_TO_TICKS( ulReceiveTimeOut );
-    const TickType_t xSendTimeOut = pdMS_TO_TICKS( ulSendTimeOut );
     SocketsSockaddr_t xServerAddress;
-    size_t xURLLength;
-    BaseType_t xIsIPAddress;
     BaseType_t xStatus;
 
     configASSERT( pxHostAddressData != NULL );
     configASSERT( pxSocket != NULL );
 
-    /* Calculate the length of the supplied URL. */
-    xURLLength = strlen( pxHostAddressData->pcHostAddress );
+    xStatus = prvSecureConnectPrepare( pxHostAddressData,
+                                       pxSocket,
+                                       &xServerAddress,
+                                       ulReceiveTimeOut,
+                                       ulSendTimeOut );
 
-    /* Ensure that the length of the specified URL is
-     * within the permitted limits. */
-    if( xURLLength <= ( size_t ) securesocketsMAX_DNS_NAME_LENGTH )
+    /* Establish the TCP connection. */
+    if( pdPASS == xStatus )
     {
-        /* Create the socket. */
-        *pxSocket = SOCKETS_Socket( SOCKETS_AF_INET,
-                                    SOCKETS_SOCK_STREAM,
-                                    SOCKETS_IPPROTO_TCP );
-
-        if( *pxSocket == SOCKETS_INVALID_SOCKET )
+        if( ( SOCKETS_Connect( *pxSocket,
+                               &xServerAddress,
+                               ( uint32_t ) sizeof( xServerAddress ) )
+              != SOCKETS_ERROR_NONE ) )
         {
+            GGD_SecureConnect_Disconnect( pxSocket );
             xStatus = pdFAIL;
         }
-        else
-        {
-            xStatus = pdPASS;
-        }
-
-        if( xStatus == pdPASS )
-        {
-            if( prvIsIPaddress( pxHostAddressData->pcHostAddress ) == ( uint32_t ) 0 )
-            {
-                xIsIPAddress = pdFALSE;
-            }
-            else
-            {
-                xIsIPAddress = pdTRUE;
-            }
+    }
 
-            xServerAddress.ucLength = sizeof( SocketsSockaddr_t );
-            xServerAddress.usPort = SOCKETS_htons( pxHostAddressData->usPort );
-            xServerAddress.ulAddress =
-                SOCKETS_GetHostByName( pxHostAddressData->pcHostAddress );
-            xServerAddress.ucSocketDomain = SOCKETS_AF_INET;
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
 
-            /* Set send timeout for the socket. */
-            ( void ) SOCKETS_SetSockOpt( *pxSocket,
-                                         0,
-                                         SOCKETS_SO_SNDTIMEO,
-                                         &xSendTimeOut,
-                                         sizeof( xSendTimeOut ) );
+BaseType_t GGD_SecureConnect_ConnectFirst( const GGD_HostAddressData_t * pxHostAddressData,
+                                           const uint32_t ulHostAddressCount,
+                                           Socket_t * pxSocket,
+                                           uint32_t * pulConnectedIndex,
+                                           uint32_t ulReceiveTimeOut,
+                                           uint32_t ulSendTimeOut )
+{
+    GGD_ProbeContext_t * pxContext = NULL;
+    EventBits_t xBits = 0;
+    uint32_t ulTasks = 0;
+    uint32_t ulIndex;
+    BaseType_t xCreate;
+    BaseType_t xStatus = pdFAIL;
 
-            /* Set receive timeout for the socket. */
-            ( void ) SOCKETS_SetSockOpt( *pxSocket,
-                                         0,
-                                         SOCKETS_SO_RCVTIMEO,
-                                         &xReceiveTimeOut,
-                                         sizeof( xReceiveTimeOut ) );
+    configASSERT( pxHostAddressData != NULL );
+    configASSERT( pxSocket != NULL );
+    configASSERT( pulConnectedIndex != NULL );
 
-            /* Set secure connection. */
-            ( void ) SOCKETS_SetSockOpt( *pxSocket,
-                                         0,
-                                         SOCKETS_SO_REQUIRE_TLS,
-                                         NULL,
-                                         ( size_t ) 0 );
+    if( ( ulHostAddressCount > ( uint32_t ) 1 ) && ( ggdconfigPROBE_MAX_PARALLEL > 1 ) )
+    {
+        pxContext = prvProbeContextCreate( pxHostAddressData, ulHostAddressCount );
+    }
 
-            if( pxHostAddressData->pcCertificate != NULL )
+    if( pxContext != NULL )
+    {
+        pxContext->ulReceiveTimeOut = ulReceiveTimeOut;
+        pxContext->ulSendTimeOut = ulSendTimeOut;
+
+        /* Start a new attempt every ggdconfigPROBE_STAGGER_MS until one
+         * succeeds, all hosts are being tried, or the limit is reached. A task
+         * whose attempt fails moves on to the next host straight away. */
+        while( ( ulTasks < ( uint32_t ) ggdconfigPROBE_MAX_PARALLEL ) &&
+               ( ( xBits & helperPROBE_WON_BIT ) == ( EventBits_t ) 0 ) )
+        {
+            taskENTER_CRITICAL();
             {
-                if( SOCKETS_SetSockOpt( *pxSocket,
-                                        0,
-                                        SOCKETS_SO_TRUSTED_SERVER_CERTIFICATE,
-                                        pxHostAddressData->pcCertificate,
-                                        ( size_t ) pxHostAddressData->ulCertificateSize )
-                    != SOCKETS_ERROR_NONE )
+                xCreate = ( ( pxContext->xDone == pdFALSE ) &&
+                            ( pxContext->ulNextHost < pxContext->ulHostAddressCount ) ) ? pdTRUE : pdFALSE;
+
+                if( xCreate == pdTRUE )
                 {
-                    xStatus = pdFAIL;
+                    pxContext->ulRunning++;
+                    pxContext->ulReferences++;
                 }
             }
+            taskEXIT_CRITICAL();
 
-            if( xIsIPAddress == pdFALSE )
+            if( xCreate == pdFALSE )
             {
-                if( SOCKETS_SetSockOpt( *pxSocket,
-                                        0,
-                                        SOCKETS_SO_SERVER_NAME_INDICATION,
-                                        pxHostAddressData->pcHostAddress,
-                                        ( size_t ) 1 + xURLLength )
-                    != SOCKETS_ERROR_NONE )
-                {
-                    xStatus = pdFAIL;
-                }
+                break;
             }
 
-            /* Establish the TCP connection. */
-            if( pdPASS == xStatus )
+            if( xTaskCreate( prvProbeTask,
+                             "GGDProbe",
+                             ggdconfigPROBE_TASK_STACK_SIZE,
+                             pxContext,
+                             ggdconfigPROBE_TASK_PRIORITY,
+                             NULL ) != pdPASS )
             {
-                if( ( SOCKETS_Connect( *pxSocket,
-                                       &xServerAddress,
-                                       ( uint32_t ) sizeof( xServerAddress ) )
-                      != SOCKETS_ERROR_NONE ) )
+                taskENTER_CRITICAL();
                 {
-                    GGD_SecureConnect_Disconnect( pxSocket );
-                    xStatus = pdFAIL;
+                    pxContext->ulRunning--;
+                    pxContext->ulReferences--;
                 }
+                taskEXIT_CRITICAL();
+                break;
             }
+
+            ulTasks++;
+            xBits = xEventGroupWaitBits( pxContext->xEvents,
+                                         helperPROBE_WON_BIT | helperPROBE_FAILED_BIT,
+                                         pdFALSE,
+                                         pdFALSE,
+                                         pdMS_TO_TICKS( ggdconfigPROBE_STAGGER_MS ) );
+        }
+
+        /* The last task to fail signals it, so there is only something to
+         * wait for if a task was started. */
+        while( ( ulTasks > ( uint32_t ) 0 ) &&
+               ( ( xBits & ( helperPROBE_WON_BIT | helperPROBE_FAILED_BIT ) ) == ( EventBits_t ) 0 ) )
+        {
+            xBits = xEventGroupWaitBits( pxContext->xEvents,
+                                         helperPROBE_WON_BIT | helperPROBE_FAILED_BIT,
+                                         pdFALSE,
+                                         pdFALSE,
+                                         portMAX_DELAY );
+        }
+
+        if( ( xBits & helperPROBE_WON_BIT ) != ( EventBits_t ) 0 )
+        {
+            *pxSocket = pxContext->xWinnerSocket;
+            *pulConnectedIndex = pxContext->ulWinner;
+            xStatus = pdPASS;
+        }
+
+        /* The winner shuts down the attempts still in progress. Their tasks
+         * then close their socket and free the context. */
+        prvProbeContextRelease( pxContext );
+
+        if( ulTasks == ( uint32_t ) 0 )
+        {
+            /* No task could be created, fall back to trying in turn. */
+            pxContext = NULL;
         }
     }
-    else
+
+
+    if( pxContext == NULL )
     {
-        ggdconfigPRINT( "Malformed URL\r\n" );
-        xStatus = pdFAIL;
+        /* Nothing to race, or not enough memory to do so: try the hosts one
+         * after the other. */
+        for( ulIndex = 0; ulIndex < ulHostAddressCount; ulIndex++ )
+        {
+            if( GGD_SecureConnect_Connect( &pxHostAddressData[ ulIndex ],
+                                           pxSocket,
+                                           ulReceiveTimeOut,
+                                           ulSendTimeOut ) == pdPASS )
+            {
+                *pulConnectedIndex = ulIndex;
+                xStatus = pdPASS;
+                break;
+            }
+        }
     }
-
     return xStatus;
 }
 /*-----------------------------------------------------------*/
@@ -420,3 +545,425 @@ static uint32_t prvIsIPaddress( const char * pcIPAddress )
 
     return ulReturn;
 }
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSecureConnectPrepare( const GGD_HostAddressData_t * pxHostAddressData,
+                                           Socket_t * pxSocket,
+                                           SocketsSockaddr_t * pxServerAddress,
+                                           uint32_t ulReceiveTimeOut,
+                                           uint32_t ulSendTimeOut )
+{
+    const TickType_t xReceiveTimeOut = pdMS_TO_TICKS( ulReceiveTimeOut );
+    const TickType_t xSendTimeOut = pdMS_TO_TICKS( ulSendTimeOut );
+    size_t xURLLength;
+    BaseType_t xIsIPAddress;
+    BaseType_t xStatus;
+
+    /* Calculate the length of the supplied URL. */
+    xURLLength = strlen( pxHostAddressData->pcHostAddress );
+
+    /* Ensure that the length of the specified URL is
+     * within the permitted limits. */
+    if( xURLLength <= ( size_t ) securesocketsMAX_DNS_NAME_LENGTH )
+    {
+        /* Create the socket. */
+        *pxSocket = SOCKETS_Socket( SOCKETS_AF_INET,
+                                    SOCKETS_SOCK_STREAM,
+                                    SOCKETS_IPPROTO_TCP );
+
+        if( *pxSocket == SOCKETS_INVALID_SOCKET )
+        {
+            xStatus = pdFAIL;
+        }
+        else
+        {
+            xStatus = pdPASS;
+        }
+
+        if( xStatus == pdPASS )
+        {
+            if( prvIsIPaddress( pxHostAddressData->pcHostAddress ) == ( uint32_t ) 0 )
+            {
+                xIsIPAddress = pdFALSE;
+            }
+            else
+            {
+                xIsIPAddress = pdTRUE;
+            }
+
+            pxServerAddress->ucLength = sizeof( SocketsSockaddr_t );
+            pxServerAddress->usPort = SOCKETS_htons( pxHostAddressData->usPort );
+            pxServerAddress->ulAddress =
+                SOCKETS_GetHostByName( pxHostAddressData->pcHostAddress );
+            pxServerAddress->ucSocketDomain = SOCKETS_AF_INET;
+
+            /* Set send timeout for the socket. */
+            ( void ) SOCKETS_SetSockOpt( *pxSocket,
+                                         0,
+                                         SOCKETS_SO_SNDTIMEO,
+                                         &xSendTimeOut,
+                                         sizeof( xSendTimeOut ) );
+
+            /* Set receive timeout for the socket. */
+            ( void ) SOCKETS_SetSockOpt( *pxSocket,
+                                         0,
+                                         SOCKETS_SO_RCVTIMEO,
+                                         &xReceiveTimeOut,
+                                         sizeof( xReceiveTimeOut ) );
+
+            /* Set secure connection. */
+            ( void ) SOCKETS_SetSockOpt( *pxSocket,
+                                         0,
+                                         SOCKETS_SO_REQUIRE_TLS,
+                                         NULL,
+                                         ( size_t ) 0 );
+
+            if( pxHostAddressData->pcCertificate != NULL )
+            {
+                if( SOCKETS_SetSockOpt( *pxSocket,
+                                        0,
+                                        SOCKETS_SO_TRUSTED_SERVER_CERTIFICATE,
+                                        pxHostAddressData->pcCertificate,
+                                        ( size_t ) pxHostAddressData->ulCertificateSize )
+                    != SOCKETS_ERROR_NONE )
+                {
+                    xStatus = pdFAIL;
+                }
+            }
+
+            if( xIsIPAddress == pdFALSE )
+            {
+                if( SOCKETS_SetSockOpt( *pxSocket,
+                                        0,
+                                        SOCKETS_SO_SERVER_NAME_INDICATION,
+                                        pxHostAddressData->pcHostAddress,
+                                        ( size_t ) 1 + xURLLength )
+                    != SOCKETS_ERROR_NONE )
+                {
+                    xStatus = pdFAIL;
+                }
+            }
+        }
+    }
+    else
+    {
+        ggdconfigPRINT( "Malformed URL\r\n" );
+        xStatus = pdFAIL;
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static GGD_ProbeContext_t * prvProbeContextCreate( const GGD_HostAddressData_t * pxHostAddressData,
+                                                   const uint32_t ulHostAddressCount )
+{
+    GGD_ProbeContext_t * pxContext;
+    size_t xSize = sizeof( GGD_ProbeContext_t ) + ( ulHostAddressCount * sizeof( GGD_HostAddressData_t ) );
+    const char * pcLastCertificate = NULL; /*lint !e971 can use char without signed/unsigned. */
+    char * pcCopy;                         /*lint !e971 can use char without signed/unsigned. */
+    size_t xLength;
+    uint32_t ulIndex;
+
+    for( ulIndex = 0; ulIndex < ulHostAddressCount; ulIndex++ )
+    {
+        xSize += strlen( pxHostAddressData[ ulIndex ].pcHostAddress ) + ( size_t ) 1;
+
+        /* The hosts of a core normally share one certificate, which is then
+         * only copied once. */
+        if( ( pxHostAddressData[ ulIndex ].pcCertificate != NULL ) &&
+            ( pxHostAddressData[ ulIndex ].pcCertificate != pcLastCertificate ) )
+        {
+            xSize += ( size_t ) pxHostAddressData[ ulIndex ].ulCertificateSize;
+            pcLastCertificate = pxHostAddressData[ ulIndex ].pcCertificate;
+        }
+    }
+
+    pxContext = ( GGD_ProbeContext_t * ) pvPortMalloc( xSize );
+
+    if( pxContext != NULL )
+    {
+        memset( pxContext, 0, sizeof( GGD_ProbeContext_t ) );
+        pxContext->xEvents = xEventGroupCreate();
+        pxContext->xSocketsMutex = xSemaphoreCreateMutex();
+
+        if( ( pxContext->xEvents == NULL ) || ( pxContext->xSocketsMutex == NULL ) )
+        {
+            if( pxContext->xEvents != NULL )
+            {
+                vEventGroupDelete( pxContext->xEvents );
+            }
+
+            if( pxContext->xSocketsMutex != NULL )
+            {
+                vSemaphoreDelete( pxContext->xSocketsMutex );
+            }
+
+            vPortFree( pxContext );
+            pxContext = NULL;
+        }
+    }
+
+    if( pxContext != NULL )
+    {
+        for( ulIndex = 0; ulIndex < ( uint32_t ) ggdconfigPROBE_MAX_PARALLEL; ulIndex++ )
+        {
+            pxContext->xSockets[ ulIndex ] = SOCKETS_INVALID_SOCKET;
+        }
+    }
+
+    if( pxContext != NULL )
+    {
+        pxContext->pxHostAddressData = ( GGD_HostAddressData_t * ) &pxContext[ 1 ];
+        pxContext->ulHostAddressCount = ulHostAddressCount;
+        pxContext->ulReferences = 1;
+        pcCopy = ( char * ) &pxContext->pxHostAddressData[ ulHostAddressCount ];
+        pcLastCertificate = NULL;
+
+        for( ulIndex = 0; ulIndex < ulHostAddressCount; ulIndex++ )
+        {
+            pxContext->pxHostAddressData[ ulIndex ] = pxHostAddressData[ ulIndex ];
+
+            if( pxHostAddressData[ ulIndex ].pcCertificate == NULL )
+            {
+                /* The default trust list is used. */
+            }
+            else if( pxHostAddressData[ ulIndex ].pcCertificate == pcLastCertificate )
+            {
+                pxContext->pxHostAddressData[ ulIndex ].pcCertificate = pxContext->pxHostAddressData[ ulIndex - 1U ].pcCertificate;
+            }
+            else
+            {
+                xLength = ( size_t ) pxHostAddressData[ ulIndex ].ulCertificateSize;
+                memcpy( pcCopy, pxHostAddressData[ ulIndex ].pcCertificate, xLength );
+                pxContext->pxHostAddressData[ ulIndex ].pcCertificate = pcCopy;
+                pcLastCertificate = pxHostAddressData[ ulIndex ].pcCertificate;
+                pcCopy += xLength;
+            }
+
+            xLength = strlen( pxHostAddressData[ ulIndex ].pcHostAddress ) + ( size_t ) 1;
+            memcpy( pcCopy, pxHostAddressData[ ulIndex ].pcHostAddress, xLength );
+            pxContext->pxHostAddressData[ ulIndex ].pcHostAddress = pcCopy;
+            pcCopy += xLength;
+        }
+    }
+
+    return pxContext;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProbeContextRelease( GGD_ProbeContext_t * pxContext )
+{
+    BaseType_t xFree;
+
+    taskENTER_CRITICAL();
+    {
+        pxContext->ulReferences--;
+        xFree = ( pxContext->ulReferences == ( uint32_t ) 0 ) ? pdTRUE : pdFALSE;
+    }
+    taskEXIT_CRITICAL();
+
+    if( xFree == pdTRUE )
+    {
+        vEventGroupDelete( pxContext->xEvents );
+        vSemaphoreDelete( pxContext->xSocketsMutex );
+        vPortFree( pxContext );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvProbeSocketAdd( GGD_ProbeContext_t * pxContext,
+                                     Socket_t xSocket,
+                                     uint32_t * pulSlot )
+{
+    BaseType_t xStatus = pdFAIL;
+    uint32_t ulSlot;
+
+    ( void ) xSemaphoreTake( pxContext->xSocketsMutex, portMAX_DELAY );
+
+    /* Once an attempt won, the others are not started, and the winner no
+     * longer looks for sockets to shut down. There is one slot per task. */
+    if( pxContext->xDone == pdFALSE )
+    {
+        for( ulSlot = 0; ulSlot < ( uint32_t ) ggdconfigPROBE_MAX_PARALLEL; ulSlot++ )
+        {
+            if( pxContext->xSockets[ ulSlot ] == SOCKETS_INVALID_SOCKET )
+            {
+                pxContext->xSockets[ ulSlot ] = xSocket;
+                pxContext->xShutDown[ ulSlot ] = pdFALSE;
+                *pulSlot = ulSlot;
+                xStatus = pdPASS;
+                break;
+            }
+        }
+    }
+
+    ( void ) xSemaphoreGive( pxContext->xSocketsMutex );
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProbeSocketRemove( GGD_ProbeContext_t * pxContext,
+                                  uint32_t ulSlot )
+{
+    ( void ) xSemaphoreTake( pxContext->xSocketsMutex, portMAX_DELAY );
+    pxContext->xSockets[ ulSlot ] = SOCKETS_INVALID_SOCKET;
+    ( void ) xSemaphoreGive( pxContext->xSocketsMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvProbeCancelOthers( GGD_ProbeContext_t * pxContext )
+{
+    BaseType_t xPending = pdTRUE;
+    uint32_t ulSlot;
+
+    while( xPending == pdTRUE )
+    {
+        xPending = pdFALSE;
+
+        /* Holding the mutex keeps the tasks from closing the sockets while
+         * they are shut down. */
+        ( void ) xSemaphoreTake( pxContext->xSocketsMutex, portMAX_DELAY );
+
+        for( ulSlot = 0; ulSlot < ( uint32_t ) ggdconfigPROBE_MAX_PARALLEL; ulSlot++ )
+        {
+            if( ( pxContext->xSockets[ ulSlot ] != SOCKETS_INVALID_SOCKET ) &&
+                ( pxContext->xShutDown[ ulSlot ] == pdFALSE ) )
+            {
+                /* The TLS handshake of a shut down socket fails at its next
+                 * read or write. */
+                if( SOCKETS_Shutdown( pxContext->xSockets[ ulSlot ],
+                                      ( uint32_t ) SOCKETS_SHUT_RDWR ) == SOCKETS_ERROR_NONE )
+                {
+                    pxContext->xShutDown[ ulSlot ] = pdTRUE;
+                }
+                else
+                {
+                    xPending = pdTRUE;
+                }
+            }
+        }
+
+        ( void ) xSemaphoreGive( pxContext->xSocketsMutex );
+
+        if( xPending == pdTRUE )
+        {
+            vTaskDelay( pdMS_TO_TICKS( helperPROBE_SHUTDOWN_RETRY_MS ) );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvProbeTask( void * pvParameters )
+{
+    GGD_ProbeContext_t * pxContext = ( GGD_ProbeContext_t * ) pvParameters;
+    Socket_t xSocket = SOCKETS_INVALID_SOCKET;
+    SocketsSockaddr_t xServerAddress;
+    uint32_t ulIndex = 0;
+    uint32_t ulSlot = 0;
+    BaseType_t xTry = pdTRUE;
+    BaseType_t xStatus;
+    BaseType_t xWon = pdFALSE;
+    BaseType_t xLastFailed = pdFALSE;
+
+    while( xTry == pdTRUE )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( ( pxContext->xDone == pdFALSE ) &&
+                ( pxContext->ulNextHost < pxContext->ulHostAddressCount ) )
+            {
+                ulIndex = pxContext->ulNextHost;
+                pxContext->ulNextHost++;
+            }
+            else
+            {
+                xTry = pdFALSE;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xTry == pdTRUE )
+        {
+            xSocket = SOCKETS_INVALID_SOCKET;
+            xStatus = prvSecureConnectPrepare( &pxContext->pxHostAddressData[ ulIndex ],
+                                               &xSocket,
+                                               &xServerAddress,
+                                               pxContext->ulReceiveTimeOut,
+                                               pxContext->ulSendTimeOut );
+
+            /* Let the winner shut the socket down while it connects. */
+            if( xStatus == pdPASS )
+            {
+                xStatus = prvProbeSocketAdd( pxContext, xSocket, &ulSlot );
+            }
+
+            if( xStatus == pdPASS )
+            {
+                if( SOCKETS_Connect( xSocket,
+                                     &xServerAddress,
+                                     ( uint32_t ) sizeof( xServerAddress ) ) != SOCKETS_ERROR_NONE )
+                {
+                    xStatus = pdFAIL;
+                }
+
+                prvProbeSocketRemove( pxContext, ulSlot );
+            }
+
+            if( xStatus == pdPASS )
+            {
+                taskENTER_CRITICAL();
+                {
+                    if( pxContext->xDone == pdFALSE )
+                    {
+                        pxContext->xDone = pdTRUE;
+                        pxContext->ulWinner = ulIndex;
+                        pxContext->xWinnerSocket = xSocket;
+                        xWon = pdTRUE;
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                /* Another host answered first, or this one did. */
+                xTry = pdFALSE;
+            }
+
+            if( xWon == pdTRUE )
+            {
+                ( void ) xEventGroupSetBits( pxContext->xEvents, helperPROBE_WON_BIT );
+                prvProbeCancelOthers( pxContext );
+            }
+            else if( xSocket != SOCKETS_INVALID_SOCKET )
+            {
+                /* Closing the socket frees its TLS context straight away. */
+                ( void ) SOCKETS_Close( xSocket );
+                xSocket = SOCKETS_INVALID_SOCKET;
+            }
+            else
+            {
+                /* No socket could be created. */
+            }
+        }
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxContext->ulRunning--;
+
+        /* A task only stops without a winner once there are no hosts left. */
+        if( ( pxContext->ulRunning == ( uint32_t ) 0 ) && ( pxContext->xDone == pdFALSE ) )
+        {
+            xLastFailed = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( xLastFailed == pdTRUE )
+    {
+        ( void ) xEventGroupSetBits( pxContext->xEvents, helperPROBE_FAILED_BIT );
+    }
+
+    prvProbeContextRelease( pxContext );
+    vTaskDelete( NULL );
+}
@@ -58,6 +58,13 @@ extern "C" {
 /* Basic FreeRTOS definitions. */
 #include "projdefs.h"
 
+/* Must be defaulted before the port layer is included, as ports only provide
+the interface used by the multicore scheduler when configNUM_CORES is greater
+than 1. */
+#ifndef configNUM_CORES
+	#define configNUM_CORES 1
+#endif
+
 /* Definitions specific to the port being used. */
 #include "portable.h"
 
@@ -688,6 +695,46 @@ extern "C" {
 	#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceMEMORY_POOL_CREATE
+	#define traceMEMORY_POOL_CREATE( pxMemoryPool )
+#endif
+
+#ifndef traceMEMORY_POOL_CREATE_FAILED
+	#define traceMEMORY_POOL_CREATE_FAILED()
+#endif
+
+#ifndef traceMEMORY_POOL_DELETE
+	#define traceMEMORY_POOL_DELETE( xMemoryPool )
+#endif
+
+#ifndef traceMEMORY_POOL_ALLOC
+	#define traceMEMORY_POOL_ALLOC( xMemoryPool, pvBlock, uxFreeBlocks )
+#endif
+
+#ifndef traceMEMORY_POOL_ALLOC_FAILED
+	#define traceMEMORY_POOL_ALLOC_FAILED( xMemoryPool )
+#endif
+
+#ifndef traceBLOCKING_ON_MEMORY_POOL_ALLOC
+	#define traceBLOCKING_ON_MEMORY_POOL_ALLOC( xMemoryPool )
+#endif
+
+#ifndef traceMEMORY_POOL_ALLOC_FROM_ISR
+	#define traceMEMORY_POOL_ALLOC_FROM_ISR( xMemoryPool, pvBlock, uxFreeBlocks )
+#endif
+
+#ifndef traceMEMORY_POOL_ALLOC_FROM_ISR_FAILED
+	#define traceMEMORY_POOL_ALLOC_FROM_ISR_FAILED( xMemoryPool )
+#endif
+
+#ifndef traceMEMORY_POOL_FREE
+	#define traceMEMORY_POOL_FREE( xMemoryPool, pvBlock, uxFreeBlocks )
+#endif
+
+#ifndef traceMEMORY_POOL_FREE_FROM_ISR
+	#define traceMEMORY_POOL_FREE_FROM_ISR( xMemoryPool, pvBlock, uxFreeBlocks )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
 	#define configGENERATE_RUN_TIME_STATS 0
 #endif
@@ -719,7 +766,13 @@ extern "C" {
 #endif
 
 #ifndef portYIELD_WITHIN_API
-	#define portYIELD_WITHIN_API portYIELD
+	#if ( configNUM_CORES > 1 )
+		/* A task that yields from inside a critical section only latches the
+		yield, which is then performed when the critical section is exited. */
+		#define portYIELD_WITHIN_API vTaskYieldWithinAPI
+	#else
+		#define portYIELD_WITHIN_API portYIELD
+	#endif
 #endif
 
 #ifndef portSUPPRESS_TICKS_AND_SLEEP
@@ -806,6 +859,12 @@ extern "C" {
 	#define configUSE_TASK_NOTIFICATIONS 1
 #endif
 
+#ifndef configTASK_NOTIFICATION_ARRAY_ENTRIES
+	/* The number of notification values, and notification states, each task
+	has.  Index 0 is used by the original notification API. */
+	#define configTASK_NOTIFICATION_ARRAY_ENTRIES 1
+#endif
+
 #ifndef configUSE_POSIX_ERRNO
 	#define configUSE_POSIX_ERRNO 0
 #endif
@@ -830,6 +889,19 @@ extern "C" {
 	#define configSTACK_DEPTH_TYPE uint16_t
 #endif
 
+#ifndef configUSE_TIMING_WHEEL
+	/* Set to 1 to hold Blocked state tasks in a timing wheel instead of a list
+	sorted by wake time, so the cost of blocking and unblocking a task does not
+	depend on the number of tasks already blocked. */
+	#define configUSE_TIMING_WHEEL 0
+#endif
+
+#ifndef configTIMING_WHEEL_SLOTS
+	/* Number of slots in each of the two levels of the timing wheel.  Must be
+	a power of 2 and at least 32. */
+	#define configTIMING_WHEEL_SLOTS 64
+#endif
+
 /* Sanity check the configuration. */
 #if( configUSE_TICKLESS_IDLE != 0 )
 	#if( INCLUDE_vTaskSuspend != 1 )
@@ -845,6 +917,67 @@ extern "C" {
 	#error configUSE_MUTEXES must be set to 1 to use recursive mutexes
 #endif
 
+#if( configUSE_TIMING_WHEEL == 1 )
+	#if( ( configTIMING_WHEEL_SLOTS < 32 ) || ( configTIMING_WHEEL_SLOTS > 4096 ) || ( ( configTIMING_WHEEL_SLOTS & ( configTIMING_WHEEL_SLOTS - 1 ) ) != 0 ) )
+		#error configTIMING_WHEEL_SLOTS must be a power of 2 between 32 and 4096
+	#endif
+	#if( ( configUSE_16_BIT_TICKS == 1 ) && ( configTIMING_WHEEL_SLOTS > 256 ) )
+		#error configTIMING_WHEEL_SLOTS cannot be greater than 256 if configUSE_16_BIT_TICKS is set to 1
+	#endif
+#endif /* configUSE_TIMING_WHEEL */
+
+#if( configTASK_NOTIFICATION_ARRAY_ENTRIES < 1 )
+	#error configTASK_NOTIFICATION_ARRAY_ENTRIES must be at least 1
+#endif
+
+#if( configNUM_CORES < 1 )
+	#error configNUM_CORES must be at least 1
+#endif
+
+#if( configNUM_CORES > 1 )
+	/* Each core needs its own bit in a task's affinity mask. */
+	#if( configNUM_CORES > 16 )
+		#error configNUM_CORES cannot be greater than 16
+	#endif
+
+	#ifndef portGET_CORE_ID
+		#error portGET_CORE_ID() must be defined by the port when configNUM_CORES is greater than 1
+	#endif
+
+	#ifndef portYIELD_CORE
+		#error portYIELD_CORE() must be defined by the port when configNUM_CORES is greater than 1
+	#endif
+
+	#if !defined( portGET_TASK_LOCK ) || !defined( portRELEASE_TASK_LOCK ) || !defined( portGET_ISR_LOCK ) || !defined( portRELEASE_ISR_LOCK )
+		#error The port must define the task and ISR locks when configNUM_CORES is greater than 1
+	#endif
+
+	#if !defined( portSET_INTERRUPT_MASK ) || !defined( portCLEAR_INTERRUPT_MASK )
+		#error The port must define portSET_INTERRUPT_MASK() and portCLEAR_INTERRUPT_MASK() when configNUM_CORES is greater than 1
+	#endif
+
+	/* The idle task of each core other than core 0 is allocated dynamically. */
+	#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+		#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 if configNUM_CORES is greater than 1
+	#endif
+
+	/* The scheduler is suspended, so all the other cores are held off the
+	kernel, for the whole time the idle task sleeps in tickless mode. */
+	#if( configUSE_TICKLESS_IDLE != 0 )
+		#error configUSE_TICKLESS_IDLE must be set to 0 if configNUM_CORES is greater than 1
+	#endif
+
+	/* The critical nesting count is held per core by the kernel. */
+	#if( portCRITICAL_NESTING_IN_TCB == 1 )
+		#error portCRITICAL_NESTING_IN_TCB cannot be used if configNUM_CORES is greater than 1
+	#endif
+
+	/* Both are swapped in and out of a single global on each context switch. */
+	#if( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_POSIX_ERRNO == 1 ) )
+		#error configUSE_NEWLIB_REENTRANT and configUSE_POSIX_ERRNO must be set to 0 if configNUM_CORES is greater than 1
+	#endif
+#endif /* configNUM_CORES */
+
 #ifndef configINITIAL_TICK_COUNT
 	#define configINITIAL_TICK_COUNT 0
 #endif
@@ -1020,8 +1153,8 @@ typedef struct xSTATIC_TCB
 		struct	_reent	xDummy17;
 	#endif
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
-		uint32_t 		ulDummy18;
-		uint8_t 		ucDummy19;
+		uint32_t 		ulDummy18[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		uint8_t 		ucDummy19[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 	#if( ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) || ( portUSING_MPU_WRAPPERS == 1 ) )
 		uint8_t			uxDummy20;
@@ -1032,6 +1165,10 @@ typedef struct xSTATIC_TCB
 	#if ( configUSE_POSIX_ERRNO == 1 )
 		int             iDummy22;
 	#endif
+	#if ( configNUM_CORES > 1 )
+		BaseType_t		xDummy23;
+		UBaseType_t		uxDummy24;
+	#endif
 } StaticTask_t;
 
 /*
@@ -1165,6 +1302,32 @@ typedef struct xSTATIC_STREAM_BUFFER
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+* In line with software engineering best practice, especially when supplying a
+* library that is likely to change in future versions, FreeRTOS implements a
+* strict data hiding policy.  This means the memory pool structure used
+* internally by FreeRTOS is not accessible to application code.  However, if
+* the application writer wants to statically allocate the memory required to
+* create a memory pool then the size of the memory pool object needs to be
+* know.  The StaticMemoryPool_t structure below is provided for this purpose.
+* Its size and alignment requirements are guaranteed to match those of the
+* genuine structure, no matter which architecture is being used, and no matter
+* how the values in FreeRTOSConfig.h are set.  Its contents are somewhat
+* obfuscated in the hope users will recognise that it would be unwise to make
+* direct use of the structure members.
+*/
+typedef struct xSTATIC_MEMORY_POOL
+{
+	void * pvDummy1[ 2 ];
+	size_t uxDummy2;
+	UBaseType_t uxDummy3[ 4 ];
+	void * pvDummy4;
+	uint8_t ucDummy5;
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		StaticQueue_t xDummy6;
+	#endif
+} StaticMemoryPool_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,6 +39,7 @@
 /* Undefine all errnos to avoid redefinition errors with system errnos. */
 #undef EPERM
 #undef ENOENT
+#undef EINTR
 #undef EBADF
 #undef EAGAIN
 #undef ENOMEM
@@ -61,6 +62,7 @@
 /**@{ */
 #define EPERM        1   /**< Operation not permitted. */
 #define ENOENT       2   /**< No such file or directory. */
+#define EINTR        4   /**< Interrupted function. */
 #define EBADF        9   /**< Bad file descriptor. */
 #define EAGAIN       11  /**< Resource unavailable, try again. */
 #define ENOMEM       12  /**< Not enough space. */
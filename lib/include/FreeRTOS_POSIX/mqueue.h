@@ -137,4 +137,62 @@ int mq_timedsend( mqd_t mqdes,
  */
 int mq_unlink( const char * name );
 
+/**
+ * @defgroup Zero-copy message queue extensions.
+ *
+ * These functions are not part of POSIX. They pass message buffers between
+ * threads instead of copying the messages. A buffer is obtained from a queue
+ * with mq_zc_alloc() or mq_zc_timedreceive(), and holds up to mq_msgsize bytes.
+ * It belongs to the caller until it is sent with mq_zc_timedsend() or given
+ * back with mq_zc_free(), on the same queue.
+ */
+/**@{ */
+
+/**
+ * @brief Get a message buffer from a message queue.
+ *
+ * @return The buffer; NULL with errno set to EBADF or ENOMEM on failure.
+ */
+char * mq_zc_alloc( mqd_t mqdes );
+
+/**
+ * @brief Give a message buffer back to the message queue it came from.
+ *
+ * The buffer is freed if the queue has been removed, or if it came from
+ * another queue.
+ */
+void mq_zc_free( mqd_t mqdes,
+                 char * msg_ptr );
+
+/**
+ * @brief Receive a message buffer from a message queue with timeout.
+ *
+ * On success, *msg_ptr is set to the message buffer and the length of the
+ * message is returned. The caller must give the buffer back with
+ * mq_zc_free() or send it with mq_zc_timedsend().
+ *
+ * @note msg_prio is ignored.
+ */
+ssize_t mq_zc_timedreceive( mqd_t mqdes,
+                            char ** msg_ptr,
+                            unsigned * msg_prio,
+                            const struct timespec * abstime );
+
+/**
+ * @brief Send a message buffer to a message queue with timeout.
+ *
+ * On success, the buffer belongs to the queue and must no longer be used by
+ * the caller. On failure, it still belongs to the caller. Fails with EINVAL if
+ * the buffer was not obtained from the same queue, and with EMSGSIZE if
+ * msg_len exceeds mq_msgsize or the size of the buffer.
+ *
+ * @note msg_prio is ignored.
+ */
+int mq_zc_timedsend( mqd_t mqdes,
+                     char * msg_ptr,
+                     size_t msg_len,
+                     unsigned msg_prio,
+                     const struct timespec * abstime );
+/**@} */
+
 #endif /* ifndef _FREERTOS_POSIX_MQUEUE_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Amazon FreeRTOS+POSIX V1.0.0
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file poll.h
+ * @brief Input/output multiplexing.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/basedefs/poll.h.html
+ *
+ * FreeRTOS has no file descriptors, so struct pollfd holds the handle of the
+ * object to wait on and the type of that object.
+ */
+
+#ifndef _FREERTOS_POSIX_POLL_H_
+#define _FREERTOS_POSIX_POLL_H_
+
+/**
+ * @defgroup Events that can be requested in pollfd.events and returned in
+ * pollfd.revents.
+ */
+/**@{ */
+#define POLLIN      0x0001 /**< Data may be read without blocking. */
+#define POLLOUT     0x0004 /**< Data may be written without blocking. */
+#define POLLERR     0x0008 /**< An error has occurred (revents only). */
+#define POLLHUP     0x0010 /**< The peer has closed the connection (revents only). */
+#define POLLNVAL    0x0020 /**< Invalid pollfd.fd or pollfd.fdtype (revents only). */
+/**@} */
+
+/**
+ * @defgroup Types of the objects that can be polled, set in pollfd.fdtype.
+ */
+/**@{ */
+#define POLLFD_SOCKET    0 /**< FreeRTOS+TCP Socket_t, if posixconfigPOLL_FREERTOS_TCP_SOCKETS is 1. */
+#define POLLFD_MQ        1 /**< mqd_t returned by mq_open. */
+#define POLLFD_SEM       2 /**< sem_t initialized by sem_init. Only POLLIN is reported. */
+/**@} */
+
+/**
+ * @brief Number of entries in the array given to poll.
+ */
+typedef unsigned int nfds_t;
+
+/**
+ * @brief An object to wait on.
+ */
+struct pollfd
+{
+    void * fd;     /**< Handle of the object. Entries with a NULL handle are ignored. */
+    int fdtype;    /**< Type of the object, one of POLLFD_SOCKET, POLLFD_MQ or POLLFD_SEM. */
+    short events;  /**< Requested events. */
+    short revents; /**< Returned events. */
+};
+
+/**
+ * @brief Wait for events on a set of sockets, message queues and semaphores.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/poll.html
+ *
+ * @note The calling thread blocks on a single event group, which every object
+ * in fds wakes up. A socket can only be waited on by one thread at a time,
+ * and it must not also be in a FreeRTOS+TCP socket set. Objects must not be
+ * closed or destroyed while a thread is in poll on them.
+ */
+int poll( struct pollfd fds[],
+          nfds_t nfds,
+          int timeout );
+
+#endif /* _FREERTOS_POSIX_POLL_H_ */
@@ -94,4 +94,99 @@ BaseType_t CRYPTO_SignatureVerificationFinal( void * pvContext,
                                               uint8_t * pucSignature,
                                               size_t xSignatureLength );
 
+/**
+ * @brief A hash implementation that CRYPTO_Hash* calls can be routed to.
+ *
+ * Backends are tried in order of preference, and the first one whose
+ * pxIsSupported reports pdTRUE on the running CPU is used. A port can put its
+ * own backend, such as a hardware hash engine, ahead of the built-in ones by
+ * defining cryptoconfigHASH_BACKEND_PORT to the name of a
+ * CRYPTO_HashBackend_t object.
+ */
+typedef struct CRYPTO_HashBackend
+{
+    const char * pcName;                          /**< Name shown in benchmark output. */
+    BaseType_t ( * pxIsSupported )( void );       /**< Runtime feature check, or NULL if always usable. */
+    size_t xStateSize;                            /**< Bytes of per-stream state. */
+    void ( * pxStart )( void * pvState );
+    void ( * pxUpdate )( void * pvState,
+                         const uint8_t * pucData,
+                         size_t xDataLength );
+    void ( * pxFinish )( void * pvState,
+                         uint8_t * pucDigest );
+    /** Hashes several independent streams in one call, or NULL. */
+    void ( * pxUpdateMulti )( void * const * ppvStates,
+                              const uint8_t * const * ppucData,
+                              const size_t * pxDataLength,
+                              size_t xCount );
+} CRYPTO_HashBackend_t;
+
+/**
+ * @brief Enumerates the hash backends usable on this CPU.
+ *
+ * @param[in] uxIndex Zero-based index, in order of preference.
+ *
+ * @return The backend, or NULL once uxIndex passes the last one.
+ */
+const CRYPTO_HashBackend_t * CRYPTO_HashGetBackend( UBaseType_t uxIndex );
+
+/**
+ * @brief Selects the backend used by hash contexts started from now on.
+ *
+ * @param[in] pxBackend A backend from CRYPTO_HashGetBackend(), or NULL to go
+ * back to the preferred one.
+ *
+ * @return pdTRUE if the backend was selected, or pdFALSE if it is not usable
+ * on this CPU.
+ */
+BaseType_t CRYPTO_HashSetBackend( const CRYPTO_HashBackend_t * pxBackend );
+
+/**
+ * @brief Starts a hash computation on the selected backend.
+ *
+ * @param[out] ppvContext Opaque context structure.
+ * @param[in] xHashAlgorithm Only cryptoHASH_ALGORITHM_SHA256 is supported.
+ *
+ * @return pdTRUE if the context was created, or pdFALSE otherwise.
+ */
+BaseType_t CRYPTO_HashStart( void ** ppvContext,
+                             BaseType_t xHashAlgorithm );
+
+/**
+ * @brief Adds bytes to an in-progress hash.
+ *
+ * @param[in] pvContext Opaque context structure.
+ * @param[in] pucData Bytes to hash.
+ * @param[in] xDataLength Length in bytes of pucData.
+ */
+void CRYPTO_HashUpdate( void * pvContext,
+                        const uint8_t * pucData,
+                        size_t xDataLength );
+
+/**
+ * @brief Adds bytes to several independent in-progress hashes at once.
+ *
+ * Backends that can interleave streams, such as the SHA extensions, hash the
+ * streams together; the others hash them one after another.
+ *
+ * @param[in] ppvContexts Opaque context structures, one per stream.
+ * @param[in] ppucData Bytes to add to each stream.
+ * @param[in] pxDataLength Length in bytes of each ppucData entry.
+ * @param[in] xCount Number of streams.
+ */
+void CRYPTO_HashUpdateMulti( void * const * ppvContexts,
+                             const uint8_t * const * ppucData,
+                             const size_t * pxDataLength,
+                             size_t xCount );
+
+/**
+ * @brief Completes a hash and frees its context.
+ *
+ * @param[in] pvContext Opaque context structure.
+ * @param[out] pucDigest Hash result, cryptoSHA256_DIGEST_BYTES long. May be
+ * NULL to free the context after a failure.
+ */
+void CRYPTO_HashFinish( void * pvContext,
+                        uint8_t * pucDigest );
+
 #endif /* ifndef __AWS_CRYPTO__H__ */
@@ -25,9 +25,12 @@
 #ifndef AWS_DEFENDER_H
 #define AWS_DEFENDER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "aws_mqtt_agent.h"
+
 /**
  * @brief Pointer to a Defender metric structure
  * @note Calling application should not access the contents of the structure
@@ -87,6 +90,15 @@ typedef enum
 /** Maximum number of reportable metrics */
 #define DEFENDER_MAX_METRICS_COUNT    ( 1 )
 
+/**
+ * Size of the buffer the agent encodes each report into.  The report is
+ * written in a single pass, so this only needs to hold the largest encoded
+ * report.  Define it in the build to change it.
+ */
+#ifndef DEFENDER_REPORT_BUFFER_SIZE
+    #define DEFENDER_REPORT_BUFFER_SIZE    ( 256 )
+#endif
+
 /** Provides a count of established tcp connections */
 extern DefenderMetric_t xDefenderTCPConnections;
 
@@ -126,6 +138,34 @@ DefenderErr_t DEFENDER_ReportPeriodSet( uint32_t ulPeriodSec );
  */
 DefenderErr_t DEFENDER_ConnectionTimeoutSet( uint32_t ulTimeoutMs );
 
+/**
+ * @brief Reports over an MQTT connection owned by the application
+ *
+ * The agent subscribes to the report topics on the given connection and keeps
+ * those subscriptions between reports.  It never connects, disconnects or
+ * deletes the connection, so the application must keep it connected.  If a
+ * report fails to publish, the subscriptions are renewed on the next report.
+ * Pass NULL to go back to the agent's own connection.
+ *
+ * @param[in]  xMQTTAgent  Handle of a connected MQTT agent, or NULL
+ *
+ * @return     DefenderErr_t
+ */
+DefenderErr_t DEFENDER_ConnectionSet( MQTTAgentHandle_t xMQTTAgent );
+
+/**
+ * @brief Keeps the agent's own MQTT connection open between reports
+ *
+ * By default the agent connects, subscribes and disconnects for every report.
+ * When enabled, the connection and subscriptions are kept across reports and
+ * only re-established after a failure.
+ *
+ * @param[in]  xKeepConnection  true to keep the connection open
+ *
+ * @return     DefenderErr_t
+ */
+DefenderErr_t DEFENDER_KeepConnectionSet( bool xKeepConnection );
+
 /**
  * @brief Starts the defender agent
  * @return DefenderErr_t
@@ -69,14 +69,21 @@ typedef struct
  *
  * @note: In most case only calling this function is needed!
  * This function will perform in series:
- * 1. GGD_JSONRequest.
- * 2. GGD_GetJSONFileSize.
- * 3. GGD_GetJSONFile.
- * 4. GGD_ConnectToHost with auto slection parameters set to true.
- * The buffer size of pcBuffer need to be big enough to hold the complete
- * JSON file.
- *
- * @param [in] pcBuffer: Memory buffer provided by the user.
+ * 1. GGD_JSONRequestStart.
+ * 2. GGD_JSONRequestParse with auto selection set to true.
+ * 3. GGD_SecureConnect_ConnectFirst to the addresses of the core, which
+ * races staggered connection attempts and keeps the first that succeeds.
+ * The JSON file is parsed as it is received, so the buffer only needs to be
+ * big enough to hold the certificate and the addresses of the core, not the
+ * complete JSON file.
+ *
+ * The result is cached for ggdconfigCACHE_VALIDITY_S seconds. While it is
+ * valid, and the same buffer is passed in unmodified, steps 1 and 2 are
+ * skipped and the address that answered last time is tried first. If none
+ * of the cached addresses answer, a new discovery request is sent.
+ *
+ * @param [in] pcBuffer: Memory buffer provided by the user. The returned
+ * address and certificate point into it.
  *
  * @param [in] ulBufferSize: Size of the memory buffer.
  *
@@ -115,6 +122,9 @@ BaseType_t GGD_JSONRequestStart( Socket_t * pxSocket );
  *
  * @param [out] pulJSONFileSize: The size of the requested JSON file.
  *
+ * @note Fails if the response uses chunked transfer encoding, as its size
+ * is not known in advance. Use GGD_JSONRequestParse instead.
+ *
  * @return If the JSON file size was received successfully
  * then pdPASS is returned.  Otherwise pdFAIL is returned.
  */
@@ -167,6 +177,61 @@ BaseType_t GGD_JSONRequestGetFile( Socket_t * pxSocket,
                                    BaseType_t * pxJSONFileRetrieveCompleted,
                                    const uint32_t pulJSONFileSize );
 
+/*
+ * @brief Get the certificate and addresses of a GreenGrass core from the cloud.
+ *
+ * This call will close the socket in parameter. Need previous call from
+ * GGD_JSONRequestStart. GGD_JSONRequestGetSize is not needed, and responses
+ * using chunked transfer encoding are supported.
+ *
+ * @note The JSON file is parsed as it is received, so it never has to be held
+ * in memory. The certificate of the group, followed by the addresses of the
+ * core, are written to pcBuffer. Only the first group and core that match
+ * are kept, and at most *pulHostAddressCount addresses.
+ *
+ * @param [in] pxSocket: Socket for the cloud connection.
+ * @warning The socket Will be closed.Set to SOCKETS_INVALID_SOCKET.
+ *
+ * @param [in] pcBuffer: Memory buffer provided by the user, that will hold
+ * the certificate and the addresses.
+ *
+ * @param [in] ulBufferSize: Size of the memory buffer provided.
+ *
+ * @param [in] pxHostParameters: Contains the group name and cloud address
+ * of the desired core. The interface is not used, as all the addresses of
+ * the core are returned.
+ * @warning: Cannot be NULL if xAutoSelectFlag is set to pdFALSE
+ *
+ * @param [in] xAutoSelectFlag: If set to pdTRUE, the first core found is
+ * used, and pxHostParameters can be set to NULL.
+ *
+ * @param [out] pxHostAddressData: Array that receives an entry for each
+ * address of the core, in the order found in the JSON file. All entries
+ * point to the same certificate.
+ *
+ * @param [in, out] pulHostAddressCount: The number of entries in
+ * pxHostAddressData on input, and the number of addresses found on output.
+ *
+ * @return If a core was found and its certificate and addresses fitted in
+ * pcBuffer then pdPASS is returned.  Otherwise pdFAIL is returned.
+ */
+BaseType_t GGD_JSONRequestParse( Socket_t * pxSocket,
+                                 char * pcBuffer,
+                                 const uint32_t ulBufferSize,
+                                 const HostParameters_t * pxHostParameters,
+                                 const BaseType_t xAutoSelectFlag,
+                                 GGD_HostAddressData_t * pxHostAddressData,
+                                 uint32_t * pulHostAddressCount );
+
+/*
+ * @brief Discard the cached result of the last discovery.
+ *
+ * The next call to GGD_GetGGCIPandCertificate will send a new discovery
+ * request. Call this if the core returned can no longer be used, for
+ * example because the MQTT connection to it failed.
+ */
+void GGD_InvalidateCache( void );
+
 /*
  * @brief Need to be called if GGD_JSONRequestGetFile cannot be called.
  *
@@ -369,6 +369,30 @@ typedef uint32_t ( * MQTTSend_t ) ( void * pvSendContext,
                                     const uint8_t * const pucData,
                                     uint32_t ulDataLength );
 
+/**
+ * @brief Signature of the optional user supplied callback to transmit a message
+ * whose payload is in a separate buffer.
+ *
+ * If the user registers this callback, the library uses it to transmit publish
+ * messages. Only the header of the message is encoded in a buffer from the
+ * buffer pool; the payload is transmitted straight from the buffer supplied in
+ * the publish parameters, right after the header, so it is never copied by the
+ * library.
+ *
+ * @param[in] pvSendContext The send context as supplied by the user in Init parameters.
+ * @param[in] pucHeader The header of the message.
+ * @param[in] ulHeaderLength The length of the header.
+ * @param[in] pucPayload The payload of the message.
+ * @param[in] ulPayloadLength The length of the payload.
+ *
+ * @return The number of bytes actually transmitted, header and payload included.
+ */
+typedef uint32_t ( * MQTTSendv_t ) ( void * pvSendContext,
+                                     const uint8_t * const pucHeader,
+                                     uint32_t ulHeaderLength,
+                                     const uint8_t * const pucPayload,
+                                     uint32_t ulPayloadLength );
+
 /**
  * @brief Signature of the callback to get the current tick count.
  *
@@ -481,6 +505,7 @@ typedef struct MQTTContext
     MQTTEventCallback_t pxCallback;                             /**< Callback supplied  by the user to get notified of various events. */
     void * pvSendContext;                                       /**< As supplied by the user in Init parameters. */
     MQTTSend_t pxMQTTSendFxn;                                   /**< Callback supplied by the user to transmit data. */
+    MQTTSendv_t pxMQTTSendvFxn;                                 /**< Callback supplied by the user to transmit a header and a separate payload. */
     MQTTGetTicks_t pxGetTicksFxn;                               /**< Callback supplied by the user to get current tick count. */
     MQTTBufferPoolInterface_t xBufferPoolInterface;             /**< The buffer pool interface supplied by the user. @see MQTTBufferPoolInterface_t. */
     MQTTConnectionState_t xConnectionState;                     /**< The current connection state. */
@@ -505,6 +530,7 @@ typedef struct MQTTInitParams
     MQTTEventCallback_t pxCallback;                 /**< User supplied callback to get notified of various events. Can be NULL. @see MQTTEventCallback_t.*/
     void * pvSendContext;                           /**< Passed as it is in the send callback. */
     MQTTSend_t pxMQTTSendFxn;                       /**< User supplied callback to transmit data. Must not be NULL. @see MQTTSend_t. */
+    MQTTSendv_t pxMQTTSendvFxn;                     /**< User supplied callback to transmit publish messages without copying the payload. Can be NULL. @see MQTTSendv_t. */
     MQTTGetTicks_t pxGetTicksFxn;                   /**< User supplied callback to get the current tick count. Can be NULL. @see MQTTGetTicks_t. */
     MQTTBufferPoolInterface_t xBufferPoolInterface; /**< User supplied buffer pool interface. @see MQTTBufferPoolInterface_t. */
 } MQTTInitParams_t;
@@ -64,4 +64,25 @@
 /* Bring in the public header. */
 #include "pkcs11.h"
 
+/**
+ * @brief Number of times C_SeedRandom has reseeded the generator of the
+ * mbedTLS based PKCS#11 module.
+ *
+ * Not part of the PKCS#11 standard. Lets tests confirm that a reseed took
+ * effect, which cannot be seen in the random bytes.
+ */
+CK_ULONG ulPkcs11GetDrbgReseedCount( void );
+
+/**
+ * @brief Number of times C_CreateObject has changed the stored objects of the
+ * mbedTLS based PKCS#11 module.
+ *
+ * Not part of the PKCS#11 standard. Callers that cache keys or certificates
+ * read from the module compare it with the value seen when they read them,
+ * and read them again if it moved. Ports using another PKCS#11 module set
+ * tlsconfigPKCS11_OBJECT_GENERATION to 0, so that the TLS library does not
+ * call it.
+ */
+CK_ULONG ulPkcs11GetObjectGeneration( void );
+
 #endif /* ifndef _AWS_PKCS11_H_ */
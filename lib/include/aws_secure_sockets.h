@@ -189,6 +189,15 @@ typedef struct SocketsSockaddr
     uint32_t ulAddress;     /**< IP Address. Convention is to call this sin_addr. */
 } SocketsSockaddr_t;
 
+/**
+ * @brief One buffer of a call to SOCKETS_Sendv().
+ */
+typedef struct SocketsIovec
+{
+    const void * pvBuffer; /**< Start of the buffer. */
+    size_t xLength;        /**< Length of the buffer in bytes. */
+} SocketsIovec_t;
+
 /**
  * @brief Well-known port numbers.
  */
@@ -300,6 +309,29 @@ int32_t SOCKETS_Send( Socket_t xSocket,
                       size_t xDataLength,
                       uint32_t ulFlags );
 
+/**
+ * @brief Transmit the data of several buffers to the remote socket.
+ *
+ * The buffers are sent in order, as if they were one buffer, so a message
+ * made of a header and a separate payload does not need to be copied into
+ * one buffer first. Where the port supports it the data is written to the
+ * TLS record or the transmit stream straight from the buffers.
+ *
+ * @param[in] xSocket The handle of the sending socket.
+ * @param[in] pxVectors The buffers containing the data to be sent.
+ * @param[in] xVectorCount The number of entries in pxVectors.
+ * @param[in] ulFlags Not currently used. Should be set to 0.
+ *
+ * @return
+ * * On success, the total number of bytes actually sent is returned.
+ * * If an error occurred before any data was sent, a negative value is
+ *   returned. @ref SocketsErrors
+ */
+int32_t SOCKETS_Sendv( Socket_t xSocket,
+                       const SocketsIovec_t * pxVectors,
+                       size_t xVectorCount,
+                       uint32_t ulFlags );
+
 /**
  * @brief Closes all or part of a full-duplex connection on the socket.
  *
@@ -80,6 +80,60 @@ typedef struct xTLS_PARAMS
     void * pvCallerContext;
 } TLSParams_t;
 
+/**
+ * @brief One segment of a gathered write.
+ *
+ * @param[in] pucData Start of the segment.
+ * @param[in] xLength Length of the segment in bytes.
+ */
+typedef struct xTLS_IOVEC
+{
+    const unsigned char * pucData;
+    size_t xLength;
+} TLSIovec_t;
+
+/**
+ * @brief Handshake counters accumulated across all TLS contexts.
+ *
+ * @param[out] ulFullHandshakes Handshakes that negotiated a new session.
+ * @param[out] ulResumedHandshakes Handshakes that resumed a cached session.
+ * @param[out] ulFailedHandshakes Handshakes that failed.
+ * @param[out] ulHandshakeTicks Total time spent in handshakes, in ticks.
+ * @param[out] ulHandshakeBytesSent Total bytes sent during handshakes.
+ * @param[out] ulHandshakeBytesReceived Total bytes received during handshakes.
+ */
+typedef struct xTLS_STATS
+{
+    uint32_t ulFullHandshakes;
+    uint32_t ulResumedHandshakes;
+    uint32_t ulFailedHandshakes;
+    uint32_t ulHandshakeTicks;
+    uint32_t ulHandshakeBytesSent;
+    uint32_t ulHandshakeBytesReceived;
+} TLSStats_t;
+
+/**
+ * @brief Heap used by one connection.
+ *
+ * The client credential and root CA chains are shared by all connections and
+ * are not included.
+ *
+ * @param[out] ulContextBytes Internal context, including the mbedTLS state.
+ * @param[out] ulRecordBufferBytes Input and output record buffers.
+ * @param[out] ulSessionBytes Negotiated session, keys and server certificate.
+ * @param[out] ulMaxFragmentLength Largest record payload the peers agreed on.
+ * @param[out] ulUnusedRecordBytes Record buffer bytes beyond the agreed
+ * payload size, which a lower MBEDTLS_SSL_MAX_CONTENT_LEN would save.
+ */
+typedef struct xTLS_MEMORY_REPORT
+{
+    uint32_t ulContextBytes;
+    uint32_t ulRecordBufferBytes;
+    uint32_t ulSessionBytes;
+    uint32_t ulMaxFragmentLength;
+    uint32_t ulUnusedRecordBytes;
+} TLSMemoryReport_t;
+
 /**
  * @brief Initializes the TLS context.
  *
@@ -94,6 +148,11 @@ BaseType_t TLS_Init( void ** ppvContext,
 /**
  * @brief Negotiates TLS and connects to the server.
  *
+ * If a session with the same server name was negotiated recently, it is
+ * offered for resumption. The server may accept it, which skips the key
+ * exchange and client authentication, or decline it, in which case a full
+ * handshake takes place.
+ *
  * @param pvContext Opaque context handle for TLS library.
  *
  * @return Zero on success. Error return codes have the high bit set.
@@ -127,6 +186,27 @@ BaseType_t TLS_Send( void * pvContext,
                      const unsigned char * pucMsg,
                      size_t xMsgLength );
 
+/**
+ * @brief Writes several buffers to the secure connection as one stream.
+ *
+ * A message split over several buffers (such as a protocol header and its
+ * payload) is sent without first being assembled in a buffer of the caller.
+ * Small segments are gathered so they share a record. If
+ * tlsconfigSENDV_IN_RECORD is 1, every segment is instead copied straight into
+ * the TLS record being built.
+ *
+ * @param pvContext Opaque context handle for TLS library.
+ * @param pxVectors Segments to send, in order.
+ * @param xVectorCount Number of entries in pxVectors.
+ *
+ * @return Number of bytes sent. Error return codes have the high bit set. If
+ * an error follows a partial write, the number of bytes sent is returned and
+ * the next call returns the error.
+ */
+BaseType_t TLS_Sendv( void * pvContext,
+                      const TLSIovec_t * pxVectors,
+                      size_t xVectorCount );
+
 /**
  * @brief Frees resources consumed by the TLS context.
  *
@@ -134,4 +214,34 @@ BaseType_t TLS_Send( void * pvContext,
  */
 void TLS_Cleanup( void * pvContext );
 
+/**
+ * @brief Drops the cached client credential and root CA chains.
+ *
+ * The client certificate, private key and root CA chains are loaded once and
+ * shared by all TLS contexts. The next TLS_Connect after credentials are
+ * provisioned through PKCS#11 loads them again by itself, so this is only
+ * needed to free the cached copies. Contexts that are still connected keep
+ * using the credentials they were established with.
+ */
+void TLS_CredentialCacheInvalidate( void );
+
+/**
+ * @brief Reports the heap used by a connection.
+ *
+ * @param pvContext Opaque context handle for TLS library.
+ * @param[out] pxReport Receives the report.
+ *
+ * @return Zero on success. Error return codes have the high bit set, which
+ * includes calling this before TLS_Connect succeeded.
+ */
+BaseType_t TLS_GetMemoryReport( void * pvContext,
+                                TLSMemoryReport_t * pxReport );
+
+/**
+ * @brief Copies the handshake counters.
+ *
+ * @param[out] pxStats Receives the counters.
+ */
+void TLS_GetStats( TLSStats_t * pxStats );
+
 #endif /* ifndef __AWS__TLS__H__ */
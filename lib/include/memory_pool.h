@@ -0,0 +1,318 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Memory pools allocate blocks of one fixed size from storage set aside when
+ * the pool is created.  Allocating and freeing a block only pushes it onto, or
+ * pops it from, a list of free blocks, so takes the same short time however
+ * many blocks the pool holds, cannot fragment the heap, and can be done from an
+ * interrupt.  A task that finds the pool empty can block until another task or
+ * an interrupt frees a block.
+ *
+ * The storage is used to hold the free list while a block is free, so a block
+ * is at least as large as a pointer, and the size passed to the create
+ * functions is rounded up to a multiple of portBYTE_ALIGNMENT.
+ */
+
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include memory_pool.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which memory pools are referenced.  For example, a call to
+ * xMemoryPoolCreate() returns a MemoryPoolHandle_t variable that can then be
+ * used as a parameter to pvMemoryPoolAlloc(), vMemoryPoolFree(), etc.
+ */
+typedef void * MemoryPoolHandle_t;
+
+/*
+ * The size of each block in a pool created with a block size of xBlockSize.
+ */
+#define poolBLOCK_SIZE( xBlockSize ) ( ( ( ( ( size_t ) ( xBlockSize ) < sizeof( void * ) ) ? sizeof( void * ) : ( size_t ) ( xBlockSize ) ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/*
+ * The number of bytes of storage that must be passed into
+ * xMemoryPoolCreateStatic() to hold uxBlockCount blocks of xBlockSize bytes.
+ */
+#define poolSTORAGE_SIZE( xBlockSize, uxBlockCount ) ( poolBLOCK_SIZE( xBlockSize ) * ( size_t ) ( uxBlockCount ) )
+
+/**
+ * memory_pool.h
+ *
+<pre>
+MemoryPoolHandle_t xMemoryPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount );
+</pre>
+ *
+ * Creates a new memory pool using dynamically allocated memory.  The pool
+ * structure and the blocks are allocated with a single call to pvPortMalloc().
+ * See xMemoryPoolCreateStatic() for a version that uses statically allocated
+ * memory (memory that is allocated at compile time).
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xMemoryPoolCreate() to be available.
+ *
+ * @param xBlockSize The number of bytes the caller needs in each block.  The
+ * size actually used is poolBLOCK_SIZE( xBlockSize ).
+ *
+ * @param uxBlockCount The number of blocks in the pool.  Must be at least 1.
+ *
+ * @return If the memory pool was created then its handle is returned.  If there
+ * was insufficient heap memory for the pool then NULL is returned.
+ *
+ * \defgroup xMemoryPoolCreate xMemoryPoolCreate
+ * \ingroup MemoryPoolManagement
+ */
+MemoryPoolHandle_t xMemoryPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ *
+<pre>
+MemoryPoolHandle_t xMemoryPoolCreateStatic( size_t xBlockSize,
+											UBaseType_t uxBlockCount,
+											uint8_t *pucPoolStorage,
+											StaticMemoryPool_t *pxStaticMemoryPool );
+</pre>
+ *
+ * Creates a new memory pool using statically allocated memory.  See
+ * xMemoryPoolCreate() for a version that uses dynamically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xMemoryPoolCreateStatic() to be available.
+ *
+ * @param xBlockSize The number of bytes the caller needs in each block.
+ *
+ * @param uxBlockCount The number of blocks in the pool.  Must be at least 1.
+ *
+ * @param pucPoolStorage Must point to an array of at least
+ * poolSTORAGE_SIZE( xBlockSize, uxBlockCount ) bytes, aligned to
+ * portBYTE_ALIGNMENT.  The blocks are allocated from this array.
+ *
+ * @param pxStaticMemoryPool Must point to a variable of type
+ * StaticMemoryPool_t, which will be used to hold the pool's data structure.
+ *
+ * @return If the memory pool is created successfully then a handle to the
+ * created pool is returned.  If either pucPoolStorage or pxStaticMemoryPool
+ * are NULL then NULL is returned.
+ *
+ * Example use:
+<pre>
+
+// Pool of 8 blocks, each large enough to hold a message.
+#define NUM_MESSAGES 8
+
+static uint8_t ucStorage[ poolSTORAGE_SIZE( sizeof( Message_t ), NUM_MESSAGES ) ];
+static StaticMemoryPool_t xPoolStruct;
+
+void MyFunction( void )
+{
+MemoryPoolHandle_t xMemoryPool;
+
+	xMemoryPool = xMemoryPoolCreateStatic( sizeof( Message_t ),
+										   NUM_MESSAGES,
+										   ucStorage,
+										   &xPoolStruct );
+
+	// As neither the pucPoolStorage or pxStaticMemoryPool parameters were
+	// NULL, xMemoryPool will not be NULL, and can be used to reference the
+	// created memory pool in other memory pool API calls.
+}
+
+</pre>
+ * \defgroup xMemoryPoolCreateStatic xMemoryPoolCreateStatic
+ * \ingroup MemoryPoolManagement
+ */
+MemoryPoolHandle_t xMemoryPoolCreateStatic( size_t xBlockSize,
+											UBaseType_t uxBlockCount,
+											uint8_t * const pucPoolStorage,
+											StaticMemoryPool_t * const pxStaticMemoryPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ *
+<pre>
+void vMemoryPoolDelete( MemoryPoolHandle_t xMemoryPool );
+</pre>
+ *
+ * Deletes a memory pool that was previously created using a call to
+ * xMemoryPoolCreate() or xMemoryPoolCreateStatic().  If the pool was created
+ * using dynamic memory then the memory is freed.  No task may be blocked on the
+ * pool, and no block allocated from the pool may be used, once it is deleted.
+ *
+ * @param xMemoryPool The handle of the memory pool to be deleted.
+ *
+ * \defgroup vMemoryPoolDelete vMemoryPoolDelete
+ * \ingroup MemoryPoolManagement
+ */
+void vMemoryPoolDelete( MemoryPoolHandle_t xMemoryPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ *
+<pre>
+void *pvMemoryPoolAlloc( MemoryPoolHandle_t xMemoryPool, TickType_t xTicksToWait );
+</pre>
+ *
+ * Allocates a block from a memory pool.  Use pvMemoryPoolAllocFromISR() to
+ * allocate a block from an interrupt service routine (ISR).
+ *
+ * @param xMemoryPool The handle of the pool from which the block is allocated.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for a block to be freed if the pool is empty.  The
+ * tick period constant portTICK_PERIOD_MS can be used to convert this to real
+ * time.  Setting xTicksToWait to portMAX_DELAY will cause the task to wait
+ * indefinitely (without timing out), provided INCLUDE_vTaskSuspend is set to 1
+ * in FreeRTOSConfig.h.  Must be 0 if the scheduler is suspended.
+ *
+ * @return A pointer to the allocated block, which is aligned to
+ * portBYTE_ALIGNMENT, or NULL if the pool remained empty for xTicksToWait
+ * ticks.
+ *
+ * \defgroup pvMemoryPoolAlloc pvMemoryPoolAlloc
+ * \ingroup MemoryPoolManagement
+ */
+void *pvMemoryPoolAlloc( MemoryPoolHandle_t xMemoryPool, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ *
+<pre>
+void *pvMemoryPoolAllocFromISR( MemoryPoolHandle_t xMemoryPool );
+</pre>
+ *
+ * A version of pvMemoryPoolAlloc() that can be called from an interrupt
+ * service routine (ISR).  It never blocks.
+ *
+ * @param xMemoryPool The handle of the pool from which the block is allocated.
+ *
+ * @return A pointer to the allocated block, or NULL if the pool was empty.
+ *
+ * \defgroup pvMemoryPoolAllocFromISR pvMemoryPoolAllocFromISR
+ * \ingroup MemoryPoolManagement
+ */
+void *pvMemoryPoolAllocFromISR( MemoryPoolHandle_t xMemoryPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ *
+<pre>
+void vMemoryPoolFree( MemoryPoolHandle_t xMemoryPool, void *pvBlock );
+</pre>
+ *
+ * Returns a block to the memory pool it was allocated from, unblocking the
+ * highest priority task that is waiting for a block, if any.  Use
+ * vMemoryPoolFreeFromISR() to free a block from an interrupt service routine
+ * (ISR).
+ *
+ * @param xMemoryPool The handle of the pool from which the block was allocated.
+ *
+ * @param pvBlock The block, as returned by pvMemoryPoolAlloc() or
+ * pvMemoryPoolAllocFromISR().
+ *
+ * \defgroup vMemoryPoolFree vMemoryPoolFree
+ * \ingroup MemoryPoolManagement
+ */
+void vMemoryPoolFree( MemoryPoolHandle_t xMemoryPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ *
+<pre>
+void vMemoryPoolFreeFromISR( MemoryPoolHandle_t xMemoryPool,
+							 void *pvBlock,
+							 BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of vMemoryPoolFree() that can be called from an interrupt service
+ * routine (ISR).
+ *
+ * @param xMemoryPool The handle of the pool from which the block was allocated.
+ *
+ * @param pvBlock The block being freed.
+ *
+ * @param pxHigherPriorityTaskWoken *pxHigherPriorityTaskWoken is set to pdTRUE
+ * if freeing the block unblocked a task that has a priority above the priority
+ * of the currently running task.  If vMemoryPoolFreeFromISR() sets this value
+ * to pdTRUE then a context switch should be requested before the interrupt is
+ * exited.  pxHigherPriorityTaskWoken is optional and can be set to NULL.
+ *
+ * \defgroup vMemoryPoolFreeFromISR vMemoryPoolFreeFromISR
+ * \ingroup MemoryPoolManagement
+ */
+void vMemoryPoolFreeFromISR( MemoryPoolHandle_t xMemoryPool,
+							 void *pvBlock,
+							 BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ *
+<pre>
+UBaseType_t uxMemoryPoolGetFreeBlocks( MemoryPoolHandle_t xMemoryPool );
+</pre>
+ *
+ * @param xMemoryPool The handle of the pool being queried.
+ *
+ * @return The number of blocks that are currently free in the pool.
+ *
+ * \defgroup uxMemoryPoolGetFreeBlocks uxMemoryPoolGetFreeBlocks
+ * \ingroup MemoryPoolManagement
+ */
+UBaseType_t uxMemoryPoolGetFreeBlocks( MemoryPoolHandle_t xMemoryPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ *
+<pre>
+UBaseType_t uxMemoryPoolGetMinimumEverFreeBlocks( MemoryPoolHandle_t xMemoryPool );
+</pre>
+ *
+ * Returns the high water mark of the pool, which can be used to size the pool
+ * to the application's actual needs.
+ *
+ * @param xMemoryPool The handle of the pool being queried.
+ *
+ * @return The smallest number of blocks that have been free in the pool since
+ * it was created.
+ *
+ * \defgroup uxMemoryPoolGetMinimumEverFreeBlocks uxMemoryPoolGetMinimumEverFreeBlocks
+ * \ingroup MemoryPoolManagement
+ */
+UBaseType_t uxMemoryPoolGetMinimumEverFreeBlocks( MemoryPoolHandle_t xMemoryPool ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( MEMORY_POOL_H ) */
@@ -25,14 +25,25 @@
 #ifndef AWS_DEFENDER_REPORT_H /* Guards against multiple inclusion */
 #define AWS_DEFENDER_REPORT_H
 
-#include "aws_cbor.h"
+#include "aws_cbor_writer.h"
 #include "aws_defender_report_utils.h"
 
 #define DEFENDER_HEADER_TAG     DEFENDER_SelectTag( "header", "hed" )
 #define DEFENDER_METRICS_TAG    DEFENDER_SelectTag( "metrics", "met" )
 #define DEFENDER_TOTAL_TAG      DEFENDER_SelectTag( "total", "t" )
 
-CBORHandle_t CreateReport( void );
+/**
+ * @brief Encodes the header and every metric into a buffer
+ * @param[out] pucBuffer Buffer the report is encoded into
+ * @param[in] xBufferSize Size of pucBuffer in bytes
+ * @param[out] plReportLength Number of bytes in the encoded report
+ * @return pucBuffer, NULL if the report did not fit in it
+ * @note The metrics are updated as they are written, so reports must not be
+ * created from more than one task at a time
+ */
+uint8_t const * CreateReport( uint8_t * pucBuffer,
+                              size_t xBufferSize,
+                              int32_t * plReportLength );
 
 #endif /* ifndef AWS_DEFENDER_REPORT_H */
 
@@ -25,8 +25,8 @@
 #ifndef AWS_DEFENDER_REPORT_CPU_H /* Guards against multiple inclusion */
 #define AWS_DEFENDER_REPORT_CPU_H
 
-#include "aws_cbor.h"
+#include "aws_cbor_writer.h"
 
-CBORHandle_t CpuReportGet( void );
+void CpuReportGet( CborWriter_t * pxWriter );
 
 #endif /* ifndef AWS_DEFENDER_CPU_H */
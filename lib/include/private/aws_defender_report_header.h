@@ -25,7 +25,7 @@
 #ifndef AWS_DEFENDER_HEADER_H
 #define AWS_DEFENDER_HEADER_H
 
-#include "aws_cbor.h"
+#include "aws_cbor_writer.h"
 #include "aws_defender_report_utils.h"
 
 extern const char * DEFENDER_METRICS_VERSION;
@@ -33,6 +33,6 @@ extern const char * DEFENDER_METRICS_VERSION;
 #define DEFENDER_REPORT_ID_TAG    DEFENDER_SelectTag( "report_id", "rid" )
 #define DEFENDER_VERSION_TAG      DEFENDER_SelectTag( "version", "v" )
 
-CBORHandle_t GetHeader( void );
+void WriteHeader( CborWriter_t * pxWriter );
 
 #endif /* end of include guard: AWS_DEFENDER_HEADER_H */
@@ -25,13 +25,13 @@
 #ifndef AWS_DEFENDER_REPORT_TCP_CONN_H
 #define AWS_DEFENDER_REPORT_TCP_CONN_H
 
-#include "aws_cbor.h"
+#include "aws_cbor_writer.h"
 #include "aws_defender_report_utils.h"
 
 #define DEFENDER_TCP_CONN_TAG    DEFENDER_SelectTag( "tcp_connections", "tc" )
 #define DEFENDER_EST_CONN_TAG \
     DEFENDER_SelectTag( "established_connections", "ec" )
 
-CBORHandle_t TcpConnReportGet( void );
+void TcpConnReportGet( CborWriter_t * pxWriter );
 
 #endif /* end of include guard: AWS_DEFENDER_REPORT_TCP_CONN_H */
@@ -25,10 +25,12 @@
 #ifndef AWS_REPORT_TYPES_H
 #define AWS_REPORT_TYPES_H
 
-#include "aws_cbor.h"
+#include "aws_cbor_writer.h"
 
 typedef void (* UpdateMetric_t)( void );
-typedef CBORHandle_t (* ReportMetric_t)( void );
+
+/* Writes the metric's key/value pairs into the open metrics map */
+typedef void (* ReportMetric_t)( CborWriter_t * );
 
 struct DefenderMetric_s
 {
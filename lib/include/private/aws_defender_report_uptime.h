@@ -25,8 +25,8 @@
 #ifndef AWS_DEFENDER_REPORT_UPTIME_H
 #define AWS_DEFENDER_REPORT_UPTIME_H
 
-#include "aws_cbor.h"
+#include "aws_cbor_writer.h"
 
-CBORHandle_t UptimeReportGet( void );
+void UptimeReportGet( CborWriter_t * pxWriter );
 
 #endif /* end of include guard: AWS_DEFENDER_UPTIME_H */
@@ -77,6 +77,72 @@
     #define ggdconfigJSON_MAX_TOKENS    ( 128 )        /* Size of the array used by jsmn to store the tokens. */
 #endif
 
+/**
+ * @brief Size of the buffer through which the discovery HTTP response is read.
+ *
+ * Only one discovery request can be in progress at a time, so there is only
+ * one such buffer.
+ */
+#ifndef ggdconfigHTTP_READ_BUFFER_SIZE
+    #define ggdconfigHTTP_READ_BUFFER_SIZE    ( 512 )
+#endif
+
+/**
+ * @brief Maximum number of connectivity entries kept for the selected core
+ * when the discovery response is parsed as it is received.
+ */
+#ifndef ggdconfigMAX_CORE_ENDPOINTS
+    #define ggdconfigMAX_CORE_ENDPOINTS    ( 8 )
+#endif
+
+/**
+ * @brief Time in seconds for which the result of a discovery is reused.
+ *
+ * While the result is valid, GGD_GetGGCIPandCertificate() connects to the
+ * cached addresses without sending a new discovery request. Set to 0 to
+ * always send a discovery request. The period in ticks must fit in a
+ * TickType_t.
+ */
+#ifndef ggdconfigCACHE_VALIDITY_S
+    #define ggdconfigCACHE_VALIDITY_S    ( 3600 )
+#endif
+
+/**
+ * @brief Maximum number of connection attempts to the core in progress at
+ * the same time.
+ *
+ * Each attempt runs in its own task and may hold a TLS context, so this
+ * bounds the RAM used while probing. Set to 1 to try the addresses one after
+ * the other in the calling task.
+ */
+#ifndef ggdconfigPROBE_MAX_PARALLEL
+    #define ggdconfigPROBE_MAX_PARALLEL    ( 3 )
+#endif
+
+/**
+ * @brief Time in milliseconds between the start of two connection attempts
+ * to the core.
+ */
+#ifndef ggdconfigPROBE_STAGGER_MS
+    #define ggdconfigPROBE_STAGGER_MS    ( 250 )
+#endif
+
+/**
+ * @brief Stack size of the tasks that attempt the connections to the core.
+ *
+ * The TLS handshake runs on this stack.
+ */
+#ifndef ggdconfigPROBE_TASK_STACK_SIZE
+    #define ggdconfigPROBE_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 16 )
+#endif
+
+/**
+ * @brief Priority of the tasks that attempt the connections to the core.
+ */
+#ifndef ggdconfigPROBE_TASK_PRIORITY
+    #define ggdconfigPROBE_TASK_PRIORITY    ( tskIDLE_PRIORITY )
+#endif
+
 #ifndef ggdconfigPRINT
     #define ggdconfigPRINT    vLoggingPrintf
 #endif
@@ -54,6 +54,44 @@ BaseType_t GGD_SecureConnect_Connect( const GGD_HostAddressData_t * pxHostAddres
                                       uint32_t ulReceiveTimeOut,
                                       uint32_t ulSendTimeOut );
 
+/*
+ * @brief Start a secure connection to the first of several hosts that
+ * answers.
+ *
+ * Up to ggdconfigPROBE_MAX_PARALLEL connection attempts are run at the same
+ * time, each started ggdconfigPROBE_STAGGER_MS after the previous one, in
+ * the order of pxHostAddressData. The first attempt to complete the TLS
+ * handshake wins. Attempts that have not started yet are cancelled. The ones
+ * still in progress are shut down, which makes them fail, close their socket
+ * and free its TLS context in the background. An attempt still waiting for
+ * its TCP connection is shut down once it is connected.
+ *
+ * @note The host addresses and certificate are copied, so pxHostAddressData
+ * can be freed as soon as this function returns.
+ *
+ * @param [in] pxHostAddressData : Array of the hosts to try.
+ *
+ * @param [in] ulHostAddressCount : Number of entries in pxHostAddressData.
+ *
+ * @param [out] pxSocket : Returned socket, connected to the winning host.
+ *
+ * @param [out] pulConnectedIndex : Index in pxHostAddressData of the winning
+ * host.
+ *
+ * @param [in] ulReceiveTimeOut : Receive Timeout in millisecond.
+ *
+ * @param [in] ulSendTimeOut : Send Timeout in millisecond
+ *
+ * @return If a connection was successful then pdPASS is
+ * returned.  Otherwise pdFAIL is returned.
+ */
+BaseType_t GGD_SecureConnect_ConnectFirst( const GGD_HostAddressData_t * pxHostAddressData,
+                                           const uint32_t ulHostAddressCount,
+                                           Socket_t * pxSocket,
+                                           uint32_t * pulConnectedIndex,
+                                           uint32_t ulReceiveTimeOut,
+                                           uint32_t ulSendTimeOut );
+
 /*
  * @briefstop a secure connection with host.
  *
@@ -61,4 +61,35 @@
     #define socketsconfigDEFAULT_RECV_TIMEOUT    ( 10000 )
 #endif
 
+/**
+ * @brief Number of random bytes fetched from the crypto library at a time.
+ *
+ * Ports that buffer random numbers hand them out from a pool of this size,
+ * so that the random number generator only runs once per pool. Must be a
+ * multiple of 4.
+ */
+#ifndef socketsconfigRANDOM_POOL_SIZE
+    #define socketsconfigRANDOM_POOL_SIZE    ( 64 )
+#endif
+
+/**
+ * @brief Number of random pool refills after which the generator is reseeded.
+ */
+#ifndef socketsconfigRANDOM_RESEED_INTERVAL
+    #define socketsconfigRANDOM_RESEED_INTERVAL    ( 1024 )
+#endif
+
+/**
+ * @brief Longest time, in milliseconds, that the random number and sequence
+ * number helpers wait for the shared crypto session.
+ *
+ * These helpers are called from the IP-task, which must not block behind a
+ * long crypto operation of another task. If the session is not available in
+ * time, they fail and return 0, which FreeRTOS+TCP already handles as a failed
+ * random number.
+ */
+#ifndef socketsconfigCRYPTO_SESSION_WAIT_MS
+    #define socketsconfigCRYPTO_SESSION_WAIT_MS    ( 10 )
+#endif
+
 #endif /* AWS_INC_SECURE_SOCKETS_CONFIG_DEFAULTS_H_ */
@@ -0,0 +1,403 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Stackless tasks are functions that are run by an executor task.  Many
+ * stackless tasks share the executor's stack, so a protocol client that spends
+ * most of its time waiting for a message, a notification or a timeout can be
+ * written as a stackless task for the cost of a StacklessTask_t, rather than a
+ * task control block and a stack of its own.
+ *
+ * A stackless task is written as a function that starts with stacklessBEGIN()
+ * and ends with stacklessEND().  When the function waits, using one of the
+ * stacklessAWAIT_...() macros, stacklessDELAY() or stacklessYIELD(), it records
+ * where it got to and returns to the executor, which calls it again when the
+ * wait is over and it continues from the same point.  As the function returns
+ * while it waits:
+ *
+ * + Local variables do not keep their values across a wait.  State that must
+ *   be kept should be held in the structure passed as the pvParameter value.
+ * + The wait macros can only be used in the stackless task function itself, not
+ *   in functions it calls, and not in a switch statement.
+ * + Only one wait macro can be used on each line of source code.
+ * + A stackless task must never call an API function that blocks, as that would
+ *   stop all the other stackless tasks run by the same executor.
+ *
+ * Other tasks and interrupts wake stackless tasks by notifying them with
+ * xStacklessNotify() or xStacklessNotifyFromISR(), or by writing to a queue or
+ * giving a semaphore that has been added to the executor with
+ * xExecutorAddQueue().  The latter requires configUSE_QUEUE_SETS to be set to 1
+ * in FreeRTOSConfig.h, and is also the way stackless tasks wait for
+ * FreeRTOS+TCP sockets - see stacklessAWAIT_SOCKET().
+ */
+
+#ifndef STACKLESS_H
+#define STACKLESS_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include stackless.h"
+#endif
+
+#include "task.h"
+#include "queue.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which executors are referenced.  For example, a call to
+ * xExecutorCreate() returns an ExecutorHandle_t variable that can then be used
+ * as a parameter to vExecutorStartStacklessTask(), xExecutorAddQueue(), etc.
+ */
+typedef void * ExecutorHandle_t;
+
+struct xSTACKLESS_TASK;
+
+/*
+ * Defines the prototype to which stackless task functions must conform.
+ */
+typedef void (*StacklessTaskFunction_t)( struct xSTACKLESS_TASK *pxStacklessTask, void *pvParameter );
+
+/*
+ * A stackless task.  The structure is allocated by the application, usually as
+ * part of the session or other object the stackless task runs for, and its
+ * members are only accessed through the API functions and macros below.
+ */
+typedef struct xSTACKLESS_TASK
+{
+	ListItem_t xStateListItem;						/*< Used to reference the stackless task from the executor's ready or delayed list.  The item value is the time at which a wait times out. */
+	ListItem_t xEventListItem;						/*< Used to reference the stackless task from the executor's list of stackless tasks waiting for a queue or semaphore. */
+	struct xSTACKLESS_TASK * volatile pxNextSignalled;	/*< The next stackless task that was notified or started since the executor last checked. */
+	StacklessTaskFunction_t pxFunction;				/*< The stackless task function. */
+	void *pvParameter;								/*< The parameter passed into pxFunction. */
+	void *pvExecutor;								/*< The executor that runs the stackless task. */
+	void *pvWaitObject;								/*< The queue or semaphore the stackless task is waiting for, the stackless task itself if it is waiting for a notification, or NULL. */
+	TimeOut_t xTimeOut;								/*< The time at which the current wait started. */
+	TickType_t xTicksToWait;						/*< The time remaining before the current wait times out. */
+	volatile uint32_t ulNotifiedValue;				/*< The bits set by xStacklessNotify() that have not yet been received. */
+	UBaseType_t uxResumePoint;						/*< The point from which the stackless task function continues when it is next called. */
+	volatile uint8_t ucSignalled;					/*< pdTRUE while the stackless task is on the executor's list of notified stackless tasks. */
+	uint8_t ucState;								/*< One of the stacklessSTATE_... values below. */
+	uint8_t ucWaitFlags;							/*< The stacklessWAIT_... flags below. */
+} StacklessTask_t;
+
+/* Values for ucState.  For internal use only. */
+#define stacklessSTATE_NOT_STARTED		( ( uint8_t ) 0 )
+#define stacklessSTATE_STARTING			( ( uint8_t ) 1 )
+#define stacklessSTATE_READY			( ( uint8_t ) 2 )
+#define stacklessSTATE_WAITING			( ( uint8_t ) 3 )
+#define stacklessSTATE_FINISHED			( ( uint8_t ) 4 )
+
+/* Values for uxResumePoint that are not line numbers.  For internal use
+only. */
+#define stacklessRESUME_POINT_START		( ( UBaseType_t ) 0 )
+#define stacklessRESUME_POINT_END		( ~( ( UBaseType_t ) 0 ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Marks the start of a stackless task function.  Must be the first statement of
+ * the function.
+ */
+#define stacklessBEGIN( pxStacklessTask ) switch( ( pxStacklessTask )->uxResumePoint ) { case stacklessRESUME_POINT_START:
+
+/*
+ * Marks the end of a stackless task function.  Must be the last statement of
+ * the function.  A stackless task that reaches stacklessEND() has finished, and
+ * will not be run again unless it is restarted with
+ * vExecutorStartStacklessTask().
+ */
+#define stacklessEND( pxStacklessTask ) default: break; } ( pxStacklessTask )->uxResumePoint = stacklessRESUME_POINT_END
+
+/*
+ * Records the point from which the stackless task continues, and returns to the
+ * executor.  For internal use only.
+ */
+#define stacklessSET_RESUME_POINT( pxStacklessTask ) ( pxStacklessTask )->uxResumePoint = ( UBaseType_t ) __LINE__; return; case __LINE__:
+
+/*
+ * Returns to the executor, which runs any other stackless tasks that are ready
+ * before continuing this one.
+ */
+#define stacklessYIELD( pxStacklessTask ) do { stacklessSET_RESUME_POINT( pxStacklessTask ) } while( 0 )
+
+/*
+ * Waits until xCondition is true, re-evaluating it each time the stackless task
+ * is woken, for at most xTicksToWait ticks.  pvObject is the queue or semaphore
+ * whose activity could make xCondition true, the stackless task itself if a
+ * notification could make it true, or NULL.  If xCondition is still false when
+ * the time is up the stackless task continues anyway, so xCondition must be
+ * tested again, or have a side effect that records the result, as in the macros
+ * below.  xTicksToWait can be portMAX_DELAY to wait without a timeout, provided
+ * INCLUDE_vTaskSuspend is set to 1 in FreeRTOSConfig.h.
+ */
+#define stacklessWAIT_UNTIL( pxStacklessTask, xCondition, pvObject, xTicksToWait )																\
+	while( xStacklessWait( ( pxStacklessTask ), ( ( xCondition ) ? pdTRUE : pdFALSE ), ( void * ) ( pvObject ), ( xTicksToWait ) ) != pdFALSE )	\
+	{																																			\
+		stacklessSET_RESUME_POINT( pxStacklessTask )																							\
+	}
+
+/*
+ * Waits for xTicksToDelay ticks.  The executor runs other stackless tasks, or
+ * blocks, in the meantime.
+ */
+#define stacklessDELAY( pxStacklessTask, xTicksToDelay ) stacklessWAIT_UNTIL( ( pxStacklessTask ), pdFALSE, NULL, ( xTicksToDelay ) )
+
+/*
+ * Waits for the stackless task to be notified with xStacklessNotify() or
+ * xStacklessNotifyFromISR(), for at most xTicksToWait ticks.  On return
+ * *pulNotifiedValue holds the bits set by all the notifications received since
+ * the stackless task last waited, which are then cleared, or 0 if the wait
+ * timed out.
+ */
+#define stacklessAWAIT_NOTIFY( pxStacklessTask, xTicksToWait, pulNotifiedValue )							\
+	stacklessWAIT_UNTIL( ( pxStacklessTask ),																\
+						 ( ( *( pulNotifiedValue ) = ulStacklessNotifyTake( pxStacklessTask ) ) != 0UL ),	\
+						 ( pxStacklessTask ),																\
+						 ( xTicksToWait ) )
+
+/*
+ * Receives an item from xQueue, which must have been added to the executor with
+ * xExecutorAddQueue(), waiting for at most xTicksToWait ticks if the queue is
+ * empty.  *pxResult is set to pdPASS if an item was received into pvBuffer, or
+ * errQUEUE_EMPTY if the wait timed out.
+ */
+#define stacklessAWAIT_QUEUE_RECEIVE( pxStacklessTask, xQueue, pvBuffer, xTicksToWait, pxResult )			\
+	stacklessWAIT_UNTIL( ( pxStacklessTask ),																\
+						 ( ( *( pxResult ) = xQueueReceive( ( xQueue ), ( pvBuffer ), 0 ) ) != pdFALSE ),	\
+						 ( xQueue ),																		\
+						 ( xTicksToWait ) )
+
+/*
+ * Takes xSemaphore, which must have been added to the executor with
+ * xExecutorAddQueue(), waiting for at most xTicksToWait ticks if it is not
+ * available.  *pxResult is set to pdPASS if the semaphore was taken, or pdFAIL
+ * if the wait timed out.
+ */
+#define stacklessAWAIT_SEMAPHORE( pxStacklessTask, xSemaphore, xTicksToWait, pxResult )					\
+	stacklessWAIT_UNTIL( ( pxStacklessTask ),															\
+						 ( ( *( pxResult ) = xQueueSemaphoreTake( ( xSemaphore ), 0 ) ) != pdFALSE ),	\
+						 ( xSemaphore ),																\
+						 ( xTicksToWait ) )
+
+/*
+ * Waits until xCondition is true for a FreeRTOS+TCP socket, for example
+ * FreeRTOS_recvcount( xSocket ) > 0, for at most xTicksToWait ticks.
+ * xSemaphore must be a binary semaphore that has been added to the executor
+ * with xExecutorAddQueue(), and set on the socket using the
+ * FREERTOS_SO_SET_SEMAPHORE socket option, so that the IP task gives it each
+ * time there is an event on the socket.  That requires
+ * ipconfigSOCKET_HAS_USER_SEMAPHORE to be set to 1 in FreeRTOSIPConfig.h.  As
+ * with stacklessWAIT_UNTIL(), xCondition must be tested again once the macro
+ * completes.
+ */
+#define stacklessAWAIT_SOCKET( pxStacklessTask, xSemaphore, xCondition, xTicksToWait )			\
+	stacklessWAIT_UNTIL( ( pxStacklessTask ),													\
+						 ( ( void ) xQueueSemaphoreTake( ( xSemaphore ), 0 ), ( xCondition ) ),	\
+						 ( xSemaphore ),														\
+						 ( xTicksToWait ) )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * stackless.h
+ *
+<pre>
+ExecutorHandle_t xExecutorCreate( const char * const pcName,
+								  configSTACK_DEPTH_TYPE usStackDepth,
+								  UBaseType_t uxPriority,
+								  UBaseType_t uxQueueSetLength );
+</pre>
+ *
+ * Creates a new executor, and the task that runs its stackless tasks, using
+ * dynamically allocated memory.  stackless.c can only be built with
+ * configSUPPORT_DYNAMIC_ALLOCATION set to 1 or left undefined in
+ * FreeRTOSConfig.h.
+ *
+ * @param pcName The name given to the executor task.
+ *
+ * @param usStackDepth The size of the executor task's stack, specified as for
+ * xTaskCreate().  The stack must be large enough for the deepest call made by
+ * any of the stackless tasks.
+ *
+ * @param uxPriority The priority at which the executor task runs.
+ *
+ * @param uxQueueSetLength 0 if no queues or semaphores will be added to the
+ * executor.  Otherwise the sum of the lengths of all the queues and semaphores
+ * that will be added, as for xQueueCreateSet().  Must be 0 if
+ * configUSE_QUEUE_SETS is not set to 1.
+ *
+ * @return If the executor was created then its handle is returned.  If there
+ * was insufficient heap memory then NULL is returned.
+ *
+ * \defgroup xExecutorCreate xExecutorCreate
+ * \ingroup StacklessTaskManagement
+ */
+ExecutorHandle_t xExecutorCreate( const char * const pcName,
+								  configSTACK_DEPTH_TYPE usStackDepth,
+								  UBaseType_t uxPriority,
+								  UBaseType_t uxQueueSetLength ) PRIVILEGED_FUNCTION;
+
+/**
+ * stackless.h
+ *
+<pre>
+void vExecutorDelete( ExecutorHandle_t xExecutor );
+</pre>
+ *
+ * Deletes an executor.  Its stackless tasks are not run again, and any queues
+ * or semaphores added to it must have been removed with xExecutorRemoveQueue().
+ * The executor task frees the executor and deletes itself once the stackless
+ * task it is running, if any, returns, so vExecutorDelete() can be called from
+ * a stackless task.
+ *
+ * @param xExecutor The handle of the executor to delete.
+ *
+ * \defgroup vExecutorDelete vExecutorDelete
+ * \ingroup StacklessTaskManagement
+ */
+void vExecutorDelete( ExecutorHandle_t xExecutor ) PRIVILEGED_FUNCTION;
+
+/**
+ * stackless.h
+ *
+<pre>
+void vExecutorStartStacklessTask( ExecutorHandle_t xExecutor,
+								  StacklessTask_t *pxStacklessTask,
+								  StacklessTaskFunction_t pxFunction,
+								  void *pvParameter );
+</pre>
+ *
+ * Starts a stackless task.  The stackless task first runs when the executor
+ * next checks for work.  A stackless task can be started again once it has
+ * finished, but must not be started while it is running.
+ *
+ * @param xExecutor The executor that runs the stackless task.
+ *
+ * @param pxStacklessTask The stackless task, which must stay allocated until it
+ * has finished, or the executor is deleted.
+ *
+ * @param pxFunction The stackless task function.
+ *
+ * @param pvParameter The value passed into pxFunction each time it is called.
+ *
+ * \defgroup vExecutorStartStacklessTask vExecutorStartStacklessTask
+ * \ingroup StacklessTaskManagement
+ */
+void vExecutorStartStacklessTask( ExecutorHandle_t xExecutor,
+								  StacklessTask_t *pxStacklessTask,
+								  StacklessTaskFunction_t pxFunction,
+								  void *pvParameter ) PRIVILEGED_FUNCTION;
+
+/**
+ * stackless.h
+ *
+<pre>
+BaseType_t xExecutorAddQueue( ExecutorHandle_t xExecutor, QueueSetMemberHandle_t xQueueOrSemaphore );
+BaseType_t xExecutorRemoveQueue( ExecutorHandle_t xExecutor, QueueSetMemberHandle_t xQueueOrSemaphore );
+</pre>
+ *
+ * Adds a queue or semaphore to, or removes it from, the set the executor task
+ * blocks on, so stackless tasks can wait for it with
+ * stacklessAWAIT_QUEUE_RECEIVE(), stacklessAWAIT_SEMAPHORE() or
+ * stacklessAWAIT_SOCKET().  The same restrictions apply as to xQueueAddToSet()
+ * and xQueueRemoveFromSet(), so the queue or semaphore must be empty, and must
+ * only be read by the stackless tasks of this executor.  Only available when
+ * configUSE_QUEUE_SETS is set to 1.
+ *
+ * @return pdPASS if the queue or semaphore was added or removed, otherwise
+ * pdFAIL.  Adding fails if the lengths of the queues and semaphores added to
+ * the executor would then come to more than its uxQueueSetLength.
+ *
+ * \defgroup xExecutorAddQueue xExecutorAddQueue
+ * \ingroup StacklessTaskManagement
+ */
+#if( configUSE_QUEUE_SETS == 1 )
+	BaseType_t xExecutorAddQueue( ExecutorHandle_t xExecutor, QueueSetMemberHandle_t xQueueOrSemaphore ) PRIVILEGED_FUNCTION;
+	BaseType_t xExecutorRemoveQueue( ExecutorHandle_t xExecutor, QueueSetMemberHandle_t xQueueOrSemaphore ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * stackless.h
+ *
+<pre>
+BaseType_t xStacklessNotify( StacklessTask_t *pxStacklessTask, uint32_t ulBitsToSet );
+</pre>
+ *
+ * Sets bits in the stackless task's notification value, and wakes the stackless
+ * task if it is waiting in stacklessAWAIT_NOTIFY().  Can be called from tasks,
+ * including the executor's own stackless tasks.  Use xStacklessNotifyFromISR()
+ * to notify a stackless task from an interrupt service routine (ISR).
+ *
+ * @param pxStacklessTask The stackless task being notified.
+ *
+ * @param ulBitsToSet The bits to set in the notification value.  Must not be
+ * 0.
+ *
+ * @return pdTRUE if the executor had to be woken, otherwise pdFALSE.
+ *
+ * \defgroup xStacklessNotify xStacklessNotify
+ * \ingroup StacklessTaskManagement
+ */
+BaseType_t xStacklessNotify( StacklessTask_t *pxStacklessTask, uint32_t ulBitsToSet ) PRIVILEGED_FUNCTION;
+
+/**
+ * stackless.h
+ *
+<pre>
+BaseType_t xStacklessNotifyFromISR( StacklessTask_t *pxStacklessTask,
+									uint32_t ulBitsToSet,
+									BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of xStacklessNotify() that can be called from an interrupt service
+ * routine (ISR).
+ *
+ * @param pxHigherPriorityTaskWoken *pxHigherPriorityTaskWoken is set to pdTRUE
+ * if waking the executor task unblocked a task that has a priority above the
+ * priority of the currently running task, in which case a context switch
+ * should be requested before the interrupt is exited.
+ *
+ * \defgroup xStacklessNotifyFromISR xStacklessNotifyFromISR
+ * \ingroup StacklessTaskManagement
+ */
+BaseType_t xStacklessNotifyFromISR( StacklessTask_t *pxStacklessTask,
+									uint32_t ulBitsToSet,
+									BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Used by the macros above.  Not to be called directly.
+ */
+BaseType_t xStacklessWait( StacklessTask_t *pxStacklessTask, BaseType_t xReady, void *pvObject, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+uint32_t ulStacklessNotifyTake( StacklessTask_t *pxStacklessTask ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( STACKLESS_H ) */
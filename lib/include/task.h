@@ -153,6 +153,25 @@ typedef enum
  */
 #define tskIDLE_PRIORITY			( ( UBaseType_t ) 0U )
 
+/**
+ * The index of the notification value used by the task notification API
+ * functions that do not take an index, such as xTaskNotify() and
+ * ulTaskNotifyTake().  Libraries that use notifications internally should use
+ * a different index so they do not consume notifications meant for the
+ * application.
+ *
+ * \ingroup TaskNotifications
+ */
+#define tskDEFAULT_INDEX_TO_NOTIFY	( 0 )
+
+/**
+ * The core affinity mask that allows a task to run on any core.  This is the
+ * affinity of a task when it is created.
+ *
+ * \ingroup Tasks
+ */
+#define tskNO_AFFINITY				( ( UBaseType_t ) -1 )
+
 /**
  * task. h
  *
@@ -176,7 +195,11 @@ typedef enum
  * \ingroup SchedulerControl
  */
 #define taskENTER_CRITICAL()		portENTER_CRITICAL()
-#define taskENTER_CRITICAL_FROM_ISR() portSET_INTERRUPT_MASK_FROM_ISR()
+#if ( configNUM_CORES > 1 )
+	#define taskENTER_CRITICAL_FROM_ISR() uxTaskEnterCriticalFromISR()
+#else
+	#define taskENTER_CRITICAL_FROM_ISR() portSET_INTERRUPT_MASK_FROM_ISR()
+#endif
 
 /**
  * task. h
@@ -191,7 +214,11 @@ typedef enum
  * \ingroup SchedulerControl
  */
 #define taskEXIT_CRITICAL()			portEXIT_CRITICAL()
-#define taskEXIT_CRITICAL_FROM_ISR( x ) portCLEAR_INTERRUPT_MASK_FROM_ISR( x )
+#if ( configNUM_CORES > 1 )
+	#define taskEXIT_CRITICAL_FROM_ISR( x ) vTaskExitCriticalFromISR( x )
+#else
+	#define taskEXIT_CRITICAL_FROM_ISR( x ) portCLEAR_INTERRUPT_MASK_FROM_ISR( x )
+#endif
 /**
  * task. h
  *
@@ -1003,6 +1030,63 @@ void vTaskGetInfo( TaskHandle_t xTask, TaskStatus_t *pxTaskStatus, BaseType_t xG
  */
 void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>void vTaskCoreAffinitySet( TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask );</pre>
+ *
+ * Only available when configNUM_CORES is greater than 1.
+ *
+ * Set the cores a task is allowed to run on.  Bit n of the mask is set if the
+ * task can run on core n.  Tasks are created with an affinity of
+ * tskNO_AFFINITY, which allows them to run on any core.
+ *
+ * If the task is running on a core that is no longer in its affinity mask
+ * then that core is made to select another task, and the task moves to one of
+ * the cores it is allowed to run on.
+ *
+ * @param xTask Handle to the task for which the affinity is being set.
+ * Passing a NULL handle results in the affinity of the calling task being set.
+ *
+ * @param uxCoreAffinityMask The cores the task is allowed to run on.  At least
+ * one of the bits for the cores 0 to configNUM_CORES - 1 must be set.
+ *
+ * Example usage:
+   <pre>
+ void vAFunction( void )
+ {
+ TaskHandle_t xHandle;
+
+	 // Create a task, storing the handle.
+	 xTaskCreate( vTaskCode, "NAME", STACK_SIZE, NULL, tskIDLE_PRIORITY, &xHandle );
+
+	 // Only allow the task to run on core 1.
+	 vTaskCoreAffinitySet( xHandle, ( 1 << 1 ) );
+ }
+   </pre>
+ * \defgroup vTaskCoreAffinitySet vTaskCoreAffinitySet
+ * \ingroup TaskCtrl
+ */
+void vTaskCoreAffinitySet( TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskCoreAffinityGet( TaskHandle_t xTask );</pre>
+ *
+ * Only available when configNUM_CORES is greater than 1.
+ *
+ * Obtain the cores a task is allowed to run on, as set by
+ * vTaskCoreAffinitySet().
+ *
+ * @param xTask Handle of the task to be queried.  Passing a NULL
+ * handle results in the affinity of the calling task being returned.
+ *
+ * @return The affinity mask of xTask.
+ *
+ * \defgroup uxTaskCoreAffinityGet uxTaskCoreAffinityGet
+ * \ingroup TaskCtrl
+ */
+UBaseType_t uxTaskCoreAffinityGet( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <pre>void vTaskSuspend( TaskHandle_t xTaskToSuspend );</pre>
@@ -1716,12 +1800,20 @@ void vTaskGetRunTimeStats( char *pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e9
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction );</PRE>
+ * <PRE>BaseType_t xTaskNotifyIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction );</PRE>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
  * function to be available.
  *
- * When configUSE_TASK_NOTIFICATIONS is set to one each task has its own private
- * "notification value", which is a 32-bit unsigned integer (uint32_t).
+ * When configUSE_TASK_NOTIFICATIONS is set to one each task has an array of
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES private "notification values", each of
+ * which is a 32-bit unsigned integer (uint32_t) with its own pending state.  A
+ * notification sent to one index does not affect the value or the state of the
+ * other indexes, so a task can wait on one index while notifications sent to
+ * another index remain pending.
+ *
+ * xTaskNotify() is equivalent to calling xTaskNotifyIndexed() with the
+ * uxIndexToNotify parameter set to tskDEFAULT_INDEX_TO_NOTIFY.
  *
  * Events can be sent to a task using an intermediary object.  Examples of such
  * objects are queues, semaphores, mutexes and event groups.  Task notifications
@@ -1751,6 +1843,11 @@ void vTaskGetRunTimeStats( char *pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e9
  * task, and the handle of the currently running task can be obtained by calling
  * xTaskGetCurrentTaskHandle().
  *
+ * @param uxIndexToNotify The index of the notification value to update.  Must
+ * be less than configTASK_NOTIFICATION_ARRAY_ENTRIES.  The functions without
+ * "Indexed" in their name do not have this parameter and always update index
+ * tskDEFAULT_INDEX_TO_NOTIFY.
+ *
  * @param ulValue Data that can be sent with the notification.  How the data is
  * used depends on the value of the eAction parameter.
  *
@@ -1792,13 +1889,16 @@ void vTaskGetRunTimeStats( char *pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e9
  * \defgroup xTaskNotify xTaskNotify
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) PRIVILEGED_FUNCTION;
-#define xTaskNotify( xTaskToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), NULL )
-#define xTaskNotifyAndQuery( xTaskToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
+BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) PRIVILEGED_FUNCTION;
+#define xTaskNotify( xTaskToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), NULL )
+#define xTaskNotifyIndexed( xTaskToNotify, uxIndexToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), NULL )
+#define xTaskNotifyAndQuery( xTaskToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
+#define xTaskNotifyAndQueryIndexed( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
 
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ * <PRE>BaseType_t xTaskNotifyIndexedFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
  * function to be available.
@@ -1837,6 +1937,11 @@ BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNo
  * task, and the handle of the currently running task can be obtained by calling
  * xTaskGetCurrentTaskHandle().
  *
+ * @param uxIndexToNotify The index of the notification value to update.  Must
+ * be less than configTASK_NOTIFICATION_ARRAY_ENTRIES.  The functions without
+ * "Indexed" in their name do not have this parameter and always update index
+ * tskDEFAULT_INDEX_TO_NOTIFY.
+ *
  * @param ulValue Data that can be sent with the notification.  How the data is
  * used depends on the value of the eAction parameter.
  *
@@ -1883,13 +1988,16 @@ BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNo
  * \defgroup xTaskNotify xTaskNotify
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
-#define xTaskNotifyFromISR( xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
-#define xTaskNotifyAndQueryFromISR( xTaskToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
+BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyFromISR( xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyIndexedFromISR( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyAndQueryFromISR( xTaskToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyAndQueryIndexedFromISR( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
 
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait );</pre>
+ * <PRE>BaseType_t xTaskNotifyWaitIndexed( UBaseType_t uxIndexToWaitOn, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait );</pre>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
  * function to be available.
@@ -1920,6 +2028,11 @@ BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulVal
  *
  * See http://www.FreeRTOS.org/RTOS-task-notifications.html for details.
  *
+ * @param uxIndexToWaitOn The index of the notification value to wait on.  Must
+ * be less than configTASK_NOTIFICATION_ARRAY_ENTRIES.  The functions without
+ * "Indexed" in their name do not have this parameter and always use index
+ * tskDEFAULT_INDEX_TO_NOTIFY.
+ *
  * @param ulBitsToClearOnEntry Bits that are set in ulBitsToClearOnEntry value
  * will be cleared in the calling task's notification value before the task
  * checks to see if any notifications are pending, and optionally blocks if no
@@ -1960,11 +2073,14 @@ BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulVal
  * \defgroup xTaskNotifyWait xTaskNotifyWait
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWaitOn, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyWait( ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait ) xTaskGenericNotifyWait( ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulBitsToClearOnEntry ), ( ulBitsToClearOnExit ), ( pulNotificationValue ), ( xTicksToWait ) )
+#define xTaskNotifyWaitIndexed( uxIndexToWaitOn, ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait ) xTaskGenericNotifyWait( ( uxIndexToWaitOn ), ( ulBitsToClearOnEntry ), ( ulBitsToClearOnExit ), ( pulNotificationValue ), ( xTicksToWait ) )
 
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotifyGive( TaskHandle_t xTaskToNotify );</PRE>
+ * <PRE>BaseType_t xTaskNotifyGiveIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify );</PRE>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this macro
  * to be available.
@@ -2006,11 +2122,13 @@ BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClea
  * \defgroup xTaskNotifyGive xTaskNotifyGive
  * \ingroup TaskNotifications
  */
-#define xTaskNotifyGive( xTaskToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( 0 ), eIncrement, NULL )
+#define xTaskNotifyGive( xTaskToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( 0 ), eIncrement, NULL )
+#define xTaskNotifyGiveIndexed( xTaskToNotify, uxIndexToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( 0 ), eIncrement, NULL )
 
 /**
  * task. h
  * <PRE>void vTaskNotifyGiveFromISR( TaskHandle_t xTaskHandle, BaseType_t *pxHigherPriorityTaskWoken );
+ * <PRE>void vTaskNotifyGiveIndexedFromISR( TaskHandle_t xTaskHandle, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken );
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this macro
  * to be available.
@@ -2061,11 +2179,14 @@ BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClea
  * \defgroup xTaskNotifyWait xTaskNotifyWait
  * \ingroup TaskNotifications
  */
-void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#define vTaskNotifyGiveFromISR( xTaskToNotify, pxHigherPriorityTaskWoken ) vTaskGenericNotifyGiveFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( pxHigherPriorityTaskWoken ) )
+#define vTaskNotifyGiveIndexedFromISR( xTaskToNotify, uxIndexToNotify, pxHigherPriorityTaskWoken ) vTaskGenericNotifyGiveFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( pxHigherPriorityTaskWoken ) )
 
 /**
  * task. h
  * <PRE>uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait );</pre>
+ * <PRE>uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait );</pre>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
  * function to be available.
@@ -2109,6 +2230,11 @@ void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPri
  *
  * See http://www.FreeRTOS.org/RTOS-task-notifications.html for details.
  *
+ * @param uxIndexToWaitOn The index of the notification value to wait on.  Must
+ * be less than configTASK_NOTIFICATION_ARRAY_ENTRIES.  The functions without
+ * "Indexed" in their name do not have this parameter and always use index
+ * tskDEFAULT_INDEX_TO_NOTIFY.
+ *
  * @param xClearCountOnExit if xClearCountOnExit is pdFALSE then the task's
  * notification value is decremented when the function exits.  In this way the
  * notification value acts like a counting semaphore.  If xClearCountOnExit is
@@ -2130,11 +2256,14 @@ void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPri
  * \defgroup ulTaskNotifyTake ulTaskNotifyTake
  * \ingroup TaskNotifications
  */
-uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#define ulTaskNotifyTake( xClearCountOnExit, xTicksToWait ) ulTaskGenericNotifyTake( ( tskDEFAULT_INDEX_TO_NOTIFY ), ( xClearCountOnExit ), ( xTicksToWait ) )
+#define ulTaskNotifyTakeIndexed( uxIndexToWaitOn, xClearCountOnExit, xTicksToWait ) ulTaskGenericNotifyTake( ( uxIndexToWaitOn ), ( xClearCountOnExit ), ( xTicksToWait ) )
 
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask );</pre>
+ * <PRE>BaseType_t xTaskNotifyStateClearIndexed( TaskHandle_t xTask, UBaseType_t uxIndexToClear );</pre>
  *
  * If the notification state of the task referenced by the handle xTask is
  * eNotified, then set the task's notification state to eNotWaitingNotification.
@@ -2146,7 +2275,9 @@ uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait
  * \defgroup xTaskNotifyStateClear xTaskNotifyStateClear
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask );
+BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyStateClear( xTask ) xTaskGenericNotifyStateClear( ( xTask ), ( tskDEFAULT_INDEX_TO_NOTIFY ) )
+#define xTaskNotifyStateClearIndexed( xTask, uxIndexToClear ) xTaskGenericNotifyStateClear( ( xTask ), ( uxIndexToClear ) )
 
 /*-----------------------------------------------------------
  * SCHEDULER INTERNALS AVAILABLE FOR PORTING PURPOSES
@@ -2250,8 +2381,47 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem, const Tick
  *
  * Sets the pointer to the current TCB to the TCB of the highest priority task
  * that is ready to run.
+ *
+ * When configNUM_CORES is greater than 1 the function selects the task to run
+ * on the core xCoreID, which must be the core that makes the call, and must
+ * be called with interrupts disabled.
  */
-void vTaskSwitchContext( void ) PRIVILEGED_FUNCTION;
+#if ( configNUM_CORES > 1 )
+	void vTaskSwitchContext( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+#else
+	void vTaskSwitchContext( void ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configNUM_CORES > 1 )
+
+	/*
+	 * THESE FUNCTIONS MUST NOT BE USED FROM APPLICATION CODE.  THEY ARE
+	 * THE IMPLEMENTATION OF taskENTER_CRITICAL(), taskEXIT_CRITICAL(),
+	 * taskENTER_CRITICAL_FROM_ISR() and taskEXIT_CRITICAL_FROM_ISR() WHEN
+	 * configNUM_CORES IS GREATER THAN 1, AND ARE CALLED BY THE PORT'S
+	 * portENTER_CRITICAL() AND portEXIT_CRITICAL() MACROS.
+	 *
+	 * A critical section disables interrupts on the calling core and holds
+	 * the kernel locks, so no other core can access the kernel data until the
+	 * critical section is exited.  The interrupt safe versions only hold the
+	 * ISR lock.
+	 */
+	void vTaskEnterCritical( void ) PRIVILEGED_FUNCTION;
+	void vTaskExitCritical( void ) PRIVILEGED_FUNCTION;
+	UBaseType_t uxTaskEnterCriticalFromISR( void ) PRIVILEGED_FUNCTION;
+	void vTaskExitCriticalFromISR( UBaseType_t uxSavedInterruptStatus ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS THE
+	 * DEFAULT portYIELD_WITHIN_API() WHEN configNUM_CORES IS GREATER THAN 1.
+	 *
+	 * Yields the calling core, or, if the calling task is inside a critical
+	 * section, latches the yield so it is performed when the critical section
+	 * is exited.
+	 */
+	void vTaskYieldWithinAPI( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configNUM_CORES */
 
 /*
  * THESE FUNCTIONS MUST NOT BE USED FROM APPLICATION CODE.  THEY ARE USED BY
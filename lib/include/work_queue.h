@@ -0,0 +1,299 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Work queues are used to defer processing from an interrupt, or from a task,
+ * to a worker task.  Each work queue has its own worker task, created at the
+ * priority given to xWorkQueueCreate(), so deferred work can be run at several
+ * priorities, and does not compete with the timer service task as functions
+ * deferred with xTimerPendFunctionCall() do.
+ *
+ * The work is described by a WorkItem_t that is allocated by the application,
+ * usually as part of the driver or other object the work is done for.  Items
+ * are linked into the queue rather than copied into it, so submitting work
+ * cannot fail for lack of space.  An item that is submitted again before its
+ * function has started to run is only run once.  The worker task is only
+ * notified when the queue goes from empty to not empty, and then runs all the
+ * items it finds before it blocks again.
+ */
+
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include work_queue.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which work queues are referenced.  For example, a call to
+ * xWorkQueueCreate() returns a WorkQueueHandle_t variable that can then be used
+ * as a parameter to xWorkQueueSubmit(), xWorkQueueSubmitFromISR(), etc.
+ */
+typedef void * WorkQueueHandle_t;
+
+/*
+ * Defines the prototype to which functions run by a work queue must conform.
+ */
+typedef void (*WorkFunction_t)( void * );
+
+/*
+ * A unit of deferred work.  The members are only accessed through the API
+ * functions below, and the structure must not be modified while the item is
+ * pending on a work queue.
+ */
+typedef struct xWORK_ITEM
+{
+	struct xWORK_ITEM * volatile pxNext;	/*< The next item in the work queue. */
+	void * volatile pvOwner;				/*< The work queue on which the item is pending, or NULL if it is not pending. */
+	WorkFunction_t pxFunction;				/*< The function run by the worker task. */
+	void *pvParameter;						/*< The parameter passed into pxFunction. */
+	TickType_t xSubmitTime;					/*< The tick count at which the item was submitted, used for the latency statistics. */
+} WorkItem_t;
+
+/*
+ * Statistics kept by each work queue.  The latencies are measured from the time
+ * an item is submitted to the time its function starts to run, in ticks.
+ */
+typedef struct xWORK_QUEUE_STATS
+{
+	uint32_t ulSubmitted;			/*< The number of times an item was added to the queue. */
+	uint32_t ulCoalesced;			/*< The number of times an item was submitted while it was already pending. */
+	uint32_t ulExecuted;			/*< The number of item functions run. */
+	uint32_t ulWakeups;				/*< The number of times the worker task was unblocked to run items. */
+	UBaseType_t uxMaxPending;		/*< The largest number of items that were pending at once. */
+	TickType_t xMaxLatency;			/*< The longest latency of an item. */
+	uint32_t ulTotalLatency;		/*< The sum of the latencies of all the items run, so the mean latency is ulTotalLatency / ulExecuted. */
+} WorkQueueStats_t;
+
+/**
+ * work_queue.h
+ *
+<pre>
+WorkQueueHandle_t xWorkQueueCreate( const char * const pcName,
+									configSTACK_DEPTH_TYPE usStackDepth,
+									UBaseType_t uxPriority,
+									UBaseType_t uxMaxBatch );
+</pre>
+ *
+ * Creates a new work queue, and the worker task that runs the items submitted
+ * to it, using dynamically allocated memory.  work_queue.c can only be built
+ * with configSUPPORT_DYNAMIC_ALLOCATION set to 1 or left undefined in
+ * FreeRTOSConfig.h.
+ *
+ * @param pcName The name given to the worker task.
+ *
+ * @param usStackDepth The size of the worker task's stack, specified as for
+ * xTaskCreate().  The stack must be large enough for all the functions that
+ * will be run by the work queue.
+ *
+ * @param uxPriority The priority at which the worker task runs.
+ *
+ * @param uxMaxBatch The number of items the worker task runs before it yields
+ * to any other tasks of its priority, if more items remain.  0 means the
+ * worker task only yields when the queue is empty.
+ *
+ * @return If the work queue was created then its handle is returned.  If there
+ * was insufficient heap memory for the work queue or its worker task then NULL
+ * is returned.
+ *
+ * \defgroup xWorkQueueCreate xWorkQueueCreate
+ * \ingroup WorkQueueManagement
+ */
+WorkQueueHandle_t xWorkQueueCreate( const char * const pcName,
+									configSTACK_DEPTH_TYPE usStackDepth,
+									UBaseType_t uxPriority,
+									UBaseType_t uxMaxBatch ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+void vWorkQueueDelete( WorkQueueHandle_t xWorkQueue );
+</pre>
+ *
+ * Deletes a work queue.  Items that are pending on the work queue are removed
+ * from it without being run.  If an item's function is running when
+ * vWorkQueueDelete() is called then the worker task is deleted, and the work
+ * queue freed, when the function returns, so vWorkQueueDelete() can be called
+ * from a function run by the work queue being deleted.  No items can be
+ * submitted to the work queue once vWorkQueueDelete() has been called.
+ *
+ * @param xWorkQueue The handle of the work queue to delete.
+ *
+ * \defgroup vWorkQueueDelete vWorkQueueDelete
+ * \ingroup WorkQueueManagement
+ */
+void vWorkQueueDelete( WorkQueueHandle_t xWorkQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+void vWorkQueueInitialiseItem( WorkItem_t *pxWorkItem, WorkFunction_t pxFunction, void *pvParameter );
+</pre>
+ *
+ * Initialises a work item before it is first submitted.  An item must not be
+ * initialised again while it is pending.
+ *
+ * @param pxWorkItem The item to initialise.
+ *
+ * @param pxFunction The function the worker task runs each time the item is
+ * taken from the work queue.  The function must not block on the worker
+ * task's notifications, which the work queue uses itself.
+ *
+ * @param pvParameter The value passed into pxFunction.
+ *
+ * \defgroup vWorkQueueInitialiseItem vWorkQueueInitialiseItem
+ * \ingroup WorkQueueManagement
+ */
+void vWorkQueueInitialiseItem( WorkItem_t *pxWorkItem, WorkFunction_t pxFunction, void *pvParameter ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem );
+</pre>
+ *
+ * Adds an item to the end of a work queue, so the worker task runs its function
+ * after the items already pending.  xWorkQueueSubmit() never blocks.
+ *
+ * An item can only be pending on one work queue at a time.  If the item is
+ * already pending on xWorkQueue it is left where it is, so its function runs
+ * once for both submissions.  An item that is submitted while its function is
+ * running is added to the queue again, so the function runs again.
+ *
+ * xWorkQueueSubmitFromISR() is a version that can be called from an interrupt
+ * service routine.
+ *
+ * @param xWorkQueue The handle of the work queue to add the item to.
+ *
+ * @param pxWorkItem The item, which must have been initialised with
+ * vWorkQueueInitialiseItem().
+ *
+ * @return pdTRUE if the item was added to the work queue, or pdFALSE if it was
+ * already pending.  In both cases the item's function will run.
+ *
+ * \defgroup xWorkQueueSubmit xWorkQueueSubmit
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem, BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of xWorkQueueSubmit() that can be called from an interrupt service
+ * routine.
+ *
+ * @param xWorkQueue The handle of the work queue to add the item to.
+ *
+ * @param pxWorkItem The item, which must have been initialised with
+ * vWorkQueueInitialiseItem().
+ *
+ * @param pxHigherPriorityTaskWoken *pxHigherPriorityTaskWoken is set to pdTRUE
+ * if submitting the item unblocked the worker task, and the worker task has a
+ * priority above that of the task that was interrupted.  A context switch
+ * should then be requested before the interrupt is exited.
+ *
+ * @return pdTRUE if the item was added to the work queue, or pdFALSE if it was
+ * already pending.
+ *
+ * \defgroup xWorkQueueSubmitFromISR xWorkQueueSubmitFromISR
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkQueueCancel( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem );
+</pre>
+ *
+ * Removes a pending item from a work queue before its function runs.  An item
+ * whose function is already running is not waited for.
+ *
+ * @param xWorkQueue The handle of the work queue the item was submitted to.
+ *
+ * @param pxWorkItem The item to remove.
+ *
+ * @return pdTRUE if the item was pending and has been removed, otherwise
+ * pdFALSE.
+ *
+ * \defgroup xWorkQueueCancel xWorkQueueCancel
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkQueueCancel( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+void vWorkQueueGetStats( WorkQueueHandle_t xWorkQueue, WorkQueueStats_t *pxStats );
+</pre>
+ *
+ * Copies the statistics kept by a work queue since it was created, or since
+ * vWorkQueueResetStats() was last called.
+ *
+ * @param xWorkQueue The handle of the work queue.
+ *
+ * @param pxStats The structure into which the statistics are copied.
+ *
+ * \defgroup vWorkQueueGetStats vWorkQueueGetStats
+ * \ingroup WorkQueueManagement
+ */
+void vWorkQueueGetStats( WorkQueueHandle_t xWorkQueue, WorkQueueStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+void vWorkQueueResetStats( WorkQueueHandle_t xWorkQueue );
+</pre>
+ *
+ * Sets all the statistics kept by a work queue back to zero.
+ *
+ * @param xWorkQueue The handle of the work queue.
+ *
+ * \defgroup vWorkQueueResetStats vWorkQueueResetStats
+ * \ingroup WorkQueueManagement
+ */
+void vWorkQueueResetStats( WorkQueueHandle_t xWorkQueue ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( WORK_QUEUE_H ) */
@@ -286,6 +286,28 @@ static uint32_t prvMQTTSendCallback( void * pvSendContext,
                                      const uint8_t * const pucData,
                                      uint32_t ulDataLength );
 
+/**
+ * @brief The callback registered with the core MQTT library to transmit a message
+ * whose payload is in a separate buffer.
+ *
+ * Both buffers are handed to SOCKETS_Sendv(), so a publish payload is written to
+ * the socket straight from the buffer of the task that published it.
+ * @param[in] pvSendContext The send context is broker number in our case.
+ *
+ * @param[in] pucHeader The header to transmit.
+ * @param[in] ulHeaderLength Length of the header.
+ * @param[in] pucPayload The payload to transmit after the header.
+ * @param[in] ulPayloadLength Length of the payload.
+ *
+ * @return The number of actually transmitted bytes. Can be less than
+ * ulHeaderLength + ulPayloadLength if transmission fails for some reason.
+ */
+static uint32_t prvMQTTSendvCallback( void * pvSendContext,
+                                      const uint8_t * const pucHeader,
+                                      uint32_t ulHeaderLength,
+                                      const uint8_t * const pucPayload,
+                                      uint32_t ulPayloadLength );
+
 /**
  * @brief The callback registered with the core MQTT library to receive various MQTT events.
  *
@@ -622,11 +644,24 @@ static void prvMQTTTask( void * pvParameters );
 static uint32_t prvMQTTSendCallback( void * pvSendContext,
                                      const uint8_t * const pucData,
                                      uint32_t ulDataLength )
+{
+    return prvMQTTSendvCallback( pvSendContext, pucData, ulDataLength, NULL, 0 );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvMQTTSendvCallback( void * pvSendContext,
+                                      const uint8_t * const pucHeader,
+                                      uint32_t ulHeaderLength,
+                                      const uint8_t * const pucPayload,
+                                      uint32_t ulPayloadLength )
 {
     MQTTBrokerConnection_t * pxConnection;
     UBaseType_t uxBrokerNumber = ( UBaseType_t ) pvSendContext; /*lint !e923 The cast is ok as we passed the index of the client before. */
     int32_t lSendRetVal;
     uint32_t ulBytesSent = 0;
+    uint32_t ulDataLength = ulHeaderLength + ulPayloadLength;
+    SocketsIovec_t xVectors[ 2 ];
+    size_t xVectorCount;
     TimeOut_t xTimestamp;
     TickType_t xTicksToWait = pdMS_TO_TICKS( mqttconfigTCP_SEND_TIMEOUT_MS );
 
@@ -649,13 +684,37 @@ static uint32_t prvMQTTSendCallback( void * pvSendContext,
             break;
         }
 
+        /* Only send the remaining data: what is left of the header, if
+         * anything, and then what is left of the payload. */
+        xVectorCount = 0;
+
+        if( ulBytesSent < ulHeaderLength )
+        {
+            xVectors[ xVectorCount ].pvBuffer = &( pucHeader[ ulBytesSent ] );
+            xVectors[ xVectorCount ].xLength = ( size_t ) ( ulHeaderLength - ulBytesSent );
+            xVectorCount++;
+        }
+
+        if( ulPayloadLength > 0 )
+        {
+            if( ulBytesSent < ulHeaderLength )
+            {
+                xVectors[ xVectorCount ].pvBuffer = pucPayload;
+                xVectors[ xVectorCount ].xLength = ( size_t ) ulPayloadLength;
+            }
+            else
+            {
+                xVectors[ xVectorCount ].pvBuffer = &( pucPayload[ ulBytesSent - ulHeaderLength ] );
+                xVectors[ xVectorCount ].xLength = ( size_t ) ( ulDataLength - ulBytesSent );
+            }
+
+            xVectorCount++;
+        }
+
         /* Try sending the remaining data. */
-        lSendRetVal = SOCKETS_Send( pxConnection->xSocket,
-                                    &( pucData[ ulBytesSent ] ),               /* Only send the remaining data. */
-                                    ( size_t ) ( ulDataLength - ulBytesSent ), /* Only send the remaining data. */
-                                    0 );
+        lSendRetVal = SOCKETS_Sendv( pxConnection->xSocket, xVectors, xVectorCount, 0 );
 
-        /* A negative return value from SOCKETS_Send
+        /* A negative return value from SOCKETS_Sendv
          * means some error occurred. */
         if( lSendRetVal < 0 )
         {
@@ -1862,6 +1921,7 @@ BaseType_t MQTT_AGENT_Init( void )
             xInitParams.pxCallback = prvMQTTEventCallback;
             xInitParams.pvSendContext = ( void * ) x;     /*lint !e923 The cast is ok as we are passing the index of the client. */
             xInitParams.pxMQTTSendFxn = prvMQTTSendCallback;
+            xInitParams.pxMQTTSendvFxn = prvMQTTSendvCallback;
             xInitParams.pxGetTicksFxn = prvMQTTGetTicks;
             xInitParams.xBufferPoolInterface.pxGetBufferFxn = mqttconfigGET_FREE_BUFFER_FXN;
             xInitParams.xBufferPoolInterface.pxReturnBufferFxn = mqttconfigRETURN_BUFFER_FXN;
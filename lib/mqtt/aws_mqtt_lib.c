@@ -490,6 +490,26 @@ static MQTTReturnCode_t prvSendData( MQTTContext_t * pxMQTTContext,
                                      const uint8_t * const pucData,
                                      uint32_t ulDataLength );
 
+/**
+ * @brief Transmits a message header and its payload, which is in a separate
+ * buffer, using the user supplied vectored send callback.
+ *
+ * It updates the MQTT context in the same way as prvSendData.
+ *
+ * @param[in] pxMQTTContext The MQTT context.
+ * @param[in] pucHeader The header to transmit.
+ * @param[in] ulHeaderLength Length of the header.
+ * @param[in] pucPayload The payload to transmit after the header.
+ * @param[in] ulPayloadLength Length of the payload.
+ *
+ * @return eMQTTSuccess if send is successful, eMQTTSendFailed otherwise.
+ */
+static MQTTReturnCode_t prvSendHeaderAndPayload( MQTTContext_t * pxMQTTContext,
+                                                 const uint8_t * const pucHeader,
+                                                 uint32_t ulHeaderLength,
+                                                 const uint8_t * const pucPayload,
+                                                 uint32_t ulPayloadLength );
+
 /**
  * @brief Decodes and processes the received MQTT message containing only fixed header.
  *
@@ -1121,6 +1141,27 @@ static MQTTReturnCode_t prvSendData( MQTTContext_t * pxMQTTContext,
 }
 /*-----------------------------------------------------------*/
 
+static MQTTReturnCode_t prvSendHeaderAndPayload( MQTTContext_t * pxMQTTContext,
+                                                 const uint8_t * const pucHeader,
+                                                 uint32_t ulHeaderLength,
+                                                 const uint8_t * const pucPayload,
+                                                 uint32_t ulPayloadLength )
+{
+    MQTTReturnCode_t xReturnCode = eMQTTSendFailed;
+
+    if( pxMQTTContext->pxMQTTSendvFxn( pxMQTTContext->pvSendContext, pucHeader, ulHeaderLength, pucPayload, ulPayloadLength ) == ( ulHeaderLength + ulPayloadLength ) )
+    {
+        xReturnCode = eMQTTSuccess;
+
+        /* Same as prvSendData. */
+        pxMQTTContext->xLastSentMessageTimestamp = prvGetCurrentTickCount( pxMQTTContext );
+        pxMQTTContext->ulNextPeriodicInvokeTicks = pxMQTTContext->ulKeepAliveActualIntervalTicks;
+    }
+
+    return xReturnCode;
+}
+/*-----------------------------------------------------------*/
+
 static void prvProcessReceivedFixedHeaderOnlyMQTTPacket( MQTTContext_t * pxMQTTContext )
 {
     MQTTEventCallbackParams_t xEventCallbackParams;
@@ -2450,6 +2491,7 @@ MQTTReturnCode_t MQTT_Init( MQTTContext_t * pxMQTTContext,
     /* Store send context and function. */
     pxMQTTContext->pvSendContext = pxInitParams->pvSendContext;
     pxMQTTContext->pxMQTTSendFxn = pxInitParams->pxMQTTSendFxn;
+    pxMQTTContext->pxMQTTSendvFxn = pxInitParams->pxMQTTSendvFxn;
 
     /* Store get ticks function. */
     pxMQTTContext->pxGetTicksFxn = pxInitParams->pxGetTicksFxn;
@@ -2963,10 +3005,11 @@ MQTTReturnCode_t MQTT_Publish( MQTTContext_t * pxMQTTContext,
                                const MQTTPublishParams_t * const pxPublishParams )
 {
     uint8_t * pucNextByte, * pucLastByteInBuffer, ucRemainingLengthFieldBytes;
-    uint32_t ulRemainingLength, ulTotalMessageLength;
+    uint32_t ulRemainingLength, ulTotalMessageLength, ulBufferedLength;
     uint16_t usTopicLength;
     MQTTBufferHandle_t xBuffer = NULL;
     MQTTReturnCode_t xReturnCode = eMQTTFailure;
+    MQTTBool_t xSendPayloadSeparately;
 
     /* These are checked here once and are later used without
      * NULL checks. */
@@ -2978,6 +3021,18 @@ MQTTReturnCode_t MQTT_Publish( MQTTContext_t * pxMQTTContext,
 
     mqttconfigDEBUG_LOG( ( "Initiating MQTT publish.\r\n" ) );
 
+    /* If the user registered a vectored send callback, the payload is sent
+     * from the user's buffer and only the header goes in the Tx buffer. The
+     * Tx buffer is never retransmitted, so it does not need the payload. */
+    if( ( pxMQTTContext->pxMQTTSendvFxn != NULL ) && ( pxPublishParams->ulDataLength > ( uint32_t ) 0 ) )
+    {
+        xSendPayloadSeparately = eMQTTTrue;
+    }
+    else
+    {
+        xSendPayloadSeparately = eMQTTFalse;
+    }
+
     if( pxMQTTContext->xConnectionState != eMQTTConnected )
     {
         /* Fail the publish operation immediately, if
@@ -3003,8 +3058,18 @@ MQTTReturnCode_t MQTT_Publish( MQTTContext_t * pxMQTTContext,
             /* Calculate total MQTT message length. */
             ulTotalMessageLength = mqttTOTAL_MESSAGE_LENGTH( ucRemainingLengthFieldBytes, ulRemainingLength );
 
+            /* Length of the part of the message written to the Tx buffer. */
+            if( xSendPayloadSeparately == eMQTTTrue )
+            {
+                ulBufferedLength = ulTotalMessageLength - pxPublishParams->ulDataLength;
+            }
+            else
+            {
+                ulBufferedLength = ulTotalMessageLength;
+            }
+
             /* Try to get a buffer from the free buffer pool. */
-            xBuffer = prvGetFreeBuffer( pxMQTTContext, ulTotalMessageLength );
+            xBuffer = prvGetFreeBuffer( pxMQTTContext, ulBufferedLength );
 
             if( xBuffer == NULL )
             {
@@ -3058,15 +3123,19 @@ MQTTReturnCode_t MQTT_Publish( MQTTContext_t * pxMQTTContext,
                     pucNextByte++;
                 }
 
-                /* Write the payload into the message. */
-                memcpy( pucNextByte, pxPublishParams->pvData, ( size_t ) pxPublishParams->ulDataLength );
+                /* Write the payload into the message, unless it is sent
+                 * from the user's buffer. */
+                if( xSendPayloadSeparately == eMQTTFalse )
+                {
+                    memcpy( pucNextByte, pxPublishParams->pvData, ( size_t ) pxPublishParams->ulDataLength );
+                }
 
                 /* Store the packet identifier in TxBuffer also for matching
                  * ACK later. */
                 mqttbufferGET_PACKET_IDENTIFIER( xBuffer ) = pxPublishParams->usPacketIdentifier;
 
                 /* Update the number of bytes written to the buffer. */
-                mqttbufferGET_DATA_LENGTH( xBuffer ) = ulTotalMessageLength;
+                mqttbufferGET_DATA_LENGTH( xBuffer ) = ulBufferedLength;
 
                 /* MQTT packet created. */
                 xReturnCode = eMQTTSuccess;
@@ -3077,7 +3146,18 @@ MQTTReturnCode_t MQTT_Publish( MQTTContext_t * pxMQTTContext,
     /* If the packet was successfully constructed, transmit it. */
     if( xReturnCode == eMQTTSuccess )
     {
-        xReturnCode = prvSendData( pxMQTTContext, mqttbufferGET_DATA( xBuffer ), mqttbufferGET_DATA_LENGTH( xBuffer ) );
+        if( xSendPayloadSeparately == eMQTTTrue )
+        {
+            xReturnCode = prvSendHeaderAndPayload( pxMQTTContext,
+                                                   mqttbufferGET_DATA( xBuffer ),
+                                                   mqttbufferGET_DATA_LENGTH( xBuffer ),
+                                                   ( const uint8_t * ) pxPublishParams->pvData,
+                                                   pxPublishParams->ulDataLength );
+        }
+        else
+        {
+            xReturnCode = prvSendData( pxMQTTContext, mqttbufferGET_DATA( xBuffer ), mqttbufferGET_DATA_LENGTH( xBuffer ) );
+        }
     }
 
     /* If some error occurred or QOS0 (No ACK is expected in case of QOS0),
@@ -36,6 +36,7 @@
 #include "FreeRTOSIPConfig.h"
 #include "aws_pkcs11_config.h"
 #include "task.h"
+#include "semphr.h"
 #include "aws_crypto.h"
 #include "aws_pkcs11.h"
 
@@ -66,6 +67,10 @@ typedef int ( * pfnMbedTlsSign )( void * ctx,
 
 /**
  * @brief Key structure.
+ *
+ * The default key and certificate are parsed once and shared by every
+ * session that finds them; ulSessionCount tracks those sessions. Keys
+ * generated in a session belong to that session alone.
  */
 typedef struct P11Key
 {
@@ -74,6 +79,8 @@ typedef struct P11Key
     mbedtls_pk_info_t xMbedPkInfo;
     pfnMbedTlsSign pfnSavedMbedSign;
     void * pvSavedMbedPkCtx;
+    CK_BBOOL xShared;
+    uint32_t ulSessionCount;
 } P11Key_t, * P11KeyPtr_t;
 
 /**
@@ -88,8 +95,7 @@ typedef struct P11Session
     CK_BBOOL xFindObjectInit;
     CK_BBOOL xFindObjectComplete;
     CK_OBJECT_CLASS xFindObjectClass;
-    mbedtls_ctr_drbg_context xMbedDrbgCtx;
-    mbedtls_entropy_context xMbedEntropyContext;
+    CK_OBJECT_HANDLE xFindObjectHandle;
     mbedtls_pk_context xPublicKey;
     mbedtls_sha256_context xSHA256Context;
 } P11Session_t, * P11SessionPtr_t;
@@ -104,6 +110,20 @@ typedef struct P11Session
 
 #define pkcs11SUPPORTED_KEY_BITS           2048
 
+/**
+ * @brief Object labels, which can be used instead of the object class to find
+ * an object.
+ */
+#ifndef pkcs11configLABEL_DEVICE_PUBLIC_KEY_FOR_TLS
+    #define pkcs11configLABEL_DEVICE_PUBLIC_KEY_FOR_TLS     "Device Pub TLS Key"
+#endif
+#ifndef pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS
+    #define pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS    "Device Priv TLS Key"
+#endif
+#ifndef pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS
+    #define pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS    "Device Cert"
+#endif
+
 
 /**
  * @brief Helper definitions.
@@ -143,6 +163,121 @@ extern void PKCS11_PAL_ReleaseFileData( uint8_t * pucBuffer,
                                         uint32_t ulBufferSize );
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Object table entry. The table is indexed by object handle, so the
+ * handles are the same in every session.
+ */
+typedef struct P11Object
+{
+    CK_OBJECT_CLASS xClass;
+    const char * pcLabel;
+} P11Object_t;
+
+static const P11Object_t xP11Objects[] =
+{
+    { CKO_PUBLIC_KEY,  pkcs11configLABEL_DEVICE_PUBLIC_KEY_FOR_TLS  }, /* pkcs11OBJECT_HANDLE_PUBLIC_KEY */
+    { CKO_PRIVATE_KEY, pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS }, /* pkcs11OBJECT_HANDLE_PRIVATE_KEY */
+    { CKO_CERTIFICATE, pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS }  /* pkcs11OBJECT_HANDLE_CERTIFICATE */
+};
+
+#define pkcs11OBJECT_COUNT    ( sizeof( xP11Objects ) / sizeof( xP11Objects[ 0 ] ) )
+
+/**
+ * @brief State shared by all sessions.
+ *
+ * Seeding a DRBG and parsing the stored key and certificate are the costly
+ * parts of using the module, so both are done once rather than per session.
+ * xMutex guards all the fields, and the use of the DRBG.
+ */
+typedef struct P11Module
+{
+    SemaphoreHandle_t xMutex;
+    CK_BBOOL xDrbgSeeded;
+    CK_ULONG ulDrbgReseeds;
+    CK_ULONG ulObjectGeneration;
+    mbedtls_entropy_context xMbedEntropyContext;
+    mbedtls_ctr_drbg_context xMbedDrbgCtx;
+    P11KeyPtr_t pxDefaultKey;
+} P11Module_t;
+
+static P11Module_t xP11Module;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Locks the module state, creating the lock on first use.
+ *
+ * @return CKR_OK if the lock was taken.
+ */
+static CK_RV prvModuleLock( void )
+{
+    SemaphoreHandle_t xNewMutex;
+
+    if( NULL == xP11Module.xMutex )
+    {
+        xNewMutex = xSemaphoreCreateMutex();
+
+        if( NULL == xNewMutex )
+        {
+            return CKR_HOST_MEMORY;
+        }
+
+        /* Another task may have raced to create the lock. */
+        taskENTER_CRITICAL();
+
+        if( NULL == xP11Module.xMutex )
+        {
+            xP11Module.xMutex = xNewMutex;
+            xNewMutex = NULL;
+        }
+
+        taskEXIT_CRITICAL();
+
+        if( NULL != xNewMutex )
+        {
+            vSemaphoreDelete( xNewMutex );
+        }
+    }
+
+    return ( pdTRUE == xSemaphoreTake( xP11Module.xMutex, portMAX_DELAY ) ) ? CKR_OK : CKR_CANT_LOCK;
+}
+
+/**
+ * @brief Unlocks the module state.
+ */
+static void prvModuleUnlock( void )
+{
+    ( void ) xSemaphoreGive( xP11Module.xMutex );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Maps an object label into its handle.
+ *
+ * @return The object handle, or 0 if no object has that label.
+ */
+static CK_OBJECT_HANDLE prvObjectFromLabel( const void * pvLabel,
+                                            CK_ULONG ulLabelLength )
+{
+    CK_OBJECT_HANDLE xHandle = 0;
+    CK_ULONG ulIndex;
+
+    /* The table has one entry per virtual handle, so this is bounded. */
+    for( ulIndex = 0; ( ulIndex < pkcs11OBJECT_COUNT ) && ( 0 == xHandle ); ulIndex++ )
+    {
+        if( ( strlen( xP11Objects[ ulIndex ].pcLabel ) == ulLabelLength ) &&
+            ( 0 == memcmp( xP11Objects[ ulIndex ].pcLabel, pvLabel, ulLabelLength ) ) )
+        {
+            xHandle = ( CK_OBJECT_HANDLE ) ( ulIndex + 1 );
+        }
+    }
+
+    return xHandle;
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Maps an opaque caller session handle into its internal state structure.
  */
@@ -151,6 +286,64 @@ P11SessionPtr_t prvSessionPointerFromHandle( CK_SESSION_HANDLE xSession )
     return ( P11SessionPtr_t ) xSession; /*lint !e923 Allow casting integer type to pointer for handle. */
 }
 
+/**
+ * @brief Sign a cryptographic hash with a private key, using the shared DRBG.
+ *
+ * @param[in] pxKey Key to sign with.
+ * @param[in] pucHash Hash to be signed.
+ * @param[in] ulHashLen Length in bytes of the hash.
+ * @param[out] pucSig Signature bytes.
+ * @param[in,out] pxSigLen Length in bytes of the signature.
+ *
+ * @return CKR_OK on success.
+ */
+static CK_RV prvSignHash( P11KeyPtr_t pxKey,
+                          const unsigned char * pucHash,
+                          CK_ULONG ulHashLen,
+                          unsigned char * pucSig,
+                          size_t * pxSigLen )
+{
+    CK_RV xResult = CKR_OK;
+
+    /*
+     * Check algorithm support.
+     */
+    if( ( CK_ULONG ) cryptoSHA256_DIGEST_BYTES != ulHashLen )
+    {
+        xResult = CKR_DATA_LEN_RANGE;
+    }
+
+    if( CKR_OK == xResult )
+    {
+        xResult = prvModuleLock();
+    }
+
+    /*
+     * Sign the data.
+     */
+    if( CKR_OK == xResult )
+    {
+        if( 0 != pxKey->pfnSavedMbedSign(
+                pxKey->pvSavedMbedPkCtx,
+                MBEDTLS_MD_SHA256,
+                pucHash,
+                ulHashLen,
+                pucSig,
+                pxSigLen,
+                mbedtls_ctr_drbg_random,
+                &xP11Module.xMbedDrbgCtx ) )
+        {
+            xResult = CKR_FUNCTION_FAILED;
+        }
+
+        prvModuleUnlock();
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Sign a cryptographic hash with the private key.
  *
@@ -174,9 +367,7 @@ static int prvPrivateKeySigningCallback( void * pvContext,
                                          int ( *piRng )( void *, unsigned char *, size_t ), /*lint !e955 This parameter is unused. */
                                          void * pvRng )
 {
-    BaseType_t xResult = 0;
-    P11SessionPtr_t pxSession = ( P11SessionPtr_t ) pvContext;
-    CK_MECHANISM xMech = { 0 };
+    P11KeyPtr_t pxKey = ( P11KeyPtr_t ) pvContext;
 
     /* Unreferenced parameters. */
     ( void ) ( piRng );
@@ -184,24 +375,11 @@ static int prvPrivateKeySigningCallback( void * pvContext,
     ( void ) ( xMdAlg );
 
     /* Use the PKCS#11 module to sign. */
-    xMech.mechanism = CKM_SHA256;
-
-    xResult = ( BaseType_t ) C_SignInit(
-        ( CK_SESSION_HANDLE ) pxSession,
-        &xMech,
-        ( CK_OBJECT_HANDLE ) pxSession->pxCurrentKey );
-
-    if( 0 == xResult )
-    {
-        xResult = ( BaseType_t ) C_Sign(
-            ( CK_SESSION_HANDLE ) pxSession,
-            ( CK_BYTE_PTR ) pucHash, /*lint !e9005 The interfaces are from 3rdparty libraries, we are not suppose to change them. */
-            ( CK_ULONG ) xHashLen,
-            pucSig,
-            ( CK_ULONG_PTR ) pxSigLen );
-    }
-
-    return xResult;
+    return ( int ) prvSignHash( pxKey,
+                                pucHash,
+                                ( CK_ULONG ) xHashLen,
+                                pucSig,
+                                pxSigLen );
 }
 
 /*-----------------------------------------------------------*/
@@ -210,8 +388,7 @@ static int prvPrivateKeySigningCallback( void * pvContext,
  * @brief Allow mbedTLS client authentication to use PKCS#11 without a separate
  * shim library. 
  */
-static CK_RV prvSetupPkcs11SigningForMbedTls( P11SessionPtr_t pxSessionObj, 
-                                              P11KeyPtr_t pxKeyObj )
+static CK_RV prvSetupPkcs11SigningForMbedTls( P11KeyPtr_t pxKeyObj )
 {
     /* Swap out the signing function pointer. */
     memcpy(
@@ -222,9 +399,10 @@ static CK_RV prvSetupPkcs11SigningForMbedTls( P11SessionPtr_t pxSessionObj,
     pxKeyObj->xMbedPkInfo.sign_func = prvPrivateKeySigningCallback;
     pxKeyObj->xMbedPkCtx.pk_info = &pxKeyObj->xMbedPkInfo;
 
-    /* Swap out the underlying internal key context. */
+    /* Swap out the underlying internal key context. The key outlives every
+     * session that can export it. */
     pxKeyObj->pvSavedMbedPkCtx = pxKeyObj->xMbedPkCtx.pk_ctx;
-    pxKeyObj->xMbedPkCtx.pk_ctx = pxSessionObj;
+    pxKeyObj->xMbedPkCtx.pk_ctx = pxKeyObj;
 
     return CKR_OK;
 }
@@ -234,7 +412,7 @@ static CK_RV prvSetupPkcs11SigningForMbedTls( P11SessionPtr_t pxSessionObj,
 /**
  * @brief Initializes a key structure.
  */
-static CK_RV prvInitializeKey( P11SessionPtr_t pxSessionObj,
+static CK_RV prvInitializeKey( P11KeyPtr_t pxKey,
                                const char * pcEncodedKey,
                                const uint32_t ulEncodedKeyLength,
                                const char * pcEncodedCertificate,
@@ -242,55 +420,37 @@ static CK_RV prvInitializeKey( P11SessionPtr_t pxSessionObj,
 {
     CK_RV xResult = 0;
 
+    memset( pxKey, 0, sizeof( P11Key_t ) );
+    mbedtls_pk_init( &pxKey->xMbedPkCtx );
+    mbedtls_x509_crt_init( &pxKey->xMbedX509Cli );
+
     /*
-     * Create the key structure, but allow an existing one to be used.
+     * Initialize the key field.
      */
 
-    if( NULL == pxSessionObj->pxCurrentKey )
+    if( 0 != mbedtls_pk_parse_key(
+            &pxKey->xMbedPkCtx,
+            ( const unsigned char * ) pcEncodedKey,
+            ulEncodedKeyLength,
+            NULL,
+            0 ) )
     {
-        if( NULL == ( pxSessionObj->pxCurrentKey = ( P11KeyPtr_t ) pvPortMalloc(
-                          sizeof( P11Key_t ) ) ) ) /*lint !e9087 Allow casting void* to other types. */
-        {
-            xResult = CKR_HOST_MEMORY;
-        }
+        xResult = CKR_FUNCTION_FAILED;
     }
 
-    /*
-     * Initialize the key field, if requested.
-     */
-
-    if( ( CKR_OK == xResult ) && ( NULL != pcEncodedKey ) )
+    if( CKR_OK == xResult )
     {
-        memset( pxSessionObj->pxCurrentKey, 0, sizeof( P11Key_t ) );
-        mbedtls_pk_init( &pxSessionObj->pxCurrentKey->xMbedPkCtx );
-
-        if( 0 != mbedtls_pk_parse_key(
-                &pxSessionObj->pxCurrentKey->xMbedPkCtx,
-                ( const unsigned char * ) pcEncodedKey,
-                ulEncodedKeyLength,
-                NULL,
-                0 ) )
-        {
-            xResult = CKR_FUNCTION_FAILED;
-        }
-
-        if( CKR_OK == xResult )
-        {
-            xResult = prvSetupPkcs11SigningForMbedTls( pxSessionObj, 
-                                                       pxSessionObj->pxCurrentKey );
-        }
+        xResult = prvSetupPkcs11SigningForMbedTls( pxKey );
     }
 
     /*
-     * Initialize the certificate field, if requested.
+     * Initialize the certificate field.
      */
 
-    if( ( CKR_OK == xResult ) && ( NULL != pcEncodedCertificate ) )
+    if( CKR_OK == xResult )
     {
-        mbedtls_x509_crt_init( &pxSessionObj->pxCurrentKey->xMbedX509Cli );
-
         if( 0 != mbedtls_x509_crt_parse(
-                &pxSessionObj->pxCurrentKey->xMbedX509Cli,
+                &pxKey->xMbedX509Cli,
                 ( const unsigned char * ) pcEncodedCertificate,
                 ulEncodedCertificateLength ) )
         {
@@ -304,9 +464,10 @@ static CK_RV prvInitializeKey( P11SessionPtr_t pxSessionObj,
 /*-----------------------------------------------------------*/
 
 /**
- * @brief Load the default key and certificate from storage.
+ * @brief Load the default key and certificate from storage. The caller must
+ * hold the module lock.
  */
-static CK_RV prvLoadAndInitializeDefaultCertificateAndKey( P11SessionPtr_t pxSession )
+static CK_RV prvLoadAndInitializeDefaultCertificateAndKey( P11KeyPtr_t pxKey )
 {
     CK_RV xResult = 0;
     uint8_t * pucCertificateData = NULL;
@@ -342,18 +503,18 @@ static CK_RV prvLoadAndInitializeDefaultCertificateAndKey( P11SessionPtr_t pxSes
         xFreeKey = pdTRUE;
     }
 
-    /* Attach the certificate and key to the session. */
-    xResult = prvInitializeKey( pxSession,
+    /* Parse the certificate and key. */
+    xResult = prvInitializeKey( pxKey,
                                 ( const char * ) pucKeyData,
                                 ulKeyDataLength,
                                 ( const char * ) pucCertificateData,
                                 ulCertificateDataLength );
 
     /* Stir the random pot. */
-    mbedtls_entropy_update_manual( &pxSession->xMbedEntropyContext,
+    mbedtls_entropy_update_manual( &xP11Module.xMbedEntropyContext,
                                    pucKeyData,
                                    ulKeyDataLength );
-    mbedtls_entropy_update_manual( &pxSession->xMbedEntropyContext,
+    mbedtls_entropy_update_manual( &xP11Module.xMbedEntropyContext,
                                    pucCertificateData,
                                    ulCertificateDataLength );
 
@@ -390,6 +551,116 @@ static void prvFreeKey( P11KeyPtr_t pxKey )
     }
 }
 
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Attaches the default key and certificate to a session, parsing them
+ * only if no other session did since they were last stored.
+ */
+static CK_RV prvDefaultKeyAcquire( P11SessionPtr_t pxSession )
+{
+    CK_RV xResult;
+    P11KeyPtr_t pxKey;
+
+    xResult = prvModuleLock();
+
+    if( CKR_OK == xResult )
+    {
+        pxKey = xP11Module.pxDefaultKey;
+
+        if( NULL == pxKey )
+        {
+            pxKey = ( P11KeyPtr_t ) pvPortMalloc( sizeof( P11Key_t ) ); /*lint !e9087 Allow casting void* to other types. */
+
+            if( NULL == pxKey )
+            {
+                xResult = CKR_HOST_MEMORY;
+            }
+            else
+            {
+                xResult = prvLoadAndInitializeDefaultCertificateAndKey( pxKey );
+
+                if( CKR_OK == xResult )
+                {
+                    pxKey->xShared = CK_TRUE;
+                    xP11Module.pxDefaultKey = pxKey;
+                }
+                else
+                {
+                    prvFreeKey( pxKey );
+                    pxKey = NULL;
+                }
+            }
+        }
+
+        if( NULL != pxKey )
+        {
+            pxKey->ulSessionCount++;
+            pxSession->pxCurrentKey = pxKey;
+        }
+
+        prvModuleUnlock();
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Detaches a key from a session, freeing it if no session uses it
+ * any more and it is not the current default key.
+ */
+static void prvKeyRelease( P11KeyPtr_t pxKey )
+{
+    if( NULL == pxKey )
+    {
+        return;
+    }
+
+    if( CK_TRUE != pxKey->xShared )
+    {
+        prvFreeKey( pxKey );
+    }
+    else if( CKR_OK == prvModuleLock() )
+    {
+        pxKey->ulSessionCount--;
+
+        if( ( 0u == pxKey->ulSessionCount ) && ( pxKey != xP11Module.pxDefaultKey ) )
+        {
+            prvFreeKey( pxKey );
+        }
+
+        prvModuleUnlock();
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Makes the next session that needs the default key and certificate
+ * read them from storage again. Sessions still using the previous ones keep
+ * them until they close.
+ *
+ * Also moves the object generation on, which tells callers that cache what
+ * they read from the module, such as the TLS layer, to read it again.
+ */
+static void prvDefaultKeyInvalidate( void )
+{
+    if( CKR_OK == prvModuleLock() )
+    {
+        if( ( NULL != xP11Module.pxDefaultKey ) &&
+            ( 0u == xP11Module.pxDefaultKey->ulSessionCount ) )
+        {
+            prvFreeKey( xP11Module.pxDefaultKey );
+        }
+
+        xP11Module.pxDefaultKey = NULL;
+        xP11Module.ulObjectGeneration++;
+        prvModuleUnlock();
+    }
+}
+
 /*
  * PKCS#11 module implementation.
  */
@@ -463,7 +734,7 @@ static CK_FUNCTION_LIST prvP11FunctionList =
     NULL, /*C_WrapKey*/
     NULL, /*C_UnwrapKey*/
     NULL, /*C_DeriveKey*/
-    NULL, /*C_SeedRandom*/
+    C_SeedRandom,
     C_GenerateRandom,
     NULL, /*C_GetFunctionStatus*/
     NULL, /*C_CancelFunction*/
@@ -583,37 +854,53 @@ CK_DEFINE_FUNCTION( CK_RV, C_OpenSession )( CK_SLOT_ID xSlotID,
     }
 
     /*
-     * Make space for the context.
+     * Initialize the RNG shared by all sessions, once.
      */
     if( CKR_OK == xResult )
     {
-        pxSessionObj = ( P11SessionPtr_t ) pvPortMalloc( sizeof( P11Session_t ) ); /*lint !e9087 Allow casting void* to other types. */
+        xResult = prvModuleLock();
 
-        if( NULL == pxSessionObj )
+        if( CKR_OK == xResult )
         {
-            xResult = CKR_HOST_MEMORY;
+            if( CK_FALSE == xP11Module.xDrbgSeeded )
+            {
+                mbedtls_entropy_init( &xP11Module.xMbedEntropyContext );
+                mbedtls_ctr_drbg_init( &xP11Module.xMbedDrbgCtx );
+
+                if( 0 != mbedtls_ctr_drbg_seed( &xP11Module.xMbedDrbgCtx,
+                                                mbedtls_entropy_func,
+                                                &xP11Module.xMbedEntropyContext,
+                                                NULL,
+                                                0 ) )
+                {
+                    xResult = CKR_FUNCTION_FAILED;
+                    mbedtls_ctr_drbg_free( &xP11Module.xMbedDrbgCtx );
+                    mbedtls_entropy_free( &xP11Module.xMbedEntropyContext );
+                }
+                else
+                {
+                    xP11Module.xDrbgSeeded = CK_TRUE;
+                }
+            }
+
+            prvModuleUnlock();
         }
     }
 
     /*
-     * Initialize RNG.
+     * Make space for the context.
      */
-
     if( CKR_OK == xResult )
     {
-        memset( pxSessionObj, 0, sizeof( P11Session_t ) );
-
-        mbedtls_entropy_init( &pxSessionObj->xMbedEntropyContext );
-
-        mbedtls_ctr_drbg_init( &pxSessionObj->xMbedDrbgCtx );
+        pxSessionObj = ( P11SessionPtr_t ) pvPortMalloc( sizeof( P11Session_t ) ); /*lint !e9087 Allow casting void* to other types. */
 
-        if( 0 != mbedtls_ctr_drbg_seed( &pxSessionObj->xMbedDrbgCtx,
-                                        mbedtls_entropy_func,
-                                        &pxSessionObj->xMbedEntropyContext,
-                                        NULL,
-                                        0 ) )
+        if( NULL == pxSessionObj )
         {
-            xResult = CKR_FUNCTION_FAILED;
+            xResult = CKR_HOST_MEMORY;
+        }
+        else
+        {
+            memset( pxSessionObj, 0, sizeof( P11Session_t ) );
         }
     }
 
@@ -664,10 +951,7 @@ CK_DEFINE_FUNCTION( CK_RV, C_CloseSession )( CK_SESSION_HANDLE xSession )
          * Tear down the session.
          */
 
-        if( NULL != pxSession->pxCurrentKey )
-        {
-            prvFreeKey( pxSession->pxCurrentKey );
-        }
+        prvKeyRelease( pxSession->pxCurrentKey );
 
         /* Free the public key context if it exists. */
         if( NULL != pxSession->xPublicKey.pk_ctx )
@@ -675,7 +959,6 @@ CK_DEFINE_FUNCTION( CK_RV, C_CloseSession )( CK_SESSION_HANDLE xSession )
             mbedtls_pk_free( &pxSession->xPublicKey );
         }
 
-        mbedtls_ctr_drbg_free( &pxSession->xMbedDrbgCtx );
         vPortFree( pxSession );
     }
     else
@@ -892,6 +1175,12 @@ CK_DEFINE_FUNCTION( CK_RV, C_CreateObject )( CK_SESSION_HANDLE xSession,
         }
     }
 
+    /* The parsed default key and certificate are now stale. */
+    if( CKR_OK == xResult )
+    {
+        prvDefaultKeyInvalidate();
+    }
+
     return xResult;
 }
 
@@ -910,7 +1199,7 @@ CK_DEFINE_FUNCTION( CK_RV, C_DestroyObject )( CK_SESSION_HANDLE xSession,
         pkcs11OBJECT_HANDLE_PUBLIC_KEY != xObject &&
         pkcs11OBJECT_HANDLE_CERTIFICATE != xObject )
     {
-        prvFreeKey( pxKey );
+        prvKeyRelease( pxKey );
     }
     else
     {
@@ -1024,6 +1313,20 @@ CK_DEFINE_FUNCTION( CK_RV, C_GetAttributeValue )( CK_SESSION_HANDLE xSession,
                     pvAttr = &xKeyBitLen;
                     break;
 
+                case CKA_LABEL:
+
+                    if( ( xObject >= 1u ) && ( xObject <= pkcs11OBJECT_COUNT ) )
+                    {
+                        pvAttr = ( CK_VOID_PTR ) xP11Objects[ xObject - 1u ].pcLabel; /*lint !e9005 Allow casting other types to void*. */
+                        ulAttrLength = strlen( xP11Objects[ xObject - 1u ].pcLabel );
+                    }
+                    else
+                    {
+                        xResult = CKR_OBJECT_HANDLE_INVALID;
+                    }
+
+                    break;
+
                 case CKA_VENDOR_DEFINED:
 
                     /*
@@ -1073,8 +1376,9 @@ CK_DEFINE_FUNCTION( CK_RV, C_FindObjectsInit )( CK_SESSION_HANDLE xSession,
 {   /*lint !e9072 It's OK to have different parameter name. */
     P11SessionPtr_t pxSession = prvSessionPointerFromHandle( xSession );
     CK_RV xResult = CKR_OK;
-
-    ( void ) ( ulCount );
+    CK_ULONG ulIndex;
+    CK_BBOOL xHaveClass = CK_FALSE;
+    CK_BBOOL xHaveLabel = CK_FALSE;
 
     /*
      * Check parameters.
@@ -1086,14 +1390,50 @@ CK_DEFINE_FUNCTION( CK_RV, C_FindObjectsInit )( CK_SESSION_HANDLE xSession,
     else
     {
         /*
-         * Allow filtering on a single object class attribute.
+         * Allow filtering on an object class attribute, an object label, or
+         * both.
          */
 
         pxSession->xFindObjectInit = CK_TRUE;
         pxSession->xFindObjectComplete = CK_FALSE;
-        memcpy( &pxSession->xFindObjectClass,
-                pxTemplate[ 0 ].pValue,
-                sizeof( CK_OBJECT_CLASS ) );
+        pxSession->xFindObjectClass = ( CK_OBJECT_CLASS ) CKO_VENDOR_DEFINED;
+        pxSession->xFindObjectHandle = 0;
+
+        for( ulIndex = 0; ulIndex < ulCount; ulIndex++ )
+        {
+            switch( pxTemplate[ ulIndex ].type )
+            {
+                case CKA_CLASS:
+                    memcpy( &pxSession->xFindObjectClass,
+                            pxTemplate[ ulIndex ].pValue,
+                            sizeof( CK_OBJECT_CLASS ) );
+                    xHaveClass = CK_TRUE;
+                    break;
+
+                case CKA_LABEL:
+                    xHaveLabel = CK_TRUE;
+                    pxSession->xFindObjectHandle = prvObjectFromLabel( pxTemplate[ ulIndex ].pValue,
+                                                                       pxTemplate[ ulIndex ].ulValueLen );
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        /* A label alone selects the class of its object. An unknown label
+         * matches nothing. */
+        if( CK_TRUE == xHaveLabel )
+        {
+            if( 0u == pxSession->xFindObjectHandle )
+            {
+                pxSession->xFindObjectClass = ( CK_OBJECT_CLASS ) CKO_VENDOR_DEFINED;
+            }
+            else if( CK_FALSE == xHaveClass )
+            {
+                pxSession->xFindObjectClass = xP11Objects[ pxSession->xFindObjectHandle - 1u ].xClass;
+            }
+        }
     }
 
     return xResult;
@@ -1147,7 +1487,7 @@ CK_DEFINE_FUNCTION( CK_RV, C_FindObjects )( CK_SESSION_HANDLE xSession,
 
     if( ( pdFALSE == xDone ) && ( NULL == pxSession->pxCurrentKey ) )
     {
-        if( CKR_OK != ( xResult = prvLoadAndInitializeDefaultCertificateAndKey( pxSession ) ) )
+        if( CKR_OK != ( xResult = prvDefaultKeyAcquire( pxSession ) ) )
         {
             xDone = pdTRUE;
         }
@@ -1182,6 +1522,14 @@ CK_DEFINE_FUNCTION( CK_RV, C_FindObjects )( CK_SESSION_HANDLE xSession,
                 break;
         }
 
+        /* A label must name the object of the requested class. */
+        if( ( 0u != pxSession->xFindObjectHandle ) &&
+            ( *pxObject != pxSession->xFindObjectHandle ) )
+        {
+            *pxObject = 0;
+            *pulObjectCount = 0;
+        }
+
         pxSession->xFindObjectComplete = CK_TRUE;
     }
 
@@ -1213,6 +1561,7 @@ CK_DEFINE_FUNCTION( CK_RV, C_FindObjectsFinal )( CK_SESSION_HANDLE xSession )
         pxSession->xFindObjectInit = CK_FALSE;
         pxSession->xFindObjectComplete = CK_FALSE;
         pxSession->xFindObjectClass = 0;
+        pxSession->xFindObjectHandle = 0;
     }
 
     return xResult;
@@ -1373,36 +1722,11 @@ CK_DEFINE_FUNCTION( CK_RV, C_Sign )( CK_SESSION_HANDLE xSession,
         }
         else
         {
-            /*
-             * Check algorithm support.
-             */
-            if( CKR_OK == xResult )
-            {
-                if( ( CK_ULONG ) cryptoSHA256_DIGEST_BYTES != ulDataLen )
-                {
-                    xResult = CKR_DATA_LEN_RANGE;
-                }
-            }
-
-            /*
-             * Sign the data.
-             */
-
-            if( CKR_OK == xResult )
-            {
-                if( 0 != pxSessionObj->pxCurrentKey->pfnSavedMbedSign(
-                        pxSessionObj->pxCurrentKey->pvSavedMbedPkCtx,
-                        MBEDTLS_MD_SHA256,
-                        pucData,
-                        ulDataLen,
-                        pucSignature,
-                        ( size_t * ) pulSignatureLen,
-                        mbedtls_ctr_drbg_random,
-                        &pxSessionObj->xMbedDrbgCtx ) )
-                {
-                    xResult = CKR_FUNCTION_FAILED;
-                }
-            }
+            xResult = prvSignHash( pxSessionObj->pxCurrentKey,
+                                   pucData,
+                                   ulDataLen,
+                                   pucSignature,
+                                   ( size_t * ) pulSignatureLen );
         }
     }
 
@@ -1549,28 +1873,32 @@ CK_DEFINE_FUNCTION( CK_RV, C_GenerateKeyPair )( CK_SESSION_HANDLE xSession,
     if( 0 == xResult )
     {
         mbedtls_ecdsa_init( pxNewKey->xMbedPkCtx.pk_ctx );
+        xResult = prvModuleLock();
+    }
+
+    if( 0 == xResult )
+    {
         if( 0 != mbedtls_ecdsa_genkey( pxNewKey->xMbedPkCtx.pk_ctx,
                                        MBEDTLS_ECP_DP_SECP256R1,
                                        mbedtls_ctr_drbg_random,
-                                       &pxSessionObj->xMbedDrbgCtx ) )
+                                       &xP11Module.xMbedDrbgCtx ) )
         {
             xResult = CKR_FUNCTION_FAILED;
         }
+
+        prvModuleUnlock();
     }
 
     /* Complete the wrapped key context. */
     if( 0 == xResult )
     {
-        xResult = prvSetupPkcs11SigningForMbedTls( pxSessionObj, pxNewKey );
+        xResult = prvSetupPkcs11SigningForMbedTls( pxNewKey );
     }
 
     /* Return the new private key. */
     if( 0 == xResult )
     {
-        if( NULL != pxSessionObj->pxCurrentKey )
-        {
-            prvFreeKey( pxSessionObj->pxCurrentKey );
-        }
+        prvKeyRelease( pxSessionObj->pxCurrentKey );
 
         pxSessionObj->pxCurrentKey = pxNewKey;
         *pxPrivateKey = ( CK_OBJECT_HANDLE )pxNewKey;
@@ -1587,6 +1915,70 @@ CK_DEFINE_FUNCTION( CK_RV, C_GenerateKeyPair )( CK_SESSION_HANDLE xSession,
     return xResult;
 }
 
+/**
+ * @brief Reseed the random number generator.
+ *
+ * The DRBG shared by all sessions is seeded only once, so this is how a
+ * long-lived caller gets fresh entropy into it. Fresh entropy is always drawn
+ * from the entropy source, and pucSeed, if given, is mixed in as additional
+ * input. A NULL seed of zero length therefore just forces a reseed.
+ */
+CK_DEFINE_FUNCTION( CK_RV, C_SeedRandom )( CK_SESSION_HANDLE xSession,
+                                           CK_BYTE_PTR pucSeed,
+                                           CK_ULONG ulSeedLen )
+{
+    CK_RV xResult = CKR_OK;
+
+    /*lint !e9072 It's OK to have different parameter name. */
+    if( NULL == prvSessionPointerFromHandle( xSession ) )
+    {
+        xResult = CKR_SESSION_HANDLE_INVALID;
+    }
+    else if( ( NULL == pucSeed ) && ( 0 != ulSeedLen ) )
+    {
+        xResult = CKR_ARGUMENTS_BAD;
+    }
+    else
+    {
+        xResult = prvModuleLock();
+    }
+
+    if( CKR_OK == xResult )
+    {
+        /* Opening the session seeded the DRBG. */
+        if( 0 != mbedtls_ctr_drbg_reseed( &xP11Module.xMbedDrbgCtx, pucSeed, ( size_t ) ulSeedLen ) )
+        {
+            xResult = CKR_FUNCTION_FAILED;
+        }
+        else
+        {
+            xP11Module.ulDrbgReseeds++;
+        }
+
+        prvModuleUnlock();
+    }
+
+    return xResult;
+}
+
+/**
+ * @brief Number of times C_SeedRandom has reseeded the DRBG.
+ */
+CK_ULONG ulPkcs11GetDrbgReseedCount( void )
+{
+    /* Reading a single word does not need the module lock. */
+    return xP11Module.ulDrbgReseeds;
+}
+
+/**
+ * @brief Number of times the stored objects have changed.
+ */
+CK_ULONG ulPkcs11GetObjectGeneration( void )
+{
+    /* Reading a single word does not need the module lock. */
+    return xP11Module.ulObjectGeneration;
+}
+
 /**
  * @brief Generate cryptographically random bytes.
  */
@@ -1595,20 +1987,37 @@ CK_DEFINE_FUNCTION( CK_RV, C_GenerateRandom )( CK_SESSION_HANDLE xSession,
                                                CK_ULONG ulRandomLen )
 {
     CK_RV xResult = CKR_OK;
-    /*lint !e9072 It's OK to have different parameter name. */
-    P11SessionPtr_t pxSessionObj = prvSessionPointerFromHandle( xSession );
+    P11SessionPtr_t pxSession = prvSessionPointerFromHandle( xSession );
 
-    if( ( NULL == pucRandomData ) ||
-        ( ulRandomLen == 0 ) )
+    /*lint !e9072 It's OK to have different parameter name. */
+    if( ( NULL == pxSession ) ||
+        ( CK_FALSE == pxSession->xOpened ) )
+    {
+        xResult = CKR_SESSION_HANDLE_INVALID;
+    }
+    else if( CK_FALSE == xP11Module.xDrbgSeeded )
+    {
+        /* The shared DRBG is seeded when the first session is opened. */
+        xResult = CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+    else if( ( NULL == pucRandomData ) ||
+             ( ulRandomLen == 0 ) )
     {
         xResult = CKR_ARGUMENTS_BAD;
     }
     else
     {
-        if( 0 != mbedtls_ctr_drbg_random( &pxSessionObj->xMbedDrbgCtx, pucRandomData, ulRandomLen ) )
+        xResult = prvModuleLock();
+    }
+
+    if( CKR_OK == xResult )
+    {
+        if( 0 != mbedtls_ctr_drbg_random( &xP11Module.xMbedDrbgCtx, pucRandomData, ulRandomLen ) )
         {
             xResult = CKR_FUNCTION_FAILED;
         }
+
+        prvModuleUnlock();
     }
 
     return xResult;
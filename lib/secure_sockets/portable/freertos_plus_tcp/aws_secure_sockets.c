@@ -32,9 +32,14 @@
 #include "aws_secure_sockets.h"
 #include "aws_tls.h"
 #include "task.h"
+#include "semphr.h"
 #include "aws_pkcs11.h"
 #include "aws_crypto.h"
 
+/* Number of buffers of a call to SOCKETS_Sendv() handed to the TLS or TCP
+ * layer at a time. */
+#define securesocketsSENDV_BATCH    ( 4 )
+
 /* Internal context structure. */
 typedef struct SSOCKETContext
 {
@@ -270,6 +275,86 @@ int32_t SOCKETS_Send( Socket_t xSocket,
 }
 /*-----------------------------------------------------------*/
 
+int32_t SOCKETS_Sendv( Socket_t xSocket,
+                       const SocketsIovec_t * pxVectors,
+                       size_t xVectorCount,
+                       uint32_t ulFlags )
+{
+    int32_t lStatus = SOCKETS_SOCKET_ERROR;
+    int32_t lSent;
+    SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) xSocket; /*lint !e9087 cast used for portability. */
+    TLSIovec_t xTLSVectors[ securesocketsSENDV_BATCH ];
+    struct freertos_iovec xTCPVectors[ securesocketsSENDV_BATCH ];
+    size_t xIndex;
+    size_t xBatch;
+    size_t xBatchLength;
+    size_t x;
+
+    if( ( xSocket != SOCKETS_INVALID_SOCKET ) &&
+        ( ( pxVectors != NULL ) || ( xVectorCount == 0 ) ) )
+    {
+        pxContext->xSendFlags = ( BaseType_t ) ulFlags;
+        lStatus = 0;
+
+        for( xIndex = 0; xIndex < xVectorCount; xIndex += xBatch )
+        {
+            xBatch = xVectorCount - xIndex;
+
+            if( xBatch > securesocketsSENDV_BATCH )
+            {
+                xBatch = securesocketsSENDV_BATCH;
+            }
+
+            xBatchLength = 0;
+
+            for( x = 0; x < xBatch; x++ )
+            {
+                xTLSVectors[ x ].pucData = ( const unsigned char * ) pxVectors[ xIndex + x ].pvBuffer;
+                xTLSVectors[ x ].xLength = pxVectors[ xIndex + x ].xLength;
+                xTCPVectors[ x ].pvBase = ( void * ) pxVectors[ xIndex + x ].pvBuffer; /*lint !e9005 FreeRTOS_sendv() does not write to the buffers. */
+                xTCPVectors[ x ].xLength = pxVectors[ xIndex + x ].xLength;
+                xBatchLength += pxVectors[ xIndex + x ].xLength;
+            }
+
+            if( pdTRUE == pxContext->xRequireTLS )
+            {
+                /* Send through TLS pipe, if negotiated. */
+                lSent = TLS_Sendv( pxContext->pvTLSContext, xTLSVectors, xBatch );
+            }
+            else
+            {
+                /* Send unencrypted. */
+                lSent = FreeRTOS_sendv( pxContext->xSocket, xTCPVectors, xBatch, pxContext->xSendFlags );
+            }
+
+            if( lSent < 0 )
+            {
+                /* Report the error unless some data already went out. */
+                if( lStatus == 0 )
+                {
+                    lStatus = lSent;
+                }
+
+                break;
+            }
+
+            lStatus += lSent;
+
+            if( ( size_t ) lSent != xBatchLength )
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        lStatus = SOCKETS_EINVAL;
+    }
+
+    return lStatus;
+}
+/*-----------------------------------------------------------*/
+
 int32_t SOCKETS_SetSockOpt( Socket_t xSocket,
                             int32_t lLevel,
                             int32_t lOptionName,
@@ -526,17 +611,86 @@ BaseType_t SOCKETS_Init( void )
 }
 /*-----------------------------------------------------------*/
 
-static CK_RV prvSocketsGetCryptoSession( CK_SESSION_HANDLE *pxSession,
-                                         CK_FUNCTION_LIST_PTR_PTR ppxFunctionList )
+/**
+ * @brief PKCS#11 session shared by the random number and sequence number
+ * helpers, and the mutex that serializes its use.
+ */
+static CK_SESSION_HANDLE xPkcs11Session = 0;
+static CK_FUNCTION_LIST_PTR pxPkcs11FunctionList = NULL;
+static SemaphoreHandle_t xPkcs11SessionMutex = NULL;
+
+/**
+ * @brief Random bytes handed out by ulRand().
+ *
+ * Values are taken from the active buffer inside a critical section that
+ * only copies four bytes. The generator runs outside of critical sections,
+ * filling the standby buffer, which is then swapped in.
+ */
+typedef struct RandomPool
+{
+    uint8_t ucBuffers[ 2 ][ socketsconfigRANDOM_POOL_SIZE ];
+    uint8_t * volatile pucActive;
+    volatile uint32_t ulNext;
+    uint32_t ulRefills;
+} RandomPool_t;
+
+static RandomPool_t xRandomPool = { { { 0 } }, NULL, socketsconfigRANDOM_POOL_SIZE, 0 };
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Takes the shared PKCS#11 session, opening it on first use.
+ *
+ * Waits at most socketsconfigCRYPTO_SESSION_WAIT_MS for another task to
+ * release the session, as the callers run in the IP-task.
+ *
+ * @param[out] pxSession Session handle.
+ * @param[out] ppxFunctionList PKCS#11 function list.
+ *
+ * @return CKR_OK if the session was taken. The session must then be
+ * released with prvSocketsGiveCryptoSession(). CKR_CANT_LOCK if another
+ * task held it for too long.
+ */
+static CK_RV prvSocketsTakeCryptoSession( CK_SESSION_HANDLE * pxSession,
+                                          CK_FUNCTION_LIST_PTR_PTR ppxFunctionList )
 {
     CK_RV xResult = 0;
     CK_C_GetFunctionList pxCkGetFunctionList = NULL;
-    static CK_SESSION_HANDLE xPkcs11Session = 0;
-    static CK_FUNCTION_LIST_PTR pxPkcs11FunctionList = NULL;
     CK_ULONG ulCount = 1;
     CK_SLOT_ID xSlotId = 0;
+    SemaphoreHandle_t xNewMutex;
+
+    if( NULL == xPkcs11SessionMutex )
+    {
+        xNewMutex = xSemaphoreCreateMutex();
 
-    portENTER_CRITICAL( );
+        if( NULL == xNewMutex )
+        {
+            return CKR_HOST_MEMORY;
+        }
+
+        /* Another task may have raced to create the mutex. */
+        portENTER_CRITICAL( );
+
+        if( NULL == xPkcs11SessionMutex )
+        {
+            xPkcs11SessionMutex = xNewMutex;
+            xNewMutex = NULL;
+        }
+
+        portEXIT_CRITICAL( );
+
+        if( NULL != xNewMutex )
+        {
+            vSemaphoreDelete( xNewMutex );
+        }
+    }
+
+    if( pdTRUE != xSemaphoreTake( xPkcs11SessionMutex,
+                                  pdMS_TO_TICKS( socketsconfigCRYPTO_SESSION_WAIT_MS ) ) )
+    {
+        return CKR_CANT_LOCK;
+    }
 
     if( 0 == xPkcs11Session )
     {
@@ -575,7 +729,10 @@ static CK_RV prvSocketsGetCryptoSession( CK_SESSION_HANDLE *pxSession,
         }
     }
 
-    portEXIT_CRITICAL( );
+    if( 0 != xResult )
+    {
+        ( void ) xSemaphoreGive( xPkcs11SessionMutex );
+    }
 
     /* Output the shared function pointers and session handle. */
     *ppxFunctionList = pxPkcs11FunctionList;
@@ -585,30 +742,113 @@ static CK_RV prvSocketsGetCryptoSession( CK_SESSION_HANDLE *pxSession,
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Releases the session taken by prvSocketsTakeCryptoSession().
+ */
+static void prvSocketsGiveCryptoSession( void )
+{
+    ( void ) xSemaphoreGive( xPkcs11SessionMutex );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Refills the random pool, unless another task did it meanwhile.
+ *
+ * Every socketsconfigRANDOM_RESEED_INTERVAL refills, the PKCS#11 module's
+ * generator is reseeded from the entropy source with C_SeedRandom.
+ *
+ * @return CKR_OK if the pool holds fresh bytes.
+ */
+static CK_RV prvRandomPoolRefill( void )
+{
+    CK_RV xResult;
+    CK_SESSION_HANDLE xSession = 0;
+    CK_FUNCTION_LIST_PTR pxFunctionList = NULL;
+    uint8_t * pucStandby;
+    BaseType_t xSessionTaken = pdFALSE;
+
+    xResult = prvSocketsTakeCryptoSession( &xSession, &pxFunctionList );
+
+    if( 0 == xResult )
+    {
+        xSessionTaken = pdTRUE;
+    }
+
+    if( ( 0 == xResult ) &&
+        ( xRandomPool.ulNext >= socketsconfigRANDOM_POOL_SIZE ) )
+    {
+        if( ( 0 != xRandomPool.ulRefills ) &&
+            ( 0 == ( xRandomPool.ulRefills % socketsconfigRANDOM_RESEED_INTERVAL ) ) )
+        {
+            xResult = pxFunctionList->C_SeedRandom( xSession, NULL, 0 );
+        }
+
+        /* Only the refilling task, which holds the session, uses the
+         * standby buffer. */
+        if( 0 == xResult )
+        {
+            pucStandby = ( xRandomPool.pucActive == xRandomPool.ucBuffers[ 0 ] ) ?
+                         xRandomPool.ucBuffers[ 1 ] : xRandomPool.ucBuffers[ 0 ];
+            xResult = pxFunctionList->C_GenerateRandom(
+                xSession,
+                pucStandby,
+                socketsconfigRANDOM_POOL_SIZE );
+
+            if( 0 == xResult )
+            {
+                portENTER_CRITICAL( );
+                xRandomPool.pucActive = pucStandby;
+                xRandomPool.ulNext = 0;
+                portEXIT_CRITICAL( );
+
+                xRandomPool.ulRefills++;
+            }
+        }
+    }
+
+    if( pdTRUE == xSessionTaken )
+    {
+        prvSocketsGiveCryptoSession();
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
 uint32_t ulRand( void )
 {
     CK_RV xResult = 0;
-    CK_SESSION_HANDLE xPkcs11Session = 0;
-    CK_FUNCTION_LIST_PTR pxPkcs11FunctionList = NULL;
     uint32_t ulRandomValue = 0;
+    BaseType_t xServed = pdFALSE;
 
-    xResult = prvSocketsGetCryptoSession( 
-        &xPkcs11Session,
-        &pxPkcs11FunctionList );
-
-    if( 0 == xResult )
+    while( ( pdFALSE == xServed ) && ( 0 == xResult ) )
     {
-        /* Request a sequence of cryptographically random byte values using
-         * PKCS#11. */
+        /* Take the next four bytes of the pool, wiping them so that a value
+         * is never handed out twice. */
         portENTER_CRITICAL( );
-        xResult = pxPkcs11FunctionList->C_GenerateRandom( 
-            xPkcs11Session,
-            ( CK_BYTE_PTR ) &ulRandomValue,
-            sizeof( ulRandomValue ) );
+
+        if( xRandomPool.ulNext < socketsconfigRANDOM_POOL_SIZE )
+        {
+            memcpy( &ulRandomValue,
+                    xRandomPool.pucActive + xRandomPool.ulNext,
+                    sizeof( ulRandomValue ) );
+            memset( xRandomPool.pucActive + xRandomPool.ulNext,
+                    0,
+                    sizeof( ulRandomValue ) );
+            xRandomPool.ulNext += sizeof( ulRandomValue );
+            xServed = pdTRUE;
+        }
+
         portEXIT_CRITICAL( );
+
+        if( pdFALSE == xServed )
+        {
+            xResult = prvRandomPoolRefill();
+        }
     }
 
-    /* Check if any of the API calls failed. */
+    /* Check if any of the API calls failed, or the session was busy. The
+     * TCP/IP stack treats 0 as a failed random number. */
     if( 0 != xResult )
     {
         ulRandomValue = 0;
@@ -629,56 +869,54 @@ uint32_t ulApplicationGetNextSequenceNumber(
     uint16_t usDestinationPort )
 {
     CK_RV xResult = 0;
-    CK_SESSION_HANDLE xPkcs11Session = 0;
-    CK_FUNCTION_LIST_PTR pxPkcs11FunctionList = NULL;
+    CK_SESSION_HANDLE xSession = 0;
+    CK_FUNCTION_LIST_PTR pxFunctionList = NULL;
+    BaseType_t xSessionTaken = pdFALSE;
     CK_MECHANISM xMechSha256 = { 0 };
     uint8_t ucSha256Result[ cryptoSHA256_DIGEST_BYTES ];
     CK_ULONG ulLength = sizeof( ucSha256Result );
     uint32_t ulNextSequenceNumber = 0;
     static uint64_t ullKey = 0;
 
-    /* Acquire a crypto session handle. */
-    xResult = prvSocketsGetCryptoSession( 
-        &xPkcs11Session,
-        &pxPkcs11FunctionList );
+    /* Acquire and lock the shared crypto session. */
+    xResult = prvSocketsTakeCryptoSession( 
+        &xSession,
+        &pxFunctionList );
 
     if( 0 == xResult )
     {
-        portENTER_CRITICAL( );
+        xSessionTaken = pdTRUE;
+
         if( 0 == ullKey )
         {
             /* One-time initialization, per boot, of the random seed. */
-            xResult = pxPkcs11FunctionList->C_GenerateRandom( 
-                xPkcs11Session,
+            xResult = pxFunctionList->C_GenerateRandom( 
+                xSession,
                 ( CK_BYTE_PTR )&ullKey,
                 sizeof( ullKey ) );
         }
-        portEXIT_CRITICAL( );
     }
 
-    /* Lock the shared crypto session. */
-    portENTER_CRITICAL( );
-
     /* Start a hash. */
     if( 0 == xResult )
     {
         xMechSha256.mechanism = CKM_SHA256;
-        xResult = pxPkcs11FunctionList->C_DigestInit( 
-            xPkcs11Session, &xMechSha256 );
+        xResult = pxFunctionList->C_DigestInit( 
+            xSession, &xMechSha256 );
     }
 
     /* Hash the seed. */
     if( 0 == xResult )
     {
-        xResult = pxPkcs11FunctionList->C_DigestUpdate( 
-            xPkcs11Session, ( CK_BYTE_PTR )&ullKey, sizeof( ullKey ) );
+        xResult = pxFunctionList->C_DigestUpdate( 
+            xSession, ( CK_BYTE_PTR )&ullKey, sizeof( ullKey ) );
     }
 
     /* Hash the source address. */
     if( 0 == xResult )
     {
-        xResult = pxPkcs11FunctionList->C_DigestUpdate(
-            xPkcs11Session,
+        xResult = pxFunctionList->C_DigestUpdate(
+            xSession,
             ( CK_BYTE_PTR )&ulSourceAddress,
             sizeof( ulSourceAddress ) );
     }
@@ -686,8 +924,8 @@ uint32_t ulApplicationGetNextSequenceNumber(
     /* Hash the source port. */
     if( 0 == xResult )
     {
-        xResult = pxPkcs11FunctionList->C_DigestUpdate(
-            xPkcs11Session,
+        xResult = pxFunctionList->C_DigestUpdate(
+            xSession,
             ( CK_BYTE_PTR )&usSourcePort,
             sizeof( usSourcePort ) );
     }
@@ -695,8 +933,8 @@ uint32_t ulApplicationGetNextSequenceNumber(
     /* Hash the destination address. */
     if( 0 == xResult )
     {
-        xResult = pxPkcs11FunctionList->C_DigestUpdate( 
-            xPkcs11Session, 
+        xResult = pxFunctionList->C_DigestUpdate( 
+            xSession, 
             ( CK_BYTE_PTR )&ulDestinationAddress, 
             sizeof( ulDestinationAddress ) );
     }
@@ -704,8 +942,8 @@ uint32_t ulApplicationGetNextSequenceNumber(
     /* Hash the destination port. */
     if( 0 == xResult )
     {
-        xResult = pxPkcs11FunctionList->C_DigestUpdate(
-            xPkcs11Session,
+        xResult = pxFunctionList->C_DigestUpdate(
+            xSession,
             ( CK_BYTE_PTR )&usDestinationPort,
             sizeof( usDestinationPort ) );
     }
@@ -713,13 +951,16 @@ uint32_t ulApplicationGetNextSequenceNumber(
     /* Get the hash. */
     if( 0 == xResult )
     {
-        xResult = pxPkcs11FunctionList->C_DigestFinal(
-            xPkcs11Session,
+        xResult = pxFunctionList->C_DigestFinal(
+            xSession,
             ucSha256Result,
             &ulLength );
     }
 
-    portEXIT_CRITICAL( );
+    if( pdTRUE == xSessionTaken )
+    {
+        prvSocketsGiveCryptoSession();
+    }
 
     /* Use the first four bytes of the hash result as the starting point for
     all initial sequence numbers for connections based on the input 4-tuple. */
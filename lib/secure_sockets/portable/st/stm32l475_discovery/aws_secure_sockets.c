@@ -833,6 +833,53 @@ int32_t SOCKETS_Send( Socket_t xSocket,
 }
 /*-----------------------------------------------------------*/
 
+int32_t SOCKETS_Sendv( Socket_t xSocket,
+                       const SocketsIovec_t * pxVectors,
+                       size_t xVectorCount,
+                       uint32_t ulFlags )
+{
+    int32_t lStatus = SOCKETS_EINVAL;
+    int32_t lSent;
+    size_t xIndex;
+
+    /* The buffers are handed to SOCKETS_Send() one at a time. */
+    if( ( pxVectors != NULL ) || ( xVectorCount == 0 ) )
+    {
+        lStatus = 0;
+
+        for( xIndex = 0; xIndex < xVectorCount; xIndex++ )
+        {
+            if( pxVectors[ xIndex ].xLength == 0 )
+            {
+                continue;
+            }
+
+            lSent = SOCKETS_Send( xSocket, pxVectors[ xIndex ].pvBuffer, pxVectors[ xIndex ].xLength, ulFlags );
+
+            if( lSent < 0 )
+            {
+                /* Report the error unless some data already went out. */
+                if( lStatus == 0 )
+                {
+                    lStatus = lSent;
+                }
+
+                break;
+            }
+
+            lStatus += lSent;
+
+            if( ( size_t ) lSent != pxVectors[ xIndex ].xLength )
+            {
+                break;
+            }
+        }
+    }
+
+    return lStatus;
+}
+/*-----------------------------------------------------------*/
+
 int32_t SOCKETS_Shutdown( Socket_t xSocket,
                           uint32_t ulHow )
 {
@@ -30,6 +30,7 @@
 #include "aws_crypto.h"
 #include "aws_pkcs11.h"
 #include "task.h"
+#include "semphr.h"
 #include "aws_clientcredential.h"
 #include "aws_default_root_certificates.h"
 
@@ -40,6 +41,7 @@
 #include "mbedtls/entropy.h"
 #include "mbedtls/sha256.h"
 #include "mbedtls/pk.h"
+#include "mbedtls/ssl_internal.h"
 #include "mbedtls/debug.h"
 #ifdef MBEDTLS_DEBUG_C
     #define tlsDEBUG_VERBOSE    4
@@ -50,6 +52,123 @@
 #include <time.h>
 #include <stdio.h>
 
+/**
+ * @brief Number of endpoints for which a resumable session is kept.
+ *
+ * Set to zero to disable session resumption and always perform a full
+ * handshake.
+ */
+#ifndef tlsconfigSESSION_CACHE_SIZE
+    #define tlsconfigSESSION_CACHE_SIZE    ( 2 )
+#endif
+
+/**
+ * @brief Maximum age in seconds of a cached session before it is discarded.
+ */
+#ifndef tlsconfigSESSION_LIFETIME_SECONDS
+    #define tlsconfigSESSION_LIFETIME_SECONDS    ( 24UL * 60UL * 60UL )
+#endif
+
+/**
+ * @brief Number of distinct parsed root CA chains kept for reuse.
+ */
+#ifndef tlsconfigTRUST_STORE_CACHE_SIZE
+    #define tlsconfigTRUST_STORE_CACHE_SIZE    ( 2 )
+#endif
+
+/**
+ * @brief Maximum record payload to negotiate with the server, in bytes.
+ *
+ * One of 512, 1024, 2048 or 4096 requests the Max Fragment Length extension,
+ * which keeps the records of both peers within that size. Zero does not
+ * request it.
+ *
+ * mbedTLS sizes the record buffers of every connection for
+ * MBEDTLS_SSL_MAX_CONTENT_LEN. A port shrinks them by lowering that setting to
+ * one of the sizes above in its mbedTLS configuration override, and by default
+ * the same size is then requested, so that servers which honor the extension
+ * keep their records within the smaller buffers.
+ */
+#ifndef tlsconfigMAX_FRAGMENT_LENGTH
+    #if !defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+        #define tlsconfigMAX_FRAGMENT_LENGTH    ( 0 )
+    #elif ( MBEDTLS_SSL_MAX_CONTENT_LEN == 512 ) || ( MBEDTLS_SSL_MAX_CONTENT_LEN == 1024 ) || \
+    ( MBEDTLS_SSL_MAX_CONTENT_LEN == 2048 ) || ( MBEDTLS_SSL_MAX_CONTENT_LEN == 4096 )
+        #define tlsconfigMAX_FRAGMENT_LENGTH    MBEDTLS_SSL_MAX_CONTENT_LEN
+    #else
+        #define tlsconfigMAX_FRAGMENT_LENGTH    ( 0 )
+    #endif
+#endif
+
+#if ( tlsconfigMAX_FRAGMENT_LENGTH == 0 )
+    #define tlsMAX_FRAG_LEN_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_NONE
+#elif ( tlsconfigMAX_FRAGMENT_LENGTH == 512 )
+    #define tlsMAX_FRAG_LEN_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_512
+#elif ( tlsconfigMAX_FRAGMENT_LENGTH == 1024 )
+    #define tlsMAX_FRAG_LEN_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_1024
+#elif ( tlsconfigMAX_FRAGMENT_LENGTH == 2048 )
+    #define tlsMAX_FRAG_LEN_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_2048
+#elif ( tlsconfigMAX_FRAGMENT_LENGTH == 4096 )
+    #define tlsMAX_FRAG_LEN_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_4096
+#else
+    #error "tlsconfigMAX_FRAGMENT_LENGTH must be 0, 512, 1024, 2048 or 4096."
+#endif
+
+#if ( tlsconfigMAX_FRAGMENT_LENGTH > MBEDTLS_SSL_MAX_CONTENT_LEN )
+    #error "tlsconfigMAX_FRAGMENT_LENGTH exceeds MBEDTLS_SSL_MAX_CONTENT_LEN."
+#endif
+
+#if ( tlsconfigMAX_FRAGMENT_LENGTH != 0 ) && !defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+    #error "tlsconfigMAX_FRAGMENT_LENGTH requires MBEDTLS_SSL_MAX_FRAGMENT_LENGTH."
+#endif
+
+/**
+ * @brief Set to 1 to keep the server certificate in memory for the lifetime
+ * of the connection. By default it is freed once the handshake completes,
+ * since nothing reads it afterwards and renegotiation is disabled.
+ */
+#ifndef tlsconfigKEEP_PEER_CERTIFICATE
+    #define tlsconfigKEEP_PEER_CERTIFICATE    ( 0 )
+#endif
+
+/**
+ * @brief Set to 0 if the PKCS#11 module does not provide
+ * ulPkcs11GetObjectGeneration(), which is not part of the standard. The client
+ * credential is then read from the module again for every connection, instead
+ * of being cached until the objects of the module change.
+ */
+#ifndef tlsconfigPKCS11_OBJECT_GENERATION
+    #define tlsconfigPKCS11_OBJECT_GENERATION    ( 1 )
+#endif
+
+/**
+ * @brief Size of the stack buffer TLS_Sendv() gathers small vectors in, so
+ * that a protocol header and a short payload go out in one record.
+ */
+#ifndef tlsconfigSENDV_GATHER_SIZE
+    #define tlsconfigSENDV_GATHER_SIZE    ( 256 )
+#endif
+
+/**
+ * @brief Set to 1 to have TLS_Sendv() copy the vectors straight into the
+ * mbedTLS output record instead of passing them to mbedtls_ssl_write().
+ *
+ * This saves a copy per record, but uses mbedTLS internals (the out_msg,
+ * out_msglen, out_msgtype and out_left fields and mbedtls_ssl_write_record())
+ * that are not part of its API, so it has to be checked again whenever mbedTLS
+ * is updated.
+ */
+#ifndef tlsconfigSENDV_IN_RECORD
+    #define tlsconfigSENDV_IN_RECORD    ( 0 )
+#endif
+
+/*
+ * If tlsconfigSESSION_CACHE_FILE_NAME is defined, the most recent session is
+ * also written through the PKCS#11 PAL under that file name and restored after
+ * a reset. The record holds the session master secret, so it should only be
+ * enabled on ports whose PAL storage protects it as well as the private key.
+ */
+
 /**
  * @brief Internal context structure.
  *
@@ -61,13 +180,8 @@
  * @param[in] pvCallerContext Opaque pointer provided by caller for above callbacks.
  * @param[out] mbedSslCtx Connection context for mbedTLS.
  * @param[out] mbedSslConfig Configuration context for mbedTLS.
- * @param[out] mbedX509CA Server certificate context for mbedTLS.
- * @param[out] mbedX509Cli Client certificate context for mbedTLS.
- * @param[out] mbedPkAltCtx RSA crypto implementation context for mbedTLS.
- * @param[out] pxP11FunctionList PKCS#11 function list structure.
- * @param[out] xP11Session PKCS#11 session context.
- * @param[out] xP11PrivateKey PKCS#11 private key context.
- * @param[out] ulP11ModulusBytes Number of bytes in the client private key modulus.
+ * @param[out] pxTrustStore Shared server certificate chain for mbedTLS.
+ * @param[out] pxCredential Shared client certificate and private key.
  */
 typedef struct TLSContext
 {
@@ -84,22 +198,148 @@ typedef struct TLSContext
     /* mbedTLS. */
     mbedtls_ssl_context mbedSslCtx;
     mbedtls_ssl_config mbedSslConfig;
-    mbedtls_x509_crt mbedX509CA;
-    mbedtls_x509_crt mbedX509Cli;
-    mbedtls_pk_context mbedPkCtx;
     BaseType_t xMbedInitialized;
 
-    /* PKCS#11. */
+    /* Shared credentials. */
+    struct TLSTrustStore * pxTrustStore;
+    struct TLSCredential * pxCredential;
+
+    /* Session resumption and handshake accounting. */
+    BaseType_t xSessionOffered;
+    size_t xOfferedSessionIdLength;
+    unsigned char ucOfferedSessionId[ 32 ];
+    uint32_t ulBytesSent;
+    uint32_t ulBytesReceived;
+} TLSContext_t;
+
+/**
+ * @brief Parsed root CA chain, shared read-only by the contexts that trust it.
+ *
+ * @param[in] ucDigest SHA-256 of the PEM data the chain was parsed from.
+ * @param[in] ulRefCount Number of contexts using the chain.
+ * @param[in] xCached pdTRUE while the chain is listed in the cache.
+ * @param[in] xChain Parsed certificate chain.
+ */
+typedef struct TLSTrustStore
+{
+    unsigned char ucDigest[ 32 ];
+    uint32_t ulRefCount;
+    BaseType_t xCached;
+    mbedtls_x509_crt xChain;
+} TLSTrustStore_t;
+
+/**
+ * @brief Client certificate chain and private key, shared by all contexts.
+ *
+ * The private key lives in a PKCS#11 session owned by this structure. The
+ * module serializes signatures with the key itself, so contexts use the
+ * exported key context as it is.
+ *
+ * @param[in] ulRefCount Number of contexts using the credential.
+ * @param[in] xCached pdTRUE until the credential is invalidated.
+ * @param[in] ulObjectGeneration PKCS#11 object generation it was loaded at.
+ * @param[in] pxP11FunctionList PKCS#11 function list structure.
+ * @param[in] xP11Session PKCS#11 session holding the private key.
+ * @param[in] xCertificateChain Client certificate and JITR issuer, if any.
+ * @param[in] xP11Key Private key context exported by the PKCS#11 module.
+ */
+typedef struct TLSCredential
+{
+    uint32_t ulRefCount;
+    BaseType_t xCached;
+    CK_ULONG ulObjectGeneration;
     CK_FUNCTION_LIST_PTR pxP11FunctionList;
     CK_SESSION_HANDLE xP11Session;
-    CK_OBJECT_HANDLE xP11PrivateKey;
-    CK_ULONG ulP11ModulusBytes;
-} TLSContext_t;
+    mbedtls_x509_crt xCertificateChain;
+    mbedtls_pk_context xP11Key;
+} TLSCredential_t;
+
+/**
+ * @brief Handshake counters shared by all TLS contexts.
+ */
+static TLSStats_t xTLSStats;
+
+/**
+ * @brief Cached root CA chains and client credential. Both caches and their
+ * reference counts are guarded by xCredentialCacheMutex.
+ */
+static TLSTrustStore_t * pxTrustStoreCache[ tlsconfigTRUST_STORE_CACHE_SIZE ];
+static TLSCredential_t * pxCachedCredential = NULL;
+static SemaphoreHandle_t xCredentialCacheMutex = NULL;
+
+/**
+ * @brief Serializes the use of the PKCS#11 session shared between contexts.
+ */
+static SemaphoreHandle_t xCredentialSessionMutex = NULL;
+
+#if ( tlsconfigSESSION_CACHE_SIZE > 0 )
+
+/**
+ * @brief A resumable session for one endpoint.
+ *
+ * @param[in] ulEndpointHash Hash of the server name, zero if the entry is empty.
+ * @param[in] xStoredTick Tick count at which the session was stored.
+ * @param[in] xSession Session parameters, without the peer certificate.
+ */
+    typedef struct TLSSessionCacheEntry
+    {
+        uint32_t ulEndpointHash;
+        TickType_t xStoredTick;
+        mbedtls_ssl_session xSession;
+    } TLSSessionCacheEntry_t;
+
+    static TLSSessionCacheEntry_t xSessionCache[ tlsconfigSESSION_CACHE_SIZE ];
+    static SemaphoreHandle_t xSessionCacheMutex = NULL;
+#endif /* if ( tlsconfigSESSION_CACHE_SIZE > 0 ) */
 
 /*
  * Helper routines.
  */
 
+static void prvTrustStoreRelease( TLSContext_t * pCtx );
+static void prvCredentialRelease( TLSContext_t * pCtx );
+static void prvCredentialUncache( void );
+
+/**
+ * @brief Takes a mutex that is created on first use.
+ *
+ * @param[in] pxMutex Mutex handle, NULL until the mutex is created.
+ *
+ * @return pdTRUE if the mutex was taken.
+ */
+static BaseType_t prvMutexTake( SemaphoreHandle_t * pxMutex )
+{
+    SemaphoreHandle_t xNewMutex;
+
+    if( NULL == *pxMutex )
+    {
+        xNewMutex = xSemaphoreCreateMutex();
+
+        if( NULL == xNewMutex )
+        {
+            return pdFALSE;
+        }
+
+        /* Another task may have raced to create the mutex. */
+        taskENTER_CRITICAL();
+
+        if( NULL == *pxMutex )
+        {
+            *pxMutex = xNewMutex;
+            xNewMutex = NULL;
+        }
+
+        taskEXIT_CRITICAL();
+
+        if( NULL != xNewMutex )
+        {
+            vSemaphoreDelete( xNewMutex );
+        }
+    }
+
+    return xSemaphoreTake( *pxMutex, portMAX_DELAY );
+}
+
 /**
  * @brief TLS internal context rundown helper routine.
  *
@@ -114,13 +354,9 @@ static void prvFreeContext( TLSContext_t * pCtx )
         mbedtls_ssl_free( &pCtx->mbedSslCtx );
         mbedtls_ssl_config_free( &pCtx->mbedSslConfig );
 
-        /* Cleanup PKCS#11. */
-        if( ( NULL != pCtx->pxP11FunctionList ) &&
-            ( NULL != pCtx->pxP11FunctionList->C_CloseSession ) )
-        {
-            pCtx->pxP11FunctionList->C_CloseSession( pCtx->xP11Session ); /*lint !e534 This function always return CKR_OK. */
-            pCtx->pxP11FunctionList->C_Finalize( NULL );                  /*lint !e534 This function always return CKR_OK. */
-        }
+        /* Drop the references to the shared credentials. */
+        prvTrustStoreRelease( pCtx );
+        prvCredentialRelease( pCtx );
 
         pCtx->xMbedInitialized = pdFALSE;
     }
@@ -140,8 +376,14 @@ static int prvNetworkSend( void * pvContext,
                            size_t xDataLength )
 {
     TLSContext_t * pCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    BaseType_t xSent = pCtx->pxNetworkSend( pCtx->pvCallerContext, pucData, xDataLength );
+
+    if( 0 < xSent )
+    {
+        pCtx->ulBytesSent += ( uint32_t ) xSent;
+    }
 
-    return ( int ) pCtx->pxNetworkSend( pCtx->pvCallerContext, pucData, xDataLength );
+    return ( int ) xSent;
 }
 
 /**
@@ -158,8 +400,14 @@ static int prvNetworkRecv( void * pvContext,
                            size_t xReceiveLength )
 {
     TLSContext_t * pCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    BaseType_t xReceived = pCtx->pxNetworkRecv( pCtx->pvCallerContext, pucReceiveBuffer, xReceiveLength );
 
-    return ( int ) pCtx->pxNetworkRecv( pCtx->pvCallerContext, pucReceiveBuffer, xReceiveLength );
+    if( 0 < xReceived )
+    {
+        pCtx->ulBytesReceived += ( uint32_t ) xReceived;
+    }
+
+    return ( int ) xReceived;
 }
 
 /**
@@ -176,8 +424,17 @@ static int prvGenerateRandomBytes( void * pvCtx,
                                    size_t xRandomLength )
 {
     TLSContext_t * pCtx = ( TLSContext_t * ) pvCtx; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    TLSCredential_t * pxCredential = pCtx->pxCredential;
+    int lResult = ( int ) CKR_CANT_LOCK;
+
+    /* The PKCS#11 session is shared with other connections. */
+    if( pdTRUE == prvMutexTake( &xCredentialSessionMutex ) )
+    {
+        lResult = ( int ) pxCredential->pxP11FunctionList->C_GenerateRandom( pxCredential->xP11Session, pucRandom, xRandomLength );
+        ( void ) xSemaphoreGive( xCredentialSessionMutex );
+    }
 
-    return ( int ) pCtx->pxP11FunctionList->C_GenerateRandom( pCtx->xP11Session, pucRandom, xRandomLength );
+    return lResult;
 }
 
 /**
@@ -246,15 +503,257 @@ static int prvCheckCertificate( void * pvCtx,
     return 0;
 }
 
+/**
+ * @brief Hashes the PEM data of the root CA chain a context will trust.
+ *
+ * @param[in] pCtx Caller context.
+ * @param[out] pucDigest SHA-256 of the PEM data.
+ *
+ * @return Zero on success.
+ */
+static int prvTrustStoreDigest( TLSContext_t * pCtx,
+                                unsigned char * pucDigest )
+{
+    int lResult;
+    mbedtls_sha256_context xSha256;
+
+    mbedtls_sha256_init( &xSha256 );
+    lResult = mbedtls_sha256_starts_ret( &xSha256, 0 );
+
+    if( NULL != pCtx->pcServerCertificate )
+    {
+        if( 0 == lResult )
+        {
+            lResult = mbedtls_sha256_update_ret( &xSha256,
+                                                 ( const unsigned char * ) pCtx->pcServerCertificate,
+                                                 pCtx->ulServerCertificateLength );
+        }
+    }
+    else
+    {
+        if( 0 == lResult )
+        {
+            lResult = mbedtls_sha256_update_ret( &xSha256,
+                                                 ( const unsigned char * ) tlsVERISIGN_ROOT_CERTIFICATE_PEM,
+                                                 tlsVERISIGN_ROOT_CERTIFICATE_LENGTH );
+        }
+
+        if( 0 == lResult )
+        {
+            lResult = mbedtls_sha256_update_ret( &xSha256,
+                                                 ( const unsigned char * ) tlsATS1_ROOT_CERTIFICATE_PEM,
+                                                 tlsATS1_ROOT_CERTIFICATE_LENGTH );
+        }
+    }
+
+    if( 0 == lResult )
+    {
+        lResult = mbedtls_sha256_finish_ret( &xSha256, pucDigest );
+    }
+
+    mbedtls_sha256_free( &xSha256 );
+
+    return lResult;
+}
+
+/**
+ * @brief Parses the root CA chain of a context: either the default or the
+ * override.
+ *
+ * @param[in] pCtx Caller context.
+ * @param[out] pxChain Initialized certificate chain to parse into.
+ *
+ * @return Zero on success.
+ */
+static int prvTrustStoreParse( TLSContext_t * pCtx,
+                               mbedtls_x509_crt * pxChain )
+{
+    int lResult;
+
+    if( NULL != pCtx->pcServerCertificate )
+    {
+        lResult = mbedtls_x509_crt_parse( pxChain,
+                                          ( const unsigned char * ) pCtx->pcServerCertificate,
+                                          pCtx->ulServerCertificateLength );
+    }
+    else
+    {
+        lResult = mbedtls_x509_crt_parse( pxChain,
+                                          ( const unsigned char * ) tlsVERISIGN_ROOT_CERTIFICATE_PEM,
+                                          tlsVERISIGN_ROOT_CERTIFICATE_LENGTH );
+
+        if( 0 == lResult )
+        {
+            lResult = mbedtls_x509_crt_parse( pxChain,
+                                              ( const unsigned char * ) tlsATS1_ROOT_CERTIFICATE_PEM,
+                                              tlsATS1_ROOT_CERTIFICATE_LENGTH );
+        }
+    }
+
+    return lResult;
+}
+
+/**
+ * @brief Frees a trust store.
+ *
+ * @param[in] pxTrustStore Trust store to free.
+ */
+static void prvTrustStoreFree( TLSTrustStore_t * pxTrustStore )
+{
+    mbedtls_x509_crt_free( &pxTrustStore->xChain );
+    vPortFree( pxTrustStore );
+}
+
+/**
+ * @brief Takes a reference to the parsed root CA chain of a context, parsing
+ * it only if no other context already did.
+ *
+ * When the cache is full and every cached chain is in use, the chain is
+ * parsed for this context alone and freed when the context releases it.
+ *
+ * @param[in] pCtx Caller context.
+ *
+ * @return Zero on success.
+ */
+static int prvTrustStoreAcquire( TLSContext_t * pCtx )
+{
+    int lResult;
+    uint32_t ulIndex;
+    unsigned char ucDigest[ 32 ];
+    TLSTrustStore_t * pxTrustStore = NULL;
+    TLSTrustStore_t ** ppxFreeSlot = NULL;
+
+    lResult = prvTrustStoreDigest( pCtx, ucDigest );
+
+    if( ( 0 == lResult ) && ( pdTRUE != prvMutexTake( &xCredentialCacheMutex ) ) )
+    {
+        lResult = ( int ) CKR_CANT_LOCK;
+    }
+
+    if( 0 != lResult )
+    {
+        return lResult;
+    }
+
+    for( ulIndex = 0; ulIndex < tlsconfigTRUST_STORE_CACHE_SIZE; ulIndex++ )
+    {
+        if( NULL == pxTrustStoreCache[ ulIndex ] )
+        {
+            ppxFreeSlot = &pxTrustStoreCache[ ulIndex ];
+        }
+        else if( 0 == memcmp( pxTrustStoreCache[ ulIndex ]->ucDigest, ucDigest, sizeof( ucDigest ) ) )
+        {
+            pxTrustStore = pxTrustStoreCache[ ulIndex ];
+            break;
+        }
+        else if( ( NULL == ppxFreeSlot ) && ( 0UL == pxTrustStoreCache[ ulIndex ]->ulRefCount ) )
+        {
+            ppxFreeSlot = &pxTrustStoreCache[ ulIndex ];
+        }
+    }
+
+    if( NULL == pxTrustStore )
+    {
+        /* Parse under the lock so that concurrent connections to the same
+         * endpoint wait for a single parse. */
+        pxTrustStore = ( TLSTrustStore_t * ) pvPortMalloc( sizeof( TLSTrustStore_t ) ); /*lint !e9087 !e9079 Allow casting void* to other types. */
+
+        if( NULL == pxTrustStore )
+        {
+            lResult = ( int ) CKR_HOST_MEMORY;
+        }
+        else
+        {
+            memset( pxTrustStore, 0, sizeof( TLSTrustStore_t ) );
+            memcpy( pxTrustStore->ucDigest, ucDigest, sizeof( ucDigest ) );
+            mbedtls_x509_crt_init( &pxTrustStore->xChain );
+            lResult = prvTrustStoreParse( pCtx, &pxTrustStore->xChain );
+
+            if( 0 != lResult )
+            {
+                prvTrustStoreFree( pxTrustStore );
+                pxTrustStore = NULL;
+            }
+        }
+
+        if( ( NULL != pxTrustStore ) && ( NULL != ppxFreeSlot ) )
+        {
+            /* Replace the unused chain held by the slot, if any. */
+            if( NULL != *ppxFreeSlot )
+            {
+                prvTrustStoreFree( *ppxFreeSlot );
+            }
+
+            *ppxFreeSlot = pxTrustStore;
+            pxTrustStore->xCached = pdTRUE;
+        }
+    }
+
+    if( NULL != pxTrustStore )
+    {
+        pxTrustStore->ulRefCount++;
+        pCtx->pxTrustStore = pxTrustStore;
+    }
+
+    ( void ) xSemaphoreGive( xCredentialCacheMutex );
+
+    return lResult;
+}
+
+/**
+ * @brief Drops the reference of a context to its root CA chain, if it holds
+ * one.
+ *
+ * @param[in] pCtx Caller context.
+ */
+static void prvTrustStoreRelease( TLSContext_t * pCtx )
+{
+    TLSTrustStore_t * pxTrustStore = pCtx->pxTrustStore;
+
+    if( ( NULL != pxTrustStore ) && ( pdTRUE == prvMutexTake( &xCredentialCacheMutex ) ) )
+    {
+        pCtx->pxTrustStore = NULL;
+        pxTrustStore->ulRefCount--;
+
+        /* Cached chains stay parsed for the next connection. */
+        if( ( 0UL == pxTrustStore->ulRefCount ) && ( pdFALSE == pxTrustStore->xCached ) )
+        {
+            prvTrustStoreFree( pxTrustStore );
+        }
+
+        ( void ) xSemaphoreGive( xCredentialCacheMutex );
+    }
+}
+
+/**
+ * @brief Frees a client credential and closes its PKCS#11 session.
+ *
+ * @param[in] pxCredential Credential to free.
+ */
+static void prvCredentialFree( TLSCredential_t * pxCredential )
+{
+    mbedtls_x509_crt_free( &pxCredential->xCertificateChain );
+
+    /* The key contexts belong to the PKCS#11 session. */
+    if( ( NULL != pxCredential->pxP11FunctionList ) &&
+        ( NULL != pxCredential->pxP11FunctionList->C_CloseSession ) )
+    {
+        pxCredential->pxP11FunctionList->C_CloseSession( pxCredential->xP11Session ); /*lint !e534 This function always return CKR_OK. */
+        pxCredential->pxP11FunctionList->C_Finalize( NULL );                          /*lint !e534 This function always return CKR_OK. */
+    }
+
+    vPortFree( pxCredential );
+}
+
 /**
  * @brief Helper for setting up potentially hardware-based cryptographic context
  * for the client TLS certificate and private key.
  *
- * @param Caller context.
+ * @param[out] pxCredential Zeroed credential to load.
  *
  * @return Zero on success.
  */
-static int prvInitializeClientCredential( TLSContext_t * pCtx )
+static int prvCredentialLoad( TLSCredential_t * pxCredential )
 {
     BaseType_t xResult = 0;
     CK_C_GetFunctionList pxCkGetFunctionList = NULL;
@@ -262,38 +761,45 @@ static int prvInitializeClientCredential( TLSContext_t * pCtx )
     CK_ULONG ulCount = 1;
     CK_ATTRIBUTE xTemplate = { 0 };
     CK_OBJECT_CLASS xObjClass = 0;
+    CK_OBJECT_HANDLE xP11PrivateKey = 0;
     CK_OBJECT_HANDLE xCertObj = 0;
     CK_BYTE * pucCertificate = NULL;
 
     /* Initialize the mbed contexts. */
-    mbedtls_x509_crt_init( &pCtx->mbedX509Cli );
+    mbedtls_x509_crt_init( &pxCredential->xCertificateChain );
+
+    /* Read the generation first, so that objects changing during the load
+     * cause another load on the next connect. */
+    #if ( tlsconfigPKCS11_OBJECT_GENERATION == 1 )
+        pxCredential->ulObjectGeneration = ulPkcs11GetObjectGeneration();
+    #endif
 
     /* Ensure that the PKCS#11 module is initialized. */
     if( 0 == xResult )
     {
         pxCkGetFunctionList = C_GetFunctionList;
-        xResult = ( BaseType_t ) pxCkGetFunctionList( &pCtx->pxP11FunctionList );
+        xResult = ( BaseType_t ) pxCkGetFunctionList( &pxCredential->pxP11FunctionList );
     }
 
     if( 0 == xResult )
     {
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_Initialize( NULL );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_Initialize( NULL );
     }
 
     /* Get the default private key storage ID. */
     if( 0 == xResult )
     {
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_GetSlotList( CK_TRUE, &xSlotId, &ulCount );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_GetSlotList( CK_TRUE, &xSlotId, &ulCount );
     }
 
     /* Start a private session with the P#11 module. */
     if( 0 == xResult )
     {
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_OpenSession( xSlotId,
-                                                                         CKF_SERIAL_SESSION,
-                                                                         NULL,
-                                                                         NULL,
-                                                                         &pCtx->xP11Session );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_OpenSession( xSlotId,
+                                                                                 CKF_SERIAL_SESSION,
+                                                                                 NULL,
+                                                                                 NULL,
+                                                                                 &pxCredential->xP11Session );
     }
 
     /* Enumerate the first private key. */
@@ -303,59 +809,47 @@ static int prvInitializeClientCredential( TLSContext_t * pCtx )
         xTemplate.ulValueLen = sizeof( CKA_CLASS );
         xTemplate.pValue = &xObjClass;
         xObjClass = CKO_PRIVATE_KEY;
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_FindObjectsInit( pCtx->xP11Session, &xTemplate, 1 );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_FindObjectsInit( pxCredential->xP11Session, &xTemplate, 1 );
     }
 
     if( 0 == xResult )
     {
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_FindObjects( pCtx->xP11Session, &pCtx->xP11PrivateKey, 1, &ulCount );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_FindObjects( pxCredential->xP11Session, &xP11PrivateKey, 1, &ulCount );
     }
 
     if( 0 == xResult )
     {
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_FindObjectsFinal( pCtx->xP11Session );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_FindObjectsFinal( pxCredential->xP11Session );
     }
 
     /* Get the internal key context. */
     if( 0 == xResult )
     {
         xTemplate.type = CKA_VENDOR_DEFINED;
-        xTemplate.ulValueLen = sizeof( pCtx->mbedPkCtx );
-        xTemplate.pValue = &pCtx->mbedPkCtx;
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_GetAttributeValue(
-            pCtx->xP11Session, pCtx->xP11PrivateKey, &xTemplate, 1 );
-    }
-
-    /* Get the key size. */
-    if( 0 == xResult )
-    {
-        xTemplate.type = CKA_MODULUS_BITS;
-        xTemplate.ulValueLen = sizeof( pCtx->ulP11ModulusBytes );
-        xTemplate.pValue = &pCtx->ulP11ModulusBytes;
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_GetAttributeValue(
-            pCtx->xP11Session, pCtx->xP11PrivateKey, &xTemplate, 1 );
+        xTemplate.ulValueLen = sizeof( pxCredential->xP11Key );
+        xTemplate.pValue = &pxCredential->xP11Key;
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_GetAttributeValue(
+            pxCredential->xP11Session, xP11PrivateKey, &xTemplate, 1 );
     }
 
     if( 0 == xResult )
     {
-        pCtx->ulP11ModulusBytes /= 8;
-
         /* Enumerate the first client certificate. */
         xTemplate.type = CKA_CLASS;
         xTemplate.ulValueLen = sizeof( CKA_CLASS );
         xTemplate.pValue = &xObjClass;
         xObjClass = CKO_CERTIFICATE;
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_FindObjectsInit( pCtx->xP11Session, &xTemplate, 1 );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_FindObjectsInit( pxCredential->xP11Session, &xTemplate, 1 );
     }
 
     if( 0 == xResult )
     {
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_FindObjects( pCtx->xP11Session, &xCertObj, 1, &ulCount );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_FindObjects( pxCredential->xP11Session, &xCertObj, 1, &ulCount );
     }
 
     if( 0 == xResult )
     {
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_FindObjectsFinal( pCtx->xP11Session );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_FindObjectsFinal( pxCredential->xP11Session );
     }
 
     if( 0 == xResult )
@@ -364,7 +858,7 @@ static int prvInitializeClientCredential( TLSContext_t * pCtx )
         xTemplate.type = CKA_VALUE;
         xTemplate.ulValueLen = 0;
         xTemplate.pValue = NULL;
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_GetAttributeValue( pCtx->xP11Session, xCertObj, &xTemplate, 1 );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_GetAttributeValue( pxCredential->xP11Session, xCertObj, &xTemplate, 1 );
     }
 
     if( 0 == xResult )
@@ -382,14 +876,14 @@ static int prvInitializeClientCredential( TLSContext_t * pCtx )
     {
         /* Export the certificate. */
         xTemplate.pValue = pucCertificate;
-        xResult = ( BaseType_t ) pCtx->pxP11FunctionList->C_GetAttributeValue(
-            pCtx->xP11Session, xCertObj, &xTemplate, 1 );
+        xResult = ( BaseType_t ) pxCredential->pxP11FunctionList->C_GetAttributeValue(
+            pxCredential->xP11Session, xCertObj, &xTemplate, 1 );
     }
 
     /* Decode the client certificate. */
     if( 0 == xResult )
     {
-        xResult = mbedtls_x509_crt_parse( &pCtx->mbedX509Cli,
+        xResult = mbedtls_x509_crt_parse( &pxCredential->xCertificateChain,
                                           ( const unsigned char * ) pucCertificate,
                                           xTemplate.ulValueLen );
     }
@@ -403,20 +897,11 @@ static int prvInitializeClientCredential( TLSContext_t * pCtx )
         /* Decode the JITR issuer. The device client certificate will get
          * inserted as the first certificate in this chain below. */
         xResult = mbedtls_x509_crt_parse(
-            &pCtx->mbedX509Cli,
+            &pxCredential->xCertificateChain,
             ( const unsigned char * ) clientcredentialJITR_DEVICE_CERTIFICATE_AUTHORITY_PEM,
             1 + strlen( clientcredentialJITR_DEVICE_CERTIFICATE_AUTHORITY_PEM ) );
     }
 
-    /*
-     * Attach the client certificate and private key to the TLS configuration.
-     */
-    if( 0 == xResult )
-    {
-        xResult = mbedtls_ssl_conf_own_cert(
-            &pCtx->mbedSslConfig, &pCtx->mbedX509Cli, &pCtx->mbedPkCtx );
-    }
-
     if( NULL != pucCertificate )
     {
         vPortFree( pucCertificate );
@@ -425,9 +910,855 @@ static int prvInitializeClientCredential( TLSContext_t * pCtx )
     return xResult;
 }
 
-/*
- * Interface routines.
- */
+/**
+ * @brief Takes a reference to the client credential, loading it from the
+ * PKCS#11 module only if no other context already did, and attaches it to
+ * the TLS configuration.
+ *
+ * @param[in] pCtx Caller context.
+ *
+ * @return Zero on success.
+ */
+static int prvCredentialAcquire( TLSContext_t * pCtx )
+{
+    int lResult = 0;
+    TLSCredential_t * pxCredential;
+
+    if( pdTRUE != prvMutexTake( &xCredentialCacheMutex ) )
+    {
+        return ( int ) CKR_CANT_LOCK;
+    }
+
+    /* Objects provisioned since the credential was loaded replace it.
+     * Without a generation to compare, it is always loaded again. */
+    #if ( tlsconfigPKCS11_OBJECT_GENERATION == 1 )
+        if( ( NULL != pxCachedCredential ) &&
+            ( pxCachedCredential->ulObjectGeneration != ulPkcs11GetObjectGeneration() ) )
+        {
+            prvCredentialUncache();
+        }
+    #else
+        prvCredentialUncache();
+    #endif
+
+    pxCredential = pxCachedCredential;
+
+    if( NULL == pxCredential )
+    {
+        pxCredential = ( TLSCredential_t * ) pvPortMalloc( sizeof( TLSCredential_t ) ); /*lint !e9087 !e9079 Allow casting void* to other types. */
+
+        if( NULL == pxCredential )
+        {
+            lResult = ( int ) CKR_HOST_MEMORY;
+        }
+        else
+        {
+            memset( pxCredential, 0, sizeof( TLSCredential_t ) );
+            lResult = prvCredentialLoad( pxCredential );
+
+            if( 0 == lResult )
+            {
+                pxCredential->xCached = pdTRUE;
+                pxCachedCredential = pxCredential;
+            }
+            else
+            {
+                prvCredentialFree( pxCredential );
+                pxCredential = NULL;
+            }
+        }
+    }
+
+    if( NULL != pxCredential )
+    {
+        pxCredential->ulRefCount++;
+        pCtx->pxCredential = pxCredential;
+    }
+
+    ( void ) xSemaphoreGive( xCredentialCacheMutex );
+
+    /*
+     * Attach the client certificate and private key to the TLS configuration.
+     */
+    if( 0 == lResult )
+    {
+        lResult = mbedtls_ssl_conf_own_cert( &pCtx->mbedSslConfig,
+                                             &pxCredential->xCertificateChain,
+                                             &pxCredential->xP11Key );
+    }
+
+    return lResult;
+}
+
+/**
+ * @brief Drops the reference of a context to the client credential, if it
+ * holds one.
+ *
+ * @param[in] pCtx Caller context.
+ */
+static void prvCredentialRelease( TLSContext_t * pCtx )
+{
+    TLSCredential_t * pxCredential = pCtx->pxCredential;
+
+    if( ( NULL != pxCredential ) && ( pdTRUE == prvMutexTake( &xCredentialCacheMutex ) ) )
+    {
+        pCtx->pxCredential = NULL;
+        pxCredential->ulRefCount--;
+
+        /* The cached credential stays loaded for the next connection. */
+        if( ( 0UL == pxCredential->ulRefCount ) && ( pdFALSE == pxCredential->xCached ) )
+        {
+            prvCredentialFree( pxCredential );
+        }
+
+        ( void ) xSemaphoreGive( xCredentialCacheMutex );
+    }
+}
+
+/**
+ * @brief Removes the client credential from the cache. Connections still
+ * using it keep it until they close. The caller holds xCredentialCacheMutex.
+ */
+static void prvCredentialUncache( void )
+{
+    if( NULL != pxCachedCredential )
+    {
+        pxCachedCredential->xCached = pdFALSE;
+
+        if( 0UL == pxCachedCredential->ulRefCount )
+        {
+            prvCredentialFree( pxCachedCredential );
+        }
+
+        pxCachedCredential = NULL;
+    }
+}
+
+#if ( tlsconfigSESSION_CACHE_SIZE > 0 )
+
+    #ifdef tlsconfigSESSION_CACHE_FILE_NAME
+
+/**
+ * @brief Write file to filesystem (see PAL).
+ */
+        extern BaseType_t PKCS11_PAL_SaveFile( char * pcFileName,
+                                               uint8_t * pucData,
+                                               uint32_t ulDataSize );
+
+/**
+ * @brief Read file from filesystem (see PAL).
+ */
+        extern BaseType_t PKCS11_PAL_ReadFile( char * pcFileName,
+                                               uint8_t ** ppucData,
+                                               uint32_t * pulDataSize );
+
+/**
+ * @brief Free the buffer allocated in PKCS11_PAL_ReadFile (see PAL).
+ */
+        extern void PKCS11_PAL_ReleaseFileData( uint8_t * pucBuffer,
+                                                uint32_t ulBufferSize );
+
+/**
+ * @brief Identifies a stored session record of this layout.
+ */
+        #define tlsSESSION_RECORD_MAGIC    ( 0x544C5301UL )
+
+/**
+ * @brief Fixed part of a stored session record. A session ticket, if any,
+ * follows it directly.
+ */
+        typedef struct TLSSessionRecord
+        {
+            uint32_t ulMagic;
+            uint32_t ulEndpointHash;
+            int32_t lCiphersuite;
+            int32_t lCompression;
+            uint32_t ulIdLength;
+            uint8_t ucId[ 32 ];
+            uint8_t ucMaster[ 48 ];
+            uint32_t ulTicketLength;
+            uint32_t ulTicketLifetime;
+        } TLSSessionRecord_t;
+
+/**
+ * @brief Clears memory that held session secrets, in a way the compiler
+ * cannot optimize out.
+ *
+ * @param[in] pvBuffer Memory to clear.
+ * @param[in] xLength Length in bytes of the memory.
+ */
+        static void prvSessionRecordZeroize( void * pvBuffer,
+                                             size_t xLength )
+        {
+            volatile uint8_t * pucBuffer = ( volatile uint8_t * ) pvBuffer; /*lint !e9087 !e9079 Allow casting void* to other types. */
+
+            while( 0 != xLength-- )
+            {
+                *pucBuffer++ = 0;
+            }
+        }
+    #endif /* ifdef tlsconfigSESSION_CACHE_FILE_NAME */
+
+/**
+ * @brief Hashes a server name into a session cache key (FNV-1a).
+ *
+ * Collisions are harmless: the server rejects a session it did not issue and
+ * a full handshake takes place.
+ *
+ * @param[in] pcDestination Server name.
+ *
+ * @return Non-zero hash of the server name.
+ */
+    static uint32_t prvSessionCacheHash( const char * pcDestination )
+    {
+        uint32_t ulHash = 2166136261UL;
+
+        while( '\0' != *pcDestination )
+        {
+            ulHash ^= ( uint8_t ) *pcDestination++;
+            ulHash *= 16777619UL;
+        }
+
+        /* Zero marks an empty entry. */
+        return ( 0UL == ulHash ) ? 1UL : ulHash;
+    }
+
+/**
+ * @brief Takes the session cache lock, creating it on first use.
+ *
+ * @return pdTRUE if the lock was taken.
+ */
+    static BaseType_t prvSessionCacheLock( void )
+    {
+        return prvMutexTake( &xSessionCacheMutex );
+    }
+
+/**
+ * @brief Releases the session cache lock.
+ */
+    static void prvSessionCacheUnlock( void )
+    {
+        ( void ) xSemaphoreGive( xSessionCacheMutex );
+    }
+
+/**
+ * @brief Empties a session cache entry.
+ *
+ * @param[in] pxEntry Entry to empty.
+ */
+    static void prvSessionCacheEvict( TLSSessionCacheEntry_t * pxEntry )
+    {
+        mbedtls_ssl_session_free( &pxEntry->xSession );
+        pxEntry->ulEndpointHash = 0;
+    }
+
+    #ifdef tlsconfigSESSION_CACHE_FILE_NAME
+
+/**
+ * @brief Writes a cached session through the PKCS#11 PAL.
+ *
+ * @param[in] pxEntry Entry to write.
+ */
+        static void prvSessionCacheSave( TLSSessionCacheEntry_t * pxEntry )
+        {
+            TLSSessionRecord_t * pxRecord;
+            uint32_t ulTicketLength = 0;
+            uint32_t ulRecordLength;
+
+            #if defined( MBEDTLS_SSL_SESSION_TICKETS )
+                ulTicketLength = ( uint32_t ) pxEntry->xSession.ticket_len;
+            #endif
+
+            ulRecordLength = sizeof( TLSSessionRecord_t ) + ulTicketLength;
+            pxRecord = ( TLSSessionRecord_t * ) pvPortMalloc( ulRecordLength ); /*lint !e9087 !e9079 Allow casting void* to other types. */
+
+            if( NULL != pxRecord )
+            {
+                memset( pxRecord, 0, sizeof( TLSSessionRecord_t ) );
+                pxRecord->ulMagic = tlsSESSION_RECORD_MAGIC;
+                pxRecord->ulEndpointHash = pxEntry->ulEndpointHash;
+                pxRecord->lCiphersuite = ( int32_t ) pxEntry->xSession.ciphersuite;
+                pxRecord->lCompression = ( int32_t ) pxEntry->xSession.compression;
+                pxRecord->ulIdLength = ( uint32_t ) pxEntry->xSession.id_len;
+                memcpy( pxRecord->ucId, pxEntry->xSession.id, sizeof( pxRecord->ucId ) );
+                memcpy( pxRecord->ucMaster, pxEntry->xSession.master, sizeof( pxRecord->ucMaster ) );
+                pxRecord->ulTicketLength = ulTicketLength;
+
+                #if defined( MBEDTLS_SSL_SESSION_TICKETS )
+                    pxRecord->ulTicketLifetime = pxEntry->xSession.ticket_lifetime;
+
+                    if( 0 != ulTicketLength )
+                    {
+                        memcpy( pxRecord + 1, pxEntry->xSession.ticket, ulTicketLength );
+                    }
+                #endif
+
+                ( void ) PKCS11_PAL_SaveFile( tlsconfigSESSION_CACHE_FILE_NAME,
+                                              ( uint8_t * ) pxRecord,
+                                              ulRecordLength );
+
+                prvSessionRecordZeroize( pxRecord, ulRecordLength );
+                vPortFree( pxRecord );
+            }
+        }
+
+/**
+ * @brief Restores the session written by prvSessionCacheSave into the first
+ * cache entry.
+ */
+        static void prvSessionCacheLoad( void )
+        {
+            uint8_t * pucData = NULL;
+            uint32_t ulDataLength = 0;
+            TLSSessionRecord_t xRecord;
+            TLSSessionCacheEntry_t * pxEntry = &xSessionCache[ 0 ];
+
+            if( pdFALSE == PKCS11_PAL_ReadFile( tlsconfigSESSION_CACHE_FILE_NAME,
+                                                &pucData,
+                                                &ulDataLength ) )
+            {
+                return;
+            }
+
+            if( ulDataLength >= sizeof( TLSSessionRecord_t ) )
+            {
+                memcpy( &xRecord, pucData, sizeof( TLSSessionRecord_t ) );
+
+                /* Reject records of another layout or that do not add up. */
+                if( ( tlsSESSION_RECORD_MAGIC == xRecord.ulMagic ) &&
+                    ( 0UL != xRecord.ulEndpointHash ) &&
+                    ( xRecord.ulIdLength <= sizeof( xRecord.ucId ) ) &&
+                    ( ( ulDataLength - sizeof( TLSSessionRecord_t ) ) == xRecord.ulTicketLength ) )
+                {
+                    prvSessionCacheEvict( pxEntry );
+                    mbedtls_ssl_session_init( &pxEntry->xSession );
+                    pxEntry->xSession.ciphersuite = ( int ) xRecord.lCiphersuite;
+                    pxEntry->xSession.compression = ( int ) xRecord.lCompression;
+                    pxEntry->xSession.id_len = ( size_t ) xRecord.ulIdLength;
+                    memcpy( pxEntry->xSession.id, xRecord.ucId, sizeof( xRecord.ucId ) );
+                    memcpy( pxEntry->xSession.master, xRecord.ucMaster, sizeof( xRecord.ucMaster ) );
+
+                    #if defined( MBEDTLS_SSL_SESSION_TICKETS )
+                        if( 0 != xRecord.ulTicketLength )
+                        {
+                            pxEntry->xSession.ticket = mbedtls_calloc( 1, xRecord.ulTicketLength );
+
+                            if( NULL != pxEntry->xSession.ticket )
+                            {
+                                memcpy( pxEntry->xSession.ticket,
+                                        pucData + sizeof( TLSSessionRecord_t ),
+                                        xRecord.ulTicketLength );
+                                pxEntry->xSession.ticket_len = xRecord.ulTicketLength;
+                                pxEntry->xSession.ticket_lifetime = xRecord.ulTicketLifetime;
+                            }
+                        }
+                    #endif
+
+                    pxEntry->ulEndpointHash = xRecord.ulEndpointHash;
+                    pxEntry->xStoredTick = xTaskGetTickCount();
+                }
+
+                prvSessionRecordZeroize( &xRecord, sizeof( xRecord ) );
+            }
+
+            prvSessionRecordZeroize( pucData, ulDataLength );
+            PKCS11_PAL_ReleaseFileData( pucData, ulDataLength );
+        }
+    #endif /* ifdef tlsconfigSESSION_CACHE_FILE_NAME */
+
+/**
+ * @brief Finds the live cache entry of an endpoint. Expired entries are
+ * emptied along the way. The caller must hold the cache lock.
+ *
+ * @param[in] ulEndpointHash Hash of the server name.
+ *
+ * @return The entry, or NULL if there is none.
+ */
+    static TLSSessionCacheEntry_t * prvSessionCacheFind( uint32_t ulEndpointHash )
+    {
+        TLSSessionCacheEntry_t * pxFound = NULL;
+        TickType_t xNow = xTaskGetTickCount();
+        BaseType_t x;
+
+        #ifdef tlsconfigSESSION_CACHE_FILE_NAME
+            static BaseType_t xSessionLoaded = pdFALSE;
+
+            if( pdFALSE == xSessionLoaded )
+            {
+                xSessionLoaded = pdTRUE;
+                prvSessionCacheLoad();
+            }
+        #endif
+
+        for( x = 0; x < tlsconfigSESSION_CACHE_SIZE; x++ )
+        {
+            if( 0UL == xSessionCache[ x ].ulEndpointHash )
+            {
+                continue;
+            }
+
+            if( ( ( xNow - xSessionCache[ x ].xStoredTick ) / configTICK_RATE_HZ ) >
+                tlsconfigSESSION_LIFETIME_SECONDS )
+            {
+                prvSessionCacheEvict( &xSessionCache[ x ] );
+            }
+            else if( ulEndpointHash == xSessionCache[ x ].ulEndpointHash )
+            {
+                pxFound = &xSessionCache[ x ];
+            }
+        }
+
+        return pxFound;
+    }
+
+/**
+ * @brief Offers the cached session of the endpoint, if any, for resumption.
+ *
+ * @param[in] pCtx Caller context, after mbedtls_ssl_setup.
+ */
+    static void prvSessionCacheOffer( TLSContext_t * pCtx )
+    {
+        TLSSessionCacheEntry_t * pxEntry;
+
+        if( ( NULL == pCtx->pcDestination ) || ( pdFALSE == prvSessionCacheLock() ) )
+        {
+            return;
+        }
+
+        pxEntry = prvSessionCacheFind( prvSessionCacheHash( pCtx->pcDestination ) );
+
+        if( ( NULL != pxEntry ) &&
+            ( 0 == mbedtls_ssl_set_session( &pCtx->mbedSslCtx, &pxEntry->xSession ) ) )
+        {
+            /* The server echoes this ID if it agrees to resume. */
+            pCtx->xSessionOffered = pdTRUE;
+            pCtx->xOfferedSessionIdLength = pxEntry->xSession.id_len;
+            memcpy( pCtx->ucOfferedSessionId,
+                    pxEntry->xSession.id,
+                    sizeof( pCtx->ucOfferedSessionId ) );
+        }
+
+        prvSessionCacheUnlock();
+    }
+
+/**
+ * @brief Stores the negotiated session of the endpoint after a successful
+ * handshake, replacing its previous entry or else the oldest one.
+ *
+ * @param[in] pCtx Caller context.
+ */
+    static void prvSessionCacheStore( TLSContext_t * pCtx )
+    {
+        TLSSessionCacheEntry_t * pxEntry;
+        uint32_t ulEndpointHash;
+        TickType_t xNow = xTaskGetTickCount();
+        BaseType_t x;
+
+        if( ( NULL == pCtx->pcDestination ) || ( pdFALSE == prvSessionCacheLock() ) )
+        {
+            return;
+        }
+
+        ulEndpointHash = prvSessionCacheHash( pCtx->pcDestination );
+        pxEntry = prvSessionCacheFind( ulEndpointHash );
+
+        for( x = 0; ( NULL == pxEntry ) && ( x < tlsconfigSESSION_CACHE_SIZE ); x++ )
+        {
+            if( 0UL == xSessionCache[ x ].ulEndpointHash )
+            {
+                pxEntry = &xSessionCache[ x ];
+            }
+        }
+
+        if( NULL == pxEntry )
+        {
+            pxEntry = &xSessionCache[ 0 ];
+
+            for( x = 1; x < tlsconfigSESSION_CACHE_SIZE; x++ )
+            {
+                if( ( xNow - xSessionCache[ x ].xStoredTick ) > ( xNow - pxEntry->xStoredTick ) )
+                {
+                    pxEntry = &xSessionCache[ x ];
+                }
+            }
+        }
+
+        prvSessionCacheEvict( pxEntry );
+        mbedtls_ssl_session_init( &pxEntry->xSession );
+
+        if( 0 == mbedtls_ssl_get_session( &pCtx->mbedSslCtx, &pxEntry->xSession ) )
+        {
+            /* Resumption does not need the server certificate, so don't keep a
+             * parsed copy of it around. */
+            #if defined( MBEDTLS_X509_CRT_PARSE_C )
+                if( NULL != pxEntry->xSession.peer_cert )
+                {
+                    mbedtls_x509_crt_free( pxEntry->xSession.peer_cert );
+                    mbedtls_free( pxEntry->xSession.peer_cert );
+                    pxEntry->xSession.peer_cert = NULL;
+                }
+            #endif
+
+            pxEntry->ulEndpointHash = ulEndpointHash;
+            pxEntry->xStoredTick = xNow;
+
+            #ifdef tlsconfigSESSION_CACHE_FILE_NAME
+                prvSessionCacheSave( pxEntry );
+            #endif
+        }
+        else
+        {
+            prvSessionCacheEvict( pxEntry );
+        }
+
+        prvSessionCacheUnlock();
+    }
+
+/**
+ * @brief Drops the cached session of the endpoint after a failed handshake, so
+ * that the next attempt starts from a full handshake.
+ *
+ * @param[in] pCtx Caller context.
+ */
+    static void prvSessionCacheRemove( TLSContext_t * pCtx )
+    {
+        TLSSessionCacheEntry_t * pxEntry;
+
+        if( ( NULL == pCtx->pcDestination ) || ( pdFALSE == prvSessionCacheLock() ) )
+        {
+            return;
+        }
+
+        pxEntry = prvSessionCacheFind( prvSessionCacheHash( pCtx->pcDestination ) );
+
+        if( NULL != pxEntry )
+        {
+            prvSessionCacheEvict( pxEntry );
+        }
+
+        prvSessionCacheUnlock();
+    }
+
+#endif /* if ( tlsconfigSESSION_CACHE_SIZE > 0 ) */
+
+/**
+ * @brief Accounts for a completed handshake attempt and updates the session
+ * cache with its outcome.
+ *
+ * @param[in] pCtx Caller context, before it is freed on failure.
+ * @param[in] xResult Handshake result.
+ * @param[in] xElapsedTicks Time spent in the handshake.
+ */
+static void prvHandshakeComplete( TLSContext_t * pCtx,
+                                  BaseType_t xResult,
+                                  TickType_t xElapsedTicks )
+{
+    BaseType_t xResumed = pdFALSE;
+
+    if( ( 0 == xResult ) && ( pdTRUE == pCtx->xSessionOffered ) )
+    {
+        xResumed = ( pCtx->mbedSslCtx.session->id_len == pCtx->xOfferedSessionIdLength ) &&
+                   ( 0 == memcmp( pCtx->mbedSslCtx.session->id,
+                                  pCtx->ucOfferedSessionId,
+                                  pCtx->xOfferedSessionIdLength ) );
+    }
+
+    #if ( tlsconfigSESSION_CACHE_SIZE > 0 )
+        if( 0 == xResult )
+        {
+            /* Keep the latest session, which may carry a fresh ticket. */
+            prvSessionCacheStore( pCtx );
+        }
+        else if( pdTRUE == pCtx->xSessionOffered )
+        {
+            prvSessionCacheRemove( pCtx );
+        }
+    #endif
+
+    taskENTER_CRITICAL();
+    {
+        if( 0 != xResult )
+        {
+            xTLSStats.ulFailedHandshakes++;
+        }
+        else if( pdTRUE == xResumed )
+        {
+            xTLSStats.ulResumedHandshakes++;
+        }
+        else
+        {
+            xTLSStats.ulFullHandshakes++;
+        }
+
+        xTLSStats.ulHandshakeTicks += ( uint32_t ) xElapsedTicks;
+        xTLSStats.ulHandshakeBytesSent += pCtx->ulBytesSent;
+        xTLSStats.ulHandshakeBytesReceived += pCtx->ulBytesReceived;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Writes a buffer with mbedtls_ssl_write(), retrying while the
+ * network asks to.
+ *
+ * @param[in] pCtx Caller context.
+ * @param[in] pucData Data to send.
+ * @param[in] xLength Length in bytes of the data.
+ * @param[out] pxSent Number of bytes sent, also when an error is returned.
+ *
+ * @return The last result of mbedtls_ssl_write(): negative on a hard error,
+ * zero if a non-blocking socket took nothing, positive otherwise.
+ */
+static BaseType_t prvSslWrite( TLSContext_t * pCtx,
+                               const unsigned char * pucData,
+                               size_t xLength,
+                               size_t * pxSent )
+{
+    BaseType_t xResult = 0;
+
+    *pxSent = 0;
+
+    while( *pxSent < xLength )
+    {
+        xResult = mbedtls_ssl_write( &pCtx->mbedSslCtx,
+                                     pucData + *pxSent,
+                                     xLength - *pxSent );
+
+        if( 0 < xResult )
+        {
+            /* Sent data, so update the tally and keep looping. */
+            *pxSent += ( size_t ) xResult;
+        }
+        else if( 0 == xResult )
+        {
+            /* No data sent (and no error). The secure sockets
+            API supports non-blocking send, so stop the loop but don't
+            flag an error. */
+            break;
+        }
+        else if( MBEDTLS_ERR_SSL_WANT_WRITE != xResult )
+        {
+            /* Hard error. */
+            break;
+        }
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Sends the vectors of TLS_Sendv() with mbedtls_ssl_write().
+ *
+ * Runs of vectors that fit in tlsconfigSENDV_GATHER_SIZE bytes are gathered
+ * and written together; larger vectors are written from the caller's buffer.
+ *
+ * @param[in] pCtx Caller context.
+ * @param[in] pxVectors Segments to send, in order.
+ * @param[in] xVectorCount Number of entries in pxVectors.
+ * @param[in,out] pxWritten Incremented by the number of bytes sent.
+ *
+ * @return Negative on a hard error, otherwise zero or positive.
+ */
+static BaseType_t prvSendvGather( TLSContext_t * pCtx,
+                                  const TLSIovec_t * pxVectors,
+                                  size_t xVectorCount,
+                                  size_t * pxWritten )
+{
+    BaseType_t xResult = 0;
+    unsigned char ucGather[ tlsconfigSENDV_GATHER_SIZE ];
+    size_t xGathered = 0;
+    size_t xIndex;
+    size_t xSent;
+
+    for( xIndex = 0; xIndex <= xVectorCount; xIndex++ )
+    {
+        /* Flush the gathered vectors before one that does not fit with them,
+         * and after the last one. */
+        if( ( 0 != xGathered ) &&
+            ( ( xIndex == xVectorCount ) ||
+              ( pxVectors[ xIndex ].xLength > sizeof( ucGather ) - xGathered ) ) )
+        {
+            xResult = prvSslWrite( pCtx, ucGather, xGathered, &xSent );
+            *pxWritten += xSent;
+
+            if( ( 0 > xResult ) || ( xSent != xGathered ) )
+            {
+                break;
+            }
+
+            xGathered = 0;
+        }
+
+        if( xIndex == xVectorCount )
+        {
+            break;
+        }
+
+        if( pxVectors[ xIndex ].xLength <= sizeof( ucGather ) - xGathered )
+        {
+            if( 0 != pxVectors[ xIndex ].xLength )
+            {
+                memcpy( &ucGather[ xGathered ], pxVectors[ xIndex ].pucData, pxVectors[ xIndex ].xLength );
+                xGathered += pxVectors[ xIndex ].xLength;
+            }
+        }
+        else
+        {
+            xResult = prvSslWrite( pCtx, pxVectors[ xIndex ].pucData, pxVectors[ xIndex ].xLength, &xSent );
+            *pxWritten += xSent;
+
+            if( ( 0 > xResult ) || ( xSent != pxVectors[ xIndex ].xLength ) )
+            {
+                break;
+            }
+        }
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( tlsconfigSENDV_IN_RECORD == 1 )
+
+/**
+ * @brief Sends the vectors of TLS_Sendv() by copying them straight into the
+ * mbedTLS output record.
+ *
+ * This is ssl_write_real() of mbedTLS with the memcpy() of the caller's
+ * buffer replaced by a gather of the vectors, so each record is copied once,
+ * from the vectors into the record buffer.
+ *
+ * @param[in] pCtx Caller context.
+ * @param[in] pxVectors Segments to send, in order.
+ * @param[in] xVectorCount Number of entries in pxVectors.
+ * @param[in] xTotal Sum of the lengths of the vectors.
+ * @param[in,out] pxWritten Incremented by the number of bytes sent.
+ *
+ * @return Negative on a hard error, otherwise zero or positive.
+ */
+    static BaseType_t prvSendvInRecord( TLSContext_t * pCtx,
+                                        const TLSIovec_t * pxVectors,
+                                        size_t xVectorCount,
+                                        size_t xTotal,
+                                        size_t * pxWritten )
+    {
+        BaseType_t xResult = 0;
+        mbedtls_ssl_context * pxSsl = &pCtx->mbedSslCtx;
+        size_t xDone = 0;
+        size_t xPending = 0;
+        size_t xMaxRecord;
+        size_t xRecord;
+        size_t xCopy;
+        size_t xIndex;
+        size_t xVector = 0;
+        size_t xOffset = 0;
+        BaseType_t xInPlace;
+
+        #if defined( MBEDTLS_SSL_RENEGOTIATION ) || defined( MBEDTLS_SSL_CBC_RECORD_SPLITTING )
+            /* mbedtls_ssl_write() may have to renegotiate or split the record,
+             * so it has to see the data itself. */
+            xInPlace = pdFALSE;
+        #else
+            /* The records can only be built in place once the handshake is
+             * over, otherwise mbedtls_ssl_write() completes it first. */
+            xInPlace = ( MBEDTLS_SSL_HANDSHAKE_OVER == pxSsl->state ) ? pdTRUE : pdFALSE;
+        #endif
+
+        if( pdFALSE == xInPlace )
+        {
+            return prvSendvGather( pCtx, pxVectors, xVectorCount, pxWritten );
+        }
+
+        xMaxRecord = mbedtls_ssl_get_max_frag_len( pxSsl );
+
+        while( xDone < xTotal )
+        {
+            if( 0 != pxSsl->out_left )
+            {
+                xResult = mbedtls_ssl_flush_output( pxSsl );
+
+                if( 0 == xResult )
+                {
+                    /* The pending record was sent, or the socket took
+                     * nothing and mbedTLS keeps it queued for the next
+                     * write. Either way its data is no longer the
+                     * caller's to resend. */
+                    xDone += xPending;
+                    xPending = 0;
+
+                    if( 0 != pxSsl->out_left )
+                    {
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                xRecord = xTotal - xDone;
+
+                if( xRecord > xMaxRecord )
+                {
+                    xRecord = xMaxRecord;
+                }
+
+                for( xIndex = 0; xIndex < xRecord; xIndex += xCopy )
+                {
+                    while( xOffset == pxVectors[ xVector ].xLength )
+                    {
+                        xVector++;
+                        xOffset = 0;
+                    }
+
+                    xCopy = pxVectors[ xVector ].xLength - xOffset;
+
+                    if( xCopy > xRecord - xIndex )
+                    {
+                        xCopy = xRecord - xIndex;
+                    }
+
+                    memcpy( pxSsl->out_msg + xIndex, pxVectors[ xVector ].pucData + xOffset, xCopy );
+                    xOffset += xCopy;
+                }
+
+                pxSsl->out_msglen = xRecord;
+                pxSsl->out_msgtype = MBEDTLS_SSL_MSG_APPLICATION_DATA;
+                xResult = mbedtls_ssl_write_record( pxSsl );
+
+                if( 0 == xResult )
+                {
+                    xDone += xRecord;
+                }
+                else
+                {
+                    /* The record is built; it is counted once it has
+                     * been flushed. */
+                    xPending = xRecord;
+                }
+            }
+
+            if( ( 0 > xResult ) && ( MBEDTLS_ERR_SSL_WANT_WRITE != xResult ) )
+            {
+                break;
+            }
+        }
+
+        *pxWritten += xDone;
+
+        return xResult;
+    }
+
+#endif /* if ( tlsconfigSENDV_IN_RECORD == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Interface routines.
+ */
 
 BaseType_t TLS_Init( void ** ppvContext,
                      TLSParams_t * pxParams )
@@ -493,28 +1824,10 @@ BaseType_t TLS_Connect( void * pvContext )
     /* Initialize mbedTLS structures. */
     mbedtls_ssl_init( &pCtx->mbedSslCtx );
     mbedtls_ssl_config_init( &pCtx->mbedSslConfig );
-    mbedtls_x509_crt_init( &pCtx->mbedX509CA );
-
-    /* Decode the root certificate: either the default or the override. */
-    if( NULL != pCtx->pcServerCertificate )
-    {
-        xResult = mbedtls_x509_crt_parse( &pCtx->mbedX509CA,
-                                          ( const unsigned char * ) pCtx->pcServerCertificate,
-                                          pCtx->ulServerCertificateLength );
-    }
-    else
-    {
-        xResult = mbedtls_x509_crt_parse( &pCtx->mbedX509CA,
-                                          ( const unsigned char * ) tlsVERISIGN_ROOT_CERTIFICATE_PEM,
-                                          tlsVERISIGN_ROOT_CERTIFICATE_LENGTH );
 
-        if( 0 == xResult )
-        {
-            xResult = mbedtls_x509_crt_parse( &pCtx->mbedX509CA,
-                                              ( const unsigned char * ) tlsATS1_ROOT_CERTIFICATE_PEM,
-                                              tlsATS1_ROOT_CERTIFICATE_LENGTH );
-        }
-    }
+    /* Reference the root certificate chain: either the default or the
+     * override, parsed once for all the contexts that trust it. */
+    xResult = prvTrustStoreAcquire( pCtx );
 
     /* Start with protocol defaults. */
     if( 0 == xResult )
@@ -535,14 +1848,22 @@ BaseType_t TLS_Connect( void * pvContext )
         /* Server certificate validation is mandatory. */
         mbedtls_ssl_conf_authmode( &pCtx->mbedSslConfig, MBEDTLS_SSL_VERIFY_REQUIRED );
 
+        /* Ask the server to keep its records small, if configured. */
+        #if ( tlsconfigMAX_FRAGMENT_LENGTH != 0 )
+            xResult = mbedtls_ssl_conf_max_frag_len( &pCtx->mbedSslConfig, tlsMAX_FRAG_LEN_CODE );
+        #endif
+    }
+
+    if( 0 == xResult )
+    {
         /* Set the RNG callback. */
         mbedtls_ssl_conf_rng( &pCtx->mbedSslConfig, &prvGenerateRandomBytes, pCtx ); /*lint !e546 Nothing wrong here. */
 
         /* Set issuer certificate. */
-        mbedtls_ssl_conf_ca_chain( &pCtx->mbedSslConfig, &pCtx->mbedX509CA, NULL );
+        mbedtls_ssl_conf_ca_chain( &pCtx->mbedSslConfig, &pCtx->pxTrustStore->xChain, NULL );
 
         /* Setup the client credential. */
-        xResult = prvInitializeClientCredential( pCtx );
+        xResult = prvCredentialAcquire( pCtx );
     }
 
     if( ( 0 == xResult ) && ( NULL != pCtx->ppcAlpnProtocols ) )
@@ -574,9 +1895,20 @@ BaseType_t TLS_Connect( void * pvContext )
         xResult = mbedtls_ssl_set_hostname( &pCtx->mbedSslCtx, pCtx->pcDestination );
     }
 
+    /* Offer a cached session for the endpoint. If the server declines it, the
+     * handshake continues as a full handshake. */
+    #if ( tlsconfigSESSION_CACHE_SIZE > 0 )
+        if( 0 == xResult )
+        {
+            prvSessionCacheOffer( pCtx );
+        }
+    #endif
+
     /* Set the socket callbacks. */
     if( 0 == xResult )
     {
+        TickType_t xHandshakeStart = xTaskGetTickCount();
+
         mbedtls_ssl_set_bio( &pCtx->mbedSslCtx,
                              pCtx,
                              prvNetworkSend,
@@ -589,24 +1921,42 @@ BaseType_t TLS_Connect( void * pvContext )
             if( ( MBEDTLS_ERR_SSL_WANT_READ != xResult ) &&
                 ( MBEDTLS_ERR_SSL_WANT_WRITE != xResult ) )
             {
-                /* There was an unexpected error. Per mbedTLS API documentation,
-                ensure that upstream clean-up code doesn't accidentally use 
-                a context that failed the handshake. */
-                prvFreeContext( pCtx );
                 break;
             }
         }
+
+        prvHandshakeComplete( pCtx, xResult, xTaskGetTickCount() - xHandshakeStart );
+
+        if( 0 != xResult )
+        {
+            /* There was an unexpected error. Per mbedTLS API documentation,
+            ensure that upstream clean-up code doesn't accidentally use 
+            a context that failed the handshake. */
+            prvFreeContext( pCtx );
+        }
     }
 
     /* Keep track of successful completion of the handshake. */
     if( 0 == xResult )
     {
         pCtx->xMbedInitialized = pdTRUE;
-    }
 
-    /* Free up allocated memory. */
-    mbedtls_x509_crt_free( &pCtx->mbedX509CA );
-    mbedtls_x509_crt_free( &pCtx->mbedX509Cli );
+        /* The server certificate was only needed to authenticate the server. */
+        #if ( tlsconfigKEEP_PEER_CERTIFICATE == 0 )
+            if( NULL != pCtx->mbedSslCtx.session->peer_cert )
+            {
+                mbedtls_x509_crt_free( pCtx->mbedSslCtx.session->peer_cert );
+                mbedtls_free( pCtx->mbedSslCtx.session->peer_cert );
+                pCtx->mbedSslCtx.session->peer_cert = NULL;
+            }
+        #endif
+    }
+    else
+    {
+        /* Drop any references taken before the failure. */
+        prvTrustStoreRelease( pCtx );
+        prvCredentialRelease( pCtx );
+    }
 
     return xResult;
 }
@@ -674,38 +2024,80 @@ BaseType_t TLS_Send( void * pvContext,
 
     if( NULL != pCtx && pdTRUE == pCtx->xMbedInitialized )
     {
-        while( xWritten < xMsgLength )
+        xResult = prvSslWrite( pCtx, pucMsg, xMsgLength, &xWritten );
+
+        if( 0 > xResult )
         {
-            xResult = mbedtls_ssl_write( &pCtx->mbedSslCtx,
-                                         pucMsg + xWritten,
-                                         xMsgLength - xWritten );
+            /* Hard error: invalidate the context. */
+            prvFreeContext( pCtx );
+        }
+    }
+    else
+    {
+        xResult = MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
 
-            if( 0 < xResult )
-            {
-                /* Sent data, so update the tally and keep looping. */
-                xWritten += ( size_t ) xResult;
-            }
-            else if( 0 == xResult )
-            {
-                /* No data sent (and no error). The secure sockets
-                API supports non-blocking send, so stop the loop but don't
-                flag an error. */
-                break;
-            }
-            else if( MBEDTLS_ERR_SSL_WANT_WRITE != xResult )
+    if( 0 <= xResult )
+    {
+        xResult = ( BaseType_t ) xWritten;
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t TLS_Sendv( void * pvContext,
+                      const TLSIovec_t * pxVectors,
+                      size_t xVectorCount )
+{
+    BaseType_t xResult = 0;
+    TLSContext_t * pCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    size_t xTotal = 0;
+    size_t xWritten = 0;
+    size_t xIndex;
+
+    if( NULL == pCtx || pdTRUE != pCtx->xMbedInitialized )
+    {
+        xResult = MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+    else if( NULL == pxVectors && 0 != xVectorCount )
+    {
+        xResult = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    else
+    {
+        for( xIndex = 0; xIndex < xVectorCount; xIndex++ )
+        {
+            if( NULL == pxVectors[ xIndex ].pucData && 0 != pxVectors[ xIndex ].xLength )
             {
-                /* Hard error: invalidate the context and stop. */
-                prvFreeContext( pCtx );
+                xResult = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
                 break;
             }
+
+            xTotal += pxVectors[ xIndex ].xLength;
         }
     }
-    else
+
+    if( 0 == xResult )
     {
-        xResult = MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+        #if ( tlsconfigSENDV_IN_RECORD == 1 )
+            xResult = prvSendvInRecord( pCtx, pxVectors, xVectorCount, xTotal, &xWritten );
+        #else
+            ( void ) xTotal;
+            xResult = prvSendvGather( pCtx, pxVectors, xVectorCount, &xWritten );
+        #endif
+
+        if( 0 > xResult )
+        {
+            /* Hard error: invalidate the context, so the next call fails. */
+            prvFreeContext( pCtx );
+        }
     }
 
-    if( 0 <= xResult )
+    /* Bytes sent before an error are reported; the error is returned by the
+     * next call. */
+    if( ( 0 <= xResult ) || ( 0 != xWritten ) )
     {
         xResult = ( BaseType_t ) xWritten;
     }
@@ -730,3 +2122,83 @@ void TLS_Cleanup( void * pvContext )
         vPortFree( pCtx );
     }
 }
+
+/*-----------------------------------------------------------*/
+
+void TLS_CredentialCacheInvalidate( void )
+{
+    uint32_t ulIndex;
+
+    if( pdTRUE == prvMutexTake( &xCredentialCacheMutex ) )
+    {
+        prvCredentialUncache();
+
+        /* Release the root CA chains that are no longer in use. */
+        for( ulIndex = 0; ulIndex < tlsconfigTRUST_STORE_CACHE_SIZE; ulIndex++ )
+        {
+            if( NULL != pxTrustStoreCache[ ulIndex ] )
+            {
+                pxTrustStoreCache[ ulIndex ]->xCached = pdFALSE;
+
+                if( 0UL == pxTrustStoreCache[ ulIndex ]->ulRefCount )
+                {
+                    prvTrustStoreFree( pxTrustStoreCache[ ulIndex ] );
+                }
+
+                pxTrustStoreCache[ ulIndex ] = NULL;
+            }
+        }
+
+        ( void ) xSemaphoreGive( xCredentialCacheMutex );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t TLS_GetMemoryReport( void * pvContext,
+                                TLSMemoryReport_t * pxReport )
+{
+    TLSContext_t * pCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    const mbedtls_x509_crt * pxPeerCertificate;
+
+    memset( pxReport, 0, sizeof( TLSMemoryReport_t ) );
+    pxReport->ulContextBytes = sizeof( TLSContext_t );
+
+    if( ( NULL == pCtx ) || ( pdTRUE != pCtx->xMbedInitialized ) )
+    {
+        return ( BaseType_t ) MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    /* mbedTLS allocates one input and one output record buffer. */
+    pxReport->ulRecordBufferBytes = 2UL * MBEDTLS_SSL_BUFFER_LEN;
+    pxReport->ulSessionBytes = sizeof( mbedtls_ssl_session ) + sizeof( mbedtls_ssl_transform );
+
+    for( pxPeerCertificate = pCtx->mbedSslCtx.session->peer_cert;
+         NULL != pxPeerCertificate;
+         pxPeerCertificate = pxPeerCertificate->next )
+    {
+        pxReport->ulSessionBytes += sizeof( mbedtls_x509_crt ) + pxPeerCertificate->raw.len;
+    }
+
+    #if defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+        pxReport->ulMaxFragmentLength = ( uint32_t ) mbedtls_ssl_get_max_frag_len( &pCtx->mbedSslCtx );
+    #else
+        pxReport->ulMaxFragmentLength = MBEDTLS_SSL_MAX_CONTENT_LEN;
+    #endif
+
+    /* Record buffer space that the negotiated fragment length leaves unused. */
+    pxReport->ulUnusedRecordBytes = 2UL * ( MBEDTLS_SSL_MAX_CONTENT_LEN - pxReport->ulMaxFragmentLength );
+
+    return 0;
+}
+
+/*-----------------------------------------------------------*/
+
+void TLS_GetStats( TLSStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xTLSStats;
+    }
+    taskEXIT_CRITICAL();
+}
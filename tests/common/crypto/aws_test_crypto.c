@@ -25,17 +25,41 @@
 
 /* Standard includes. */
 #include <stdint.h>
+#include <string.h>
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
+#include "task.h"
 
 /* Crypto includes. */
 #include "aws_crypto.h"
+#include "mbedtls/sha256.h"
 
 /* Unity framework includes. */
 #include "unity_fixture.h"
 #include "unity.h"
 
+/* Bytes hashed per backend and message size by the benchmark. */
+#ifndef cryptotestHASH_BENCHMARK_BYTES
+    #define cryptotestHASH_BENCHMARK_BYTES    ( 256 * 1024 )
+#endif
+
+/* Streams hashed together by the multi-buffer benchmark. */
+#define cryptotestHASH_MULTI_STREAMS          4
+
+/* Largest message size used by the benchmark. */
+#define cryptotestHASH_MAX_MESSAGE_BYTES      4096
+
+/* Lengths of the two streams hashed together by HashBackendTestVectors. They
+ * span several blocks and differ, so that the streams share some blocks and
+ * each has blocks of its own. */
+#define cryptotestHASH_LANE0_BYTES            1000
+#define cryptotestHASH_LANE1_BYTES            333
+
+/* Bytes of each stream added by the first update, ending mid-block. */
+#define cryptotestHASH_LANE0_SPLIT            100
+#define cryptotestHASH_LANE1_SPLIT            37
+
 TEST_GROUP( Full_CRYPTO );
 
 TEST_SETUP( Full_CRYPTO )
@@ -49,6 +73,8 @@ TEST_TEAR_DOWN( Full_CRYPTO )
 TEST_GROUP_RUNNER( Full_CRYPTO )
 {
     RUN_TEST_CASE( Full_CRYPTO, VerifySignatureTestVectors );
+    RUN_TEST_CASE( Full_CRYPTO, HashBackendTestVectors );
+    RUN_TEST_CASE( Full_CRYPTO, HashBackendBenchmark );
 }
 
 TEST( Full_CRYPTO, VerifySignatureTestVectors )
@@ -281,3 +307,220 @@ TEST( Full_CRYPTO, VerifySignatureTestVectors )
     TEST_ASSERT_FALSE( xResult );
     /** @}*/
 }
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_CRYPTO, HashBackendTestVectors )
+{
+    const CRYPTO_HashBackend_t * pxBackend = NULL;
+    UBaseType_t uxIndex = 0;
+    void * pvContexts[ 3 ] = { NULL };
+    const uint8_t * pucData[ 3 ];
+    size_t xDataLength[ 3 ];
+    uint8_t ucDigest[ cryptoSHA256_DIGEST_BYTES ];
+    size_t x;
+    const char cShortMessage[] = "abc";
+    const char cLongMessage[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const uint8_t ucShortDigest[ cryptoSHA256_DIGEST_BYTES ] =
+    {
+        0xBA, 0x78, 0x16, 0xBF, 0x8F, 0x01, 0xCF, 0xEA, 0x41, 0x41, 0x40, 0xDE, 0x5D, 0xAE, 0x22, 0x23,
+        0xB0, 0x03, 0x61, 0xA3, 0x96, 0x17, 0x7A, 0x9C, 0xB4, 0x10, 0xFF, 0x61, 0xF2, 0x00, 0x15, 0xAD
+    };
+    const uint8_t ucLongDigest[ cryptoSHA256_DIGEST_BYTES ] =
+    {
+        0x24, 0x8D, 0x6A, 0x61, 0xD2, 0x06, 0x38, 0xB8, 0xE5, 0xC0, 0x26, 0x93, 0x0C, 0x3E, 0x60, 0x39,
+        0xA3, 0x3C, 0xE4, 0x59, 0x64, 0xFF, 0x21, 0x67, 0xF6, 0xEC, 0xED, 0xD4, 0x19, 0xDB, 0x06, 0xC1
+    };
+    static uint8_t ucLaneMessage[ cryptotestHASH_LANE0_BYTES ];
+    uint8_t ucLaneDigest[ 2 ][ cryptoSHA256_DIGEST_BYTES ];
+
+    /* The multi-block streams are checked against mbedTLS. */
+    for( x = 0; x < sizeof( ucLaneMessage ); x++ )
+    {
+        ucLaneMessage[ x ] = ( uint8_t ) ( ( x * 131u ) + ( x >> 8 ) );
+    }
+
+    TEST_ASSERT_EQUAL_INT( 0, mbedtls_sha256_ret( ucLaneMessage, cryptotestHASH_LANE0_BYTES, ucLaneDigest[ 0 ], 0 ) );
+    TEST_ASSERT_EQUAL_INT( 0, mbedtls_sha256_ret( &ucLaneMessage[ 1 ], cryptotestHASH_LANE1_BYTES, ucLaneDigest[ 1 ], 0 ) );
+
+    /* Every usable backend must produce the FIPS 180-2 test vector digests,
+     * hashed alone and hashed alongside other streams. */
+    while( NULL != ( pxBackend = CRYPTO_HashGetBackend( uxIndex++ ) ) )
+    {
+        TEST_ASSERT_TRUE( CRYPTO_HashSetBackend( pxBackend ) );
+
+        TEST_ASSERT_TRUE( CRYPTO_HashStart( &pvContexts[ 0 ], cryptoHASH_ALGORITHM_SHA256 ) );
+        CRYPTO_HashUpdate( pvContexts[ 0 ], ( const uint8_t * ) cShortMessage, strlen( cShortMessage ) );
+        CRYPTO_HashFinish( pvContexts[ 0 ], ucDigest );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE( ucShortDigest, ucDigest, sizeof( ucDigest ), pxBackend->pcName );
+
+        for( x = 0; x < 3; x++ )
+        {
+            TEST_ASSERT_TRUE( CRYPTO_HashStart( &pvContexts[ x ], cryptoHASH_ALGORITHM_SHA256 ) );
+        }
+
+        /* Feed the streams unevenly so that they cross block boundaries at
+         * different points. */
+        pucData[ 0 ] = ( const uint8_t * ) cLongMessage;
+        xDataLength[ 0 ] = 1;
+        pucData[ 1 ] = ( const uint8_t * ) cLongMessage;
+        xDataLength[ 1 ] = strlen( cLongMessage );
+        pucData[ 2 ] = ( const uint8_t * ) cShortMessage;
+        xDataLength[ 2 ] = strlen( cShortMessage );
+        CRYPTO_HashUpdateMulti( pvContexts, pucData, xDataLength, 3 );
+
+        pucData[ 0 ] = ( const uint8_t * ) &cLongMessage[ 1 ];
+        xDataLength[ 0 ] = strlen( cLongMessage ) - 1;
+        xDataLength[ 1 ] = 0;
+        xDataLength[ 2 ] = 0;
+        CRYPTO_HashUpdateMulti( pvContexts, pucData, xDataLength, 3 );
+
+        CRYPTO_HashFinish( pvContexts[ 0 ], ucDigest );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE( ucLongDigest, ucDigest, sizeof( ucDigest ), pxBackend->pcName );
+        CRYPTO_HashFinish( pvContexts[ 1 ], ucDigest );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE( ucLongDigest, ucDigest, sizeof( ucDigest ), pxBackend->pcName );
+        CRYPTO_HashFinish( pvContexts[ 2 ], ucDigest );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE( ucShortDigest, ucDigest, sizeof( ucDigest ), pxBackend->pcName );
+
+        /* Two multi-block streams of different lengths, so that backends
+         * which interleave pairs of streams hash their common blocks together
+         * and the rest on their own. The first update ends mid-block, so the
+         * second starts by completing a buffered block in each stream. The
+         * second stream starts at an odd address. */
+        for( x = 0; x < 2; x++ )
+        {
+            TEST_ASSERT_TRUE( CRYPTO_HashStart( &pvContexts[ x ], cryptoHASH_ALGORITHM_SHA256 ) );
+        }
+
+        pucData[ 0 ] = ucLaneMessage;
+        xDataLength[ 0 ] = cryptotestHASH_LANE0_SPLIT;
+        pucData[ 1 ] = &ucLaneMessage[ 1 ];
+        xDataLength[ 1 ] = cryptotestHASH_LANE1_SPLIT;
+        CRYPTO_HashUpdateMulti( pvContexts, pucData, xDataLength, 2 );
+
+        pucData[ 0 ] = &ucLaneMessage[ cryptotestHASH_LANE0_SPLIT ];
+        xDataLength[ 0 ] = cryptotestHASH_LANE0_BYTES - cryptotestHASH_LANE0_SPLIT;
+        pucData[ 1 ] = &ucLaneMessage[ 1 + cryptotestHASH_LANE1_SPLIT ];
+        xDataLength[ 1 ] = cryptotestHASH_LANE1_BYTES - cryptotestHASH_LANE1_SPLIT;
+        CRYPTO_HashUpdateMulti( pvContexts, pucData, xDataLength, 2 );
+
+        CRYPTO_HashFinish( pvContexts[ 0 ], ucDigest );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE( ucLaneDigest[ 0 ], ucDigest, sizeof( ucDigest ), pxBackend->pcName );
+        CRYPTO_HashFinish( pvContexts[ 1 ], ucDigest );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE( ucLaneDigest[ 1 ], ucDigest, sizeof( ucDigest ), pxBackend->pcName );
+    }
+
+    TEST_ASSERT_TRUE( CRYPTO_HashSetBackend( NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Prints throughput in MB/s with two decimal places. */
+static void prvPrintHashRate( const char * pcBackend,
+                              const char * pcMode,
+                              size_t xMessageBytes,
+                              TickType_t xTicks )
+{
+    uint32_t ulHundredthsMBps;
+
+    if( 0 == xTicks )
+    {
+        xTicks = 1;
+    }
+
+    ulHundredthsMBps = ( uint32_t ) ( ( ( uint64_t ) cryptotestHASH_BENCHMARK_BYTES * configTICK_RATE_HZ * 100u ) /
+                                      ( ( uint64_t ) xTicks * 1000000u ) );
+    configPRINTF( ( "SHA-256 %s %s, %d-byte messages: %d.%02d MB/s\r\n",
+                    pcBackend,
+                    pcMode,
+                    ( int ) xMessageBytes,
+                    ( int ) ( ulHundredthsMBps / 100u ),
+                    ( int ) ( ulHundredthsMBps % 100u ) ) );
+}
+
+TEST( Full_CRYPTO, HashBackendBenchmark )
+{
+    static const size_t xMessageSizes[] = { 64, 1024, cryptotestHASH_MAX_MESSAGE_BYTES };
+    const CRYPTO_HashBackend_t * pxBackend = NULL;
+    UBaseType_t uxIndex = 0;
+    void * pvContexts[ cryptotestHASH_MULTI_STREAMS ];
+    const uint8_t * pucData[ cryptotestHASH_MULTI_STREAMS ];
+    size_t xDataLength[ cryptotestHASH_MULTI_STREAMS ];
+    uint8_t ucDigest[ cryptoSHA256_DIGEST_BYTES ];
+    uint8_t ucExpected[ sizeof( xMessageSizes ) / sizeof( xMessageSizes[ 0 ] ) ][ cryptoSHA256_DIGEST_BYTES ];
+    uint8_t * pucMessage = NULL;
+    size_t xSize, xMessage, xStream;
+    TickType_t xStart;
+    BaseType_t xDigestsMatch;
+
+    pucMessage = ( uint8_t * ) pvPortMalloc( cryptotestHASH_MAX_MESSAGE_BYTES );
+    TEST_ASSERT_NOT_NULL( pucMessage );
+    memset( pucMessage, 0xA5, cryptotestHASH_MAX_MESSAGE_BYTES );
+
+    /* Every digest the benchmark computes is checked against mbedTLS. */
+    for( xSize = 0; xSize < sizeof( xMessageSizes ) / sizeof( xMessageSizes[ 0 ] ); xSize++ )
+    {
+        TEST_ASSERT_EQUAL_INT( 0, mbedtls_sha256_ret( pucMessage, xMessageSizes[ xSize ], ucExpected[ xSize ], 0 ) );
+    }
+
+    while( NULL != ( pxBackend = CRYPTO_HashGetBackend( uxIndex++ ) ) )
+    {
+        ( void ) CRYPTO_HashSetBackend( pxBackend );
+
+        for( xSize = 0; xSize < sizeof( xMessageSizes ) / sizeof( xMessageSizes[ 0 ] ); xSize++ )
+        {
+            /* One message at a time, each a complete hash. */
+            xDigestsMatch = pdTRUE;
+            xStart = xTaskGetTickCount();
+
+            for( xMessage = 0; xMessage < cryptotestHASH_BENCHMARK_BYTES / xMessageSizes[ xSize ]; xMessage++ )
+            {
+                TEST_ASSERT_TRUE( CRYPTO_HashStart( &pvContexts[ 0 ], cryptoHASH_ALGORITHM_SHA256 ) );
+                CRYPTO_HashUpdate( pvContexts[ 0 ], pucMessage, xMessageSizes[ xSize ] );
+                CRYPTO_HashFinish( pvContexts[ 0 ], ucDigest );
+
+                if( 0 != memcmp( ucDigest, ucExpected[ xSize ], sizeof( ucDigest ) ) )
+                {
+                    xDigestsMatch = pdFALSE;
+                }
+            }
+
+            prvPrintHashRate( pxBackend->pcName, "single", xMessageSizes[ xSize ], xTaskGetTickCount() - xStart );
+            TEST_ASSERT_TRUE_MESSAGE( xDigestsMatch, pxBackend->pcName );
+
+            /* The same bytes spread over several streams hashed together. */
+            xDigestsMatch = pdTRUE;
+            xStart = xTaskGetTickCount();
+
+            for( xMessage = 0;
+                 xMessage < cryptotestHASH_BENCHMARK_BYTES / ( xMessageSizes[ xSize ] * cryptotestHASH_MULTI_STREAMS );
+                 xMessage++ )
+            {
+                for( xStream = 0; xStream < cryptotestHASH_MULTI_STREAMS; xStream++ )
+                {
+                    TEST_ASSERT_TRUE( CRYPTO_HashStart( &pvContexts[ xStream ], cryptoHASH_ALGORITHM_SHA256 ) );
+                    pucData[ xStream ] = pucMessage;
+                    xDataLength[ xStream ] = xMessageSizes[ xSize ];
+                }
+
+                CRYPTO_HashUpdateMulti( pvContexts, pucData, xDataLength, cryptotestHASH_MULTI_STREAMS );
+
+                for( xStream = 0; xStream < cryptotestHASH_MULTI_STREAMS; xStream++ )
+                {
+                    CRYPTO_HashFinish( pvContexts[ xStream ], ucDigest );
+
+                    if( 0 != memcmp( ucDigest, ucExpected[ xSize ], sizeof( ucDigest ) ) )
+                    {
+                        xDigestsMatch = pdFALSE;
+                    }
+                }
+            }
+
+            prvPrintHashRate( pxBackend->pcName, "multi", xMessageSizes[ xSize ], xTaskGetTickCount() - xStart );
+            TEST_ASSERT_TRUE_MESSAGE( xDigestsMatch, pxBackend->pcName );
+        }
+    }
+
+    ( void ) CRYPTO_HashSetBackend( NULL );
+    vPortFree( pucMessage );
+}
@@ -71,6 +71,7 @@ TEST_GROUP_RUNNER( Full_DEFENDER )
 
     /* This tests that the agent successfully reports to the service */
     RUN_TEST_CASE( Full_DEFENDER, agent_happy_states );
+    RUN_TEST_CASE( Full_DEFENDER, agent_keeps_connection_between_reports );
     RUN_TEST_CASE( Full_DEFENDER, endpoint_accepts_report_from_agent );
 }
 
@@ -578,6 +579,41 @@ TEST( Full_DEFENDER, agent_happy_states )
     DEFENDER_Stop();
 }
 
+TEST( Full_DEFENDER, agent_keeps_connection_between_reports )
+{
+    ( void ) DEFENDER_MetricsInitFunc( NULL, 0 );
+
+    int lReportPeriod = 5;
+    ( void ) DEFENDER_ReportPeriodSet( lReportPeriod );
+    ( void ) DEFENDER_KeepConnectionSet( true );
+
+    DEFENDER_Start();
+
+    while( eDefenderStateInit == StateGet() )
+    {
+    }
+
+    /* The first report opens the connection, the second one reuses it */
+    DEFENDER_AssertStateAndWait( eDefenderStateStarted );
+    DEFENDER_AssertStateAndWait( eDefenderStateNewMqttSuccess );
+    DEFENDER_AssertStateAndWait( eDefenderStateConnectMqttSuccess );
+    DEFENDER_AssertStateAndWait( eDefenderStateSubscribeMqttSuccess );
+    DEFENDER_AssertStateAndWait( eDefenderStateSubmitReportSuccess );
+    DEFENDER_AssertStateAndWait( eDefenderStateSleep );
+    DEFENDER_AssertStateAndWait( eDefenderStateStarted );
+    DEFENDER_AssertStateAndWait( eDefenderStateSubscribeMqttSuccess );
+    DEFENDER_AssertState( eDefenderStateSubmitReportSuccess );
+
+    DEFENDER_Stop();
+
+    /* Wait for the agent to release its connection */
+    while( eDefenderStateInit != StateGet() )
+    {
+    }
+
+    ( void ) DEFENDER_KeepConnectionSet( false );
+}
+
 TEST( Full_DEFENDER, endpoint_accepts_report_from_agent )
 {
     int32_t const lMaxStrLen = 128;
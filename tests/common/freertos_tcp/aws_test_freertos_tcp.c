@@ -30,10 +30,17 @@
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
+#include "task.h"
 #include "list.h"
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS_IP_Private.h"
 #include "FreeRTOS_DNS.h"
+#include "FreeRTOS_Sockets.h"
+#include "NetworkBufferManagement.h"
+
+/* Crypto includes. */
+#include "aws_pkcs11.h"
+#include "aws_secure_sockets.h"
 
 /* Test includes. */
 #include "unity_fixture.h"
@@ -43,6 +50,16 @@
 /**
  * @brief Configuration for this test group.
  */
+#define freertostcptestRAND32_BENCHMARK_ITERATIONS    ( 10000 )
+#define freertostcptestRX_BENCHMARK_FRAMES            ( 20000 )
+#define freertostcptestRX_BENCHMARK_BURST             ( 8 )
+#define freertostcptestRX_BENCHMARK_PAYLOAD_SIZE      ( 64 )
+#define freertostcptestRX_BENCHMARK_PORT              ( 5001 )
+#define freertostcptestRX_BENCHMARK_TIMEOUT_MS        ( 1000 )
+#define freertostcptestMMSG_BENCHMARK_DATAGRAMS       ( 2000 )
+#define freertostcptestMMSG_BENCHMARK_BATCH           ( 8 )
+#define freertostcptestMMSG_BENCHMARK_PAYLOAD_SIZE    ( 32 )
+#define freertostcptestMMSG_BENCHMARK_PORT            ( 9 )
 
 /*
  * @brief Test group definition.
@@ -68,6 +85,21 @@ TEST_GROUP_RUNNER( Full_FREERTOS_TCP )
 
     /* xProcessReceivedUDPPacket test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, UDPPacketLength );
+
+    /* Random number benchmark. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, ipconfigRAND32_Benchmark );
+
+    /* The random pool reseeds its generator. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, ipconfigRAND32_Reseed );
+
+    /* Receive path benchmark. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, RX_Benchmark );
+
+    /* Batched UDP socket API. */
+    #if ( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 )
+        RUN_TEST_CASE( Full_FREERTOS_TCP, UDP_RecvMMsg );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, UDP_SendMMsg_Benchmark );
+    #endif
 }
 
 TEST( Full_FREERTOS_TCP, prvParseDnsResponse )
@@ -359,4 +391,555 @@ TEST( Full_FREERTOS_TCP, UDPPacketLength )
     xNetworkBuffer.xDataLength = sizeof( ucBadUdpPacketB );
     xReturn = xProcessReceivedUDPPacket( &xNetworkBuffer, usPort );
     TEST_ASSERT_EQUAL_UINT32( pdFAIL, xReturn );
-}
\ No newline at end of file
+}
+
+TEST( Full_FREERTOS_TCP, ipconfigRAND32_Benchmark )
+{
+    uint32_t ulIteration;
+    uint32_t ulValue;
+    uint32_t ulPreviousValue;
+    uint32_t ulRepeats = 0;
+    uint32_t ulAllOnes = 0xFFFFFFFFUL;
+    uint32_t ulAllZeros = 0;
+    TickType_t xCallStart;
+    TickType_t xCallTicks;
+    TickType_t xMaxCallTicks = 0;
+    TickType_t xStart;
+    TickType_t xTotalTicks;
+
+    ulPreviousValue = ipconfigRAND32();
+    xStart = xTaskGetTickCount();
+
+    for( ulIteration = 0; ulIteration < freertostcptestRAND32_BENCHMARK_ITERATIONS; ulIteration++ )
+    {
+        xCallStart = xTaskGetTickCount();
+        ulValue = ipconfigRAND32();
+        xCallTicks = xTaskGetTickCount() - xCallStart;
+
+        if( xCallTicks > xMaxCallTicks )
+        {
+            xMaxCallTicks = xCallTicks;
+        }
+
+        if( ulValue == ulPreviousValue )
+        {
+            ulRepeats++;
+        }
+
+        /* Every bit should be seen both set and cleared. */
+        ulAllOnes &= ulValue;
+        ulAllZeros |= ulValue;
+        ulPreviousValue = ulValue;
+    }
+
+    xTotalTicks = xTaskGetTickCount() - xStart;
+
+    configPRINTF( ( "ipconfigRAND32: %u values in %u ms, slowest call %u ms.\r\n",
+                    ( unsigned int ) freertostcptestRAND32_BENCHMARK_ITERATIONS,
+                    ( unsigned int ) ( xTotalTicks * portTICK_PERIOD_MS ),
+                    ( unsigned int ) ( xMaxCallTicks * portTICK_PERIOD_MS ) ) );
+
+    TEST_ASSERT_EQUAL_UINT32( 0, ulRepeats );
+    TEST_ASSERT_EQUAL_UINT32( 0, ulAllOnes );
+    TEST_ASSERT_EQUAL_UINT32( 0xFFFFFFFFUL, ulAllZeros );
+}
+/*-----------------------------------------------------------*/
+
+TEST( Full_FREERTOS_TCP, ipconfigRAND32_Reseed )
+{
+    uint32_t ulIteration;
+    CK_ULONG ulReseedsBefore;
+    CK_ULONG ulReseedsAfter;
+
+    /* Enough values to refill the pool more than
+     * socketsconfigRANDOM_RESEED_INTERVAL times, wherever in the reseed
+     * interval the pool starts. */
+    const uint32_t ulValuesToReseed = ( socketsconfigRANDOM_RESEED_INTERVAL + 1 ) *
+                                      ( socketsconfigRANDOM_POOL_SIZE / sizeof( uint32_t ) );
+
+    ulReseedsBefore = ulPkcs11GetDrbgReseedCount();
+
+    for( ulIteration = 0; ulIteration < ulValuesToReseed; ulIteration++ )
+    {
+        ( void ) ipconfigRAND32();
+    }
+
+    ulReseedsAfter = ulPkcs11GetDrbgReseedCount();
+
+    TEST_ASSERT_GREATER_THAN_UINT32( ulReseedsBefore, ulReseedsAfter );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Build a UDP frame addressed to this node, as a network driver would
+ * have received it.
+ */
+static NetworkBufferDescriptor_t * prvCreateRxBenchmarkFrame( uint32_t ulSequence )
+{
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+    UDPPacket_t * pxUDPPacket;
+    size_t xFrameLength = sizeof( UDPPacket_t ) + freertostcptestRX_BENCHMARK_PAYLOAD_SIZE;
+
+    pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xFrameLength, 0 );
+
+    if( pxNetworkBuffer != NULL )
+    {
+        pxUDPPacket = ( UDPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+        memset( pxNetworkBuffer->pucEthernetBuffer, 0, xFrameLength );
+
+        memcpy( pxUDPPacket->xEthernetHeader.xDestinationAddress.ucBytes, FreeRTOS_GetMACAddress(), ipMAC_ADDRESS_LENGTH_BYTES );
+        memset( pxUDPPacket->xEthernetHeader.xSourceAddress.ucBytes, 0x02, ipMAC_ADDRESS_LENGTH_BYTES );
+        pxUDPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+
+        pxUDPPacket->xIPHeader.ucVersionHeaderLength = 0x45;
+        pxUDPPacket->xIPHeader.usLength = FreeRTOS_htons( xFrameLength - ipSIZE_OF_ETH_HEADER );
+        pxUDPPacket->xIPHeader.usIdentification = FreeRTOS_htons( ( uint16_t ) ulSequence );
+        pxUDPPacket->xIPHeader.ucTimeToLive = 64;
+        pxUDPPacket->xIPHeader.ucProtocol = ipPROTOCOL_UDP;
+        pxUDPPacket->xIPHeader.ulSourceIPAddress = FreeRTOS_GetIPAddress() ^ FreeRTOS_htonl( 0x01UL );
+        pxUDPPacket->xIPHeader.ulDestinationIPAddress = FreeRTOS_GetIPAddress();
+        pxUDPPacket->xIPHeader.usHeaderChecksum = ~FreeRTOS_htons( usGenerateChecksum( 0UL, ( uint8_t * ) &( pxUDPPacket->xIPHeader ), ipSIZE_OF_IPv4_HEADER ) );
+
+        /* A UDP checksum of zero means that no checksum was calculated. */
+        pxUDPPacket->xUDPHeader.usSourcePort = FreeRTOS_htons( freertostcptestRX_BENCHMARK_PORT );
+        pxUDPPacket->xUDPHeader.usDestinationPort = FreeRTOS_htons( freertostcptestRX_BENCHMARK_PORT );
+        pxUDPPacket->xUDPHeader.usLength = FreeRTOS_htons( ipSIZE_OF_UDP_HEADER + freertostcptestRX_BENCHMARK_PAYLOAD_SIZE );
+
+        memcpy( pxNetworkBuffer->pucEthernetBuffer + sizeof( UDPPacket_t ), &ulSequence, sizeof( ulSequence ) );
+        pxNetworkBuffer->xDataLength = xFrameLength;
+    }
+
+    return pxNetworkBuffer;
+}
+/*-----------------------------------------------------------*/
+
+TEST( Full_FREERTOS_TCP, RX_Benchmark )
+{
+    Socket_t xSocket;
+    struct freertos_sockaddr xBindAddress;
+    TickType_t xTimeout = pdMS_TO_TICKS( freertostcptestRX_BENCHMARK_TIMEOUT_MS );
+    IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+    NetworkBufferDescriptor_t * pxFirstBuffer;
+    NetworkBufferDescriptor_t * pxLastBuffer;
+    uint8_t * pucPayload;
+    uint32_t ulSent = 0;
+    uint32_t ulReceived = 0;
+    uint32_t ulOutOfOrder = 0;
+    uint32_t ulSequence;
+    uint32_t ulBurst;
+    int32_t lReturned;
+    TickType_t xStart;
+    TickType_t xTotalTicks;
+
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+    TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xSocket );
+
+    FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+    xBindAddress.sin_port = FreeRTOS_htons( freertostcptestRX_BENCHMARK_PORT );
+    TEST_ASSERT_EQUAL_INT32( 0, FreeRTOS_bind( xSocket, &xBindAddress, sizeof( xBindAddress ) ) );
+
+    xStart = xTaskGetTickCount();
+
+    while( ulSent < freertostcptestRX_BENCHMARK_FRAMES )
+    {
+        /* Hand over a burst of frames while the IP task cannot run, so that
+         * they are all waiting when it wakes up, as they would be after an
+         * interrupt from a busy network. */
+        pxFirstBuffer = NULL;
+        pxLastBuffer = NULL;
+        vTaskSuspendAll();
+
+        for( ulBurst = 0; ulBurst < freertostcptestRX_BENCHMARK_BURST; ulBurst++ )
+        {
+            pxNetworkBuffer = prvCreateRxBenchmarkFrame( ulSent + ulBurst );
+
+            if( pxNetworkBuffer == NULL )
+            {
+                break;
+            }
+
+            #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                {
+                    pxNetworkBuffer->pxNextBuffer = NULL;
+
+                    if( pxFirstBuffer == NULL )
+                    {
+                        pxFirstBuffer = pxNetworkBuffer;
+                    }
+                    else
+                    {
+                        pxLastBuffer->pxNextBuffer = pxNetworkBuffer;
+                    }
+
+                    pxLastBuffer = pxNetworkBuffer;
+                }
+            #else
+                {
+                    xRxEvent.pvData = ( void * ) pxNetworkBuffer;
+
+                    if( xSendEventStructToIPTask( &xRxEvent, 0 ) == pdFAIL )
+                    {
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                        break;
+                    }
+                }
+            #endif /* if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) */
+        }
+
+        #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+            {
+                xRxEvent.pvData = ( void * ) pxFirstBuffer;
+
+                if( ( pxFirstBuffer != NULL ) && ( xSendEventStructToIPTask( &xRxEvent, 0 ) == pdFAIL ) )
+                {
+                    while( pxFirstBuffer != NULL )
+                    {
+                        pxNetworkBuffer = pxFirstBuffer;
+                        pxFirstBuffer = pxFirstBuffer->pxNextBuffer;
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    }
+
+                    ulBurst = 0;
+                }
+            }
+        #else
+            {
+                ( void ) pxFirstBuffer;
+                ( void ) pxLastBuffer;
+            }
+        #endif /* if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) */
+
+        ( void ) xTaskResumeAll();
+
+        if( ulBurst == 0 )
+        {
+            break;
+        }
+
+        ulSent += ulBurst;
+
+        /* Read the burst back. */
+        while( ulReceived < ulSent )
+        {
+            lReturned = FreeRTOS_recvfrom( xSocket, &pucPayload, 0, FREERTOS_ZERO_COPY, NULL, NULL );
+
+            if( lReturned <= 0 )
+            {
+                break;
+            }
+
+            memcpy( &ulSequence, pucPayload, sizeof( ulSequence ) );
+
+            if( ulSequence != ulReceived )
+            {
+                ulOutOfOrder++;
+            }
+
+            FreeRTOS_ReleaseUDPPayloadBuffer( pucPayload );
+            ulReceived++;
+        }
+
+        if( ulReceived < ulSent )
+        {
+            break;
+        }
+    }
+
+    xTotalTicks = xTaskGetTickCount() - xStart;
+
+    if( xTotalTicks == 0 )
+    {
+        xTotalTicks = 1;
+    }
+
+    configPRINTF( ( "RX: %u frames in %u ms, %u frames per second, batch size %u.\r\n",
+                    ( unsigned int ) ulReceived,
+                    ( unsigned int ) ( xTotalTicks * portTICK_PERIOD_MS ),
+                    ( unsigned int ) ( ( ( uint64_t ) ulReceived * configTICK_RATE_HZ ) / xTotalTicks ),
+                    ( unsigned int ) ipconfigRX_BATCH_SIZE ) );
+
+    FreeRTOS_closesocket( xSocket );
+
+    TEST_ASSERT_EQUAL_UINT32( freertostcptestRX_BENCHMARK_FRAMES, ulReceived );
+    TEST_ASSERT_EQUAL_UINT32( 0, ulOutOfOrder );
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 )
+
+    /**
+     * @brief Pass frames made by prvCreateRxBenchmarkFrame() to the IP task
+     * while it cannot run, so that they are all waiting when it wakes up.
+     *
+     * @return The number of frames that were passed on.
+     */
+    static uint32_t prvInjectRxBenchmarkFrames( uint32_t ulFirstSequence,
+                                                uint32_t ulCount )
+    {
+        IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+        NetworkBufferDescriptor_t * pxFirstBuffer = NULL;
+        NetworkBufferDescriptor_t * pxLastBuffer = NULL;
+        uint32_t ulInjected;
+
+        vTaskSuspendAll();
+
+        for( ulInjected = 0; ulInjected < ulCount; ulInjected++ )
+        {
+            pxNetworkBuffer = prvCreateRxBenchmarkFrame( ulFirstSequence + ulInjected );
+
+            if( pxNetworkBuffer == NULL )
+            {
+                break;
+            }
+
+            #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                {
+                    pxNetworkBuffer->pxNextBuffer = NULL;
+
+                    if( pxFirstBuffer == NULL )
+                    {
+                        pxFirstBuffer = pxNetworkBuffer;
+                    }
+                    else
+                    {
+                        pxLastBuffer->pxNextBuffer = pxNetworkBuffer;
+                    }
+
+                    pxLastBuffer = pxNetworkBuffer;
+                }
+            #else
+                {
+                    xRxEvent.pvData = ( void * ) pxNetworkBuffer;
+
+                    if( xSendEventStructToIPTask( &xRxEvent, 0 ) == pdFAIL )
+                    {
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                        break;
+                    }
+                }
+            #endif /* if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) */
+        }
+
+        #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+            {
+                xRxEvent.pvData = ( void * ) pxFirstBuffer;
+
+                if( ( pxFirstBuffer != NULL ) && ( xSendEventStructToIPTask( &xRxEvent, 0 ) == pdFAIL ) )
+                {
+                    while( pxFirstBuffer != NULL )
+                    {
+                        pxNetworkBuffer = pxFirstBuffer;
+                        pxFirstBuffer = pxFirstBuffer->pxNextBuffer;
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    }
+
+                    ulInjected = 0;
+                }
+            }
+        #else
+            {
+                ( void ) pxFirstBuffer;
+                ( void ) pxLastBuffer;
+            }
+        #endif /* if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) */
+
+        ( void ) xTaskResumeAll();
+
+        return ulInjected;
+    }
+
+    /**
+     * @brief Create a UDP socket bound to freertostcptestRX_BENCHMARK_PORT.
+     */
+    static Socket_t prvCreateRxBenchmarkSocket( void )
+    {
+        Socket_t xSocket;
+        struct freertos_sockaddr xBindAddress;
+        TickType_t xTimeout = pdMS_TO_TICKS( freertostcptestRX_BENCHMARK_TIMEOUT_MS );
+
+        xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xSocket );
+
+        FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+        xBindAddress.sin_port = FreeRTOS_htons( freertostcptestRX_BENCHMARK_PORT );
+        TEST_ASSERT_EQUAL_INT32( 0, FreeRTOS_bind( xSocket, &xBindAddress, sizeof( xBindAddress ) ) );
+
+        return xSocket;
+    }
+
+    TEST( Full_FREERTOS_TCP, UDP_RecvMMsg )
+    {
+        Socket_t xSocket;
+        struct freertos_mmsghdr xMessages[ freertostcptestRX_BENCHMARK_BURST ];
+        uint8_t ucBuffers[ freertostcptestRX_BENCHMARK_BURST ][ freertostcptestRX_BENCHMARK_PAYLOAD_SIZE ];
+        BaseType_t xFlags;
+        uint32_t ulSent = 0;
+        uint32_t ulReceived = 0;
+        uint32_t ulSequence;
+        int32_t lReturned;
+        int32_t lIndex;
+
+        xSocket = prvCreateRxBenchmarkSocket();
+
+        /* Receive a burst with copies, then one with zero copy. */
+        for( xFlags = 0; xFlags <= FREERTOS_ZERO_COPY; xFlags += FREERTOS_ZERO_COPY )
+        {
+            ulSent += prvInjectRxBenchmarkFrames( ulSent, freertostcptestRX_BENCHMARK_BURST );
+
+            while( ulReceived < ulSent )
+            {
+                for( lIndex = 0; lIndex < freertostcptestRX_BENCHMARK_BURST; lIndex++ )
+                {
+                    xMessages[ lIndex ].pvBuffer = ucBuffers[ lIndex ];
+                    xMessages[ lIndex ].xBufferLength = sizeof( ucBuffers[ lIndex ] );
+                }
+
+                lReturned = FreeRTOS_recvmmsg( xSocket, xMessages, freertostcptestRX_BENCHMARK_BURST, xFlags );
+                TEST_ASSERT_GREATER_THAN_INT32( 0, lReturned );
+
+                for( lIndex = 0; lIndex < lReturned; lIndex++ )
+                {
+                    TEST_ASSERT_EQUAL_UINT32( freertostcptestRX_BENCHMARK_PAYLOAD_SIZE, xMessages[ lIndex ].xDataLength );
+                    TEST_ASSERT_EQUAL_UINT16( FreeRTOS_htons( freertostcptestRX_BENCHMARK_PORT ), xMessages[ lIndex ].xAddress.sin_port );
+
+                    memcpy( &ulSequence, xMessages[ lIndex ].pvBuffer, sizeof( ulSequence ) );
+                    TEST_ASSERT_EQUAL_UINT32( ulReceived, ulSequence );
+
+                    if( xFlags == FREERTOS_ZERO_COPY )
+                    {
+                        FreeRTOS_ReleaseUDPPayloadBuffer( xMessages[ lIndex ].pvBuffer );
+                    }
+
+                    ulReceived++;
+                }
+            }
+        }
+
+        FreeRTOS_closesocket( xSocket );
+
+        TEST_ASSERT_EQUAL_UINT32( 2 * freertostcptestRX_BENCHMARK_BURST, ulReceived );
+    }
+
+#endif /* if ( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 )
+
+    /**
+     * @brief Print how many datagrams per second were sent in xTicks.
+     */
+    static void prvPrintMMsgBenchmark( const char * pcMethod,
+                                       uint32_t ulSent,
+                                       TickType_t xTicks )
+    {
+        if( xTicks == 0 )
+        {
+            xTicks = 1;
+        }
+
+        configPRINTF( ( "%s: %u datagrams in %u ms, %u datagrams per second.\r\n",
+                        pcMethod,
+                        ( unsigned int ) ulSent,
+                        ( unsigned int ) ( xTicks * portTICK_PERIOD_MS ),
+                        ( unsigned int ) ( ( ( uint64_t ) ulSent * configTICK_RATE_HZ ) / xTicks ) ) );
+    }
+
+    TEST( Full_FREERTOS_TCP, UDP_SendMMsg_Benchmark )
+    {
+        Socket_t xSocket;
+        struct freertos_sockaddr xDestination;
+        struct freertos_mmsghdr xMessages[ freertostcptestMMSG_BENCHMARK_BATCH ];
+        uint8_t ucPayload[ freertostcptestMMSG_BENCHMARK_PAYLOAD_SIZE ];
+        uint32_t ulGatewayAddress;
+        uint32_t ulSent;
+        uint32_t ulIndex;
+        int32_t lReturned;
+        TickType_t xStart;
+
+        xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xSocket );
+
+        /* Nothing needs to listen for the datagrams, so send them to the
+         * discard port of the gateway, which is known to be reachable. */
+        FreeRTOS_GetAddressConfiguration( NULL, NULL, &ulGatewayAddress, NULL );
+        xDestination.sin_addr = ulGatewayAddress;
+        xDestination.sin_port = FreeRTOS_htons( freertostcptestMMSG_BENCHMARK_PORT );
+        memset( ucPayload, 0x55, sizeof( ucPayload ) );
+
+        /* One datagram per call. */
+        xStart = xTaskGetTickCount();
+
+        for( ulSent = 0; ulSent < freertostcptestMMSG_BENCHMARK_DATAGRAMS; ulSent++ )
+        {
+            if( FreeRTOS_sendto( xSocket, ucPayload, sizeof( ucPayload ), 0, &xDestination, sizeof( xDestination ) ) <= 0 )
+            {
+                break;
+            }
+        }
+
+        prvPrintMMsgBenchmark( "FreeRTOS_sendto", ulSent, xTaskGetTickCount() - xStart );
+        TEST_ASSERT_EQUAL_UINT32( freertostcptestMMSG_BENCHMARK_DATAGRAMS, ulSent );
+
+        /* A batch of copied datagrams per call. */
+        for( ulIndex = 0; ulIndex < freertostcptestMMSG_BENCHMARK_BATCH; ulIndex++ )
+        {
+            xMessages[ ulIndex ].pvBuffer = ucPayload;
+            xMessages[ ulIndex ].xDataLength = sizeof( ucPayload );
+            xMessages[ ulIndex ].xAddress = xDestination;
+        }
+
+        xStart = xTaskGetTickCount();
+
+        for( ulSent = 0; ulSent < freertostcptestMMSG_BENCHMARK_DATAGRAMS; ulSent += ( uint32_t ) lReturned )
+        {
+            lReturned = FreeRTOS_sendmmsg( xSocket, xMessages, freertostcptestMMSG_BENCHMARK_BATCH, 0 );
+
+            if( lReturned <= 0 )
+            {
+                break;
+            }
+        }
+
+        prvPrintMMsgBenchmark( "FreeRTOS_sendmmsg", ulSent, xTaskGetTickCount() - xStart );
+        TEST_ASSERT_TRUE( ulSent >= freertostcptestMMSG_BENCHMARK_DATAGRAMS );
+
+        /* A batch of zero copy datagrams per call. */
+        xStart = xTaskGetTickCount();
+
+        for( ulSent = 0; ulSent < freertostcptestMMSG_BENCHMARK_DATAGRAMS; ulSent += ( uint32_t ) lReturned )
+        {
+            for( ulIndex = 0; ulIndex < freertostcptestMMSG_BENCHMARK_BATCH; ulIndex++ )
+            {
+                xMessages[ ulIndex ].pvBuffer = FreeRTOS_GetUDPPayloadBuffer( sizeof( ucPayload ), portMAX_DELAY );
+                TEST_ASSERT_NOT_NULL( xMessages[ ulIndex ].pvBuffer );
+                memcpy( xMessages[ ulIndex ].pvBuffer, ucPayload, sizeof( ucPayload ) );
+            }
+
+            lReturned = FreeRTOS_sendmmsg( xSocket, xMessages, freertostcptestMMSG_BENCHMARK_BATCH, FREERTOS_ZERO_COPY );
+
+            if( lReturned < 0 )
+            {
+                lReturned = 0;
+            }
+
+            /* The buffers that were not sent still belong to this task. */
+            for( ulIndex = ( uint32_t ) lReturned; ulIndex < freertostcptestMMSG_BENCHMARK_BATCH; ulIndex++ )
+            {
+                FreeRTOS_ReleaseUDPPayloadBuffer( xMessages[ ulIndex ].pvBuffer );
+            }
+
+            if( lReturned == 0 )
+            {
+                break;
+            }
+        }
+
+        prvPrintMMsgBenchmark( "FreeRTOS_sendmmsg zero copy", ulSent, xTaskGetTickCount() - xStart );
+        TEST_ASSERT_TRUE( ulSent >= freertostcptestMMSG_BENCHMARK_DATAGRAMS );
+
+        FreeRTOS_closesocket( xSocket );
+    }
+
+#endif /* if ( ipconfigSUPPORT_MMSG_FUNCTIONS != 0 ) */
@@ -26,6 +26,8 @@
 #include <string.h>
 
 #include "aws_greengrass_discovery.h"
+#include "aws_ggd_config.h"
+#include "aws_ggd_config_defaults.h"
 #include "aws_helper_secure_connect.h"
 #include "jsmn.h"
 #include "unity_fixture.h"
@@ -34,7 +36,6 @@
 #include "aws_test_runner.h"
 
 #define ggdLOOP_BACK_IP                    "127.0.0.1"
-#define ggdHTTP_CONTENT_LENGTH_STRING      "content-length:"
 #define cJSON_FILE_SIZE                    " 2193"
 #define END_OF_HTTP_RESPONSE               "\r\n\r\n"
 #define ggdJSON_FILE                       "{\"GGGroups\":[{\"GGGroupId\":\"myGroupID\",\"Cores\":[{\"thingArn\":\"myGreenGrassCoreArn\",\"Connectivity\":[{\"Id\":\"AUTOIP_10.60.212.138_0\",\"HostAddress\":\"44.44.44.44\",\"PortNumber\":1234,\"Metadata\":\"\"},{\"Id\":\"AUTOIP_127.0.0.1_1\",\"HostAddress\":\"127.0.0.1\",\"PortNumber\":8883,\"Metadata\":\"\"},{\"Id\":\"AUTOIP_192.168.2.2_2\",\"HostAddress\":\"01.23.456.789\",\"PortNumber\":4321,\"Metadata\":\"\"},{\"Id\":\"AUTOIP_::1_3\",\"HostAddress\":\"::1\",\"PortNumber\":8883,\"Metadata\":\"\"},{\"Id\":\"AUTOIP_fe80::bfda:8f62:7b4b:f358_4\",\"HostAddress\":\"fe80::bfda:8f62:7b4b:f358\",\"PortNumber\":8883,\"Metadata\":\"\"},{\"Id\":\"AUTOIP_fe80::e234:cff9:f53f:6216_5\",\"HostAddress\":\"fe80::e234:cff9:f53f:6216\",\"PortNumber\":8883,\"Metadata\":\"\"}]}],\"CAs\":[\"-----BEGIN CERTIFICATE-----\\nMIIEFTCCAv2gAwIBAgIVAPRru+NqCDr0r6oD6PnTG05rWuY+MA0GCSqGSIb3DQEB\\nCwUAMIGoMQswCQYDVQQGEwJVUzEYMBYGA1UECgwPQW1hem9uLmNvbSBJbmMuMRww\\nGgYDVQQLDBNBbWF6b24gV2ViIFNlcnZpY2VzMRMwEQYDVQQIDApXYXNoaW5ndG9u\\nMRAwDgYDVQQHDAdTZWF0dGxlMTowOAYDVQQDDDE5NDI5MjczNzY5NjU6ZDk3ZmZl\\nZmUtNTI4MS00ZWM5LTk4NDYtYjNlZTQxMDRjMjAxMCAXDTE3MDcwNjIwMDczOFoY\\nDzIwOTcwNzA2MjAwNzM3WjCBqDELMAkGA1UEBhMCVVMxGDAWBgNVBAoMD0FtYXpv\\nbi5jb20gSW5jLjEcMBoGA1UECwwTQW1hem9uIFdlYiBTZXJ2aWNlczETMBEGA1UE\\nCAwKV2FzaGluZ3RvbjEQMA4GA1UEBwwHU2VhdHRsZTE6MDgGA1UEAwwxOTQyOTI3\\nMzc2OTY1OmQ5N2ZmZWZlLTUyODEtNGVjOS05ODQ2LWIzZWU0MTA0YzIwMTCCASIw\\nDQYJKoZIhvcNAQEBBQADggEPADCCAQoCggEBAKxzJpXU2DZDEglh/FT01epAWby6\\np4Ymw76icyMzBUJzafibABJ3cTyjDQE6ZqbSl1ryBxGwQBsveIgj8SVVtv927wk7\\nlncgD+EghfTZgSfscND653AJeVFQlCeHipZI32wzXyPmwglFrWp9vsrY/8BO1Kjk\\nSAs4o8fDVVMAaZCJDMuc5csc3CQ2OJYLOl+SZisGNM1h0xHpWieM38KDDrp99x8Q\\nTwDmgaMjtdIJR7Y9Nzm0N78gTf3gTazEO9iUKojVCNubxK/lQ6KjJ0JcvsljPpVp\\nuzjOmn91xmNoHEQCboa7YoYNNbdAbftGeUl16wFdTgbuUS9vakk5idVoC2ECAwEA\\nAaMyMDAwDwYDVR0TAQH/BAUwAwEB/zAdBgNVHQ4EFgQUmcz4OlH9+mlpnTKG3taI\\nw+6FSk0wDQYJKoZIhvcNAQELBQADggEBACeiQ6MxiktsU0sLNmP1cNbiuBuutjoq\\nymk476Bhr4E2WSE0B9W1TFOSLIYx9oN63T3lXzsGHP/MznueIbqbwFf/o5aXI7th\\n+J+i9LgBrViNvzkze7G0GiPuEQ7ox4XnPBJAFtTZxa8gXL95QfcypERpQs28lg7W\\nQpdNhiBN+c4o1aSOzJ474sjXnjtI1G2jRTKucm0buYYeAeVT7kpBq9YL7gGfOcyj\\nsPxQEgyQV2Mk+b1q7lYDS4tnzoRkUfNLgAtDKSh8S8iVhAR6wRR2G3aMySKrOxbg\\nalghO3OqfeuTwIj9w17JTAyYAME22RJQ6oxEJ8rHp/9PaYnOmiSkP7M=\\n-----END CERTIFICATE-----\\n\"]}]}"
@@ -44,6 +45,8 @@
 #define ggdTestJSON_PORT_ADRESS_1          1234
 #define ggdTestJSON_PORT_ADRESS_3          4321
 #define ggdTestLOOP_NUMBER                 10
+#define ggdTestUNREACHABLE_IP_1            "192.0.2.1" /* Reserved for documentation, never answers. */
+#define ggdTestUNREACHABLE_IP_2            "192.0.2.2"
 
 #define ggdJSON_FILE_GROUPID               "GGGroupId"
 #define ggdJSON_FILE_THING_ARN             "thingArn"
@@ -85,13 +88,18 @@ TEST_GROUP_RUNNER( Full_GGD )
     RUN_TEST_CASE( Full_GGD, GetIPOnInterface );
     RUN_TEST_CASE( Full_GGD, JSONRequestGetSize );
     RUN_TEST_CASE( Full_GGD, JSONRequestGetFile );
-    RUN_TEST_CASE( Full_GGD, CheckForContentLengthString );
+    RUN_TEST_CASE( Full_GGD, JSONRequestParse );
+    RUN_TEST_CASE( Full_GGD, HTTPHeaderValue );
+    RUN_TEST_CASE( Full_GGD, ParseJSONStream );
+    RUN_TEST_CASE( Full_GGD, ParseJSONStreamBenchmark );
     RUN_TEST_CASE( Full_GGD, Jsoneq );
     RUN_TEST_CASE( Full_GGD, CheckMatch );
     RUN_TEST_CASE( Full_GGD, GetCertificate );
     RUN_TEST_CASE( Full_GGD, GetCore );
     RUN_TEST_CASE( Full_GGD, prvIsIPvalid );
     RUN_TEST_CASE( Full_GGD, GetGGCIPandCertificate );
+    RUN_TEST_CASE( Full_GGD, DiscoveryCache );
+    RUN_TEST_CASE( Full_GGD, SecureConnectConnectFirst );
 }
 
 TEST( Full_GGD, JSONRequestAbort )
@@ -219,6 +227,149 @@ TEST( Full_GGD, GetGGCIPandCertificate )
 }
 
 
+TEST( Full_GGD, DiscoveryCache )
+{
+    BaseType_t xStatus;
+    GGD_HostAddressData_t xHostAddressData;
+    GGD_HostAddressData_t xCachedHostAddressData;
+    TickType_t xDiscoveryTicks;
+    TickType_t xCachedTicks;
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Check the second call reuses the result of the first.
+         *  @{
+         */
+        GGD_InvalidateCache();
+        xDiscoveryTicks = xTaskGetTickCount();
+        xStatus = GGD_GetGGCIPandCertificate( cBuffer,
+                                              testrunnerBUFFER_SIZE,
+                                              &xHostAddressData );
+        xDiscoveryTicks = xTaskGetTickCount() - xDiscoveryTicks;
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+
+        xCachedTicks = xTaskGetTickCount();
+        xStatus = GGD_GetGGCIPandCertificate( cBuffer,
+                                              testrunnerBUFFER_SIZE,
+                                              &xCachedHostAddressData );
+        xCachedTicks = xTaskGetTickCount() - xCachedTicks;
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        TEST_ASSERT_EQUAL_STRING( xHostAddressData.pcHostAddress, xCachedHostAddressData.pcHostAddress );
+        TEST_ASSERT_EQUAL_PTR( xHostAddressData.pcCertificate, xCachedHostAddressData.pcCertificate );
+        TEST_ASSERT_TRUE( xCachedTicks <= xDiscoveryTicks );
+
+        configPRINTF( ( "GGD connect time: discovery %u ms, cached %u ms\r\n",
+                        ( unsigned ) ( xDiscoveryTicks * portTICK_PERIOD_MS ),
+                        ( unsigned ) ( xCachedTicks * portTICK_PERIOD_MS ) ) );
+        /** @}*/
+
+        /** @brief Check a modified buffer is not trusted.
+         *  @{
+         */
+        cBuffer[ 0 ] = '\0';
+        xStatus = GGD_GetGGCIPandCertificate( cBuffer,
+                                              testrunnerBUFFER_SIZE,
+                                              &xHostAddressData );
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        TEST_ASSERT_EQUAL_UINT32( strlen( xHostAddressData.pcCertificate ) + 1, xHostAddressData.ulCertificateSize );
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+}
+
+TEST( Full_GGD, SecureConnectConnectFirst )
+{
+    BaseType_t xStatus;
+    GGD_HostAddressData_t xHostAddressData[ ggdconfigMAX_CORE_ENDPOINTS ];
+    GGD_HostAddressData_t xProbeAddressData[ 3 ];
+    uint32_t ulHostAddressCount = ggdconfigMAX_CORE_ENDPOINTS;
+    uint32_t ulConnectedIndex = 0;
+    TickType_t xTicks;
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Find the address the core answers on.
+         *  @{
+         */
+        xStatus = GGD_JSONRequestStart( &xSocket );
+
+        if( xStatus == pdPASS )
+        {
+            xStatus = GGD_JSONRequestParse( &xSocket,
+                                            cBuffer,
+                                            testrunnerBUFFER_SIZE,
+                                            NULL,
+                                            pdTRUE,
+                                            xHostAddressData,
+                                            &ulHostAddressCount );
+        }
+
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+
+        xStatus = GGD_SecureConnect_ConnectFirst( xHostAddressData,
+                                                  ulHostAddressCount,
+                                                  &xSocket,
+                                                  &ulConnectedIndex,
+                                                  ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                                  ggdconfigTCP_SEND_TIMEOUT_MS );
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        GGD_SecureConnect_Disconnect( &xSocket );
+        /** @}*/
+
+        /** @brief Check that addresses which never answer do not delay the
+         * connection by a full timeout each.
+         *  @{
+         */
+        xProbeAddressData[ 0 ] = xHostAddressData[ ulConnectedIndex ];
+        xProbeAddressData[ 0 ].pcHostAddress = ggdTestUNREACHABLE_IP_1;
+        xProbeAddressData[ 1 ] = xProbeAddressData[ 0 ];
+        xProbeAddressData[ 1 ].pcHostAddress = ggdTestUNREACHABLE_IP_2;
+        xProbeAddressData[ 2 ] = xHostAddressData[ ulConnectedIndex ];
+
+        xTicks = xTaskGetTickCount();
+        xStatus = GGD_SecureConnect_ConnectFirst( xProbeAddressData,
+                                                  3,
+                                                  &xSocket,
+                                                  &ulConnectedIndex,
+                                                  ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                                  ggdconfigTCP_SEND_TIMEOUT_MS );
+        xTicks = xTaskGetTickCount() - xTicks;
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        TEST_ASSERT_EQUAL_UINT32( 2, ulConnectedIndex );
+        GGD_SecureConnect_Disconnect( &xSocket );
+
+        configPRINTF( ( "GGD time to connected behind 2 dead addresses: %u ms\r\n",
+                        ( unsigned ) ( xTicks * portTICK_PERIOD_MS ) ) );
+
+        if( ggdconfigPROBE_MAX_PARALLEL > 2 )
+        {
+            TEST_ASSERT_LESS_THAN_UINT32( pdMS_TO_TICKS( ggdconfigTCP_RECEIVE_TIMEOUT_MS ), xTicks );
+        }
+
+        /** @}*/
+
+        /** @brief Check fail is returned when no address answers.
+         *  @{
+         */
+        xStatus = GGD_SecureConnect_ConnectFirst( xProbeAddressData,
+                                                  2,
+                                                  &xSocket,
+                                                  &ulConnectedIndex,
+                                                  ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                                  ggdconfigTCP_SEND_TIMEOUT_MS );
+        TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+}
+
+
 TEST( Full_GGD, GetIPandCertificateFromJSON )
 {
     uint32_t ulJSONFileSize = strlen( cJSON_FILE );
@@ -809,54 +960,284 @@ TEST( Full_GGD, Jsoneq )
     }
 }
 
-TEST( Full_GGD, CheckForContentLengthString )
+TEST( Full_GGD, HTTPHeaderValue )
+{
+    const char * pcValue; /*lint !e971 can use char without signed/unsigned. */
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Check the value is found whatever the case of the name.
+         *  @{
+         */
+        pcValue = test_prvHTTPHeaderValue( "content-length: 2193", "content-length" );
+        TEST_ASSERT_NOT_NULL( pcValue );
+        TEST_ASSERT_EQUAL_STRING( "2193", pcValue );
+
+        pcValue = test_prvHTTPHeaderValue( "Content-Length:2193", "content-length" );
+        TEST_ASSERT_NOT_NULL( pcValue );
+        TEST_ASSERT_EQUAL_STRING( "2193", pcValue );
+
+        pcValue = test_prvHTTPHeaderValue( "TRANSFER-ENCODING:   chunked", "transfer-encoding" );
+        TEST_ASSERT_NOT_NULL( pcValue );
+        TEST_ASSERT_EQUAL_STRING( "chunked", pcValue );
+        /** @}*/
+
+        /** @brief Check other headers and partial names are not matched.
+         *  @{
+         */
+        pcValue = test_prvHTTPHeaderValue( "content-type: application/json", "content-length" );
+        TEST_ASSERT_NULL( pcValue );
+
+        pcValue = test_prvHTTPHeaderValue( "content-length-extra: 10", "content-length" );
+        TEST_ASSERT_NULL( pcValue );
+
+        pcValue = test_prvHTTPHeaderValue( "content", "content-length" );
+        TEST_ASSERT_NULL( pcValue );
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+}
+
+TEST( Full_GGD, ParseJSONStream )
 {
     BaseType_t xStatus;
-    uint8_t ucIndex = 0;
-    uint32_t ulI;
-    char cHTTPContentString[] = ggdHTTP_CONTENT_LENGTH_STRING;
+    GGD_HostAddressData_t xHostAddressData[ 3 ];
+    HostParameters_t xHostParameters;
+    uint32_t ulJSONFileSize = strlen( cJSON_FILE );
+    uint32_t ulHostAddressCount;
+    uint32_t ulFeedSize;
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Check the document gives the same result whatever the
+         * size of the pieces it is received in.
+         *  @{
+         */
+        for( ulFeedSize = 1; ulFeedSize <= ulJSONFileSize; ulFeedSize = ( ulFeedSize * 7 ) + 1 )
+        {
+            ulHostAddressCount = 2;
+            xStatus = test_prvGGDParseJSONStream( cJSON_FILE,
+                                                  ulJSONFileSize,
+                                                  ulFeedSize,
+                                                  cBuffer,
+                                                  testrunnerBUFFER_SIZE,
+                                                  NULL,
+                                                  pdTRUE,
+                                                  xHostAddressData,
+                                                  &ulHostAddressCount );
+            TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+            TEST_ASSERT_EQUAL_UINT32( 2, ulHostAddressCount );
+            TEST_ASSERT_EQUAL_STRING( cIP_ADDRESS_1, xHostAddressData[ 0 ].pcHostAddress );
+            TEST_ASSERT_EQUAL_UINT16( ggdTestJSON_PORT_ADRESS_1, xHostAddressData[ 0 ].usPort );
+            TEST_ASSERT_EQUAL_STRING( ggdLOOP_BACK_IP, xHostAddressData[ 1 ].pcHostAddress );
+            TEST_ASSERT_EQUAL_STRING( cCERTIFICATE, xHostAddressData[ 0 ].pcCertificate );
+            TEST_ASSERT_EQUAL_UINT32( strlen( cCERTIFICATE ) + 1, xHostAddressData[ 0 ].ulCertificateSize );
+            TEST_ASSERT_EQUAL_PTR( xHostAddressData[ 0 ].pcCertificate, xHostAddressData[ 1 ].pcCertificate );
+        }
+
+        /** @}*/
+
+        /** @brief Check the group and core are selected when auto selection
+         * is off, and that the addresses are kept in order.
+         *  @{
+         */
+        xHostParameters.pcGroupName = cMyGroupID;
+        xHostParameters.pcCoreAddress = cMY_CORE_ARN;
+        xHostParameters.ucInterface = 1;
+        ulHostAddressCount = 3;
+        xStatus = test_prvGGDParseJSONStream( cJSON_FILE,
+                                              ulJSONFileSize,
+                                              ulJSONFileSize,
+                                              cBuffer,
+                                              testrunnerBUFFER_SIZE,
+                                              &xHostParameters,
+                                              pdFALSE,
+                                              xHostAddressData,
+                                              &ulHostAddressCount );
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        TEST_ASSERT_EQUAL_UINT32( 3, ulHostAddressCount );
+        TEST_ASSERT_EQUAL_STRING( cIP_ADDRESS_3, xHostAddressData[ 2 ].pcHostAddress );
+        TEST_ASSERT_EQUAL_UINT16( ggdTestJSON_PORT_ADRESS_3, xHostAddressData[ 2 ].usPort );
+        /** @}*/
+
+        /** @brief Check fail is returned when the group does not exist.
+         *  @{
+         */
+        xHostParameters.pcGroupName = "notMyGroupID";
+        ulHostAddressCount = 2;
+        xStatus = test_prvGGDParseJSONStream( cJSON_FILE,
+                                              ulJSONFileSize,
+                                              ulJSONFileSize,
+                                              cBuffer,
+                                              testrunnerBUFFER_SIZE,
+                                              &xHostParameters,
+                                              pdFALSE,
+                                              xHostAddressData,
+                                              &ulHostAddressCount );
+        TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
+        /** @}*/
+
+        /** @brief Check fail is returned when the certificate does not fit.
+         *  @{
+         */
+        ulHostAddressCount = 2;
+        xStatus = test_prvGGDParseJSONStream( cJSON_FILE,
+                                              ulJSONFileSize,
+                                              ulJSONFileSize,
+                                              cBuffer,
+                                              strlen( cCERTIFICATE ),
+                                              NULL,
+                                              pdTRUE,
+                                              xHostAddressData,
+                                              &ulHostAddressCount );
+        TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
+        /** @}*/
+
+        /** @brief Check fail is returned on a truncated document.
+         *  @{
+         */
+        ulHostAddressCount = 2;
+        xStatus = test_prvGGDParseJSONStream( cJSON_FILE,
+                                              ulJSONFileSize - 1,
+                                              ulJSONFileSize,
+                                              cBuffer,
+                                              testrunnerBUFFER_SIZE,
+                                              NULL,
+                                              pdTRUE,
+                                              xHostAddressData,
+                                              &ulHostAddressCount );
+        TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+}
+
+TEST( Full_GGD, ParseJSONStreamBenchmark )
+{
+    BaseType_t i;
+    BaseType_t xStatus = pdPASS;
+    GGD_HostAddressData_t xHostAddressData[ 2 ];
+    uint32_t ulJSONFileSize = strlen( cJSON_FILE );
+    uint32_t ulHostAddressCount;
+    TickType_t xStartTime;
+    TickType_t xTokenTicks;
+    TickType_t xStreamTicks;
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Compare the cost of tokenizing a received document with
+         * parsing it as it is received.
+         *  @{
+         */
+        xStartTime = xTaskGetTickCount();
+
+        for( i = 0; ( i < ( ggdTestLOOP_NUMBER * 100 ) ) && ( xStatus == pdPASS ); i++ )
+        {
+            memcpy( cBuffer, cJSON_FILE, ulJSONFileSize + 1 );
+            xStatus = GGD_GetIPandCertificateFromJSON( cBuffer,
+                                                       ulJSONFileSize,
+                                                       NULL,
+                                                       &xHostAddressData[ 0 ],
+                                                       pdTRUE );
+        }
+
+        xTokenTicks = xTaskGetTickCount() - xStartTime;
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+
+        xStartTime = xTaskGetTickCount();
+
+        for( i = 0; ( i < ( ggdTestLOOP_NUMBER * 100 ) ) && ( xStatus == pdPASS ); i++ )
+        {
+            ulHostAddressCount = 2;
+            xStatus = test_prvGGDParseJSONStream( cJSON_FILE,
+                                                  ulJSONFileSize,
+                                                  ggdconfigHTTP_READ_BUFFER_SIZE,
+                                                  cBuffer,
+                                                  testrunnerBUFFER_SIZE,
+                                                  NULL,
+                                                  pdTRUE,
+                                                  xHostAddressData,
+                                                  &ulHostAddressCount );
+        }
+
+        xStreamTicks = xTaskGetTickCount() - xStartTime;
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+
+        configPRINTF( ( "GGD parse of %u bytes x%d: jsmn %u ticks, stream %u ticks\r\n",
+                        ( unsigned ) ulJSONFileSize,
+                        ( int ) ( ggdTestLOOP_NUMBER * 100 ),
+                        ( unsigned ) xTokenTicks,
+                        ( unsigned ) xStreamTicks ) );
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+}
+
+TEST( Full_GGD, JSONRequestParse )
+{
+    BaseType_t xStatus;
+    GGD_HostAddressData_t xHostAddressData[ ggdconfigMAX_CORE_ENDPOINTS ];
+    uint32_t ulHostAddressCount;
 
     if( TEST_PROTECT() )
     {
         /** @brief Check return status and value in ideal case.
          *  @{
          */
-        for( ulI = 0;
-             ulI < strlen( ggdHTTP_CONTENT_LENGTH_STRING ) - 1;
-             ulI++ )
+        xStatus = GGD_JSONRequestStart( &xSocket );
+
+        if( xStatus == pdPASS )
         {
-            xStatus = test_prvCheckForContentLengthString( &ucIndex,
-                                                           cHTTPContentString[ ulI ] );
-            TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
-            TEST_ASSERT_EQUAL_INT32( ulI + 1, ucIndex );
+            ulHostAddressCount = ggdconfigMAX_CORE_ENDPOINTS;
+            xStatus = GGD_JSONRequestParse( &xSocket,
+                                            cBuffer,
+                                            testrunnerBUFFER_SIZE,
+                                            NULL,
+                                            pdTRUE,
+                                            xHostAddressData,
+                                            &ulHostAddressCount );
         }
 
-        xStatus = test_prvCheckForContentLengthString( &ucIndex,
-                                                       cHTTPContentString[ ulI ] );
+        TEST_ASSERT_EQUAL_INT32( SOCKETS_INVALID_SOCKET, xSocket );
         TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        TEST_ASSERT_GREATER_THAN( 0, ulHostAddressCount );
+        TEST_ASSERT_GREATER_THAN( 1000, xHostAddressData[ 0 ].ulCertificateSize );
         /** @}*/
 
-        /** @brief Check index start back to 0 when a wrong char is given.
+        /** @brief Check fail if the buffer is too small for the certificate.
          *  @{
          */
-        ucIndex = 0;
+        xStatus = GGD_JSONRequestStart( &xSocket );
 
-        for( ulI = 0;
-             ulI < strlen( ggdHTTP_CONTENT_LENGTH_STRING ) - 1;
-             ulI++ )
+        if( xStatus == pdPASS )
         {
-            xStatus = test_prvCheckForContentLengthString( &ucIndex,
-                                                           cHTTPContentString[ ulI ] );
-            TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
-            TEST_ASSERT_EQUAL_INT32( ulI + 1, ucIndex );
+            ulHostAddressCount = ggdconfigMAX_CORE_ENDPOINTS;
+            xStatus = GGD_JSONRequestParse( &xSocket,
+                                            cBuffer,
+                                            xHostAddressData[ 0 ].ulCertificateSize - 1,
+                                            NULL,
+                                            pdTRUE,
+                                            xHostAddressData,
+                                            &ulHostAddressCount );
         }
 
-        xStatus = test_prvCheckForContentLengthString( &ucIndex,
-                                                       '0' ); /* Send a random character. */
+        TEST_ASSERT_EQUAL_INT32( SOCKETS_INVALID_SOCKET, xSocket );
         TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
-        TEST_ASSERT_EQUAL_INT32( 0, ucIndex );
         /** @}*/
     }
+    else
+    {
+        TEST_FAIL();
+    }
 }
 
 TEST( Full_GGD, JSONRequestGetFile )
@@ -34,8 +34,17 @@
 #define _AWS_GREENGRASS_DISCOVERY_TEST_ACCESS_DECLARE_H_
 
 #include "jsmn.h"
-BaseType_t test_prvCheckForContentLengthString( uint8_t * pucIndex,
-                                                const char cNewChar );
+const char * test_prvHTTPHeaderValue( const char * pcLine, /*lint !e971 can use char without signed/unsigned. */
+                                      const char * pcName ); /*lint !e971 can use char without signed/unsigned. */
+BaseType_t test_prvGGDParseJSONStream( const char * pcJSONFile, /*lint !e971 can use char without signed/unsigned. */
+                                       const uint32_t ulJSONFileSize,
+                                       const uint32_t ulFeedSize,
+                                       char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                       const uint32_t ulBufferSize,
+                                       const HostParameters_t * pxHostParameters,
+                                       const BaseType_t xAutoSelectFlag,
+                                       GGD_HostAddressData_t * pxHostAddressData,
+                                       uint32_t * pulHostAddressCount );
 BaseType_t test_prvGGDJsoneq( const char * pcJson, /*lint !e971 can use char without signed/unsigned. */
                               const jsmntok_t * const pxTok,
                               const char * pcString );
@@ -35,11 +35,61 @@
 
 /*-----------------------------------------------------------*/
 
-BaseType_t test_prvCheckForContentLengthString( uint8_t * pucIndex,
-                                                const char cNewChar ) /*lint !e971 can use char without signed/unsigned. */
+const char * test_prvHTTPHeaderValue( const char * pcLine, /*lint !e971 can use char without signed/unsigned. */
+                                      const char * pcName ) /*lint !e971 can use char without signed/unsigned. */
 {
-    return prvCheckForContentLengthString( pucIndex,
-                                           cNewChar );
+    return prvHTTPHeaderValue( pcLine,
+                               pcName );
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t test_prvGGDParseJSONStream( const char * pcJSONFile, /*lint !e971 can use char without signed/unsigned. */
+                                       const uint32_t ulJSONFileSize,
+                                       const uint32_t ulFeedSize,
+                                       char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                       const uint32_t ulBufferSize,
+                                       const HostParameters_t * pxHostParameters,
+                                       const BaseType_t xAutoSelectFlag,
+                                       GGD_HostAddressData_t * pxHostAddressData,
+                                       uint32_t * pulHostAddressCount )
+{
+    GGD_JSONStream_t xStream;
+    BaseType_t xStatus = pdPASS;
+    uint32_t ulOffset = 0;
+    uint32_t ulLength;
+
+    prvJSONStreamInit( &xStream,
+                       pcBuffer,
+                       ulBufferSize,
+                       pxHostParameters,
+                       xAutoSelectFlag,
+                       pxHostAddressData,
+                       *pulHostAddressCount );
+
+    /* Feed the document in pieces as they would arrive from the socket. */
+    while( ( xStatus == pdPASS ) && ( ulOffset < ulJSONFileSize ) )
+    {
+        ulLength = ulJSONFileSize - ulOffset;
+
+        if( ulLength > ulFeedSize )
+        {
+            ulLength = ulFeedSize;
+        }
+
+        xStatus = prvJSONStreamFeed( &xStream,
+                                     &pcJSONFile[ ulOffset ],
+                                     ulLength );
+        ulOffset += ulLength;
+    }
+
+    if( xStatus == pdPASS )
+    {
+        xStatus = prvJSONStreamResult( &xStream,
+                                       pulHostAddressCount );
+    }
+
+    return xStatus;
 }
 
 /*-----------------------------------------------------------*/
@@ -43,6 +43,14 @@
     #define testrunnerTEST_FILTER    0
 #endif
 
+/**
+ * @brief If set to 1, the test runner exits the process when the tests are
+ * done, with a non-zero status if any test failed.
+ */
+#ifndef testrunnerEXIT_WITH_RESULT
+    #define testrunnerEXIT_WITH_RESULT    0
+#endif
+
 /**
  * @brief Size of shared array.
  *
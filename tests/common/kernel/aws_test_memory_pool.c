@@ -0,0 +1,344 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Tests for the fixed block memory pools, and a comparison of their cost with
+ * allocating the same blocks from the heap. */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "memory_pool.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define pooltestBLOCK_SIZE         ( 13 )
+#define pooltestBLOCKS             ( 8 )
+#define pooltestSTACK_SIZE         ( configMINIMAL_STACK_SIZE * 2 )
+#define pooltestWAITER_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#define pooltestWAIT_TIME          ( pdMS_TO_TICKS( 50 ) )
+#define pooltestALLOCATIONS        ( 100000 )
+#define pooltestTIMEOUT            ( pdMS_TO_TICKS( 30000 ) )
+
+/* The pool used by pvMemoryPoolAlloc() in the waiting task. */
+static MemoryPoolHandle_t xWaiterPool;
+
+/* The block allocated by the waiting task. */
+static void * volatile pvWaiterBlock;
+
+/* The task that runs the tests, and is notified by the waiting task. */
+static TaskHandle_t xTestTask;
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+/* Storage for the statically allocated pool, declared as uint64_t so it is
+ * aligned to portBYTE_ALIGNMENT. */
+    static uint64_t ullStaticStorage[ ( poolSTORAGE_SIZE( pooltestBLOCK_SIZE, pooltestBLOCKS ) + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t ) ];
+    static StaticMemoryPool_t xStaticPool;
+#endif
+
+/*-----------------------------------------------------------*/
+
+static void prvWaiterTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    pvWaiterBlock = pvMemoryPoolAlloc( xWaiterPool, pooltestTIMEOUT );
+    xTaskNotifyGive( xTestTask );
+
+    vTaskSuspend( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Allocates every block in the pool into pvBlocks, checking that the blocks
+ * are distinct and aligned. */
+static void prvAllocAll( MemoryPoolHandle_t xPool,
+                         void * pvBlocks[ pooltestBLOCKS ] )
+{
+    uint32_t ulBlock;
+    uint32_t ulOther;
+
+    for( ulBlock = 0; ulBlock < pooltestBLOCKS; ulBlock++ )
+    {
+        pvBlocks[ ulBlock ] = pvMemoryPoolAlloc( xPool, 0 );
+        TEST_ASSERT_NOT_NULL( pvBlocks[ ulBlock ] );
+        TEST_ASSERT_EQUAL( 0, ( ( uintptr_t ) pvBlocks[ ulBlock ] ) & portBYTE_ALIGNMENT_MASK );
+
+        for( ulOther = 0; ulOther < ulBlock; ulOther++ )
+        {
+            TEST_ASSERT_TRUE( ( ( uint8_t * ) pvBlocks[ ulBlock ] >= ( uint8_t * ) pvBlocks[ ulOther ] + pooltestBLOCK_SIZE ) ||
+                              ( ( uint8_t * ) pvBlocks[ ulOther ] >= ( uint8_t * ) pvBlocks[ ulBlock ] + pooltestBLOCK_SIZE ) );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_MemoryPool );
+
+TEST_SETUP( Full_MemoryPool )
+{
+    xWaiterPool = NULL;
+    pvWaiterBlock = NULL;
+    xTestTask = xTaskGetCurrentTaskHandle();
+}
+
+TEST_TEAR_DOWN( Full_MemoryPool )
+{
+}
+
+TEST_GROUP_RUNNER( Full_MemoryPool )
+{
+    RUN_TEST_CASE( Full_MemoryPool, MemoryPool_AllocFree );
+    RUN_TEST_CASE( Full_MemoryPool, MemoryPool_BlockingAlloc );
+    RUN_TEST_CASE( Full_MemoryPool, MemoryPool_AllocTimeout );
+    RUN_TEST_CASE( Full_MemoryPool, MemoryPool_StaticFromISR );
+    RUN_TEST_CASE( Full_MemoryPool, MemoryPool_Benchmark );
+}
+
+TEST( Full_MemoryPool, MemoryPool_AllocFree )
+{
+    MemoryPoolHandle_t xPool;
+    void * pvBlocks[ pooltestBLOCKS ];
+    uint32_t ulBlock;
+
+    xPool = xMemoryPoolCreate( pooltestBLOCK_SIZE, pooltestBLOCKS );
+    TEST_ASSERT_NOT_NULL( xPool );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_EQUAL( pooltestBLOCKS, uxMemoryPoolGetFreeBlocks( xPool ) );
+
+        prvAllocAll( xPool, pvBlocks );
+
+        /* The pool is empty. */
+        TEST_ASSERT_NULL( pvMemoryPoolAlloc( xPool, 0 ) );
+        TEST_ASSERT_EQUAL( 0, uxMemoryPoolGetFreeBlocks( xPool ) );
+
+        for( ulBlock = 0; ulBlock < pooltestBLOCKS; ulBlock++ )
+        {
+            vMemoryPoolFree( xPool, pvBlocks[ ulBlock ] );
+        }
+
+        TEST_ASSERT_EQUAL( pooltestBLOCKS, uxMemoryPoolGetFreeBlocks( xPool ) );
+        TEST_ASSERT_EQUAL( 0, uxMemoryPoolGetMinimumEverFreeBlocks( xPool ) );
+
+        /* The last block freed is the first to be reused. */
+        TEST_ASSERT_EQUAL_PTR( pvBlocks[ pooltestBLOCKS - 1 ], pvMemoryPoolAlloc( xPool, 0 ) );
+        vMemoryPoolFree( xPool, pvBlocks[ pooltestBLOCKS - 1 ] );
+    }
+
+    vMemoryPoolDelete( xPool );
+}
+
+TEST( Full_MemoryPool, MemoryPool_BlockingAlloc )
+{
+    TaskHandle_t xWaiter = NULL;
+    void * pvBlock;
+
+    xWaiterPool = xMemoryPoolCreate( pooltestBLOCK_SIZE, 1 );
+    TEST_ASSERT_NOT_NULL( xWaiterPool );
+
+    if( TEST_PROTECT() )
+    {
+        pvBlock = pvMemoryPoolAlloc( xWaiterPool, 0 );
+        TEST_ASSERT_NOT_NULL( pvBlock );
+
+        /* The waiting task has the higher priority, so finds the pool empty
+         * and blocks. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvWaiterTask,
+                                                "PoolWait",
+                                                pooltestSTACK_SIZE,
+                                                NULL,
+                                                pooltestWAITER_PRIORITY,
+                                                &xWaiter ) );
+
+        vTaskDelay( pooltestWAIT_TIME );
+        TEST_ASSERT_NULL( pvWaiterBlock );
+
+        /* Freeing the block unblocks the waiting task, which is given it. */
+        vMemoryPoolFree( xWaiterPool, pvBlock );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, pooltestTIMEOUT ) );
+        TEST_ASSERT_EQUAL_PTR( pvBlock, pvWaiterBlock );
+        TEST_ASSERT_EQUAL( 0, uxMemoryPoolGetFreeBlocks( xWaiterPool ) );
+
+        vMemoryPoolFree( xWaiterPool, pvWaiterBlock );
+    }
+
+    if( xWaiter != NULL )
+    {
+        vTaskDelete( xWaiter );
+    }
+
+    vMemoryPoolDelete( xWaiterPool );
+}
+
+TEST( Full_MemoryPool, MemoryPool_AllocTimeout )
+{
+    MemoryPoolHandle_t xPool;
+    void * pvBlock;
+    TickType_t xStart;
+    TickType_t xTicks;
+
+    xPool = xMemoryPoolCreate( pooltestBLOCK_SIZE, 1 );
+    TEST_ASSERT_NOT_NULL( xPool );
+
+    if( TEST_PROTECT() )
+    {
+        pvBlock = pvMemoryPoolAlloc( xPool, 0 );
+        TEST_ASSERT_NOT_NULL( pvBlock );
+
+        xStart = xTaskGetTickCount();
+        TEST_ASSERT_NULL( pvMemoryPoolAlloc( xPool, pooltestWAIT_TIME ) );
+        xTicks = xTaskGetTickCount() - xStart;
+
+        TEST_ASSERT_TRUE( xTicks >= pooltestWAIT_TIME );
+
+        vMemoryPoolFree( xPool, pvBlock );
+    }
+
+    vMemoryPoolDelete( xPool );
+}
+
+TEST( Full_MemoryPool, MemoryPool_StaticFromISR )
+{
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+        MemoryPoolHandle_t xPool;
+        void * pvBlocks[ pooltestBLOCKS ];
+        uint32_t ulBlock;
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        xPool = xMemoryPoolCreateStatic( pooltestBLOCK_SIZE,
+                                         pooltestBLOCKS,
+                                         ( uint8_t * ) ullStaticStorage,
+                                         &xStaticPool );
+        TEST_ASSERT_EQUAL_PTR( &xStaticPool, xPool );
+
+        if( TEST_PROTECT() )
+        {
+            /* The blocks are allocated from the storage provided. */
+            for( ulBlock = 0; ulBlock < pooltestBLOCKS; ulBlock++ )
+            {
+                pvBlocks[ ulBlock ] = pvMemoryPoolAllocFromISR( xPool );
+                TEST_ASSERT_TRUE( ( ( uint8_t * ) pvBlocks[ ulBlock ] >= ( uint8_t * ) ullStaticStorage ) &&
+                                  ( ( uint8_t * ) pvBlocks[ ulBlock ] < ( uint8_t * ) ullStaticStorage + sizeof( ullStaticStorage ) ) );
+            }
+
+            TEST_ASSERT_NULL( pvMemoryPoolAllocFromISR( xPool ) );
+
+            /* Free half the blocks, then take one back, so the high water mark
+             * stays at the point the pool was empty. */
+            for( ulBlock = 0; ulBlock < pooltestBLOCKS / 2; ulBlock++ )
+            {
+                vMemoryPoolFreeFromISR( xPool, pvBlocks[ ulBlock ], &xHigherPriorityTaskWoken );
+            }
+
+            TEST_ASSERT_EQUAL( pdFALSE, xHigherPriorityTaskWoken );
+            TEST_ASSERT_EQUAL( pooltestBLOCKS / 2, uxMemoryPoolGetFreeBlocks( xPool ) );
+
+            pvBlocks[ 0 ] = pvMemoryPoolAllocFromISR( xPool );
+            TEST_ASSERT_NOT_NULL( pvBlocks[ 0 ] );
+            TEST_ASSERT_EQUAL( ( pooltestBLOCKS / 2 ) - 1, uxMemoryPoolGetFreeBlocks( xPool ) );
+            TEST_ASSERT_EQUAL( 0, uxMemoryPoolGetMinimumEverFreeBlocks( xPool ) );
+        }
+
+        vMemoryPoolDelete( xPool );
+    #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+        TEST_IGNORE_MESSAGE( "configSUPPORT_STATIC_ALLOCATION is 0." );
+    #endif /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+}
+
+TEST( Full_MemoryPool, MemoryPool_Benchmark )
+{
+    MemoryPoolHandle_t xPool;
+    void * pvBlocks[ pooltestBLOCKS ];
+    TickType_t xStart;
+    TickType_t xHeapTicks;
+    TickType_t xPoolTicks;
+    uint32_t ulAllocation;
+    uint32_t ulBlock;
+
+    xPool = xMemoryPoolCreate( pooltestBLOCK_SIZE, pooltestBLOCKS );
+    TEST_ASSERT_NOT_NULL( xPool );
+
+    if( TEST_PROTECT() )
+    {
+        /* Keep several blocks allocated at once, as an application would. */
+        xStart = xTaskGetTickCount();
+
+        for( ulAllocation = 0; ulAllocation < pooltestALLOCATIONS; ulAllocation += pooltestBLOCKS )
+        {
+            for( ulBlock = 0; ulBlock < pooltestBLOCKS; ulBlock++ )
+            {
+                pvBlocks[ ulBlock ] = pvPortMalloc( pooltestBLOCK_SIZE );
+                TEST_ASSERT_NOT_NULL( pvBlocks[ ulBlock ] );
+            }
+
+            for( ulBlock = 0; ulBlock < pooltestBLOCKS; ulBlock++ )
+            {
+                vPortFree( pvBlocks[ ulBlock ] );
+            }
+        }
+
+        xHeapTicks = xTaskGetTickCount() - xStart;
+        xStart = xTaskGetTickCount();
+
+        for( ulAllocation = 0; ulAllocation < pooltestALLOCATIONS; ulAllocation += pooltestBLOCKS )
+        {
+            for( ulBlock = 0; ulBlock < pooltestBLOCKS; ulBlock++ )
+            {
+                pvBlocks[ ulBlock ] = pvMemoryPoolAlloc( xPool, 0 );
+                TEST_ASSERT_NOT_NULL( pvBlocks[ ulBlock ] );
+            }
+
+            for( ulBlock = 0; ulBlock < pooltestBLOCKS; ulBlock++ )
+            {
+                vMemoryPoolFree( xPool, pvBlocks[ ulBlock ] );
+            }
+        }
+
+        xPoolTicks = xTaskGetTickCount() - xStart;
+
+        configPRINTF( ( "MemoryPool: %u allocations, %u ms with pvPortMalloc(), %u ms with a memory pool.\r\n",
+                        ( unsigned int ) pooltestALLOCATIONS,
+                        ( unsigned int ) ( xHeapTicks * portTICK_PERIOD_MS ),
+                        ( unsigned int ) ( xPoolTicks * portTICK_PERIOD_MS ) ) );
+
+        TEST_ASSERT_EQUAL( pooltestBLOCKS, uxMemoryPoolGetFreeBlocks( xPool ) );
+    }
+
+    vMemoryPoolDelete( xPool );
+}
@@ -0,0 +1,290 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Tests for the management of Blocked state tasks by the scheduler, with
+ * either the sorted delayed lists or the timing wheel selected by
+ * configUSE_TIMING_WHEEL. */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define schedulertestMIN_TASKS          ( 8 )
+#define schedulertestMAX_TASKS          ( 512 )
+#define schedulertestMAX_PERIOD         ( 37 )
+#define schedulertestWINDOW             ( pdMS_TO_TICKS( 1000 ) )
+#define schedulertestTASK_PRIORITY      ( tskIDLE_PRIORITY + 2 )
+#define schedulertestSPINNER_PRIORITY   ( tskIDLE_PRIORITY + 1 )
+#define schedulertestLONG_DELAY         ( pdMS_TO_TICKS( 300 ) )
+#define schedulertestLONG_DELAY_TASKS   ( 16 )
+
+/**
+ * @brief State of one of the tasks that block periodically.
+ */
+typedef struct SchedulerTestTask
+{
+    TaskHandle_t xHandle;
+    TickType_t xPeriod;
+    volatile uint32_t ulWakes;
+    volatile uint32_t ulEarlyWakes;
+} SchedulerTestTask_t;
+
+static SchedulerTestTask_t xTestTasks[ schedulertestMAX_TASKS ];
+
+/* Counts the iterations of the lowest priority task, which only runs while
+ * the periodic tasks are blocked and the scheduler is not busy with them. */
+static volatile uint32_t ulSpinnerCount;
+
+/*-----------------------------------------------------------*/
+
+static void prvPeriodicTask( void * pvParameters )
+{
+    SchedulerTestTask_t * pxTask = ( SchedulerTestTask_t * ) pvParameters;
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
+    for( ; ; )
+    {
+        vTaskDelayUntil( &xLastWakeTime, pxTask->xPeriod );
+
+        /* xLastWakeTime now holds the tick count at which the task was due
+         * to wake. */
+        if( ( TickType_t ) ( xTaskGetTickCount() - xLastWakeTime ) > ( TickType_t ) ( portMAX_DELAY / 2 ) )
+        {
+            pxTask->ulEarlyWakes++;
+        }
+
+        pxTask->ulWakes++;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvSpinnerTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ulSpinnerCount++;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* Runs ulTaskCount periodic tasks for schedulertestWINDOW ticks, and returns
+ * the number of tasks that could be created. */
+static uint32_t prvRunPeriodicTasks( uint32_t ulTaskCount,
+                                     uint32_t * pulSpinnerCount )
+{
+    uint32_t ulTask;
+    uint32_t ulCreated = 0;
+    uint32_t ulStartCount;
+
+    for( ulTask = 0; ulTask < ulTaskCount; ulTask++ )
+    {
+        /* Spread the wake times so the tasks do not all block for the same
+         * period. */
+        xTestTasks[ ulTask ].xPeriod = ( TickType_t ) ( 1 + ( ( ulTask * 7 ) % schedulertestMAX_PERIOD ) );
+        xTestTasks[ ulTask ].ulWakes = 0;
+        xTestTasks[ ulTask ].ulEarlyWakes = 0;
+
+        if( xTaskCreate( prvPeriodicTask,
+                         "SchedT",
+                         configMINIMAL_STACK_SIZE,
+                         &( xTestTasks[ ulTask ] ),
+                         schedulertestTASK_PRIORITY,
+                         &( xTestTasks[ ulTask ].xHandle ) ) != pdPASS )
+        {
+            break;
+        }
+
+        ulCreated++;
+    }
+
+    ulStartCount = ulSpinnerCount;
+    vTaskDelay( schedulertestWINDOW );
+    *pulSpinnerCount = ulSpinnerCount - ulStartCount;
+
+    /* The tasks are not running, so their memory is freed straight away. */
+    for( ulTask = 0; ulTask < ulCreated; ulTask++ )
+    {
+        vTaskDelete( xTestTasks[ ulTask ].xHandle );
+    }
+
+    return ulCreated;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvLongDelayTask( void * pvParameters )
+{
+    SchedulerTestTask_t * pxTask = ( SchedulerTestTask_t * ) pvParameters;
+    TickType_t xStart = xTaskGetTickCount();
+
+    vTaskDelay( pxTask->xPeriod );
+
+    if( ( TickType_t ) ( xTaskGetTickCount() - xStart ) < pxTask->xPeriod )
+    {
+        pxTask->ulEarlyWakes++;
+    }
+
+    pxTask->ulWakes++;
+
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_Scheduler );
+
+TEST_SETUP( Full_Scheduler )
+{
+}
+
+TEST_TEAR_DOWN( Full_Scheduler )
+{
+}
+
+TEST_GROUP_RUNNER( Full_Scheduler )
+{
+    RUN_TEST_CASE( Full_Scheduler, DelayedTasks_Benchmark );
+    RUN_TEST_CASE( Full_Scheduler, DelayedTasks_LongDelays );
+}
+
+TEST( Full_Scheduler, DelayedTasks_Benchmark )
+{
+    TaskHandle_t xSpinner = NULL;
+    UBaseType_t uxOriginalPriority = uxTaskPriorityGet( NULL );
+    uint32_t ulTaskCount;
+    uint32_t ulCreated;
+    uint32_t ulTask;
+    uint32_t ulIdleCount;
+    uint32_t ulBusyCount;
+    uint32_t ulWakes;
+    uint32_t ulEarlyWakes;
+
+    /* Run above the periodic tasks so the measurement windows are exact. */
+    vTaskPrioritySet( NULL, configMAX_PRIORITIES - 1 );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvSpinnerTask,
+                                                "SchedS",
+                                                configMINIMAL_STACK_SIZE,
+                                                NULL,
+                                                schedulertestSPINNER_PRIORITY,
+                                                &xSpinner ) );
+
+        /* The time left to the spinner with no periodic tasks is the
+         * reference the other runs are compared with. */
+        ( void ) prvRunPeriodicTasks( 0, &ulIdleCount );
+        TEST_ASSERT_TRUE( ulIdleCount > 0 );
+
+        for( ulTaskCount = schedulertestMIN_TASKS; ulTaskCount <= schedulertestMAX_TASKS; ulTaskCount *= 2 )
+        {
+            ulCreated = prvRunPeriodicTasks( ulTaskCount, &ulBusyCount );
+
+            ulWakes = 0;
+            ulEarlyWakes = 0;
+
+            for( ulTask = 0; ulTask < ulCreated; ulTask++ )
+            {
+                ulWakes += xTestTasks[ ulTask ].ulWakes;
+                ulEarlyWakes += xTestTasks[ ulTask ].ulEarlyWakes;
+            }
+
+            configPRINTF( ( "Scheduler: %u blocking tasks, %u wakes per second, %u%% of the CPU left to other tasks.\r\n",
+                            ( unsigned int ) ulCreated,
+                            ( unsigned int ) ( ( ulWakes * configTICK_RATE_HZ ) / schedulertestWINDOW ),
+                            ( unsigned int ) ( ( ( uint64_t ) ulBusyCount * 100U ) / ulIdleCount ) ) );
+
+            TEST_ASSERT_EQUAL_UINT32( 0, ulEarlyWakes );
+            TEST_ASSERT_TRUE( ulWakes > 0 );
+
+            if( ulCreated < ulTaskCount )
+            {
+                /* Out of heap, larger sweeps would fail in the same way. */
+                configPRINTF( ( "Scheduler: could only create %u of %u tasks.\r\n",
+                                ( unsigned int ) ulCreated,
+                                ( unsigned int ) ulTaskCount ) );
+                break;
+            }
+        }
+    }
+
+    if( xSpinner != NULL )
+    {
+        vTaskDelete( xSpinner );
+    }
+
+    vTaskPrioritySet( NULL, uxOriginalPriority );
+}
+
+TEST( Full_Scheduler, DelayedTasks_LongDelays )
+{
+    uint32_t ulTask;
+    uint32_t ulWakes = 0;
+    uint32_t ulEarlyWakes = 0;
+
+    /* Delays of several hundred ticks go past the first level of the timing
+     * wheel, so the tasks are moved between levels before they wake. */
+    for( ulTask = 0; ulTask < schedulertestLONG_DELAY_TASKS; ulTask++ )
+    {
+        xTestTasks[ ulTask ].xPeriod = schedulertestLONG_DELAY + ( TickType_t ) ( ulTask * 13 );
+        xTestTasks[ ulTask ].ulWakes = 0;
+        xTestTasks[ ulTask ].ulEarlyWakes = 0;
+
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvLongDelayTask,
+                                                "SchedL",
+                                                configMINIMAL_STACK_SIZE,
+                                                &( xTestTasks[ ulTask ] ),
+                                                schedulertestTASK_PRIORITY,
+                                                NULL ) );
+    }
+
+    vTaskDelay( schedulertestLONG_DELAY + ( TickType_t ) ( schedulertestLONG_DELAY_TASKS * 13 ) + pdMS_TO_TICKS( 100 ) );
+
+    for( ulTask = 0; ulTask < schedulertestLONG_DELAY_TASKS; ulTask++ )
+    {
+        ulWakes += xTestTasks[ ulTask ].ulWakes;
+        ulEarlyWakes += xTestTasks[ ulTask ].ulEarlyWakes;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( schedulertestLONG_DELAY_TASKS, ulWakes );
+    TEST_ASSERT_EQUAL_UINT32( 0, ulEarlyWakes );
+}
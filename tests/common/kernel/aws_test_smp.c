@@ -0,0 +1,325 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Tests for the scheduler when configNUM_CORES is greater than 1: tasks
+ * running on several cores at once, core affinity, and a task on one core
+ * waking a task on another. */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define smptestTASK_PRIORITY     ( tskIDLE_PRIORITY + 1 )
+#define smptestTEST_PRIORITY     ( configMAX_PRIORITIES - 1 )
+#define smptestRUN_TIME          ( pdMS_TO_TICKS( 200 ) )
+#define smptestROUND_TRIPS       ( 1000 )
+#define smptestTIMEOUT           ( pdMS_TO_TICKS( 30000 ) )
+#define smptestLAST_CORE         ( configNUM_CORES - 1 )
+
+#if ( configNUM_CORES > 1 )
+
+/**
+ * @brief State of a task started by one of the tests.
+ */
+    typedef struct SmpTestTask
+    {
+        TaskHandle_t xHandle;
+        BaseType_t xExpectedCore;
+        volatile uint32_t ulRuns;
+        volatile uint32_t ulWrongCore;
+    } SmpTestTask_t;
+
+    static SmpTestTask_t xTestTasks[ configNUM_CORES ];
+
+/* The task that runs the tests, and is notified by the tasks it starts. */
+    static TaskHandle_t xTestTask = NULL;
+
+/*-----------------------------------------------------------*/
+
+    static void prvPinnedTask( void * pvParameters )
+    {
+        SmpTestTask_t * pxTask = ( SmpTestTask_t * ) pvParameters;
+
+        /* Wait until the test has set the affinity. */
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        for( ; ; )
+        {
+            if( portGET_CORE_ID() != pxTask->xExpectedCore )
+            {
+                pxTask->ulWrongCore++;
+            }
+
+            pxTask->ulRuns++;
+
+            /* Give the scheduler the chance to move the task each time. */
+            vTaskDelay( 1 );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void prvSpinnerTask( void * pvParameters )
+    {
+        SmpTestTask_t * pxTask = ( SmpTestTask_t * ) pvParameters;
+
+        for( ; ; )
+        {
+            pxTask->ulRuns++;
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void prvResponderTask( void * pvParameters )
+    {
+        SmpTestTask_t * pxTask = ( SmpTestTask_t * ) pvParameters;
+
+        for( ; ; )
+        {
+            ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+            if( portGET_CORE_ID() != pxTask->xExpectedCore )
+            {
+                pxTask->ulWrongCore++;
+            }
+
+            pxTask->ulRuns++;
+            xTaskNotifyGive( xTestTask );
+        }
+    }
+
+#endif /* configNUM_CORES > 1 */
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_SMP );
+
+TEST_SETUP( Full_SMP )
+{
+}
+
+TEST_TEAR_DOWN( Full_SMP )
+{
+}
+
+TEST_GROUP_RUNNER( Full_SMP )
+{
+    RUN_TEST_CASE( Full_SMP, SMP_ParallelTasks );
+    RUN_TEST_CASE( Full_SMP, SMP_CoreAffinity );
+    RUN_TEST_CASE( Full_SMP, SMP_CrossCoreWakeup );
+}
+
+TEST( Full_SMP, SMP_ParallelTasks )
+{
+    #if ( configNUM_CORES > 1 )
+        UBaseType_t uxOriginalPriority = uxTaskPriorityGet( NULL );
+        BaseType_t xTask;
+        BaseType_t xRunning;
+        TickType_t xStart;
+        uint32_t ulStartRuns[ configNUM_CORES - 1 ];
+
+        for( xTask = 0; xTask < configNUM_CORES - 1; xTask++ )
+        {
+            xTestTasks[ xTask ].xHandle = NULL;
+            xTestTasks[ xTask ].ulRuns = 0;
+        }
+
+        /* Run above the spinners, which then have one core each to
+         * themselves. */
+        vTaskPrioritySet( NULL, smptestTEST_PRIORITY );
+
+        if( TEST_PROTECT() )
+        {
+            for( xTask = 0; xTask < configNUM_CORES - 1; xTask++ )
+            {
+                TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvSpinnerTask,
+                                                        "SMPSpin",
+                                                        configMINIMAL_STACK_SIZE,
+                                                        &( xTestTasks[ xTask ] ),
+                                                        smptestTASK_PRIORITY,
+                                                        &( xTestTasks[ xTask ].xHandle ) ) );
+            }
+
+            vTaskDelay( smptestRUN_TIME );
+
+            /* The spinners never block, so on a single core none of them
+             * would be running while this task is.  A core takes a moment to
+             * switch when it is asked to, so sample until they all are. */
+            xStart = xTaskGetTickCount();
+
+            do
+            {
+                xRunning = 0;
+
+                for( xTask = 0; xTask < configNUM_CORES - 1; xTask++ )
+                {
+                    if( eTaskGetState( xTestTasks[ xTask ].xHandle ) == eRunning )
+                    {
+                        xRunning++;
+                    }
+                }
+            } while( ( xRunning < configNUM_CORES - 1 ) &&
+                     ( ( xTaskGetTickCount() - xStart ) < smptestRUN_TIME ) );
+
+            TEST_ASSERT_EQUAL( configNUM_CORES - 1, xRunning );
+
+            for( xTask = 0; xTask < configNUM_CORES - 1; xTask++ )
+            {
+                ulStartRuns[ xTask ] = xTestTasks[ xTask ].ulRuns;
+            }
+
+            /* They also make progress while this task does not block. */
+            for( xTask = 0; xTask < configNUM_CORES - 1; xTask++ )
+            {
+                while( xTestTasks[ xTask ].ulRuns == ulStartRuns[ xTask ] )
+                {
+                }
+            }
+        }
+
+        for( xTask = 0; xTask < configNUM_CORES - 1; xTask++ )
+        {
+            if( xTestTasks[ xTask ].xHandle != NULL )
+            {
+                vTaskDelete( xTestTasks[ xTask ].xHandle );
+            }
+        }
+
+        vTaskPrioritySet( NULL, uxOriginalPriority );
+    #else /* if ( configNUM_CORES > 1 ) */
+        TEST_IGNORE_MESSAGE( "configNUM_CORES is 1." );
+    #endif /* if ( configNUM_CORES > 1 ) */
+}
+
+TEST( Full_SMP, SMP_CoreAffinity )
+{
+    #if ( configNUM_CORES > 1 )
+        SmpTestTask_t * pxTask = &( xTestTasks[ 0 ] );
+
+        pxTask->xHandle = NULL;
+        pxTask->xExpectedCore = smptestLAST_CORE;
+        pxTask->ulRuns = 0;
+        pxTask->ulWrongCore = 0;
+
+        if( TEST_PROTECT() )
+        {
+            TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvPinnedTask,
+                                                    "SMPPin",
+                                                    configMINIMAL_STACK_SIZE,
+                                                    pxTask,
+                                                    smptestTASK_PRIORITY,
+                                                    &( pxTask->xHandle ) ) );
+            TEST_ASSERT_EQUAL( tskNO_AFFINITY, uxTaskCoreAffinityGet( pxTask->xHandle ) );
+
+            vTaskCoreAffinitySet( pxTask->xHandle, ( UBaseType_t ) 1 << smptestLAST_CORE );
+            TEST_ASSERT_EQUAL( ( UBaseType_t ) 1 << smptestLAST_CORE, uxTaskCoreAffinityGet( pxTask->xHandle ) );
+
+            xTaskNotifyGive( pxTask->xHandle );
+            vTaskDelay( smptestRUN_TIME );
+
+            TEST_ASSERT_TRUE( pxTask->ulRuns > 0 );
+            TEST_ASSERT_EQUAL_UINT32( 0, pxTask->ulWrongCore );
+        }
+
+        if( pxTask->xHandle != NULL )
+        {
+            vTaskDelete( pxTask->xHandle );
+        }
+    #else /* if ( configNUM_CORES > 1 ) */
+        TEST_IGNORE_MESSAGE( "configNUM_CORES is 1." );
+    #endif /* if ( configNUM_CORES > 1 ) */
+}
+
+TEST( Full_SMP, SMP_CrossCoreWakeup )
+{
+    #if ( configNUM_CORES > 1 )
+        SmpTestTask_t * pxTask = &( xTestTasks[ 0 ] );
+        UBaseType_t uxOriginalAffinity = uxTaskCoreAffinityGet( NULL );
+        uint32_t ulRoundTrip;
+        TickType_t xStart;
+        TickType_t xTicks;
+
+        pxTask->xHandle = NULL;
+        pxTask->xExpectedCore = smptestLAST_CORE;
+        pxTask->ulRuns = 0;
+        pxTask->ulWrongCore = 0;
+        xTestTask = xTaskGetCurrentTaskHandle();
+
+        /* Keep this task and the responder apart, so every notification is
+         * given to a task on another core. */
+        vTaskCoreAffinitySet( NULL, ( UBaseType_t ) 1 );
+
+        if( TEST_PROTECT() )
+        {
+            TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvResponderTask,
+                                                    "SMPResp",
+                                                    configMINIMAL_STACK_SIZE,
+                                                    pxTask,
+                                                    smptestTEST_PRIORITY,
+                                                    &( pxTask->xHandle ) ) );
+            vTaskCoreAffinitySet( pxTask->xHandle, ( UBaseType_t ) 1 << smptestLAST_CORE );
+
+            xStart = xTaskGetTickCount();
+
+            for( ulRoundTrip = 0; ulRoundTrip < smptestROUND_TRIPS; ulRoundTrip++ )
+            {
+                xTaskNotifyGive( pxTask->xHandle );
+                TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, smptestTIMEOUT ) );
+            }
+
+            xTicks = xTaskGetTickCount() - xStart;
+
+            configPRINTF( ( "SMP: %u cross core round trips in %u ms.\r\n",
+                            ( unsigned int ) smptestROUND_TRIPS,
+                            ( unsigned int ) ( xTicks * portTICK_PERIOD_MS ) ) );
+
+            TEST_ASSERT_EQUAL_UINT32( smptestROUND_TRIPS, pxTask->ulRuns );
+            TEST_ASSERT_EQUAL_UINT32( 0, pxTask->ulWrongCore );
+        }
+
+        if( pxTask->xHandle != NULL )
+        {
+            vTaskDelete( pxTask->xHandle );
+        }
+
+        vTaskCoreAffinitySet( NULL, uxOriginalAffinity );
+    #else /* if ( configNUM_CORES > 1 ) */
+        TEST_IGNORE_MESSAGE( "configNUM_CORES is 1." );
+    #endif /* if ( configNUM_CORES > 1 ) */
+}
@@ -0,0 +1,533 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Tests for the stackless task executor, and a comparison of the RAM and round
+ * trip latency of a stackless task per session with a task per session. */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "stackless.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define stacklesstestSTACK_SIZE      ( configMINIMAL_STACK_SIZE * 2 )
+#define stacklesstestPRIORITY        ( configMAX_PRIORITIES - 2 )
+#define stacklesstestSESSIONS        ( 32 )
+#define stacklesstestROUND_TRIPS     ( 2048 )
+#define stacklesstestDELAY           ( pdMS_TO_TICKS( 50 ) )
+#define stacklesstestSHORT_WAIT      ( pdMS_TO_TICKS( 20 ) )
+#define stacklesstestQUEUE_LENGTH    ( 4 )
+#define stacklesstestITEMS           ( 3 )
+#define stacklesstestTIMEOUT         ( pdMS_TO_TICKS( 30000 ) )
+
+/**
+ * @brief State of a stackless task, or task, started by one of the tests.  The
+ * stackless tasks keep everything that must survive a wait in here, as their
+ * local variables do not.
+ */
+typedef struct StacklessTestSession
+{
+    StacklessTask_t xStackless;
+    TaskHandle_t xTask;
+    uint32_t ulValue;
+    uint32_t ulItem;
+    uint32_t ulCount;
+    BaseType_t xResult;
+    TickType_t xStart;
+    TickType_t xDelayed;
+    TickType_t xTimedOut;
+    volatile uint32_t ulRuns;
+    volatile BaseType_t xFinished;
+} StacklessTestSession_t;
+
+static StacklessTestSession_t xSessions[ stacklesstestSESSIONS ];
+
+/* The order in which the yielding stackless tasks ran. */
+static uint32_t ulOrder[ 8 ];
+static uint32_t ulOrderIndex;
+
+/* The task that runs the tests, and is notified by the sessions. */
+static TaskHandle_t xTestTask;
+
+#if ( configUSE_QUEUE_SETS == 1 )
+    static QueueHandle_t xTestQueue;
+#endif
+
+/*-----------------------------------------------------------*/
+
+static void prvNotifiedStackless( StacklessTask_t * pxStacklessTask,
+                                  void * pvParameter )
+{
+    StacklessTestSession_t * pxSession = ( StacklessTestSession_t * ) pvParameter;
+
+    stacklessBEGIN( pxStacklessTask );
+
+    stacklessAWAIT_NOTIFY( pxStacklessTask, portMAX_DELAY, &( pxSession->ulValue ) );
+    pxSession->xFinished = pdTRUE;
+
+    stacklessEND( pxStacklessTask );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvDelayingStackless( StacklessTask_t * pxStacklessTask,
+                                  void * pvParameter )
+{
+    StacklessTestSession_t * pxSession = ( StacklessTestSession_t * ) pvParameter;
+
+    stacklessBEGIN( pxStacklessTask );
+
+    pxSession->xStart = xTaskGetTickCount();
+    stacklessDELAY( pxStacklessTask, stacklesstestDELAY );
+    pxSession->xDelayed = xTaskGetTickCount();
+
+    /* Nothing notifies the stackless task, so the wait times out. */
+    stacklessAWAIT_NOTIFY( pxStacklessTask, stacklesstestSHORT_WAIT, &( pxSession->ulValue ) );
+    pxSession->xTimedOut = xTaskGetTickCount();
+    pxSession->xFinished = pdTRUE;
+
+    stacklessEND( pxStacklessTask );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvYieldingStackless( StacklessTask_t * pxStacklessTask,
+                                  void * pvParameter )
+{
+    StacklessTestSession_t * pxSession = ( StacklessTestSession_t * ) pvParameter;
+
+    stacklessBEGIN( pxStacklessTask );
+
+    for( pxSession->ulCount = 0; pxSession->ulCount < 3; pxSession->ulCount++ )
+    {
+        ulOrder[ ulOrderIndex ] = pxSession->ulValue;
+        ulOrderIndex++;
+        stacklessYIELD( pxStacklessTask );
+    }
+
+    pxSession->xFinished = pdTRUE;
+
+    stacklessEND( pxStacklessTask );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvEchoStackless( StacklessTask_t * pxStacklessTask,
+                              void * pvParameter )
+{
+    StacklessTestSession_t * pxSession = ( StacklessTestSession_t * ) pvParameter;
+
+    stacklessBEGIN( pxStacklessTask );
+
+    for( ; ; )
+    {
+        stacklessAWAIT_NOTIFY( pxStacklessTask, portMAX_DELAY, &( pxSession->ulValue ) );
+        pxSession->ulRuns++;
+        xTaskNotifyGive( xTestTask );
+    }
+
+    stacklessEND( pxStacklessTask );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvEchoTask( void * pvParameters )
+{
+    StacklessTestSession_t * pxSession = ( StacklessTestSession_t * ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        pxSession->ulRuns++;
+        xTaskNotifyGive( xTestTask );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SETS == 1 )
+    static void prvReceivingStackless( StacklessTask_t * pxStacklessTask,
+                                       void * pvParameter )
+    {
+        StacklessTestSession_t * pxSession = ( StacklessTestSession_t * ) pvParameter;
+
+        stacklessBEGIN( pxStacklessTask );
+
+        for( pxSession->ulCount = 0; pxSession->ulCount < stacklesstestITEMS; pxSession->ulCount++ )
+        {
+            stacklessAWAIT_QUEUE_RECEIVE( pxStacklessTask, xTestQueue, &( pxSession->ulItem ), stacklesstestTIMEOUT, &( pxSession->xResult ) );
+
+            if( pxSession->xResult == pdPASS )
+            {
+                pxSession->ulValue += pxSession->ulItem;
+            }
+        }
+
+        /* The queue is now empty, so the wait times out. */
+        stacklessAWAIT_QUEUE_RECEIVE( pxStacklessTask, xTestQueue, &( pxSession->ulItem ), stacklesstestSHORT_WAIT, &( pxSession->xResult ) );
+        pxSession->xFinished = pdTRUE;
+
+        stacklessEND( pxStacklessTask );
+    }
+#endif /* if ( configUSE_QUEUE_SETS == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+/* Waits until the session has finished, and returns pdFALSE if that did not
+ * happen within the timeout. */
+static BaseType_t prvWaitForFinish( StacklessTestSession_t * pxSession )
+{
+    TickType_t xStart = xTaskGetTickCount();
+
+    while( pxSession->xFinished == pdFALSE )
+    {
+        if( ( xTaskGetTickCount() - xStart ) > stacklesstestTIMEOUT )
+        {
+            return pdFALSE;
+        }
+
+        vTaskDelay( 1 );
+    }
+
+    return pdTRUE;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_Stackless );
+
+TEST_SETUP( Full_Stackless )
+{
+    uint32_t ulSession;
+
+    for( ulSession = 0; ulSession < stacklesstestSESSIONS; ulSession++ )
+    {
+        memset( &( xSessions[ ulSession ] ), 0x00, sizeof( StacklessTestSession_t ) );
+    }
+
+    ulOrderIndex = 0;
+    xTestTask = xTaskGetCurrentTaskHandle();
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+}
+
+TEST_TEAR_DOWN( Full_Stackless )
+{
+}
+
+TEST_GROUP_RUNNER( Full_Stackless )
+{
+    RUN_TEST_CASE( Full_Stackless, Stackless_Notify );
+    RUN_TEST_CASE( Full_Stackless, Stackless_DelayAndTimeout );
+    RUN_TEST_CASE( Full_Stackless, Stackless_Yield );
+    RUN_TEST_CASE( Full_Stackless, Stackless_QueueReceive );
+    RUN_TEST_CASE( Full_Stackless, Stackless_QueueSetLength );
+    RUN_TEST_CASE( Full_Stackless, Stackless_Benchmark );
+}
+
+TEST( Full_Stackless, Stackless_Notify )
+{
+    ExecutorHandle_t xExecutor;
+    StacklessTestSession_t * pxSession = &( xSessions[ 0 ] );
+
+    xExecutor = xExecutorCreate( "StacklessTest", stacklesstestSTACK_SIZE, stacklesstestPRIORITY, 0 );
+    TEST_ASSERT_NOT_NULL( xExecutor );
+
+    if( TEST_PROTECT() )
+    {
+        vExecutorStartStacklessTask( xExecutor, &( pxSession->xStackless ), prvNotifiedStackless, pxSession );
+        vTaskDelay( stacklesstestSHORT_WAIT );
+        TEST_ASSERT_EQUAL( pdFALSE, pxSession->xFinished );
+
+        /* Both notifications are received by the one wait. */
+        vTaskSuspendAll();
+        {
+            ( void ) xStacklessNotify( &( pxSession->xStackless ), 0x01UL );
+            ( void ) xStacklessNotify( &( pxSession->xStackless ), 0x04UL );
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForFinish( pxSession ) );
+        TEST_ASSERT_EQUAL_UINT32( 0x05UL, pxSession->ulValue );
+
+        /* A stackless task that has finished can be started again. */
+        pxSession->xFinished = pdFALSE;
+        vExecutorStartStacklessTask( xExecutor, &( pxSession->xStackless ), prvNotifiedStackless, pxSession );
+        ( void ) xStacklessNotify( &( pxSession->xStackless ), 0x02UL );
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForFinish( pxSession ) );
+        TEST_ASSERT_EQUAL_UINT32( 0x02UL, pxSession->ulValue );
+    }
+
+    vExecutorDelete( xExecutor );
+}
+
+TEST( Full_Stackless, Stackless_DelayAndTimeout )
+{
+    ExecutorHandle_t xExecutor;
+    StacklessTestSession_t * pxSession = &( xSessions[ 0 ] );
+
+    xExecutor = xExecutorCreate( "StacklessTest", stacklesstestSTACK_SIZE, stacklesstestPRIORITY, 0 );
+    TEST_ASSERT_NOT_NULL( xExecutor );
+
+    if( TEST_PROTECT() )
+    {
+        pxSession->ulValue = 0xFFFFFFFFUL;
+        vExecutorStartStacklessTask( xExecutor, &( pxSession->xStackless ), prvDelayingStackless, pxSession );
+
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForFinish( pxSession ) );
+        TEST_ASSERT_TRUE( ( pxSession->xDelayed - pxSession->xStart ) >= stacklesstestDELAY );
+        TEST_ASSERT_TRUE( ( pxSession->xTimedOut - pxSession->xDelayed ) >= stacklesstestSHORT_WAIT );
+        TEST_ASSERT_EQUAL_UINT32( 0, pxSession->ulValue );
+    }
+
+    vExecutorDelete( xExecutor );
+}
+
+TEST( Full_Stackless, Stackless_Yield )
+{
+    ExecutorHandle_t xExecutor;
+    uint32_t ulIndex;
+
+    xExecutor = xExecutorCreate( "StacklessTest", stacklesstestSTACK_SIZE, stacklesstestPRIORITY, 0 );
+    TEST_ASSERT_NOT_NULL( xExecutor );
+
+    if( TEST_PROTECT() )
+    {
+        xSessions[ 0 ].ulValue = 0;
+        xSessions[ 1 ].ulValue = 1;
+
+        /* Started together, so the executor runs them in turn. */
+        vTaskSuspendAll();
+        {
+            vExecutorStartStacklessTask( xExecutor, &( xSessions[ 0 ].xStackless ), prvYieldingStackless, &( xSessions[ 0 ] ) );
+            vExecutorStartStacklessTask( xExecutor, &( xSessions[ 1 ].xStackless ), prvYieldingStackless, &( xSessions[ 1 ] ) );
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForFinish( &( xSessions[ 0 ] ) ) );
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForFinish( &( xSessions[ 1 ] ) ) );
+        TEST_ASSERT_EQUAL_UINT32( 6, ulOrderIndex );
+
+        /* With more than one core the executor can run the first stackless task
+         * before the second is started, so the order is only defined on a
+         * single core. */
+        #if ( configNUM_CORES == 1 )
+            for( ulIndex = 0; ulIndex < 6; ulIndex++ )
+            {
+                TEST_ASSERT_EQUAL_UINT32( ulIndex % 2, ulOrder[ ulIndex ] );
+            }
+        #else
+            ( void ) ulIndex;
+        #endif
+    }
+
+    vExecutorDelete( xExecutor );
+}
+
+TEST( Full_Stackless, Stackless_QueueReceive )
+{
+    #if ( configUSE_QUEUE_SETS == 1 )
+        ExecutorHandle_t volatile xExecutor = NULL;
+        StacklessTestSession_t * pxSession = &( xSessions[ 0 ] );
+        uint32_t ulItem;
+
+        xTestQueue = xQueueCreate( stacklesstestQUEUE_LENGTH, sizeof( uint32_t ) );
+        TEST_ASSERT_NOT_NULL( xTestQueue );
+
+        if( TEST_PROTECT() )
+        {
+            xExecutor = xExecutorCreate( "StacklessTest", stacklesstestSTACK_SIZE, stacklesstestPRIORITY, stacklesstestQUEUE_LENGTH );
+            TEST_ASSERT_NOT_NULL( xExecutor );
+            TEST_ASSERT_EQUAL( pdPASS, xExecutorAddQueue( xExecutor, xTestQueue ) );
+
+            vExecutorStartStacklessTask( xExecutor, &( pxSession->xStackless ), prvReceivingStackless, pxSession );
+            vTaskDelay( stacklesstestSHORT_WAIT );
+
+            /* One item is sent while the stackless task waits, and the others
+             * are already queued when it next tests the queue. */
+            ulItem = 1;
+            TEST_ASSERT_EQUAL( pdPASS, xQueueSend( xTestQueue, &ulItem, 0 ) );
+
+            vTaskSuspendAll();
+            {
+                ulItem = 10;
+                ( void ) xQueueSend( xTestQueue, &ulItem, 0 );
+                ulItem = 100;
+                ( void ) xQueueSend( xTestQueue, &ulItem, 0 );
+            }
+            ( void ) xTaskResumeAll();
+
+            TEST_ASSERT_EQUAL( pdTRUE, prvWaitForFinish( pxSession ) );
+            TEST_ASSERT_EQUAL_UINT32( 111, pxSession->ulValue );
+            TEST_ASSERT_EQUAL( errQUEUE_EMPTY, pxSession->xResult );
+
+            TEST_ASSERT_EQUAL( pdPASS, xExecutorRemoveQueue( xExecutor, xTestQueue ) );
+        }
+
+        if( xExecutor != NULL )
+        {
+            vExecutorDelete( xExecutor );
+        }
+
+        vQueueDelete( xTestQueue );
+    #else /* if ( configUSE_QUEUE_SETS == 1 ) */
+        TEST_IGNORE_MESSAGE( "configUSE_QUEUE_SETS is 0." );
+    #endif /* if ( configUSE_QUEUE_SETS == 1 ) */
+}
+
+TEST( Full_Stackless, Stackless_QueueSetLength )
+{
+    #if ( configUSE_QUEUE_SETS == 1 )
+        ExecutorHandle_t volatile xExecutor = NULL;
+        SemaphoreHandle_t xSemaphore;
+
+        xTestQueue = xQueueCreate( stacklesstestQUEUE_LENGTH, sizeof( uint32_t ) );
+        TEST_ASSERT_NOT_NULL( xTestQueue );
+        xSemaphore = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_NULL( xSemaphore );
+
+        if( TEST_PROTECT() )
+        {
+            /* The set has room for the queue or the semaphore, not both. */
+            xExecutor = xExecutorCreate( "StacklessTest", stacklesstestSTACK_SIZE, stacklesstestPRIORITY, stacklesstestQUEUE_LENGTH );
+            TEST_ASSERT_NOT_NULL( xExecutor );
+
+            TEST_ASSERT_EQUAL( pdPASS, xExecutorAddQueue( xExecutor, xSemaphore ) );
+            TEST_ASSERT_EQUAL( pdFAIL, xExecutorAddQueue( xExecutor, xTestQueue ) );
+
+            /* Removing the semaphore makes room for the queue. */
+            TEST_ASSERT_EQUAL( pdPASS, xExecutorRemoveQueue( xExecutor, xSemaphore ) );
+            TEST_ASSERT_EQUAL( pdPASS, xExecutorAddQueue( xExecutor, xTestQueue ) );
+            TEST_ASSERT_EQUAL( pdFAIL, xExecutorAddQueue( xExecutor, xSemaphore ) );
+
+            TEST_ASSERT_EQUAL( pdPASS, xExecutorRemoveQueue( xExecutor, xTestQueue ) );
+        }
+
+        if( xExecutor != NULL )
+        {
+            vExecutorDelete( xExecutor );
+        }
+
+        vSemaphoreDelete( xSemaphore );
+        vQueueDelete( xTestQueue );
+    #else /* if ( configUSE_QUEUE_SETS == 1 ) */
+        TEST_IGNORE_MESSAGE( "configUSE_QUEUE_SETS is 0." );
+    #endif /* if ( configUSE_QUEUE_SETS == 1 ) */
+}
+
+TEST( Full_Stackless, Stackless_Benchmark )
+{
+    ExecutorHandle_t xExecutor;
+    uint32_t ulSession;
+    uint32_t ulRoundTrip;
+    TickType_t xStart;
+    TickType_t xStacklessTicks;
+    TickType_t xTaskTicks = 0;
+    size_t xTaskRam;
+    size_t xStacklessRam;
+
+    xExecutor = xExecutorCreate( "StacklessTest", stacklesstestSTACK_SIZE, stacklesstestPRIORITY, 0 );
+    TEST_ASSERT_NOT_NULL( xExecutor );
+
+    if( TEST_PROTECT() )
+    {
+        for( ulSession = 0; ulSession < stacklesstestSESSIONS; ulSession++ )
+        {
+            vExecutorStartStacklessTask( xExecutor, &( xSessions[ ulSession ].xStackless ), prvEchoStackless, &( xSessions[ ulSession ] ) );
+        }
+
+        xStart = xTaskGetTickCount();
+
+        for( ulRoundTrip = 0; ulRoundTrip < stacklesstestROUND_TRIPS; ulRoundTrip++ )
+        {
+            ( void ) xStacklessNotify( &( xSessions[ ulRoundTrip % stacklesstestSESSIONS ].xStackless ), 0x01UL );
+            TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, stacklesstestTIMEOUT ) );
+        }
+
+        xStacklessTicks = xTaskGetTickCount() - xStart;
+
+        for( ulSession = 0; ulSession < stacklesstestSESSIONS; ulSession++ )
+        {
+            TEST_ASSERT_EQUAL_UINT32( stacklesstestROUND_TRIPS / stacklesstestSESSIONS, xSessions[ ulSession ].ulRuns );
+            xSessions[ ulSession ].ulRuns = 0;
+            TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvEchoTask,
+                                                    "CoEcho",
+                                                    stacklesstestSTACK_SIZE,
+                                                    &( xSessions[ ulSession ] ),
+                                                    stacklesstestPRIORITY,
+                                                    &( xSessions[ ulSession ].xTask ) ) );
+        }
+
+        xStart = xTaskGetTickCount();
+
+        for( ulRoundTrip = 0; ulRoundTrip < stacklesstestROUND_TRIPS; ulRoundTrip++ )
+        {
+            xTaskNotifyGive( xSessions[ ulRoundTrip % stacklesstestSESSIONS ].xTask );
+            TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, stacklesstestTIMEOUT ) );
+        }
+
+        xTaskTicks = xTaskGetTickCount() - xStart;
+
+        /* The RAM each approach needs for the sessions, leaving out the heap
+         * overhead of each allocation. */
+        xTaskRam = stacklesstestSESSIONS * ( sizeof( StaticTask_t ) + ( stacklesstestSTACK_SIZE * sizeof( StackType_t ) ) );
+        xStacklessRam = ( stacklesstestSESSIONS * sizeof( StacklessTask_t ) ) + sizeof( StaticTask_t ) + ( stacklesstestSTACK_SIZE * sizeof( StackType_t ) );
+
+        configPRINTF( ( "Stackless: %u sessions use %u bytes as tasks, %u bytes as stackless tasks.\r\n",
+                        ( unsigned int ) stacklesstestSESSIONS,
+                        ( unsigned int ) xTaskRam,
+                        ( unsigned int ) xStacklessRam ) );
+        configPRINTF( ( "Stackless: %u round trips, %u ms with tasks, %u ms with stackless tasks.\r\n",
+                        ( unsigned int ) stacklesstestROUND_TRIPS,
+                        ( unsigned int ) ( xTaskTicks * portTICK_PERIOD_MS ),
+                        ( unsigned int ) ( xStacklessTicks * portTICK_PERIOD_MS ) ) );
+
+        TEST_ASSERT_TRUE( xStacklessRam < xTaskRam );
+    }
+
+    for( ulSession = 0; ulSession < stacklesstestSESSIONS; ulSession++ )
+    {
+        if( xSessions[ ulSession ].xTask != NULL )
+        {
+            vTaskDelete( xSessions[ ulSession ].xTask );
+        }
+    }
+
+    vExecutorDelete( xExecutor );
+}
@@ -0,0 +1,291 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Tests for the indexed task notifications, and a comparison of their cost
+ * with the binary semaphores they can replace. */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define notifytestROUND_TRIPS        ( 10000 )
+#define notifytestTIMEOUT            ( pdMS_TO_TICKS( 30000 ) )
+#define notifytestPEER_PRIORITY      ( configMAX_PRIORITIES - 1 )
+#define notifytestLAST_INDEX         ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+
+/* The semaphores used by the peer task in the binary semaphore benchmark. */
+static SemaphoreHandle_t xPingSemaphore = NULL;
+static SemaphoreHandle_t xPongSemaphore = NULL;
+
+/* The task that started the benchmark, and is notified by the peer task. */
+static TaskHandle_t xTestTask = NULL;
+
+/*-----------------------------------------------------------*/
+
+static void prvSemaphorePeerTask( void * pvParameters )
+{
+    uint32_t ulRoundTrip;
+
+    ( void ) pvParameters;
+
+    for( ulRoundTrip = 0; ulRoundTrip < notifytestROUND_TRIPS; ulRoundTrip++ )
+    {
+        ( void ) xSemaphoreTake( xPingSemaphore, portMAX_DELAY );
+        ( void ) xSemaphoreGive( xPongSemaphore );
+    }
+
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvNotifyPeerTask( void * pvParameters )
+{
+    uint32_t ulRoundTrip;
+
+    ( void ) pvParameters;
+
+    for( ulRoundTrip = 0; ulRoundTrip < notifytestROUND_TRIPS; ulRoundTrip++ )
+    {
+        /* Use the last index so the default index is free for other
+         * notifications, as a library would. */
+        ( void ) ulTaskNotifyTakeIndexed( notifytestLAST_INDEX, pdTRUE, portMAX_DELAY );
+        ( void ) xTaskNotifyGiveIndexed( xTestTask, notifytestLAST_INDEX );
+    }
+
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Runs notifytestROUND_TRIPS exchanges between the calling task and a higher
+ * priority peer task with binary semaphores, and returns the number of ticks
+ * they took, or portMAX_DELAY if an exchange timed out. */
+static TickType_t prvRunSemaphoreRoundTrips( void )
+{
+    uint32_t ulRoundTrip;
+    TickType_t xStart;
+    TickType_t xElapsed = portMAX_DELAY;
+
+    xPingSemaphore = xSemaphoreCreateBinary();
+    xPongSemaphore = xSemaphoreCreateBinary();
+
+    if( ( xPingSemaphore != NULL ) &&
+        ( xPongSemaphore != NULL ) &&
+        ( xTaskCreate( prvSemaphorePeerTask,
+                       "NotifyS",
+                       configMINIMAL_STACK_SIZE,
+                       NULL,
+                       notifytestPEER_PRIORITY,
+                       NULL ) == pdPASS ) )
+    {
+        xStart = xTaskGetTickCount();
+
+        for( ulRoundTrip = 0; ulRoundTrip < notifytestROUND_TRIPS; ulRoundTrip++ )
+        {
+            ( void ) xSemaphoreGive( xPingSemaphore );
+
+            if( xSemaphoreTake( xPongSemaphore, notifytestTIMEOUT ) != pdTRUE )
+            {
+                break;
+            }
+        }
+
+        if( ulRoundTrip == notifytestROUND_TRIPS )
+        {
+            xElapsed = xTaskGetTickCount() - xStart;
+        }
+    }
+
+    /* Let the idle task free the peer task before its semaphores go. */
+    vTaskDelay( pdMS_TO_TICKS( 10 ) );
+
+    if( xPingSemaphore != NULL )
+    {
+        vSemaphoreDelete( xPingSemaphore );
+        xPingSemaphore = NULL;
+    }
+
+    if( xPongSemaphore != NULL )
+    {
+        vSemaphoreDelete( xPongSemaphore );
+        xPongSemaphore = NULL;
+    }
+
+    return xElapsed;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Runs the same exchanges as prvRunSemaphoreRoundTrips() with direct to task
+ * notifications. */
+static TickType_t prvRunNotifyRoundTrips( void )
+{
+    uint32_t ulRoundTrip;
+    TickType_t xStart;
+    TickType_t xElapsed = portMAX_DELAY;
+    TaskHandle_t xPeerTask = NULL;
+
+    xTestTask = xTaskGetCurrentTaskHandle();
+    ( void ) xTaskNotifyStateClearIndexed( NULL, notifytestLAST_INDEX );
+    ( void ) ulTaskNotifyTakeIndexed( notifytestLAST_INDEX, pdTRUE, 0 );
+
+    if( xTaskCreate( prvNotifyPeerTask,
+                     "NotifyN",
+                     configMINIMAL_STACK_SIZE,
+                     NULL,
+                     notifytestPEER_PRIORITY,
+                     &xPeerTask ) == pdPASS )
+    {
+        xStart = xTaskGetTickCount();
+
+        for( ulRoundTrip = 0; ulRoundTrip < notifytestROUND_TRIPS; ulRoundTrip++ )
+        {
+            ( void ) xTaskNotifyGiveIndexed( xPeerTask, notifytestLAST_INDEX );
+
+            if( ulTaskNotifyTakeIndexed( notifytestLAST_INDEX, pdTRUE, notifytestTIMEOUT ) == 0 )
+            {
+                break;
+            }
+        }
+
+        if( ulRoundTrip == notifytestROUND_TRIPS )
+        {
+            xElapsed = xTaskGetTickCount() - xStart;
+        }
+    }
+
+    vTaskDelay( pdMS_TO_TICKS( 10 ) );
+
+    return xElapsed;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_TaskNotify );
+
+TEST_SETUP( Full_TaskNotify )
+{
+}
+
+TEST_TEAR_DOWN( Full_TaskNotify )
+{
+    /* Do not leave notifications pending for the tests that follow. */
+    UBaseType_t uxIndex;
+
+    for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+    {
+        ( void ) xTaskNotifyStateClearIndexed( NULL, uxIndex );
+        ( void ) ulTaskNotifyTakeIndexed( uxIndex, pdTRUE, 0 );
+    }
+}
+
+TEST_GROUP_RUNNER( Full_TaskNotify )
+{
+    RUN_TEST_CASE( Full_TaskNotify, TaskNotify_DefaultIndex );
+    RUN_TEST_CASE( Full_TaskNotify, TaskNotify_IndexesAreIndependent );
+    RUN_TEST_CASE( Full_TaskNotify, TaskNotify_Benchmark );
+}
+
+TEST( Full_TaskNotify, TaskNotify_DefaultIndex )
+{
+    uint32_t ulValue = 0;
+    TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+
+    /* The functions without an index work on tskDEFAULT_INDEX_TO_NOTIFY. */
+    TEST_ASSERT_EQUAL( pdPASS, xTaskNotify( xTask, 0x5aU, eSetValueWithOverwrite ) );
+    TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyWaitIndexed( tskDEFAULT_INDEX_TO_NOTIFY, 0, 0xffffffffUL, &ulValue, 0 ) );
+    TEST_ASSERT_EQUAL_UINT32( 0x5aU, ulValue );
+
+    TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyGiveIndexed( xTask, tskDEFAULT_INDEX_TO_NOTIFY ) );
+    TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, 0 ) );
+    TEST_ASSERT_EQUAL( pdFAIL, xTaskNotifyWait( 0, 0, NULL, 0 ) );
+}
+
+TEST( Full_TaskNotify, TaskNotify_IndexesAreIndependent )
+{
+    #if ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 )
+        uint32_t ulValue = 0;
+        TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+
+        /* A notification pending on the last index is not seen on index 0. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyIndexed( xTask, notifytestLAST_INDEX, 0x1234U, eSetValueWithoutOverwrite ) );
+        TEST_ASSERT_EQUAL( pdFAIL, xTaskNotifyWait( 0, 0, NULL, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulTaskNotifyTake( pdTRUE, 0 ) );
+
+        /* Overwriting is refused on the index that has a notification
+         * pending, but not on the others. */
+        TEST_ASSERT_EQUAL( pdFAIL, xTaskNotifyIndexed( xTask, notifytestLAST_INDEX, 0x4321U, eSetValueWithoutOverwrite ) );
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotify( xTask, 0x4321U, eSetValueWithoutOverwrite ) );
+
+        /* Clearing the state of index 0 leaves the last index pending. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyStateClear( NULL ) );
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyAndQueryIndexed( xTask, notifytestLAST_INDEX, 0x10000U, eSetBits, &ulValue ) );
+        TEST_ASSERT_EQUAL_UINT32( 0x1234U, ulValue );
+
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyWaitIndexed( notifytestLAST_INDEX, 0, 0xffffffffUL, &ulValue, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( 0x11234U, ulValue );
+        TEST_ASSERT_EQUAL( pdFAIL, xTaskNotifyWaitIndexed( notifytestLAST_INDEX, 0, 0, NULL, 0 ) );
+    #else
+        TEST_IGNORE_MESSAGE( "configTASK_NOTIFICATION_ARRAY_ENTRIES is 1." );
+    #endif
+}
+
+TEST( Full_TaskNotify, TaskNotify_Benchmark )
+{
+    UBaseType_t uxOriginalPriority = uxTaskPriorityGet( NULL );
+    TickType_t xSemaphoreTicks;
+    TickType_t xNotifyTicks;
+
+    /* Run below the peer task, so each exchange is two context switches. */
+    vTaskPrioritySet( NULL, notifytestPEER_PRIORITY - 1 );
+
+    xSemaphoreTicks = prvRunSemaphoreRoundTrips();
+    xNotifyTicks = prvRunNotifyRoundTrips();
+
+    vTaskPrioritySet( NULL, uxOriginalPriority );
+
+    TEST_ASSERT_TRUE( xSemaphoreTicks != portMAX_DELAY );
+    TEST_ASSERT_TRUE( xNotifyTicks != portMAX_DELAY );
+
+    configPRINTF( ( "TaskNotify: %u round trips, binary semaphores %u ticks, notifications %u ticks.\r\n",
+                    ( unsigned int ) notifytestROUND_TRIPS,
+                    ( unsigned int ) xSemaphoreTicks,
+                    ( unsigned int ) xNotifyTicks ) );
+}
@@ -0,0 +1,382 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Tests for the work queues, and a comparison of their cost with deferring
+ * the same work with xTimerPendFunctionCall(). */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "work_queue.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define worktestSTACK_SIZE          ( configMINIMAL_STACK_SIZE * 2 )
+#define worktestHIGH_PRIORITY       ( configMAX_PRIORITIES - 2 )
+#define worktestLOW_PRIORITY        ( tskIDLE_PRIORITY + 1 )
+#define worktestITEMS               ( 32 )
+#define worktestSUBMISSIONS         ( 10 )
+#define worktestDEFERRALS           ( 10000 )
+#define worktestTIMEOUT             ( pdMS_TO_TICKS( 30000 ) )
+
+/* The items submitted by the tests. */
+static WorkItem_t xItems[ worktestITEMS ];
+
+/* The number of times each item's function has run. */
+static volatile uint32_t ulRuns[ worktestITEMS ];
+
+/* The order in which the functions ran, for the priority test. */
+static volatile uint32_t ulOrder[ worktestITEMS ];
+static volatile uint32_t ulOrderIndex;
+
+/* The total number of functions run. */
+static volatile uint32_t ulTotalRuns;
+
+/*-----------------------------------------------------------*/
+
+static void prvCountRun( void * pvParameter )
+{
+    uint32_t ulItem = ( uint32_t ) ( uintptr_t ) pvParameter;
+
+    ulRuns[ ulItem ]++;
+
+    if( ulOrderIndex < worktestITEMS )
+    {
+        ulOrder[ ulOrderIndex ] = ulItem;
+        ulOrderIndex++;
+    }
+
+    ulTotalRuns++;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 )
+    static void prvPendedRun( void * pvParameter1,
+                              uint32_t ulParameter2 )
+    {
+        ( void ) pvParameter1;
+        ( void ) ulParameter2;
+
+        ulTotalRuns++;
+    }
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Waits until the functions have run ulExpected times in total, and returns
+ * pdFALSE if that did not happen within the timeout. */
+static BaseType_t prvWaitForRuns( uint32_t ulExpected )
+{
+    TickType_t xStart = xTaskGetTickCount();
+
+    while( ulTotalRuns < ulExpected )
+    {
+        if( ( xTaskGetTickCount() - xStart ) > worktestTIMEOUT )
+        {
+            return pdFALSE;
+        }
+
+        vTaskDelay( 1 );
+    }
+
+    return pdTRUE;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_WorkQueue );
+
+TEST_SETUP( Full_WorkQueue )
+{
+    uint32_t ulItem;
+
+    for( ulItem = 0; ulItem < worktestITEMS; ulItem++ )
+    {
+        vWorkQueueInitialiseItem( &( xItems[ ulItem ] ), prvCountRun, ( void * ) ( uintptr_t ) ulItem );
+        ulRuns[ ulItem ] = 0;
+        ulOrder[ ulItem ] = 0;
+    }
+
+    ulOrderIndex = 0;
+    ulTotalRuns = 0;
+}
+
+TEST_TEAR_DOWN( Full_WorkQueue )
+{
+}
+
+TEST_GROUP_RUNNER( Full_WorkQueue )
+{
+    RUN_TEST_CASE( Full_WorkQueue, WorkQueue_Coalescing );
+    RUN_TEST_CASE( Full_WorkQueue, WorkQueue_Batching );
+    RUN_TEST_CASE( Full_WorkQueue, WorkQueue_Cancel );
+    RUN_TEST_CASE( Full_WorkQueue, WorkQueue_Priorities );
+    RUN_TEST_CASE( Full_WorkQueue, WorkQueue_Benchmark );
+}
+
+TEST( Full_WorkQueue, WorkQueue_Coalescing )
+{
+    WorkQueueHandle_t xWorkQueue;
+    WorkQueueStats_t xStats;
+    uint32_t ulSubmission;
+
+    xWorkQueue = xWorkQueueCreate( "WQTest", worktestSTACK_SIZE, worktestHIGH_PRIORITY, 0 );
+    TEST_ASSERT_NOT_NULL( xWorkQueue );
+
+    if( TEST_PROTECT() )
+    {
+        /* The worker task cannot run until the scheduler is resumed, so the
+         * later submissions find the item still pending. */
+        vTaskSuspendAll();
+        {
+            for( ulSubmission = 0; ulSubmission < worktestSUBMISSIONS; ulSubmission++ )
+            {
+                ( void ) xWorkQueueSubmit( xWorkQueue, &( xItems[ 0 ] ) );
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRuns( 1 ) );
+        vTaskDelay( pdMS_TO_TICKS( 50 ) );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulRuns[ 0 ] );
+
+        vWorkQueueGetStats( xWorkQueue, &xStats );
+        TEST_ASSERT_EQUAL_UINT32( 1, xStats.ulSubmitted );
+        TEST_ASSERT_EQUAL_UINT32( worktestSUBMISSIONS - 1, xStats.ulCoalesced );
+        TEST_ASSERT_EQUAL_UINT32( 1, xStats.ulExecuted );
+
+        /* Once the function has run the item is submitted again. */
+        TEST_ASSERT_EQUAL( pdTRUE, xWorkQueueSubmit( xWorkQueue, &( xItems[ 0 ] ) ) );
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRuns( 2 ) );
+        TEST_ASSERT_EQUAL_UINT32( 2, ulRuns[ 0 ] );
+    }
+
+    vWorkQueueDelete( xWorkQueue );
+}
+
+TEST( Full_WorkQueue, WorkQueue_Batching )
+{
+    WorkQueueHandle_t xWorkQueue;
+    WorkQueueStats_t xStats;
+    uint32_t ulItem;
+    volatile uint32_t ulAdded = 0;
+
+    xWorkQueue = xWorkQueueCreate( "WQTest", worktestSTACK_SIZE, worktestHIGH_PRIORITY, 0 );
+    TEST_ASSERT_NOT_NULL( xWorkQueue );
+
+    if( TEST_PROTECT() )
+    {
+        vTaskSuspendAll();
+        {
+            for( ulItem = 0; ulItem < worktestITEMS; ulItem++ )
+            {
+                if( xWorkQueueSubmit( xWorkQueue, &( xItems[ ulItem ] ) ) == pdTRUE )
+                {
+                    ulAdded++;
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_EQUAL_UINT32( worktestITEMS, ulAdded );
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRuns( worktestITEMS ) );
+
+        /* Only the first item notified the worker task, which then ran all the
+         * items in the order they were submitted. */
+        vWorkQueueGetStats( xWorkQueue, &xStats );
+        TEST_ASSERT_EQUAL_UINT32( worktestITEMS, xStats.ulExecuted );
+        TEST_ASSERT_EQUAL_UINT32( 1, xStats.ulWakeups );
+        TEST_ASSERT_EQUAL( worktestITEMS, xStats.uxMaxPending );
+
+        for( ulItem = 0; ulItem < worktestITEMS; ulItem++ )
+        {
+            TEST_ASSERT_EQUAL_UINT32( ulItem, ulOrder[ ulItem ] );
+        }
+    }
+
+    vWorkQueueDelete( xWorkQueue );
+}
+
+TEST( Full_WorkQueue, WorkQueue_Cancel )
+{
+    WorkQueueHandle_t xWorkQueue;
+    BaseType_t xCancelled[ 4 ];
+
+    xWorkQueue = xWorkQueueCreate( "WQTest", worktestSTACK_SIZE, worktestHIGH_PRIORITY, 0 );
+    TEST_ASSERT_NOT_NULL( xWorkQueue );
+
+    if( TEST_PROTECT() )
+    {
+        /* Cancel the middle, first and last items. */
+        vTaskSuspendAll();
+        {
+            ( void ) xWorkQueueSubmit( xWorkQueue, &( xItems[ 0 ] ) );
+            ( void ) xWorkQueueSubmit( xWorkQueue, &( xItems[ 1 ] ) );
+            ( void ) xWorkQueueSubmit( xWorkQueue, &( xItems[ 2 ] ) );
+            ( void ) xWorkQueueSubmit( xWorkQueue, &( xItems[ 3 ] ) );
+            xCancelled[ 0 ] = xWorkQueueCancel( xWorkQueue, &( xItems[ 1 ] ) );
+            xCancelled[ 1 ] = xWorkQueueCancel( xWorkQueue, &( xItems[ 0 ] ) );
+            xCancelled[ 2 ] = xWorkQueueCancel( xWorkQueue, &( xItems[ 3 ] ) );
+            xCancelled[ 3 ] = xWorkQueueCancel( xWorkQueue, &( xItems[ 3 ] ) );
+
+            /* The tail was removed, so this must be linked after item 2. */
+            ( void ) xWorkQueueSubmit( xWorkQueue, &( xItems[ 4 ] ) );
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_EQUAL( pdTRUE, xCancelled[ 0 ] );
+        TEST_ASSERT_EQUAL( pdTRUE, xCancelled[ 1 ] );
+        TEST_ASSERT_EQUAL( pdTRUE, xCancelled[ 2 ] );
+        TEST_ASSERT_EQUAL( pdFALSE, xCancelled[ 3 ] );
+
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRuns( 2 ) );
+        vTaskDelay( pdMS_TO_TICKS( 50 ) );
+
+        TEST_ASSERT_EQUAL_UINT32( 0, ulRuns[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulRuns[ 1 ] );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulRuns[ 2 ] );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulRuns[ 3 ] );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulRuns[ 4 ] );
+
+        /* An item that has run is no longer pending. */
+        TEST_ASSERT_EQUAL( pdFALSE, xWorkQueueCancel( xWorkQueue, &( xItems[ 2 ] ) ) );
+    }
+
+    vWorkQueueDelete( xWorkQueue );
+}
+
+TEST( Full_WorkQueue, WorkQueue_Priorities )
+{
+    WorkQueueHandle_t xHighQueue = NULL;
+    WorkQueueHandle_t xLowQueue = NULL;
+
+    xHighQueue = xWorkQueueCreate( "WQHigh", worktestSTACK_SIZE, worktestHIGH_PRIORITY, 0 );
+    xLowQueue = xWorkQueueCreate( "WQLow", worktestSTACK_SIZE, worktestLOW_PRIORITY, 0 );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_NOT_NULL( xHighQueue );
+        TEST_ASSERT_NOT_NULL( xLowQueue );
+
+        vTaskSuspendAll();
+        {
+            ( void ) xWorkQueueSubmit( xLowQueue, &( xItems[ 0 ] ) );
+            ( void ) xWorkQueueSubmit( xHighQueue, &( xItems[ 1 ] ) );
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRuns( 2 ) );
+
+        /* With more than one core both workers can run at once, so the order
+         * is only defined on a single core. */
+        #if ( configNUM_CORES == 1 )
+            TEST_ASSERT_EQUAL_UINT32( 1, ulOrder[ 0 ] );
+            TEST_ASSERT_EQUAL_UINT32( 0, ulOrder[ 1 ] );
+        #endif
+    }
+
+    if( xHighQueue != NULL )
+    {
+        vWorkQueueDelete( xHighQueue );
+    }
+
+    if( xLowQueue != NULL )
+    {
+        vWorkQueueDelete( xLowQueue );
+    }
+}
+
+TEST( Full_WorkQueue, WorkQueue_Benchmark )
+{
+    #if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 )
+        WorkQueueHandle_t xWorkQueue;
+        WorkQueueStats_t xStats;
+        TickType_t xStart;
+        TickType_t xPendTicks;
+        TickType_t xWorkTicks;
+        uint32_t ulDeferral;
+
+        /* Run the worker task at the same priority as the timer service task,
+         * so both defer the work to a task of the same priority. */
+        xWorkQueue = xWorkQueueCreate( "WQTest", worktestSTACK_SIZE, configTIMER_TASK_PRIORITY, 0 );
+        TEST_ASSERT_NOT_NULL( xWorkQueue );
+
+        if( TEST_PROTECT() )
+        {
+            xStart = xTaskGetTickCount();
+
+            for( ulDeferral = 0; ulDeferral < worktestDEFERRALS; ulDeferral++ )
+            {
+                TEST_ASSERT_EQUAL( pdPASS, xTimerPendFunctionCall( prvPendedRun, NULL, 0, worktestTIMEOUT ) );
+            }
+
+            TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRuns( worktestDEFERRALS ) );
+            xPendTicks = xTaskGetTickCount() - xStart;
+
+            ulTotalRuns = 0;
+            xStart = xTaskGetTickCount();
+
+            for( ulDeferral = 0; ulDeferral < worktestDEFERRALS; ulDeferral++ )
+            {
+                ( void ) xWorkQueueSubmit( xWorkQueue, &( xItems[ ulDeferral % worktestITEMS ] ) );
+            }
+
+            /* If the worker task runs on another core an item can still be
+             * pending when it is submitted again, so fewer functions run. */
+            vWorkQueueGetStats( xWorkQueue, &xStats );
+            TEST_ASSERT_EQUAL_UINT32( worktestDEFERRALS, xStats.ulSubmitted + xStats.ulCoalesced );
+            TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRuns( xStats.ulSubmitted ) );
+            xWorkTicks = xTaskGetTickCount() - xStart;
+
+            vWorkQueueGetStats( xWorkQueue, &xStats );
+
+            configPRINTF( ( "WorkQueue: %u deferrals, %u ms with xTimerPendFunctionCall(), %u ms with a work queue (%u wakeups, max latency %u ticks).\r\n",
+                            ( unsigned int ) worktestDEFERRALS,
+                            ( unsigned int ) ( xPendTicks * portTICK_PERIOD_MS ),
+                            ( unsigned int ) ( xWorkTicks * portTICK_PERIOD_MS ),
+                            ( unsigned int ) xStats.ulWakeups,
+                            ( unsigned int ) xStats.xMaxLatency ) );
+
+            TEST_ASSERT_EQUAL_UINT32( xStats.ulSubmitted, xStats.ulExecuted );
+        }
+
+        vWorkQueueDelete( xWorkQueue );
+    #else /* if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) */
+        TEST_IGNORE_MESSAGE( "xTimerPendFunctionCall() is not available." );
+    #endif /* if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) */
+}
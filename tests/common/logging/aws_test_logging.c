@@ -0,0 +1,248 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Tests for the binary ring logging implementation in
+ * aws_logging_task_binary_ring.c, which must be the logging implementation
+ * linked into the test project. */
+
+/* Standard includes. */
+#include <limits.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Logging includes. */
+#include "aws_logging_task.h"
+#include "aws_logging_binary_ring.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define loggingtestBENCHMARK_ITERATIONS    ( 1000 )
+#define loggingtestBENCHMARK_BATCH         ( 10 )
+#define loggingtestBURST_LENGTH            ( 500 )
+#define loggingtestFLUSH_TIMEOUT           ( pdMS_TO_TICKS( 5000 ) )
+#define loggingtestFORMAT_BUFFER_LENGTH    ( 128 )
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_Logging );
+
+TEST_SETUP( Full_Logging )
+{
+}
+
+TEST_TEAR_DOWN( Full_Logging )
+{
+}
+
+TEST_GROUP_RUNNER( Full_Logging )
+{
+    RUN_TEST_CASE( Full_Logging, vLoggingPrintf_Benchmark );
+    RUN_TEST_CASE( Full_Logging, vLoggingPrintf_DropsCounted );
+    RUN_TEST_CASE( Full_Logging, xLoggingFormat_Strings );
+    RUN_TEST_CASE( Full_Logging, xLoggingFormat_LongLong );
+    RUN_TEST_CASE( Full_Logging, xLoggingFormat_StarWidthAndPrecision );
+    RUN_TEST_CASE( Full_Logging, xLoggingFormat_Percent );
+    RUN_TEST_CASE( Full_Logging, xLoggingFormat_UnsupportedConversion );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Formats a message with xLoggingFormat().
+ */
+static size_t prvLoggingFormat( char * pcBuffer,
+                                size_t xBufferLength,
+                                const char * pcFormat,
+                                ... )
+{
+    va_list xArguments;
+    size_t xLength;
+
+    va_start( xArguments, pcFormat );
+    xLength = xLoggingFormat( pcBuffer, xBufferLength, pcFormat, xArguments );
+    va_end( xArguments );
+
+    return xLength;
+}
+
+/**
+ * @brief Checks that the logging task would output the same text as
+ * snprintf() for a message.
+ */
+static void prvCheckFormat( const char * pcFormat,
+                            ... )
+{
+    char cExpected[ loggingtestFORMAT_BUFFER_LENGTH ];
+    char cActual[ loggingtestFORMAT_BUFFER_LENGTH ];
+    va_list xArguments;
+    va_list xCopy;
+    int lExpectedLength;
+    size_t xActualLength;
+
+    va_start( xArguments, pcFormat );
+    va_copy( xCopy, xArguments );
+    lExpectedLength = vsnprintf( cExpected, sizeof( cExpected ), pcFormat, xArguments );
+    xActualLength = xLoggingFormat( cActual, sizeof( cActual ), pcFormat, xCopy );
+    va_end( xCopy );
+    va_end( xArguments );
+
+    TEST_ASSERT_EQUAL_STRING_MESSAGE( cExpected, cActual, pcFormat );
+    TEST_ASSERT_EQUAL_INT32_MESSAGE( lExpectedLength, ( int32_t ) xActualLength, pcFormat );
+}
+
+TEST( Full_Logging, vLoggingPrintf_Benchmark )
+{
+    uint32_t ulIteration;
+    uint32_t ulBatch;
+    TickType_t xStart;
+    TickType_t xTotalTicks = 0;
+    LoggingStats_t xBefore;
+    LoggingStats_t xAfter;
+
+    TEST_ASSERT_EQUAL( pdPASS, xLoggingFlush( loggingtestFLUSH_TIMEOUT ) );
+    vLoggingGetStats( &xBefore );
+
+    /* Time the calls in batches small enough to fit in the ring, flushing
+     * between batches, so the time spent by the logging task formatting the
+     * messages is not included. */
+    for( ulIteration = 0; ulIteration < loggingtestBENCHMARK_ITERATIONS; ulIteration += loggingtestBENCHMARK_BATCH )
+    {
+        xStart = xTaskGetTickCount();
+
+        for( ulBatch = 0; ulBatch < loggingtestBENCHMARK_BATCH; ulBatch++ )
+        {
+            vLoggingPrintf( "Benchmark %u of %u, %s\r\n",
+                            ( unsigned int ) ( ulIteration + ulBatch ),
+                            ( unsigned int ) loggingtestBENCHMARK_ITERATIONS,
+                            "binary ring" );
+        }
+
+        xTotalTicks += xTaskGetTickCount() - xStart;
+        TEST_ASSERT_EQUAL( pdPASS, xLoggingFlush( loggingtestFLUSH_TIMEOUT ) );
+    }
+
+    vLoggingGetStats( &xAfter );
+
+    configPRINTF( ( "vLoggingPrintf: %u calls in %u ms, %u dropped.\r\n",
+                    ( unsigned int ) loggingtestBENCHMARK_ITERATIONS,
+                    ( unsigned int ) ( xTotalTicks * portTICK_PERIOD_MS ),
+                    ( unsigned int ) ( xAfter.ulDropped - xBefore.ulDropped ) ) );
+
+    TEST_ASSERT_EQUAL_UINT32( loggingtestBENCHMARK_ITERATIONS,
+                              ( xAfter.ulWritten - xBefore.ulWritten ) + ( xAfter.ulDropped - xBefore.ulDropped ) );
+}
+
+TEST( Full_Logging, vLoggingPrintf_DropsCounted )
+{
+    uint32_t ulIteration;
+    LoggingStats_t xBefore;
+    LoggingStats_t xAfter;
+
+    TEST_ASSERT_EQUAL( pdPASS, xLoggingFlush( loggingtestFLUSH_TIMEOUT ) );
+    vLoggingGetStats( &xBefore );
+
+    /* Log faster than the logging task can output.  Every message must be
+     * either written or counted as dropped, and the caller must never block. */
+    for( ulIteration = 0; ulIteration < loggingtestBURST_LENGTH; ulIteration++ )
+    {
+        vLoggingPrintf( "Burst %u\r\n", ( unsigned int ) ulIteration );
+    }
+
+    vLoggingGetStats( &xAfter );
+    TEST_ASSERT_EQUAL( pdPASS, xLoggingFlush( loggingtestFLUSH_TIMEOUT ) );
+
+    configPRINTF( ( "vLoggingPrintf: burst of %u, %u written, %u dropped.\r\n",
+                    ( unsigned int ) loggingtestBURST_LENGTH,
+                    ( unsigned int ) ( xAfter.ulWritten - xBefore.ulWritten ),
+                    ( unsigned int ) ( xAfter.ulDropped - xBefore.ulDropped ) ) );
+
+    TEST_ASSERT_EQUAL_UINT32( loggingtestBURST_LENGTH,
+                              ( xAfter.ulWritten - xBefore.ulWritten ) + ( xAfter.ulDropped - xBefore.ulDropped ) );
+}
+/*-----------------------------------------------------------*/
+
+TEST( Full_Logging, xLoggingFormat_Strings )
+{
+    prvCheckFormat( "%s", "binary ring" );
+    prvCheckFormat( "[%s] [%s]", "", "second" );
+    prvCheckFormat( "[%8s] [%-8s] [%.3s] [%6.2s]", "right", "left", "precision", "both" );
+    prvCheckFormat( "%s %d %s %u %s", "mixed", -1, "with", 2U, "numbers" );
+}
+
+TEST( Full_Logging, xLoggingFormat_LongLong )
+{
+    prvCheckFormat( "%lld %lld %lld", LLONG_MIN, 0LL, LLONG_MAX );
+    prvCheckFormat( "%llu %llx %llX", ULLONG_MAX, 0x0123456789abcdefULL, 0xfedcba9876543210ULL );
+    prvCheckFormat( "%d %lld %d", 1, -1234567890123LL, 2 );
+    prvCheckFormat( "[%20lld] [%-20lld] [%020lld]", 42LL, -42LL, 42LL );
+}
+
+TEST( Full_Logging, xLoggingFormat_StarWidthAndPrecision )
+{
+    prvCheckFormat( "[%*d] [%-*d]", 6, 42, 6, 42 );
+    prvCheckFormat( "[%.*d] [%*.*d]", 5, 42, 8, 5, -42 );
+    prvCheckFormat( "[%.*s] [%*.*s]", 3, "precision", 10, 4, "width and precision" );
+    prvCheckFormat( "[%*lld] [%.*lld]", 24, LLONG_MIN, 21, 7LL );
+
+    /* A negative width means left justified, and a negative precision is
+     * treated as if it were omitted. */
+    prvCheckFormat( "[%*d] [%.*d] [%.*s]", -6, 42, -1, 42, -1, "all" );
+}
+
+TEST( Full_Logging, xLoggingFormat_Percent )
+{
+    prvCheckFormat( "%%" );
+    prvCheckFormat( "100%% of %d%%", 5 );
+    prvCheckFormat( "%%%s%%%%", "between" );
+}
+
+TEST( Full_Logging, xLoggingFormat_UnsupportedConversion )
+{
+    char cExpected[ loggingtestFORMAT_BUFFER_LENGTH ];
+    char cActual[ loggingtestFORMAT_BUFFER_LENGTH ];
+    size_t xLength;
+
+    /* The arguments after a wide character cannot be located, so everything
+     * from the unsupported conversion on is output as it is. */
+    ( void ) snprintf( cExpected, sizeof( cExpected ), "%d %s ", 7, "before" );
+    ( void ) strncat( cExpected, "%lc %d after", sizeof( cExpected ) - strlen( cExpected ) - 1 );
+
+    xLength = prvLoggingFormat( cActual, sizeof( cActual ), "%d %s %lc %d after", 7, "before", 'x', 9 );
+
+    TEST_ASSERT_EQUAL_STRING( cExpected, cActual );
+    TEST_ASSERT_EQUAL_UINT32( strlen( cExpected ), xLength );
+}
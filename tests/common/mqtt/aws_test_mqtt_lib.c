@@ -99,6 +99,14 @@ typedef struct CallbackCounter
  */
 static MQTTContext_t xMQTTContext;
 
+/**
+ * @brief What prvSendvCallback was last asked to transmit.
+ */
+static uint8_t ucSentHeader[ 32 ];
+static uint32_t ulSentHeaderLength;
+static const uint8_t * pucSentPayload;
+static uint32_t ulSentPayloadLength;
+
 /**
  * @brief Callback counter used by all the tests.
  */
@@ -158,6 +166,26 @@ static uint32_t prvSendFailedCallback( void * pvSendContext,
                                        const uint8_t * const pucData,
                                        uint32_t ulDataLength );
 
+/**
+ * @brief The vectored send callback registered with the MQTT library.
+ *
+ * This one records the header and the location of the payload, and
+ * mimics a successful send.
+ *
+ * @param[in] pvSendContext The send context as supplied in Init parameters.
+ * @param[in] pucHeader The header to transmit.
+ * @param[in] ulHeaderLength The length of the header.
+ * @param[in] pucPayload The payload to transmit.
+ * @param[in] ulPayloadLength The length of the payload.
+ *
+ * @return The number of bytes actually transmitted.
+ */
+static uint32_t prvSendvCallback( void * pvSendContext,
+                                  const uint8_t * const pucHeader,
+                                  uint32_t ulHeaderLength,
+                                  const uint8_t * const pucPayload,
+                                  uint32_t ulPayloadLength );
+
 /**
  * @brief Initializes the global callback counter object.
  */
@@ -249,6 +277,27 @@ static uint32_t prvSendFailedCallback( void * pvSendContext,
 }
 /*-----------------------------------------------------------*/
 
+static uint32_t prvSendvCallback( void * pvSendContext,
+                                  const uint8_t * const pucHeader,
+                                  uint32_t ulHeaderLength,
+                                  const uint8_t * const pucPayload,
+                                  uint32_t ulPayloadLength )
+{
+    /* Ensure that the correct context was supplied by the library. */
+    TEST_ASSERT_EQUAL( pvSendContext, testmqttlibSEND_CONTEXT );
+    TEST_ASSERT_TRUE( ulHeaderLength <= sizeof( ucSentHeader ) );
+
+    /* The header is in a buffer that the library recycles, so copy it. */
+    memcpy( ucSentHeader, pucHeader, ulHeaderLength );
+    ulSentHeaderLength = ulHeaderLength;
+    pucSentPayload = pucPayload;
+    ulSentPayloadLength = ulPayloadLength;
+
+    /* Mimic that everything was sent successfully. */
+    return ulHeaderLength + ulPayloadLength;
+}
+/*-----------------------------------------------------------*/
+
 static void prvInitializeCallbackCounter( void )
 {
     xCallbackCounter.ulConnACK = 0;
@@ -268,6 +317,7 @@ static MQTTReturnCode_t prvInitializeMQTTContext( void )
     xInitParams.pvCallbackContext = testmqttlibCALLBACK_CONTEXT;
     xInitParams.pvSendContext = testmqttlibSEND_CONTEXT;
     xInitParams.pxMQTTSendFxn = &( prvSendCallback );
+    xInitParams.pxMQTTSendvFxn = NULL;
     xInitParams.pxGetTicksFxn = NULL;
     xInitParams.xBufferPoolInterface.pxGetBufferFxn = BUFFERPOOL_GetFreeBuffer;
     xInitParams.xBufferPoolInterface.pxReturnBufferFxn = BUFFERPOOL_ReturnBuffer;
@@ -381,6 +431,9 @@ TEST_GROUP_RUNNER( Full_MQTT )
     RUN_TEST_CASE( Full_MQTT, AFQP_MQTT_Connect_SecondConnectWhileAlreadyConnected );
     RUN_TEST_CASE( Full_MQTT, AFQP_MQTT_Connect_SecondConnectWhileWaitingForConnACK );
     RUN_TEST_CASE( Full_MQTT, AFQP_MQTT_Connect_NetworkSendFailed );
+
+    /* MQTT_Publish tests. */
+    RUN_TEST_CASE( Full_MQTT, AFQP_MQTT_Publish_PayloadSentSeparately );
 }
 /*-----------------------------------------------------------*/
 
@@ -725,6 +778,7 @@ TEST( Full_MQTT, AFQP_MQTT_Init_NULLParams )
     xInitParams.pvCallbackContext = testmqttlibCALLBACK_CONTEXT;
     xInitParams.pvSendContext = testmqttlibSEND_CONTEXT;
     xInitParams.pxMQTTSendFxn = NULL; /* This is a required callback and setting it to NULL will fire assert. */
+    xInitParams.pxMQTTSendvFxn = NULL;
     xInitParams.pxGetTicksFxn = NULL;
     xInitParams.xBufferPoolInterface.pxGetBufferFxn = BUFFERPOOL_GetFreeBuffer;
     xInitParams.xBufferPoolInterface.pxReturnBufferFxn = BUFFERPOOL_ReturnBuffer;
@@ -1075,3 +1129,56 @@ TEST( Full_MQTT, AFQP_MQTT_Connect_NetworkSendFailed )
     TEST_ASSERT_EQUAL( 0, xCallbackCounter.ulUnidentified );
 }
 /*-----------------------------------------------------------*/
+
+/**
+ * @brief MQTT publish - The payload is handed to the vectored send callback
+ * without being copied.
+ */
+TEST( Full_MQTT, AFQP_MQTT_Publish_PayloadSentSeparately )
+{
+    MQTTReturnCode_t xReturnCode;
+    MQTTPublishParams_t xPublishParams;
+    static const uint8_t ucPayload[] = { 'p', 'a', 'y', 'l', 'o', 'a', 'd' };
+    static const uint8_t ucExpectedHeader[] =
+    {
+        0x32,                   /* PUBLISH, QoS1. */
+        0x10,                   /* Remaining length: 2 + 5 + 2 + 7. */
+        0x00, 0x05,             /* Topic length. */
+        't', 'o', 'p', 'i', 'c',
+        0x12, 0x34              /* Packet identifier. */
+    };
+
+    /* Connect. */
+    xReturnCode = prvSendMQTTConnect();
+    TEST_ASSERT_EQUAL( eMQTTSuccess, xReturnCode );
+    xReturnCode = prvReceiveMQTTConnACK();
+    TEST_ASSERT_EQUAL( eMQTTSuccess, xReturnCode );
+
+    /* Register the vectored send callback in the MQTT context. */
+    xMQTTContext.pxMQTTSendvFxn = &( prvSendvCallback );
+    ulSentHeaderLength = 0;
+    pucSentPayload = NULL;
+    ulSentPayloadLength = 0;
+
+    xPublishParams.pucTopic = ( const uint8_t * ) "topic";
+    xPublishParams.usTopicLength = 5;
+    xPublishParams.xQos = eMQTTQoS1;
+    xPublishParams.pvData = ucPayload;
+    xPublishParams.ulDataLength = sizeof( ucPayload );
+    xPublishParams.usPacketIdentifier = 0x1234;
+    xPublishParams.ulTimeoutTicks = testmqttlibOPERATION_TIMEOUT_TICKS;
+
+    xReturnCode = MQTT_Publish( &( xMQTTContext ), &( xPublishParams ) );
+    TEST_ASSERT_EQUAL( eMQTTSuccess, xReturnCode );
+
+    /* Only the header must have been encoded; the payload must have been
+     * passed from the caller's buffer. */
+    TEST_ASSERT_EQUAL_UINT32( sizeof( ucExpectedHeader ), ulSentHeaderLength );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( ucExpectedHeader, ucSentHeader, sizeof( ucExpectedHeader ) );
+    TEST_ASSERT_EQUAL_PTR( ucPayload, pucSentPayload );
+    TEST_ASSERT_EQUAL_UINT32( sizeof( ucPayload ), ulSentPayloadLength );
+
+    /* No other callback must have been invoked. */
+    TEST_ASSERT_EQUAL( 0, xCallbackCounter.ulUnidentified );
+}
+/*-----------------------------------------------------------*/
@@ -74,6 +74,15 @@ typedef struct SignVerifyTaskParams
 /* Event group used to synchronize tasks. */
 static EventGroupHandle_t xSyncEventGroup;
 
+/*-----------------------------------------------------------*/
+/*             Session latency benchmark configuration.      */
+/*-----------------------------------------------------------*/
+/* Number of open-find-sign-close cycles timed. This can be configured in
+ * aws_test_pkcs11_config.h. */
+#ifndef pkcs11testSESSION_BENCHMARK_ITERATIONS
+    #define pkcs11testSESSION_BENCHMARK_ITERATIONS    ( 10 )
+#endif
+
 /*-----------------------------------------------------------*/
 /*                Certificates used in tests.                */
 /*-----------------------------------------------------------*/
@@ -1003,6 +1012,7 @@ TEST_GROUP_RUNNER( Full_PKCS11 )
     /* Generated Random tests. */
     RUN_TEST_CASE( Full_PKCS11, AFQP_C_PKCSGenerateRandomInvalidParameters );
     RUN_TEST_CASE( Full_PKCS11, AFQP_C_PKCSGenerateRandomTestHappyTest );
+    RUN_TEST_CASE( Full_PKCS11, AFQP_C_PKCSSeedRandomReseedsGenerator );
 
     /* Test that keys can be parsed. */
     RUN_TEST_CASE( Full_PKCS11, AFQP_TestRSAParse );
@@ -1032,6 +1042,9 @@ TEST_GROUP_RUNNER( Full_PKCS11 )
     /* Test key generation. */
     RUN_TEST_CASE( Full_PKCS11, AFQP_KeyGenerationEcdsaHappyPath );
 
+    /* Time opening sessions, finding the key and signing with it. */
+    RUN_TEST_CASE( Full_PKCS11, AFQP_SessionLatencyBenchmark );
+
     /* Re-provision the device with default RSA certs so that subsequent tests are not changed. */
     vDevModeKeyProvisioning();
 }
@@ -1882,6 +1895,74 @@ TEST( Full_PKCS11, AFQP_C_PKCSGenerateRandomTestHappyTest )
 
 /*-----------------------------------------------------------*/
 
+TEST( Full_PKCS11, AFQP_C_PKCSSeedRandomReseedsGenerator )
+{
+    CK_SESSION_HANDLE xSession = 0;
+    CK_RV xResult = 0;
+    CK_FUNCTION_LIST_PTR pxFunctionList = NULL;
+    CK_SLOT_ID xSlotId = 0;
+    CK_BYTE xSeed[ 16 ] = { 0 };
+    CK_BYTE xBuf[ 16 ];
+    CK_ULONG ulReseedsBefore = 0;
+    CK_ULONG ulReseedsAfterEntropy = 0;
+    CK_ULONG ulReseedsAfterSeed = 0;
+    CK_ULONG ulReseedsAfterBadArgs = 0;
+    CK_RV xBadArgsResult = 0;
+
+    /* Initialize the module and start a private session. */
+    xResult = prvInitializeAndStartSession(
+        &pxFunctionList,
+        &xSlotId,
+        &xSession );
+
+    if( 0 != xResult )
+    {
+        configPRINTF( ( "Could not start session.\r\n" ) );
+    }
+
+    /* Reseed from the entropy source alone, then with extra seed material. */
+    if( 0 == xResult )
+    {
+        ulReseedsBefore = ulPkcs11GetDrbgReseedCount();
+        xResult = pxFunctionList->C_SeedRandom( xSession, NULL, 0 );
+        ulReseedsAfterEntropy = ulPkcs11GetDrbgReseedCount();
+    }
+
+    if( 0 == xResult )
+    {
+        xResult = pxFunctionList->C_SeedRandom( xSession, xSeed, sizeof( xSeed ) );
+        ulReseedsAfterSeed = ulPkcs11GetDrbgReseedCount();
+    }
+
+    /* A missing seed with a length is rejected and does not reseed. */
+    if( 0 == xResult )
+    {
+        xBadArgsResult = pxFunctionList->C_SeedRandom( xSession, NULL, sizeof( xSeed ) );
+        ulReseedsAfterBadArgs = ulPkcs11GetDrbgReseedCount();
+    }
+
+    /* The reseeded generator still works. */
+    if( 0 == xResult )
+    {
+        xResult = pxFunctionList->C_GenerateRandom( xSession, xBuf, sizeof( xBuf ) );
+    }
+
+    /* Cleanup PKCS#11. */
+    if( NULL != pxFunctionList )
+    {
+        ( void ) pxFunctionList->C_CloseSession( xSession );
+        ( void ) pxFunctionList->C_Finalize( NULL );
+    }
+
+    TEST_ASSERT_EQUAL_INT32( 0, xResult );
+    TEST_ASSERT_EQUAL_UINT32( ulReseedsBefore + 1, ulReseedsAfterEntropy );
+    TEST_ASSERT_EQUAL_UINT32( ulReseedsBefore + 2, ulReseedsAfterSeed );
+    TEST_ASSERT_EQUAL_INT32( CKR_ARGUMENTS_BAD, xBadArgsResult );
+    TEST_ASSERT_EQUAL_UINT32( ulReseedsAfterSeed, ulReseedsAfterBadArgs );
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_PKCS11, AFQP_C_PKCSGenerateRandomInvalidParameters )
 {
     CK_SESSION_HANDLE xSession = 0;
@@ -3072,3 +3153,133 @@ TEST( Full_PKCS11, AFQP_KeyGenerationEcdsaHappyPath )
 }
 
 /*-----------------------------------------------------------*/
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_PKCS11, AFQP_SessionLatencyBenchmark )
+{
+    CK_RV xResult = 0;
+    CK_FUNCTION_LIST_PTR pxFunctionList = NULL;
+    CK_SLOT_ID xSlotId = 0;
+    CK_SESSION_HANDLE xSession = 0;
+    CK_ULONG ulCount = 0;
+    CK_ATTRIBUTE xTemplate = { 0 };
+    CK_OBJECT_CLASS xObjClass = CKO_PRIVATE_KEY;
+    CK_OBJECT_HANDLE xPrivateKey = 0;
+    CK_OBJECT_HANDLE xFirstPrivateKey = 0;
+    CK_MECHANISM xMech = { 0 };
+    CK_BYTE pucHash[ cryptoSHA256_DIGEST_BYTES ] = { 0 };
+    CK_BYTE pucSignature[ 256 ] = { 0 };
+    TickType_t xStart = 0;
+    TickType_t xOpenTicks = 0;
+    TickType_t xFindTicks = 0;
+    TickType_t xSignTicks = 0;
+    uint32_t ulIteration = 0;
+
+    prvReprovision( pcValidECDSACertificate, pcValidECDSAPrivateKey, CKK_EC );
+
+    /* Hash the message (the null input). */
+    ( void ) mbedtls_sha256_ret( pucHash, 0, pucHash, 0 );
+
+    /* Initialize the module. The first session pays for any one-time setup. */
+    xResult = prvInitializeAndStartSession(
+        &pxFunctionList,
+        &xSlotId,
+        &xSession );
+
+    if( 0 == xResult )
+    {
+        ( void ) pxFunctionList->C_CloseSession( xSession );
+    }
+
+    xTemplate.type = CKA_CLASS;
+    xTemplate.ulValueLen = sizeof( CKA_CLASS );
+    xTemplate.pValue = &xObjClass;
+    xMech.mechanism = CKM_ECDSA;
+
+    for( ulIteration = 0;
+         ( 0 == xResult ) && ( ulIteration < pkcs11testSESSION_BENCHMARK_ITERATIONS );
+         ulIteration++ )
+    {
+        xStart = xTaskGetTickCount();
+        xResult = pxFunctionList->C_OpenSession(
+            xSlotId,
+            CKF_SERIAL_SESSION,
+            NULL,
+            NULL,
+            &xSession );
+        xOpenTicks += xTaskGetTickCount() - xStart;
+
+        if( 0 != xResult )
+        {
+            break;
+        }
+
+        xStart = xTaskGetTickCount();
+        xResult = pxFunctionList->C_FindObjectsInit( xSession, &xTemplate, 1 );
+
+        if( 0 == xResult )
+        {
+            xResult = pxFunctionList->C_FindObjects( xSession, &xPrivateKey, 1, &ulCount );
+        }
+
+        if( 0 == xResult )
+        {
+            xResult = pxFunctionList->C_FindObjectsFinal( xSession );
+        }
+
+        xFindTicks += xTaskGetTickCount() - xStart;
+
+        /* The key should have the same handle in every session. */
+        if( 0 == ulIteration )
+        {
+            xFirstPrivateKey = xPrivateKey;
+        }
+        else if( ( 0 == xResult ) && ( xPrivateKey != xFirstPrivateKey ) )
+        {
+            configPRINTF( ( "Private key handle changed between sessions.\r\n" ) );
+            xResult = CKR_GENERAL_ERROR;
+        }
+
+        xStart = xTaskGetTickCount();
+
+        if( 0 == xResult )
+        {
+            xResult = pxFunctionList->C_SignInit( xSession, &xMech, xPrivateKey );
+        }
+
+        if( 0 == xResult )
+        {
+            ulCount = sizeof( pucSignature );
+            xResult = pxFunctionList->C_Sign(
+                xSession,
+                pucHash,
+                sizeof( pucHash ),
+                pucSignature,
+                &ulCount );
+        }
+
+        xSignTicks += xTaskGetTickCount() - xStart;
+
+        ( void ) pxFunctionList->C_CloseSession( xSession );
+    }
+
+    if( 0 == xResult )
+    {
+        configPRINTF( ( "PKCS#11 latency over %d sessions, in ticks: open %d, find %d, sign %d.\r\n",
+                        pkcs11testSESSION_BENCHMARK_ITERATIONS,
+                        xOpenTicks,
+                        xFindTicks,
+                        xSignTicks ) );
+    }
+
+    /* Clean-up. */
+    if( NULL != pxFunctionList )
+    {
+        ( void ) pxFunctionList->C_Finalize( NULL );
+    }
+
+    TEST_ASSERT_EQUAL_INT32( 0, xResult );
+}
+
+/*-----------------------------------------------------------*/
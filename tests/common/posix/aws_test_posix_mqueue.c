@@ -50,7 +50,10 @@
 #define posixtestMQ_SMALL_MESSAGE         "Hello"                                  /**< A small test message sent over the mq tests. */
 #define posixtestMQ_SMALL_MESSAGE_SIZE    ( sizeof( posixtestMQ_SMALL_MESSAGE ) )  /**< Length (including null-terminator) of posixtestMQ_SMALL_MESSAGE. */
 #define posixtestMQ_DEFAULT_NAME          "/myqueue"                               /**< Default name of message queues in this test. */
+#define posixtestMQ_SECOND_NAME           "/myqueue2"                              /**< Name of the second queue in tests that use two. */
+#define posixtestMQ_LARGE_MESSAGE_SIZE    ( 8 * posixtestMQ_SMALL_MESSAGE_SIZE )   /**< mq_msgsize of the larger queue in mq_zc_buffer_from_other_queue. */
 #define posixtestMQ_DEFAULT_MODE          0600                                     /**< Default mode argument for mq_open. */
+#define posixtestMQ_MANY_QUEUES           ( 3 * posixconfigMQ_HASH_TABLE_SIZE )    /**< Number of queues open at once in mq_open_unlink_many_queues. */
 /**@} */
 
 /* Default queue attributes used in these tests. */
@@ -86,6 +89,7 @@ TEST_GROUP_RUNNER( Full_POSIX_MQUEUE )
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_open_unlink_attr );
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_open_unlink_twice );
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_open_unlink_two_queues );
+    RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_open_unlink_many_queues );
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_open_flags );
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_open_invalid_params );
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_unlink_invalid_params );
@@ -93,6 +97,9 @@ TEST_GROUP_RUNNER( Full_POSIX_MQUEUE )
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive );
     /*RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive_invalidParams ); */
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive_nonblock );
+    RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_zc_send_receive );
+    RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_zc_invalid_params );
+    RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_zc_buffer_from_other_queue );
 }
 
 /*-----------------------------------------------------------*/
@@ -246,6 +253,106 @@ TEST( Full_POSIX_MQUEUE, mq_open_unlink_two_queues )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Write the name of queue number xIndex of mq_open_unlink_many_queues.
+ */
+static void prvManyQueuesName( char * pcName,
+                               size_t xIndex )
+{
+    ( void ) strcpy( pcName, posixtestMQ_DEFAULT_NAME );
+    pcName += sizeof( posixtestMQ_DEFAULT_NAME ) - 1;
+    pcName[ 0 ] = ( char ) ( 'a' + ( xIndex / 26 ) );
+    pcName[ 1 ] = ( char ) ( 'a' + ( xIndex % 26 ) );
+    pcName[ 2 ] = '\0';
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_MQUEUE, mq_open_unlink_many_queues )
+{
+    int iStatus = 0;
+    size_t xIndex = 0;
+    mqd_t xMqId[ posixtestMQ_MANY_QUEUES ] = { 0 };
+    char pcName[ sizeof( posixtestMQ_DEFAULT_NAME ) + 2 ] = { 0 };
+    char pcReceiveBuffer[ posixtestMQ_SMALL_MESSAGE_SIZE ] = { 0 };
+
+    for( xIndex = 0; xIndex < posixtestMQ_MANY_QUEUES; xIndex++ )
+    {
+        xMqId[ xIndex ] = posixtestMQ_INVALID_MQD;
+    }
+
+    /* Open more queues than there are hash table buckets, so that several
+     * queues share each bucket. */
+    if( TEST_PROTECT() )
+    {
+        for( xIndex = 0; xIndex < posixtestMQ_MANY_QUEUES; xIndex++ )
+        {
+            prvManyQueuesName( pcName, xIndex );
+            xMqId[ xIndex ] = mq_open( pcName, O_CREAT | O_EXCL | O_RDWR, posixtestMQ_DEFAULT_MODE, &xDefaultQueueAttr );
+            TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xMqId[ xIndex ] );
+        }
+
+        /* Send a different message to each queue, tagged with the queue index. */
+        for( xIndex = 0; xIndex < posixtestMQ_MANY_QUEUES; xIndex++ )
+        {
+            ( void ) strcpy( pcReceiveBuffer, posixtestMQ_SMALL_MESSAGE );
+            pcReceiveBuffer[ 0 ] = ( char ) xIndex;
+            iStatus = mq_send( xMqId[ xIndex ], pcReceiveBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+            TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        }
+
+        /* Reopening each queue by name must find the same queue, and each
+         * queue must hold its own message. */
+        for( xIndex = 0; xIndex < posixtestMQ_MANY_QUEUES; xIndex++ )
+        {
+            prvManyQueuesName( pcName, xIndex );
+            TEST_ASSERT_EQUAL_PTR( xMqId[ xIndex ], mq_open( pcName, O_RDWR, posixtestMQ_DEFAULT_MODE, NULL ) );
+            iStatus = mq_close( xMqId[ xIndex ] );
+            TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+            iStatus = ( int ) mq_receive( xMqId[ xIndex ], pcReceiveBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, NULL );
+            TEST_ASSERT_EQUAL_INT( posixtestMQ_SMALL_MESSAGE_SIZE, iStatus );
+            TEST_ASSERT_EQUAL_INT( ( char ) xIndex, pcReceiveBuffer[ 0 ] );
+        }
+
+        /* Remove every other queue, then check that the remaining ones are
+         * still found and the removed ones are not. */
+        for( xIndex = 0; xIndex < posixtestMQ_MANY_QUEUES; xIndex += 2 )
+        {
+            prvManyQueuesName( pcName, xIndex );
+            TEST_ASSERT_EQUAL_INT( 0, mq_close( xMqId[ xIndex ] ) );
+            TEST_ASSERT_EQUAL_INT( 0, mq_unlink( pcName ) );
+            xMqId[ xIndex ] = posixtestMQ_INVALID_MQD;
+        }
+
+        for( xIndex = 0; xIndex < posixtestMQ_MANY_QUEUES; xIndex++ )
+        {
+            prvManyQueuesName( pcName, xIndex );
+
+            if( ( xIndex % 2 ) == 0 )
+            {
+                TEST_ASSERT_EQUAL( posixtestMQ_INVALID_MQD, mq_open( pcName, O_RDWR, posixtestMQ_DEFAULT_MODE, NULL ) );
+                TEST_ASSERT_EQUAL_INT( ENOENT, errno );
+            }
+            else
+            {
+                iStatus = mq_send( xMqId[ xIndex ], posixtestMQ_SMALL_MESSAGE, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+                TEST_ASSERT_EQUAL_INT( 0, iStatus );
+            }
+        }
+    }
+
+    /* Clean up resources used by test. */
+    for( xIndex = 0; xIndex < posixtestMQ_MANY_QUEUES; xIndex++ )
+    {
+        prvManyQueuesName( pcName, xIndex );
+        ( void ) mq_close( xMqId[ xIndex ] );
+        ( void ) mq_unlink( pcName );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_MQUEUE, mq_open_flags )
 {
     volatile mqd_t xMqId = posixtestMQ_INVALID_MQD,
@@ -550,3 +657,200 @@ TEST( Full_POSIX_MQUEUE, mq_send_receive_nonblock )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_MQUEUE, mq_zc_send_receive )
+{
+    int iStatus = 0;
+    int iRound = 0;
+    volatile mqd_t xMqId = posixtestMQ_INVALID_MQD;
+    char * volatile pcBuffer = NULL;
+    char * pcReceived = NULL;
+    char pcReceiveBuffer[ posixtestMQ_SMALL_MESSAGE_SIZE ] = { 0 };
+
+    if( TEST_PROTECT() )
+    {
+        /* Create queue with default parameters. */
+        xMqId = mq_open( posixtestMQ_DEFAULT_NAME,
+                         O_CREAT | O_RDWR,
+                         posixtestMQ_DEFAULT_MODE,
+                         &xDefaultQueueAttr );
+        TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xMqId );
+
+        /* Pass a buffer through the queue a few times, so that buffers kept
+         * for reuse are exercised. */
+        for( iRound = 0; iRound < 3; iRound++ )
+        {
+            pcBuffer = mq_zc_alloc( xMqId );
+            TEST_ASSERT_NOT_NULL( pcBuffer );
+            ( void ) memcpy( pcBuffer, posixtestMQ_SMALL_MESSAGE, posixtestMQ_SMALL_MESSAGE_SIZE );
+
+            iStatus = mq_zc_timedsend( xMqId, pcBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, 0, NULL );
+            TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+            /* The buffer now belongs to the queue. */
+            pcReceived = pcBuffer;
+            pcBuffer = NULL;
+
+            /* The same buffer must be received, without a copy. */
+            iStatus = ( int ) mq_zc_timedreceive( xMqId, ( char ** ) &pcBuffer, NULL, NULL );
+            TEST_ASSERT_EQUAL_INT( posixtestMQ_SMALL_MESSAGE_SIZE, iStatus );
+            TEST_ASSERT_EQUAL_PTR( pcReceived, pcBuffer );
+            TEST_ASSERT_EQUAL_STRING( posixtestMQ_SMALL_MESSAGE, pcBuffer );
+
+            mq_zc_free( xMqId, pcBuffer );
+            pcBuffer = NULL;
+        }
+
+        /* Messages sent with a copy can be received without one, and the
+         * other way around. */
+        iStatus = mq_send( xMqId, posixtestMQ_SMALL_MESSAGE, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = ( int ) mq_zc_timedreceive( xMqId, ( char ** ) &pcBuffer, NULL, NULL );
+        TEST_ASSERT_EQUAL_INT( posixtestMQ_SMALL_MESSAGE_SIZE, iStatus );
+        TEST_ASSERT_EQUAL_STRING( posixtestMQ_SMALL_MESSAGE, pcBuffer );
+
+        iStatus = mq_zc_timedsend( xMqId, pcBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, 0, NULL );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        pcBuffer = NULL;
+
+        iStatus = ( int ) mq_receive( xMqId, pcReceiveBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, NULL );
+        TEST_ASSERT_EQUAL_INT( posixtestMQ_SMALL_MESSAGE_SIZE, iStatus );
+        TEST_ASSERT_EQUAL_STRING( posixtestMQ_SMALL_MESSAGE, pcReceiveBuffer );
+    }
+
+    /* Clean up resources used by test. */
+    mq_zc_free( xMqId, pcBuffer );
+    ( void ) mq_close( xMqId );
+    ( void ) mq_unlink( posixtestMQ_DEFAULT_NAME );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_MQUEUE, mq_zc_invalid_params )
+{
+    int iStatus = 0;
+    volatile mqd_t xMqId = posixtestMQ_INVALID_MQD;
+    char * volatile pcBuffer = NULL;
+    char * pcReceived = NULL;
+
+    /* Try to get a buffer with a bad queue descriptor. */
+    TEST_ASSERT_NULL( mq_zc_alloc( xMqId ) );
+    TEST_ASSERT_EQUAL_INT( EBADF, errno );
+
+    /* Try to receive with a bad queue descriptor. */
+    iStatus = ( int ) mq_zc_timedreceive( xMqId, &pcReceived, NULL, NULL );
+    TEST_ASSERT_EQUAL_INT( -1, iStatus );
+    TEST_ASSERT_EQUAL_INT( EBADF, errno );
+
+    if( TEST_PROTECT() )
+    {
+        /* Create nonblocking queue with default parameters. */
+        xMqId = mq_open( posixtestMQ_DEFAULT_NAME,
+                         O_CREAT | O_RDWR | O_NONBLOCK,
+                         posixtestMQ_DEFAULT_MODE,
+                         &xDefaultQueueAttr );
+        TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xMqId );
+
+        /* Receiving from an empty nonblocking queue fails immediately. */
+        iStatus = ( int ) mq_zc_timedreceive( xMqId, &pcReceived, NULL, NULL );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EAGAIN, errno );
+
+        /* A NULL output pointer is rejected. */
+        iStatus = ( int ) mq_zc_timedreceive( xMqId, NULL, NULL, NULL );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        pcBuffer = mq_zc_alloc( xMqId );
+        TEST_ASSERT_NOT_NULL( pcBuffer );
+
+        /* Attempt to send a message that's larger than mq_msgsize. The
+         * buffer stays with the caller. */
+        iStatus = mq_zc_timedsend( xMqId, pcBuffer, posixtestMQ_SMALL_MESSAGE_SIZE + 1, 0, NULL );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EMSGSIZE, errno );
+
+        /* Attempt to send a NULL buffer. */
+        iStatus = mq_zc_timedsend( xMqId, NULL, posixtestMQ_SMALL_MESSAGE_SIZE, 0, NULL );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+    }
+
+    /* Close and unlink the message queue before giving the buffer back; it is
+     * then freed. */
+    ( void ) mq_close( xMqId );
+    ( void ) mq_unlink( posixtestMQ_DEFAULT_NAME );
+    mq_zc_free( xMqId, pcBuffer );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_MQUEUE, mq_zc_buffer_from_other_queue )
+{
+    int iStatus = 0;
+    volatile mqd_t xSmallMqId = posixtestMQ_INVALID_MQD;
+    volatile mqd_t xLargeMqId = posixtestMQ_INVALID_MQD;
+    char * volatile pcBuffer = NULL;
+    struct mq_attr xLargeQueueAttr = xDefaultQueueAttr;
+    char * pcNotABuffer = NULL;
+    void * pvNotFromPool[ 8 ] = { NULL };
+
+    xLargeQueueAttr.mq_msgsize = posixtestMQ_LARGE_MESSAGE_SIZE;
+
+    if( TEST_PROTECT() )
+    {
+        xSmallMqId = mq_open( posixtestMQ_DEFAULT_NAME,
+                              O_CREAT | O_RDWR | O_NONBLOCK,
+                              posixtestMQ_DEFAULT_MODE,
+                              &xDefaultQueueAttr );
+        TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xSmallMqId );
+
+        xLargeMqId = mq_open( posixtestMQ_SECOND_NAME,
+                              O_CREAT | O_RDWR | O_NONBLOCK,
+                              posixtestMQ_DEFAULT_MODE,
+                              &xLargeQueueAttr );
+        TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xLargeMqId );
+
+        /* A buffer from the small queue cannot be sent to another queue, even
+         * with a message that fits in it. */
+        pcBuffer = mq_zc_alloc( xSmallMqId );
+        TEST_ASSERT_NOT_NULL( pcBuffer );
+
+        iStatus = mq_zc_timedsend( xLargeMqId, pcBuffer, posixtestMQ_LARGE_MESSAGE_SIZE, 0, NULL );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        iStatus = mq_zc_timedsend( xLargeMqId, pcBuffer, 1, 0, NULL );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        /* Neither can memory that is not a message buffer. Its "header" is in
+         * the same array, so reading it is safe. */
+        pcNotABuffer = ( char * ) &pvNotFromPool[ 4 ];
+        iStatus = mq_zc_timedsend( xSmallMqId, pcNotABuffer, 1, 0, NULL );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        /* Giving it to the large queue frees it instead of keeping it for
+         * reuse, so the next buffer from the large queue holds a large
+         * message. */
+        mq_zc_free( xLargeMqId, pcBuffer );
+        pcBuffer = mq_zc_alloc( xLargeMqId );
+        TEST_ASSERT_NOT_NULL( pcBuffer );
+        ( void ) memset( pcBuffer, 0xA5, posixtestMQ_LARGE_MESSAGE_SIZE );
+
+        iStatus = mq_zc_timedsend( xLargeMqId, pcBuffer, posixtestMQ_LARGE_MESSAGE_SIZE, 0, NULL );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        pcBuffer = NULL;
+    }
+
+    /* Clean up resources used by test. */
+    mq_zc_free( xLargeMqId, pcBuffer );
+    ( void ) mq_close( xSmallMqId );
+    ( void ) mq_unlink( posixtestMQ_DEFAULT_NAME );
+    ( void ) mq_close( xLargeMqId );
+    ( void ) mq_unlink( posixtestMQ_SECOND_NAME );
+}
+
+/*-----------------------------------------------------------*/
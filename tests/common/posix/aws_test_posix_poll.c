@@ -0,0 +1,758 @@
+/*
+ * Amazon FreeRTOS+POSIX V1.0.0
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_test_posix_poll.c
+ * @brief Tests for poll.
+ */
+
+/* C standard library includes. */
+#include <stddef.h>
+#include <string.h>
+
+/* FreeRTOS+POSIX includes. */
+#include "FreeRTOS_POSIX.h"
+#include "FreeRTOS_POSIX/errno.h"
+#include "FreeRTOS_POSIX/fcntl.h"
+#include "FreeRTOS_POSIX/mqueue.h"
+#include "FreeRTOS_POSIX/poll.h"
+#include "FreeRTOS_POSIX/pthread.h"
+#include "FreeRTOS_POSIX/semaphore.h"
+
+#if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+    /* FreeRTOS+TCP includes. */
+    #include "FreeRTOS_IP.h"
+    #include "FreeRTOS_Sockets.h"
+#endif
+
+/* Test framework includes. */
+#include "unity.h"
+#include "unity_fixture.h"
+
+/**
+ * @defgroup Configuration constants for the poll tests.
+ */
+/**@{ */
+#define posixtestPOLL_MESSAGE             "Hello"                              /**< Message sent over the queues. */
+#define posixtestPOLL_MESSAGE_SIZE        ( sizeof( posixtestPOLL_MESSAGE ) )  /**< Length (including null-terminator) of posixtestPOLL_MESSAGE. */
+#define posixtestPOLL_MQ_NAME             "/pollqueue"                         /**< Name of the queues in these tests, followed by a number. */
+#define posixtestPOLL_MQ_MODE             0600                                 /**< Mode argument for mq_open. */
+#define posixtestPOLL_TIMEOUT_MS          ( 20 )                               /**< Timeout of poll calls that are expected to time out. */
+#define posixtestPOLL_WAKE_DELAY_MS       ( 10 )                               /**< Delay before another thread makes an object ready. */
+#define posixtestPOLL_BLOCK_MS            ( 5000 )                             /**< Timeout of poll calls that are expected to be woken up. */
+#define posixtestPOLL_SOCKET_PORT         ( 5400 )                             /**< First port of the sockets in these tests. */
+/**@} */
+
+/**
+ * @brief Number of sources that a single thread serves in the benchmark.
+ */
+#ifndef posixtestPOLL_BENCHMARK_SOURCES
+    #define posixtestPOLL_BENCHMARK_SOURCES    ( 64 )
+#endif
+
+/**
+ * @brief Number of messages sent to each source in the benchmark.
+ */
+#ifndef posixtestPOLL_BENCHMARK_MESSAGES
+    #define posixtestPOLL_BENCHMARK_MESSAGES    ( 50 )
+#endif
+
+/**
+ * @brief The arguments to the threads that receive in the benchmark.
+ */
+typedef struct PollBenchmarkArgs
+{
+    mqd_t * pxQueues;     /**< Queues to receive from. */
+    size_t xQueueCount;   /**< Number of queues in pxQueues. */
+    size_t xMessages;     /**< Number of messages to receive in total. */
+    size_t xReceived;     /**< Output parameter for the number of messages received. */
+} PollBenchmarkArgs_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Build the name of the queue with the given index.
+ */
+static void prvQueueName( char * pcName,
+                          size_t xIndex )
+{
+    size_t xLength = sizeof( posixtestPOLL_MQ_NAME ) - 1;
+
+    ( void ) memcpy( pcName, posixtestPOLL_MQ_NAME, xLength );
+    pcName[ xLength ] = ( char ) ( '0' + ( ( xIndex / 100 ) % 10 ) );
+    pcName[ xLength + 1 ] = ( char ) ( '0' + ( ( xIndex / 10 ) % 10 ) );
+    pcName[ xLength + 2 ] = ( char ) ( '0' + ( xIndex % 10 ) );
+    pcName[ xLength + 3 ] = '\0';
+}
+
+/*-----------------------------------------------------------*/
+
+static mqd_t prvOpenQueue( size_t xIndex )
+{
+    char pcName[ sizeof( posixtestPOLL_MQ_NAME ) + 3 ];
+    struct mq_attr xQueueAttr =
+    {
+        .mq_flags   = 0,
+        .mq_maxmsg  = posixconfigMQ_MAX_MESSAGES,
+        .mq_msgsize = posixtestPOLL_MESSAGE_SIZE,
+        .mq_curmsgs = 0
+    };
+
+    prvQueueName( pcName, xIndex );
+
+    return mq_open( pcName, O_CREAT | O_RDWR, posixtestPOLL_MQ_MODE, &xQueueAttr );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvCloseQueue( mqd_t xMqId,
+                           size_t xIndex )
+{
+    char pcName[ sizeof( posixtestPOLL_MQ_NAME ) + 3 ];
+
+    prvQueueName( pcName, xIndex );
+
+    ( void ) mq_close( xMqId );
+    ( void ) mq_unlink( pcName );
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvSendAfterDelayThread( void * pvArgs )
+{
+    vTaskDelay( pdMS_TO_TICKS( posixtestPOLL_WAKE_DELAY_MS ) );
+
+    ( void ) mq_send( *( ( mqd_t * ) pvArgs ), posixtestPOLL_MESSAGE, posixtestPOLL_MESSAGE_SIZE, 0 );
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvPostAfterDelayThread( void * pvArgs )
+{
+    vTaskDelay( pdMS_TO_TICKS( posixtestPOLL_WAKE_DELAY_MS ) );
+
+    ( void ) sem_post( ( sem_t * ) pvArgs );
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Close and unlink the queue with index 1 after a delay.
+ */
+static void * prvCloseAfterDelayThread( void * pvArgs )
+{
+    vTaskDelay( pdMS_TO_TICKS( posixtestPOLL_WAKE_DELAY_MS ) );
+
+    prvCloseQueue( *( ( mqd_t * ) pvArgs ), 1 );
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvDestroyAfterDelayThread( void * pvArgs )
+{
+    vTaskDelay( pdMS_TO_TICKS( posixtestPOLL_WAKE_DELAY_MS ) );
+
+    ( void ) sem_destroy( ( sem_t * ) pvArgs );
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 ) && ( ipconfigSUPPORT_SIGNALS != 0 )
+
+    static void * prvSignalAfterDelayThread( void * pvArgs )
+    {
+        vTaskDelay( pdMS_TO_TICKS( posixtestPOLL_WAKE_DELAY_MS ) );
+
+        ( void ) FreeRTOS_SignalSocket( ( Socket_t ) pvArgs );
+
+        return NULL;
+    }
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+static void * prvPollReceiverThread( void * pvArgs )
+{
+    PollBenchmarkArgs_t * pxArgs = ( PollBenchmarkArgs_t * ) pvArgs;
+    struct pollfd * pxFds = NULL;
+    char pcReceiveBuffer[ posixtestPOLL_MESSAGE_SIZE ];
+    size_t xIndex = 0;
+    int iReady = 0;
+
+    pxFds = pvPortMalloc( pxArgs->xQueueCount * sizeof( struct pollfd ) );
+
+    if( pxFds != NULL )
+    {
+        for( xIndex = 0; xIndex < pxArgs->xQueueCount; xIndex++ )
+        {
+            pxFds[ xIndex ].fd = pxArgs->pxQueues[ xIndex ];
+            pxFds[ xIndex ].fdtype = POLLFD_MQ;
+            pxFds[ xIndex ].events = POLLIN;
+        }
+
+        /* Serve all queues from this thread. */
+        while( pxArgs->xReceived < pxArgs->xMessages )
+        {
+            iReady = poll( pxFds, ( nfds_t ) pxArgs->xQueueCount, posixtestPOLL_BLOCK_MS );
+
+            if( iReady <= 0 )
+            {
+                break;
+            }
+
+            for( xIndex = 0; xIndex < pxArgs->xQueueCount; xIndex++ )
+            {
+                /* This is the only receiver, so a readable queue does not
+                 * block. */
+                if( ( ( pxFds[ xIndex ].revents & POLLIN ) != 0 ) &&
+                    ( mq_receive( pxArgs->pxQueues[ xIndex ], pcReceiveBuffer, posixtestPOLL_MESSAGE_SIZE, NULL ) == ( ssize_t ) posixtestPOLL_MESSAGE_SIZE ) )
+                {
+                    pxArgs->xReceived++;
+                }
+            }
+        }
+
+        vPortFree( pxFds );
+    }
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvBlockingReceiverThread( void * pvArgs )
+{
+    PollBenchmarkArgs_t * pxArgs = ( PollBenchmarkArgs_t * ) pvArgs;
+    char pcReceiveBuffer[ posixtestPOLL_MESSAGE_SIZE ];
+    struct timespec xTimeout = { 0 };
+
+    /* Serve one queue from this thread. */
+    while( pxArgs->xReceived < pxArgs->xMessages )
+    {
+        ( void ) clock_gettime( CLOCK_REALTIME, &xTimeout );
+        xTimeout.tv_sec += posixtestPOLL_BLOCK_MS / 1000;
+
+        if( mq_timedreceive( pxArgs->pxQueues[ 0 ], pcReceiveBuffer, posixtestPOLL_MESSAGE_SIZE, NULL, &xTimeout ) != ( ssize_t ) posixtestPOLL_MESSAGE_SIZE )
+        {
+            break;
+        }
+
+        pxArgs->xReceived++;
+    }
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+TEST_GROUP( Full_POSIX_POLL );
+
+/*-----------------------------------------------------------*/
+
+TEST_SETUP( Full_POSIX_POLL )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+TEST_TEAR_DOWN( Full_POSIX_POLL )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+TEST_GROUP_RUNNER( Full_POSIX_POLL )
+{
+    RUN_TEST_CASE( Full_POSIX_POLL, poll_invalid_params );
+    RUN_TEST_CASE( Full_POSIX_POLL, poll_mq );
+    RUN_TEST_CASE( Full_POSIX_POLL, poll_sem );
+    RUN_TEST_CASE( Full_POSIX_POLL, poll_wakeup );
+    RUN_TEST_CASE( Full_POSIX_POLL, poll_object_deleted );
+    #if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+        RUN_TEST_CASE( Full_POSIX_POLL, poll_sockets );
+    #endif
+    RUN_TEST_CASE( Full_POSIX_POLL, poll_benchmark );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_POLL, poll_invalid_params )
+{
+    int iStatus = 0;
+    int iNotAnObject = 0;
+    struct pollfd xFds[ 2 ] = { { 0 } };
+
+    /* A NULL array with entries is invalid. */
+    iStatus = poll( NULL, 1, 0 );
+    TEST_ASSERT_EQUAL_INT( -1, iStatus );
+    TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+    /* No entries; times out. */
+    iStatus = poll( NULL, 0, posixtestPOLL_TIMEOUT_MS );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    /* Entries with a NULL handle are ignored. */
+    xFds[ 0 ].fd = NULL;
+    xFds[ 0 ].fdtype = POLLFD_MQ;
+    xFds[ 0 ].events = POLLIN;
+    iStatus = poll( xFds, 1, 0 );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+    TEST_ASSERT_EQUAL_INT( 0, xFds[ 0 ].revents );
+
+    /* An unknown type and a descriptor that is not an open queue are
+     * reported, even if no event was requested. */
+    xFds[ 0 ].fd = &iNotAnObject;
+    xFds[ 0 ].fdtype = -1;
+    xFds[ 0 ].events = 0;
+    xFds[ 1 ].fd = &iNotAnObject;
+    xFds[ 1 ].fdtype = POLLFD_MQ;
+    xFds[ 1 ].events = 0;
+    iStatus = poll( xFds, 2, posixtestPOLL_BLOCK_MS );
+    TEST_ASSERT_EQUAL_INT( 2, iStatus );
+    TEST_ASSERT_EQUAL_INT( POLLNVAL, xFds[ 0 ].revents );
+    TEST_ASSERT_EQUAL_INT( POLLNVAL, xFds[ 1 ].revents );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_POLL, poll_mq )
+{
+    int iStatus = 0;
+    volatile mqd_t xMqId = ( mqd_t ) -1;
+    struct pollfd xFds[ 1 ] = { { 0 } };
+    char pcReceiveBuffer[ posixtestPOLL_MESSAGE_SIZE ] = { 0 };
+
+    if( TEST_PROTECT() )
+    {
+        xMqId = prvOpenQueue( 0 );
+        TEST_ASSERT_NOT_EQUAL( ( mqd_t ) -1, xMqId );
+
+        xFds[ 0 ].fd = xMqId;
+        xFds[ 0 ].fdtype = POLLFD_MQ;
+
+        /* An empty queue can be written but not read. */
+        xFds[ 0 ].events = POLLIN | POLLOUT;
+        iStatus = poll( xFds, 1, 0 );
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( POLLOUT, xFds[ 0 ].revents );
+
+        xFds[ 0 ].events = POLLIN;
+        iStatus = poll( xFds, 1, posixtestPOLL_TIMEOUT_MS );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        TEST_ASSERT_EQUAL_INT( 0, xFds[ 0 ].revents );
+
+        /* Fill the queue; it can now be read but not written. */
+        for( iStatus = 0; iStatus < posixconfigMQ_MAX_MESSAGES; iStatus++ )
+        {
+            TEST_ASSERT_EQUAL_INT( 0, mq_send( xMqId, posixtestPOLL_MESSAGE, posixtestPOLL_MESSAGE_SIZE, 0 ) );
+        }
+
+        xFds[ 0 ].events = POLLIN | POLLOUT;
+        iStatus = poll( xFds, 1, 0 );
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( POLLIN, xFds[ 0 ].revents );
+
+        /* Receiving a message makes it writable again. */
+        TEST_ASSERT_EQUAL_INT( posixtestPOLL_MESSAGE_SIZE,
+                               mq_receive( xMqId, pcReceiveBuffer, posixtestPOLL_MESSAGE_SIZE, NULL ) );
+        iStatus = poll( xFds, 1, 0 );
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( POLLIN | POLLOUT, xFds[ 0 ].revents );
+    }
+
+    prvCloseQueue( xMqId, 0 );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_POLL, poll_sem )
+{
+    int iStatus = 0;
+    sem_t xSemaphore = NULL;
+    struct pollfd xFds[ 1 ] = { { 0 } };
+
+    TEST_ASSERT_EQUAL_INT( 0, sem_init( &xSemaphore, 0, 0 ) );
+
+    if( TEST_PROTECT() )
+    {
+        xFds[ 0 ].fd = xSemaphore;
+        xFds[ 0 ].fdtype = POLLFD_SEM;
+        xFds[ 0 ].events = POLLIN;
+
+        /* The semaphore cannot be taken. */
+        iStatus = poll( xFds, 1, posixtestPOLL_TIMEOUT_MS );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* Once posted, it can, and poll does not take it. */
+        TEST_ASSERT_EQUAL_INT( 0, sem_post( &xSemaphore ) );
+        iStatus = poll( xFds, 1, 0 );
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( POLLIN, xFds[ 0 ].revents );
+        TEST_ASSERT_EQUAL_INT( 0, sem_trywait( &xSemaphore ) );
+
+        iStatus = poll( xFds, 1, 0 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+    }
+
+    ( void ) sem_destroy( &xSemaphore );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_POLL, poll_wakeup )
+{
+    int iStatus = 0;
+    volatile mqd_t xMqId = ( mqd_t ) -1, xMqId2 = ( mqd_t ) -1;
+    sem_t xSemaphore = NULL;
+    pthread_t xThread;
+    struct pollfd xFds[ 3 ] = { { 0 } };
+    TickType_t xStartTime = 0;
+
+    TEST_ASSERT_EQUAL_INT( 0, sem_init( &xSemaphore, 0, 0 ) );
+
+    if( TEST_PROTECT() )
+    {
+        xMqId = prvOpenQueue( 0 );
+        TEST_ASSERT_NOT_EQUAL( ( mqd_t ) -1, xMqId );
+        xMqId2 = prvOpenQueue( 1 );
+        TEST_ASSERT_NOT_EQUAL( ( mqd_t ) -1, xMqId2 );
+
+        xFds[ 0 ].fd = xMqId;
+        xFds[ 0 ].fdtype = POLLFD_MQ;
+        xFds[ 0 ].events = POLLIN;
+        xFds[ 1 ].fd = xSemaphore;
+        xFds[ 1 ].fdtype = POLLFD_SEM;
+        xFds[ 1 ].events = POLLIN;
+        xFds[ 2 ].fd = xMqId2;
+        xFds[ 2 ].fdtype = POLLFD_MQ;
+        xFds[ 2 ].events = POLLIN;
+
+        /* A message sent by another thread wakes this one, and only its queue
+         * is reported. */
+        TEST_ASSERT_EQUAL_INT( 0, pthread_create( &xThread, NULL, prvSendAfterDelayThread, ( void * ) &xMqId2 ) );
+        xStartTime = xTaskGetTickCount();
+        iStatus = poll( xFds, 3, posixtestPOLL_BLOCK_MS );
+        TEST_ASSERT_EQUAL_INT( 0, pthread_join( xThread, NULL ) );
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( 0, xFds[ 0 ].revents );
+        TEST_ASSERT_EQUAL_INT( 0, xFds[ 1 ].revents );
+        TEST_ASSERT_EQUAL_INT( POLLIN, xFds[ 2 ].revents );
+        TEST_ASSERT_TRUE( ( xTaskGetTickCount() - xStartTime ) < pdMS_TO_TICKS( posixtestPOLL_BLOCK_MS ) );
+
+        /* Same for a semaphore. */
+        xFds[ 2 ].fd = NULL;
+        TEST_ASSERT_EQUAL_INT( 0, pthread_create( &xThread, NULL, prvPostAfterDelayThread, &xSemaphore ) );
+        iStatus = poll( xFds, 3, posixtestPOLL_BLOCK_MS );
+        TEST_ASSERT_EQUAL_INT( 0, pthread_join( xThread, NULL ) );
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( 0, xFds[ 0 ].revents );
+        TEST_ASSERT_EQUAL_INT( POLLIN, xFds[ 1 ].revents );
+    }
+
+    prvCloseQueue( xMqId, 0 );
+    prvCloseQueue( xMqId2, 1 );
+    ( void ) sem_destroy( &xSemaphore );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_POLL, poll_object_deleted )
+{
+    int iStatus = 0;
+    volatile mqd_t xMqId = ( mqd_t ) -1, xMqId2 = ( mqd_t ) -1;
+    sem_t xSemaphore = NULL;
+    volatile BaseType_t xSemaphoreDestroyed = pdFALSE;
+    pthread_t xThread;
+    struct pollfd xFds[ 2 ] = { { 0 } };
+    TickType_t xStartTime = 0;
+
+    TEST_ASSERT_EQUAL_INT( 0, sem_init( &xSemaphore, 0, 0 ) );
+
+    if( TEST_PROTECT() )
+    {
+        xMqId = prvOpenQueue( 0 );
+        TEST_ASSERT_NOT_EQUAL( ( mqd_t ) -1, xMqId );
+        xMqId2 = prvOpenQueue( 1 );
+        TEST_ASSERT_NOT_EQUAL( ( mqd_t ) -1, xMqId2 );
+
+        xFds[ 0 ].fd = xMqId;
+        xFds[ 0 ].fdtype = POLLFD_MQ;
+        xFds[ 0 ].events = POLLIN;
+        xFds[ 1 ].fd = xMqId2;
+        xFds[ 1 ].fdtype = POLLFD_MQ;
+        xFds[ 1 ].events = POLLIN;
+
+        /* A queue deleted by another thread wakes this one, and is reported
+         * as invalid. */
+        TEST_ASSERT_EQUAL_INT( 0, pthread_create( &xThread, NULL, prvCloseAfterDelayThread, ( void * ) &xMqId2 ) );
+        xStartTime = xTaskGetTickCount();
+        iStatus = poll( xFds, 2, posixtestPOLL_BLOCK_MS );
+        TEST_ASSERT_EQUAL_INT( 0, pthread_join( xThread, NULL ) );
+        xMqId2 = ( mqd_t ) -1;
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( 0, xFds[ 0 ].revents );
+        TEST_ASSERT_EQUAL_INT( POLLNVAL, xFds[ 1 ].revents );
+        TEST_ASSERT_TRUE( ( xTaskGetTickCount() - xStartTime ) < pdMS_TO_TICKS( posixtestPOLL_BLOCK_MS ) );
+
+        /* Same for a semaphore. */
+        xFds[ 1 ].fd = xSemaphore;
+        xFds[ 1 ].fdtype = POLLFD_SEM;
+        TEST_ASSERT_EQUAL_INT( 0, pthread_create( &xThread, NULL, prvDestroyAfterDelayThread, &xSemaphore ) );
+        iStatus = poll( xFds, 2, posixtestPOLL_BLOCK_MS );
+        TEST_ASSERT_EQUAL_INT( 0, pthread_join( xThread, NULL ) );
+        xSemaphoreDestroyed = pdTRUE;
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( 0, xFds[ 0 ].revents );
+        TEST_ASSERT_EQUAL_INT( POLLNVAL, xFds[ 1 ].revents );
+
+        /* The waiters were removed from the queue that is still open, so it
+         * still wakes a thread in poll(). */
+        xFds[ 1 ].fd = NULL;
+        TEST_ASSERT_EQUAL_INT( 0, pthread_create( &xThread, NULL, prvSendAfterDelayThread, ( void * ) &xMqId ) );
+        iStatus = poll( xFds, 2, posixtestPOLL_BLOCK_MS );
+        TEST_ASSERT_EQUAL_INT( 0, pthread_join( xThread, NULL ) );
+        TEST_ASSERT_EQUAL_INT( 1, iStatus );
+        TEST_ASSERT_EQUAL_INT( POLLIN, xFds[ 0 ].revents );
+    }
+
+    prvCloseQueue( xMqId, 0 );
+
+    if( xMqId2 != ( mqd_t ) -1 )
+    {
+        prvCloseQueue( xMqId2, 1 );
+    }
+
+    if( xSemaphoreDestroyed == pdFALSE )
+    {
+        ( void ) sem_destroy( &xSemaphore );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 )
+
+    TEST( Full_POSIX_POLL, poll_sockets )
+    {
+        int iStatus = 0;
+        size_t xIndex = 0;
+        struct freertos_sockaddr xAddress = { 0 };
+        Socket_t * pxSockets = NULL;
+        struct pollfd * pxFds = NULL;
+        TickType_t xStartTime = 0;
+
+        #if ( ipconfigSUPPORT_SIGNALS != 0 )
+            pthread_t xThread;
+        #endif
+
+        pxSockets = pvPortMalloc( posixtestPOLL_BENCHMARK_SOURCES * sizeof( Socket_t ) );
+        pxFds = pvPortMalloc( posixtestPOLL_BENCHMARK_SOURCES * sizeof( struct pollfd ) );
+
+        if( TEST_PROTECT() )
+        {
+            TEST_ASSERT_NOT_NULL( pxSockets );
+            TEST_ASSERT_NOT_NULL( pxFds );
+
+            for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+            {
+                pxSockets[ xIndex ] = FREERTOS_INVALID_SOCKET;
+            }
+
+            for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+            {
+                pxSockets[ xIndex ] = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+                TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, pxSockets[ xIndex ] );
+
+                xAddress.sin_port = FreeRTOS_htons( ( uint16_t ) ( posixtestPOLL_SOCKET_PORT + xIndex ) );
+                TEST_ASSERT_EQUAL_INT( 0, FreeRTOS_bind( pxSockets[ xIndex ], &xAddress, sizeof( xAddress ) ) );
+
+                pxFds[ xIndex ].fd = pxSockets[ xIndex ];
+                pxFds[ xIndex ].fdtype = POLLFD_SOCKET;
+                pxFds[ xIndex ].events = POLLIN;
+            }
+
+            /* Nothing is received; times out. */
+            xStartTime = xTaskGetTickCount();
+            iStatus = poll( pxFds, posixtestPOLL_BENCHMARK_SOURCES, posixtestPOLL_TIMEOUT_MS );
+            TEST_ASSERT_EQUAL_INT( 0, iStatus );
+            TEST_ASSERT_TRUE( ( xTaskGetTickCount() - xStartTime ) >= pdMS_TO_TICKS( posixtestPOLL_TIMEOUT_MS ) );
+
+            for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+            {
+                TEST_ASSERT_EQUAL_INT( 0, pxFds[ xIndex ].revents );
+            }
+
+            /* A signalled socket interrupts poll. */
+            #if ( ipconfigSUPPORT_SIGNALS != 0 )
+                TEST_ASSERT_EQUAL_INT( 0, pthread_create( &xThread, NULL, prvSignalAfterDelayThread, pxSockets[ 0 ] ) );
+                iStatus = poll( pxFds, posixtestPOLL_BENCHMARK_SOURCES, posixtestPOLL_BLOCK_MS );
+                TEST_ASSERT_EQUAL_INT( 0, pthread_join( xThread, NULL ) );
+                TEST_ASSERT_EQUAL_INT( -1, iStatus );
+                TEST_ASSERT_EQUAL_INT( EINTR, errno );
+            #endif
+        }
+
+        if( pxSockets != NULL )
+        {
+            for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+            {
+                if( pxSockets[ xIndex ] != FREERTOS_INVALID_SOCKET )
+                {
+                    ( void ) FreeRTOS_closesocket( pxSockets[ xIndex ] );
+                }
+            }
+        }
+
+        vPortFree( pxSockets );
+        vPortFree( pxFds );
+    }
+
+#endif /* if ( posixconfigPOLL_FREERTOS_TCP_SOCKETS == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_POLL, poll_benchmark )
+{
+    size_t xIndex = 0, xMessage = 0, xReceived = 0;
+    size_t xThreadsCreated = 0;
+    mqd_t * pxQueues = NULL;
+    pthread_t * pxThreads = NULL;
+    PollBenchmarkArgs_t * pxArgs = NULL;
+    TickType_t xStartTime = 0, xPollTicks = 0, xThreadTicks = 0;
+
+    pxQueues = pvPortMalloc( posixtestPOLL_BENCHMARK_SOURCES * sizeof( mqd_t ) );
+    pxThreads = pvPortMalloc( posixtestPOLL_BENCHMARK_SOURCES * sizeof( pthread_t ) );
+    pxArgs = pvPortMalloc( posixtestPOLL_BENCHMARK_SOURCES * sizeof( PollBenchmarkArgs_t ) );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_NOT_NULL( pxQueues );
+        TEST_ASSERT_NOT_NULL( pxThreads );
+        TEST_ASSERT_NOT_NULL( pxArgs );
+
+        for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+        {
+            pxQueues[ xIndex ] = ( mqd_t ) -1;
+        }
+
+        for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+        {
+            pxQueues[ xIndex ] = prvOpenQueue( xIndex );
+            TEST_ASSERT_NOT_EQUAL( ( mqd_t ) -1, pxQueues[ xIndex ] );
+        }
+
+        /* One thread serves all queues with poll. */
+        pxArgs[ 0 ].pxQueues = pxQueues;
+        pxArgs[ 0 ].xQueueCount = posixtestPOLL_BENCHMARK_SOURCES;
+        pxArgs[ 0 ].xMessages = posixtestPOLL_BENCHMARK_SOURCES * posixtestPOLL_BENCHMARK_MESSAGES;
+        pxArgs[ 0 ].xReceived = 0;
+
+        xStartTime = xTaskGetTickCount();
+        TEST_ASSERT_EQUAL_INT( 0, pthread_create( &pxThreads[ 0 ], NULL, prvPollReceiverThread, &pxArgs[ 0 ] ) );
+        xThreadsCreated = 1;
+
+        for( xMessage = 0; xMessage < posixtestPOLL_BENCHMARK_MESSAGES; xMessage++ )
+        {
+            for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+            {
+                TEST_ASSERT_EQUAL_INT( 0, mq_send( pxQueues[ xIndex ], posixtestPOLL_MESSAGE, posixtestPOLL_MESSAGE_SIZE, 0 ) );
+            }
+        }
+
+        xThreadsCreated = 0;
+        TEST_ASSERT_EQUAL_INT( 0, pthread_join( pxThreads[ 0 ], NULL ) );
+        xPollTicks = xTaskGetTickCount() - xStartTime;
+        TEST_ASSERT_EQUAL( posixtestPOLL_BENCHMARK_SOURCES * posixtestPOLL_BENCHMARK_MESSAGES, pxArgs[ 0 ].xReceived );
+
+        /* One thread per queue. */
+        xStartTime = xTaskGetTickCount();
+
+        for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+        {
+            pxArgs[ xIndex ].pxQueues = &pxQueues[ xIndex ];
+            pxArgs[ xIndex ].xQueueCount = 1;
+            pxArgs[ xIndex ].xMessages = posixtestPOLL_BENCHMARK_MESSAGES;
+            pxArgs[ xIndex ].xReceived = 0;
+
+            TEST_ASSERT_EQUAL_INT( 0, pthread_create( &pxThreads[ xIndex ], NULL, prvBlockingReceiverThread, &pxArgs[ xIndex ] ) );
+            xThreadsCreated++;
+        }
+
+        for( xMessage = 0; xMessage < posixtestPOLL_BENCHMARK_MESSAGES; xMessage++ )
+        {
+            for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+            {
+                TEST_ASSERT_EQUAL_INT( 0, mq_send( pxQueues[ xIndex ], posixtestPOLL_MESSAGE, posixtestPOLL_MESSAGE_SIZE, 0 ) );
+            }
+        }
+
+        for( ; xThreadsCreated > 0; xThreadsCreated-- )
+        {
+            TEST_ASSERT_EQUAL_INT( 0, pthread_join( pxThreads[ xThreadsCreated - 1 ], NULL ) );
+            xReceived += pxArgs[ xThreadsCreated - 1 ].xReceived;
+        }
+
+        xThreadTicks = xTaskGetTickCount() - xStartTime;
+        TEST_ASSERT_EQUAL( posixtestPOLL_BENCHMARK_SOURCES * posixtestPOLL_BENCHMARK_MESSAGES, xReceived );
+
+        configPRINTF( ( "poll: %u queues, %u messages each. 1 thread: %u ms, %u bytes of stack. %u threads: %u ms, %u bytes of stack.\r\n",
+                        ( unsigned ) posixtestPOLL_BENCHMARK_SOURCES,
+                        ( unsigned ) posixtestPOLL_BENCHMARK_MESSAGES,
+                        ( unsigned ) ( xPollTicks * portTICK_PERIOD_MS ),
+                        ( unsigned ) PTHREAD_STACK_MIN,
+                        ( unsigned ) posixtestPOLL_BENCHMARK_SOURCES,
+                        ( unsigned ) ( xThreadTicks * portTICK_PERIOD_MS ),
+                        ( unsigned ) ( posixtestPOLL_BENCHMARK_SOURCES * PTHREAD_STACK_MIN ) ) );
+    }
+
+    /* Join the threads left if an assert was triggered; they time out. */
+    for( ; xThreadsCreated > 0; xThreadsCreated-- )
+    {
+        ( void ) pthread_join( pxThreads[ xThreadsCreated - 1 ], NULL );
+    }
+
+    if( pxQueues != NULL )
+    {
+        for( xIndex = 0; xIndex < posixtestPOLL_BENCHMARK_SOURCES; xIndex++ )
+        {
+            prvCloseQueue( pxQueues[ xIndex ], xIndex );
+        }
+    }
+
+    vPortFree( pxQueues );
+    vPortFree( pxThreads );
+    vPortFree( pxArgs );
+}
+
+/*-----------------------------------------------------------*/
@@ -48,6 +48,8 @@
 /**@{ */
 #define posixtestPTHREAD_DETACHED_WAIT_MILLISECONDS          ( 100000000 ) /**< How long to wait for a detached thread to finish. */
 #define posixtestPTHREAD_COND_BROADCAST_NUMBER_OF_THREADS    ( 4 )         /**< Number of threads that wait on a pthread_cond_broadcast. */
+#define posixtestPTHREAD_MUTEX_CONTENDED_NUMBER_OF_THREADS   ( 4 )         /**< Number of threads that contend for a mutex. */
+#define posixtestPTHREAD_MUTEX_CONTENDED_ITERATIONS          ( 200 )       /**< Number of times each contending thread locks the mutex. */
 /**@} */
 
 /**
@@ -60,6 +62,26 @@ typedef struct SignalCondThreadArgs
     pthread_cond_t * pxCond; /**< Condition variable. */
 } SignalCondThreadArgs_t;
 
+/**
+ * @brief The arguments to prvWriteLockThread.
+ */
+typedef struct WriteLockThreadArgs
+{
+    int iStatus;                 /**< The status the thread reports. */
+    volatile BaseType_t xLocked; /**< Set to pdTRUE while the thread holds the lock. */
+    pthread_rwlock_t * pxRwlock; /**< Read-write lock. */
+} WriteLockThreadArgs_t;
+
+/**
+ * @brief The arguments to prvIncrementCounterThread.
+ */
+typedef struct IncrementCounterThreadArgs
+{
+    int iStatus;               /**< The status the thread reports. */
+    volatile int * piCounter;  /**< Counter incremented with the mutex held. */
+    pthread_mutex_t * pxMutex; /**< Mutex that protects the counter. */
+} IncrementCounterThreadArgs_t;
+
 /*-----------------------------------------------------------*/
 
 static void * prvComputeSquareThread( void * pvArgs )
@@ -93,6 +115,32 @@ static void * prvUnlockMutexThread( void * pvArgs )
 
 /*-----------------------------------------------------------*/
 
+static void * prvIncrementCounterThread( void * pvArgs )
+{
+    IncrementCounterThreadArgs_t * pxArgs = ( IncrementCounterThreadArgs_t * ) pvArgs;
+    int i = 0, iValue = 0;
+
+    for( i = 0; ( i < posixtestPTHREAD_MUTEX_CONTENDED_ITERATIONS ) && ( pxArgs->iStatus == 0 ); i++ )
+    {
+        pxArgs->iStatus = pthread_mutex_lock( pxArgs->pxMutex );
+
+        if( pxArgs->iStatus == 0 )
+        {
+            /* Yield between the read and the write, so that another thread
+             * would overwrite the counter if it could take the mutex. */
+            iValue = *( pxArgs->piCounter );
+            taskYIELD();
+            *( pxArgs->piCounter ) = iValue + 1;
+
+            pxArgs->iStatus = pthread_mutex_unlock( pxArgs->pxMutex );
+        }
+    }
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
 static void * prvBarrierThread( void * pvArgs )
 {
     pthread_barrier_t * pxBarrier = ( pthread_barrier_t * ) pvArgs;
@@ -187,6 +235,27 @@ static void * prvWaitCondThread( void * pvArgs )
 
 /*-----------------------------------------------------------*/
 
+static void * prvWriteLockThread( void * pvArgs )
+{
+    WriteLockThreadArgs_t * pxArgs = ( WriteLockThreadArgs_t * ) pvArgs;
+
+    /* Take the lock for writing, hold it for a while, then release it. */
+    pxArgs->iStatus = pthread_rwlock_wrlock( pxArgs->pxRwlock );
+
+    if( pxArgs->iStatus == 0 )
+    {
+        pxArgs->xLocked = pdTRUE;
+        vTaskDelay( pdMS_TO_TICKS( 100 ) );
+        pxArgs->xLocked = pdFALSE;
+
+        pxArgs->iStatus = pthread_rwlock_unlock( pxArgs->pxRwlock );
+    }
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
 static void prvTestMutexLockUnlock( int iMutexType )
 {
     int iStatus = 0, iType = -1;
@@ -289,9 +358,12 @@ TEST_GROUP_RUNNER( Full_POSIX_PTHREAD )
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_attr_init_destroy );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_mutex_lock_unlock );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_mutex_trylock_timedlock );
+    RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_mutex_lock_contended );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_barrier );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_cond_signal );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_cond_broadcast );
+    RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_rwlock_lock_unlock );
+    RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_rwlock_writer_preference );
 }
 
 /*-----------------------------------------------------------*/
@@ -471,6 +543,80 @@ TEST( Full_POSIX_PTHREAD, pthread_mutex_trylock_timedlock )
 
 /*-----------------------------------------------------------*/
 
+/* With a nonzero posixconfigPTHREAD_MUTEX_SPIN_COUNT, this test also covers
+ * the spin before pthread_mutex_lock blocks. */
+TEST( Full_POSIX_PTHREAD, pthread_mutex_lock_contended )
+{
+    int iStatus = 0, i = 0;
+    volatile int iCounter = 0;
+    volatile int iThreadsCreated = 0;
+    volatile BaseType_t xLocked = pdFALSE;
+    pthread_mutex_t xMutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_t xThreads[ posixtestPTHREAD_MUTEX_CONTENDED_NUMBER_OF_THREADS ];
+    IncrementCounterThreadArgs_t xThreadArgs[ posixtestPTHREAD_MUTEX_CONTENDED_NUMBER_OF_THREADS ] = { { 0 } };
+
+    if( TEST_PROTECT() )
+    {
+        /* Hold the mutex while the threads start, so that they all wait for
+         * it. */
+        iStatus = pthread_mutex_lock( &xMutex );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        xLocked = pdTRUE;
+
+        for( i = 0; i < posixtestPTHREAD_MUTEX_CONTENDED_NUMBER_OF_THREADS; i++ )
+        {
+            xThreadArgs[ i ].piCounter = &iCounter;
+            xThreadArgs[ i ].pxMutex = &xMutex;
+
+            iStatus = pthread_create( &xThreads[ i ], NULL, prvIncrementCounterThread, &xThreadArgs[ i ] );
+            TEST_ASSERT_EQUAL_INT( 0, iStatus );
+            iThreadsCreated++;
+        }
+
+        vTaskDelay( pdMS_TO_TICKS( 20 ) );
+        TEST_ASSERT_EQUAL_INT( 0, iCounter );
+
+        xLocked = pdFALSE;
+        iStatus = pthread_mutex_unlock( &xMutex );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        for( i = 0; i < posixtestPTHREAD_MUTEX_CONTENDED_NUMBER_OF_THREADS; i++ )
+        {
+            ( void ) pthread_join( xThreads[ i ], NULL );
+        }
+
+        iThreadsCreated = 0;
+
+        for( i = 0; i < posixtestPTHREAD_MUTEX_CONTENDED_NUMBER_OF_THREADS; i++ )
+        {
+            TEST_ASSERT_EQUAL_INT( 0, xThreadArgs[ i ].iStatus );
+        }
+
+        /* Every increment is kept if the threads never held the mutex at the
+         * same time. */
+        TEST_ASSERT_EQUAL_INT( posixtestPTHREAD_MUTEX_CONTENDED_NUMBER_OF_THREADS *
+                               posixtestPTHREAD_MUTEX_CONTENDED_ITERATIONS,
+                               iCounter );
+
+        /* The mutex is free again. */
+        iStatus = pthread_mutex_trylock( &xMutex );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        xLocked = pdTRUE;
+    }
+
+    if( xLocked == pdTRUE )
+    {
+        ( void ) pthread_mutex_unlock( &xMutex );
+    }
+
+    for( i = 0; i < iThreadsCreated; i++ )
+    {
+        ( void ) pthread_join( xThreads[ i ], NULL );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_PTHREAD, pthread_barrier )
 {
     int iStatus = 0;
@@ -648,3 +794,127 @@ TEST( Full_POSIX_PTHREAD, pthread_cond_broadcast )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_PTHREAD, pthread_rwlock_lock_unlock )
+{
+    int iStatus = 0;
+    pthread_rwlock_t xRwlock = PTHREAD_RWLOCK_INITIALIZER;
+
+    /* Several read locks may be held at once, but no write lock. */
+    iStatus = pthread_rwlock_rdlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    iStatus = pthread_rwlock_tryrdlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    iStatus = pthread_rwlock_trywrlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( EBUSY, iStatus );
+
+    iStatus = pthread_rwlock_unlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    iStatus = pthread_rwlock_unlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    /* Unlocking a lock that isn't held should fail. */
+    iStatus = pthread_rwlock_unlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( EPERM, iStatus );
+
+    /* A write lock excludes all other locks. Taking one again from the same
+     * thread should be detected. */
+    iStatus = pthread_rwlock_wrlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    iStatus = pthread_rwlock_tryrdlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( EBUSY, iStatus );
+
+    iStatus = pthread_rwlock_rdlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( EDEADLK, iStatus );
+
+    iStatus = pthread_rwlock_wrlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( EDEADLK, iStatus );
+
+    iStatus = pthread_rwlock_unlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    /* The lock should be free again. */
+    iStatus = pthread_rwlock_trywrlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    iStatus = pthread_rwlock_unlock( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_PTHREAD, pthread_rwlock_writer_preference )
+{
+    int iStatus = 0;
+    BaseType_t xReadLocked = pdFALSE;
+    volatile BaseType_t xThreadCreated = pdFALSE;
+    pthread_rwlock_t xRwlock;
+    pthread_t xNewThread;
+    WriteLockThreadArgs_t xThreadArgs = { 0 };
+    struct timespec xWaitTime = { 0 };
+
+    iStatus = pthread_rwlock_init( &xRwlock, NULL );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    if( TEST_PROTECT() )
+    {
+        /* Take a read lock, then create a thread that waits for a write lock. */
+        iStatus = pthread_rwlock_rdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        xReadLocked = pdTRUE;
+
+        xThreadArgs.pxRwlock = &xRwlock;
+        iStatus = pthread_create( &xNewThread, NULL, prvWriteLockThread, &xThreadArgs );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        xThreadCreated = pdTRUE;
+
+        /* Wait for the thread to block in pthread_rwlock_wrlock. */
+        vTaskDelay( pdMS_TO_TICKS( 100 ) );
+        TEST_ASSERT_EQUAL( pdFALSE, xThreadArgs.xLocked );
+
+        /* While a writer waits, new read locks should not be granted. */
+        iStatus = pthread_rwlock_tryrdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( EBUSY, iStatus );
+
+        ( void ) clock_gettime( CLOCK_REALTIME, &xWaitTime );
+        ( void ) UTILS_TimespecAddNanoseconds( &xWaitTime, &xWaitTime, 50000000LL );
+        iStatus = pthread_rwlock_timedrdlock( &xRwlock, &xWaitTime );
+        TEST_ASSERT_EQUAL_INT( ETIMEDOUT, iStatus );
+
+        /* Releasing the read lock hands the lock to the writer. */
+        xReadLocked = pdFALSE;
+        iStatus = pthread_rwlock_unlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        vTaskDelay( pdMS_TO_TICKS( 20 ) );
+        TEST_ASSERT_EQUAL( pdTRUE, xThreadArgs.xLocked );
+
+        /* A read lock is granted once the writer releases the lock. */
+        iStatus = pthread_rwlock_rdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        xReadLocked = pdTRUE;
+        TEST_ASSERT_EQUAL( pdFALSE, xThreadArgs.xLocked );
+
+        ( void ) pthread_join( xNewThread, NULL );
+        xThreadCreated = pdFALSE;
+        TEST_ASSERT_EQUAL_INT( 0, xThreadArgs.iStatus );
+    }
+
+    if( xReadLocked == pdTRUE )
+    {
+        ( void ) pthread_rwlock_unlock( &xRwlock );
+    }
+
+    if( xThreadCreated == pdTRUE )
+    {
+        ( void ) pthread_join( xNewThread, NULL );
+    }
+
+    ( void ) pthread_rwlock_destroy( &xRwlock );
+}
+
+/*-----------------------------------------------------------*/
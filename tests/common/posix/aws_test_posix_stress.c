@@ -73,6 +73,22 @@
 #define posixtestBARRIER_STRESS_COUNT    ( 12 )    /**< The count argument for the barriers. */
 /**@} */
 
+/**
+ * @defgroup Configuration constants for the read-write lock stress test.
+ */
+/**@{ */
+#define posixtestRWLOCK_STRESS_ITERATIONS           ( 20 ) /**< Number of times each thread takes the lock. */
+#define posixtestRWLOCK_STRESS_NUMBER_OF_THREADS    ( 8 )  /**< Number of read-write lock test threads. */
+#define posixtestRWLOCK_STRESS_WRITE_PERIOD         ( 5 )  /**< Every this many iterations, a thread takes the lock for writing. */
+/**@} */
+
+/**
+ * @defgroup Configuration constants for the condition variable stress test.
+ */
+/**@{ */
+#define posixtestCOND_STRESS_NUMBER_OF_THREADS    ( 26 ) /**< Number of threads waiting on the condition variable; more than it has event group bits for. */
+/**@} */
+
 /**
  * @brief The arguments to prvChangeErrnoThread.
  */
@@ -101,6 +117,27 @@ typedef struct BarrierTestThreadArgs
     volatile int * piWaitingThreads; /**< How many threads are waiting on pxBarrier. */
 } BarrierTestThreadArgs_t;
 
+/**
+ * @brief The arguments to all of the read-write lock test threads.
+ */
+typedef struct RwlockTestThreadArgs
+{
+    volatile int * piSharedVariable; /**< Pointer to the shared variable to modify. */
+    pthread_rwlock_t * pxRwlock;     /**< Lock which protects the shared variable, or NULL to use pxMutex. */
+    pthread_mutex_t * pxMutex;       /**< Mutex which protects the shared variable if pxRwlock is NULL. */
+} RwlockTestThreadArgs_t;
+
+/**
+ * @brief The arguments to all of the condition variable test threads.
+ */
+typedef struct CondTestThreadArgs
+{
+    pthread_mutex_t * pxMutex;      /**< Mutex which protects the members below. */
+    pthread_cond_t * pxCond;        /**< Condition variable to wait on. */
+    volatile int iWaitingThreads;   /**< How many threads are waiting on pxCond. */
+    volatile BaseType_t xCondition; /**< Set to pdTRUE when the threads may exit. */
+} CondTestThreadArgs_t;
+
 /*-----------------------------------------------------------*/
 
 static void * prvChangeErrnoThread( void * pvArgs )
@@ -302,6 +339,121 @@ static void * prvBarrierTestThread( void * pvArgs )
 
 /*-----------------------------------------------------------*/
 
+static void * prvRwlockTestThread( void * pvArgs )
+{
+    intptr_t iResult = 1;
+    int i = 0, iExpectedValue = 0;
+    RwlockTestThreadArgs_t * pxArgs = ( RwlockTestThreadArgs_t * ) pvArgs;
+
+    for( i = 0; ( i < posixtestRWLOCK_STRESS_ITERATIONS ) && ( iResult == 1 ); i++ )
+    {
+        if( i % posixtestRWLOCK_STRESS_WRITE_PERIOD == 0 )
+        {
+            /* Take the lock for writing and increment the shared variable. */
+            if( pxArgs->pxRwlock != NULL )
+            {
+                iResult = ( intptr_t ) ( pthread_rwlock_wrlock( pxArgs->pxRwlock ) == 0 );
+            }
+            else
+            {
+                iResult = ( intptr_t ) ( pthread_mutex_lock( pxArgs->pxMutex ) == 0 );
+            }
+
+            ( *( pxArgs->piSharedVariable ) )++;
+        }
+        else
+        {
+            /* Take the lock for reading and hold it for a tick, as a reader
+             * doing some work would. */
+            if( pxArgs->pxRwlock != NULL )
+            {
+                iResult = ( intptr_t ) ( pthread_rwlock_rdlock( pxArgs->pxRwlock ) == 0 );
+            }
+            else
+            {
+                iResult = ( intptr_t ) ( pthread_mutex_lock( pxArgs->pxMutex ) == 0 );
+            }
+
+            iExpectedValue = *( pxArgs->piSharedVariable );
+            vTaskDelay( 1 );
+
+            /* Ensure that no writer changed the shared variable. */
+            if( iResult == 1 )
+            {
+                iResult = ( intptr_t ) ( *( pxArgs->piSharedVariable ) == iExpectedValue );
+            }
+        }
+
+        if( pxArgs->pxRwlock != NULL )
+        {
+            ( void ) pthread_rwlock_unlock( pxArgs->pxRwlock );
+        }
+        else
+        {
+            ( void ) pthread_mutex_unlock( pxArgs->pxMutex );
+        }
+    }
+
+    return ( void * ) iResult;
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvCondTestThread( void * pvArgs )
+{
+    intptr_t iResult = 0;
+    CondTestThreadArgs_t * pxArgs = ( CondTestThreadArgs_t * ) pvArgs;
+
+    ( void ) pthread_mutex_lock( pxArgs->pxMutex );
+    pxArgs->iWaitingThreads++;
+
+    /* Wait until the condition is set. */
+    while( ( iResult == 0 ) && ( pxArgs->xCondition == pdFALSE ) )
+    {
+        iResult = pthread_cond_wait( pxArgs->pxCond, pxArgs->pxMutex );
+    }
+
+    pxArgs->iWaitingThreads--;
+    ( void ) pthread_mutex_unlock( pxArgs->pxMutex );
+
+    return ( void * ) ( intptr_t ) ( iResult == 0 );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Run the read-write lock test threads and wait for them to finish.
+ *
+ * @param[in] pxArgs The arguments to the threads.
+ * @param[out] pxThreadStatus The return values of the threads.
+ *
+ * @return The number of ticks the threads ran for.
+ */
+static TickType_t prvRunRwlockTestThreads( RwlockTestThreadArgs_t * pxArgs,
+                                           intptr_t * pxThreadStatus )
+{
+    int i = 0;
+    TickType_t xStartTime = xTaskGetTickCount();
+    pthread_t xThreads[ posixtestRWLOCK_STRESS_NUMBER_OF_THREADS ] = { ( pthread_t ) NULL };
+
+    for( i = 0; i < posixtestRWLOCK_STRESS_NUMBER_OF_THREADS; i++ )
+    {
+        ( void ) pthread_create( &xThreads[ i ], NULL, prvRwlockTestThread, pxArgs );
+    }
+
+    for( i = 0; i < posixtestRWLOCK_STRESS_NUMBER_OF_THREADS; i++ )
+    {
+        if( xThreads[ i ] != ( pthread_t ) NULL )
+        {
+            ( void ) pthread_join( xThreads[ i ], ( void ** ) &pxThreadStatus[ i ] );
+        }
+    }
+
+    return xTaskGetTickCount() - xStartTime;
+}
+
+/*-----------------------------------------------------------*/
+
 TEST_GROUP( Full_POSIX_STRESS );
 
 /*-----------------------------------------------------------*/
@@ -324,6 +476,8 @@ TEST_GROUP_RUNNER( Full_POSIX_STRESS )
     RUN_TEST_CASE( Full_POSIX_STRESS, mqueue );
     RUN_TEST_CASE( Full_POSIX_STRESS, pthread_mutex );
     RUN_TEST_CASE( Full_POSIX_STRESS, pthread_barrier_overflow );
+    RUN_TEST_CASE( Full_POSIX_STRESS, pthread_rwlock );
+    RUN_TEST_CASE( Full_POSIX_STRESS, pthread_cond_broadcast_overflow );
 }
 
 /*-----------------------------------------------------------*/
@@ -598,3 +752,136 @@ TEST( Full_POSIX_STRESS, pthread_barrier_overflow )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_STRESS, pthread_rwlock )
+{
+    int i = 0;
+    volatile int iSharedVariable = 0;
+    TickType_t xRwlockTicks = 0, xMutexTicks = 0;
+    pthread_rwlock_t xRwlock;
+    pthread_mutex_t xMutex;
+    intptr_t xThreadStatus[ posixtestRWLOCK_STRESS_NUMBER_OF_THREADS ] = { 0 };
+    RwlockTestThreadArgs_t xThreadArguments = { 0 };
+    const int iExpectedValue = posixtestRWLOCK_STRESS_NUMBER_OF_THREADS *
+                               ( ( posixtestRWLOCK_STRESS_ITERATIONS + posixtestRWLOCK_STRESS_WRITE_PERIOD - 1 ) /
+                                 posixtestRWLOCK_STRESS_WRITE_PERIOD );
+
+    xThreadArguments.piSharedVariable = &iSharedVariable;
+
+    TEST_ASSERT_EQUAL_INT( 0, pthread_rwlock_init( &xRwlock, NULL ) );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_EQUAL_INT( 0, pthread_mutex_init( &xMutex, NULL ) );
+
+        if( TEST_PROTECT() )
+        {
+            /* Run the threads with the read-write lock. */
+            xThreadArguments.pxRwlock = &xRwlock;
+            xRwlockTicks = prvRunRwlockTestThreads( &xThreadArguments, xThreadStatus );
+
+            TEST_ASSERT_EQUAL_INT( iExpectedValue, iSharedVariable );
+
+            for( i = 0; i < posixtestRWLOCK_STRESS_NUMBER_OF_THREADS; i++ )
+            {
+                TEST_ASSERT_EQUAL_INT( 1, xThreadStatus[ i ] );
+            }
+
+            /* Run them again with a mutex, for comparison. Readers then hold
+             * the lock one at a time. */
+            ( void ) memset( xThreadStatus, 0x00, sizeof( xThreadStatus ) );
+            iSharedVariable = 0;
+            xThreadArguments.pxRwlock = NULL;
+            xThreadArguments.pxMutex = &xMutex;
+            xMutexTicks = prvRunRwlockTestThreads( &xThreadArguments, xThreadStatus );
+
+            TEST_ASSERT_EQUAL_INT( iExpectedValue, iSharedVariable );
+
+            for( i = 0; i < posixtestRWLOCK_STRESS_NUMBER_OF_THREADS; i++ )
+            {
+                TEST_ASSERT_EQUAL_INT( 1, xThreadStatus[ i ] );
+            }
+
+            configPRINTF( ( "rwlock: %u threads, %u locks each. rwlock: %u ms. mutex: %u ms.\r\n",
+                            ( unsigned ) posixtestRWLOCK_STRESS_NUMBER_OF_THREADS,
+                            ( unsigned ) posixtestRWLOCK_STRESS_ITERATIONS,
+                            ( unsigned ) ( xRwlockTicks * portTICK_PERIOD_MS ),
+                            ( unsigned ) ( xMutexTicks * portTICK_PERIOD_MS ) ) );
+        }
+
+        ( void ) pthread_mutex_destroy( &xMutex );
+    }
+
+    ( void ) pthread_rwlock_destroy( &xRwlock );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_STRESS, pthread_cond_broadcast_overflow )
+{
+    int i = 0, iStatus = 0;
+    TickType_t xStartTime = 0, xBroadcastTicks = 0;
+    pthread_mutex_t xMutex;
+    pthread_cond_t xCond;
+    pthread_t xCondTestThreads[ posixtestCOND_STRESS_NUMBER_OF_THREADS ] = { ( pthread_t ) NULL };
+    intptr_t xThreadReturnStatus[ posixtestCOND_STRESS_NUMBER_OF_THREADS ] = { 0 };
+    CondTestThreadArgs_t xThreadArguments = { 0 };
+
+    xThreadArguments.pxMutex = &xMutex;
+    xThreadArguments.pxCond = &xCond;
+    xThreadArguments.xCondition = pdFALSE;
+
+    TEST_ASSERT_EQUAL_INT( 0, pthread_mutex_init( &xMutex, NULL ) );
+    TEST_ASSERT_EQUAL_INT( 0, pthread_cond_init( &xCond, NULL ) );
+
+    if( TEST_PROTECT() )
+    {
+        /* Create the threads. Those that find no free event group bit in the
+         * condition variable wait on its semaphore. */
+        for( i = 0; i < posixtestCOND_STRESS_NUMBER_OF_THREADS; i++ )
+        {
+            ( void ) pthread_create( &xCondTestThreads[ i ],
+                                     NULL,
+                                     prvCondTestThread,
+                                     &xThreadArguments );
+        }
+
+        /* Wait half a second to allow all threads time to enter
+         * pthread_cond_wait. */
+        vTaskDelay( pdMS_TO_TICKS( 500 ) );
+        TEST_ASSERT_EQUAL_INT( posixtestCOND_STRESS_NUMBER_OF_THREADS, xThreadArguments.iWaitingThreads );
+
+        /* Set the condition and wake all the threads. */
+        ( void ) pthread_mutex_lock( &xMutex );
+        xThreadArguments.xCondition = pdTRUE;
+        xStartTime = xTaskGetTickCount();
+        iStatus = pthread_cond_broadcast( &xCond );
+        ( void ) pthread_mutex_unlock( &xMutex );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* Join all the threads created by this test. */
+        for( i = 0; i < posixtestCOND_STRESS_NUMBER_OF_THREADS; i++ )
+        {
+            ( void ) pthread_join( xCondTestThreads[ i ], ( void ** ) &xThreadReturnStatus[ i ] );
+        }
+
+        xBroadcastTicks = xTaskGetTickCount() - xStartTime;
+
+        /* Ensure that all waiting threads were woken. */
+        TEST_ASSERT_EQUAL_INT( 0, xThreadArguments.iWaitingThreads );
+
+        for( i = 0; i < posixtestCOND_STRESS_NUMBER_OF_THREADS; i++ )
+        {
+            TEST_ASSERT_EQUAL_INT( 1, xThreadReturnStatus[ i ] );
+        }
+
+        configPRINTF( ( "cond: %u threads woken by a broadcast in %u ms.\r\n",
+                        ( unsigned ) posixtestCOND_STRESS_NUMBER_OF_THREADS,
+                        ( unsigned ) ( xBroadcastTicks * portTICK_PERIOD_MS ) ) );
+    }
+
+    ( void ) pthread_cond_destroy( &xCond );
+    ( void ) pthread_mutex_destroy( &xMutex );
+}
+
+/*-----------------------------------------------------------*/
@@ -782,6 +782,7 @@ TEST_GROUP_RUNNER( Full_TCP )
     RUN_TEST_CASE( Full_TCP, AFQP_SOCKETS_Close );
     RUN_TEST_CASE( Full_TCP, AFQP_SOCKETS_Recv_ByteByByte );
     RUN_TEST_CASE( Full_TCP, AFQP_SOCKETS_SendRecv_VaryLength );
+    RUN_TEST_CASE( Full_TCP, AFQP_SOCKETS_Sendv );
     RUN_TEST_CASE( Full_TCP, AFQP_SOCKETS_Socket_InvalidTooManySockets );
     RUN_TEST_CASE( Full_TCP, AFQP_SOCKETS_Socket_InvalidInputParams );
     RUN_TEST_CASE( Full_TCP, AFQP_SOCKETS_Send_Invalid );
@@ -809,6 +810,7 @@ TEST_GROUP_RUNNER( Full_TCP )
         RUN_TEST_CASE( Full_TCP, AFQP_SECURE_SOCKETS_Close );
         RUN_TEST_CASE( Full_TCP, AFQP_SECURE_SOCKETS_Recv_ByteByByte );
         RUN_TEST_CASE( Full_TCP, AFQP_SECURE_SOCKETS_SendRecv_VaryLength );
+        RUN_TEST_CASE( Full_TCP, AFQP_SECURE_SOCKETS_Sendv );
         /* SECURE_SOCKETS_Socket_InvalidTooManySockets has not been implemented. */
         /*SECURE_SOCKETS_Socket_InvalidInputParams DNE.*/
         RUN_TEST_CASE( Full_TCP, AFQP_SECURE_SOCKETS_Send_Invalid );
@@ -1640,6 +1642,71 @@ TEST( Full_TCP, AFQP_SECURE_SOCKETS_SendRecv_VaryLength )
     prvSOCKETS_SendRecv_VaryLength( eSecure );
 }
 
+/*-----------------------------------------------------------*/
+
+static void prvSOCKETS_Sendv( Server_t xConn )
+{
+    BaseType_t xResult;
+    int32_t lSent;
+    uint8_t * pucTxBuffer = ( uint8_t * ) pcTxBuffer;
+    uint8_t * pucRxBuffer = ( uint8_t * ) pcRxBuffer;
+    const size_t xMessageLength = 1200;
+    SocketsIovec_t xVectors[ 3 ];
+
+    tcptestPRINTF( ( "Starting %s.\r\n", __FUNCTION__ ) );
+
+    /* Attempt to establish the requested connection. */
+    xResult = prvConnectHelperWithRetry( &xSocket, xConn, xReceiveTimeOut, xSendTimeOut, &xSocketOpen );
+    TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Failed to connect" );
+
+    /* Invalid vectors must be rejected. */
+    lSent = SOCKETS_Sendv( xSocket, NULL, 1, 0 );
+    TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_EINVAL, lSent, "Sendv accepted NULL vectors" );
+
+    /* Send one message split over three buffers, as a header, a payload
+     * and a trailer would be. */
+    prvCreateTxData( ( char * ) pucTxBuffer, xMessageLength, 0 );
+    xVectors[ 0 ].pvBuffer = pucTxBuffer;
+    xVectors[ 0 ].xLength = 5;
+    xVectors[ 1 ].pvBuffer = &pucTxBuffer[ 5 ];
+    xVectors[ 1 ].xLength = xMessageLength - 6;
+    xVectors[ 2 ].pvBuffer = &pucTxBuffer[ xMessageLength - 1 ];
+    xVectors[ 2 ].xLength = 1;
+
+    lSent = SOCKETS_Sendv( xSocket, xVectors, 3, 0 );
+    TEST_ASSERT_EQUAL_INT32_MESSAGE( xMessageLength, lSent, "Data failed to send\r\n" );
+
+    /* The echo server must return the buffers as one stream. */
+    memset( pucRxBuffer, tcptestRX_BUFFER_FILLER, tcptestBUFFER_SIZE );
+    xResult = prvRecvHelper( xSocket, pucRxBuffer, xMessageLength );
+    TEST_ASSERT_EQUAL_INT32_MESSAGE( pdPASS, xResult, "Data was not received \r\n" );
+    xResult = prvCheckRxTxBuffers( pucTxBuffer, pucRxBuffer, xMessageLength );
+    TEST_ASSERT_EQUAL_INT32_MESSAGE( pdPASS, xResult, "Received data was not the data sent\r\n" );
+
+    xResult = prvShutdownHelper( xSocket );
+    TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Socket failed to shutdown" );
+
+    xResult = prvCloseHelper( xSocket, &xSocketOpen );
+    TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Socket failed to close" );
+
+    /* Report Test Results. */
+    tcptestPRINTF( ( "%s passed\r\n", __FUNCTION__ ) );
+}
+
+TEST( Full_TCP, AFQP_SOCKETS_Sendv )
+{
+    tcptestPRINTF( ( "Starting %s.\r\n", __FUNCTION__ ) );
+
+    prvSOCKETS_Sendv( eNonsecure );
+}
+
+TEST( Full_TCP, AFQP_SECURE_SOCKETS_Sendv )
+{
+    tcptestPRINTF( ( "Starting %s.\r\n", __FUNCTION__ ) );
+
+    prvSOCKETS_Sendv( eSecure );
+}
+
 /*/ *-----------------------------------------------------------* / */
 
 static void prvSOCKETS_Socket_InvalidInputParams( Server_t xConn )
@@ -29,6 +29,9 @@
  * @brief The function to be called to run all the tests.
  */
 
+/* Standard includes. */
+#include <stdlib.h>
+
 /* Test runner interface includes. */
 #include "aws_test_runner.h"
 
@@ -138,6 +141,7 @@ static void RunTests( void )
     #if ( testrunnerFULL_POSIX_ENABLED == 1 )
         RUN_TEST_GROUP( Full_POSIX_CLOCK );
         RUN_TEST_GROUP( Full_POSIX_MQUEUE );
+        RUN_TEST_GROUP( Full_POSIX_POLL );
         RUN_TEST_GROUP( Full_POSIX_PTHREAD );
         RUN_TEST_GROUP( Full_POSIX_SEMAPHORE );
         RUN_TEST_GROUP( Full_POSIX_TIMER );
@@ -149,6 +153,34 @@ static void RunTests( void )
         RUN_TEST_GROUP( Full_FREERTOS_TCP );
     #endif
 
+    #if ( testrunnerFULL_LOGGING_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_Logging );
+    #endif
+
+    #if ( testrunnerFULL_SCHEDULER_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_Scheduler );
+    #endif
+
+    #if ( testrunnerFULL_TASK_NOTIFY_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_TaskNotify );
+    #endif
+
+    #if ( testrunnerFULL_SMP_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_SMP );
+    #endif
+
+    #if ( testrunnerFULL_WORK_QUEUE_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_WorkQueue );
+    #endif
+
+    #if ( testrunnerFULL_MEMORY_POOL_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_MemoryPool );
+    #endif
+
+    #if ( testrunnerFULL_STACKLESS_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_Stackless );
+    #endif
+
     #if ( testrunnerOTA_END_TO_END_ENABLED == 1 )
         extern void vStartOTAUpdateDemoTask( void );
         vStartOTAUpdateDemoTask();
@@ -198,6 +230,11 @@ void TEST_RUNNER_RunTests_task( void * pvParameters )
         exit( 0 );
     #endif
 
+    /* Tests that run as a host process report the result in the exit status. */
+    #if ( testrunnerEXIT_WITH_RESULT == 1 )
+        exit( ( Unity.TestFailures == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    #endif
+
     /* This task has finished.  FreeRTOS does not allow a task to run off the
      * end of its implementing function, so the task must be deleted. */
     vTaskDelete( NULL );
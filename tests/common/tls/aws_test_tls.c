@@ -40,6 +40,14 @@
 #include "aws_dev_mode_key_provisioning.h"
 #include "aws_pkcs11.h"
 
+/* TLS includes for the loopback test. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+#include "aws_tls.h"
+#include "mbedtls/ssl.h"
+
 
 /*
  * Length of elliptic curve credentials included from aws_clientcredential_keys.h.
@@ -82,6 +90,13 @@ TEST_GROUP_RUNNER( Full_TLS )
     RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectMalformedCert );
     RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectUntrustedCert );
     RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectBYOCCredentials );
+    #if defined( MBEDTLS_SSL_SRV_C )
+        RUN_TEST_CASE( Full_TLS, TLS_SessionResumptionLoopback );
+        RUN_TEST_CASE( Full_TLS, TLS_SendvLoopback );
+        #if defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+            RUN_TEST_CASE( Full_TLS, TLS_MaxFragmentLengthLoopback );
+        #endif
+    #endif
 }
 
 /*-----------------------------------------------------------*/
@@ -275,3 +290,582 @@ TEST( Full_TLS, AFQP_TLS_ConnectBYOCCredentials )
                                 );
 }
 /*-----------------------------------------------------------*/
+
+#if defined( MBEDTLS_SSL_SRV_C )
+
+/*
+ * The session resumption test runs a local mbedTLS server in a second task and
+ * connects to it through a pair of stream buffers, so that it does not depend
+ * on the session cache policy of a remote endpoint.
+ */
+    #define tlstestLOOPBACK_BUFFER_SIZE          ( 4096 )
+    #define tlstestLOOPBACK_TIMEOUT              pdMS_TO_TICKS( 20000 )
+    #define tlstestLOOPBACK_SERVER_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 16 )
+    #define tlstestLOOPBACK_SERVER_NAME          "localhost"
+
+/**
+ * @brief Max Fragment Length code the loopback server should agree on.
+ *
+ * The TLS library requests a fragment length equal to
+ * MBEDTLS_SSL_MAX_CONTENT_LEN when that is one of the sizes the extension
+ * supports, which is how a port shrinks its record buffers. With the default
+ * 16 KB buffers it requests none.
+ */
+    #if !defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+        #define tlstestEXPECTED_MFL_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_NONE
+    #elif ( MBEDTLS_SSL_MAX_CONTENT_LEN == 512 )
+        #define tlstestEXPECTED_MFL_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_512
+    #elif ( MBEDTLS_SSL_MAX_CONTENT_LEN == 1024 )
+        #define tlstestEXPECTED_MFL_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_1024
+    #elif ( MBEDTLS_SSL_MAX_CONTENT_LEN == 2048 )
+        #define tlstestEXPECTED_MFL_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_2048
+    #elif ( MBEDTLS_SSL_MAX_CONTENT_LEN == 4096 )
+        #define tlstestEXPECTED_MFL_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_4096
+    #else
+        #define tlstestEXPECTED_MFL_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_NONE
+    #endif
+
+/**
+ * @brief Upper bound on the record header, IV, MAC and padding bytes that
+ * mbedTLS adds to each record buffer beyond the payload.
+ */
+    #define tlstestRECORD_OVERHEAD_BYTES    ( 1024UL )
+
+/**
+ * @brief State of the loopback server, shared with the test task.
+ */
+    typedef struct LoopbackServer
+    {
+        StreamBufferHandle_t xToServer;
+        StreamBufferHandle_t xToClient;
+        SemaphoreHandle_t xDone;
+        mbedtls_ssl_config xConfig;
+        mbedtls_x509_crt xCertificate;
+        mbedtls_pk_context xKey;
+        CK_FUNCTION_LIST_PTR pxP11FunctionList;
+        CK_SESSION_HANDLE xP11Session;
+        mbedtls_ssl_session xCachedSession;
+        BaseType_t xHandshakeResult;
+        unsigned char ucMflCode;
+        unsigned char * pucReceived;
+        size_t xReceiveLength;
+        size_t xReceived;
+        BaseType_t xReceiveResult;
+    } LoopbackServer_t;
+
+    static LoopbackServer_t xLoopback;
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvLoopbackClientSend( void * pvCallerContext,
+                                             const unsigned char * pucData,
+                                             size_t xDataLength )
+    {
+        ( void ) pvCallerContext;
+
+        /* A stream buffer waits for space for the whole write, so a record
+         * longer than the buffer is sent in parts. */
+        if( xDataLength > tlstestLOOPBACK_BUFFER_SIZE )
+        {
+            xDataLength = tlstestLOOPBACK_BUFFER_SIZE;
+        }
+
+        return ( BaseType_t ) xStreamBufferSend( xLoopback.xToServer, pucData, xDataLength, tlstestLOOPBACK_TIMEOUT );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvLoopbackClientRecv( void * pvCallerContext,
+                                             unsigned char * pucReceiveBuffer,
+                                             size_t xReceiveLength )
+    {
+        ( void ) pvCallerContext;
+
+        return ( BaseType_t ) xStreamBufferReceive( xLoopback.xToClient, pucReceiveBuffer, xReceiveLength, tlstestLOOPBACK_TIMEOUT );
+    }
+/*-----------------------------------------------------------*/
+
+    static int prvLoopbackServerSend( void * pvContext,
+                                      const unsigned char * pucData,
+                                      size_t xDataLength )
+    {
+        ( void ) pvContext;
+
+        if( xDataLength > tlstestLOOPBACK_BUFFER_SIZE )
+        {
+            xDataLength = tlstestLOOPBACK_BUFFER_SIZE;
+        }
+
+        return ( int ) xStreamBufferSend( xLoopback.xToClient, pucData, xDataLength, tlstestLOOPBACK_TIMEOUT );
+    }
+/*-----------------------------------------------------------*/
+
+    static int prvLoopbackServerRecv( void * pvContext,
+                                      unsigned char * pucReceiveBuffer,
+                                      size_t xReceiveLength )
+    {
+        ( void ) pvContext;
+
+        return ( int ) xStreamBufferReceive( xLoopback.xToServer, pucReceiveBuffer, xReceiveLength, tlstestLOOPBACK_TIMEOUT );
+    }
+/*-----------------------------------------------------------*/
+
+    static int prvLoopbackServerRandom( void * pvContext,
+                                        unsigned char * pucRandom,
+                                        size_t xRandomLength )
+    {
+        ( void ) pvContext;
+
+        return ( int ) xLoopback.pxP11FunctionList->C_GenerateRandom( xLoopback.xP11Session, pucRandom, xRandomLength );
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Single-entry server session cache, following mbedtls_ssl_cache_get/set.
+ */
+    static int prvLoopbackServerCacheGet( void * pvContext,
+                                          mbedtls_ssl_session * pxSession )
+    {
+        ( void ) pvContext;
+
+        if( ( pxSession->ciphersuite != xLoopback.xCachedSession.ciphersuite ) ||
+            ( pxSession->compression != xLoopback.xCachedSession.compression ) ||
+            ( pxSession->id_len != xLoopback.xCachedSession.id_len ) ||
+            ( 0 == pxSession->id_len ) ||
+            ( 0 != memcmp( pxSession->id, xLoopback.xCachedSession.id, pxSession->id_len ) ) )
+        {
+            return 1;
+        }
+
+        memcpy( pxSession->master, xLoopback.xCachedSession.master, sizeof( pxSession->master ) );
+        pxSession->verify_result = xLoopback.xCachedSession.verify_result;
+
+        return 0;
+    }
+/*-----------------------------------------------------------*/
+
+    static int prvLoopbackServerCacheSet( void * pvContext,
+                                          const mbedtls_ssl_session * pxSession )
+    {
+        ( void ) pvContext;
+
+        xLoopback.xCachedSession.ciphersuite = pxSession->ciphersuite;
+        xLoopback.xCachedSession.compression = pxSession->compression;
+        xLoopback.xCachedSession.id_len = pxSession->id_len;
+        memcpy( xLoopback.xCachedSession.id, pxSession->id, sizeof( pxSession->id ) );
+        memcpy( xLoopback.xCachedSession.master, pxSession->master, sizeof( pxSession->master ) );
+        xLoopback.xCachedSession.verify_result = pxSession->verify_result;
+
+        return 0;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLoopbackServerTask( void * pvParameters )
+    {
+        mbedtls_ssl_context xSsl;
+        int lResult;
+
+        ( void ) pvParameters;
+
+        mbedtls_ssl_init( &xSsl );
+        lResult = mbedtls_ssl_setup( &xSsl, &xLoopback.xConfig );
+
+        if( 0 == lResult )
+        {
+            mbedtls_ssl_set_bio( &xSsl, NULL, prvLoopbackServerSend, prvLoopbackServerRecv, NULL );
+
+            do
+            {
+                lResult = mbedtls_ssl_handshake( &xSsl );
+            } while( ( MBEDTLS_ERR_SSL_WANT_READ == lResult ) ||
+                     ( MBEDTLS_ERR_SSL_WANT_WRITE == lResult ) );
+        }
+
+        xLoopback.ucMflCode = MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+
+        #if defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+            if( ( 0 == lResult ) && ( NULL != xSsl.session ) )
+            {
+                xLoopback.ucMflCode = xSsl.session->mfl_code;
+            }
+        #endif
+
+        xLoopback.xHandshakeResult = ( BaseType_t ) lResult;
+
+        /* Then receive the data the test expects the client to send. */
+        while( ( 0 == lResult ) && ( xLoopback.xReceived < xLoopback.xReceiveLength ) )
+        {
+            lResult = mbedtls_ssl_read( &xSsl,
+                                        xLoopback.pucReceived + xLoopback.xReceived,
+                                        xLoopback.xReceiveLength - xLoopback.xReceived );
+
+            if( 0 < lResult )
+            {
+                xLoopback.xReceived += ( size_t ) lResult;
+                lResult = 0;
+            }
+            else if( 0 == lResult )
+            {
+                lResult = MBEDTLS_ERR_SSL_CONN_EOF;
+            }
+            else if( ( MBEDTLS_ERR_SSL_WANT_READ == lResult ) ||
+                     ( MBEDTLS_ERR_SSL_WANT_WRITE == lResult ) )
+            {
+                lResult = 0;
+            }
+        }
+
+        xLoopback.xReceiveResult = ( BaseType_t ) lResult;
+
+        mbedtls_ssl_free( &xSsl );
+
+        ( void ) xSemaphoreGive( xLoopback.xDone );
+        vTaskDelete( NULL );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Performs one client handshake against the loopback server.
+ *
+ * @return Result of TLS_Connect.
+ */
+    static BaseType_t prvLoopbackConnect( void )
+    {
+        TLSParams_t xParams = { 0 };
+        TLSMemoryReport_t xReport;
+        void * pvTlsContext = NULL;
+        BaseType_t xResult;
+
+        xStreamBufferReset( xLoopback.xToServer );
+        xStreamBufferReset( xLoopback.xToClient );
+
+        xParams.ulSize = sizeof( xParams );
+        xParams.pcDestination = tlstestLOOPBACK_SERVER_NAME;
+        xParams.pcServerCertificate = tlstestLOOPBACK_SERVER_CERTIFICATE_PEM;
+        xParams.ulServerCertificateLength = sizeof( tlstestLOOPBACK_SERVER_CERTIFICATE_PEM );
+        xParams.pxNetworkRecv = prvLoopbackClientRecv;
+        xParams.pxNetworkSend = prvLoopbackClientSend;
+
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xTaskCreate( prvLoopbackServerTask,
+                                                      "TLSLoopback",
+                                                      tlstestLOOPBACK_SERVER_STACK_SIZE,
+                                                      NULL,
+                                                      uxTaskPriorityGet( NULL ),
+                                                      NULL ) );
+
+        xResult = TLS_Init( &pvTlsContext, &xParams );
+
+        if( 0 == xResult )
+        {
+            xResult = TLS_Connect( pvTlsContext );
+        }
+
+        TEST_ASSERT_EQUAL_INT32( pdTRUE, xSemaphoreTake( xLoopback.xDone, tlstestLOOPBACK_TIMEOUT ) );
+
+        if( 0 == xResult )
+        {
+            TEST_ASSERT_EQUAL_INT32( 0, TLS_GetMemoryReport( pvTlsContext, &xReport ) );
+            TEST_ASSERT_GREATER_THAN_UINT32( 0, xReport.ulSessionBytes );
+
+            /* Both record buffers are sized for MBEDTLS_SSL_MAX_CONTENT_LEN,
+             * which the peers agreed on as the fragment length, so no buffer
+             * space is left unused. */
+            TEST_ASSERT_EQUAL_UINT32( MBEDTLS_SSL_MAX_CONTENT_LEN, xReport.ulMaxFragmentLength );
+            TEST_ASSERT_EQUAL_UINT32( 0, xReport.ulUnusedRecordBytes );
+            TEST_ASSERT_GREATER_THAN_UINT32( 2UL * xReport.ulMaxFragmentLength, xReport.ulRecordBufferBytes );
+            TEST_ASSERT_LESS_THAN_UINT32( 2UL * ( xReport.ulMaxFragmentLength + tlstestRECORD_OVERHEAD_BYTES ),
+                                          xReport.ulRecordBufferBytes );
+        }
+
+        TLS_Cleanup( pvTlsContext );
+
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xLoopback.xHandshakeResult, "Loopback server handshake failed" );
+        TEST_ASSERT_EQUAL_UINT8_MESSAGE( tlstestEXPECTED_MFL_CODE,
+                                         xLoopback.ucMflCode,
+                                         "Loopback server did not agree on the requested fragment length" );
+
+        return xResult;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Creates the loopback channel and the server configuration.
+ *
+ * Call inside TEST_PROTECT and pair with prvLoopbackServerTearDown.
+ */
+    static void prvLoopbackServerSetUp( void )
+    {
+        CK_SLOT_ID xSlotId = 0;
+        CK_ULONG ulCount = 1;
+        int lResult;
+
+        /* The client authenticates with the default credentials. */
+        vDevModeKeyProvisioning();
+
+        xLoopback.xToServer = xStreamBufferCreate( tlstestLOOPBACK_BUFFER_SIZE, 1 );
+        xLoopback.xToClient = xStreamBufferCreate( tlstestLOOPBACK_BUFFER_SIZE, 1 );
+        xLoopback.xDone = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_NULL( xLoopback.xToServer );
+        TEST_ASSERT_NOT_NULL( xLoopback.xToClient );
+        TEST_ASSERT_NOT_NULL( xLoopback.xDone );
+
+        /* The server draws random numbers from its own PKCS#11 session. */
+        TEST_ASSERT_EQUAL( CKR_OK, C_GetFunctionList( &xLoopback.pxP11FunctionList ) );
+        ( void ) xLoopback.pxP11FunctionList->C_Initialize( NULL );
+        TEST_ASSERT_EQUAL( CKR_OK, xLoopback.pxP11FunctionList->C_GetSlotList( CK_TRUE, &xSlotId, &ulCount ) );
+        TEST_ASSERT_EQUAL( CKR_OK, xLoopback.pxP11FunctionList->C_OpenSession( xSlotId,
+                                                                               CKF_SERIAL_SESSION,
+                                                                               NULL,
+                                                                               NULL,
+                                                                               &xLoopback.xP11Session ) );
+
+        lResult = mbedtls_x509_crt_parse( &xLoopback.xCertificate,
+                                          ( const unsigned char * ) tlstestLOOPBACK_SERVER_CERTIFICATE_PEM,
+                                          sizeof( tlstestLOOPBACK_SERVER_CERTIFICATE_PEM ) );
+        TEST_ASSERT_EQUAL_INT32( 0, lResult );
+        lResult = mbedtls_pk_parse_key( &xLoopback.xKey,
+                                        ( const unsigned char * ) tlstestLOOPBACK_SERVER_PRIVATE_KEY_PEM,
+                                        sizeof( tlstestLOOPBACK_SERVER_PRIVATE_KEY_PEM ),
+                                        NULL,
+                                        0 );
+        TEST_ASSERT_EQUAL_INT32( 0, lResult );
+
+        lResult = mbedtls_ssl_config_defaults( &xLoopback.xConfig,
+                                               MBEDTLS_SSL_IS_SERVER,
+                                               MBEDTLS_SSL_TRANSPORT_STREAM,
+                                               MBEDTLS_SSL_PRESET_DEFAULT );
+        TEST_ASSERT_EQUAL_INT32( 0, lResult );
+        mbedtls_ssl_conf_rng( &xLoopback.xConfig, prvLoopbackServerRandom, NULL );
+        mbedtls_ssl_conf_authmode( &xLoopback.xConfig, MBEDTLS_SSL_VERIFY_NONE );
+        mbedtls_ssl_conf_session_cache( &xLoopback.xConfig,
+                                        NULL,
+                                        prvLoopbackServerCacheGet,
+                                        prvLoopbackServerCacheSet );
+        lResult = mbedtls_ssl_conf_own_cert( &xLoopback.xConfig, &xLoopback.xCertificate, &xLoopback.xKey );
+        TEST_ASSERT_EQUAL_INT32( 0, lResult );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Frees whatever prvLoopbackServerSetUp created.
+ */
+    static void prvLoopbackServerTearDown( void )
+    {
+        mbedtls_ssl_config_free( &xLoopback.xConfig );
+        mbedtls_x509_crt_free( &xLoopback.xCertificate );
+        mbedtls_pk_free( &xLoopback.xKey );
+
+        if( NULL != xLoopback.pxP11FunctionList )
+        {
+            ( void ) xLoopback.pxP11FunctionList->C_CloseSession( xLoopback.xP11Session );
+        }
+
+        if( NULL != xLoopback.xToServer )
+        {
+            vStreamBufferDelete( xLoopback.xToServer );
+        }
+
+        if( NULL != xLoopback.xToClient )
+        {
+            vStreamBufferDelete( xLoopback.xToClient );
+        }
+
+        if( NULL != xLoopback.xDone )
+        {
+            vSemaphoreDelete( xLoopback.xDone );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    TEST( Full_TLS, TLS_SessionResumptionLoopback )
+    {
+        TLSStats_t xBefore;
+        TLSStats_t xAfterFull;
+        TLSStats_t xAfterResumed;
+
+        memset( &xLoopback, 0, sizeof( xLoopback ) );
+        mbedtls_ssl_config_init( &xLoopback.xConfig );
+        mbedtls_x509_crt_init( &xLoopback.xCertificate );
+        mbedtls_pk_init( &xLoopback.xKey );
+
+        if( TEST_PROTECT() )
+        {
+            prvLoopbackServerSetUp();
+
+            /* The first connection negotiates a new session... */
+            TLS_GetStats( &xBefore );
+            TEST_ASSERT_EQUAL_INT32( 0, prvLoopbackConnect() );
+            TLS_GetStats( &xAfterFull );
+            TEST_ASSERT_EQUAL_UINT32( xBefore.ulFullHandshakes + 1, xAfterFull.ulFullHandshakes );
+
+            /* ...which the second one resumes, with less traffic. */
+            TEST_ASSERT_EQUAL_INT32( 0, prvLoopbackConnect() );
+            TLS_GetStats( &xAfterResumed );
+            TEST_ASSERT_EQUAL_UINT32( xAfterFull.ulResumedHandshakes + 1, xAfterResumed.ulResumedHandshakes );
+            TEST_ASSERT_LESS_THAN_UINT32( xAfterFull.ulHandshakeBytesReceived - xBefore.ulHandshakeBytesReceived,
+                                          xAfterResumed.ulHandshakeBytesReceived - xAfterFull.ulHandshakeBytesReceived );
+        }
+
+        prvLoopbackServerTearDown();
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Sends a header, an empty segment, a body longer than one record and a
+ * trailer with one call to TLS_Sendv, and checks that the server receives them
+ * as one stream.
+ */
+    TEST( Full_TLS, TLS_SendvLoopback )
+    {
+        TLSParams_t xParams = { 0 };
+        TLSIovec_t xVectors[ 4 ];
+        void * pvTlsContext = NULL;
+        unsigned char * pucSent = NULL;
+        size_t xLength;
+        size_t xIndex;
+
+        memset( &xLoopback, 0, sizeof( xLoopback ) );
+        mbedtls_ssl_config_init( &xLoopback.xConfig );
+        mbedtls_x509_crt_init( &xLoopback.xCertificate );
+        mbedtls_pk_init( &xLoopback.xKey );
+
+        if( TEST_PROTECT() )
+        {
+            prvLoopbackServerSetUp();
+
+            xLength = 5 + MBEDTLS_SSL_MAX_CONTENT_LEN + 1000 + 3;
+            pucSent = pvPortMalloc( xLength );
+            xLoopback.pucReceived = pvPortMalloc( xLength );
+            TEST_ASSERT_NOT_NULL( pucSent );
+            TEST_ASSERT_NOT_NULL( xLoopback.pucReceived );
+            xLoopback.xReceiveLength = xLength;
+
+            for( xIndex = 0; xIndex < xLength; xIndex++ )
+            {
+                pucSent[ xIndex ] = ( unsigned char ) ( ( xIndex * 7 ) + ( xIndex >> 8 ) );
+            }
+
+            xVectors[ 0 ].pucData = pucSent;
+            xVectors[ 0 ].xLength = 5;
+            xVectors[ 1 ].pucData = NULL;
+            xVectors[ 1 ].xLength = 0;
+            xVectors[ 2 ].pucData = pucSent + 5;
+            xVectors[ 2 ].xLength = MBEDTLS_SSL_MAX_CONTENT_LEN + 1000;
+            xVectors[ 3 ].pucData = pucSent + 5 + MBEDTLS_SSL_MAX_CONTENT_LEN + 1000;
+            xVectors[ 3 ].xLength = 3;
+
+            xParams.ulSize = sizeof( xParams );
+            xParams.pcDestination = tlstestLOOPBACK_SERVER_NAME;
+            xParams.pcServerCertificate = tlstestLOOPBACK_SERVER_CERTIFICATE_PEM;
+            xParams.ulServerCertificateLength = sizeof( tlstestLOOPBACK_SERVER_CERTIFICATE_PEM );
+            xParams.pxNetworkRecv = prvLoopbackClientRecv;
+            xParams.pxNetworkSend = prvLoopbackClientSend;
+
+            TEST_ASSERT_EQUAL_INT32( pdPASS, xTaskCreate( prvLoopbackServerTask,
+                                                          "TLSLoopback",
+                                                          tlstestLOOPBACK_SERVER_STACK_SIZE,
+                                                          NULL,
+                                                          uxTaskPriorityGet( NULL ),
+                                                          NULL ) );
+
+            TEST_ASSERT_EQUAL_INT32( 0, TLS_Init( &pvTlsContext, &xParams ) );
+            TEST_ASSERT_EQUAL_INT32( 0, TLS_Connect( pvTlsContext ) );
+            TEST_ASSERT_EQUAL_INT32( xLength, TLS_Sendv( pvTlsContext, xVectors, 4 ) );
+
+            TEST_ASSERT_EQUAL_INT32( pdTRUE, xSemaphoreTake( xLoopback.xDone, tlstestLOOPBACK_TIMEOUT ) );
+            TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xLoopback.xHandshakeResult, "Loopback server handshake failed" );
+            TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xLoopback.xReceiveResult, "Loopback server read failed" );
+            TEST_ASSERT_EQUAL_UINT32( xLength, xLoopback.xReceived );
+            TEST_ASSERT_EQUAL_UINT8_ARRAY( pucSent, xLoopback.pucReceived, xLength );
+        }
+
+        TLS_Cleanup( pvTlsContext );
+        vPortFree( pucSent );
+        vPortFree( xLoopback.pucReceived );
+        prvLoopbackServerTearDown();
+    }
+/*-----------------------------------------------------------*/
+
+    #if defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+
+        static int prvLoopbackRawClientSend( void * pvContext,
+                                             const unsigned char * pucData,
+                                             size_t xDataLength )
+        {
+            return ( int ) prvLoopbackClientSend( pvContext, pucData, xDataLength );
+        }
+/*-----------------------------------------------------------*/
+
+        static int prvLoopbackRawClientRecv( void * pvContext,
+                                             unsigned char * pucReceiveBuffer,
+                                             size_t xReceiveLength )
+        {
+            return ( int ) prvLoopbackClientRecv( pvContext, pucReceiveBuffer, xReceiveLength );
+        }
+/*-----------------------------------------------------------*/
+
+/*
+ * Record buffers smaller than 16 KB are only safe once the server has agreed
+ * to the Max Fragment Length the client asked for. This test requests 4 KB
+ * straight from mbedTLS, independently of MBEDTLS_SSL_MAX_CONTENT_LEN, and
+ * checks that both ends settle on it.
+ */
+        TEST( Full_TLS, TLS_MaxFragmentLengthLoopback )
+        {
+            mbedtls_ssl_config xClientConfig;
+            mbedtls_ssl_context xClientSsl;
+            int lResult;
+
+            memset( &xLoopback, 0, sizeof( xLoopback ) );
+            mbedtls_ssl_config_init( &xLoopback.xConfig );
+            mbedtls_x509_crt_init( &xLoopback.xCertificate );
+            mbedtls_pk_init( &xLoopback.xKey );
+            mbedtls_ssl_config_init( &xClientConfig );
+            mbedtls_ssl_init( &xClientSsl );
+
+            if( TEST_PROTECT() )
+            {
+                prvLoopbackServerSetUp();
+
+                lResult = mbedtls_ssl_config_defaults( &xClientConfig,
+                                                       MBEDTLS_SSL_IS_CLIENT,
+                                                       MBEDTLS_SSL_TRANSPORT_STREAM,
+                                                       MBEDTLS_SSL_PRESET_DEFAULT );
+                TEST_ASSERT_EQUAL_INT32( 0, lResult );
+                mbedtls_ssl_conf_rng( &xClientConfig, prvLoopbackServerRandom, NULL );
+                mbedtls_ssl_conf_authmode( &xClientConfig, MBEDTLS_SSL_VERIFY_NONE );
+                TEST_ASSERT_EQUAL_INT32( 0, mbedtls_ssl_conf_max_frag_len( &xClientConfig,
+                                                                           MBEDTLS_SSL_MAX_FRAG_LEN_4096 ) );
+                TEST_ASSERT_EQUAL_INT32( 0, mbedtls_ssl_setup( &xClientSsl, &xClientConfig ) );
+                mbedtls_ssl_set_bio( &xClientSsl, NULL, prvLoopbackRawClientSend, prvLoopbackRawClientRecv, NULL );
+
+                TEST_ASSERT_EQUAL_INT32( pdPASS, xTaskCreate( prvLoopbackServerTask,
+                                                              "TLSLoopback",
+                                                              tlstestLOOPBACK_SERVER_STACK_SIZE,
+                                                              NULL,
+                                                              uxTaskPriorityGet( NULL ),
+                                                              NULL ) );
+
+                do
+                {
+                    lResult = mbedtls_ssl_handshake( &xClientSsl );
+                } while( ( MBEDTLS_ERR_SSL_WANT_READ == lResult ) ||
+                         ( MBEDTLS_ERR_SSL_WANT_WRITE == lResult ) );
+
+                TEST_ASSERT_EQUAL_INT32( pdTRUE, xSemaphoreTake( xLoopback.xDone, tlstestLOOPBACK_TIMEOUT ) );
+                TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, lResult, "Loopback client handshake failed" );
+                TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xLoopback.xHandshakeResult, "Loopback server handshake failed" );
+
+                /* The server accepted the extension, and the client limits
+                 * its records to the agreed length. */
+                TEST_ASSERT_EQUAL_UINT8( MBEDTLS_SSL_MAX_FRAG_LEN_4096, xLoopback.ucMflCode );
+                TEST_ASSERT_EQUAL_UINT32( 4096, mbedtls_ssl_get_max_frag_len( &xClientSsl ) );
+            }
+
+            mbedtls_ssl_free( &xClientSsl );
+            mbedtls_ssl_config_free( &xClientConfig );
+            prvLoopbackServerTearDown();
+        }
+/*-----------------------------------------------------------*/
+
+    #endif /* if defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH ) */
+
+#endif /* if defined( MBEDTLS_SSL_SRV_C ) */
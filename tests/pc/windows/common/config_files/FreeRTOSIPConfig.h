@@ -245,6 +245,10 @@ extern uint32_t ulRand();
  * (and associated) API function is available. */
 #define ipconfigSUPPORT_SELECT_FUNCTION                0
 
+/* If ipconfigSUPPORT_MMSG_FUNCTIONS is set to 1 then the FreeRTOS_sendmmsg()
+ * and FreeRTOS_recvmmsg() API functions are available. */
+#define ipconfigSUPPORT_MMSG_FUNCTIONS                 1
+
 /* If ipconfigFILTER_OUT_NON_ETHERNET_II_FRAMES is set to 1 then Ethernet frames
  * that are not in Ethernet II format will be dropped.  This option is included for
  * potential future IP stack developments. */
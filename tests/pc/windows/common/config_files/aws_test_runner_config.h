@@ -43,15 +43,22 @@
 #define testrunnerFULL_DEFENDER_ENABLED            0
 #define testrunnerFULL_GGD_ENABLED                 0
 #define testrunnerFULL_GGD_HELPER_ENABLED          0
+#define testrunnerFULL_LOGGING_ENABLED             0
 #define testrunnerFULL_MQTT_AGENT_ENABLED          0
 #define testrunnerFULL_MQTT_ALPN_ENABLED           0
 #define testrunnerFULL_MQTT_ENABLED                0
 #define testrunnerFULL_MQTT_STRESS_TEST_ENABLED    0
 #define testrunnerFULL_PKCS11_ENABLED              0
 #define testrunnerFULL_POSIX_ENABLED               0
+#define testrunnerFULL_SCHEDULER_ENABLED           0
 #define testrunnerFULL_SHADOW_ENABLED              0
+#define testrunnerFULL_SMP_ENABLED                 0
+#define testrunnerFULL_TASK_NOTIFY_ENABLED         0
 #define testrunnerFULL_TCP_ENABLED                 1
 #define testrunnerFULL_TLS_ENABLED                 0
+#define testrunnerFULL_WORK_QUEUE_ENABLED          0
+#define testrunnerFULL_MEMORY_POOL_ENABLED         0
+#define testrunnerFULL_STACKLESS_ENABLED           0
 #define testrunnerFULL_MEMORYLEAK_ENABLED          0
 #define testrunnerFULL_OTA_CBOR_ENABLED            0
 #define testrunnerFULL_OTA_AGENT_ENABLED           0